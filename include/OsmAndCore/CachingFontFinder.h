@@ -2,10 +2,12 @@
 #define _OSMAND_CORE_CACHING_FONT_FINDER_H_
 
 #include <OsmAndCore/stdlib_common.h>
+#include <atomic>
 
 #include <OsmAndCore/QtExtensions.h>
 #include <QString>
 #include <QHash>
+#include <QList>
 #include <QMutex>
 
 #include <OsmAndCore.h>
@@ -58,8 +60,17 @@ namespace OsmAnd
 #endif // !defined(SWIG)
         };
 
+        typedef QHash< CacheKey, SkTypeface* > Cache;
+
+        // Read-mostly, RCU-like: lookups go to immutable published snapshot without any locking.
+        // Misses are resolved under lock into pending entries, which are merged into new snapshot
+        // once there're enough of them. Replaced snapshots are kept until destruction, but since
+        // merge happens only when pending part is a fraction of snapshot, their total size is O(n)
+        mutable std::atomic<const Cache*> _snapshot;
         mutable QMutex _lock;
-        mutable QHash< CacheKey, SkTypeface* > _cache;
+        mutable Cache _pending;
+        mutable QList<const Cache*> _retiredSnapshots;
+        void publishSnapshot() const;
     protected:
     public:
         CachingFontFinder(const std::shared_ptr<const IFontFinder>& fontFinder);
@@ -0,0 +1,104 @@
+#ifndef _OSMAND_CORE_COLUMNAR_TRACKS_FILE_H_
+#define _OSMAND_CORE_COLUMNAR_TRACKS_FILE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <limits>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QVector>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Common.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/PointsAndAreas.h>
+#include <OsmAndCore/GeoInfoDocument.h>
+#include <OsmAndCore/GpxDocument.h>
+
+namespace OsmAnd
+{
+    // Binary storage of tracks: each track segment is a block of columns (31-bit coordinates, timestamps, elevations)
+    // encoded as zigzag varint deltas and optionally compressed. Blocks are located through fixed-size segments table,
+    // so file is memory-mapped and segments are decoded on demand, without parsing the rest of the file.
+    // Coordinates are stored as 31-bit tile coordinates and elevations in centimeters. Only tracks are stored.
+    // Once opened, segments may be read from any thread.
+    class ColumnarTracksFile_P;
+    class OSMAND_CORE_API ColumnarTracksFile
+    {
+        Q_DISABLE_COPY_AND_MOVE(ColumnarTracksFile);
+    public:
+        enum class Compression : uint32_t
+        {
+            None = 0,
+            Zlib = 1,
+        };
+
+        enum : int64_t {
+            NoTimestamp = std::numeric_limits<int64_t>::min(),
+        };
+
+        struct OSMAND_CORE_API Track
+        {
+            Track();
+            ~Track();
+
+            QString name;
+            QString description;
+            QString comment;
+            QString type;
+            unsigned int firstSegmentIndex;
+            unsigned int segmentsCount;
+        };
+
+        struct OSMAND_CORE_API Segment
+        {
+            Segment();
+            ~Segment();
+
+            unsigned int trackIndex;
+            unsigned int pointsCount;
+            AreaI bbox31;
+            bool hasTimestamps;
+            bool hasElevations;
+        };
+
+    private:
+        PrivateImplementation<ColumnarTracksFile_P> _p;
+    protected:
+    public:
+        ColumnarTracksFile(const QString& filename);
+        virtual ~ColumnarTracksFile();
+
+        const QString filename;
+
+        bool open();
+        void close();
+        bool isOpened() const;
+
+        QVector<Track> getTracks() const;
+        QVector<Segment> getSegments() const;
+
+        // Missing timestamps are NoTimestamp, missing elevations are NaN
+        bool readSegment(
+            const unsigned int segmentIndex,
+            QVector<PointI>* const outPoints31,
+            QVector<int64_t>* const outTimestamps = nullptr,
+            QVector<double>* const outElevations = nullptr) const;
+
+        std::shared_ptr<GpxDocument> toGpxDocument() const;
+
+        static bool saveTo(
+            const QString& filename,
+            const std::shared_ptr<const GeoInfoDocument>& document,
+            const Compression compression = Compression::Zlib);
+        // Tracks are streamed from GPX file without loading it as GpxDocument
+        static bool convertGpx(
+            const QString& gpxFilename,
+            const QString& filename,
+            const Compression compression = Compression::Zlib);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_COLUMNAR_TRACKS_FILE_H_)
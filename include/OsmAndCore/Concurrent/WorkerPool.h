@@ -28,18 +28,45 @@ namespace OsmAnd
             {
                 FIFO,
                 LIFO,
-                Random
+                Random,
+
+                // Runnable with highest priority (as returned by priority function) is executed first.
+                // Queue is kept as a binary heap, so enqueue and dequeue are O(log n). Sort predicates
+                // are ignored in this mode.
+                Priority
+            };
+
+            enum class Scheduler
+            {
+                // Single queue guarded by pool mutex, honours Order and sort predicates
+                SharedQueue,
+
+                // Per-thread deques with stealing between idle threads. Runnables enqueued from a worker
+                // are executed by same worker (LIFO) unless stolen, others go through FIFO injection queue.
+                // Order, sort predicates and priority function are ignored in this mode.
+                WorkStealing,
+
+                // Runnables are queued by pool itself (honouring Order, sort predicates and priority function),
+                // and up to maxThreadCount of them at a time are handed to single work-stealing scheduler that
+                // is shared by all pools in this mode. So these pools together never run more threads than cores.
+                SharedWorkStealing
             };
 
             typedef std::function<bool (QRunnable* const l, QRunnable* const r)> SortPredicate;
+            typedef std::function<int64_t (QRunnable* const runnable)> PriorityFunction;
 
         private:
             PrivateImplementation<WorkerPool_P> _p;
         protected:
         public:
-            WorkerPool(const Order order = Order::FIFO, const int maxThreadCount = QThread::idealThreadCount());
+            WorkerPool(
+                const Order order = Order::FIFO,
+                const int maxThreadCount = QThread::idealThreadCount(),
+                const Scheduler scheduler = Scheduler::SharedQueue);
             virtual ~WorkerPool();
 
+            Scheduler scheduler() const;
+
             Order order() const;
             void setOrder(const Order order);
 
@@ -56,6 +83,10 @@ namespace OsmAnd
 
             void sortQueue(const SortPredicate predicate);
 
+            PriorityFunction priorityFunction() const;
+            void setPriorityFunction(const PriorityFunction priorityFunction, const bool reprioritize = true);
+            void reprioritize();
+
             void reset();
         };
     }
@@ -158,6 +158,10 @@ namespace OsmAnd
         static std::shared_ptr<GpxDocument> loadFrom(QXmlStreamReader& xmlReader);
         static std::shared_ptr<GpxDocument> loadFrom(QIODevice& ioDevice);
         static std::shared_ptr<GpxDocument> loadFrom(const QString& filename);
+
+        // Fast path for large track files: only tracks are loaded, using GpxStreamReader
+        static std::shared_ptr<GpxDocument> loadTracksFrom(QIODevice& ioDevice);
+        static std::shared_ptr<GpxDocument> loadTracksFrom(const QString& filename);
     };
 }
 
@@ -0,0 +1,109 @@
+#ifndef _OSMAND_CORE_GPX_STREAM_READER_H_
+#define _OSMAND_CORE_GPX_STREAM_READER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <limits>
+#include <vector>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QIODevice>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Common.h>
+#include <OsmAndCore/Callable.h>
+#include <OsmAndCore/PrivateImplementation.h>
+
+namespace OsmAnd
+{
+    // Streaming reader of GPX tracks: input is read in fixed-size chunks and track points are reported in batches
+    // of plain columns, so no document is ever held in memory. Only <trk>, <trkseg>, <trkpt> and their name, description,
+    // comment, type, elevation and time are read, everything else is skipped.
+    // Not thread-safe, use one reader per thread.
+    class GpxStreamReader_P;
+    class OSMAND_CORE_API GpxStreamReader
+    {
+        Q_DISABLE_COPY_AND_MOVE(GpxStreamReader);
+    public:
+        enum : int {
+            DefaultBatchSize = 4096,
+            DefaultChunkSize = 64 * 1024,
+        };
+
+        enum : int64_t {
+            NoTimestamp = std::numeric_limits<int64_t>::min(),
+        };
+
+        struct OSMAND_CORE_API TrackPointsBatch
+        {
+            TrackPointsBatch();
+            ~TrackPointsBatch();
+
+            // Index of track in document and of segment in that track. Batch never spans several segments
+            int trackIndex;
+            int segmentIndex;
+            // Set on last batch of segment, which may be empty if segment had no points
+            bool isLastInSegment;
+
+            // Columns of equal size, one entry per point
+            std::vector<double> latitudes;
+            std::vector<double> longitudes;
+            // NaN if point has no elevation
+            std::vector<double> elevations;
+            // Milliseconds since epoch, UTC. NoTimestamp if point has no time
+            std::vector<int64_t> timestamps;
+
+            inline unsigned int size() const
+            {
+                return static_cast<unsigned int>(latitudes.size());
+            }
+        };
+
+        struct OSMAND_CORE_API TrackInfo
+        {
+            TrackInfo();
+            ~TrackInfo();
+
+            int trackIndex;
+            int segmentsCount;
+            unsigned int pointsCount;
+            QString name;
+            QString description;
+            QString comment;
+            QString type;
+        };
+
+        // Returning false stops reading
+        OSMAND_CALLABLE(TrackPointsBatchReady, bool, const TrackPointsBatch& batch);
+        OSMAND_CALLABLE(TrackFinished, bool, const TrackInfo& track);
+
+    private:
+        PrivateImplementation<GpxStreamReader_P> _p;
+    protected:
+    public:
+        GpxStreamReader(const int batchSize = DefaultBatchSize, const int chunkSize = DefaultChunkSize);
+        virtual ~GpxStreamReader();
+
+        const int batchSize;
+        const int chunkSize;
+
+        bool read(
+            QIODevice& ioDevice,
+            const TrackPointsBatchReady batchReady,
+            const TrackFinished trackFinished = nullptr);
+        bool read(
+            const QString& filename,
+            const TrackPointsBatchReady batchReady,
+            const TrackFinished trackFinished = nullptr);
+
+        // Results of last read
+        QString getVersion() const;
+        QString getCreator() const;
+        bool hasSkippedContent() const;
+        uint64_t getBytesRead() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_GPX_STREAM_READER_H_)
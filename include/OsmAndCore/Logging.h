@@ -29,20 +29,58 @@ namespace OsmAnd
     };
 
     class ILogSink;
+    class AsyncLogQueue;
 
     class OSMAND_CORE_API Logger Q_DECL_FINAL
     {
         Q_DISABLE_COPY_AND_MOVE(Logger);
+    public:
+        enum : unsigned int {
+            // Queue of asynchronous mode takes about AsyncQueueCapacity * (AsyncMessageMaxLength + 1) bytes
+            AsyncQueueCapacity = 2048,
+            AsyncMessageMaxLength = 511,
+        };
+
+        enum : int {
+            // How long flushOnCrash() waits for locks that may be held by crashed thread
+            CrashLockTimeoutMs = 200,
+        };
+
+        struct AsyncStatistics
+        {
+            uint64_t enqueuedCount;
+            // Queue was full
+            uint64_t droppedCount;
+            // Message was longer than queue slot
+            uint64_t truncatedCount;
+        };
+
     private:
         Logger();
+
+        void writeToSinks(const LogSeverityLevel level, const char* const message);
+        void writeToSinksUnlocked(const LogSeverityLevel level, const char* const message);
     protected:
         mutable QReadWriteLock _sinksLock;
         QSet< std::shared_ptr<ILogSink> > _sinks;
         mutable QMutex _logMutex;
         mutable QAtomicInt _severifyLevelThreshold;
+
+        // Queue is created once asynchronous mode is enabled for first time, and lives as long as logger does.
+        // It's accessed only via std::atomic_load() and std::atomic_store(), and threads that are logging hold
+        // reference to it, so it's never deleted under them
+        mutable QMutex _asyncQueueMutex;
+        std::shared_ptr<AsyncLogQueue> _asyncQueue;
+        QAtomicInt _isAsynchronous;
     public:
         virtual ~Logger();
 
+        // In asynchronous mode messages are formatted on calling thread into bounded lock-free queue,
+        // and written to sinks by background thread. Messages that don't fit into queue are dropped.
+        bool isAsynchronous() const;
+        void setAsynchronous(const bool asynchronous);
+        AsyncStatistics getAsyncStatistics() const;
+
         LogSeverityLevel getSeverityLevelThreshold() const;
         LogSeverityLevel setSeverityLevelThreshold(const LogSeverityLevel newThreshold);
 
@@ -55,7 +93,10 @@ namespace OsmAnd
         void log(const LogSeverityLevel level, const char* format, va_list args);
         void log(const LogSeverityLevel level, const char* format, ...);
 #endif // !defined(SWIG)
+        // Writes queued messages and flushes sinks
         void flush();
+        // Same as flush(), but does not wait for locks indefinitely. Intended for crash and terminate handlers
+        void flushOnCrash();
 
         static const std::shared_ptr<Logger>& get();
     };
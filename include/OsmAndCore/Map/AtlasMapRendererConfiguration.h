@@ -20,6 +20,12 @@ namespace OsmAnd
 
         float referenceTileSizeOnScreenInPixels;
 
+        // Compute symbols placement on background thread, while frames are rendered using last completed one.
+        // Placement computed for state that differs from current one is used for no longer than given
+        // staleness (in milliseconds), after that symbols are placed synchronously until worker catches up
+        bool asynchronousSymbolsPlacement;
+        unsigned int asynchronousSymbolsPlacementMaxStaleness;
+
         virtual void copyTo(MapRendererConfiguration& other) const;
         virtual std::shared_ptr<MapRendererConfiguration> createCopy() const;
 
@@ -51,6 +51,7 @@ namespace OsmAnd
         FIELD_ACTION(unsigned int, applyMinDistanceToSameContentFromOtherSymbolFilteringCalls, "");             \
         FIELD_ACTION(unsigned int, acceptedByMinDistanceToSameContentFromOtherSymbolFiltering, "");             \
         FIELD_ACTION(unsigned int, rejectedByMinDistanceToSameContentFromOtherSymbolFiltering, "");             \
+        FIELD_ACTION(float, symbolsPlacementAge, "s");                                                          \
         FIELD_ACTION(float, elapsedTimeForAddToIntersectionsCalls, "s");                                        \
         FIELD_ACTION(unsigned int, addToIntersectionsCalls, "");                                                \
         FIELD_ACTION(unsigned int, acceptedByAddToIntersections, "");                                           \
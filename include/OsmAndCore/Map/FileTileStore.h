@@ -0,0 +1,53 @@
+#ifndef _OSMAND_CORE_FILE_TILE_STORE_H_
+#define _OSMAND_CORE_FILE_TILE_STORE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QByteArray>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/Map/ITileStore.h>
+
+namespace OsmAnd
+{
+    // Each tile is kept as separate 'zoom/x/y.tile' file under given path, expiry is checked using file modification time
+    class OSMAND_CORE_API FileTileStore : public ITileStore
+    {
+        Q_DISABLE_COPY_AND_MOVE(FileTileStore);
+    private:
+    protected:
+    public:
+        FileTileStore(const QString& path, const int64_t expiryPeriod = NeverExpires);
+        virtual ~FileTileStore();
+
+        const QString path;
+        // In seconds
+        const int64_t expiryPeriod;
+
+        QString getTileFilename(const TileId tileId, const ZoomLevel zoom) const;
+
+        virtual bool obtainTile(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            QByteArray& outData,
+            bool* const pOutExpired = nullptr) Q_DECL_OVERRIDE;
+        virtual bool containsTile(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            bool* const pOutExpired = nullptr) const Q_DECL_OVERRIDE;
+        virtual bool storeTile(const TileId tileId, const ZoomLevel zoom, const QByteArray& data) Q_DECL_OVERRIDE;
+        virtual bool removeTile(const TileId tileId, const ZoomLevel zoom) Q_DECL_OVERRIDE;
+
+        // Walks whole directory tree
+        virtual uint64_t getTotalSize() const Q_DECL_OVERRIDE;
+
+        static QString getTileRelativePath(const TileId tileId, const ZoomLevel zoom);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_FILE_TILE_STORE_H_)
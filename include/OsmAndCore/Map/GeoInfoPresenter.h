@@ -12,7 +12,9 @@
 #include <OsmAndCore/PrivateImplementation.h>
 #include <OsmAndCore/CommonTypes.h>
 #include <OsmAndCore/GeoInfoDocument.h>
+#include <OsmAndCore/ColumnarTracksFile.h>
 #include <OsmAndCore/Data/MapObject.h>
+#include <OsmAndCore/Map/MapObjectsProvider.h>
 
 namespace OsmAnd
 {
@@ -56,10 +58,17 @@ namespace OsmAnd
             };
 
         private:
+            void addDocumentAttributes(
+                const std::shared_ptr<const GeoInfoDocument::ExtraData>& extraData,
+                const bool hasWaypoints,
+                const bool hasTrackpoints,
+                const bool hasRoutepoints);
         protected:
             MapObject(
                 const std::shared_ptr<const GeoInfoDocument>& geoInfoDocument,
                 const std::shared_ptr<const GeoInfoDocument::ExtraData>& extraData = nullptr);
+            // Object that isn't backed by GeoInfoDocument
+            MapObject(const bool hasWaypoints, const bool hasTrackpoints, const bool hasRoutepoints);
         public:
             virtual ~MapObject();
 
@@ -111,6 +120,27 @@ namespace OsmAnd
             const std::shared_ptr<const GeoInfoDocument::TrackSegment> trackSegment;
         };
 
+        // Track segment that is read right from ColumnarTracksFile, only when tile it crosses is requested
+        class OSMAND_CORE_API ColumnarTracklineMapObject
+            : public MapObject
+            , public MapObjectsProvider::IDeferredPolyline
+        {
+            Q_DISABLE_COPY_AND_MOVE(ColumnarTracklineMapObject);
+
+        public:
+            ColumnarTracklineMapObject(
+                const std::shared_ptr<const ColumnarTracksFile>& tracksFile,
+                const unsigned int segmentIndex,
+                const AreaI& segmentBBox31,
+                const QString& trackName);
+            virtual ~ColumnarTracklineMapObject();
+
+            const std::shared_ptr<const ColumnarTracksFile> tracksFile;
+            const unsigned int segmentIndex;
+
+            virtual bool readPoints31(QVector<PointI>& outPoints31) const Q_DECL_OVERRIDE;
+        };
+
         class OSMAND_CORE_API RoutepointMapObject : public MapObject
         {
             Q_DISABLE_COPY_AND_MOVE(RoutepointMapObject);
@@ -145,9 +175,14 @@ namespace OsmAnd
     public:
         GeoInfoPresenter(
             const QList< std::shared_ptr<const GeoInfoDocument> >& documents);
+        GeoInfoPresenter(
+            const QList< std::shared_ptr<const GeoInfoDocument> >& documents,
+            const QList< std::shared_ptr<const ColumnarTracksFile> >& tracksFiles);
         virtual ~GeoInfoPresenter();
 
         const QList< std::shared_ptr<const GeoInfoDocument> > documents;
+        // Opened files, which are presented by track lines only
+        const QList< std::shared_ptr<const ColumnarTracksFile> > tracksFiles;
 
         std::shared_ptr<IMapObjectsProvider> createMapObjectsProvider() const;
     };
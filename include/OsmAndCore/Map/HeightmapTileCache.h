@@ -0,0 +1,80 @@
+#ifndef _OSMAND_CORE_HEIGHTMAP_TILE_CACHE_H_
+#define _OSMAND_CORE_HEIGHTMAP_TILE_CACHE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QVector>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+
+namespace OsmAnd
+{
+    // Byte-bounded LRU cache of decoded heightmap tiles, as square row-major grids of elevations.
+    // Same tiles are requested over and over while panning, and each neighbour is needed again
+    // to stitch borders, so decoding them once saves most of decode time. Thread-safe.
+    class HeightmapTileCache_P;
+    class OSMAND_CORE_API HeightmapTileCache
+    {
+        Q_DISABLE_COPY_AND_MOVE(HeightmapTileCache);
+
+    public:
+        enum : unsigned int {
+            // Fits 2048 tiles of 32x32
+            DefaultCapacityInBytes = 8 * 1024 * 1024
+        };
+
+        struct OSMAND_CORE_API Statistics Q_DECL_FINAL
+        {
+            Statistics();
+
+            uint64_t hits;
+            uint64_t misses;
+            uint64_t evictions;
+            uint64_t stitchedTiles;
+            uint64_t missingNeighbours;
+            unsigned int entriesCount;
+            unsigned int sizeInBytes;
+            unsigned int capacityInBytes;
+
+            float getHitRatio() const;
+            QString toString(const QString& prefix = QString::null) const;
+        };
+
+    private:
+        PrivateImplementation<HeightmapTileCache_P> _p;
+    protected:
+    public:
+        HeightmapTileCache(const unsigned int capacityInBytes = DefaultCapacityInBytes);
+        virtual ~HeightmapTileCache();
+
+        // Zero capacity disables caching
+        unsigned int capacityInBytes() const;
+        void setCapacityInBytes(const unsigned int capacityInBytes);
+
+        // Empty grid marks tile that has no data
+        bool obtainTile(const TileId tileId, const ZoomLevel zoom, QVector<float>& outGrid);
+        void insertTile(const TileId tileId, const ZoomLevel zoom, const QVector<float>& grid);
+
+        // Builds grid of (tileSize + 2) x (tileSize + 2) elevations of cached tile with one-sample border
+        // taken from its cached neighbours, including diagonal ones. Neighbours are never decoded for that:
+        // border next to neighbour that is not cached or has no data repeats edge of the tile itself.
+        bool obtainStitchedTile(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            const unsigned int tileSize,
+            QVector<float>& outGrid,
+            unsigned int* const pOutMissingNeighboursCount = nullptr);
+
+        Statistics getStatistics() const;
+        void resetStatistics();
+        void clear();
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_HEIGHTMAP_TILE_CACHE_H_)
@@ -11,6 +11,7 @@
 #include <OsmAndCore/CommonTypes.h>
 #include <OsmAndCore/PrivateImplementation.h>
 #include <OsmAndCore/Map/IMapElevationDataProvider.h>
+#include <OsmAndCore/Map/HeightmapTileCache.h>
 
 namespace OsmAnd
 {
@@ -31,15 +32,25 @@ namespace OsmAnd
 
         void rebuildTileDbIndex();
 
+        // Decoded tiles are kept in this cache, it may be used to obtain tiles stitched with their neighbours
+        std::shared_ptr<HeightmapTileCache> getTileCache() const;
+
         virtual ZoomLevel getMinZoom() const;
         virtual ZoomLevel getMaxZoom() const;
         virtual uint32_t getTileSize() const;
 
+        virtual bool supportsNaturalObtainData() const Q_DECL_OVERRIDE;
         virtual bool obtainData(
             const IMapDataProvider::Request& request,
             std::shared_ptr<IMapDataProvider::Data>& outData,
             std::shared_ptr<Metric>* const pOutMetric = nullptr) Q_DECL_OVERRIDE;
 
+        virtual bool supportsNaturalObtainDataAsync() const Q_DECL_OVERRIDE;
+        virtual void obtainDataAsync(
+            const IMapDataProvider::Request& request,
+            const IMapDataProvider::ObtainDataAsyncCallback callback,
+            const bool collectMetric = false) Q_DECL_OVERRIDE;
+
         static const QString defaultIndexFilename;
     };
 }
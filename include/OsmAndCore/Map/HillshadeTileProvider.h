@@ -0,0 +1,103 @@
+#ifndef _OSMAND_CORE_HILLSHADE_TILE_PROVIDER_H_
+#define _OSMAND_CORE_HILLSHADE_TILE_PROVIDER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QtGlobal>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/Map/IRasterMapLayerProvider.h>
+#include <OsmAndCore/Map/IMapElevationDataProvider.h>
+
+namespace OsmAnd
+{
+    // Derives hillshade or slope tiles from elevation data on the fly. Tiles are black with alpha of shadow,
+    // to be drawn over other layers. Rendered tiles are cached. If elevation provider is HeightmapTileProvider,
+    // its cache of decoded tiles is used to stitch borders, so neighbours are decoded only once.
+    class HillshadeTileProvider_P;
+    class OSMAND_CORE_API HillshadeTileProvider Q_DECL_FINAL : public IRasterMapLayerProvider
+    {
+        Q_DISABLE_COPY_AND_MOVE(HillshadeTileProvider);
+    public:
+        enum class Mode
+        {
+            Hillshade,
+            // Light from zenith, so shading depends only on steepness
+            Slope,
+        };
+
+        enum : unsigned int {
+            DefaultCacheCapacityInBytes = 16 * 1024 * 1024
+        };
+
+    private:
+        PrivateImplementation<HillshadeTileProvider_P> _p;
+    protected:
+    public:
+        HillshadeTileProvider(
+            const std::shared_ptr<IMapElevationDataProvider>& elevationProvider,
+            const Mode mode = Mode::Hillshade,
+            const uint32_t tileSize = 256,
+            const float densityFactor = 1.0f,
+            const float azimuth = 315.0f,
+            const float altitude = 45.0f,
+            const float zFactor = 1.0f);
+        virtual ~HillshadeTileProvider();
+
+        const std::shared_ptr<IMapElevationDataProvider> elevationProvider;
+        const Mode mode;
+        const uint32_t tileSize;
+        const float densityFactor;
+
+        // In degrees, clockwise from north
+        const float azimuth;
+        // In degrees above horizon
+        const float altitude;
+        const float zFactor;
+
+        // Zero capacity disables caching of rendered tiles
+        unsigned int getCacheCapacityInBytes() const;
+        void setCacheCapacityInBytes(const unsigned int capacityInBytes);
+        unsigned int getCachedTilesCount() const;
+        void clearCache();
+
+        virtual MapStubStyle getDesiredStubsStyle() const;
+
+        virtual float getTileDensityFactor() const;
+        virtual uint32_t getTileSize() const;
+
+        virtual bool supportsNaturalObtainData() const Q_DECL_OVERRIDE;
+        virtual bool obtainData(
+            const IMapDataProvider::Request& request,
+            std::shared_ptr<IMapDataProvider::Data>& outData,
+            std::shared_ptr<Metric>* const pOutMetric = nullptr) Q_DECL_OVERRIDE;
+
+        virtual bool supportsNaturalObtainDataAsync() const Q_DECL_OVERRIDE;
+        virtual void obtainDataAsync(
+            const IMapDataProvider::Request& request,
+            const IMapDataProvider::ObtainDataAsyncCallback callback,
+            const bool collectMetric = false) Q_DECL_OVERRIDE;
+
+        virtual ZoomLevel getMinZoom() const;
+        virtual ZoomLevel getMaxZoom() const;
+
+        // Computes shading of size x size cells from (size + 2) x (size + 2) elevations in meters, that include
+        // one-cell border, using Horn's method. 255 is fully lit (or flat for slope), 0 is in shadow.
+        static void computeShading(
+            const float* const pElevations,
+            const unsigned int size,
+            const float cellSize,
+            const Mode mode,
+            const float azimuth,
+            const float altitude,
+            const float zFactor,
+            uint8_t* const pOutShading,
+            const bool allowVectorized = true);
+        static bool isVectorizedShadingSupported();
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_HILLSHADE_TILE_PROVIDER_H_)
@@ -5,6 +5,7 @@
 
 #include <OsmAndCore/QtExtensions.h>
 #include <QList>
+#include <QVector>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/CommonTypes.h>
@@ -56,6 +57,8 @@ namespace OsmAnd
         virtual ~IMapKeyedDataProvider();
 
         virtual QList<Key> getProvidedDataKeys() const = 0;
+        // Keys of data needed to present given tiles. By default, it's all provided data
+        virtual QList<Key> getProvidedDataKeysForTiles(const QVector<TileId>& tiles, const ZoomLevel zoom) const;
         virtual bool obtainKeyedData(
             const Request& request,
             std::shared_ptr<Data>& outKeyedData,
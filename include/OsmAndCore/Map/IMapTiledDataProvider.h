@@ -4,6 +4,9 @@
 #include <OsmAndCore/stdlib_common.h>
 
 #include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QVector>
+#include <OsmAndCore/restore_internal_warnings.h>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/CommonTypes.h>
@@ -50,6 +53,20 @@ namespace OsmAnd
             Request(const Request& that);
         };
 
+        // Tiles that are likely to be requested soon, in order of priority
+        struct OSMAND_CORE_API PrefetchHint
+        {
+            PrefetchHint();
+            ~PrefetchHint();
+
+            // Tiles around visible area, ones in direction of movement go first
+            QVector<TileId> tileIds;
+            ZoomLevel zoom;
+
+            // Tiles of next zoom level under center of visible area
+            QVector<TileId> nextZoomTileIds;
+        };
+
     private:
     protected:
         IMapTiledDataProvider();
@@ -63,6 +80,9 @@ namespace OsmAnd
             const Request& request,
             std::shared_ptr<Data>& outTiledData,
             std::shared_ptr<Metric>* const pOutMetric = nullptr);
+
+        // Each hint replaces previous one. Does nothing by default
+        virtual void prefetch(const PrefetchHint& hint);
     };
 }
 
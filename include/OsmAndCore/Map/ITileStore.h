@@ -0,0 +1,48 @@
+#ifndef _OSMAND_CORE_I_TILE_STORE_H_
+#define _OSMAND_CORE_I_TILE_STORE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QByteArray>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+
+namespace OsmAnd
+{
+    // Local storage of downloaded tiles. Tile with empty data is a tile that is known to not exist.
+    // Implementations must allow access from any thread.
+    class OSMAND_CORE_API ITileStore
+    {
+        Q_DISABLE_COPY_AND_MOVE(ITileStore);
+    public:
+        enum : int64_t {
+            NeverExpires = 0,
+        };
+
+    private:
+    protected:
+        ITileStore();
+    public:
+        virtual ~ITileStore();
+
+        // Returns false if tile is not stored. Expired tile is still returned, with pOutExpired set
+        virtual bool obtainTile(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            QByteArray& outData,
+            bool* const pOutExpired = nullptr) = 0;
+        // Same as obtainTile(), but without reading data and without counting as access
+        virtual bool containsTile(const TileId tileId, const ZoomLevel zoom, bool* const pOutExpired = nullptr) const = 0;
+        virtual bool storeTile(const TileId tileId, const ZoomLevel zoom, const QByteArray& data) = 0;
+        virtual bool removeTile(const TileId tileId, const ZoomLevel zoom) = 0;
+
+        // Size of stored tiles data in bytes
+        virtual uint64_t getTotalSize() const = 0;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_I_TILE_STORE_H_)
@@ -2,6 +2,7 @@
 #define _OSMAND_CORE_MAP_COMMON_TYPES_H_
 
 #include <OsmAndCore/stdlib_common.h>
+#include <bitset>
 
 #include <OsmAndCore/QtExtensions.h>
 
@@ -35,6 +36,11 @@ namespace OsmAnd
     };
 
     typedef int MapSymbolIntersectionClassId;
+    enum : unsigned int {
+        MaxMapSymbolIntersectionClassesCount = 256
+    };
+    // Indexed by MapSymbolIntersectionClassId, so intersection tests are AND of words plus popcount
+    typedef std::bitset<MaxMapSymbolIntersectionClassesCount> MapSymbolIntersectionClassesSet;
 
     enum class MapStyleRulesetType
     {
@@ -8,6 +8,8 @@
 #include <QHash>
 
 #include <OsmAndCore.h>
+#include <OsmAndCore/Callable.h>
+#include <OsmAndCore/Observable.h>
 #include <OsmAndCore/PrivateImplementation.h>
 #include <OsmAndCore/CommonTypes.h>
 #include <OsmAndCore/PointsAndAreas.h>
@@ -115,6 +117,11 @@ namespace OsmAnd
 
         std::shared_ptr<SymbolsGroup> createSymbolsGroup() const;
 
+        OSMAND_OBSERVER_CALLABLE(PositionChanged,
+            const MapMarker* const marker,
+            const PointI previousPosition);
+        const ObservableAs<MapMarker::PositionChanged> positionChangeObservable;
+
     friend class OsmAnd::MapMarkerBuilder;
     friend class OsmAnd::MapMarkerBuilder_P;
     friend class OsmAnd::MapMarkersCollection;
@@ -6,6 +6,7 @@
 
 #include <OsmAndCore/QtExtensions.h>
 #include <QList>
+#include <QVector>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/PrivateImplementation.h>
@@ -25,6 +26,17 @@ namespace OsmAnd
     {
         Q_DISABLE_COPY_AND_MOVE(MapMarkersCollection);
 
+    public:
+        struct Cluster
+        {
+            ZoomLevel zoom;
+            // Mean position of clustered markers
+            PointI position31;
+            QList< std::shared_ptr<MapMarker> > markers;
+        };
+
+        typedef std::function< std::shared_ptr<MapSymbolsGroup>(const Cluster& cluster) > ClusterSymbolsGroupFactory;
+
     private:
         PrivateImplementation<MapMarkersCollection_P> _p;
     protected:
@@ -36,10 +48,19 @@ namespace OsmAnd
         bool removeMarker(const std::shared_ptr<MapMarker>& marker);
         void removeAllMarkers();
 
+        // Up to given zoom, markers that fall into same quarter of tile are presented by a single cluster.
+        // Without factory, cluster is presented by one of its markers
+        void setClusteringEnabled(const bool enabled, const ZoomLevel maxClusteredZoom = ZoomLevel16);
+        bool isClusteringEnabled() const;
+        void setClusterSymbolsGroupFactory(const ClusterSymbolsGroupFactory factory);
+
         const ZoomLevel minZoom;
         const ZoomLevel maxZoom;
 
         virtual QList<IMapKeyedSymbolsProvider::Key> getProvidedDataKeys() const;
+        virtual QList<IMapKeyedSymbolsProvider::Key> getProvidedDataKeysForTiles(
+            const QVector<TileId>& tiles,
+            const ZoomLevel zoom) const Q_DECL_OVERRIDE;
 
         virtual bool supportsNaturalObtainData() const Q_DECL_OVERRIDE;
         virtual bool obtainData(
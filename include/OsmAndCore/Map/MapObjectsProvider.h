@@ -4,6 +4,9 @@
 #include <OsmAndCore/stdlib_common.h>
 
 #include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QVector>
+#include <OsmAndCore/restore_internal_warnings.h>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/CommonTypes.h>
@@ -19,14 +22,32 @@ namespace OsmAnd
     {
         Q_DISABLE_COPY_AND_MOVE(MapObjectsProvider);
 
+    public:
+        // Polyline that keeps no points and reads them each time tile it crosses is requested,
+        // so its bbox31 has to be set upfront. Such map objects are always clipped
+        class OSMAND_CORE_API IDeferredPolyline
+        {
+        private:
+        protected:
+            IDeferredPolyline();
+        public:
+            virtual ~IDeferredPolyline();
+
+            virtual bool readPoints31(QVector<PointI>& outPoints31) const = 0;
+        };
+
     private:
         PrivateImplementation<MapObjectsProvider_P> _p;
     protected:
     public:
-        MapObjectsProvider(const QList< std::shared_ptr<const MapObject> >& mapObjects);
+        MapObjectsProvider(
+            const QList< std::shared_ptr<const MapObject> >& mapObjects,
+            const bool clipPolylines = false);
         virtual ~MapObjectsProvider();
 
         const QList< std::shared_ptr<const MapObject> > mapObjects;
+        // Polylines are simplified for requested zoom and only their pieces that cross requested tile are provided
+        const bool clipPolylines;
 
         virtual ZoomLevel getMinZoom() const;
         virtual ZoomLevel getMaxZoom() const;
@@ -45,7 +45,7 @@ namespace OsmAnd
 
         int order;
         ContentClass contentClass;
-        QSet<MapSymbolIntersectionClassId> intersectsWithClasses;
+        MapSymbolIntersectionClassesSet intersectsWithClasses;
 
         bool isHidden;
         FColorARGB modulationColor;
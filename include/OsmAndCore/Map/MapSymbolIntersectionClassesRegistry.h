@@ -30,6 +30,9 @@ namespace OsmAnd
         static MapSymbolIntersectionClassesRegistry& globalInstance();
 
         QString getClassNameById(const ClassId classId) const;
+
+        // Class ids are limited by MaxMapSymbolIntersectionClassesCount. Once limit is reached,
+        // new class names are mapped to 'any' class, so that symbols are hidden rather than overlapped
         ClassId getOrRegisterClassIdByName(const QString& className);
 
         // Predefined 'any' class
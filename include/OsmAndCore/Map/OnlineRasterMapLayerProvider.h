@@ -15,6 +15,7 @@
 #include <OsmAndCore/WebClient.h>
 #include <OsmAndCore/Map/MapCommonTypes.h>
 #include <OsmAndCore/Map/IRasterMapLayerProvider.h>
+#include <OsmAndCore/Map/ITileStore.h>
 
 namespace OsmAnd
 {
@@ -22,6 +23,27 @@ namespace OsmAnd
     class OSMAND_CORE_API OnlineRasterMapLayerProvider : public IRasterMapLayerProvider
     {
         Q_DISABLE_COPY_AND_MOVE(OnlineRasterMapLayerProvider);
+    public:
+        struct OSMAND_CORE_API PrefetchStatistics
+        {
+            PrefetchStatistics();
+            ~PrefetchStatistics();
+
+            // Prefetch downloads that were started
+            unsigned int startedCount;
+            // Tiles downloaded by prefetch, including tiles that do not exist
+            unsigned int downloadedCount;
+            // Prefetched tiles that were requested afterwards or while being downloaded
+            unsigned int usefulCount;
+            // Prefetched tiles that were not requested so far
+            unsigned int wastedCount;
+            // Downloads cancelled since tiles are no longer hinted
+            unsigned int cancelledCount;
+            // Queued tiles that were no longer hinted before download started
+            unsigned int droppedCount;
+            unsigned int failedCount;
+        };
+
     private:
         PrivateImplementation<OnlineRasterMapLayerProvider_P> _p;
     protected:
@@ -70,9 +92,21 @@ namespace OsmAnd
         void setLocalCachePath(const QString& localCachePath, const bool appendPathSuffix = true);
         const QString& localCachePath;
 
+        // Replaces per-file cache at local cache path, nullptr disables local cache
+        void setLocalTileStore(const std::shared_ptr<ITileStore>& localTileStore);
+        std::shared_ptr<ITileStore> getLocalTileStore() const;
+
         void setNetworkAccessPermission(bool allowed);
         const bool& networkAccessAllowed;
 
+        // Prefetch uses asynchronous requests, so it's available only with WebClient. Prefetched tiles
+        // are put to local tile store and prefetch is disabled without one
+        void setPrefetchEnabled(const bool enabled);
+        bool isPrefetchEnabled() const;
+        PrefetchStatistics getPrefetchStatistics() const;
+        void resetPrefetchStatistics();
+        virtual void prefetch(const PrefetchHint& hint) Q_DECL_OVERRIDE;
+
         virtual MapStubStyle getDesiredStubsStyle() const;
 
         virtual float getTileDensityFactor() const;
@@ -0,0 +1,66 @@
+#ifndef _OSMAND_CORE_RASTERIZED_TEXT_CACHE_H_
+#define _OSMAND_CORE_RASTERIZED_TEXT_CACHE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+
+namespace OsmAnd
+{
+    class SymbolRasterizer_P;
+
+    // Byte-bounded LRU cache of rasterized text symbols (text with shield or underlay icon) that
+    // is shared between all symbol rasterizers, since same captions repeat across adjacent tiles
+    // and successive zoom levels. Thread-safe.
+    class RasterizedTextCache_P;
+    class OSMAND_CORE_API RasterizedTextCache
+    {
+        Q_DISABLE_COPY_AND_MOVE(RasterizedTextCache);
+
+    public:
+        enum : unsigned int {
+            DefaultCapacityInBytes = 16 * 1024 * 1024
+        };
+
+        struct OSMAND_CORE_API Statistics Q_DECL_FINAL
+        {
+            Statistics();
+
+            uint64_t hits;
+            uint64_t misses;
+            uint64_t evictions;
+            unsigned int entriesCount;
+            unsigned int sizeInBytes;
+            unsigned int capacityInBytes;
+
+            float getHitRatio() const;
+            QString toString(const QString& prefix = QString::null) const;
+        };
+
+    private:
+        PrivateImplementation<RasterizedTextCache_P> _p;
+    protected:
+    public:
+        RasterizedTextCache(const unsigned int capacityInBytes = DefaultCapacityInBytes);
+        virtual ~RasterizedTextCache();
+
+        // Zero capacity disables caching
+        unsigned int capacityInBytes() const;
+        void setCapacityInBytes(const unsigned int capacityInBytes);
+
+        Statistics getStatistics() const;
+        void resetStatistics();
+        void clear();
+
+        static std::shared_ptr<RasterizedTextCache> getDefault();
+
+    friend class OsmAnd::SymbolRasterizer_P;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_RASTERIZED_TEXT_CACHE_H_)
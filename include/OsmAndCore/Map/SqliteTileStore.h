@@ -0,0 +1,82 @@
+#ifndef _OSMAND_CORE_SQLITE_TILE_STORE_H_
+#define _OSMAND_CORE_SQLITE_TILE_STORE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QByteArray>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/Map/ITileStore.h>
+
+namespace OsmAnd
+{
+    // All tiles of a layer are packed into single SQLite database with MBTiles-compatible 'tiles' table
+    // (rows are in TMS order), extended with creation and last access time of each tile.
+    // When total size of tiles data exceeds maximal size, least recently used tiles are evicted.
+    // Access times are kept in memory and written in batches, so lookups do not write to database.
+    // Access is serialized, store may be used from any thread.
+    class SqliteTileStore_P;
+    class OSMAND_CORE_API SqliteTileStore : public ITileStore
+    {
+        Q_DISABLE_COPY_AND_MOVE(SqliteTileStore);
+    public:
+        enum : uint64_t {
+            Unbounded = 0,
+        };
+
+    private:
+        PrivateImplementation<SqliteTileStore_P> _p;
+    protected:
+    public:
+        SqliteTileStore(
+            const QString& filename,
+            const uint64_t maxSize = Unbounded,
+            const int64_t expiryPeriod = NeverExpires);
+        virtual ~SqliteTileStore();
+
+        const QString filename;
+        // In bytes of tiles data
+        const uint64_t maxSize;
+        // In seconds
+        const int64_t expiryPeriod;
+
+        bool open();
+        void close();
+        bool isOpened() const;
+
+        // Writes pending access times
+        bool flush();
+
+        unsigned int getTilesCount() const;
+        uint64_t getEvictedTilesCount() const;
+
+        // Imports tiles from 'zoom/x/y.tile' layout of FileTileStore, keeping modification time as creation time.
+        // Imported files are removed, so interrupted import may be continued by calling it again.
+        bool importDirectory(
+            const QString& path,
+            const bool removeImportedFiles = true,
+            unsigned int* const pOutImportedCount = nullptr);
+
+        virtual bool obtainTile(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            QByteArray& outData,
+            bool* const pOutExpired = nullptr) Q_DECL_OVERRIDE;
+        virtual bool containsTile(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            bool* const pOutExpired = nullptr) const Q_DECL_OVERRIDE;
+        virtual bool storeTile(const TileId tileId, const ZoomLevel zoom, const QByteArray& data) Q_DECL_OVERRIDE;
+        virtual bool removeTile(const TileId tileId, const ZoomLevel zoom) Q_DECL_OVERRIDE;
+
+        virtual uint64_t getTotalSize() const Q_DECL_OVERRIDE;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_SQLITE_TILE_STORE_H_)
@@ -14,6 +14,7 @@
 #include <OsmAndCore/TextRasterizer.h>
 #include <OsmAndCore/Map/MapCommonTypes.h>
 #include <OsmAndCore/Map/MapPrimitiviser.h>
+#include <OsmAndCore/Map/RasterizedTextCache.h>
 
 class SkCanvas;
 class SkBitmap;
@@ -114,11 +115,15 @@ namespace OsmAnd
     protected:
     public:
         SymbolRasterizer(
-            const std::shared_ptr<const TextRasterizer>& textRasterizer = TextRasterizer::getDefault());
+            const std::shared_ptr<const TextRasterizer>& textRasterizer = TextRasterizer::getDefault(),
+            const std::shared_ptr<RasterizedTextCache>& rasterizedTextCache = RasterizedTextCache::getDefault());
         virtual ~SymbolRasterizer();
 
         const std::shared_ptr<const TextRasterizer> textRasterizer;
 
+        // May be null, then text symbols are rasterized each time
+        const std::shared_ptr<RasterizedTextCache> rasterizedTextCache;
+
         virtual void rasterize(
             const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects>& primitivisedObjects,
             QList< std::shared_ptr<const RasterizedSymbolsGroup> >& outSymbolsGroups,
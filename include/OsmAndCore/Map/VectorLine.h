@@ -88,6 +88,8 @@ namespace OsmAnd
 
         QVector<PointI> getPoints() const;
         void setPoints(const QVector<PointI>& points);
+        // Cheaper than setPoints() for growing lines, since geometry of existing points is reused
+        void appendPoints(const QVector<PointI>& points);
 
         bool hasUnappliedChanges() const;
 
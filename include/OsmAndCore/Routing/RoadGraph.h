@@ -0,0 +1,74 @@
+#ifndef _OSMAND_CORE_ROAD_GRAPH_H_
+#define _OSMAND_CORE_ROAD_GRAPH_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QList>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+
+namespace OsmAnd
+{
+    class Road;
+    class ObfDataInterface;
+    class IQueryController;
+    class RoutingProfileContext;
+    class RoutePlanner_P;
+
+    // Road network in compressed sparse rows layout. Nodes are ends of roads and points shared by several roads,
+    // edges are parts of roads between two nodes, one edge for each allowed direction. Edges of a node are stored
+    // contiguously in flat arrays of targets and travel times, once grouped by source node for forward search and
+    // once grouped by target node for backward search.
+    // Access, oneway, speed and obstacle rules of routing profile are evaluated only while graph is built.
+    // Turn restrictions are applied by giving restricted incoming edge own copy of its target node, with only allowed
+    // outgoing edges, so there may be several nodes at same position.
+    // Graph is immutable and may be shared by route planners from any thread.
+    class RoadGraph_P;
+    class OSMAND_CORE_API RoadGraph Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoadGraph);
+    public:
+        typedef uint32_t NodeIndex;
+        typedef uint32_t EdgeIndex;
+
+        enum : uint32_t {
+            InvalidIndex = 0xFFFFFFFFu,
+        };
+
+    private:
+        PrivateImplementation<RoadGraph_P> _p;
+    protected:
+        RoadGraph();
+    public:
+        ~RoadGraph();
+
+        unsigned int getNodesCount() const;
+        unsigned int getEdgesCount() const;
+        unsigned int getRoadsCount() const;
+
+        PointI getNodePosition31(const NodeIndex nodeIndex) const;
+        NodeIndex findNearestNode(const PointI& point31) const;
+
+        // Fastest travel speed of all edges in meters per second, route planner estimates remaining time with it
+        float getMaxSpeed() const;
+
+        static std::shared_ptr<const RoadGraph> build(
+            const QList< std::shared_ptr<const Road> >& roads,
+            const std::shared_ptr<RoutingProfileContext>& profileContext);
+        static std::shared_ptr<const RoadGraph> load(
+            const std::shared_ptr<ObfDataInterface>& dataInterface,
+            const std::shared_ptr<RoutingProfileContext>& profileContext,
+            const AreaI* const bbox31 = nullptr,
+            const std::shared_ptr<const IQueryController>& queryController = nullptr);
+
+    friend class OsmAnd::RoadGraph_P;
+    friend class OsmAnd::RoutePlanner_P;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ROAD_GRAPH_H_)
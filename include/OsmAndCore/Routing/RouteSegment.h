@@ -1,66 +1,47 @@
 #ifndef _OSMAND_CORE_ROUTE_SEGMENT_H_
 #define _OSMAND_CORE_ROUTE_SEGMENT_H_
 
-#include <limits>
-#include <memory>
+#include <OsmAndCore/stdlib_common.h>
 
 #include <OsmAndCore/QtExtensions.h>
-#include <OsmAndCore/ignore_warnings_on_external_includes.h>
-#include <QList>
-#include <QVector>
-#include <OsmAndCore/restore_internal_warnings.h>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/Data/Road.h>
-#include <OsmAndCore/Routing/TurnInfo.h>
 
-namespace OsmAnd {
+namespace OsmAnd
+{
+    class RoutePlanner_P;
 
-    class RoutePlannerAnalyzer;
-    class RoutePlanner;
-
-    class OSMAND_CORE_API RouteSegment
+    // Part of route that passes road from start point to end point (end point index is less than start
+    // point index if road is passed in opposite order of its points)
+    class OSMAND_CORE_API RouteSegment Q_DECL_FINAL
     {
+        Q_DISABLE_COPY_AND_MOVE(RouteSegment);
     private:
     protected:
-        RouteSegment(const std::shared_ptr<const Road>& road, uint32_t startPointIndex, uint32_t endPointIndex);
-
-        const std::shared_ptr<const Road> _road;
-        uint32_t _startPointIndex;
-        uint32_t _endPointIndex;
-        QVector< QList< std::shared_ptr<RouteSegment> > > _attachedRoutes;
-
-        float _distance;
-        float _speed;
-        float _time;
-        QString _description;
-        // this make not possible to make turns in between segment result for now
-        TurnInfo _turnType;
-
-        void dump(const QString& prefix = QString::null) const;
+        RouteSegment(
+            const std::shared_ptr<const Road>& road,
+            const uint32_t startPointIndex,
+            const uint32_t endPointIndex,
+            const float distance,
+            const float time);
     public:
-        virtual ~RouteSegment();
-
-        const std::shared_ptr<const Road>& road;
-        const uint32_t& startPointIndex;
-        const uint32_t& endPointIndex;
-        const QVector< QList< std::shared_ptr<RouteSegment> > >& attachedRoutes;
+        ~RouteSegment();
 
-        const QString& description;
-        const TurnInfo& turnInfo;
+        const std::shared_ptr<const Road> road;
+        const uint32_t startPointIndex;
+        const uint32_t endPointIndex;
 
-        const float& distance;
-        const float& speed;
-        const float& time;
+        // Distance in meters and travel time in seconds
+        const float distance;
+        const float time;
 
-        double getBearing(uint32_t pointIndex, bool isIncrement) const;
+        double getBearing(const uint32_t pointIndex, const bool isIncrement) const;
         double getBearingBegin() const;
         double getBearingEnd() const;
 
-        friend class OsmAnd::RoutePlanner;
-        friend class OsmAnd::RoutePlannerAnalyzer;
+    friend class OsmAnd::RoutePlanner_P;
     };
+}
 
-} // namespace OsmAnd
-
-#endif // !defined(_OSMAND_CORE_ROUTE_PLANNER_H_)
+#endif // !defined(_OSMAND_CORE_ROUTE_SEGMENT_H_)
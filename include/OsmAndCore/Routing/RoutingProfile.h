@@ -10,7 +10,6 @@
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/Routing/RoutingRuleset.h>
-#include <OsmAndCore/Data/Model/Road.h>
 
 namespace OsmAnd {
 
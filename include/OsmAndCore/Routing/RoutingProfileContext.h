@@ -6,24 +6,42 @@
 #include <OsmAndCore/QtExtensions.h>
 #include <QString>
 #include <QHash>
+#include <QVector>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/Routing/RoutingProfile.h>
 #include <OsmAndCore/Routing/RoutingRulesetContext.h>
-#include <OsmAndCore/Data/Model/Road.h>
+#include <OsmAndCore/Data/Road.h>
 
 namespace OsmAnd {
 
     class ObfRoutingSectionInfo;
-    class ObfRoutingBorderLinePoint;
 
     class OSMAND_CORE_API RoutingProfileContext
     {
+    public:
+        // Results of way rules, that depend only on set of road types
+        struct RoadRules
+        {
+            float speed;
+            float priority;
+            int8_t direction;
+            bool accepted;
+
+            inline RoadDirection getDirection() const
+            {
+                return static_cast<RoadDirection>(direction);
+            }
+        };
+
     private:
     protected:
         std::shared_ptr<RoutingRulesetContext> _rulesetContexts[RoutingRuleset::TypesCount];
 
         QHash< std::shared_ptr<const ObfRoutingSectionInfo>, QMap<uint32_t, uint32_t> > _tagValueAttribIdCache;
+
+        // Types are ids of section encoding rules, so each section has own set of cached rules
+        QHash< std::shared_ptr<const ObfRoutingSectionInfo>, QHash< QVector<uint32_t>, RoadRules > > _roadRulesCache;
     public:
         RoutingProfileContext(const std::shared_ptr<RoutingProfile>& profile, QHash<QString, QString>* contextValues = nullptr);
         virtual ~RoutingProfileContext();
@@ -32,13 +50,21 @@ namespace OsmAnd {
 
         std::shared_ptr<RoutingRulesetContext> getRulesetContext(RoutingRuleset::Type type);
 
-        Model::RoadDirection getDirection(const std::shared_ptr<const OsmAnd::Model::Road>& road);
-        bool acceptsRoad(const std::shared_ptr<const OsmAnd::Model::Road>& road);
-        bool acceptsBorderLinePoint(const std::shared_ptr<const ObfRoutingSectionInfo>& section, const std::shared_ptr<const ObfRoutingBorderLinePoint>& point);
-        float getSpeedPriority(const std::shared_ptr<const OsmAnd::Model::Road>& road);
-        float getSpeed(const std::shared_ptr<const OsmAnd::Model::Road>& road);
-        float getObstaclesExtraTime(const std::shared_ptr<const OsmAnd::Model::Road>& road, uint32_t pointIndex);
-        float getRoutingObstaclesExtraTime(const std::shared_ptr<const OsmAnd::Model::Road>& road, uint32_t pointIndex);
+        RoadDirection getDirection(const std::shared_ptr<const OsmAnd::Road>& road);
+        bool acceptsRoad(const std::shared_ptr<const OsmAnd::Road>& road);
+        float getSpeedPriority(const std::shared_ptr<const OsmAnd::Road>& road);
+        float getSpeed(const std::shared_ptr<const OsmAnd::Road>& road);
+        float getObstaclesExtraTime(const std::shared_ptr<const OsmAnd::Road>& road, uint32_t pointIndex);
+        float getRoutingObstaclesExtraTime(const std::shared_ptr<const OsmAnd::Road>& road, uint32_t pointIndex);
+
+        // Same as evaluating access, speed, priority and direction separately, but rules are evaluated only once
+        // for each distinct set of road types. RoadGraph takes rules from here only while it's built, since route
+        // search reads precomputed edge times, so caching speeds up graph build and not the search itself.
+        RoadRules getRoadRules(const std::shared_ptr<const OsmAnd::Road>& road);
+        unsigned int getCachedRoadRulesCount() const;
+
+        // Number of rulesets evaluations made by this context so far
+        uint64_t getRulesEvaluationsCount() const;
 
         friend class OsmAnd::RoutingRulesetContext;
     };
@@ -75,12 +75,18 @@ namespace OsmAnd
         typedef SharedResourcesContainer<KEY_TYPE, RESOURCE_TYPE> base;
 
         typedef std::shared_ptr<AvailableResourceEntry> AvailableResourceEntryPtr;
-        QSet< AvailableResourceEntryPtr > _availableResourceEntriesStorage;
-        std::array< QHash< KEY_TYPE, AvailableResourceEntryPtr >, ZoomLevelsCount> _availableResources;
-
         typedef std::shared_ptr<PromisedResourceEntry> PromisedResourceEntryPtr;
-        QSet< PromisedResourceEntryPtr > _promisedResourceEntriesStorage;
-        std::array< QHash< KEY_TYPE, PromisedResourceEntryPtr >, ZoomLevelsCount> _promisedResources;
+
+        // All zoom levels of a key live in the same stripe, guarded by the lock of that stripe in base
+        struct Stripe
+        {
+            QSet< AvailableResourceEntryPtr > availableResourceEntriesStorage;
+            std::array< QHash< KEY_TYPE, AvailableResourceEntryPtr >, ZoomLevelsCount> availableResources;
+
+            QSet< PromisedResourceEntryPtr > promisedResourceEntriesStorage;
+            std::array< QHash< KEY_TYPE, PromisedResourceEntryPtr >, ZoomLevelsCount> promisedResources;
+        };
+        std::array< Stripe, base::StripesCount > _stripes;
     protected:
     public:
         SharedByZoomResourcesContainer()
@@ -92,7 +98,9 @@ namespace OsmAnd
 
         void insert(const KEY_TYPE& key, const QSet<ZoomLevel>& levels, ResourcePtr& resourcePtr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->insert(%s, [%s], %p)",
@@ -114,19 +122,21 @@ namespace OsmAnd
             {
                 // Resource must not be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(!_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(!stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                _availableResources[level].insert(key, newEntryPtr);
+                stripe.availableResources[level].insert(key, newEntryPtr);
             }
             
-            _availableResourceEntriesStorage.insert(qMove(newEntryPtr));
+            stripe.availableResourceEntriesStorage.insert(qMove(newEntryPtr));
         }
 
 #ifdef Q_COMPILER_RVALUE_REFS
         void insert(const KEY_TYPE& key, const QSet<ZoomLevel>& levels, ResourcePtr&& resourcePtr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->insert(%s, [%s], %p)",
@@ -144,19 +154,21 @@ namespace OsmAnd
             {
                 // Resource must not be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(!_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(!stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                _availableResources[level].insert(key, newEntryPtr);
+                stripe.availableResources[level].insert(key, newEntryPtr);
             }
 
-            _availableResourceEntriesStorage.insert(qMove(newEntryPtr));
+            stripe.availableResourceEntriesStorage.insert(qMove(newEntryPtr));
         }
 #endif // Q_COMPILER_RVALUE_REFS
 
         void insertAndReference(const KEY_TYPE& key, const QSet<ZoomLevel>& levels, const ResourcePtr& resourcePtr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->insertAndReference(%s, [%s], %p)",
@@ -173,18 +185,20 @@ namespace OsmAnd
             {
                 // Resource must not be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(!_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(!stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                _availableResources[level].insert(key, newEntryPtr);
+                stripe.availableResources[level].insert(key, newEntryPtr);
             }
 
-            _availableResourceEntriesStorage.insert(qMove(newEntryPtr));
+            stripe.availableResourceEntriesStorage.insert(qMove(newEntryPtr));
         }
 
         bool obtainReference(const KEY_TYPE& key, const ZoomLevel level, ResourcePtr& outResourcePtr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->obtainReference(%s, [%d],...)",
@@ -195,7 +209,7 @@ namespace OsmAnd
 #endif
 
             // In case resource was promised, wait forever until promise is fulfilled
-            const auto& promisedResources = _promisedResources[level];
+            const auto& promisedResources = stripe.promisedResources[level];
             const auto& itPromisedResourceEntry = promisedResources.constFind(key);
             if (itPromisedResourceEntry != promisedResources.cend())
             {
@@ -214,7 +228,7 @@ namespace OsmAnd
                 return false;
             }
 
-            auto& availableResources = _availableResources[level];
+            auto& availableResources = stripe.availableResources[level];
             const auto& itAvailableResourceEntry = availableResources.find(key);
             if (itAvailableResourceEntry == availableResources.end())
                 return false;
@@ -228,7 +242,9 @@ namespace OsmAnd
 
         bool releaseReference(const KEY_TYPE& key, const ZoomLevel level, ResourcePtr& resourcePtr, const bool autoClean = true, bool* outWasCleaned = nullptr, uintmax_t* outRemainingReferences = nullptr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->releaseReference(%s, [%d], %p, ...)",
@@ -240,9 +256,9 @@ namespace OsmAnd
 #endif
 
             // Resource must not be promised. Otherwise behavior is undefined
-            assert(!_promisedResources[level].contains(key));
+            assert(!stripe.promisedResources[level].contains(key));
 
-            auto& availableResources = _availableResources[level];
+            auto& availableResources = stripe.availableResources[level];
             const auto& itAvailableResourceEntry = availableResources.find(key);
             if (itAvailableResourceEntry == availableResources.end())
                 return false;
@@ -262,11 +278,11 @@ namespace OsmAnd
                     if (otherLevel == level)
                         continue;
 
-                    const auto removedCount = _availableResources[otherLevel].remove(key);
+                    const auto removedCount = stripe.availableResources[otherLevel].remove(key);
                     assert(removedCount == 1);
                 }
 
-                _availableResourceEntriesStorage.remove(availableResourceEntry);
+                stripe.availableResourceEntriesStorage.remove(availableResourceEntry);
                 availableResources.erase(itAvailableResourceEntry);
 
                 if (outWasCleaned)
@@ -279,7 +295,9 @@ namespace OsmAnd
         
         void makePromise(const KEY_TYPE& key, const QSet<ZoomLevel>& levels)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->makePromise(%s, [%s])",
@@ -295,18 +313,20 @@ namespace OsmAnd
             {
                 // Resource must not be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(!_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(!stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                _promisedResources[level].insert(key, newEntryPtr);
+                stripe.promisedResources[level].insert(key, newEntryPtr);
             }
 
-            _promisedResourceEntriesStorage.insert(qMove(newEntryPtr));
+            stripe.promisedResourceEntriesStorage.insert(qMove(newEntryPtr));
         }
 
         void breakPromise(const KEY_TYPE& key, const QSet<ZoomLevel>& levels)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->breakPromise(%s, [%s])",
@@ -321,23 +341,25 @@ namespace OsmAnd
             {
                 // Resource must be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                auto& promisedResources = _promisedResources[level];
+                auto& promisedResources = stripe.promisedResources[level];
                 const auto& itPromisedResourceEntry = promisedResources.find(key);
                 if (!promisedEntryPtr)
                     promisedEntryPtr = *itPromisedResourceEntry;
                 promisedResources.erase(itPromisedResourceEntry);
             }
 
-            _promisedResourceEntriesStorage.remove(promisedEntryPtr);
+            stripe.promisedResourceEntriesStorage.remove(promisedEntryPtr);
             promisedEntryPtr->promise.set_exception(proper::make_exception_ptr(std::runtime_error("Promise was broken")));
         }
 
         void fulfilPromise(const KEY_TYPE& key, const QSet<ZoomLevel>& levels, ResourcePtr& resourcePtr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->fulfilPromise(%s, [%s], %p)",
@@ -353,16 +375,16 @@ namespace OsmAnd
             {
                 // Resource must be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                auto& promisedResources = _promisedResources[level];
+                auto& promisedResources = stripe.promisedResources[level];
                 const auto& itPromisedResourceEntry = promisedResources.find(key);
                 if (!promisedEntryPtr)
                     promisedEntryPtr = *itPromisedResourceEntry;
                 promisedResources.erase(itPromisedResourceEntry);
             }
-            _promisedResourceEntriesStorage.remove(promisedEntryPtr);
+            stripe.promisedResourceEntriesStorage.remove(promisedEntryPtr);
 
             if (promisedEntryPtr->refCounter <= 0)
                 return;
@@ -378,20 +400,22 @@ namespace OsmAnd
             {
                 // Resource must not be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(!_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(!stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                _availableResources[level].insert(key, newEntryPtr);
+                stripe.availableResources[level].insert(key, newEntryPtr);
             }
 
-            _availableResourceEntriesStorage.insert(newEntryPtr);
+            stripe.availableResourceEntriesStorage.insert(newEntryPtr);
             promisedEntryPtr->promise.set_value(newEntryPtr->resourcePtr);
         }
 
 #ifdef Q_COMPILER_RVALUE_REFS
         void fulfilPromise(const KEY_TYPE& key, const QSet<ZoomLevel>& levels, ResourcePtr&& resourcePtr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->fulfilPromise(%s, [%s], %p)",
@@ -407,16 +431,16 @@ namespace OsmAnd
             {
                 // Resource must be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                auto& promisedResources = _promisedResources[level];
+                auto& promisedResources = stripe.promisedResources[level];
                 const auto& itPromisedResourceEntry = promisedResources.find(key);
                 if (!promisedEntryPtr)
                     promisedEntryPtr = *itPromisedResourceEntry;
                 promisedResources.erase(itPromisedResourceEntry);
             }
-            _promisedResourceEntriesStorage.remove(promisedEntryPtr);
+            stripe.promisedResourceEntriesStorage.remove(promisedEntryPtr);
 
             if (promisedEntryPtr->refCounter <= 0)
                 return;
@@ -428,20 +452,22 @@ namespace OsmAnd
             {
                 // Resource must not be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(!_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(!stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                _availableResources[level].insert(key, newEntryPtr);
+                stripe.availableResources[level].insert(key, newEntryPtr);
             }
 
-            _availableResourceEntriesStorage.insert(newEntryPtr);
+            stripe.availableResourceEntriesStorage.insert(newEntryPtr);
             promisedEntryPtr->promise.set_value(newEntryPtr->resourcePtr);
         }
 #endif // Q_COMPILER_RVALUE_REFS
 
         void fulfilPromiseAndReference(const KEY_TYPE& key, const QSet<ZoomLevel>& levels, const ResourcePtr& resourcePtr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->fulfilPromiseAndReference(%s, [%s], %p)",
@@ -457,16 +483,16 @@ namespace OsmAnd
             {
                 // Resource must be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                auto& promisedResources = _promisedResources[level];
+                auto& promisedResources = stripe.promisedResources[level];
                 const auto& itPromisedResourceEntry = promisedResources.find(key);
                 if (!promisedEntryPtr)
                     promisedEntryPtr = *itPromisedResourceEntry;
                 promisedResources.erase(itPromisedResourceEntry);
             }
-            _promisedResourceEntriesStorage.remove(promisedEntryPtr);
+            stripe.promisedResourceEntriesStorage.remove(promisedEntryPtr);
 
             const AvailableResourceEntryPtr newEntryPtr(new AvailableResourceEntry(promisedEntryPtr->refCounter + 1, resourcePtr, levels));
 
@@ -474,19 +500,21 @@ namespace OsmAnd
             {
                 // Resource must not be promised and must not be already available.
                 // Otherwise behavior is undefined
-                assert(!_promisedResources[level].contains(key));
-                assert(!_availableResources[level].contains(key));
+                assert(!stripe.promisedResources[level].contains(key));
+                assert(!stripe.availableResources[level].contains(key));
 
-                _availableResources[level].insert(key, newEntryPtr);
+                stripe.availableResources[level].insert(key, newEntryPtr);
             }
 
-            _availableResourceEntriesStorage.insert(newEntryPtr);
+            stripe.availableResourceEntriesStorage.insert(newEntryPtr);
             promisedEntryPtr->promise.set_value(newEntryPtr->resourcePtr);
         }
 
         bool obtainFutureReference(const KEY_TYPE& key, const ZoomLevel level, proper::shared_future<ResourcePtr>& outFutureResourcePtr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->obtainFutureReference(%s, [%d], ...)",
@@ -498,9 +526,9 @@ namespace OsmAnd
 
             // Resource must not be already available.
             // Otherwise behavior is undefined
-            assert(!_availableResources[level].contains(key));
+            assert(!stripe.availableResources[level].contains(key));
 
-            const auto& promisedResources = _promisedResources[level];
+            const auto& promisedResources = stripe.promisedResources[level];
             const auto& itPromisedResourceEntry = promisedResources.constFind(key);
             if (itPromisedResourceEntry == promisedResources.cend())
                 return false;
@@ -514,7 +542,9 @@ namespace OsmAnd
 
         bool releaseFutureReference(const KEY_TYPE& key, const ZoomLevel level)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->releaseFutureReference(%s, [%d])",
@@ -526,9 +556,9 @@ namespace OsmAnd
 
             // Resource must not be already available.
             // Otherwise behavior is undefined
-            assert(!_availableResources[level].contains(key));
+            assert(!stripe.availableResources[level].contains(key));
 
-            const auto& promisedResources = _promisedResources[level];
+            const auto& promisedResources = stripe.promisedResources[level];
             const auto& itPromisedResourceEntry = promisedResources.constFind(key);
             if (itPromisedResourceEntry == promisedResources.cend())
                 return false;
@@ -542,7 +572,9 @@ namespace OsmAnd
 
         bool obtainReferenceOrFutureReferenceOrMakePromise(const KEY_TYPE& key, const ZoomLevel level, const QSet<ZoomLevel>& levels, ResourcePtr& outResourcePtr, proper::shared_future<ResourcePtr>& outFutureResourcePtr)
         {
-            QWriteLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QWriteLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
 #if OSMAND_LOG_SHARED_BY_ZOOM_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedByZoomResourcesContainer(%p)->obtainReferenceOrFutureReferenceOrMakePromise(%s, [%d], [%s], ...)",
@@ -555,7 +587,7 @@ namespace OsmAnd
 
             assert(levels.contains(level));
 
-            auto& availableResources = _availableResources[level];
+            auto& availableResources = stripe.availableResources[level];
             const auto& itAvailableResourceEntry = availableResources.find(key);
             if (itAvailableResourceEntry != availableResources.end())
             {
@@ -587,14 +619,16 @@ namespace OsmAnd
 
         uintmax_t getReferencesCount(const KEY_TYPE& key, const ZoomLevel level = InvalidZoomLevel) const
         {
-            QReadLocker scopedLocker(&this->_lock);
+            const auto stripeIndex = base::getStripeIndex(key);
+            QReadLocker scopedLocker(&this->_lockStripes[stripeIndex].lock);
+            auto& stripe = _stripes[stripeIndex];
 
             uintmax_t result = 0;
             const auto firstZoom = (level == InvalidZoomLevel) ? MinZoomLevel : level;
             const auto lastZoom = (level == InvalidZoomLevel) ? MaxZoomLevel : level;
             for (int currentLevel = firstZoom; currentLevel <= lastZoom; currentLevel++)
             {
-                const auto& availableResources = _availableResources[currentLevel];
+                const auto& availableResources = stripe.availableResources[currentLevel];
                 const auto citAvailableResourceEntry = availableResources.constFind(key);
                 if (citAvailableResourceEntry != availableResources.cend())
                 {
@@ -604,7 +638,7 @@ namespace OsmAnd
                     continue;
                 }
 
-                const auto& promisedResources = _promisedResources[currentLevel];
+                const auto& promisedResources = stripe.promisedResources[currentLevel];
                 const auto citPromisedResourceEntry = promisedResources.constFind(key);
                 if (citPromisedResourceEntry != promisedResources.cend())
                 {
@@ -2,6 +2,7 @@
 #define _OSMAND_CORE_SHARED_RESOURCES_CONTAINER_H_
 
 #include <OsmAndCore/stdlib_common.h>
+#include <array>
 #include <proper/future.h>
 
 #include <OsmAndCore/QtExtensions.h>
@@ -29,7 +30,31 @@ namespace OsmAnd
     public:
         typedef std::shared_ptr<RESOURCE_TYPE> ResourcePtr;
     protected:
-        mutable QReadWriteLock _lock;
+        // Entries are partitioned by hash of the key into stripes, each guarded by its own lock.
+        // Every operation touches a single key, so threads working on different keys rarely contend.
+        enum {
+            StripesCountLog2 = 6,
+            StripesCount = 1 << StripesCountLog2,
+        };
+        static unsigned int getStripeIndex(const KEY_TYPE& key)
+        {
+            // Fibonacci hashing, since qHash() of integer keys is identity and low bits may be poorly spread
+            return static_cast<uint32_t>(static_cast<uint32_t>(qHash(key)) * 2654435761u) >> (32 - StripesCountLog2);
+        }
+
+        struct LockStripe
+        {
+            LockStripe()
+                : lock(QReadWriteLock::Recursive)
+            {
+            }
+
+            QReadWriteLock lock;
+
+        private:
+            Q_DISABLE_COPY_AND_MOVE(LockStripe);
+        };
+        mutable std::array<LockStripe, StripesCount> _lockStripes;
 
         struct AvailableResourceEntry
         {
@@ -82,12 +107,11 @@ namespace OsmAnd
             Q_DISABLE_COPY_AND_MOVE(PromisedResourceEntry);
         };
     private:
-        QHash< KEY_TYPE, std::shared_ptr< AvailableResourceEntry > > _availableResources;
-        QHash< KEY_TYPE, std::shared_ptr< PromisedResourceEntry > > _promisedResources;
+        std::array< QHash< KEY_TYPE, std::shared_ptr< AvailableResourceEntry > >, StripesCount > _availableResources;
+        std::array< QHash< KEY_TYPE, std::shared_ptr< PromisedResourceEntry > >, StripesCount > _promisedResources;
     protected:
     public:
         SharedResourcesContainer()
-            : _lock(QReadWriteLock::Recursive)
         {
         }
         virtual ~SharedResourcesContainer()
@@ -96,7 +120,9 @@ namespace OsmAnd
 
         void insert(const KEY_TYPE& key, ResourcePtr& resourcePtr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
 
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->insert(%s, %p)",
@@ -108,8 +134,8 @@ namespace OsmAnd
 
             // Resource must not be promised and must not be already available.
             // Otherwise behavior is undefined
-            assert(!_promisedResources.contains(key));
-            assert(!_availableResources.contains(key));
+            assert(!_promisedResources[stripeIndex].contains(key));
+            assert(!availableResources.contains(key));
 
             const auto newEntry = new AvailableResourceEntry(0, qMove(resourcePtr));
 #ifndef Q_COMPILER_RVALUE_REFS
@@ -117,13 +143,15 @@ namespace OsmAnd
 #else
             assert(resourcePtr.use_count() == 0);
 #endif
-            _availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
+            availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
         }
 
 #ifdef Q_COMPILER_RVALUE_REFS
         void insert(const KEY_TYPE& key, ResourcePtr&& resourcePtr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
 
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->insert(%s, %p)",
@@ -135,18 +163,20 @@ namespace OsmAnd
 
             // Resource must not be promised and must not be already available.
             // Otherwise behavior is undefined
-            assert(!_promisedResources.contains(key));
-            assert(!_availableResources.contains(key));
+            assert(!_promisedResources[stripeIndex].contains(key));
+            assert(!availableResources.contains(key));
 
             const auto newEntry = new AvailableResourceEntry(0, qMove(resourcePtr));
             assert(resourcePtr.use_count() == 0);
-            _availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
+            availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
         }
 #endif // Q_COMPILER_RVALUE_REFS
         
         void insertAndReference(const KEY_TYPE& key, const ResourcePtr& resourcePtr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
 
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->insertAndReference(%s, %p)",
@@ -158,16 +188,19 @@ namespace OsmAnd
 
             // Resource must not be promised and must not be already available.
             // Otherwise behavior is undefined
-            assert(!_promisedResources.contains(key));
-            assert(!_availableResources.contains(key));
+            assert(!_promisedResources[stripeIndex].contains(key));
+            assert(!availableResources.contains(key));
 
             const auto newEntry = new AvailableResourceEntry(1, resourcePtr);
-            _availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
+            availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
         }
 
         bool obtainReference(const KEY_TYPE& key, ResourcePtr& outResourcePtr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
+            auto& promisedResources = _promisedResources[stripeIndex];
 
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->obtainReference(%s)",
@@ -177,8 +210,8 @@ namespace OsmAnd
 #endif
 
             // In case resource was promised, wait forever until promise is fulfilled
-            const auto itPromisedResourceEntry = _promisedResources.constFind(key);
-            if (itPromisedResourceEntry != _promisedResources.cend())
+            const auto itPromisedResourceEntry = promisedResources.constFind(key);
+            if (itPromisedResourceEntry != promisedResources.cend())
             {
                 const auto localFuture = (*itPromisedResourceEntry)->sharedFuture;
                 scopedLocker.unlock();
@@ -195,8 +228,8 @@ namespace OsmAnd
                 return false;
             }
 
-            const auto itAvailableResourceEntry = _availableResources.find(key);
-            if (itAvailableResourceEntry == _availableResources.end())
+            const auto itAvailableResourceEntry = availableResources.find(key);
+            if (itAvailableResourceEntry == availableResources.end())
                 return false;
             const auto& availableResourceEntry = *itAvailableResourceEntry;
 
@@ -208,13 +241,15 @@ namespace OsmAnd
 
         bool releaseReference(const KEY_TYPE& key, ResourcePtr& resourcePtr, const bool autoClean = true, bool* outWasCleaned = nullptr, uintmax_t* outRemainingReferences = nullptr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
 
             // Resource must not be promised. Otherwise behavior is undefined
-            assert(!_promisedResources.contains(key));
+            assert(!_promisedResources[stripeIndex].contains(key));
             
-            const auto itAvailableResourceEntry = _availableResources.find(key);
-            if (itAvailableResourceEntry == _availableResources.end())
+            const auto itAvailableResourceEntry = availableResources.find(key);
+            if (itAvailableResourceEntry == availableResources.end())
                 return false;
             const auto& availableResourceEntry = *itAvailableResourceEntry;
             assert(availableResourceEntry->refCounter > 0);
@@ -237,7 +272,7 @@ namespace OsmAnd
                 *outWasCleaned = false;
             if (autoClean && availableResourceEntry->refCounter == 0)
             {
-                _availableResources.erase(itAvailableResourceEntry);
+                availableResources.erase(itAvailableResourceEntry);
 
                 if (outWasCleaned)
                     *outWasCleaned = true;
@@ -249,7 +284,9 @@ namespace OsmAnd
 
         void makePromise(const KEY_TYPE& key)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& promisedResources = _promisedResources[stripeIndex];
 
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->makePromise(%s)",
@@ -260,16 +297,18 @@ namespace OsmAnd
 
             // Resource must not be promised and must not be already available.
             // Otherwise behavior is undefined
-            assert(!_promisedResources.contains(key));
-            assert(!_availableResources.contains(key));
+            assert(!promisedResources.contains(key));
+            assert(!_availableResources[stripeIndex].contains(key));
 
             const auto newEntry = new PromisedResourceEntry();
-            _promisedResources.insert(key, qMove(std::shared_ptr<PromisedResourceEntry>(newEntry)));
+            promisedResources.insert(key, qMove(std::shared_ptr<PromisedResourceEntry>(newEntry)));
         }
 
         void breakPromise(const KEY_TYPE& key)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& promisedResources = _promisedResources[stripeIndex];
 
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->breakPromise(%s)",
@@ -280,10 +319,10 @@ namespace OsmAnd
 
             // Resource must be promised and must not be already available.
             // Otherwise behavior is undefined
-            assert(_promisedResources.contains(key));
-            assert(!_availableResources.contains(key));
+            assert(promisedResources.contains(key));
+            assert(!_availableResources[stripeIndex].contains(key));
 
-            const auto itPromisedResourceEntry = _promisedResources.find(key);
+            const auto itPromisedResourceEntry = promisedResources.find(key);
             const std::shared_ptr<PromisedResourceEntry> promisedResourceEntry
 #ifdef Q_COMPILER_RVALUE_REFS
                 (qMove(*itPromisedResourceEntry))
@@ -291,21 +330,24 @@ namespace OsmAnd
                 = itPromisedResourceEntry
 #endif // Q_COMPILER_RVALUE_REFS
             ;
-            _promisedResources.erase(itPromisedResourceEntry);
+            promisedResources.erase(itPromisedResourceEntry);
 
             promisedResourceEntry->promise.set_exception(proper::make_exception_ptr(std::runtime_error("Promise was broken")));
         }
 
         void fulfilPromise(const KEY_TYPE& key, ResourcePtr& resourcePtr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
+            auto& promisedResources = _promisedResources[stripeIndex];
 
             // Resource must be promised and must not be already available.
             // Otherwise behavior is undefined
-            assert(_promisedResources.contains(key));
-            assert(!_availableResources.contains(key));
+            assert(promisedResources.contains(key));
+            assert(!availableResources.contains(key));
 
-            const auto itPromisedResourceEntry = _promisedResources.find(key);
+            const auto itPromisedResourceEntry = promisedResources.find(key);
             const std::shared_ptr<PromisedResourceEntry> promisedResourceEntry
 #ifdef Q_COMPILER_RVALUE_REFS
                 (qMove(*itPromisedResourceEntry))
@@ -313,7 +355,7 @@ namespace OsmAnd
                 = itPromisedResourceEntry
 #endif // Q_COMPILER_RVALUE_REFS
             ;
-            _promisedResources.erase(itPromisedResourceEntry);
+            promisedResources.erase(itPromisedResourceEntry);
 
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->fulfilPromise(%s, %p): %" PRIu64 "",
@@ -333,23 +375,26 @@ namespace OsmAnd
 #else
             assert(resourcePtr.use_count() == 0);
 #endif
-            _availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
+            availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
             promisedResourceEntry->promise.set_value(newEntry->resourcePtr);
         }
 
 #ifdef Q_COMPILER_RVALUE_REFS
         void fulfilPromise(const KEY_TYPE& key, ResourcePtr&& resourcePtr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
+            auto& promisedResources = _promisedResources[stripeIndex];
 
             // Resource must be promised and must not be already available.
             // Otherwise behavior is undefined
-            assert(_promisedResources.contains(key));
-            assert(!_availableResources.contains(key));
+            assert(promisedResources.contains(key));
+            assert(!availableResources.contains(key));
 
-            const auto itPromisedResourceEntry = _promisedResources.find(key);
+            const auto itPromisedResourceEntry = promisedResources.find(key);
             const std::shared_ptr<PromisedResourceEntry> promisedResourceEntry(qMove(*itPromisedResourceEntry));
-            _promisedResources.erase(itPromisedResourceEntry);
+            promisedResources.erase(itPromisedResourceEntry);
 
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->fulfilPromise(%s, %p): %" PRIu64 "",
@@ -365,21 +410,24 @@ namespace OsmAnd
 
             const auto newEntry = new AvailableResourceEntry(promisedResourceEntry->refCounter, qMove(resourcePtr));
             assert(resourcePtr.use_count() == 0);
-            _availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
+            availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
             promisedResourceEntry->promise.set_value(newEntry->resourcePtr);
         }
 #endif // Q_COMPILER_RVALUE_REFS
 
         void fulfilPromiseAndReference(const KEY_TYPE& key, const ResourcePtr& resourcePtr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
+            auto& promisedResources = _promisedResources[stripeIndex];
 
             // Resource must be promised and must not be already available.
             // Otherwise behavior is undefined
-            assert(_promisedResources.contains(key));
-            assert(!_availableResources.contains(key));
+            assert(promisedResources.contains(key));
+            assert(!availableResources.contains(key));
 
-            const auto itPromisedResourceEntry = _promisedResources.find(key);
+            const auto itPromisedResourceEntry = promisedResources.find(key);
             const std::shared_ptr<PromisedResourceEntry> promisedResourceEntry
 #ifdef Q_COMPILER_RVALUE_REFS
                 (qMove(*itPromisedResourceEntry))
@@ -387,7 +435,7 @@ namespace OsmAnd
                 = itPromisedResourceEntry
 #endif // Q_COMPILER_RVALUE_REFS
             ;
-            _promisedResources.erase(itPromisedResourceEntry);
+            promisedResources.erase(itPromisedResourceEntry);
 
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
             LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->fulfilPromiseAndReference(%s, %p): %" PRIu64 " -> %" PRIu64 "",
@@ -400,20 +448,22 @@ namespace OsmAnd
 #endif
 
             const auto newEntry = new AvailableResourceEntry(promisedResourceEntry->refCounter + 1, resourcePtr);
-            _availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
+            availableResources.insert(key, qMove(std::shared_ptr<AvailableResourceEntry>(newEntry)));
             promisedResourceEntry->promise.set_value(newEntry->resourcePtr);
         }
 
         bool obtainFutureReference(const KEY_TYPE& key, proper::shared_future<ResourcePtr>& outFutureResourcePtr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& promisedResources = _promisedResources[stripeIndex];
 
             // Resource must not be already available.
             // Otherwise behavior is undefined
-            assert(!_availableResources.contains(key));
+            assert(!_availableResources[stripeIndex].contains(key));
 
-            const auto itPromisedResourceEntry = _promisedResources.constFind(key);
-            if (itPromisedResourceEntry == _promisedResources.cend())
+            const auto itPromisedResourceEntry = promisedResources.constFind(key);
+            if (itPromisedResourceEntry == promisedResources.cend())
             {
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
                 LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->obtainFutureReference(%s)",
@@ -443,14 +493,16 @@ namespace OsmAnd
 
         bool releaseFutureReference(const KEY_TYPE& key)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& promisedResources = _promisedResources[stripeIndex];
 
             // Resource must not be already available.
             // Otherwise behavior is undefined
-            assert(!_availableResources.contains(key));
+            assert(!_availableResources[stripeIndex].contains(key));
 
-            const auto itPromisedResourceEntry = _promisedResources.constFind(key);
-            if (itPromisedResourceEntry == _promisedResources.cend())
+            const auto itPromisedResourceEntry = promisedResources.constFind(key);
+            if (itPromisedResourceEntry == promisedResources.cend())
             {
 #if OSMAND_LOG_SHARED_RESOURCES_CONTAINER_CHANGE
                 LogPrintf(LogSeverityLevel::Debug, "[thread:%p] SharedResourcesContainer(%p)->releaseFutureReference(%s)",
@@ -480,10 +532,12 @@ namespace OsmAnd
 
         bool obtainReferenceOrFutureReferenceOrMakePromise(const KEY_TYPE& key, ResourcePtr& outResourcePtr, proper::shared_future<ResourcePtr>& outFutureResourcePtr)
         {
-            QWriteLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QWriteLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
 
-            const auto itAvailableResourceEntry = _availableResources.find(key);
-            if (itAvailableResourceEntry != _availableResources.end())
+            const auto itAvailableResourceEntry = availableResources.find(key);
+            if (itAvailableResourceEntry != availableResources.end())
             {
                 const auto& availableResourceEntry = *itAvailableResourceEntry;
 
@@ -528,18 +582,21 @@ namespace OsmAnd
 
         uintmax_t getReferencesCount(const KEY_TYPE& key) const
         {
-            QReadLocker scopedLocker(&_lock);
+            const auto stripeIndex = getStripeIndex(key);
+            QReadLocker scopedLocker(&_lockStripes[stripeIndex].lock);
+            auto& availableResources = _availableResources[stripeIndex];
+            auto& promisedResources = _promisedResources[stripeIndex];
 
-            const auto citAvailableResourceEntry = _availableResources.constFind(key);
-            if (citAvailableResourceEntry != _availableResources.cend())
+            const auto citAvailableResourceEntry = availableResources.constFind(key);
+            if (citAvailableResourceEntry != availableResources.cend())
             {
                 const auto& availableResourceEntry = *citAvailableResourceEntry;
 
                 return availableResourceEntry->refCounter;
             }
 
-            const auto citPromisedResourceEntry = _promisedResources.constFind(key);
-            if (citPromisedResourceEntry != _promisedResources.cend())
+            const auto citPromisedResourceEntry = promisedResources.constFind(key);
+            if (citPromisedResourceEntry != promisedResources.cend())
             {
                 const auto& promisedResourceEntry = *citPromisedResourceEntry;
 
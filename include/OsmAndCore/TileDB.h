@@ -9,7 +9,10 @@
 #include <QFile>
 #include <QString>
 #include <QMutex>
+#include <QHash>
+#include <QVector>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/CommonTypes.h>
@@ -20,12 +23,54 @@ namespace OsmAnd {
     class OSMAND_CORE_API TileDB
     {
     public:
+        enum : int {
+            // Batch lookup reads this many tiles per query
+            BatchSize = 64,
+        };
+
     private:
+        // Tile database is kept opened with prepared queries once it was accessed.
+        // On opening, rowids of all its tiles are read, so lookups do not touch SQLite index of 'tiles' table
+        struct File
+        {
+            QString filename;
+            QString connectionName;
+            QSqlDatabase db;
+            QSqlQuery selectDataQuery;
+            QSqlQuery selectBatchDataQuery;
+            std::array< QHash<TileId, qint64>, ZoomLevelsCount > rowIds;
+        };
+
+        struct FileBounds
+        {
+            int32_t xMin;
+            int32_t yMin;
+            int32_t xMax;
+            int32_t yMax;
+            int fileId;
+        };
+
+        QHash<int, QString> _filenames;
+        std::array< QVector<FileBounds>, ZoomLevelsCount > _bounds;
+        QHash<int, std::shared_ptr<File> > _openedFiles;
+
+        bool loadIndex();
+        std::shared_ptr<File> obtainFile(const int fileId);
+        void closeFiles();
+        bool findTile(const TileId tileId, const ZoomLevel zoom, int& outFileId, qint64& outRowId);
+        bool readBatch(
+            File& file,
+            const QVector<qint64>& rowIds,
+            const QHash<qint64, TileId>& tileIdsByRowId,
+            QHash<TileId, QByteArray>& outData);
+
+        static QString getBatchQuerySql(const int rowIdsCount);
     protected:
         mutable QMutex _indexMutex;
         QSqlDatabase _indexDb;
 
         bool openIndex();
+        bool openIndexDb();
     public:
         TileDB(const QDir& dataPath, const QString& indexFilename = QString::null);
         virtual ~TileDB();
@@ -35,6 +80,8 @@ namespace OsmAnd {
 
         bool rebuildIndex();
         bool obtainTileData(const TileId tileId, const ZoomLevel zoom, QByteArray& data);
+        // Tiles that were not found are absent in output. Returns false on database error
+        bool obtainTilesData(const QVector<TileId>& tileIds, const ZoomLevel zoom, QHash<TileId, QByteArray>& outData);
     };
 
 }
@@ -0,0 +1,101 @@
+#ifndef _OSMAND_CORE_TRACING_H_
+#define _OSMAND_CORE_TRACING_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <atomic>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QByteArray>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+
+// Spans are compiled out if OSMAND_TRACING is defined to 0. Otherwise span costs single relaxed load
+// of atomic flag while tracer is not started
+#if !defined(OSMAND_TRACING)
+#   define OSMAND_TRACING 1
+#endif // !defined(OSMAND_TRACING)
+
+namespace OsmAnd
+{
+    // Records spans of work into per-thread buffers, and exports them as Chrome trace-event JSON
+    // that can be opened in chrome://tracing or Perfetto UI. Category and name of span must be
+    // string literals, since only pointers to them are stored.
+    class OSMAND_CORE_API Tracer Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(Tracer);
+    public:
+        enum : unsigned int {
+            // Spans that don't fit into buffer of their thread are dropped until tracer is restarted
+            ThreadBufferCapacity = 64 * 1024,
+        };
+
+        class OSMAND_CORE_API ScopedSpan Q_DECL_FINAL
+        {
+            Q_DISABLE_COPY_AND_MOVE(ScopedSpan);
+        private:
+            const char* const _category;
+            const char* const _name;
+            // Negative if tracer was not started when span began
+            const int64_t _beginTimestamp;
+        public:
+            inline ScopedSpan(const char* const category, const char* const name)
+                : _category(category)
+                , _name(name)
+                , _beginTimestamp(isStarted() ? now() : -1)
+            {
+            }
+
+            inline ~ScopedSpan()
+            {
+                if (_beginTimestamp >= 0)
+                    recordSpan(_category, _name, _beginTimestamp, now());
+            }
+        };
+
+    private:
+        Tracer();
+
+        static std::atomic<bool> _isStarted;
+    protected:
+    public:
+        ~Tracer();
+
+        static inline bool isStarted()
+        {
+            return _isStarted.load(std::memory_order_relaxed);
+        }
+
+        // Discards previously recorded spans
+        static void start();
+        static void stop();
+
+        // In nanoseconds, from monotonic clock
+        static int64_t now();
+        static void recordSpan(
+            const char* const category,
+            const char* const name,
+            const int64_t beginTimestamp,
+            const int64_t endTimestamp);
+
+        static unsigned int getRecordedSpansCount();
+        static uint64_t getDroppedSpansCount();
+
+        // May be called while tracer is running, spans that are not finished yet are not included
+        static QByteArray exportChromeTrace();
+        static bool saveChromeTrace(const QString& filename);
+    };
+}
+
+#if OSMAND_TRACING
+#   define OSMAND_TRACE_SPAN_VARIABLE_CONCAT(prefix, line) prefix##line
+#   define OSMAND_TRACE_SPAN_VARIABLE(line) OSMAND_TRACE_SPAN_VARIABLE_CONCAT(_traceSpan, line)
+#   define OSMAND_TRACE_SCOPE(category, name)                                                                               \
+        const OsmAnd::Tracer::ScopedSpan OSMAND_TRACE_SPAN_VARIABLE(__LINE__)(category, name)
+#else
+#   define OSMAND_TRACE_SCOPE(category, name)
+#endif // OSMAND_TRACING
+
+#endif // !defined(_OSMAND_CORE_TRACING_H_)
@@ -954,6 +954,14 @@ namespace OsmAnd
             const float spacing = 0.0f);
 
         static QString resolveColorFromPalette(const QString& input, const bool usePalette6);
+
+        // Douglas-Peucker significance of points between start and end (both get maximal value):
+        // simplification with any tolerance keeps exactly the points whose significance is not less than it
+        static void computePointsSignificance(
+            const QVector<PointI>& points31,
+            const int start,
+            const int end,
+            QVector<double>& pointsSignificance);
     private:
         Utilities();
         ~Utilities();
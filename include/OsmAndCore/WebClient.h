@@ -10,9 +10,13 @@
 #include <QByteArray>
 #include <QUrl>
 #include <QNetworkReply>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
 #include <OsmAndCore/restore_internal_warnings.h>
 
 #include <OsmAndCore.h>
+#include <OsmAndCore/Callable.h>
 #include <OsmAndCore/PrivateImplementation.h>
 #include <OsmAndCore/IWebClient.h>
 
@@ -57,6 +61,62 @@ namespace OsmAnd
         friend class OsmAnd::WebClient_P;
         };
 
+        OSMAND_CALLABLE(RequestFinishedCallback,
+            void,
+            const QByteArray& data,
+            const std::shared_ptr<const IWebClient::IRequestResult>& requestResult);
+
+        // Request that is processed by network thread. Data and result are available once it's finished
+        class OSMAND_CORE_API AsyncRequest
+        {
+            Q_DISABLE_COPY_AND_MOVE(AsyncRequest);
+
+        private:
+            mutable QMutex _mutex;
+            mutable QWaitCondition _finishedCondition;
+            bool _isFinished;
+            QAtomicInt _isCancelled;
+            QByteArray _data;
+            std::shared_ptr<const IWebClient::IRequestResult> _requestResult;
+            std::function<void()> _cancelledHandler;
+        protected:
+            AsyncRequest(
+                const QNetworkRequest& networkRequest,
+                const QString& userAgent,
+                const unsigned int retriesLimit,
+                const bool followRedirects,
+                const RequestFinishedCallback callback);
+
+            void finish(const QByteArray& data, const std::shared_ptr<const IWebClient::IRequestResult>& requestResult);
+        public:
+            virtual ~AsyncRequest();
+
+            const QNetworkRequest networkRequest;
+            const QString userAgent;
+            const unsigned int retriesLimit;
+            const bool followRedirects;
+            const RequestFinishedCallback callback;
+
+            // Request that isn't started yet is dropped, one that is in progress is aborted
+            void cancel();
+            bool isCancelled() const;
+
+            bool isFinished() const;
+            // Must not be called from callback, since it's invoked on network thread
+            void waitUntilFinished() const;
+            bool waitUntilFinished(const unsigned long timeoutInMilliseconds) const;
+
+            // Valid only after request is finished
+            QByteArray getData() const;
+            std::shared_ptr<const IWebClient::IRequestResult> getRequestResult() const;
+
+        friend class OsmAnd::WebClient_P;
+        };
+
+        enum : unsigned int {
+            DefaultPerHostRequestsLimit = 4,
+        };
+
     private:
         PrivateImplementation<WebClient_P> _p;
     protected:
@@ -80,6 +140,10 @@ namespace OsmAnd
         bool getFollowRedirects() const;
         void setFollowRedirects(const bool followRedirects);
 
+        // Limit of asynchronous requests that are in progress for each host at the same time
+        unsigned int getPerHostRequestsLimit() const;
+        void setPerHostRequestsLimit(const unsigned int newLimit);
+
         QByteArray downloadData(
             const QNetworkRequest& networkRequest,
             std::shared_ptr<const IWebClient::IRequestResult>* const requestResult = nullptr,
@@ -94,6 +158,15 @@ namespace OsmAnd
             std::shared_ptr<const IWebClient::IRequestResult>* const requestResult = nullptr,
             const IWebClient::RequestProgressCallbackSignature progressCallback = nullptr) const;
 
+        // Asynchronous requests share single network thread, so connections to hosts are kept alive and reused.
+        // Callback is invoked on network thread
+        std::shared_ptr<AsyncRequest> downloadDataAsync(
+            const QNetworkRequest& networkRequest,
+            const RequestFinishedCallback callback = nullptr) const;
+        std::shared_ptr<AsyncRequest> downloadDataAsync(
+            const QString& url,
+            const RequestFinishedCallback callback = nullptr) const;
+
         virtual QByteArray downloadData(
             const QString& url,
             std::shared_ptr<const IWebClient::IRequestResult>* const requestResult = nullptr,
@@ -14,10 +14,14 @@ namespace OsmAnd
 {
     struct OSMAND_CORE_API zlibUtilities Q_DECL_FINAL
     {
-        static QByteArray decompress(const QByteArray& input, const int windowBits);
-        static QByteArray zlibDecompress(const QByteArray& input);
+        // If output size is limited, output buffer is never grown beyond it and larger output is treated as error
+        static QByteArray decompress(const QByteArray& input, const int windowBits, const int maxOutputSize = -1);
+        static QByteArray zlibDecompress(const QByteArray& input, const int maxOutputSize = -1);
         static QByteArray deflateDecompress(const QByteArray& input);
         static QByteArray gzipDecompress(const QByteArray& input);
+
+        static QByteArray compress(const QByteArray& input, const int windowBits, const int level);
+        static QByteArray zlibCompress(const QByteArray& input, const int level = -1 /* Z_DEFAULT_COMPRESSION */);
     private:
         zlibUtilities();
         ~zlibUtilities();
@@ -0,0 +1,200 @@
+#include "AsyncLogQueue.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "Common.h"
+
+OsmAnd::AsyncLogQueue::AsyncLogQueue(const WriterSignature writer)
+    : _slots(new Slot[Capacity])
+    , _enqueuePosition(0)
+    , _dequeuePosition(0)
+    , _enqueuedCount(0)
+    , _droppedCount(0)
+    , _truncatedCount(0)
+    , _writer(writer)
+    , _isDrainerIdle(false)
+    , _isStopping(false)
+    , _thread(new Concurrent::Thread(std::bind(&AsyncLogQueue::threadProcedure, this)))
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity of queue must be power of two");
+
+    // Slot is free for producer when its sequence equals to position, and ready for consumer
+    // when it's one more than position
+    for (auto idx = 0u; idx < Capacity; idx++)
+        _slots[idx].sequence.store(idx, std::memory_order_relaxed);
+
+    _thread->start();
+}
+
+OsmAnd::AsyncLogQueue::~AsyncLogQueue()
+{
+    {
+        QMutexLocker scopedLocker(&_wakeMutex);
+
+        _isStopping = true;
+        _wakeCondition.wakeAll();
+    }
+    REPEAT_UNTIL(_thread->wait());
+
+    // Messages that were enqueued while thread was stopping
+    drain();
+}
+
+void OsmAnd::AsyncLogQueue::threadProcedure()
+{
+    for (;;)
+    {
+        drain();
+
+        QMutexLocker scopedLocker(&_wakeMutex);
+        if (_isStopping)
+            break;
+
+        // Producer checks idle flag after publishing message, and drainer checks queue after setting it,
+        // so at least one of them sees other's write
+        _isDrainerIdle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!isEmpty())
+        {
+            _isDrainerIdle.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        _wakeCondition.wait(&_wakeMutex, IdleWaitTimeoutMs);
+        _isDrainerIdle.store(false, std::memory_order_relaxed);
+    }
+}
+
+void OsmAnd::AsyncLogQueue::wakeDrainer()
+{
+    QMutexLocker scopedLocker(&_wakeMutex);
+
+    _wakeCondition.wakeOne();
+}
+
+bool OsmAnd::AsyncLogQueue::isEmpty() const
+{
+    const auto position = _dequeuePosition.load(std::memory_order_relaxed);
+    const auto& slot = _slots[position & (Capacity - 1)];
+    return slot.sequence.load(std::memory_order_acquire) != position + 1;
+}
+
+bool OsmAnd::AsyncLogQueue::enqueue(const LogSeverityLevel level, const char* const format, va_list args)
+{
+    auto position = _enqueuePosition.load(std::memory_order_relaxed);
+    Slot* pSlot;
+    for (;;)
+    {
+        pSlot = &_slots[position & (Capacity - 1)];
+        const auto sequence = pSlot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<int64_t>(sequence - position);
+        if (difference == 0)
+        {
+            if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // Slot still holds message from previous round, so queue is full
+            _droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+            position = _enqueuePosition.load(std::memory_order_relaxed);
+    }
+
+    pSlot->level = level;
+    const auto length = vsnprintf(pSlot->message, sizeof(pSlot->message), format, args);
+    if (length < 0)
+        pSlot->message[0] = '\0';
+    else if (length > static_cast<int>(MaxMessageLength))
+        _truncatedCount.fetch_add(1, std::memory_order_relaxed);
+    pSlot->sequence.store(position + 1, std::memory_order_release);
+    _enqueuedCount.fetch_add(1, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_isDrainerIdle.load(std::memory_order_relaxed))
+        wakeDrainer();
+
+    return true;
+}
+
+bool OsmAnd::AsyncLogQueue::dequeue(LogSeverityLevel& outLevel, char* const outMessage)
+{
+    // Consumers are serialized by drain mutex, except for crash path, so CAS almost never fails
+    auto position = _dequeuePosition.load(std::memory_order_relaxed);
+    Slot* pSlot;
+    for (;;)
+    {
+        pSlot = &_slots[position & (Capacity - 1)];
+        const auto sequence = pSlot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<int64_t>(sequence - (position + 1));
+        if (difference == 0)
+        {
+            if (_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // Slot is either empty or its message is still being formatted
+            return false;
+        }
+        else
+            position = _dequeuePosition.load(std::memory_order_relaxed);
+    }
+
+    outLevel = pSlot->level;
+    memcpy(outMessage, pSlot->message, strlen(pSlot->message) + 1);
+    pSlot->sequence.store(position + Capacity, std::memory_order_release);
+
+    return true;
+}
+
+unsigned int OsmAnd::AsyncLogQueue::drainUnlocked(const WriterSignature& writer)
+{
+    unsigned int count = 0;
+    LogSeverityLevel level;
+    char message[MaxMessageLength + 1];
+    while (dequeue(level, message))
+    {
+        writer(level, message);
+        count++;
+    }
+
+    return count;
+}
+
+unsigned int OsmAnd::AsyncLogQueue::drain()
+{
+    QMutexLocker scopedLocker(&_drainMutex);
+
+    return drainUnlocked(_writer);
+}
+
+unsigned int OsmAnd::AsyncLogQueue::drainOnCrash(const WriterSignature& writer, const int lockTimeoutMs)
+{
+    // If background thread doesn't finish writing in time, messages are written concurrently with it,
+    // which is still safe for queue itself
+    const auto locked = _drainMutex.tryLock(lockTimeoutMs);
+    const auto count = drainUnlocked(writer);
+    if (locked)
+        _drainMutex.unlock();
+
+    return count;
+}
+
+uint64_t OsmAnd::AsyncLogQueue::getEnqueuedCount() const
+{
+    return _enqueuedCount.load(std::memory_order_relaxed);
+}
+
+uint64_t OsmAnd::AsyncLogQueue::getDroppedCount() const
+{
+    return _droppedCount.load(std::memory_order_relaxed);
+}
+
+uint64_t OsmAnd::AsyncLogQueue::getTruncatedCount() const
+{
+    return _truncatedCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,98 @@
+#ifndef _OSMAND_CORE_ASYNC_LOG_QUEUE_H_
+#define _OSMAND_CORE_ASYNC_LOG_QUEUE_H_
+
+#include "stdlib_common.h"
+#include <atomic>
+#include <cstdarg>
+#include <functional>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QMutex>
+#include <QWaitCondition>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "Logging.h"
+#include "Thread.h"
+
+namespace OsmAnd
+{
+    // Bounded multi-producer queue of formatted log messages (Vyukov's array-based queue). Producer reserves
+    // a slot with a single CAS and formats message right into it, so logging threads never wait for each
+    // other or for sinks. When queue is full, message is dropped and counted. Messages are passed to writer
+    // by background thread, or by any thread that drains queue explicitly.
+    class AsyncLogQueue Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(AsyncLogQueue);
+    public:
+        enum : unsigned int {
+            // Power of two
+            Capacity = Logger::AsyncQueueCapacity,
+            MaxMessageLength = Logger::AsyncMessageMaxLength,
+        };
+
+        typedef std::function<void(const LogSeverityLevel level, const char* const message)> WriterSignature;
+
+    private:
+        enum : unsigned int {
+            CacheLineSize = 64,
+            // Wake-ups are not lost, timeout only guards against bugs in that
+            IdleWaitTimeoutMs = 1000,
+        };
+
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence;
+            LogSeverityLevel level;
+            char message[MaxMessageLength + 1];
+        };
+        const std::unique_ptr<Slot[]> _slots;
+
+        // Positions are updated by different threads, so they are kept on separate cache lines
+        std::atomic<uint64_t> _enqueuePosition;
+        uint8_t _enqueuePositionPadding[CacheLineSize - sizeof(std::atomic<uint64_t>)];
+        std::atomic<uint64_t> _dequeuePosition;
+        uint8_t _dequeuePositionPadding[CacheLineSize - sizeof(std::atomic<uint64_t>)];
+
+        std::atomic<uint64_t> _enqueuedCount;
+        std::atomic<uint64_t> _droppedCount;
+        std::atomic<uint64_t> _truncatedCount;
+
+        const WriterSignature _writer;
+
+        // Only one thread writes messages at a time, to keep their order
+        QMutex _drainMutex;
+
+        std::atomic<bool> _isDrainerIdle;
+        QMutex _wakeMutex;
+        QWaitCondition _wakeCondition;
+        bool _isStopping;
+        const std::unique_ptr<Concurrent::Thread> _thread;
+        void threadProcedure();
+        void wakeDrainer();
+
+        bool isEmpty() const;
+        bool dequeue(LogSeverityLevel& outLevel, char* const outMessage);
+        unsigned int drainUnlocked(const WriterSignature& writer);
+    protected:
+    public:
+        AsyncLogQueue(const WriterSignature writer);
+        ~AsyncLogQueue();
+
+        // Never blocks. Returns false if message was dropped
+        bool enqueue(const LogSeverityLevel level, const char* const format, va_list args);
+
+        // Writes all queued messages on calling thread
+        unsigned int drain();
+        // Same as drain(), but doesn't wait for background thread if it's stuck while writing messages,
+        // so may be used from crash handlers
+        unsigned int drainOnCrash(const WriterSignature& writer, const int lockTimeoutMs);
+
+        uint64_t getEnqueuedCount() const;
+        uint64_t getDroppedCount() const;
+        uint64_t getTruncatedCount() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ASYNC_LOG_QUEUE_H_)
@@ -2,8 +2,11 @@
 
 #include <SkTypeface.h>
 
+#include "QKeyValueIterator.h"
+
 OsmAnd::CachingFontFinder::CachingFontFinder(const std::shared_ptr<const IFontFinder>& fontFinder_)
-    : fontFinder(fontFinder_)
+    : _snapshot(nullptr)
+    , fontFinder(fontFinder_)
 {
 }
 
@@ -11,27 +14,82 @@ OsmAnd::CachingFontFinder::~CachingFontFinder()
 {
     QMutexLocker scopedLocker(&_lock);
 
-    for (const auto& font : constOf(_cache))
-        font->unref();
+    // Every font is referenced once, either from pending entries or from latest snapshot
+    for (const auto& font : constOf(_pending))
+    {
+        if (font)
+            font->unref();
+    }
+    _pending.clear();
+
+    if (const auto snapshot = _snapshot.exchange(nullptr))
+    {
+        for (const auto& font : constOf(*snapshot))
+        {
+            if (font)
+                font->unref();
+        }
+        delete snapshot;
+    }
+
+    for (const auto& retiredSnapshot : constOf(_retiredSnapshots))
+        delete retiredSnapshot;
+    _retiredSnapshots.clear();
 }
 
 SkTypeface* OsmAnd::CachingFontFinder::findFontForCharacterUCS4(
     const uint32_t character,
     const SkFontStyle style /*= SkFontStyle()*/) const
 {
-    QMutexLocker scopedLocker(&_lock);
-
     CacheKey cacheKey;
     cacheKey.styleId = *reinterpret_cast<const StyleId*>(&style);
     cacheKey.character = character;
 
-    const auto citFont = _cache.constFind(cacheKey);
-    if (citFont != _cache.cend())
-        return *citFont;
+    // Fast path: published snapshot is never modified, so concurrent lookups are safe
+    if (const auto snapshot = _snapshot.load(std::memory_order_acquire))
+    {
+        const auto citFont = snapshot->constFind(cacheKey);
+        if (citFont != snapshot->cend())
+            return *citFont;
+    }
+
+    QMutexLocker scopedLocker(&_lock);
+
+    // Snapshot might have been republished meanwhile, but then this key is in it or still in pending
+    const auto citPendingFont = _pending.constFind(cacheKey);
+    if (citPendingFont != _pending.cend())
+        return *citPendingFont;
+    if (const auto snapshot = _snapshot.load(std::memory_order_relaxed))
+    {
+        const auto citFont = snapshot->constFind(cacheKey);
+        if (citFont != snapshot->cend())
+            return *citFont;
+    }
 
     const auto font = fontFinder->findFontForCharacterUCS4(character, style);
     if (font)
         font->ref();
-    _cache.insert(cacheKey, font);
+    _pending.insert(cacheKey, font);
+
+    const auto snapshot = _snapshot.load(std::memory_order_relaxed);
+    const auto snapshotSize = snapshot ? snapshot->size() : 0;
+    if (_pending.size() >= qMax(16, snapshotSize / 4))
+        publishSnapshot();
+
     return font;
 }
+
+void OsmAnd::CachingFontFinder::publishSnapshot() const
+{
+    const auto oldSnapshot = _snapshot.load(std::memory_order_relaxed);
+
+    const auto newSnapshot = oldSnapshot ? new Cache(*oldSnapshot) : new Cache();
+    for (const auto& entry : rangeOf(constOf(_pending)))
+        newSnapshot->insert(entry.key(), entry.value());
+    _pending.clear();
+
+    // Readers may still hold old snapshot, so it's retired rather than deleted
+    _snapshot.store(newSnapshot, std::memory_order_release);
+    if (oldSnapshot)
+        _retiredSnapshots.push_back(oldSnapshot);
+}
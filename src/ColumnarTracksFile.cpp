@@ -0,0 +1,89 @@
+#include "ColumnarTracksFile.h"
+#include "ColumnarTracksFile_P.h"
+
+OsmAnd::ColumnarTracksFile::ColumnarTracksFile(const QString& filename_)
+    : _p(new ColumnarTracksFile_P(this))
+    , filename(filename_)
+{
+}
+
+OsmAnd::ColumnarTracksFile::~ColumnarTracksFile()
+{
+}
+
+bool OsmAnd::ColumnarTracksFile::open()
+{
+    return _p->open();
+}
+
+void OsmAnd::ColumnarTracksFile::close()
+{
+    _p->close();
+}
+
+bool OsmAnd::ColumnarTracksFile::isOpened() const
+{
+    return _p->isOpened();
+}
+
+QVector<OsmAnd::ColumnarTracksFile::Track> OsmAnd::ColumnarTracksFile::getTracks() const
+{
+    return _p->getTracks();
+}
+
+QVector<OsmAnd::ColumnarTracksFile::Segment> OsmAnd::ColumnarTracksFile::getSegments() const
+{
+    return _p->getSegments();
+}
+
+bool OsmAnd::ColumnarTracksFile::readSegment(
+    const unsigned int segmentIndex,
+    QVector<PointI>* const outPoints31,
+    QVector<int64_t>* const outTimestamps /*= nullptr*/,
+    QVector<double>* const outElevations /*= nullptr*/) const
+{
+    return _p->readSegment(segmentIndex, outPoints31, outTimestamps, outElevations);
+}
+
+std::shared_ptr<OsmAnd::GpxDocument> OsmAnd::ColumnarTracksFile::toGpxDocument() const
+{
+    return _p->toGpxDocument();
+}
+
+bool OsmAnd::ColumnarTracksFile::saveTo(
+    const QString& filename,
+    const std::shared_ptr<const GeoInfoDocument>& document,
+    const Compression compression /*= Compression::Zlib*/)
+{
+    return ColumnarTracksFile_P::saveTo(filename, document, compression);
+}
+
+bool OsmAnd::ColumnarTracksFile::convertGpx(
+    const QString& gpxFilename,
+    const QString& filename,
+    const Compression compression /*= Compression::Zlib*/)
+{
+    return ColumnarTracksFile_P::convertGpx(gpxFilename, filename, compression);
+}
+
+OsmAnd::ColumnarTracksFile::Track::Track()
+    : firstSegmentIndex(0)
+    , segmentsCount(0)
+{
+}
+
+OsmAnd::ColumnarTracksFile::Track::~Track()
+{
+}
+
+OsmAnd::ColumnarTracksFile::Segment::Segment()
+    : trackIndex(0)
+    , pointsCount(0)
+    , hasTimestamps(false)
+    , hasElevations(false)
+{
+}
+
+OsmAnd::ColumnarTracksFile::Segment::~Segment()
+{
+}
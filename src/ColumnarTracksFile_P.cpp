@@ -0,0 +1,714 @@
+#include "ColumnarTracksFile_P.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QtEndian>
+#include <QDateTime>
+#include "restore_internal_warnings.h"
+
+#include "Common.h"
+#include "Utilities.h"
+#include "Logging.h"
+#include "zlibUtilities.h"
+#include "GpxStreamReader.h"
+
+namespace
+{
+    const char Magic[4] = { 'O', 'A', 'C', 'T' };
+
+    inline uint64_t encodeZigzag(const int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t decodeZigzag(const uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    inline void appendVarint(QByteArray& output, uint64_t value)
+    {
+        char bytes[10];
+        auto length = 0;
+        while (value >= 0x80)
+        {
+            bytes[length++] = static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        bytes[length++] = static_cast<char>(value);
+        output.append(bytes, length);
+    }
+
+    inline bool readVarint(const uint8_t*& p, const uint8_t* const end, uint64_t& outValue)
+    {
+        outValue = 0;
+        for (auto shift = 0; shift < 64; shift += 7)
+        {
+            if (p >= end)
+                return false;
+            const auto byte = *(p++);
+            outValue |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    template<typename T>
+    inline void appendLittleEndian(QByteArray& output, const T value)
+    {
+        uchar bytes[sizeof(T)];
+        qToLittleEndian<T>(value, bytes);
+        output.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+    }
+
+    template<typename T>
+    inline T readLittleEndian(const uint8_t* const p)
+    {
+        return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(p));
+    }
+
+    inline void appendString(QByteArray& output, const QString& value)
+    {
+        const auto utf8 = value.toUtf8();
+        appendVarint(output, static_cast<uint64_t>(utf8.size()));
+        output.append(utf8);
+    }
+
+    inline bool readString(const uint8_t*& p, const uint8_t* const end, QString& outValue)
+    {
+        uint64_t length;
+        if (!readVarint(p, end, length) || length > static_cast<uint64_t>(end - p))
+            return false;
+        outValue = QString::fromUtf8(reinterpret_cast<const char*>(p), static_cast<int>(length));
+        p += length;
+        return true;
+    }
+
+    // Column of values where some may be missing: presence bitmap (only if some are missing), then deltas of present values
+    void appendColumn(QByteArray& output, const int64_t* const values, const bool* const present, const unsigned int count, const bool hasMissing)
+    {
+        if (hasMissing)
+        {
+            const auto bitmapOffset = output.size();
+            output.append(QByteArray((count + 7) / 8, 0));
+            auto bitmap = reinterpret_cast<uint8_t*>(output.data() + bitmapOffset);
+            for (auto idx = 0u; idx < count; idx++)
+            {
+                if (present[idx])
+                    bitmap[idx / 8] |= static_cast<uint8_t>(1u << (idx % 8));
+            }
+        }
+
+        int64_t previous = 0;
+        for (auto idx = 0u; idx < count; idx++)
+        {
+            if (!present[idx])
+                continue;
+            appendVarint(output, encodeZigzag(values[idx] - previous));
+            previous = values[idx];
+        }
+    }
+
+    template<typename T, typename CONVERTER>
+    bool readColumn(
+        const uint8_t*& p,
+        const uint8_t* const end,
+        const unsigned int count,
+        const bool hasMissing,
+        const T missingValue,
+        T* const outValues,
+        CONVERTER converter)
+    {
+        const uint8_t* bitmap = nullptr;
+        if (hasMissing)
+        {
+            if (static_cast<uint64_t>(end - p) < (count + 7) / 8)
+                return false;
+            bitmap = p;
+            p += (count + 7) / 8;
+        }
+
+        int64_t value = 0;
+        for (auto idx = 0u; idx < count; idx++)
+        {
+            if (bitmap && (bitmap[idx / 8] & (1u << (idx % 8))) == 0)
+            {
+                outValues[idx] = missingValue;
+                continue;
+            }
+
+            uint64_t delta;
+            if (!readVarint(p, end, delta))
+                return false;
+            value += decodeZigzag(delta);
+            outValues[idx] = converter(value);
+        }
+
+        return true;
+    }
+}
+
+OsmAnd::ColumnarTracksFile_P::ColumnarTracksFile_P(ColumnarTracksFile* const owner_)
+    : _data(nullptr)
+    , _size(0)
+    , _compression(Compression::None)
+    , owner(owner_)
+{
+}
+
+OsmAnd::ColumnarTracksFile_P::~ColumnarTracksFile_P()
+{
+    close();
+}
+
+bool OsmAnd::ColumnarTracksFile_P::open()
+{
+    close();
+
+    _file.setFileName(owner->filename);
+    if (!_file.open(QIODevice::ReadOnly))
+        return false;
+    _size = static_cast<uint64_t>(_file.size());
+    if (_size < HeaderSize)
+    {
+        close();
+        return false;
+    }
+
+    _data = reinterpret_cast<const uint8_t*>(_file.map(0, _file.size()));
+    if (!_data)
+    {
+        LogPrintf(LogSeverityLevel::Warning, "Failed to map '%s'", qPrintable(owner->filename));
+        close();
+        return false;
+    }
+
+    if (!parseTables())
+    {
+        LogPrintf(LogSeverityLevel::Warning, "'%s' is not a valid columnar tracks file", qPrintable(owner->filename));
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool OsmAnd::ColumnarTracksFile_P::parseTables()
+{
+    if (memcmp(_data, Magic, sizeof(Magic)) != 0 || readLittleEndian<quint32>(_data + 4) != Version)
+        return false;
+
+    const auto compression = readLittleEndian<quint32>(_data + 8);
+    if (compression > static_cast<quint32>(Compression::Zlib))
+        return false;
+    _compression = static_cast<Compression>(compression);
+    const auto tracksCount = readLittleEndian<quint32>(_data + 12);
+    const auto segmentsCount = readLittleEndian<quint32>(_data + 16);
+    const auto tracksTableOffset = readLittleEndian<quint64>(_data + 24);
+    const auto segmentsTableOffset = readLittleEndian<quint64>(_data + 32);
+    if (tracksTableOffset > segmentsTableOffset ||
+        segmentsTableOffset > _size ||
+        static_cast<uint64_t>(segmentsCount) * SegmentEntrySize > _size - segmentsTableOffset)
+    {
+        return false;
+    }
+
+    if (static_cast<uint64_t>(tracksCount) * 8 > segmentsTableOffset - tracksTableOffset)
+        return false;
+
+    _tracks.resize(tracksCount);
+    auto p = _data + tracksTableOffset;
+    const auto tracksTableEnd = _data + segmentsTableOffset;
+    for (auto& track : _tracks)
+    {
+        if (tracksTableEnd - p < 8)
+            return false;
+        track.firstSegmentIndex = readLittleEndian<quint32>(p);
+        track.segmentsCount = readLittleEndian<quint32>(p + 4);
+        p += 8;
+        if (static_cast<uint64_t>(track.firstSegmentIndex) + track.segmentsCount > segmentsCount)
+            return false;
+
+        if (!readString(p, tracksTableEnd, track.name) ||
+            !readString(p, tracksTableEnd, track.description) ||
+            !readString(p, tracksTableEnd, track.comment) ||
+            !readString(p, tracksTableEnd, track.type))
+        {
+            return false;
+        }
+    }
+
+    _segments.resize(segmentsCount);
+    _blocksOffsets.resize(segmentsCount);
+    _blocksSizes.resize(segmentsCount);
+    _blocksRawSizes.resize(segmentsCount);
+    _segmentsFlags.resize(segmentsCount);
+    p = _data + segmentsTableOffset;
+    for (auto segmentIdx = 0u; segmentIdx < segmentsCount; segmentIdx++, p += SegmentEntrySize)
+    {
+        auto& segment = _segments[segmentIdx];
+        segment.trackIndex = readLittleEndian<quint32>(p);
+        segment.pointsCount = readLittleEndian<quint32>(p + 4);
+        segment.bbox31.left() = readLittleEndian<qint32>(p + 8);
+        segment.bbox31.top() = readLittleEndian<qint32>(p + 12);
+        segment.bbox31.right() = readLittleEndian<qint32>(p + 16);
+        segment.bbox31.bottom() = readLittleEndian<qint32>(p + 20);
+        _blocksOffsets[segmentIdx] = readLittleEndian<quint64>(p + 24);
+        _blocksSizes[segmentIdx] = readLittleEndian<quint32>(p + 32);
+        _blocksRawSizes[segmentIdx] = readLittleEndian<quint32>(p + 36);
+        _segmentsFlags[segmentIdx] = readLittleEndian<quint32>(p + 40);
+        segment.hasTimestamps = (_segmentsFlags[segmentIdx] & HasTimestamps) != 0;
+        segment.hasElevations = (_segmentsFlags[segmentIdx] & HasElevations) != 0;
+
+        if (segment.trackIndex >= tracksCount ||
+            _blocksOffsets[segmentIdx] > _size ||
+            _blocksSizes[segmentIdx] > _size - _blocksOffsets[segmentIdx])
+        {
+            return false;
+        }
+
+        // Points count is used to allocate columns before block is decoded. Each column takes
+        // at least one byte per point, so it can't exceed size of raw block
+        const auto rawBlockSize = (_compression == Compression::Zlib)
+            ? _blocksRawSizes[segmentIdx]
+            : _blocksSizes[segmentIdx];
+        if (rawBlockSize > static_cast<quint32>(std::numeric_limits<int>::max()) ||
+            segment.pointsCount > rawBlockSize)
+        {
+            return false;
+        }
+        if (_compression == Compression::Zlib &&
+            _blocksRawSizes[segmentIdx] > static_cast<uint64_t>(_blocksSizes[segmentIdx]) * MaxZlibCompressionRatio)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void OsmAnd::ColumnarTracksFile_P::close()
+{
+    if (_data)
+        _file.unmap(const_cast<uchar*>(reinterpret_cast<const uchar*>(_data)));
+    _data = nullptr;
+    _size = 0;
+    _file.close();
+
+    _tracks.clear();
+    _segments.clear();
+    _blocksOffsets.clear();
+    _blocksSizes.clear();
+    _blocksRawSizes.clear();
+    _segmentsFlags.clear();
+}
+
+bool OsmAnd::ColumnarTracksFile_P::isOpened() const
+{
+    return _data != nullptr;
+}
+
+QVector<OsmAnd::ColumnarTracksFile_P::Track> OsmAnd::ColumnarTracksFile_P::getTracks() const
+{
+    return _tracks;
+}
+
+QVector<OsmAnd::ColumnarTracksFile_P::Segment> OsmAnd::ColumnarTracksFile_P::getSegments() const
+{
+    return _segments;
+}
+
+bool OsmAnd::ColumnarTracksFile_P::readSegment(
+    const unsigned int segmentIndex,
+    QVector<PointI>* const outPoints31,
+    QVector<int64_t>* const outTimestamps,
+    QVector<double>* const outElevations) const
+{
+    if (!_data || segmentIndex >= static_cast<unsigned int>(_segments.size()))
+        return false;
+    const auto pointsCount = _segments[segmentIndex].pointsCount;
+    const auto flags = _segmentsFlags[segmentIndex];
+
+    // Uncompressed blocks are decoded right from mapped memory
+    QByteArray inflatedBlock;
+    auto p = _data + _blocksOffsets[segmentIndex];
+    auto end = p + _blocksSizes[segmentIndex];
+    if (_compression == Compression::Zlib && _blocksSizes[segmentIndex] > 0)
+    {
+        // Block is inflated right into buffer of declared raw size, so corrupted block can't make it grow
+        inflatedBlock = zlibUtilities::zlibDecompress(
+            QByteArray::fromRawData(reinterpret_cast<const char*>(p), static_cast<int>(_blocksSizes[segmentIndex])),
+            static_cast<int>(_blocksRawSizes[segmentIndex]));
+        if (inflatedBlock.size() != static_cast<int>(_blocksRawSizes[segmentIndex]))
+            return false;
+        p = reinterpret_cast<const uint8_t*>(inflatedBlock.constData());
+        end = p + inflatedBlock.size();
+    }
+
+    // Coordinates are always present, so only needed ones are decoded to reach other columns
+    QVector<PointI> points31(pointsCount);
+    const auto toCoordinate =
+        []
+        (const int64_t value) -> int32_t
+        {
+            return static_cast<int32_t>(value);
+        };
+    QVector<int32_t> coordinates(pointsCount);
+    if (!readColumn<int32_t>(p, end, pointsCount, false, 0, coordinates.data(), toCoordinate))
+        return false;
+    for (auto pointIdx = 0u; pointIdx < pointsCount; pointIdx++)
+        points31[pointIdx].x = coordinates[pointIdx];
+    if (!readColumn<int32_t>(p, end, pointsCount, false, 0, coordinates.data(), toCoordinate))
+        return false;
+    for (auto pointIdx = 0u; pointIdx < pointsCount; pointIdx++)
+        points31[pointIdx].y = coordinates[pointIdx];
+    if (outPoints31)
+        *outPoints31 = qMove(points31);
+
+    if (!outTimestamps && !outElevations)
+        return true;
+
+    QVector<int64_t> timestamps(pointsCount, ColumnarTracksFile::NoTimestamp);
+    if (flags & HasTimestamps)
+    {
+        const auto ok = readColumn<int64_t>(p, end, pointsCount, (flags & HasMissingTimestamps) != 0,
+            ColumnarTracksFile::NoTimestamp, timestamps.data(),
+            []
+            (const int64_t value) -> int64_t
+            {
+                return value;
+            });
+        if (!ok)
+            return false;
+    }
+    if (outTimestamps)
+        *outTimestamps = qMove(timestamps);
+
+    if (!outElevations)
+        return true;
+
+    QVector<double> elevations(pointsCount, std::numeric_limits<double>::quiet_NaN());
+    if (flags & HasElevations)
+    {
+        const auto ok = readColumn<double>(p, end, pointsCount, (flags & HasMissingElevations) != 0,
+            std::numeric_limits<double>::quiet_NaN(), elevations.data(),
+            []
+            (const int64_t value) -> double
+            {
+                return value / 100.0;
+            });
+        if (!ok)
+            return false;
+    }
+    *outElevations = qMove(elevations);
+
+    return true;
+}
+
+std::shared_ptr<OsmAnd::GpxDocument> OsmAnd::ColumnarTracksFile_P::toGpxDocument() const
+{
+    if (!_data)
+        return nullptr;
+
+    const std::shared_ptr<GpxDocument> document(new GpxDocument());
+    QVector<PointI> points31;
+    QVector<int64_t> timestamps;
+    QVector<double> elevations;
+    for (const auto& track : constOf(_tracks))
+    {
+        const std::shared_ptr<GpxDocument::GpxTrk> trk(new GpxDocument::GpxTrk());
+        trk->name = track.name;
+        trk->description = track.description;
+        trk->comment = track.comment;
+        trk->type = track.type;
+
+        for (auto segmentIdx = track.firstSegmentIndex; segmentIdx < track.firstSegmentIndex + track.segmentsCount; segmentIdx++)
+        {
+            if (!readSegment(segmentIdx, &points31, &timestamps, &elevations))
+                return nullptr;
+
+            const std::shared_ptr<GpxDocument::GpxTrkSeg> trkseg(new GpxDocument::GpxTrkSeg());
+            trkseg->points.reserve(points31.size());
+            for (auto pointIdx = 0; pointIdx < points31.size(); pointIdx++)
+            {
+                const std::shared_ptr<GpxDocument::GpxTrkPt> trkpt(new GpxDocument::GpxTrkPt());
+                trkpt->position = Utilities::convert31ToLatLon(points31[pointIdx]);
+                trkpt->elevation = elevations[pointIdx];
+                if (timestamps[pointIdx] != ColumnarTracksFile::NoTimestamp)
+                    trkpt->timestamp = QDateTime::fromMSecsSinceEpoch(timestamps[pointIdx], Qt::UTC);
+                trkseg->points.append(trkpt);
+            }
+            trk->segments.append(trkseg);
+        }
+
+        document->tracks.append(trk);
+    }
+
+    return document;
+}
+
+bool OsmAnd::ColumnarTracksFile_P::saveTo(
+    const QString& filename,
+    const std::shared_ptr<const GeoInfoDocument>& document,
+    const Compression compression)
+{
+    Writer writer(filename, compression);
+    if (!writer.begin())
+        return false;
+
+    QVector<PointI> points31;
+    QVector<int64_t> timestamps;
+    QVector<double> elevations;
+    for (const auto& track : constOf(document->tracks))
+    {
+        for (const auto& trackSegment : constOf(track->segments))
+        {
+            const auto pointsCount = trackSegment->points.size();
+            points31.resize(pointsCount);
+            timestamps.resize(pointsCount);
+            elevations.resize(pointsCount);
+            for (auto pointIdx = 0; pointIdx < pointsCount; pointIdx++)
+            {
+                const auto& point = trackSegment->points[pointIdx];
+                points31[pointIdx] = Utilities::convertLatLonTo31(point->position);
+                timestamps[pointIdx] = point->timestamp.isValid()
+                    ? point->timestamp.toMSecsSinceEpoch()
+                    : static_cast<int64_t>(ColumnarTracksFile::NoTimestamp);
+                elevations[pointIdx] = point->elevation;
+            }
+
+            writer.addSegment(points31.constData(), timestamps.constData(), elevations.constData(), pointsCount);
+        }
+
+        writer.addTrack(track->name, track->description, track->comment, track->type);
+    }
+
+    return writer.finish();
+}
+
+bool OsmAnd::ColumnarTracksFile_P::convertGpx(
+    const QString& gpxFilename,
+    const QString& filename,
+    const Compression compression)
+{
+    Writer writer(filename, compression);
+    if (!writer.begin())
+        return false;
+
+    // Only one segment is held in memory at a time
+    QVector<PointI> points31;
+    QVector<int64_t> timestamps;
+    QVector<double> elevations;
+    GpxStreamReader reader;
+    const auto ok = reader.read(gpxFilename,
+        [&writer, &points31, &timestamps, &elevations]
+        (const GpxStreamReader::TrackPointsBatch& batch) -> bool
+        {
+            for (auto pointIdx = 0u; pointIdx < batch.size(); pointIdx++)
+            {
+                points31.push_back(Utilities::convertLatLonTo31(LatLon(batch.latitudes[pointIdx], batch.longitudes[pointIdx])));
+                timestamps.push_back(batch.timestamps[pointIdx] == GpxStreamReader::NoTimestamp
+                    ? static_cast<int64_t>(ColumnarTracksFile::NoTimestamp)
+                    : batch.timestamps[pointIdx]);
+                elevations.push_back(batch.elevations[pointIdx]);
+            }
+
+            if (batch.isLastInSegment)
+            {
+                writer.addSegment(points31.constData(), timestamps.constData(), elevations.constData(), points31.size());
+                points31.resize(0);
+                timestamps.resize(0);
+                elevations.resize(0);
+            }
+
+            return true;
+        },
+        [&writer]
+        (const GpxStreamReader::TrackInfo& track) -> bool
+        {
+            writer.addTrack(track.name, track.description, track.comment, track.type);
+            return true;
+        });
+    if (!ok)
+        return false;
+
+    return writer.finish();
+}
+
+OsmAnd::ColumnarTracksFile_P::Writer::Writer(const QString& filename, const Compression compression_)
+    : _file(filename)
+    , _tracksCount(0)
+    , _segmentsCount(0)
+    , _trackFirstSegmentIndex(0)
+    , _isOk(false)
+    , compression(compression_)
+{
+}
+
+OsmAnd::ColumnarTracksFile_P::Writer::~Writer()
+{
+}
+
+bool OsmAnd::ColumnarTracksFile_P::Writer::begin()
+{
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    // Header is written once tables are known
+    _isOk = (_file.write(QByteArray(HeaderSize, 0)) == HeaderSize);
+    return _isOk;
+}
+
+void OsmAnd::ColumnarTracksFile_P::Writer::addSegment(
+    const PointI* const points31,
+    const int64_t* const timestamps,
+    const double* const elevations,
+    const unsigned int pointsCount)
+{
+    if (!_isOk)
+        return;
+
+    AreaI bbox31(
+        std::numeric_limits<int32_t>::max(),
+        std::numeric_limits<int32_t>::max(),
+        std::numeric_limits<int32_t>::min(),
+        std::numeric_limits<int32_t>::min());
+    QVector<int64_t> values(pointsCount);
+    QVector<bool> present(pointsCount, true);
+    _block.resize(0);
+
+    for (auto pointIdx = 0u; pointIdx < pointsCount; pointIdx++)
+    {
+        const auto& point31 = points31[pointIdx];
+        bbox31.left() = qMin(bbox31.left(), point31.x);
+        bbox31.top() = qMin(bbox31.top(), point31.y);
+        bbox31.right() = qMax(bbox31.right(), point31.x);
+        bbox31.bottom() = qMax(bbox31.bottom(), point31.y);
+        values[pointIdx] = point31.x;
+    }
+    appendColumn(_block, values.constData(), present.constData(), pointsCount, false);
+    for (auto pointIdx = 0u; pointIdx < pointsCount; pointIdx++)
+        values[pointIdx] = points31[pointIdx].y;
+    appendColumn(_block, values.constData(), present.constData(), pointsCount, false);
+
+    uint32_t flags = 0;
+    auto presentCount = 0u;
+    for (auto pointIdx = 0u; pointIdx < pointsCount; pointIdx++)
+    {
+        present[pointIdx] = (timestamps[pointIdx] != ColumnarTracksFile::NoTimestamp);
+        if (present[pointIdx])
+        {
+            values[pointIdx] = timestamps[pointIdx];
+            presentCount++;
+        }
+    }
+    if (presentCount > 0)
+    {
+        flags |= HasTimestamps;
+        if (presentCount < pointsCount)
+            flags |= HasMissingTimestamps;
+        appendColumn(_block, values.constData(), present.constData(), pointsCount, presentCount < pointsCount);
+    }
+
+    presentCount = 0u;
+    for (auto pointIdx = 0u; pointIdx < pointsCount; pointIdx++)
+    {
+        present[pointIdx] = !std::isnan(elevations[pointIdx]);
+        if (present[pointIdx])
+        {
+            values[pointIdx] = static_cast<int64_t>(std::llround(elevations[pointIdx] * 100.0));
+            presentCount++;
+        }
+    }
+    if (presentCount > 0)
+    {
+        flags |= HasElevations;
+        if (presentCount < pointsCount)
+            flags |= HasMissingElevations;
+        appendColumn(_block, values.constData(), present.constData(), pointsCount, presentCount < pointsCount);
+    }
+
+    const auto rawSize = _block.size();
+    if (compression == Compression::Zlib && rawSize > 0)
+        _block = zlibUtilities::zlibCompress(_block);
+    const auto blockOffset = static_cast<uint64_t>(_file.pos());
+    if (_file.write(_block) != _block.size())
+    {
+        _isOk = false;
+        return;
+    }
+
+    if (pointsCount == 0)
+        bbox31 = AreaI();
+    appendLittleEndian<quint32>(_segmentsTable, _tracksCount);
+    appendLittleEndian<quint32>(_segmentsTable, pointsCount);
+    appendLittleEndian<qint32>(_segmentsTable, bbox31.left());
+    appendLittleEndian<qint32>(_segmentsTable, bbox31.top());
+    appendLittleEndian<qint32>(_segmentsTable, bbox31.right());
+    appendLittleEndian<qint32>(_segmentsTable, bbox31.bottom());
+    appendLittleEndian<quint64>(_segmentsTable, blockOffset);
+    appendLittleEndian<quint32>(_segmentsTable, static_cast<quint32>(_block.size()));
+    appendLittleEndian<quint32>(_segmentsTable, static_cast<quint32>(rawSize));
+    appendLittleEndian<quint32>(_segmentsTable, flags);
+    appendLittleEndian<quint32>(_segmentsTable, 0);
+    _segmentsCount++;
+}
+
+void OsmAnd::ColumnarTracksFile_P::Writer::addTrack(
+    const QString& name,
+    const QString& description,
+    const QString& comment,
+    const QString& type)
+{
+    appendLittleEndian<quint32>(_tracksTable, _trackFirstSegmentIndex);
+    appendLittleEndian<quint32>(_tracksTable, _segmentsCount - _trackFirstSegmentIndex);
+    appendString(_tracksTable, name);
+    appendString(_tracksTable, description);
+    appendString(_tracksTable, comment);
+    appendString(_tracksTable, type);
+
+    _trackFirstSegmentIndex = _segmentsCount;
+    _tracksCount++;
+}
+
+bool OsmAnd::ColumnarTracksFile_P::Writer::finish()
+{
+    if (!_isOk)
+    {
+        _file.close();
+        _file.remove();
+        return false;
+    }
+
+    // Segments that don't belong to any track are put into an unnamed one
+    if (_trackFirstSegmentIndex < _segmentsCount)
+        addTrack(QString(), QString(), QString(), QString());
+
+    const auto tracksTableOffset = static_cast<uint64_t>(_file.pos());
+    const auto segmentsTableOffset = tracksTableOffset + _tracksTable.size();
+    QByteArray header;
+    header.append(Magic, sizeof(Magic));
+    appendLittleEndian<quint32>(header, Version);
+    appendLittleEndian<quint32>(header, static_cast<quint32>(compression));
+    appendLittleEndian<quint32>(header, _tracksCount);
+    appendLittleEndian<quint32>(header, _segmentsCount);
+    appendLittleEndian<quint32>(header, 0);
+    appendLittleEndian<quint64>(header, tracksTableOffset);
+    appendLittleEndian<quint64>(header, segmentsTableOffset);
+
+    const auto ok =
+        _file.write(_tracksTable) == _tracksTable.size() &&
+        _file.write(_segmentsTable) == _segmentsTable.size() &&
+        _file.seek(0) &&
+        _file.write(header) == header.size();
+    _file.close();
+    if (!ok)
+        _file.remove();
+
+    return ok;
+}
@@ -0,0 +1,121 @@
+#ifndef _OSMAND_CORE_COLUMNAR_TRACKS_FILE_P_H_
+#define _OSMAND_CORE_COLUMNAR_TRACKS_FILE_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QFile>
+
+#include "OsmAndCore.h"
+#include "PrivateImplementation.h"
+#include "ColumnarTracksFile.h"
+
+namespace OsmAnd
+{
+    class ColumnarTracksFile;
+    class ColumnarTracksFile_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(ColumnarTracksFile_P);
+    public:
+        typedef ColumnarTracksFile::Compression Compression;
+        typedef ColumnarTracksFile::Track Track;
+        typedef ColumnarTracksFile::Segment Segment;
+
+        enum : uint32_t {
+            Version = 1,
+            HeaderSize = 40,
+            SegmentEntrySize = 48,
+            // Deflate can't expand data more than that, so larger raw size of compressed block means corrupted file
+            MaxZlibCompressionRatio = 1032,
+        };
+
+        enum SegmentFlag : uint32_t {
+            HasTimestamps = 1u << 0,
+            HasElevations = 1u << 1,
+            HasMissingTimestamps = 1u << 2,
+            HasMissingElevations = 1u << 3,
+        };
+
+        // Writes file sequentially: segment blocks first, then tracks and segments tables, then header is updated
+        class Writer Q_DECL_FINAL
+        {
+            Q_DISABLE_COPY_AND_MOVE(Writer);
+
+        private:
+            QFile _file;
+            QByteArray _tracksTable;
+            QByteArray _segmentsTable;
+            QByteArray _block;
+            unsigned int _tracksCount;
+            unsigned int _segmentsCount;
+            unsigned int _trackFirstSegmentIndex;
+            bool _isOk;
+        protected:
+        public:
+            Writer(const QString& filename, const Compression compression);
+            ~Writer();
+
+            const Compression compression;
+
+            bool begin();
+            void addSegment(
+                const PointI* const points31,
+                const int64_t* const timestamps,
+                const double* const elevations,
+                const unsigned int pointsCount);
+            void addTrack(const QString& name, const QString& description, const QString& comment, const QString& type);
+            bool finish();
+        };
+
+    private:
+        QFile _file;
+        const uint8_t* _data;
+        uint64_t _size;
+        Compression _compression;
+        QVector<Track> _tracks;
+        QVector<Segment> _segments;
+        QVector<uint64_t> _blocksOffsets;
+        QVector<uint32_t> _blocksSizes;
+        QVector<uint32_t> _blocksRawSizes;
+        QVector<uint32_t> _segmentsFlags;
+
+        bool parseTables();
+    protected:
+        ColumnarTracksFile_P(ColumnarTracksFile* const owner);
+    public:
+        ~ColumnarTracksFile_P();
+
+        ImplementationInterface<ColumnarTracksFile> owner;
+
+        bool open();
+        void close();
+        bool isOpened() const;
+
+        QVector<Track> getTracks() const;
+        QVector<Segment> getSegments() const;
+
+        bool readSegment(
+            const unsigned int segmentIndex,
+            QVector<PointI>* const outPoints31,
+            QVector<int64_t>* const outTimestamps,
+            QVector<double>* const outElevations) const;
+
+        std::shared_ptr<GpxDocument> toGpxDocument() const;
+
+        static bool saveTo(
+            const QString& filename,
+            const std::shared_ptr<const GeoInfoDocument>& document,
+            const Compression compression);
+        static bool convertGpx(
+            const QString& gpxFilename,
+            const QString& filename,
+            const Compression compression);
+
+    friend class OsmAnd::ColumnarTracksFile;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_COLUMNAR_TRACKS_FILE_P_H_)
@@ -0,0 +1,590 @@
+#include "WorkStealingScheduler.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QElapsedTimer>
+#include "restore_internal_warnings.h"
+
+#include "Logging.h"
+#include "Tracing.h"
+
+OsmAnd::Concurrent::WorkStealingScheduler::WorkStealingScheduler(const int maxThreadCount_)
+    : _injectionQueueSize(0)
+    , _workersCount(0)
+    , _maxThreadCount(maxThreadCount_)
+    , _isStopping(false)
+    , _parkedCount(0)
+    , _pendingCount(0)
+    , _activeCount(0)
+{
+    for (auto& worker : _workers)
+        worker.store(nullptr, std::memory_order_relaxed);
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::~WorkStealingScheduler()
+{
+    reset();
+}
+
+std::shared_ptr<OsmAnd::Concurrent::WorkStealingScheduler> OsmAnd::Concurrent::WorkStealingScheduler::obtainShared()
+{
+    static QMutex sharedMutex;
+    static std::weak_ptr<WorkStealingScheduler> weakShared;
+
+    QMutexLocker scopedLocker(&sharedMutex);
+
+    auto shared = weakShared.lock();
+    if (!shared)
+    {
+        shared.reset(new WorkStealingScheduler(QThread::idealThreadCount()));
+        weakShared = shared;
+    }
+    return shared;
+}
+
+int OsmAnd::Concurrent::WorkStealingScheduler::maxThreadCount() const
+{
+    return _maxThreadCount.load();
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::setMaxThreadCount(const int maxThreadCount)
+{
+    {
+        QMutexLocker scopedLocker(&_workersMutex);
+
+        _maxThreadCount.store(maxThreadCount);
+        _excessWorkersWakeup.wakeAll();
+    }
+
+    if (_pendingCount.load() > 0)
+    {
+        ensureWorkersCreated();
+        unparkOne();
+    }
+}
+
+unsigned int OsmAnd::Concurrent::WorkStealingScheduler::activeThreadCount() const
+{
+    return _activeCount.load();
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::enqueue(QRunnable* const runnable)
+{
+    const auto job = new Job(runnable);
+    registerJob(job);
+    _pendingCount.fetch_add(1);
+
+    ensureWorkersCreated();
+
+    // Worker threads of this pool push to own deque, everyone else uses injection queue
+    const auto worker = getCurrentWorker();
+    if (worker && worker->index < getEffectiveMaxThreadCount())
+    {
+        worker->deque.push(job);
+    }
+    else
+    {
+        QMutexLocker scopedLocker(&_injectionQueueMutex);
+
+        _injectionQueue.enqueue(job);
+        _injectionQueueSize.fetch_add(1);
+    }
+
+    unparkOne();
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::enqueue(const QVector<QRunnable*>& runnables)
+{
+    if (runnables.isEmpty())
+        return;
+
+    QVector<Job*> jobs;
+    jobs.reserve(runnables.size());
+    for (const auto& runnable : constOf(runnables))
+    {
+        const auto job = new Job(runnable);
+        registerJob(job);
+        jobs.push_back(job);
+    }
+    _pendingCount.fetch_add(jobs.size());
+
+    ensureWorkersCreated();
+
+    const auto worker = getCurrentWorker();
+    if (worker && worker->index < getEffectiveMaxThreadCount())
+    {
+        for (const auto& job : constOf(jobs))
+            worker->deque.push(job);
+    }
+    else
+    {
+        QMutexLocker scopedLocker(&_injectionQueueMutex);
+
+        for (const auto& job : constOf(jobs))
+            _injectionQueue.enqueue(job);
+        _injectionQueueSize.fetch_add(jobs.size());
+    }
+
+    // Wake up as many workers as there are new jobs, but no more than there are parked
+    for (auto jobIndex = 0; jobIndex < jobs.size(); jobIndex++)
+    {
+        if (_parkedCount.load() <= 0)
+            break;
+        unparkOne();
+    }
+}
+
+bool OsmAnd::Concurrent::WorkStealingScheduler::dequeue(QRunnable* const runnable)
+{
+    auto& stripe = getRegistryStripe(runnable);
+    QMutexLocker scopedLocker(&stripe.mutex);
+
+    const auto citJob = stripe.jobs.constFind(runnable);
+    if (citJob == stripe.jobs.cend())
+        return false;
+    const auto job = *citJob;
+
+    // Job itself stays in some deque and will be discarded by whoever takes it
+    int expectedState = static_cast<int>(JobState::Queued);
+    if (!job->state.compare_exchange_strong(expectedState, static_cast<int>(JobState::Dequeued)))
+        return false;
+    stripe.jobs.remove(runnable);
+    scopedLocker.unlock();
+
+    finishJob();
+    return true;
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::dequeueAll()
+{
+    for (auto& stripe : _registry)
+    {
+        QList<QRunnable*> dequeuedRunnables;
+        {
+            QMutexLocker scopedLocker(&stripe.mutex);
+
+            for (const auto& job : constOf(stripe.jobs))
+            {
+                int expectedState = static_cast<int>(JobState::Queued);
+                if (job->state.compare_exchange_strong(expectedState, static_cast<int>(JobState::Dequeued)))
+                    dequeuedRunnables.push_back(job->runnable);
+            }
+            stripe.jobs.clear();
+        }
+
+        for (const auto& runnable : constOf(dequeuedRunnables))
+        {
+            if (runnable->autoDelete())
+                delete runnable;
+            finishJob();
+        }
+    }
+}
+
+bool OsmAnd::Concurrent::WorkStealingScheduler::waitForDone(const int msecs) const
+{
+    QMutexLocker scopedLocker(&_doneMutex);
+
+    if (msecs < 0)
+    {
+        while (_pendingCount.load() != 0)
+            REPEAT_UNTIL(_doneCondition.wait(&_doneMutex));
+    }
+    else
+    {
+        QElapsedTimer waitTimer;
+        waitTimer.start();
+        int timeLeft;
+        while (_pendingCount.load() != 0 && ((timeLeft = msecs - waitTimer.elapsed()) > 0))
+            _doneCondition.wait(&_doneMutex, timeLeft);
+    }
+
+    return _pendingCount.load() == 0;
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::reset()
+{
+    dequeueAll();
+    waitForDone(-1);
+
+    QMutexLocker scopedLocker(&_workersMutex);
+
+    const auto workersCount = _workersCount.load();
+    _isStopping.store(true);
+    _excessWorkersWakeup.wakeAll();
+    _parkingLot.release(workersCount);
+    scopedLocker.unlock();
+
+    for (auto workerIndex = 0; workerIndex < workersCount; workerIndex++)
+    {
+        const auto worker = _workers[workerIndex].exchange(nullptr);
+        worker->wait();
+        delete worker;
+    }
+
+    scopedLocker.relock();
+    _workersCount.store(0);
+    _parkedCount.store(0);
+    _parkingLot.tryAcquire(_parkingLot.available());
+    {
+        QMutexLocker injectionQueueLocker(&_injectionQueueMutex);
+
+        // Only discarded jobs may remain here
+        for (const auto& job : constOf(_injectionQueue))
+            delete job;
+        _injectionQueue.clear();
+        _injectionQueueSize.store(0);
+    }
+    _isStopping.store(false);
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::RegistryStripe& OsmAnd::Concurrent::WorkStealingScheduler::getRegistryStripe(
+    QRunnable* const runnable)
+{
+    // Lowest bits of pointers are always zero due to alignment
+    const auto hash = reinterpret_cast<uintptr_t>(runnable) >> 4;
+    return _registry[hash % RegistryStripesCount];
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::registerJob(Job* const job)
+{
+    auto& stripe = getRegistryStripe(job->runnable);
+    QMutexLocker scopedLocker(&stripe.mutex);
+
+    stripe.jobs.insert(job->runnable, job);
+}
+
+bool OsmAnd::Concurrent::WorkStealingScheduler::claimJob(Job* const job)
+{
+    int expectedState = static_cast<int>(JobState::Queued);
+    if (!job->state.compare_exchange_strong(expectedState, static_cast<int>(JobState::Running)))
+        return false;
+
+    auto& stripe = getRegistryStripe(job->runnable);
+    QMutexLocker scopedLocker(&stripe.mutex);
+
+    const auto itJob = stripe.jobs.find(job->runnable);
+    if (itJob != stripe.jobs.end() && *itJob == job)
+        stripe.jobs.erase(itJob);
+
+    return true;
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::Job* OsmAnd::Concurrent::WorkStealingScheduler::takeFromInjectionQueue()
+{
+    if (_injectionQueueSize.load() <= 0)
+        return nullptr;
+
+    QMutexLocker scopedLocker(&_injectionQueueMutex);
+
+    if (_injectionQueue.isEmpty())
+        return nullptr;
+    _injectionQueueSize.fetch_sub(1);
+    return _injectionQueue.dequeue();
+}
+
+int OsmAnd::Concurrent::WorkStealingScheduler::getEffectiveMaxThreadCount() const
+{
+    const auto maxThreadCount = _maxThreadCount.load();
+    if (maxThreadCount <= 0)
+        return qBound(1, QThread::idealThreadCount(), static_cast<int>(MaxWorkersCount));
+    return qMin(maxThreadCount, static_cast<int>(MaxWorkersCount));
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::ensureWorkersCreated()
+{
+    const auto effectiveMaxThreadCount = getEffectiveMaxThreadCount();
+    if (_workersCount.load(std::memory_order_acquire) >= effectiveMaxThreadCount)
+        return;
+
+    QMutexLocker scopedLocker(&_workersMutex);
+
+    if (_isStopping.load())
+        return;
+
+    auto workersCount = _workersCount.load();
+    while (workersCount < effectiveMaxThreadCount)
+    {
+        const auto worker = new WorkerThread(this, workersCount);
+        worker->setObjectName(QLatin1String("Worker (work-stealing)"));
+        _workers[workersCount].store(worker, std::memory_order_release);
+        workersCount++;
+        _workersCount.store(workersCount, std::memory_order_release);
+
+        worker->start();
+    }
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::WorkerThread* OsmAnd::Concurrent::WorkStealingScheduler::getCurrentWorker() const
+{
+    const auto worker = dynamic_cast<WorkerThread*>(QThread::currentThread());
+    if (!worker || worker->scheduler != this)
+        return nullptr;
+    return worker;
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::unparkOne()
+{
+    // Pairs with fence in park(): either parked worker is seen here, or new job is seen there
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (tryCancelParking())
+        _parkingLot.release(1);
+}
+
+bool OsmAnd::Concurrent::WorkStealingScheduler::tryCancelParking()
+{
+    auto parkedCount = _parkedCount.load();
+    while (parkedCount > 0)
+    {
+        if (_parkedCount.compare_exchange_weak(parkedCount, parkedCount - 1))
+            return true;
+    }
+    return false;
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::park()
+{
+    _parkedCount.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Re-check after announcing intent to sleep, to not miss job enqueued in between
+    if (hasVisibleWork() || _isStopping.load())
+    {
+        if (tryCancelParking())
+            return;
+
+        // Someone has already released a token for this worker, consume it
+    }
+
+    _parkingLot.acquire(1);
+}
+
+bool OsmAnd::Concurrent::WorkStealingScheduler::hasVisibleWork() const
+{
+    if (_injectionQueueSize.load() > 0)
+        return true;
+
+    const auto workersCount = _workersCount.load(std::memory_order_acquire);
+    for (auto workerIndex = 0; workerIndex < workersCount; workerIndex++)
+    {
+        const auto worker = _workers[workerIndex].load(std::memory_order_acquire);
+        if (worker && !worker->deque.isEmpty())
+            return true;
+    }
+
+    return false;
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::finishJob()
+{
+    if (_pendingCount.fetch_sub(1) != 1)
+        return;
+
+    QMutexLocker scopedLocker(&_doneMutex);
+    _doneCondition.wakeAll();
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::Job* OsmAnd::Concurrent::WorkStealingScheduler::findJob(WorkerThread* const worker)
+{
+    // Own deque first (LIFO, cache-hot), then shared injection queue, then steal from others (FIFO end)
+    if (const auto job = worker->deque.pop())
+        return job;
+
+    if (const auto job = takeFromInjectionQueue())
+        return job;
+
+    const auto workersCount = _workersCount.load(std::memory_order_acquire);
+    for (auto offset = 1; offset < workersCount; offset++)
+    {
+        const auto victim = _workers[(worker->index + offset) % workersCount].load(std::memory_order_acquire);
+        if (!victim)
+            continue;
+
+        if (const auto job = victim->deque.steal())
+            return job;
+    }
+
+    return nullptr;
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::execute(Job* const job)
+{
+    OSMAND_TRACE_SCOPE("WorkerPool", "execute");
+
+    const auto runnable = job->runnable;
+    delete job;
+
+    _activeCount.fetch_add(1);
+#ifndef QT_NO_EXCEPTIONS
+    try
+    {
+#endif
+        runnable->run();
+#ifndef QT_NO_EXCEPTIONS
+
+        if (runnable->autoDelete())
+            delete runnable;
+    }
+    catch (...)
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "Exception was caught during execution of worker runnable %p. It must be caught inside runnable, otherwise runnable will be lost!", runnable);
+    }
+#endif
+    _activeCount.fetch_sub(1);
+
+    finishJob();
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::Job::Job(QRunnable* const runnable_)
+    : runnable(runnable_)
+    , state(static_cast<int>(JobState::Queued))
+{
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::Deque::Deque()
+    : _top(0)
+    , _bottom(0)
+    , _buffer(new Buffer(256))
+{
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::Deque::~Deque()
+{
+    // Jobs left here were dequeued, otherwise owning pool would still be waiting for them
+    const auto buffer = _buffer.load();
+    for (auto index = _top.load(); index < _bottom.load(); index++)
+        delete buffer->get(index);
+
+    delete buffer;
+    for (const auto& retiredBuffer : _retiredBuffers)
+        delete retiredBuffer;
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::Deque::push(Job* const job)
+{
+    const auto bottom = _bottom.load(std::memory_order_relaxed);
+    const auto top = _top.load(std::memory_order_acquire);
+    auto buffer = _buffer.load(std::memory_order_relaxed);
+
+    if (bottom - top > buffer->capacity - 1)
+    {
+        const auto grownBuffer = new Buffer(buffer->capacity * 2);
+        for (auto index = top; index < bottom; index++)
+            grownBuffer->put(index, buffer->get(index));
+        _retiredBuffers.push_back(buffer);
+        _buffer.store(grownBuffer, std::memory_order_release);
+        buffer = grownBuffer;
+    }
+
+    buffer->put(bottom, job);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::Job* OsmAnd::Concurrent::WorkStealingScheduler::Deque::pop()
+{
+    const auto bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    const auto buffer = _buffer.load(std::memory_order_relaxed);
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = _top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        // Deque was empty
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto job = buffer->get(bottom);
+    if (top == bottom)
+    {
+        // Last element, race against stealers
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::Job* OsmAnd::Concurrent::WorkStealingScheduler::Deque::steal()
+{
+    auto top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = _bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+        return nullptr;
+
+    const auto buffer = _buffer.load(std::memory_order_acquire);
+    const auto job = buffer->get(top);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+
+    return job;
+}
+
+bool OsmAnd::Concurrent::WorkStealingScheduler::Deque::isEmpty() const
+{
+    const auto top = _top.load(std::memory_order_acquire);
+    const auto bottom = _bottom.load(std::memory_order_acquire);
+    return bottom <= top;
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::Deque::Buffer::Buffer(const int64_t capacity_)
+    : capacity(capacity_)
+    , slots(new std::atomic<Job*>[capacity_])
+{
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::Deque::Buffer::~Buffer()
+{
+    delete[] slots;
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::WorkerThread::WorkerThread(WorkStealingScheduler* const scheduler_, const int index_)
+    : scheduler(scheduler_)
+    , index(index_)
+{
+}
+
+OsmAnd::Concurrent::WorkStealingScheduler::WorkerThread::~WorkerThread()
+{
+}
+
+void OsmAnd::Concurrent::WorkStealingScheduler::WorkerThread::run()
+{
+    for (;;)
+    {
+        if (scheduler->_isStopping.load())
+            return;
+
+        // Workers above the limit sleep until limit is raised. Their deques are drained by others
+        if (index >= scheduler->getEffectiveMaxThreadCount())
+        {
+            QMutexLocker scopedLocker(&scheduler->_workersMutex);
+            while (index >= scheduler->getEffectiveMaxThreadCount() && !scheduler->_isStopping.load())
+                REPEAT_UNTIL(scheduler->_excessWorkersWakeup.wait(&scheduler->_workersMutex));
+            continue;
+        }
+
+        const auto job = scheduler->findJob(this);
+        if (!job)
+        {
+            scheduler->park();
+            continue;
+        }
+
+        // Job may have been dequeued while it was waiting
+        if (!scheduler->claimJob(job))
+        {
+            delete job;
+            continue;
+        }
+
+        scheduler->execute(job);
+    }
+}
@@ -0,0 +1,187 @@
+#ifndef _OSMAND_CORE_CONCURRENT_WORK_STEALING_SCHEDULER_H_
+#define _OSMAND_CORE_CONCURRENT_WORK_STEALING_SCHEDULER_H_
+
+#include "stdlib_common.h"
+#include <atomic>
+#include <array>
+#include <vector>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QRunnable>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSemaphore>
+#include <QQueue>
+#include <QHash>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+
+namespace OsmAnd
+{
+    namespace Concurrent
+    {
+        // Executor with per-worker Chase-Lev deques. Owner thread pushes and pops at the bottom of its own
+        // deque without locks, idle workers steal from the top of other deques with a single CAS. Runnables
+        // enqueued from outside of the pool go to a shared injection queue. Idle workers park on a single
+        // semaphore instead of per-thread wait conditions.
+        class WorkStealingScheduler Q_DECL_FINAL
+        {
+            Q_DISABLE_COPY_AND_MOVE(WorkStealingScheduler);
+
+        private:
+            enum class JobState : int
+            {
+                Queued,
+                Running,
+                Dequeued
+            };
+
+            struct Job
+            {
+                Job(QRunnable* const runnable);
+
+                QRunnable* const runnable;
+                std::atomic<int> state;
+            };
+
+            class Deque Q_DECL_FINAL
+            {
+                Q_DISABLE_COPY_AND_MOVE(Deque);
+
+            private:
+                struct Buffer
+                {
+                    Buffer(const int64_t capacity);
+                    ~Buffer();
+
+                    const int64_t capacity;
+                    std::atomic<Job*>* const slots;
+
+                    inline Job* get(const int64_t index) const
+                    {
+                        return slots[index & (capacity - 1)].load(std::memory_order_relaxed);
+                    }
+
+                    inline void put(const int64_t index, Job* const job)
+                    {
+                        slots[index & (capacity - 1)].store(job, std::memory_order_relaxed);
+                    }
+                };
+
+                std::atomic<int64_t> _top;
+                std::atomic<int64_t> _bottom;
+                std::atomic<Buffer*> _buffer;
+
+                // Buffers that were replaced by bigger ones. Stealers may still read them,
+                // so they are released only with the deque itself
+                std::vector<Buffer*> _retiredBuffers;
+            public:
+                Deque();
+                ~Deque();
+
+                // Owner thread only
+                void push(Job* const job);
+                Job* pop();
+
+                // Any thread
+                Job* steal();
+                bool isEmpty() const;
+            };
+
+            class WorkerThread Q_DECL_FINAL : public QThread
+            {
+                Q_DISABLE_COPY_AND_MOVE(WorkerThread);
+
+            private:
+            protected:
+            public:
+                WorkerThread(WorkStealingScheduler* const scheduler, const int index);
+                virtual ~WorkerThread();
+
+                WorkStealingScheduler* const scheduler;
+                const int index;
+                Deque deque;
+
+                virtual void run();
+            };
+
+            // Registry of queued jobs, to support dequeue of specific runnable. Striped to avoid
+            // all threads contending on single lock
+            enum {
+                RegistryStripesCount = 16
+            };
+            struct RegistryStripe
+            {
+                QMutex mutex;
+                QHash<QRunnable*, Job*> jobs;
+            };
+            std::array<RegistryStripe, RegistryStripesCount> _registry;
+            RegistryStripe& getRegistryStripe(QRunnable* const runnable);
+            void registerJob(Job* const job);
+            bool claimJob(Job* const job);
+
+            // Runnables enqueued from non-worker threads
+            mutable QMutex _injectionQueueMutex;
+            QQueue<Job*> _injectionQueue;
+            std::atomic<int> _injectionQueueSize;
+            Job* takeFromInjectionQueue();
+
+            // Workers array is never reallocated, so stealers may walk it without locking
+            enum {
+                MaxWorkersCount = 64
+            };
+            mutable QMutex _workersMutex;
+            std::array<std::atomic<WorkerThread*>, MaxWorkersCount> _workers;
+            std::atomic<int> _workersCount;
+            std::atomic<int> _maxThreadCount;
+            int getEffectiveMaxThreadCount() const;
+            std::atomic<bool> _isStopping;
+            QWaitCondition _excessWorkersWakeup;
+            void ensureWorkersCreated();
+            WorkerThread* getCurrentWorker() const;
+
+            // Parking
+            QSemaphore _parkingLot;
+            std::atomic<int> _parkedCount;
+            void unparkOne();
+            bool tryCancelParking();
+            void park();
+            bool hasVisibleWork() const;
+
+            // Completion tracking
+            std::atomic<int> _pendingCount;
+            std::atomic<unsigned int> _activeCount;
+            mutable QMutex _doneMutex;
+            mutable QWaitCondition _doneCondition;
+            void finishJob();
+
+            Job* findJob(WorkerThread* const worker);
+            void execute(Job* const job);
+        protected:
+        public:
+            WorkStealingScheduler(const int maxThreadCount);
+            ~WorkStealingScheduler();
+
+            // Scheduler with QThread::idealThreadCount() workers, that lives while anyone references it
+            static std::shared_ptr<WorkStealingScheduler> obtainShared();
+
+            int maxThreadCount() const;
+            void setMaxThreadCount(const int maxThreadCount);
+            unsigned int activeThreadCount() const;
+
+            void enqueue(QRunnable* const runnable);
+            void enqueue(const QVector<QRunnable*>& runnables);
+            bool dequeue(QRunnable* const runnable);
+            void dequeueAll();
+
+            bool waitForDone(const int msecs) const;
+            void reset();
+        };
+    }
+}
+
+#endif // !defined(_OSMAND_CORE_CONCURRENT_WORK_STEALING_SCHEDULER_H_)
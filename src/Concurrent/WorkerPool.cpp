@@ -3,8 +3,9 @@
 
 OsmAnd::Concurrent::WorkerPool::WorkerPool(
     const Order order /*= Order::FIFO*/,
-    const int maxThreadCount /*= QThread::idealThreadCount()*/)
-    : _p(new WorkerPool_P(this, order, maxThreadCount))
+    const int maxThreadCount /*= QThread::idealThreadCount()*/,
+    const Scheduler scheduler /*= Scheduler::SharedQueue*/)
+    : _p(new WorkerPool_P(this, order, maxThreadCount, scheduler))
 {
 }
 
@@ -13,6 +14,11 @@ OsmAnd::Concurrent::WorkerPool::~WorkerPool()
     reset();
 }
 
+OsmAnd::Concurrent::WorkerPool::Scheduler OsmAnd::Concurrent::WorkerPool::scheduler() const
+{
+    return _p->scheduler;
+}
+
 OsmAnd::Concurrent::WorkerPool::Order OsmAnd::Concurrent::WorkerPool::order() const
 {
     return _p->order();
@@ -68,6 +74,23 @@ void OsmAnd::Concurrent::WorkerPool::sortQueue(const SortPredicate predicate)
     _p->sortQueue(predicate);
 }
 
+OsmAnd::Concurrent::WorkerPool::PriorityFunction OsmAnd::Concurrent::WorkerPool::priorityFunction() const
+{
+    return _p->priorityFunction();
+}
+
+void OsmAnd::Concurrent::WorkerPool::setPriorityFunction(
+    const PriorityFunction priorityFunction,
+    const bool reprioritize /*= true*/)
+{
+    _p->setPriorityFunction(priorityFunction, reprioritize);
+}
+
+void OsmAnd::Concurrent::WorkerPool::reprioritize()
+{
+    _p->reprioritize();
+}
+
 void OsmAnd::Concurrent::WorkerPool::reset()
 {
     _p->reset();
@@ -5,14 +5,25 @@
 #include <QElapsedTimer>
 
 #include "Logging.h"
-
-OsmAnd::Concurrent::WorkerPool_P::WorkerPool_P(WorkerPool* const owner_, const Order order_, const int maxThreadCount_)
-    : _order(static_cast<int>(order_))
+#include "Tracing.h"
+
+OsmAnd::Concurrent::WorkerPool_P::WorkerPool_P(
+    WorkerPool* const owner_,
+    const Order order_,
+    const int maxThreadCount_,
+    const Scheduler scheduler_)
+    : _workStealingScheduler(scheduler_ == Scheduler::WorkStealing ? new WorkStealingScheduler(maxThreadCount_) : nullptr)
+    , _sharedScheduler(scheduler_ == Scheduler::SharedWorkStealing ? WorkStealingScheduler::obtainShared() : nullptr)
+    , _submittedCount(0)
+    , _order(static_cast<int>(order_))
     , _maxThreadCount(maxThreadCount_)
+    , _priorityQueueSerial(0)
     , _isBeingReset(false)
     , owner(owner_)
+    , scheduler(scheduler_)
 {
     _queue.reserve(1024);
+    _priorityQueue.reserve(1024);
 }
 
 OsmAnd::Concurrent::WorkerPool_P::~WorkerPool_P()
@@ -26,18 +37,31 @@ OsmAnd::Concurrent::WorkerPool_P::Order OsmAnd::Concurrent::WorkerPool_P::order(
 
 void OsmAnd::Concurrent::WorkerPool_P::setOrder(const Order order)
 {
-    _order.storeRelease(static_cast<int>(order));
+    QMutexLocker scopedLocker(&_mutex);
+
+    const auto oldOrder = static_cast<Order>(_order.fetchAndStoreOrdered(static_cast<int>(order)));
+    switchQueueNoLock(oldOrder, order);
 }
 
 int OsmAnd::Concurrent::WorkerPool_P::maxThreadCount() const
 {
+    if (_workStealingScheduler)
+        return _workStealingScheduler->maxThreadCount();
+
     return _maxThreadCount.loadAcquire();
 }
 
 void OsmAnd::Concurrent::WorkerPool_P::setMaxThreadCount(int maxThreadCount)
 {
+    if (_workStealingScheduler)
+    {
+        _workStealingScheduler->setMaxThreadCount(maxThreadCount);
+        return;
+    }
+
     const auto oldMaxThreadCount = _maxThreadCount.fetchAndStoreOrdered(maxThreadCount);
-    if (maxThreadCount > 0 && oldMaxThreadCount <= maxThreadCount)
+    // Own threads pick up more runnables by themselves, while shared scheduler gets only submitted ones
+    if (!_sharedScheduler && maxThreadCount > 0 && oldMaxThreadCount <= maxThreadCount)
         return;
 
     QMutexLocker scopedLocker(&_mutex);
@@ -46,6 +70,9 @@ void OsmAnd::Concurrent::WorkerPool_P::setMaxThreadCount(int maxThreadCount)
 
 unsigned int OsmAnd::Concurrent::WorkerPool_P::activeThreadCount() const
 {
+    if (_workStealingScheduler)
+        return _workStealingScheduler->activeThreadCount();
+
     QMutexLocker scopedLocker(&_mutex);
 
     return activeThreadCountNoLock();
@@ -53,6 +80,9 @@ unsigned int OsmAnd::Concurrent::WorkerPool_P::activeThreadCount() const
 
 bool OsmAnd::Concurrent::WorkerPool_P::waitForDone(const int msecs) const
 {
+    if (_workStealingScheduler)
+        return _workStealingScheduler->waitForDone(msecs);
+
     QMutexLocker scopedLocker(&_mutex);
     
     return waitForDoneNoLock(msecs);
@@ -60,31 +90,70 @@ bool OsmAnd::Concurrent::WorkerPool_P::waitForDone(const int msecs) const
 
 void OsmAnd::Concurrent::WorkerPool_P::enqueue(QRunnable* const runnable, const SortPredicate predicate)
 {
+    if (_workStealingScheduler)
+    {
+        _workStealingScheduler->enqueue(runnable);
+        return;
+    }
+
     QMutexLocker scopedLocker(&_mutex);
-    
-    _queue.push_front(runnable);
-    if (predicate)
-        sortQueueNoLock(predicate);
 
-    tryLaunchNextRunnable();
+    if (order() == Order::Priority)
+    {
+        priorityQueuePush(runnable);
+    }
+    else
+    {
+        _queue.push_front(runnable);
+        if (predicate)
+            sortQueueNoLock(predicate);
+    }
+
+    if (_sharedScheduler)
+        tryLaunchNextRunnables();
+    else
+        tryLaunchNextRunnable();
 }
 
 void OsmAnd::Concurrent::WorkerPool_P::enqueue(const QVector<QRunnable*>& runnables, const SortPredicate predicate)
 {
+    if (_workStealingScheduler)
+    {
+        _workStealingScheduler->enqueue(runnables);
+        return;
+    }
+
     QMutexLocker scopedLocker(&_mutex);
 
-    for (const auto& runnable : constOf(runnables))
-        _queue.push_front(runnable);
-    if (predicate)
-        sortQueueNoLock(predicate);
+    if (order() == Order::Priority)
+    {
+        for (const auto& runnable : constOf(runnables))
+            priorityQueuePush(runnable);
+    }
+    else
+    {
+        for (const auto& runnable : constOf(runnables))
+            _queue.push_front(runnable);
+        if (predicate)
+            sortQueueNoLock(predicate);
+    }
 
-    tryLaunchNextRunnable();
+    if (_sharedScheduler)
+        tryLaunchNextRunnables();
+    else
+        tryLaunchNextRunnable();
 }
 
 bool OsmAnd::Concurrent::WorkerPool_P::dequeue(QRunnable* const runnable, const SortPredicate predicate)
 {
+    if (_workStealingScheduler)
+        return _workStealingScheduler->dequeue(runnable);
+
     QMutexLocker scopedLocker(&_mutex);
-    
+
+    if (order() == Order::Priority)
+        return priorityQueueRemove(runnable);
+
     const auto result = _queue.removeOne(runnable);
     if (result && predicate)
         sortQueueNoLock(predicate);
@@ -94,6 +163,12 @@ bool OsmAnd::Concurrent::WorkerPool_P::dequeue(QRunnable* const runnable, const
 
 void OsmAnd::Concurrent::WorkerPool_P::dequeueAll()
 {
+    if (_workStealingScheduler)
+    {
+        _workStealingScheduler->dequeueAll();
+        return;
+    }
+
     QMutexLocker scopedLocker(&_mutex);
 
     dequeueAllNoLock();
@@ -106,8 +181,39 @@ void OsmAnd::Concurrent::WorkerPool_P::sortQueue(const SortPredicate predicate)
     sortQueueNoLock(predicate);
 }
 
+OsmAnd::Concurrent::WorkerPool_P::PriorityFunction OsmAnd::Concurrent::WorkerPool_P::priorityFunction() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _priorityFunction;
+}
+
+void OsmAnd::Concurrent::WorkerPool_P::setPriorityFunction(
+    const PriorityFunction priorityFunction,
+    const bool reprioritize)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    _priorityFunction = priorityFunction;
+    if (reprioritize)
+        priorityQueueRebuild();
+}
+
+void OsmAnd::Concurrent::WorkerPool_P::reprioritize()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    priorityQueueRebuild();
+}
+
 void OsmAnd::Concurrent::WorkerPool_P::reset()
 {
+    if (_workStealingScheduler)
+    {
+        _workStealingScheduler->reset();
+        return;
+    }
+
     QMutexLocker scopedLocker(&_mutex);
 
     dequeueAllNoLock();
@@ -129,6 +235,9 @@ void OsmAnd::Concurrent::WorkerPool_P::reset()
 
 unsigned int OsmAnd::Concurrent::WorkerPool_P::activeThreadCountNoLock() const
 {
+    if (_sharedScheduler)
+        return _submittedCount;
+
     return _allThreads.count() - _freeThreads.count() - _inactiveThreads.count();
 }
 
@@ -145,6 +254,9 @@ void OsmAnd::Concurrent::WorkerPool_P::createNewThread()
 
 bool OsmAnd::Concurrent::WorkerPool_P::tryLaunchNextRunnable()
 {
+    if (_sharedScheduler)
+        return trySubmitNextRunnable();
+
     // In case there are no threads, create new one
     if (_allThreads.isEmpty())
     {
@@ -177,16 +289,32 @@ bool OsmAnd::Concurrent::WorkerPool_P::tryLaunchNextRunnable()
 
 void OsmAnd::Concurrent::WorkerPool_P::tryLaunchNextRunnables()
 {
-    while (!_queue.isEmpty() && tryLaunchNextRunnable());
+    while (!isQueueEmptyNoLock() && tryLaunchNextRunnable());
+}
+
+bool OsmAnd::Concurrent::WorkerPool_P::trySubmitNextRunnable()
+{
+    if (tooManyThreadsActive())
+        return false;
+
+    const auto runnable = takeNextRunnable();
+    if (!runnable)
+        return false;
+
+    _submittedCount++;
+    _sharedScheduler->enqueue(new SubmittedRunnable(this, runnable));
+    return true;
 }
 
 QRunnable* OsmAnd::Concurrent::WorkerPool_P::takeNextRunnable()
 {
-    if (_queue.isEmpty())
+    if (isQueueEmptyNoLock())
         return nullptr;
 
     switch (order())
     {
+        case Order::Priority:
+            return priorityQueuePop();
         case Order::FIFO:
             return _queue.takeFirst();
         case Order::LIFO:
@@ -212,13 +340,21 @@ void OsmAnd::Concurrent::WorkerPool_P::dequeueAllNoLock()
             delete runnable;
     }
     _queue.clear();
+
+    for (const auto& entry : constOf(_priorityQueue))
+    {
+        if (entry.runnable->autoDelete())
+            delete entry.runnable;
+    }
+    _priorityQueue.clear();
+    _priorityQueueIndices.clear();
 }
 
 bool OsmAnd::Concurrent::WorkerPool_P::waitForDoneNoLock(const int msecs) const
 {
     if (msecs < 0)
     {
-        while (activeThreadCountNoLock() != 0 || !_queue.isEmpty())
+        while (activeThreadCountNoLock() != 0 || !isQueueEmptyNoLock())
             REPEAT_UNTIL(_threadFreed.wait(&_mutex));
     }
     else
@@ -226,18 +362,163 @@ bool OsmAnd::Concurrent::WorkerPool_P::waitForDoneNoLock(const int msecs) const
         QElapsedTimer waitTimer;
         waitTimer.start();
         int timeLeft;
-        while ((activeThreadCountNoLock() != 0 || !_queue.isEmpty()) && ((timeLeft = msecs - waitTimer.elapsed()) > 0))
+        while ((activeThreadCountNoLock() != 0 || !isQueueEmptyNoLock()) && ((timeLeft = msecs - waitTimer.elapsed()) > 0))
             _threadFreed.wait(&_mutex, timeLeft);
     }
 
-    return activeThreadCountNoLock() == 0 && _queue.isEmpty();
+    return activeThreadCountNoLock() == 0 && isQueueEmptyNoLock();
 }
 
 void OsmAnd::Concurrent::WorkerPool_P::sortQueueNoLock(const SortPredicate predicate)
 {
+    // Heap in Order::Priority mode is ordered by priority function only
+    if (order() == Order::Priority)
+        return;
+
     std::sort(_queue, predicate);
 }
 
+bool OsmAnd::Concurrent::WorkerPool_P::isQueueEmptyNoLock() const
+{
+    return _queue.isEmpty() && _priorityQueue.isEmpty();
+}
+
+void OsmAnd::Concurrent::WorkerPool_P::switchQueueNoLock(const Order oldOrder, const Order newOrder)
+{
+    if (oldOrder == newOrder)
+        return;
+
+    if (newOrder == Order::Priority)
+    {
+        for (const auto& runnable : constOf(_queue))
+            priorityQueuePush(runnable);
+        _queue.clear();
+    }
+    else if (oldOrder == Order::Priority)
+    {
+        // Keep priority order: with FIFO highest priority will be taken first
+        while (!_priorityQueue.isEmpty())
+            _queue.push_back(priorityQueuePop());
+        if (newOrder == Order::LIFO)
+            std::reverse(_queue.begin(), _queue.end());
+    }
+}
+
+bool OsmAnd::Concurrent::WorkerPool_P::isLowerPriority(const PrioritizedRunnable& l, const PrioritizedRunnable& r)
+{
+    // Among equal priorities, one that was enqueued earlier goes first
+    if (l.priority != r.priority)
+        return l.priority < r.priority;
+    return l.serial > r.serial;
+}
+
+void OsmAnd::Concurrent::WorkerPool_P::priorityQueuePlace(const int index, const PrioritizedRunnable& entry)
+{
+    _priorityQueue[index] = entry;
+    _priorityQueueIndices[entry.runnable] = index;
+}
+
+void OsmAnd::Concurrent::WorkerPool_P::priorityQueueSiftUp(int index)
+{
+    const auto entry = _priorityQueue[index];
+    while (index > 0)
+    {
+        const auto parentIndex = (index - 1) / 2;
+        const auto& parent = _priorityQueue[parentIndex];
+        if (!isLowerPriority(parent, entry))
+            break;
+
+        priorityQueuePlace(index, parent);
+        index = parentIndex;
+    }
+    priorityQueuePlace(index, entry);
+}
+
+void OsmAnd::Concurrent::WorkerPool_P::priorityQueueSiftDown(int index)
+{
+    const auto size = _priorityQueue.size();
+    const auto entry = _priorityQueue[index];
+    for (;;)
+    {
+        auto childIndex = 2 * index + 1;
+        if (childIndex >= size)
+            break;
+        if (childIndex + 1 < size && isLowerPriority(_priorityQueue[childIndex], _priorityQueue[childIndex + 1]))
+            childIndex++;
+        if (!isLowerPriority(entry, _priorityQueue[childIndex]))
+            break;
+
+        priorityQueuePlace(index, _priorityQueue[childIndex]);
+        index = childIndex;
+    }
+    priorityQueuePlace(index, entry);
+}
+
+void OsmAnd::Concurrent::WorkerPool_P::priorityQueuePush(QRunnable* const runnable)
+{
+    PrioritizedRunnable entry;
+    entry.runnable = runnable;
+    entry.priority = _priorityFunction ? _priorityFunction(runnable) : 0;
+    entry.serial = _priorityQueueSerial++;
+
+    _priorityQueue.push_back(entry);
+    priorityQueueSiftUp(_priorityQueue.size() - 1);
+}
+
+QRunnable* OsmAnd::Concurrent::WorkerPool_P::priorityQueuePop()
+{
+    if (_priorityQueue.isEmpty())
+        return nullptr;
+
+    const auto runnable = _priorityQueue.first().runnable;
+    _priorityQueueIndices.remove(runnable);
+
+    const auto last = _priorityQueue.last();
+    _priorityQueue.removeLast();
+    if (!_priorityQueue.isEmpty())
+    {
+        _priorityQueue[0] = last;
+        priorityQueueSiftDown(0);
+    }
+
+    return runnable;
+}
+
+bool OsmAnd::Concurrent::WorkerPool_P::priorityQueueRemove(QRunnable* const runnable)
+{
+    const auto citIndex = _priorityQueueIndices.constFind(runnable);
+    if (citIndex == _priorityQueueIndices.cend())
+        return false;
+    const auto index = *citIndex;
+    _priorityQueueIndices.erase(citIndex);
+
+    const auto last = _priorityQueue.last();
+    _priorityQueue.removeLast();
+    if (index < _priorityQueue.size())
+    {
+        // Replacement may need to go either direction
+        const auto removed = _priorityQueue[index];
+        _priorityQueue[index] = last;
+        if (isLowerPriority(removed, last))
+            priorityQueueSiftUp(index);
+        else
+            priorityQueueSiftDown(index);
+    }
+
+    return true;
+}
+
+void OsmAnd::Concurrent::WorkerPool_P::priorityQueueRebuild()
+{
+    // Re-evaluate all priorities and heapify in O(n)
+    for (auto& entry : _priorityQueue)
+        entry.priority = _priorityFunction ? _priorityFunction(entry.runnable) : 0;
+    for (auto index = _priorityQueue.size() / 2 - 1; index >= 0; index--)
+        priorityQueueSiftDown(index);
+    for (auto index = 0, size = _priorityQueue.size(); index < size; index++)
+        _priorityQueueIndices[_priorityQueue[index].runnable] = index;
+}
+
 OsmAnd::Concurrent::WorkerPool_P::WorkerThread::WorkerThread(WorkerPool_P* const pool_)
     : pool(pool_)
 {
@@ -294,7 +575,10 @@ void OsmAnd::Concurrent::WorkerPool_P::WorkerThread::run()
         try
         {
 #endif
-            runnable->run();
+            {
+                OSMAND_TRACE_SCOPE("WorkerPool", "execute");
+                runnable->run();
+            }
 #ifndef QT_NO_EXCEPTIONS
 
             if (runnable->autoDelete())
@@ -317,3 +601,43 @@ void OsmAnd::Concurrent::WorkerPool_P::WorkerThread::run()
         }
     }
 }
+
+OsmAnd::Concurrent::WorkerPool_P::SubmittedRunnable::SubmittedRunnable(
+    WorkerPool_P* const pool_,
+    QRunnable* const runnable_)
+    : pool(pool_)
+    , runnable(runnable_)
+{
+    setAutoDelete(true);
+}
+
+OsmAnd::Concurrent::WorkerPool_P::SubmittedRunnable::~SubmittedRunnable()
+{
+}
+
+void OsmAnd::Concurrent::WorkerPool_P::SubmittedRunnable::run()
+{
+#ifndef QT_NO_EXCEPTIONS
+    try
+    {
+#endif
+        runnable->run();
+
+        if (runnable->autoDelete())
+            delete runnable;
+#ifndef QT_NO_EXCEPTIONS
+    }
+    catch (...)
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "Exception was caught during execution of worker runnable %p. It must be caught inside runnable, otherwise runnable will be lost!", runnable);
+    }
+#endif
+
+    // Slot of this pool is free, so next runnable can be submitted
+    QMutexLocker scopedLocker(&pool->_mutex);
+
+    pool->_submittedCount--;
+    pool->_threadFreed.wakeAll();
+    pool->tryLaunchNextRunnables();
+}
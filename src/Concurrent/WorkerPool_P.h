@@ -13,11 +13,13 @@
 #include <QSet>
 #include <QQueue>
 #include <QVector>
+#include <QHash>
 #include "restore_internal_warnings.h"
 
 #include "OsmAndCore.h"
 #include "PrivateImplementation.h"
 #include "WorkerPool.h"
+#include "WorkStealingScheduler.h"
 
 namespace OsmAnd
 {
@@ -30,6 +32,8 @@ namespace OsmAnd
         public:
             typedef WorkerPool::Order Order;
             typedef WorkerPool::SortPredicate SortPredicate;
+            typedef WorkerPool::PriorityFunction PriorityFunction;
+            typedef WorkerPool::Scheduler Scheduler;
 
         private:
             class WorkerThread Q_DECL_FINAL : public QThread
@@ -51,11 +55,57 @@ namespace OsmAnd
             friend class OsmAnd::Concurrent::WorkerPool_P;
             };
 
+            // Runnable taken from queue of this pool and handed to shared scheduler
+            class SubmittedRunnable Q_DECL_FINAL : public QRunnable
+            {
+                Q_DISABLE_COPY_AND_MOVE(SubmittedRunnable);
+
+            private:
+            protected:
+            public:
+                SubmittedRunnable(WorkerPool_P* const pool, QRunnable* const runnable);
+                virtual ~SubmittedRunnable();
+
+                WorkerPool_P* const pool;
+                QRunnable* const runnable;
+
+                virtual void run();
+            };
+
+            // Set only in Scheduler::WorkStealing mode, then all queueing is delegated to it
+            const std::unique_ptr<WorkStealingScheduler> _workStealingScheduler;
+
+            // Set only in Scheduler::SharedWorkStealing mode, then it replaces own threads of pool
+            const std::shared_ptr<WorkStealingScheduler> _sharedScheduler;
+            unsigned int _submittedCount;
+
             QAtomicInt _order;
             QAtomicInt _maxThreadCount;
 
             mutable QMutex _mutex;
             QVector<QRunnable*> _queue;
+
+            // Binary max-heap used in Order::Priority mode, with positions of each runnable in it
+            struct PrioritizedRunnable
+            {
+                QRunnable* runnable;
+                int64_t priority;
+                uint64_t serial;
+            };
+            QVector<PrioritizedRunnable> _priorityQueue;
+            QHash<QRunnable*, int> _priorityQueueIndices;
+            uint64_t _priorityQueueSerial;
+            PriorityFunction _priorityFunction;
+            static bool isLowerPriority(const PrioritizedRunnable& l, const PrioritizedRunnable& r);
+            void priorityQueuePlace(const int index, const PrioritizedRunnable& entry);
+            void priorityQueueSiftUp(int index);
+            void priorityQueueSiftDown(int index);
+            void priorityQueuePush(QRunnable* const runnable);
+            QRunnable* priorityQueuePop();
+            bool priorityQueueRemove(QRunnable* const runnable);
+            void priorityQueueRebuild();
+            void switchQueueNoLock(const Order oldOrder, const Order newOrder);
+            bool isQueueEmptyNoLock() const;
             QSet<WorkerThread*> _allThreads;
             QQueue<WorkerThread*> _freeThreads;
             QQueue<WorkerThread*> _inactiveThreads;
@@ -66,17 +116,19 @@ namespace OsmAnd
             void createNewThread();
             bool tryLaunchNextRunnable();
             void tryLaunchNextRunnables();
+            bool trySubmitNextRunnable();
             QRunnable* takeNextRunnable();
             bool tooManyThreadsActive() const;
             void dequeueAllNoLock();
             bool waitForDoneNoLock(const int msecs) const;
             void sortQueueNoLock(const SortPredicate predicate);
         protected:
-            WorkerPool_P(WorkerPool* const owner, const Order order, const int maxThreadCount);
+            WorkerPool_P(WorkerPool* const owner, const Order order, const int maxThreadCount, const Scheduler scheduler);
         public:
             ~WorkerPool_P();
 
             ImplementationInterface<WorkerPool> owner;
+            const Scheduler scheduler;
 
             Order order() const;
             void setOrder(const Order order);
@@ -94,10 +146,15 @@ namespace OsmAnd
 
             void sortQueue(const SortPredicate predicate);
 
+            PriorityFunction priorityFunction() const;
+            void setPriorityFunction(const PriorityFunction priorityFunction, const bool reprioritize);
+            void reprioritize();
+
             void reset();
 
         friend class OsmAnd::Concurrent::WorkerPool;
         friend class OsmAnd::Concurrent::WorkerPool_P::WorkerThread;
+        friend class OsmAnd::Concurrent::WorkerPool_P::SubmittedRunnable;
         };
     }
 }
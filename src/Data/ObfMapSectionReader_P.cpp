@@ -16,6 +16,7 @@
 #include "BinaryMapObject.h"
 #include "IQueryController.h"
 #include "Stopwatch.h"
+#include "Tracing.h"
 #include "Logging.h"
 #include "Utilities.h"
 
@@ -935,6 +936,8 @@ void OsmAnd::ObfMapSectionReader_P::loadMapObjects(
     const std::shared_ptr<const IQueryController>& queryController,
     ObfMapSectionReader_Metrics::Metric_loadMapObjects* const metric)
 {
+    OSMAND_TRACE_SCOPE("ObfMapSectionReader", "loadMapObjects");
+
     const auto cis = reader.getCodedInputStream().get();
 
     const auto filterReadById =
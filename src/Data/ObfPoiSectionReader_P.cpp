@@ -17,6 +17,7 @@
 #include "Amenity.h"
 #include "ObfReaderUtilities.h"
 #include "IQueryController.h"
+#include "Tracing.h"
 #include "Utilities.h"
 
 const int BUCKET_SEARCH_BY_NAME = 5;
@@ -1430,6 +1431,8 @@ void OsmAnd::ObfPoiSectionReader_P::loadAmenities(
     const ObfPoiSectionReader::VisitorFunction visitor,
     const std::shared_ptr<const IQueryController>& queryController)
 {
+    OSMAND_TRACE_SCOPE("ObfPoiSectionReader", "loadAmenities");
+
     ensureCategoriesLoaded(reader, section);
     ensureSubtypesLoaded(reader, section);
 
@@ -14,6 +14,7 @@
 #include "Road.h"
 #include "ObfReaderUtilities.h"
 #include "Stopwatch.h"
+#include "Tracing.h"
 #include "IQueryController.h"
 #include "Utilities.h"
 
@@ -889,6 +890,8 @@ void OsmAnd::ObfRoutingSectionReader_P::loadRoads(
     const std::shared_ptr<const IQueryController>& queryController,
     ObfRoutingSectionReader_Metrics::Metric_loadRoads* const metric)
 {
+    OSMAND_TRACE_SCOPE("ObfRoutingSectionReader", "loadRoads");
+
     const auto cis = reader.getCodedInputStream().get();
 
     // Ensure encoding/decoding rules are read
@@ -11,6 +11,7 @@
 #include "QKeyValueIterator.h"
 #include "Utilities.h"
 #include "Logging.h"
+#include "GpxStreamReader.h"
 
 OsmAnd::GpxDocument::GpxDocument()
 {
@@ -2163,6 +2164,79 @@ std::shared_ptr<OsmAnd::GpxDocument> OsmAnd::GpxDocument::loadFrom(const QString
     return gpxDocument;
 }
 
+std::shared_ptr<OsmAnd::GpxDocument> OsmAnd::GpxDocument::loadTracksFrom(QIODevice& ioDevice)
+{
+    std::shared_ptr<GpxTrk> trk;
+    std::shared_ptr<GpxTrkSeg> trkseg;
+    const std::shared_ptr<GpxDocument> document(new GpxDocument());
+
+    GpxStreamReader reader;
+    const auto ok = reader.read(ioDevice,
+        [&trk, &trkseg]
+        (const GpxStreamReader::TrackPointsBatch& batch) -> bool
+        {
+            if (!trk)
+                trk.reset(new GpxTrk());
+            if (!trkseg)
+                trkseg.reset(new GpxTrkSeg());
+
+            trkseg->points.reserve(trkseg->points.size() + batch.size());
+            for (auto pointIdx = 0u; pointIdx < batch.size(); pointIdx++)
+            {
+                const std::shared_ptr<GpxTrkPt> trkpt(new GpxTrkPt());
+                trkpt->position.latitude = batch.latitudes[pointIdx];
+                trkpt->position.longitude = batch.longitudes[pointIdx];
+                trkpt->elevation = batch.elevations[pointIdx];
+                const auto timestamp = batch.timestamps[pointIdx];
+                if (timestamp != GpxStreamReader::NoTimestamp)
+                    trkpt->timestamp = QDateTime::fromMSecsSinceEpoch(timestamp, Qt::UTC);
+
+                trkseg->points.append(trkpt);
+            }
+
+            if (batch.isLastInSegment)
+            {
+                trk->segments.append(trkseg);
+                trkseg = nullptr;
+            }
+
+            return true;
+        },
+        [&trk, &document]
+        (const GpxStreamReader::TrackInfo& track) -> bool
+        {
+            if (!trk)
+                trk.reset(new GpxTrk());
+            trk->name = track.name;
+            trk->description = track.description;
+            trk->comment = track.comment;
+            trk->type = track.type;
+
+            document->tracks.append(trk);
+            trk = nullptr;
+
+            return true;
+        });
+    if (!ok)
+        return nullptr;
+
+    document->version = reader.getVersion();
+    document->creator = reader.getCreator();
+
+    return document;
+}
+
+std::shared_ptr<OsmAnd::GpxDocument> OsmAnd::GpxDocument::loadTracksFrom(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return nullptr;
+    const auto gpxDocument = loadTracksFrom(file);
+    file.close();
+
+    return gpxDocument;
+}
+
 OsmAnd::GpxDocument::GpxExtension::GpxExtension()
 {
 }
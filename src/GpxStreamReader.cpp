@@ -0,0 +1,84 @@
+#include "GpxStreamReader.h"
+#include "GpxStreamReader_P.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QFile>
+#include "restore_internal_warnings.h"
+
+OsmAnd::GpxStreamReader::GpxStreamReader(
+    const int batchSize_ /*= DefaultBatchSize*/,
+    const int chunkSize_ /*= DefaultChunkSize*/)
+    : _p(new GpxStreamReader_P(this))
+    , batchSize(qMax(batchSize_, 1))
+    , chunkSize(qMax(chunkSize_, 1))
+{
+}
+
+OsmAnd::GpxStreamReader::~GpxStreamReader()
+{
+}
+
+bool OsmAnd::GpxStreamReader::read(
+    QIODevice& ioDevice,
+    const TrackPointsBatchReady batchReady,
+    const TrackFinished trackFinished /*= nullptr*/)
+{
+    return _p->read(ioDevice, batchReady, trackFinished);
+}
+
+bool OsmAnd::GpxStreamReader::read(
+    const QString& filename,
+    const TrackPointsBatchReady batchReady,
+    const TrackFinished trackFinished /*= nullptr*/)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const auto ok = _p->read(file, batchReady, trackFinished);
+    file.close();
+
+    return ok;
+}
+
+QString OsmAnd::GpxStreamReader::getVersion() const
+{
+    return _p->getVersion();
+}
+
+QString OsmAnd::GpxStreamReader::getCreator() const
+{
+    return _p->getCreator();
+}
+
+bool OsmAnd::GpxStreamReader::hasSkippedContent() const
+{
+    return _p->hasSkippedContent();
+}
+
+uint64_t OsmAnd::GpxStreamReader::getBytesRead() const
+{
+    return _p->getBytesRead();
+}
+
+OsmAnd::GpxStreamReader::TrackPointsBatch::TrackPointsBatch()
+    : trackIndex(-1)
+    , segmentIndex(-1)
+    , isLastInSegment(false)
+{
+}
+
+OsmAnd::GpxStreamReader::TrackPointsBatch::~TrackPointsBatch()
+{
+}
+
+OsmAnd::GpxStreamReader::TrackInfo::TrackInfo()
+    : trackIndex(-1)
+    , segmentsCount(0)
+    , pointsCount(0)
+{
+}
+
+OsmAnd::GpxStreamReader::TrackInfo::~TrackInfo()
+{
+}
@@ -0,0 +1,915 @@
+#include "GpxStreamReader_P.h"
+
+#include <cstring>
+#include <cmath>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QDateTime>
+#include "restore_internal_warnings.h"
+
+#include "Logging.h"
+
+namespace
+{
+    inline bool isWhitespace(const char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    inline void trim(const char*& begin, const char*& end)
+    {
+        while (begin < end && isWhitespace(*begin))
+            begin++;
+        while (end > begin && isWhitespace(*(end - 1)))
+            end--;
+    }
+
+    inline bool isNamed(const char* const name, const int length, const char* const expectedName)
+    {
+        return strncmp(name, expectedName, length) == 0 && expectedName[length] == '\0';
+    }
+
+    const char* findSequence(const char* begin, const char* const end, const char* const sequence, const int length)
+    {
+        while (end - begin >= length)
+        {
+            const auto candidate = static_cast<const char*>(memchr(begin, sequence[0], end - begin - length + 1));
+            if (!candidate)
+                return nullptr;
+            if (memcmp(candidate, sequence, length) == 0)
+                return candidate;
+            begin = candidate + 1;
+        }
+        return nullptr;
+    }
+
+    // Parses 'count' decimal digits
+    inline bool parseDigits(const char* const begin, const int count, int& outValue)
+    {
+        outValue = 0;
+        for (auto idx = 0; idx < count; idx++)
+        {
+            const auto digit = begin[idx] - '0';
+            if (digit < 0 || digit > 9)
+                return false;
+            outValue = outValue * 10 + digit;
+        }
+        return true;
+    }
+
+    // Days since 1970-01-01 of proleptic Gregorian date
+    inline int64_t getDaysFromCivil(int year, const int month, const int day)
+    {
+        year -= (month <= 2) ? 1 : 0;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const int64_t yearOfEra = year - era * 400;
+        const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    void appendUtf8(const uint32_t codePoint, QByteArray& outText)
+    {
+        if (codePoint < 0x80)
+        {
+            outText.append(static_cast<char>(codePoint));
+        }
+        else if (codePoint < 0x800)
+        {
+            outText.append(static_cast<char>(0xC0 | (codePoint >> 6)));
+            outText.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            outText.append(static_cast<char>(0xE0 | (codePoint >> 12)));
+            outText.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            outText.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x110000)
+        {
+            outText.append(static_cast<char>(0xF0 | (codePoint >> 18)));
+            outText.append(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            outText.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            outText.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+}
+
+OsmAnd::GpxStreamReader_P::GpxStreamReader_P(GpxStreamReader* const owner_)
+    : _ioDevice(nullptr)
+    , _endOfInput(false)
+    , _position(0)
+    , _bytesRead(0)
+    , _stopped(false)
+    , _tracksCount(0)
+    , _pointLatitude(0.0)
+    , _pointLongitude(0.0)
+    , _pointElevation(std::numeric_limits<double>::quiet_NaN())
+    , _pointTimestamp(GpxStreamReader::NoTimestamp)
+    , _hasSkippedContent(false)
+    , owner(owner_)
+{
+}
+
+OsmAnd::GpxStreamReader_P::~GpxStreamReader_P()
+{
+}
+
+bool OsmAnd::GpxStreamReader_P::read(
+    QIODevice& ioDevice,
+    const GpxStreamReader::TrackPointsBatchReady batchReady,
+    const GpxStreamReader::TrackFinished trackFinished)
+{
+    _ioDevice = &ioDevice;
+    _endOfInput = false;
+    _buffer.clear();
+    _buffer.reserve(owner->chunkSize);
+    _position = 0;
+    _bytesRead = 0;
+    _stopped = false;
+    _batchReady = batchReady;
+    _trackFinished = trackFinished;
+    _elements.clear();
+    _text.clear();
+    _batch = TrackPointsBatch();
+    _batch.latitudes.reserve(owner->batchSize);
+    _batch.longitudes.reserve(owner->batchSize);
+    _batch.elevations.reserve(owner->batchSize);
+    _batch.timestamps.reserve(owner->batchSize);
+    _track = TrackInfo();
+    _tracksCount = 0;
+    _version = QString::null;
+    _creator = QString::null;
+    _hasSkippedContent = false;
+
+    auto ok = true;
+    auto hasRootElement = false;
+    if (fillBuffer() && _buffer.startsWith("\xEF\xBB\xBF"))
+        _position = 3;
+    while (!_stopped)
+    {
+        const auto data = _buffer.constData();
+        const auto dataEnd = data + _buffer.size();
+
+        // Character data is processed only when it's complete, so that entities are never split
+        const auto markupBegin = static_cast<const char*>(memchr(data + _position, '<', dataEnd - data - _position));
+        if (!markupBegin)
+        {
+            if (!fillBuffer())
+                break;
+            continue;
+        }
+
+        const char* markupEnd = nullptr;
+        const auto markup = findMarkupEnd(markupBegin, dataEnd, markupEnd);
+        if (markup == Markup::Incomplete)
+        {
+            if (!fillBuffer())
+            {
+                LogPrintf(
+                    LogSeverityLevel::Warning,
+                    "GPX error (offset %" PRIu64 "): unterminated markup",
+                    getCurrentOffset());
+                ok = false;
+                break;
+            }
+            continue;
+        }
+
+        processText(data + _position, markupBegin);
+        _position = markupEnd - data;
+
+        switch (markup)
+        {
+            case Markup::StartTag:
+                if (_elements.isEmpty() && hasRootElement)
+                {
+                    LogPrintf(
+                        LogSeverityLevel::Warning,
+                        "GPX error (offset %" PRIu64 "): more than one root element",
+                        getCurrentOffset());
+                    ok = false;
+                    break;
+                }
+                hasRootElement = true;
+                ok = processStartTag(markupBegin + 1, markupEnd - 1);
+                break;
+            case Markup::EndTag:
+                ok = processEndTag();
+                break;
+            case Markup::CData:
+                if (isTextElement())
+                    _text.append(markupBegin + 9, markupEnd - markupBegin - 12);
+                break;
+            default:
+                break;
+        }
+        if (!ok)
+            break;
+    }
+
+    if (ok && !_stopped)
+    {
+        if (!hasRootElement || !_elements.isEmpty())
+        {
+            LogPrintf(
+                LogSeverityLevel::Warning,
+                "GPX error (offset %" PRIu64 "): unexpected end of input",
+                getCurrentOffset());
+            ok = false;
+        }
+    }
+
+    _ioDevice = nullptr;
+    _batchReady = nullptr;
+    _trackFinished = nullptr;
+    _buffer.clear();
+    _elements.clear();
+
+    return ok;
+}
+
+bool OsmAnd::GpxStreamReader_P::fillBuffer()
+{
+    if (_endOfInput)
+        return false;
+
+    // Consumed data is dropped, so buffer only grows past chunk size for a single large token
+    if (_position > 0)
+    {
+        _buffer.remove(0, _position);
+        _position = 0;
+    }
+
+    const auto chunkSize = owner->chunkSize;
+    const auto previousSize = _buffer.size();
+    _buffer.resize(previousSize + chunkSize);
+    const auto bytesRead = _ioDevice->read(_buffer.data() + previousSize, chunkSize);
+    if (bytesRead <= 0)
+    {
+        if (bytesRead < 0)
+        {
+            LogPrintf(
+                LogSeverityLevel::Warning,
+                "GPX error (offset %" PRIu64 "): %s",
+                _bytesRead,
+                qPrintable(_ioDevice->errorString()));
+        }
+
+        _buffer.resize(previousSize);
+        _endOfInput = true;
+        return false;
+    }
+    _buffer.resize(previousSize + static_cast<int>(bytesRead));
+    _bytesRead += bytesRead;
+
+    return true;
+}
+
+uint64_t OsmAnd::GpxStreamReader_P::getCurrentOffset() const
+{
+    return _bytesRead - static_cast<uint64_t>(_buffer.size() - _position);
+}
+
+OsmAnd::GpxStreamReader_P::Markup OsmAnd::GpxStreamReader_P::findMarkupEnd(
+    const char* const begin,
+    const char* const end,
+    const char*& outMarkupEnd) const
+{
+    const auto length = end - begin;
+    if (length < 2)
+        return Markup::Incomplete;
+
+    if (begin[1] == '!')
+    {
+        // Enough to tell comment from CDATA from declaration
+        if (length < 9 && !_endOfInput)
+            return Markup::Incomplete;
+
+        if (length >= 4 && memcmp(begin, "<!--", 4) == 0)
+        {
+            const auto commentEnd = findSequence(begin + 4, end, "-->", 3);
+            if (!commentEnd)
+                return Markup::Incomplete;
+            outMarkupEnd = commentEnd + 3;
+            return Markup::Other;
+        }
+
+        if (length >= 9 && memcmp(begin, "<![CDATA[", 9) == 0)
+        {
+            const auto cdataEnd = findSequence(begin + 9, end, "]]>", 3);
+            if (!cdataEnd)
+                return Markup::Incomplete;
+            outMarkupEnd = cdataEnd + 3;
+            return Markup::CData;
+        }
+
+        // Declaration, possibly with internal subset
+        auto nestingLevel = 0;
+        for (auto pChar = begin + 2; pChar < end; pChar++)
+        {
+            if (*pChar == '[')
+            {
+                nestingLevel++;
+            }
+            else if (*pChar == ']')
+            {
+                nestingLevel--;
+            }
+            else if (*pChar == '>' && nestingLevel <= 0)
+            {
+                outMarkupEnd = pChar + 1;
+                return Markup::Other;
+            }
+        }
+        return Markup::Incomplete;
+    }
+
+    if (begin[1] == '?')
+    {
+        const auto instructionEnd = findSequence(begin + 2, end, "?>", 2);
+        if (!instructionEnd)
+            return Markup::Incomplete;
+        outMarkupEnd = instructionEnd + 2;
+        return Markup::Other;
+    }
+
+    if (begin[1] == '/')
+    {
+        const auto tagEnd = static_cast<const char*>(memchr(begin + 2, '>', end - begin - 2));
+        if (!tagEnd)
+            return Markup::Incomplete;
+        outMarkupEnd = tagEnd + 1;
+        return Markup::EndTag;
+    }
+
+    // Start tag, where attribute values may contain '>'
+    char quote = 0;
+    for (auto pChar = begin + 1; pChar < end; pChar++)
+    {
+        const auto c = *pChar;
+        if (quote)
+        {
+            if (c == quote)
+                quote = 0;
+        }
+        else if (c == '"' || c == '\'')
+        {
+            quote = c;
+        }
+        else if (c == '>')
+        {
+            outMarkupEnd = pChar + 1;
+            return Markup::StartTag;
+        }
+    }
+    return Markup::Incomplete;
+}
+
+bool OsmAnd::GpxStreamReader_P::processStartTag(const char* const begin, const char* const end_)
+{
+    // Tag is given without '<' and '>'
+    auto end = end_;
+    const auto isEmptyElement = (end > begin && *(end - 1) == '/');
+    if (isEmptyElement)
+        end--;
+
+    auto nameEnd = begin;
+    while (nameEnd < end && !isWhitespace(*nameEnd))
+        nameEnd++;
+    auto localName = begin;
+    for (auto pChar = begin; pChar < nameEnd; pChar++)
+    {
+        if (*pChar == ':')
+            localName = pChar + 1;
+    }
+    auto element = identifyElement(localName, static_cast<int>(nameEnd - localName));
+
+    switch (element)
+    {
+        case Element::Gpx:
+        {
+            const char* valueBegin = nullptr;
+            const char* valueEnd = nullptr;
+            if (getAttributeValue(nameEnd, end, "version", valueBegin, valueEnd))
+                _version = decodeText(valueBegin, valueEnd);
+            if (getAttributeValue(nameEnd, end, "creator", valueBegin, valueEnd))
+                _creator = decodeText(valueBegin, valueEnd);
+            break;
+        }
+
+        case Element::Trk:
+            _track = TrackInfo();
+            _track.trackIndex = _tracksCount++;
+            break;
+
+        case Element::TrkSeg:
+            _batch.trackIndex = _track.trackIndex;
+            _batch.segmentIndex = _track.segmentsCount++;
+            break;
+
+        case Element::TrkPt:
+        {
+            const char* latitudeBegin = nullptr;
+            const char* latitudeEnd = nullptr;
+            const char* longitudeBegin = nullptr;
+            const char* longitudeEnd = nullptr;
+            if (!getAttributeValue(nameEnd, end, "lat", latitudeBegin, latitudeEnd) ||
+                !getAttributeValue(nameEnd, end, "lon", longitudeBegin, longitudeEnd) ||
+                !parseDouble(latitudeBegin, latitudeEnd, _pointLatitude) ||
+                !parseDouble(longitudeBegin, longitudeEnd, _pointLongitude))
+            {
+                LogPrintf(
+                    LogSeverityLevel::Warning,
+                    "GPX warning (offset %" PRIu64 "): invalid <trkpt> 'lat' or 'lon' attribute value",
+                    getCurrentOffset());
+                element = Element::Skipped;
+                _hasSkippedContent = true;
+                break;
+            }
+
+            _pointElevation = std::numeric_limits<double>::quiet_NaN();
+            _pointTimestamp = GpxStreamReader::NoTimestamp;
+            break;
+        }
+
+        case Element::Name:
+        case Element::Desc:
+        case Element::Cmt:
+        case Element::Type:
+        case Element::Ele:
+        case Element::Time:
+            _text.clear();
+            break;
+
+        case Element::Skipped:
+            if (_elements.isEmpty())
+            {
+                LogPrintf(
+                    LogSeverityLevel::Warning,
+                    "GPX error (offset %" PRIu64 "): root element is not <gpx>",
+                    getCurrentOffset());
+                return false;
+            }
+            if (_elements.last() != Element::Skipped)
+                _hasSkippedContent = true;
+            break;
+    }
+
+    _elements.push_back(element);
+    if (isEmptyElement)
+        return processEndTag();
+
+    return true;
+}
+
+bool OsmAnd::GpxStreamReader_P::processEndTag()
+{
+    if (_elements.isEmpty())
+    {
+        LogPrintf(
+            LogSeverityLevel::Warning,
+            "GPX error (offset %" PRIu64 "): unexpected end tag",
+            getCurrentOffset());
+        return false;
+    }
+    const auto element = _elements.last();
+    _elements.pop_back();
+
+    switch (element)
+    {
+        case Element::TrkPt:
+            _batch.latitudes.push_back(_pointLatitude);
+            _batch.longitudes.push_back(_pointLongitude);
+            _batch.elevations.push_back(_pointElevation);
+            _batch.timestamps.push_back(_pointTimestamp);
+            _track.pointsCount++;
+            if (_batch.size() >= static_cast<unsigned int>(owner->batchSize))
+                return flushBatch(false);
+            break;
+
+        case Element::TrkSeg:
+            return flushBatch(true);
+
+        case Element::Trk:
+            if (_trackFinished && !_trackFinished(_track))
+                _stopped = true;
+            break;
+
+        case Element::Name:
+            _track.name = QString::fromUtf8(_text).trimmed();
+            break;
+        case Element::Desc:
+            _track.description = QString::fromUtf8(_text).trimmed();
+            break;
+        case Element::Cmt:
+            _track.comment = QString::fromUtf8(_text).trimmed();
+            break;
+        case Element::Type:
+            _track.type = QString::fromUtf8(_text).trimmed();
+            break;
+
+        case Element::Ele:
+            if (!parseDouble(_text.constData(), _text.constData() + _text.size(), _pointElevation))
+            {
+                LogPrintf(
+                    LogSeverityLevel::Warning,
+                    "GPX warning (offset %" PRIu64 "): invalid <ele> value '%s'",
+                    getCurrentOffset(),
+                    _text.constData());
+                _pointElevation = std::numeric_limits<double>::quiet_NaN();
+            }
+            break;
+
+        case Element::Time:
+            if (!parseTimestamp(_text.constData(), _text.constData() + _text.size(), _pointTimestamp))
+            {
+                // Anything but UTC or explicit offset, e.g. local time, is left to QDateTime
+                const auto timestamp = QDateTime::fromString(QString::fromUtf8(_text).trimmed(), Qt::DateFormat::ISODate);
+                if (!timestamp.isValid() || timestamp.isNull())
+                {
+                    LogPrintf(
+                        LogSeverityLevel::Warning,
+                        "GPX warning (offset %" PRIu64 "): invalid <time> value '%s'",
+                        getCurrentOffset(),
+                        _text.constData());
+                    _pointTimestamp = GpxStreamReader::NoTimestamp;
+                }
+                else
+                {
+                    _pointTimestamp = timestamp.toMSecsSinceEpoch();
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return true;
+}
+
+void OsmAnd::GpxStreamReader_P::processText(const char* const begin, const char* const end)
+{
+    if (begin == end || !isTextElement())
+        return;
+
+    appendDecodedText(begin, end, _text);
+}
+
+bool OsmAnd::GpxStreamReader_P::flushBatch(const bool isLastInSegment)
+{
+    _batch.isLastInSegment = isLastInSegment;
+    if (_batchReady && !_batchReady(_batch))
+        _stopped = true;
+
+    // Columns keep their capacity, so there are no allocations after first batch
+    _batch.latitudes.clear();
+    _batch.longitudes.clear();
+    _batch.elevations.clear();
+    _batch.timestamps.clear();
+
+    return true;
+}
+
+OsmAnd::GpxStreamReader_P::Element OsmAnd::GpxStreamReader_P::identifyElement(
+    const char* const localName,
+    const int length) const
+{
+    if (_elements.isEmpty())
+        return isNamed(localName, length, "gpx") ? Element::Gpx : Element::Skipped;
+
+    switch (_elements.last())
+    {
+        case Element::Gpx:
+            if (isNamed(localName, length, "trk"))
+                return Element::Trk;
+            break;
+
+        case Element::Trk:
+            if (isNamed(localName, length, "trkseg"))
+                return Element::TrkSeg;
+            else if (isNamed(localName, length, "name"))
+                return Element::Name;
+            else if (isNamed(localName, length, "desc"))
+                return Element::Desc;
+            else if (isNamed(localName, length, "cmt"))
+                return Element::Cmt;
+            else if (isNamed(localName, length, "type"))
+                return Element::Type;
+            break;
+
+        case Element::TrkSeg:
+            if (isNamed(localName, length, "trkpt"))
+                return Element::TrkPt;
+            break;
+
+        case Element::TrkPt:
+            if (isNamed(localName, length, "ele"))
+                return Element::Ele;
+            else if (isNamed(localName, length, "time"))
+                return Element::Time;
+            break;
+
+        default:
+            break;
+    }
+
+    return Element::Skipped;
+}
+
+bool OsmAnd::GpxStreamReader_P::isTextElement() const
+{
+    if (_elements.isEmpty())
+        return false;
+
+    switch (_elements.last())
+    {
+        case Element::Name:
+        case Element::Desc:
+        case Element::Cmt:
+        case Element::Type:
+        case Element::Ele:
+        case Element::Time:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool OsmAnd::GpxStreamReader_P::getAttributeValue(
+    const char* const begin,
+    const char* const end,
+    const char* const name,
+    const char*& outValueBegin,
+    const char*& outValueEnd)
+{
+    const auto nameLength = static_cast<int>(strlen(name));
+
+    auto pChar = begin;
+    while (pChar < end)
+    {
+        while (pChar < end && isWhitespace(*pChar))
+            pChar++;
+        const auto attributeNameBegin = pChar;
+        while (pChar < end && *pChar != '=' && !isWhitespace(*pChar))
+            pChar++;
+        const auto attributeNameEnd = pChar;
+        while (pChar < end && isWhitespace(*pChar))
+            pChar++;
+        if (pChar >= end || *pChar != '=')
+            return false;
+        pChar++;
+        while (pChar < end && isWhitespace(*pChar))
+            pChar++;
+        if (pChar >= end || (*pChar != '"' && *pChar != '\''))
+            return false;
+        const auto quote = *pChar;
+        const auto valueBegin = ++pChar;
+        const auto valueEnd = static_cast<const char*>(memchr(valueBegin, quote, end - valueBegin));
+        if (!valueEnd)
+            return false;
+        pChar = valueEnd + 1;
+
+        if (attributeNameEnd - attributeNameBegin == nameLength && memcmp(attributeNameBegin, name, nameLength) == 0)
+        {
+            outValueBegin = valueBegin;
+            outValueEnd = valueEnd;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void OsmAnd::GpxStreamReader_P::appendDecodedText(const char* const begin, const char* const end, QByteArray& outText)
+{
+    auto pChar = begin;
+    while (pChar < end)
+    {
+        const auto ampersand = static_cast<const char*>(memchr(pChar, '&', end - pChar));
+        if (!ampersand)
+        {
+            outText.append(pChar, static_cast<int>(end - pChar));
+            return;
+        }
+        outText.append(pChar, static_cast<int>(ampersand - pChar));
+
+        const auto semicolon = static_cast<const char*>(memchr(ampersand, ';', end - ampersand));
+        if (!semicolon)
+        {
+            outText.append(ampersand, static_cast<int>(end - ampersand));
+            return;
+        }
+        const auto entity = ampersand + 1;
+        const auto entityLength = static_cast<int>(semicolon - entity);
+        if (isNamed(entity, entityLength, "lt"))
+            outText.append('<');
+        else if (isNamed(entity, entityLength, "gt"))
+            outText.append('>');
+        else if (isNamed(entity, entityLength, "amp"))
+            outText.append('&');
+        else if (isNamed(entity, entityLength, "quot"))
+            outText.append('"');
+        else if (isNamed(entity, entityLength, "apos"))
+            outText.append('\'');
+        else if (entityLength > 1 && entity[0] == '#')
+        {
+            bool ok = false;
+            const auto codePoint = (entity[1] == 'x' || entity[1] == 'X')
+                ? QByteArray(entity + 2, entityLength - 2).toUInt(&ok, 16)
+                : QByteArray(entity + 1, entityLength - 1).toUInt(&ok, 10);
+            if (ok)
+                appendUtf8(codePoint, outText);
+            else
+                outText.append(ampersand, static_cast<int>(semicolon + 1 - ampersand));
+        }
+        else
+        {
+            // Unknown entity is kept as is
+            outText.append(ampersand, static_cast<int>(semicolon + 1 - ampersand));
+        }
+
+        pChar = semicolon + 1;
+    }
+}
+
+QString OsmAnd::GpxStreamReader_P::decodeText(const char* const begin, const char* const end)
+{
+    QByteArray text;
+    appendDecodedText(begin, end, text);
+    return QString::fromUtf8(text);
+}
+
+bool OsmAnd::GpxStreamReader_P::parseDouble(const char* const begin_, const char* const end_, double& outValue)
+{
+    // Exactly representable powers of 10
+    static const double powersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    auto begin = begin_;
+    auto end = end_;
+    trim(begin, end);
+    if (begin == end)
+        return false;
+
+    // Plain decimal with at most 15 significant digits converts exactly: integer mantissa is below 2^53,
+    // and division by exact power of 10 is correctly rounded. Anything else is left to Qt
+    auto pChar = begin;
+    const auto isNegative = (*pChar == '-');
+    if (*pChar == '-' || *pChar == '+')
+        pChar++;
+    int64_t mantissa = 0;
+    auto hasDigits = false;
+    auto digitsCount = 0;
+    auto fractionDigitsCount = 0;
+    auto hasPoint = false;
+    auto isPlainDecimal = true;
+    for (; pChar < end; pChar++)
+    {
+        const auto c = *pChar;
+        if (c >= '0' && c <= '9')
+        {
+            hasDigits = true;
+            if (mantissa != 0 || c != '0')
+                digitsCount++;
+            mantissa = mantissa * 10 + (c - '0');
+            if (hasPoint)
+                fractionDigitsCount++;
+            if (digitsCount > 15 || fractionDigitsCount > 22)
+            {
+                isPlainDecimal = false;
+                break;
+            }
+        }
+        else if (c == '.' && !hasPoint)
+        {
+            hasPoint = true;
+        }
+        else
+        {
+            isPlainDecimal = false;
+            break;
+        }
+    }
+    if (isPlainDecimal && hasDigits)
+    {
+        const auto value = static_cast<double>(mantissa) / powersOf10[fractionDigitsCount];
+        outValue = isNegative ? -value : value;
+        return true;
+    }
+
+    bool ok = false;
+    const auto value = QByteArray::fromRawData(begin, static_cast<int>(end - begin)).toDouble(&ok);
+    if (!ok)
+        return false;
+    outValue = value;
+    return true;
+}
+
+bool OsmAnd::GpxStreamReader_P::parseTimestamp(const char* const begin_, const char* const end_, int64_t& outValue)
+{
+    auto begin = begin_;
+    auto end = end_;
+    trim(begin, end);
+
+    // YYYY-MM-DDTHH:MM:SS
+    if (end - begin < 19 ||
+        begin[4] != '-' || begin[7] != '-' || (begin[10] != 'T' && begin[10] != 't') || begin[13] != ':' || begin[16] != ':')
+    {
+        return false;
+    }
+    int year, month, day, hour, minute, second;
+    if (!parseDigits(begin, 4, year) ||
+        !parseDigits(begin + 5, 2, month) ||
+        !parseDigits(begin + 8, 2, day) ||
+        !parseDigits(begin + 11, 2, hour) ||
+        !parseDigits(begin + 14, 2, minute) ||
+        !parseDigits(begin + 17, 2, second))
+    {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59)
+        return false;
+    auto pChar = begin + 19;
+
+    // Fraction of second, rounded to milliseconds
+    auto milliseconds = 0;
+    if (pChar < end && (*pChar == '.' || *pChar == ','))
+    {
+        pChar++;
+        auto fraction = 0.0;
+        auto scale = 0.1;
+        const auto fractionBegin = pChar;
+        while (pChar < end && *pChar >= '0' && *pChar <= '9')
+        {
+            fraction += (*pChar - '0') * scale;
+            scale /= 10.0;
+            pChar++;
+        }
+        if (pChar == fractionBegin)
+            return false;
+        milliseconds = qMin(qRound(fraction * 1000.0), 999);
+    }
+
+    // Only timestamps with explicit zone are handled here
+    auto offsetSeconds = 0;
+    if (pChar < end && (*pChar == 'Z' || *pChar == 'z'))
+    {
+        pChar++;
+    }
+    else if (pChar < end && (*pChar == '+' || *pChar == '-'))
+    {
+        const auto sign = (*pChar == '-') ? -1 : 1;
+        pChar++;
+        int offsetHours = 0;
+        int offsetMinutes = 0;
+        if (end - pChar < 2 || !parseDigits(pChar, 2, offsetHours))
+            return false;
+        pChar += 2;
+        if (pChar < end && *pChar == ':')
+            pChar++;
+        if (end - pChar >= 2)
+        {
+            if (!parseDigits(pChar, 2, offsetMinutes))
+                return false;
+            pChar += 2;
+        }
+        offsetSeconds = sign * (offsetHours * 3600 + offsetMinutes * 60);
+    }
+    else
+    {
+        return false;
+    }
+    if (pChar != end)
+        return false;
+
+    const auto days = getDaysFromCivil(year, month, day);
+    const auto seconds = days * 86400 + hour * 3600 + minute * 60 + second - offsetSeconds;
+    outValue = seconds * 1000 + milliseconds;
+    return true;
+}
+
+QString OsmAnd::GpxStreamReader_P::getVersion() const
+{
+    return _version;
+}
+
+QString OsmAnd::GpxStreamReader_P::getCreator() const
+{
+    return _creator;
+}
+
+bool OsmAnd::GpxStreamReader_P::hasSkippedContent() const
+{
+    return _hasSkippedContent;
+}
+
+uint64_t OsmAnd::GpxStreamReader_P::getBytesRead() const
+{
+    return _bytesRead;
+}
@@ -0,0 +1,122 @@
+#ifndef _OSMAND_CORE_GPX_STREAM_READER_P_H_
+#define _OSMAND_CORE_GPX_STREAM_READER_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QIODevice>
+
+#include "OsmAndCore.h"
+#include "PrivateImplementation.h"
+#include "GpxStreamReader.h"
+
+namespace OsmAnd
+{
+    class GpxStreamReader;
+    class GpxStreamReader_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(GpxStreamReader_P);
+    public:
+        typedef GpxStreamReader::TrackPointsBatch TrackPointsBatch;
+        typedef GpxStreamReader::TrackInfo TrackInfo;
+
+    private:
+        enum class Element : uint8_t
+        {
+            // Element that is not read, as well as anything inside it
+            Skipped,
+
+            Gpx,
+            Trk,
+            TrkSeg,
+            TrkPt,
+
+            // Elements with text content
+            Name,
+            Desc,
+            Cmt,
+            Type,
+            Ele,
+            Time,
+        };
+
+        enum class Markup
+        {
+            Incomplete,
+            StartTag,
+            EndTag,
+            CData,
+            Other,
+        };
+
+        // State of current read
+        QIODevice* _ioDevice;
+        bool _endOfInput;
+        QByteArray _buffer;
+        int _position;
+        uint64_t _bytesRead;
+        bool _stopped;
+        GpxStreamReader::TrackPointsBatchReady _batchReady;
+        GpxStreamReader::TrackFinished _trackFinished;
+
+        QVector<Element> _elements;
+        QByteArray _text;
+        TrackPointsBatch _batch;
+        TrackInfo _track;
+        int _tracksCount;
+        double _pointLatitude;
+        double _pointLongitude;
+        double _pointElevation;
+        int64_t _pointTimestamp;
+
+        // Results of last read
+        QString _version;
+        QString _creator;
+        bool _hasSkippedContent;
+
+        bool fillBuffer();
+        uint64_t getCurrentOffset() const;
+        Markup findMarkupEnd(const char* const begin, const char* const end, const char*& outMarkupEnd) const;
+        bool processStartTag(const char* const begin, const char* const end);
+        bool processEndTag();
+        void processText(const char* const begin, const char* const end);
+        bool flushBatch(const bool isLastInSegment);
+
+        Element identifyElement(const char* const localName, const int length) const;
+        bool isTextElement() const;
+
+        static bool getAttributeValue(
+            const char* const begin,
+            const char* const end,
+            const char* const name,
+            const char*& outValueBegin,
+            const char*& outValueEnd);
+        static void appendDecodedText(const char* const begin, const char* const end, QByteArray& outText);
+        static QString decodeText(const char* const begin, const char* const end);
+        static bool parseDouble(const char* const begin, const char* const end, double& outValue);
+        static bool parseTimestamp(const char* const begin, const char* const end, int64_t& outValue);
+    protected:
+        GpxStreamReader_P(GpxStreamReader* const owner);
+    public:
+        ~GpxStreamReader_P();
+
+        ImplementationInterface<GpxStreamReader> owner;
+
+        bool read(
+            QIODevice& ioDevice,
+            const GpxStreamReader::TrackPointsBatchReady batchReady,
+            const GpxStreamReader::TrackFinished trackFinished);
+
+        QString getVersion() const;
+        QString getCreator() const;
+        bool hasSkippedContent() const;
+        uint64_t getBytesRead() const;
+
+    friend class OsmAnd::GpxStreamReader;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_GPX_STREAM_READER_P_H_)
@@ -2,9 +2,22 @@
 
 #include "QtExtensions.h"
 #include "QtCommon.h"
+#include <QThread>
 
 #include "Common.h"
 #include "ILogSink.h"
+#include "AsyncLogQueue.h"
+
+namespace
+{
+    void logToSink(OsmAnd::ILogSink* const sink, const OsmAnd::LogSeverityLevel level, const char* format, ...)
+    {
+        va_list args;
+        va_start(args, format);
+        sink->log(level, format, args);
+        va_end(args);
+    }
+}
 
 OsmAnd::Logger::Logger()
     : _severifyLevelThreshold(
@@ -13,11 +26,57 @@ OsmAnd::Logger::Logger()
 #else
         static_cast<int>(LogSeverityLevel::Warning))
 #endif // OSMAND_DEBUG
+    , _isAsynchronous(0)
 {
 }
 
 OsmAnd::Logger::~Logger()
 {
+    _isAsynchronous.storeRelease(0);
+
+    // Threads that are logging right now may still hold the queue, so it's stopped only once they're done.
+    // Stopping background thread writes all queued messages
+    auto asyncQueue = std::atomic_exchange(&_asyncQueue, std::shared_ptr<AsyncLogQueue>());
+    while (asyncQueue && asyncQueue.use_count() > 1)
+        QThread::yieldCurrentThread();
+    asyncQueue.reset();
+}
+
+bool OsmAnd::Logger::isAsynchronous() const
+{
+    return _isAsynchronous.loadAcquire() != 0;
+}
+
+void OsmAnd::Logger::setAsynchronous(const bool asynchronous)
+{
+    QMutexLocker scopedLocker(&_asyncQueueMutex);
+
+    auto asyncQueue = std::atomic_load(&_asyncQueue);
+    if (asynchronous && !asyncQueue)
+    {
+        asyncQueue.reset(new AsyncLogQueue(
+            [this]
+            (const LogSeverityLevel level, const char* const message)
+            {
+                writeToSinks(level, message);
+            }));
+        std::atomic_store(&_asyncQueue, asyncQueue);
+    }
+    _isAsynchronous.storeRelease(asynchronous ? 1 : 0);
+
+    // Messages that were queued before switching to synchronous mode go first
+    if (!asynchronous && asyncQueue)
+        asyncQueue->drain();
+}
+
+OsmAnd::Logger::AsyncStatistics OsmAnd::Logger::getAsyncStatistics() const
+{
+    AsyncStatistics statistics;
+    const auto asyncQueue = std::atomic_load(&_asyncQueue);
+    statistics.enqueuedCount = asyncQueue ? asyncQueue->getEnqueuedCount() : 0;
+    statistics.droppedCount = asyncQueue ? asyncQueue->getDroppedCount() : 0;
+    statistics.truncatedCount = asyncQueue ? asyncQueue->getTruncatedCount() : 0;
+    return statistics;
 }
 
 OsmAnd::LogSeverityLevel OsmAnd::Logger::getSeverityLevelThreshold() const
@@ -68,6 +127,15 @@ void OsmAnd::Logger::log(const LogSeverityLevel level, const char* format, va_li
     if (static_cast<int>(level) < _severifyLevelThreshold.loadAcquire())
         return;
 
+    if (_isAsynchronous.loadAcquire())
+    {
+        if (const auto asyncQueue = std::atomic_load(&_asyncQueue))
+        {
+            asyncQueue->enqueue(level, format, args);
+            return;
+        }
+    }
+
     QReadLocker scopedLocker1(&_sinksLock);
     QMutexLocker scopedLocker2(&_logMutex); // To avoid mixing of lines
 
@@ -85,12 +153,52 @@ void OsmAnd::Logger::log(const LogSeverityLevel level, const char* format, ...)
 
 void OsmAnd::Logger::flush()
 {
+    if (const auto asyncQueue = std::atomic_load(&_asyncQueue))
+        asyncQueue->drain();
+
     QReadLocker scopedLocker(&_sinksLock);
 
     for(const auto& sink : constOf(_sinks))
         sink->flush();
 }
 
+void OsmAnd::Logger::flushOnCrash()
+{
+    // Crashed thread may hold any of locks, so sinks are used without them if they can't be taken in time
+    const auto sinksLocked = _sinksLock.tryLockForRead(CrashLockTimeoutMs);
+
+    if (const auto asyncQueue = std::atomic_load(&_asyncQueue))
+    {
+        asyncQueue->drainOnCrash(
+            [this]
+            (const LogSeverityLevel level, const char* const message)
+            {
+                writeToSinksUnlocked(level, message);
+            },
+            CrashLockTimeoutMs);
+    }
+
+    for(const auto& sink : constOf(_sinks))
+        sink->flush();
+
+    if (sinksLocked)
+        _sinksLock.unlock();
+}
+
+void OsmAnd::Logger::writeToSinks(const LogSeverityLevel level, const char* const message)
+{
+    QReadLocker scopedLocker1(&_sinksLock);
+    QMutexLocker scopedLocker2(&_logMutex);
+
+    writeToSinksUnlocked(level, message);
+}
+
+void OsmAnd::Logger::writeToSinksUnlocked(const LogSeverityLevel level, const char* const message)
+{
+    for(const auto& sink : constOf(_sinks))
+        logToSink(sink.get(), level, "%s", message);
+}
+
 const std::shared_ptr<OsmAnd::Logger>& OsmAnd::Logger::get()
 {
     static const std::shared_ptr<Logger> instance(new Logger());
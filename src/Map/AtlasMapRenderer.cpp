@@ -102,8 +102,14 @@ uint32_t OsmAnd::AtlasMapRenderer::getConfigurationChangeMask(
         current->referenceTileSizeOnScreenInPixels,
         updated->referenceTileSizeOnScreenInPixels);
 
+    const bool symbolsPlacementChanged =
+        (current->asynchronousSymbolsPlacement != updated->asynchronousSymbolsPlacement) ||
+        (current->asynchronousSymbolsPlacementMaxStaleness != updated->asynchronousSymbolsPlacementMaxStaleness);
+
     if (referenceTileSizeChanged)
         mask |= enumToBit(ConfigurationChange::ReferenceTileSize);
+    if (symbolsPlacementChanged)
+        mask |= enumToBit(ConfigurationChange::SymbolsPlacement);
 
     return mask;
 }
@@ -118,6 +124,10 @@ void OsmAnd::AtlasMapRenderer::validateConfigurationChange(const MapRenderer::Co
     if (invalidateSymbols)
         getResources().invalidateResourcesOfType(MapRendererResourceType::Symbols);
 
+    // Any configuration change may affect asynchronously computed symbols placement
+    if (_symbolsStage)
+        _symbolsStage->invalidateSymbolsPlacement();
+
     MapRenderer::validateConfigurationChange(static_cast<MapRenderer::ConfigurationChange>(change));
 }
 
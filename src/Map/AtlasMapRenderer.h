@@ -18,6 +18,7 @@ namespace OsmAnd
     class AtlasMapRendererMapLayersStage;
     class AtlasMapRendererSymbolsStage;
     class AtlasMapRendererDebugStage;
+    class AtlasMapRendererSymbolsPlacementWorker;
 
     class AtlasMapRenderer
         : public MapRenderer
@@ -36,6 +37,7 @@ namespace OsmAnd
         enum class ConfigurationChange
         {
             ReferenceTileSize = static_cast<int>(MapRenderer::ConfigurationChange::__LAST),
+            SymbolsPlacement,
 
             __LAST
         };
@@ -48,6 +50,7 @@ namespace OsmAnd
         virtual void validateConfigurationChange(const MapRenderer::ConfigurationChange& change);
 
         // State-related:
+        virtual MapRendererInternalState* createInternalState() const = 0;
         virtual bool updateInternalState(
             MapRendererInternalState& outInternalState,
             const MapRendererState& state,
@@ -88,6 +91,8 @@ namespace OsmAnd
         // Symbols-related
         virtual QList<MapSymbolInformation> getSymbolsAt(const PointI& screenPoint) const;
         virtual QList<MapSymbolInformation> getSymbolsIn(const AreaI& screenPoint, const bool strict = false) const;
+
+    friend class OsmAnd::AtlasMapRendererSymbolsPlacementWorker;
     };
 }
 
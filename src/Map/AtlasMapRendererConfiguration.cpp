@@ -4,6 +4,8 @@
 
 OsmAnd::AtlasMapRendererConfiguration::AtlasMapRendererConfiguration()
     : referenceTileSizeOnScreenInPixels(IAtlasMapRenderer::DefaultReferenceTileSizeOnScreenInPixels)
+    , asynchronousSymbolsPlacement(false)
+    , asynchronousSymbolsPlacementMaxStaleness(200)
 {
 }
 
@@ -16,6 +18,8 @@ void OsmAnd::AtlasMapRendererConfiguration::copyTo(MapRendererConfiguration& oth
     if (const auto other = dynamic_cast<AtlasMapRendererConfiguration*>(&other_))
     {
         other->referenceTileSizeOnScreenInPixels = referenceTileSizeOnScreenInPixels;
+        other->asynchronousSymbolsPlacement = asynchronousSymbolsPlacement;
+        other->asynchronousSymbolsPlacementMaxStaleness = asynchronousSymbolsPlacementMaxStaleness;
     }
 
     MapRendererConfiguration::copyTo(other_);
@@ -8,6 +8,17 @@ OsmAnd::AtlasMapRendererStage::AtlasMapRendererStage(AtlasMapRenderer* const ren
 {
 }
 
+OsmAnd::AtlasMapRendererStage::AtlasMapRendererStage(
+    AtlasMapRenderer* const renderer_,
+    const std::shared_ptr<const MapRendererConfiguration>& configuration_,
+    const MapRendererState& state_,
+    const MapRendererInternalState& internalState_,
+    const std::shared_ptr<const MapRendererDebugSettings>& debugSettings_)
+    : MapRendererStage(renderer_, configuration_, state_, internalState_, debugSettings_)
+    , AtlasMapRendererStageHelper(this)
+{
+}
+
 OsmAnd::AtlasMapRendererStage::~AtlasMapRendererStage()
 {
 }
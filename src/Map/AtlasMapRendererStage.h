@@ -26,6 +26,12 @@ namespace OsmAnd
         Q_DISABLE_COPY_AND_MOVE(AtlasMapRendererStage);
     private:
     protected:
+        AtlasMapRendererStage(
+            AtlasMapRenderer* const renderer,
+            const std::shared_ptr<const MapRendererConfiguration>& configuration,
+            const MapRendererState& state,
+            const MapRendererInternalState& internalState,
+            const std::shared_ptr<const MapRendererDebugSettings>& debugSettings);
     public:
         AtlasMapRendererStage(AtlasMapRenderer* const renderer);
         virtual ~AtlasMapRendererStage();
@@ -0,0 +1,181 @@
+#include "AtlasMapRendererSymbolsPlacementWorker.h"
+
+#include "ignore_warnings_on_external_includes.h"
+#include <QThread>
+#include "restore_internal_warnings.h"
+
+#include "AtlasMapRenderer.h"
+#include "AtlasMapRendererSymbolsStage.h"
+
+namespace OsmAnd
+{
+    // Symbols stage that is never rendered, only used to place symbols for snapshot of state
+    class AtlasMapRendererSymbolsPlacementStage Q_DECL_FINAL : public AtlasMapRendererSymbolsStage
+    {
+    public:
+        AtlasMapRendererSymbolsPlacementStage(
+            AtlasMapRenderer* const renderer,
+            const std::shared_ptr<const MapRendererConfiguration>& configuration,
+            const MapRendererState& state,
+            const MapRendererInternalState& internalState,
+            const std::shared_ptr<const MapRendererDebugSettings>& debugSettings)
+            : AtlasMapRendererSymbolsStage(renderer, configuration, state, internalState, debugSettings)
+        {
+        }
+
+        virtual ~AtlasMapRendererSymbolsPlacementStage()
+        {
+        }
+
+        virtual bool initialize()
+        {
+            return true;
+        }
+
+        virtual bool render(IMapRenderer_Metrics::Metric_renderFrame* const metric)
+        {
+            return false;
+        }
+
+        virtual bool release(const bool gpuContextLost)
+        {
+            return true;
+        }
+    };
+}
+
+OsmAnd::AtlasMapRendererSymbolsPlacementWorker::AtlasMapRendererSymbolsPlacementWorker(AtlasMapRenderer* const renderer_)
+    : _hasPendingRequest(false)
+    , _isAlive(false)
+    , _thread(new Concurrent::Thread(std::bind(&AtlasMapRendererSymbolsPlacementWorker::threadProcedure, this)))
+    , _internalState(renderer_->createInternalState())
+    , renderer(renderer_)
+{
+    _stage.reset(new AtlasMapRendererSymbolsPlacementStage(
+        renderer,
+        _configuration,
+        _state,
+        *_internalState,
+        _debugSettings));
+
+    // Start worker thread
+    _isAlive = true;
+    _thread->start();
+}
+
+OsmAnd::AtlasMapRendererSymbolsPlacementWorker::~AtlasMapRendererSymbolsPlacementWorker()
+{
+    // Stop worker thread
+    _isAlive = false;
+    {
+        QMutexLocker scopedLocker(&_mutex);
+        _wakeup.wakeAll();
+    }
+    REPEAT_UNTIL(_thread->wait());
+}
+
+void OsmAnd::AtlasMapRendererSymbolsPlacementWorker::requestPlacement(
+    const unsigned int requestId,
+    const MapRendererState& state,
+    const std::shared_ptr<const MapRendererConfiguration>& configuration,
+    const std::shared_ptr<const MapRendererDebugSettings>& debugSettings)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    // Previous request, if not yet taken, is not needed anymore
+    _pendingRequest.id = requestId;
+    _pendingRequest.time = std::chrono::high_resolution_clock::now();
+    _pendingRequest.state = state;
+    _pendingRequest.configuration = configuration;
+    _pendingRequest.debugSettings = debugSettings;
+    _hasPendingRequest = true;
+
+    _wakeup.wakeAll();
+}
+
+std::shared_ptr<const OsmAnd::AtlasMapRendererSymbolsPlacementWorker::Placement>
+OsmAnd::AtlasMapRendererSymbolsPlacementWorker::getLastPlacement() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _lastPlacement;
+}
+
+void OsmAnd::AtlasMapRendererSymbolsPlacementWorker::threadProcedure()
+{
+    while (_isAlive)
+    {
+        Request request;
+
+        // Wait until there's something to place
+        {
+            QMutexLocker scopedLocker(&_mutex);
+            while (_isAlive && !_hasPendingRequest)
+                REPEAT_UNTIL(_wakeup.wait(&_mutex));
+            if (!_isAlive)
+                break;
+
+            request = qMove(_pendingRequest);
+            _pendingRequest = Request();
+            _hasPendingRequest = false;
+        }
+
+        const auto placement = computePlacement(request);
+        if (!placement)
+            continue;
+
+        {
+            QMutexLocker scopedLocker(&_mutex);
+            _lastPlacement = placement;
+        }
+
+        // Let render thread pick up new placement
+        _stage->invalidateFrame();
+    }
+}
+
+std::shared_ptr<const OsmAnd::AtlasMapRendererSymbolsPlacementWorker::Placement>
+OsmAnd::AtlasMapRendererSymbolsPlacementWorker::computePlacement(const Request& request)
+{
+    // Bind placement stage to requested state
+    _state = request.state;
+    _configuration = request.configuration;
+    if (!renderer->updateInternalState(*_internalState, _state, *_configuration))
+        return nullptr;
+
+    // Debug visualization is owned by render thread, so worker never draws it
+    const auto debugSettings = request.debugSettings->createCopy();
+    debugSettings->showSymbolsBBoxesAcceptedByIntersectionCheck = false;
+    debugSettings->showSymbolsBBoxesRejectedByIntersectionCheck = false;
+    debugSettings->showSymbolsBBoxesRejectedByMinDistanceToSameContentFromOtherSymbolCheck = false;
+    debugSettings->showSymbolsCheckBBoxesRejectedByMinDistanceToSameContentFromOtherSymbolCheck = false;
+    debugSettings->showSymbolsBBoxesRejectedByPresentationMode = false;
+    debugSettings->showOnPathSymbolsRenderablesPaths = false;
+    debugSettings->showOnPath2dSymbolGlyphDetails = false;
+    debugSettings->showOnPath3dSymbolGlyphDetails = false;
+    debugSettings->showTooShortOnPathSymbolsRenderablesPaths = false;
+    debugSettings->showAllPaths = false;
+    _debugSettings = debugSettings;
+
+    const std::shared_ptr<Placement> placement(new Placement());
+    placement->requestId = request.id;
+    placement->requestTime = request.time;
+
+    QList< std::shared_ptr<const AtlasMapRendererSymbolsStage::RenderableSymbol> > renderableSymbols;
+    AtlasMapRendererSymbolsStage::ScreenQuadTree intersections;
+    {
+        QReadLocker scopedLocker(&_stage->publishedMapSymbolsByOrderLock);
+
+        if (!_stage->obtainRenderableSymbols(
+            _stage->publishedMapSymbolsByOrder,
+            renderableSymbols,
+            intersections,
+            &placement->acceptedMapSymbolsByOrder,
+            nullptr))
+        {
+            return nullptr;
+        }
+    }
+
+    return placement;
+}
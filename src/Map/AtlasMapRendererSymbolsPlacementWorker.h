@@ -0,0 +1,84 @@
+#ifndef _OSMAND_CORE_ATLAS_MAP_RENDERER_SYMBOLS_PLACEMENT_WORKER_H_
+#define _OSMAND_CORE_ATLAS_MAP_RENDERER_SYMBOLS_PLACEMENT_WORKER_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QMutex>
+#include <QWaitCondition>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "MapRenderer.h"
+#include "MapRendererState.h"
+#include "MapRendererInternalState.h"
+#include "MapRendererConfiguration.h"
+#include "MapRendererDebugSettings.h"
+#include "Thread.h"
+
+namespace OsmAnd
+{
+    class AtlasMapRenderer;
+    class AtlasMapRendererSymbolsStage;
+
+    // Computes placement of symbols (set of symbols that passed intersection checks) for requested state
+    // on own thread. Requests are not queued: only the latest one is processed once worker is free
+    class AtlasMapRendererSymbolsPlacementWorker Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(AtlasMapRendererSymbolsPlacementWorker);
+
+    public:
+        struct Placement
+        {
+            MapRenderer::PublishedMapSymbolsByOrder acceptedMapSymbolsByOrder;
+            unsigned int requestId;
+            std::chrono::high_resolution_clock::time_point requestTime;
+        };
+
+    private:
+        struct Request
+        {
+            unsigned int id;
+            std::chrono::high_resolution_clock::time_point time;
+            MapRendererState state;
+            std::shared_ptr<const MapRendererConfiguration> configuration;
+            std::shared_ptr<const MapRendererDebugSettings> debugSettings;
+        };
+
+        mutable QMutex _mutex;
+        QWaitCondition _wakeup;
+        bool _hasPendingRequest;
+        Request _pendingRequest;
+        std::shared_ptr<const Placement> _lastPlacement;
+
+        volatile bool _isAlive;
+        const std::unique_ptr<Concurrent::Thread> _thread;
+        void threadProcedure();
+
+        // Snapshot of renderer state that placement stage is bound to. Touched only by worker thread
+        MapRendererState _state;
+        const std::unique_ptr<MapRendererInternalState> _internalState;
+        std::shared_ptr<const MapRendererConfiguration> _configuration;
+        std::shared_ptr<const MapRendererDebugSettings> _debugSettings;
+        std::unique_ptr<AtlasMapRendererSymbolsStage> _stage;
+
+        std::shared_ptr<const Placement> computePlacement(const Request& request);
+    protected:
+    public:
+        AtlasMapRendererSymbolsPlacementWorker(AtlasMapRenderer* const renderer);
+        ~AtlasMapRendererSymbolsPlacementWorker();
+
+        AtlasMapRenderer* const renderer;
+
+        void requestPlacement(
+            const unsigned int requestId,
+            const MapRendererState& state,
+            const std::shared_ptr<const MapRendererConfiguration>& configuration,
+            const std::shared_ptr<const MapRendererDebugSettings>& debugSettings);
+        std::shared_ptr<const Placement> getLastPlacement() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ATLAS_MAP_RENDERER_SYMBOLS_PLACEMENT_WORKER_H_)
@@ -21,6 +21,7 @@
 #include "AtlasMapRenderer.h"
 #include "AtlasMapRenderer_Metrics.h"
 #include "AtlasMapRendererDebugStage.h"
+#include "AtlasMapRendererSymbolsPlacementWorker.h"
 #include "MapSymbol.h"
 #include "VectorMapSymbol.h"
 #include "BillboardVectorMapSymbol.h"
@@ -36,6 +37,24 @@
 
 OsmAnd::AtlasMapRendererSymbolsStage::AtlasMapRendererSymbolsStage(AtlasMapRenderer* const renderer_)
     : AtlasMapRendererStage(renderer_)
+    , _placementOnly(false)
+    , _symbolsPlacementInvalidated(false)
+    , _lastPlacementRequestId(0)
+    , _lastPlacementRequestSymbolsVersion(0)
+{
+}
+
+OsmAnd::AtlasMapRendererSymbolsStage::AtlasMapRendererSymbolsStage(
+    AtlasMapRenderer* const renderer_,
+    const std::shared_ptr<const MapRendererConfiguration>& configuration_,
+    const MapRendererState& state_,
+    const MapRendererInternalState& internalState_,
+    const std::shared_ptr<const MapRendererDebugSettings>& debugSettings_)
+    : AtlasMapRendererStage(renderer_, configuration_, state_, internalState_, debugSettings_)
+    , _placementOnly(true)
+    , _symbolsPlacementInvalidated(false)
+    , _lastPlacementRequestId(0)
+    , _lastPlacementRequestSymbolsVersion(0)
 {
 }
 
@@ -48,7 +67,18 @@ void OsmAnd::AtlasMapRendererSymbolsStage::prepare(AtlasMapRenderer_Metrics::Met
     Stopwatch stopwatch(metric != nullptr);
 
     ScreenQuadTree intersections;
-    if (!obtainRenderableSymbols(renderableSymbols, intersections, metric))
+    bool ok;
+    if (getCurrentConfiguration().asynchronousSymbolsPlacement)
+    {
+        ok = obtainRenderableSymbolsAsynchronously(renderableSymbols, intersections, metric);
+    }
+    else
+    {
+        if (_placementWorker)
+            releaseSymbolsPlacementWorker();
+        ok = obtainRenderableSymbols(renderableSymbols, intersections, metric);
+    }
+    if (!ok)
     {
         // In case obtain failed due to lock, schedule another frame
         invalidateFrame();
@@ -158,6 +188,90 @@ void OsmAnd::AtlasMapRendererSymbolsStage::queryLastVisibleSymbolsIn(
     convertRenderableSymbolsToMapSymbolInformation(selectedRenderables, outMapSymbols);
 }
 
+void OsmAnd::AtlasMapRendererSymbolsStage::releaseSymbolsPlacementWorker()
+{
+    _placementWorker.reset();
+    _lastPlacementRequestId = 0;
+}
+
+void OsmAnd::AtlasMapRendererSymbolsStage::invalidateSymbolsPlacement()
+{
+    _symbolsPlacementInvalidated = true;
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderableSymbolsAsynchronously(
+    QList< std::shared_ptr<const RenderableSymbol> >& outRenderableSymbols,
+    ScreenQuadTree& outIntersections,
+    AtlasMapRenderer_Metrics::Metric_renderFrame* const metric)
+{
+    // While symbols update is suspended, last accepted symbols are used as-is
+    if (renderer->isSymbolsUpdateSuspended())
+        return obtainRenderableSymbols(outRenderableSymbols, outIntersections, metric);
+
+    if (!_placementWorker)
+        _placementWorker.reset(new AtlasMapRendererSymbolsPlacementWorker(getRenderer()));
+
+    // Request placement for current state, unless it was already requested. Worker gets own copies
+    // of configuration and debug settings, since these are updated in-place
+    const auto publishedMapSymbolsVersion = getPublishedMapSymbolsVersion();
+    if (_lastPlacementRequestId == 0 ||
+        _symbolsPlacementInvalidated ||
+        _lastPlacementRequestSymbolsVersion != publishedMapSymbolsVersion ||
+        isSymbolsPlacementAffected(_lastPlacementRequestState, currentState))
+    {
+        _lastPlacementRequestId++;
+        _lastPlacementRequestSymbolsVersion = publishedMapSymbolsVersion;
+        _lastPlacementRequestState = currentState;
+        _symbolsPlacementInvalidated = false;
+
+        _placementWorker->requestPlacement(
+            _lastPlacementRequestId,
+            currentState,
+            currentConfiguration->createCopy(),
+            debugSettings->createCopy());
+    }
+
+    // Placement computed for previous request is outdated since the moment it was requested
+    const auto placement = _placementWorker->getLastPlacement();
+    float placementAge = 0.0f;
+    if (placement && placement->requestId != _lastPlacementRequestId)
+    {
+        placementAge = std::chrono::duration<float>(
+            std::chrono::high_resolution_clock::now() - placement->requestTime).count();
+    }
+    const auto maxPlacementAge = getCurrentConfiguration().asynchronousSymbolsPlacementMaxStaleness / 1000.0f;
+    if (!placement || placementAge > maxPlacementAge)
+        return obtainRenderableSymbols(outRenderableSymbols, outIntersections, metric);
+
+    if (metric)
+        metric->symbolsPlacementAge = placementAge;
+
+    // Only accepted symbols are plotted for current state, so this is cheap compared to full placement
+    _lastAcceptedMapSymbolsByOrder.clear();
+    return obtainRenderableSymbols(
+        placement->acceptedMapSymbolsByOrder,
+        outRenderableSymbols,
+        outIntersections,
+        &_lastAcceptedMapSymbolsByOrder,
+        metric);
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage::isSymbolsPlacementAffected(
+    const MapRendererState& state,
+    const MapRendererState& otherState)
+{
+    return
+        state.windowSize != otherState.windowSize ||
+        state.viewport != otherState.viewport ||
+        state.fieldOfView != otherState.fieldOfView ||
+        state.azimuth != otherState.azimuth ||
+        state.elevationAngle != otherState.elevationAngle ||
+        state.target31 != otherState.target31 ||
+        state.zoomLevel != otherState.zoomLevel ||
+        state.visualZoom != otherState.visualZoom ||
+        state.visualZoomShift != otherState.visualZoomShift;
+}
+
 //#define OSMAND_KEEP_DISCARDED_SYMBOLS_IN_QUAD_TREE 1
 #ifndef OSMAND_KEEP_DISCARDED_SYMBOLS_IN_QUAD_TREE
 #   define OSMAND_KEEP_DISCARDED_SYMBOLS_IN_QUAD_TREE 0
@@ -832,8 +946,8 @@ void OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderablesFromBillboardSymbol(
     //////////////////////////////////////////////////////////////////////////
 
     // Get GPU resource
-    const auto gpuResource = captureGpuResource(referenceOrigins, mapSymbol);
-    if (!gpuResource)
+    std::shared_ptr<const GPUAPI::ResourceInGPU> gpuResource;
+    if (!obtainGpuResource(referenceOrigins, mapSymbol, gpuResource))
         return;
 
     std::shared_ptr<RenderableBillboardSymbol> renderable(new RenderableBillboardSymbol());
@@ -965,16 +1079,12 @@ void OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderablesFromOnSurfaceSymbol(
     }
 
     // Get GPU resource
-    const auto gpuResource = captureGpuResource(referenceOrigins, mapSymbol);
-    if (!gpuResource)
+    std::shared_ptr<const GPUAPI::ResourceInGPU> gpuResource;
+    if (!obtainGpuResource(referenceOrigins, mapSymbol, gpuResource))
         return;
 
-    if (const auto& gpuMeshResource = std::dynamic_pointer_cast<const GPUAPI::MeshInGPU>(gpuResource))
-    {
-        if (gpuMeshResource->position31 != nullptr)
-            position31 = PointI(gpuMeshResource->position31->x, gpuMeshResource->position31->y);
-    }
-    
+    obtainMeshPosition31(mapSymbol, gpuResource, position31);
+
     std::shared_ptr<RenderableOnSurfaceSymbol> renderable(new RenderableOnSurfaceSymbol());
     renderable->mapSymbolGroup = mapSymbolGroup;
     renderable->mapSymbol = mapSymbol;
@@ -1097,8 +1207,10 @@ void OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderablesFromOnPathSymbol(
     ////////////////////////////////////////////////////////////////////////////
 
     // Get GPU resource for this map symbol, since it's useless to perform any calculations unless it's possible to draw it
-    const auto gpuResource = std::dynamic_pointer_cast<const GPUAPI::TextureInGPU>(captureGpuResource(referenceOrigins, onPathMapSymbol));
-    if (!gpuResource)
+    std::shared_ptr<const GPUAPI::ResourceInGPU> gpuResource;
+    if (!obtainGpuResource(referenceOrigins, onPathMapSymbol, gpuResource))
+        return;
+    if (gpuResource && !std::dynamic_pointer_cast<const GPUAPI::TextureInGPU>(gpuResource))
         return;
 
     // Processing pin-point needs path in world and path on screen, as well as lengths of all segments. This may have already been computed
@@ -1499,7 +1611,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::applyIntersectionWithOtherSymbolsFilt
 
     const auto& symbol = renderable->mapSymbol;
 
-    if (symbol->intersectsWithClasses.isEmpty())
+    if (symbol->intersectsWithClasses.none())
         return true;
 
     Stopwatch stopwatch(metric != nullptr);
@@ -1508,15 +1620,24 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::applyIntersectionWithOtherSymbolsFilt
     const auto checkIntersectionsWithinGroup = renderable->mapSymbolGroup->intersectionProcessingMode.isSet(
         MapSymbolsGroup::IntersectionProcessingModeFlag::CheckIntersectionsWithinGroup);
     const auto& intersectionClassesRegistry = MapSymbolIntersectionClassesRegistry::globalInstance();
-    const auto& symbolIntersectsWithClasses = symbol->intersectsWithClasses;
     const auto anyIntersectionClass = intersectionClassesRegistry.anyClass;
-    const auto symbolIntersectsWithAnyClass = symbolIntersectsWithClasses.contains(intersectionClassesRegistry.anyClass);
+
+    // Other symbol intersects tested one if it shares at least one class from this mask:
+    //  - tested symbol with 'any' class intersects every other symbol that has at least 1 class;
+    //  - other symbol with 'any' class intersects tested symbol (which has at least 1 class already);
+    //  - otherwise, symbols intersect if they have common classes.
+    MapSymbolIntersectionClassesSet intersectionClassesMask;
+    if (symbol->intersectsWithClasses.test(anyIntersectionClass))
+        intersectionClassesMask.set();
+    else
+        intersectionClassesMask = symbol->intersectsWithClasses;
+    intersectionClassesMask.set(anyIntersectionClass);
     const auto symbolGroupPtr = symbol->groupPtr;
     const auto symbolGroupInstancePtr = renderable->genericInstanceParameters
         ? renderable->genericInstanceParameters->groupInstancePtr
         : nullptr;
     const auto intersects = intersections.test(renderable->intersectionBBox, false,
-        [symbolGroupPtr, symbolIntersectsWithClasses, symbolIntersectsWithAnyClass, anyIntersectionClass, symbolGroupInstancePtr, checkIntersectionsWithinGroup]
+        [symbolGroupPtr, &intersectionClassesMask, symbolGroupInstancePtr, checkIntersectionsWithinGroup]
         (const std::shared_ptr<const RenderableSymbol>& otherRenderable, const ScreenQuadTree::BBox& otherBBox) -> bool
         {
             const auto& otherSymbol = otherRenderable->mapSymbol;
@@ -1531,18 +1652,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::applyIntersectionWithOtherSymbolsFilt
                     return false;
             }
 
-            // Special case: tested symbol intersects any other symbol with at least 1 any class
-            if (symbolIntersectsWithAnyClass && !otherSymbol->intersectsWithClasses.isEmpty())
-                return true;
-
-            // Special case: other symbol intersects tested symbol with at least 1 any class (which is true already)
-            if (otherSymbol->intersectsWithClasses.contains(anyIntersectionClass))
-                return true;
-
-            // General case:
-            const auto commonIntersectionClasses = symbolIntersectsWithClasses & otherSymbol->intersectsWithClasses;
-            const auto hasCommonIntersectionClasses = !commonIntersectionClasses.isEmpty();
-            return hasCommonIntersectionClasses;
+            return (intersectionClassesMask & otherSymbol->intersectsWithClasses).any();
         });
 
     if (metric)
@@ -1638,7 +1748,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::addToIntersections(
     if (Q_UNLIKELY(debugSettings->allSymbolsTransparentForIntersectionLookup))
         return true;
 
-    if (renderable->mapSymbol->intersectsWithClasses.isEmpty())
+    if (renderable->mapSymbol->intersectsWithClasses.none())
         return true;
     
     Stopwatch stopwatch(metric != nullptr);
@@ -1753,6 +1863,63 @@ std::shared_ptr<const OsmAnd::GPUAPI::ResourceInGPU> OsmAnd::AtlasMapRendererSym
     return nullptr;
 }
 
+bool OsmAnd::AtlasMapRendererSymbolsStage::hasGpuResource(const MapRenderer::MapSymbolReferenceOrigins& resources)
+{
+    // Resource state is only inspected, since capturing it would interfere with render thread
+    for (auto& resource : constOf(resources))
+    {
+        const auto state = resource->getState();
+        if (state == MapRendererResourceState::Uploaded ||
+            state == MapRendererResourceState::IsBeingUsed ||
+            resource->isRenewing())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage::obtainGpuResource(
+    const MapRenderer::MapSymbolReferenceOrigins& resources,
+    const std::shared_ptr<const MapSymbol>& mapSymbol,
+    std::shared_ptr<const GPUAPI::ResourceInGPU>& outGpuResource) const
+{
+    // Placement-only stage never draws, so it's enough to know that symbol can be drawn
+    if (_placementOnly)
+        return hasGpuResource(resources);
+
+    outGpuResource = captureGpuResource(resources, mapSymbol);
+    return (outGpuResource != nullptr);
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage::obtainMeshPosition31(
+    const std::shared_ptr<const MapSymbol>& mapSymbol,
+    const std::shared_ptr<const GPUAPI::ResourceInGPU>& gpuResource,
+    PointI& outPosition31) const
+{
+    // Placement-only stage has no GPU resource, but mesh takes its position from vertices of the symbol
+    // when it's uploaded, so the same position is used for placement as for drawing
+    if (_placementOnly)
+    {
+        const auto vectorMapSymbol = std::dynamic_pointer_cast<const VectorMapSymbol>(mapSymbol);
+        if (!vectorMapSymbol)
+            return false;
+        const auto verticesAndIndexes = vectorMapSymbol->getVerticesAndIndexes();
+        if (!verticesAndIndexes || !verticesAndIndexes->position31)
+            return false;
+
+        outPosition31 = *verticesAndIndexes->position31;
+        return true;
+    }
+
+    const auto gpuMeshResource = std::dynamic_pointer_cast<const GPUAPI::MeshInGPU>(gpuResource);
+    if (!gpuMeshResource || !gpuMeshResource->position31)
+        return false;
+
+    outPosition31 = *gpuMeshResource->position31;
+    return true;
+}
+
 QVector<float> OsmAnd::AtlasMapRendererSymbolsStage::computePathSegmentsLengths(const QVector<glm::vec2>& path)
 {
     const auto segmentsCount = path.size() - 1;
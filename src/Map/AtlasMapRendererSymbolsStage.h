@@ -25,6 +25,7 @@ namespace OsmAnd
     class OnPathRasterMapSymbol;
     class IOnSurfaceMapSymbol;
     class IBillboardMapSymbol;
+    class AtlasMapRendererSymbolsPlacementWorker;
 
     class AtlasMapRendererSymbolsStage : public AtlasMapRendererStage
     {
@@ -108,6 +109,9 @@ namespace OsmAnd
             QVector< GlyphPlacement > glyphsPlacement;
         };
     private:
+        // Stage that only places symbols for snapshot of state, off the render thread
+        const bool _placementOnly;
+
         bool obtainRenderableSymbols(
             QList< std::shared_ptr<const RenderableSymbol> >& outRenderableSymbols,
             ScreenQuadTree& outIntersections,
@@ -120,6 +124,19 @@ namespace OsmAnd
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         mutable MapRenderer::PublishedMapSymbolsByOrder _lastAcceptedMapSymbolsByOrder;
 
+        // Asynchronous placement: worker places all published symbols for last requested state,
+        // while render thread only re-plots symbols accepted by last completed placement
+        std::unique_ptr<AtlasMapRendererSymbolsPlacementWorker> _placementWorker;
+        bool _symbolsPlacementInvalidated;
+        unsigned int _lastPlacementRequestId;
+        unsigned int _lastPlacementRequestSymbolsVersion;
+        MapRendererState _lastPlacementRequestState;
+        bool obtainRenderableSymbolsAsynchronously(
+            QList< std::shared_ptr<const RenderableSymbol> >& outRenderableSymbols,
+            ScreenQuadTree& outIntersections,
+            AtlasMapRenderer_Metrics::Metric_renderFrame* const metric);
+        static bool isSymbolsPlacementAffected(const MapRendererState& state, const MapRendererState& otherState);
+
         mutable QReadWriteLock _lastPreparedIntersectionsLock;
         ScreenQuadTree _lastPreparedIntersections;
 
@@ -242,6 +259,15 @@ namespace OsmAnd
         static std::shared_ptr<const GPUAPI::ResourceInGPU> captureGpuResource(
             const MapRenderer::MapSymbolReferenceOrigins& resources,
             const std::shared_ptr<const MapSymbol>& mapSymbol);
+        static bool hasGpuResource(const MapRenderer::MapSymbolReferenceOrigins& resources);
+        bool obtainGpuResource(
+            const MapRenderer::MapSymbolReferenceOrigins& resources,
+            const std::shared_ptr<const MapSymbol>& mapSymbol,
+            std::shared_ptr<const GPUAPI::ResourceInGPU>& outGpuResource) const;
+        bool obtainMeshPosition31(
+            const std::shared_ptr<const MapSymbol>& mapSymbol,
+            const std::shared_ptr<const GPUAPI::ResourceInGPU>& gpuResource,
+            PointI& outPosition31) const;
 
         static QVector<float> computePathSegmentsLengths(const QVector<glm::vec2>& path);
 
@@ -322,10 +348,21 @@ namespace OsmAnd
         QList< std::shared_ptr<const RenderableSymbol> > renderableSymbols;
 
         void prepare(AtlasMapRenderer_Metrics::Metric_renderFrame* const metric);
+        void releaseSymbolsPlacementWorker();
+
+        // Placement-only stage, bound to given snapshot of state
+        AtlasMapRendererSymbolsStage(
+            AtlasMapRenderer* const renderer,
+            const std::shared_ptr<const MapRendererConfiguration>& configuration,
+            const MapRendererState& state,
+            const MapRendererInternalState& internalState,
+            const std::shared_ptr<const MapRendererDebugSettings>& debugSettings);
     public:
         AtlasMapRendererSymbolsStage(AtlasMapRenderer* const renderer);
         virtual ~AtlasMapRendererSymbolsStage();
 
+        void invalidateSymbolsPlacement();
+
         void queryLastPreparedSymbolsAt(
             const PointI screenPoint,
             QList<IMapRenderer::MapSymbolInformation>& outMapSymbols) const;
@@ -340,6 +377,8 @@ namespace OsmAnd
             const AreaI screenArea,
             QList<IMapRenderer::MapSymbolInformation>& outMapSymbols,
             const bool strict = false) const;
+
+    friend class OsmAnd::AtlasMapRendererSymbolsPlacementWorker;
     };
 }
 
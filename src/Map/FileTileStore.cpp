@@ -0,0 +1,142 @@
+#include "FileTileStore.h"
+
+#include "QtExtensions.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QDateTime>
+
+#include "Logging.h"
+
+OsmAnd::FileTileStore::FileTileStore(
+    const QString& path_,
+    const int64_t expiryPeriod_ /*= NeverExpires*/)
+    : path(path_)
+    , expiryPeriod(expiryPeriod_)
+{
+}
+
+OsmAnd::FileTileStore::~FileTileStore()
+{
+}
+
+QString OsmAnd::FileTileStore::getTileFilename(const TileId tileId, const ZoomLevel zoom) const
+{
+    return QDir(path).absoluteFilePath(getTileRelativePath(tileId, zoom));
+}
+
+bool OsmAnd::FileTileStore::obtainTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    QByteArray& outData,
+    bool* const pOutExpired /*= nullptr*/)
+{
+    const QFileInfo tileFileInfo(getTileFilename(tileId, zoom));
+    if (!tileFileInfo.exists())
+        return false;
+
+    if (pOutExpired)
+    {
+        *pOutExpired = expiryPeriod != NeverExpires &&
+            tileFileInfo.lastModified().secsTo(QDateTime::currentDateTime()) >= expiryPeriod;
+    }
+
+    // Empty file means that tile does not exist, no need to open it
+    if (tileFileInfo.size() == 0)
+    {
+        outData.clear();
+        return true;
+    }
+
+    QFile tileFile(tileFileInfo.absoluteFilePath());
+    if (!tileFile.open(QIODevice::ReadOnly))
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to open tile file '%s'",
+            qPrintable(tileFileInfo.absoluteFilePath()));
+        return false;
+    }
+    outData = tileFile.readAll();
+    tileFile.close();
+
+    return true;
+}
+
+bool OsmAnd::FileTileStore::containsTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    bool* const pOutExpired /*= nullptr*/) const
+{
+    const QFileInfo tileFileInfo(getTileFilename(tileId, zoom));
+    if (!tileFileInfo.exists())
+        return false;
+
+    if (pOutExpired)
+    {
+        *pOutExpired = expiryPeriod != NeverExpires &&
+            tileFileInfo.lastModified().secsTo(QDateTime::currentDateTime()) >= expiryPeriod;
+    }
+
+    return true;
+}
+
+bool OsmAnd::FileTileStore::storeTile(const TileId tileId, const ZoomLevel zoom, const QByteArray& data)
+{
+    const QFileInfo tileFileInfo(getTileFilename(tileId, zoom));
+
+    // Ensure that all directories are created in path to tile
+    tileFileInfo.dir().mkpath(QLatin1String("."));
+
+    QFile tileFile(tileFileInfo.absoluteFilePath());
+    if (!tileFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to save tile to '%s'",
+            qPrintable(tileFileInfo.absoluteFilePath()));
+        return false;
+    }
+    const auto written = tileFile.write(data);
+    tileFile.close();
+
+    if (written != data.size())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to write tile to '%s'",
+            qPrintable(tileFileInfo.absoluteFilePath()));
+        tileFile.remove();
+        return false;
+    }
+
+    return true;
+}
+
+bool OsmAnd::FileTileStore::removeTile(const TileId tileId, const ZoomLevel zoom)
+{
+    QFile tileFile(getTileFilename(tileId, zoom));
+    if (!tileFile.exists())
+        return false;
+
+    return tileFile.remove();
+}
+
+uint64_t OsmAnd::FileTileStore::getTotalSize() const
+{
+    uint64_t totalSize = 0;
+    QDirIterator it(path, QStringList() << QLatin1String("*.tile"), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        it.next();
+        totalSize += it.fileInfo().size();
+    }
+
+    return totalSize;
+}
+
+QString OsmAnd::FileTileStore::getTileRelativePath(const TileId tileId, const ZoomLevel zoom)
+{
+    return
+        QString::number(zoom) + QDir::separator() +
+        QString::number(tileId.x) + QDir::separator() +
+        QString::number(tileId.y) + QLatin1String(".tile");
+}
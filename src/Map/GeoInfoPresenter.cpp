@@ -2,6 +2,7 @@
 #include "GeoInfoPresenter_P.h"
 
 #include "Utilities.h"
+#include "Logging.h"
 
 OsmAnd::GeoInfoPresenter::GeoInfoPresenter(
     const QList< std::shared_ptr<const GeoInfoDocument> >& documents_)
@@ -10,6 +11,15 @@ OsmAnd::GeoInfoPresenter::GeoInfoPresenter(
 {
 }
 
+OsmAnd::GeoInfoPresenter::GeoInfoPresenter(
+    const QList< std::shared_ptr<const GeoInfoDocument> >& documents_,
+    const QList< std::shared_ptr<const ColumnarTracksFile> >& tracksFiles_)
+    : _p(new GeoInfoPresenter_P(this))
+    , documents(documents_)
+    , tracksFiles(tracksFiles_)
+{
+}
+
 OsmAnd::GeoInfoPresenter::~GeoInfoPresenter()
 {
 }
@@ -148,6 +158,27 @@ OsmAnd::GeoInfoPresenter::MapObject::MapObject(
     const std::shared_ptr<const GeoInfoDocument>& geoInfoDocument_,
     const std::shared_ptr<const GeoInfoDocument::ExtraData>& extraData /*= nullptr*/)
     : geoInfoDocument(geoInfoDocument_)
+{
+    addDocumentAttributes(
+        extraData,
+        !geoInfoDocument->locationMarks.isEmpty(),
+        !geoInfoDocument->tracks.isEmpty(),
+        !geoInfoDocument->routes.isEmpty());
+}
+
+OsmAnd::GeoInfoPresenter::MapObject::MapObject(
+    const bool hasWaypoints,
+    const bool hasTrackpoints,
+    const bool hasRoutepoints)
+{
+    addDocumentAttributes(nullptr, hasWaypoints, hasTrackpoints, hasRoutepoints);
+}
+
+void OsmAnd::GeoInfoPresenter::MapObject::addDocumentAttributes(
+    const std::shared_ptr<const GeoInfoDocument::ExtraData>& extraData,
+    const bool hasWaypoints,
+    const bool hasTrackpoints,
+    const bool hasRoutepoints)
 {
     const auto mapping = std::make_shared<AttributeMapping>();
     attributeMapping = mapping;
@@ -178,17 +209,17 @@ OsmAnd::GeoInfoPresenter::MapObject::MapObject(
 
     mapping->verifyRequiredMappingRegistered();
 
-    additionalAttributeIds.append(geoInfoDocument->locationMarks.isEmpty()
-        ? mapping->waypointsNotPresentAttributeId
-        : mapping->waypointsPresentAttributeId);
+    additionalAttributeIds.append(hasWaypoints
+        ? mapping->waypointsPresentAttributeId
+        : mapping->waypointsNotPresentAttributeId);
 
-    additionalAttributeIds.append(geoInfoDocument->tracks.isEmpty()
-        ? mapping->trackpointsNotPresentAttributeId
-        : mapping->trackpointsPresentAttributeId);
+    additionalAttributeIds.append(hasTrackpoints
+        ? mapping->trackpointsPresentAttributeId
+        : mapping->trackpointsNotPresentAttributeId);
 
-    additionalAttributeIds.append(geoInfoDocument->routes.isEmpty()
-        ? mapping->routepointsNotPresentAttributeId
-        : mapping->routepointsPresentAttributeId);
+    additionalAttributeIds.append(hasRoutepoints
+        ? mapping->routepointsPresentAttributeId
+        : mapping->routepointsNotPresentAttributeId);
 }
 
 OsmAnd::GeoInfoPresenter::MapObject::~MapObject()
@@ -272,6 +303,46 @@ OsmAnd::GeoInfoPresenter::TracklineMapObject::~TracklineMapObject()
 {
 }
 
+OsmAnd::GeoInfoPresenter::ColumnarTracklineMapObject::ColumnarTracklineMapObject(
+    const std::shared_ptr<const ColumnarTracksFile>& tracksFile_,
+    const unsigned int segmentIndex_,
+    const AreaI& segmentBBox31,
+    const QString& trackName)
+    : MapObject(false, true, false)
+    , tracksFile(tracksFile_)
+    , segmentIndex(segmentIndex_)
+{
+    // Points are not kept, bbox stored in file is enough to find tiles segment crosses
+    bbox31 = segmentBBox31;
+
+    if (!trackName.isEmpty())
+    {
+        captionsOrder.push_back(attributeMapping->nativeNameAttributeId);
+        captions[attributeMapping->nativeNameAttributeId] = trackName;
+    }
+
+    attributeIds.append(std::static_pointer_cast<const AttributeMapping>(attributeMapping)->tracklineAttributeId);
+}
+
+OsmAnd::GeoInfoPresenter::ColumnarTracklineMapObject::~ColumnarTracklineMapObject()
+{
+}
+
+bool OsmAnd::GeoInfoPresenter::ColumnarTracklineMapObject::readPoints31(QVector<PointI>& outPoints31) const
+{
+    // Coordinates are stored as 31-bit ones, so they are used as is
+    if (!tracksFile->readSegment(segmentIndex, &outPoints31))
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "Failed to read segment %u of '%s'",
+            segmentIndex,
+            qPrintable(tracksFile->filename));
+        return false;
+    }
+
+    return true;
+}
+
 OsmAnd::GeoInfoPresenter::RoutepointMapObject::RoutepointMapObject(
     const std::shared_ptr<const GeoInfoDocument>& geoInfoDocument_,
     const std::shared_ptr<const GeoInfoDocument::Route>& route_,
@@ -14,7 +14,8 @@ OsmAnd::GeoInfoPresenter_P::~GeoInfoPresenter_P()
 }
 
 QList< std::shared_ptr<const OsmAnd::GeoInfoPresenter_P::MapObject> > OsmAnd::GeoInfoPresenter_P::generateMapObjects(
-    const QList< std::shared_ptr<const GeoInfoDocument> >& geoInfoDocuments)
+    const QList< std::shared_ptr<const GeoInfoDocument> >& geoInfoDocuments,
+    const QList< std::shared_ptr<const ColumnarTracksFile> >& tracksFiles)
 {
     QList< std::shared_ptr<const MapObject> > mapObjects;
 
@@ -74,12 +75,37 @@ QList< std::shared_ptr<const OsmAnd::GeoInfoPresenter_P::MapObject> > OsmAnd::Ge
         }
     }
 
+    // Only track lines are presented, so that whole fleet of tracks doesn't turn into objects per point.
+    // Segments are not decoded here, but each time tile they cross is requested
+    for (const auto& tracksFile : constOf(tracksFiles))
+    {
+        if (!tracksFile->isOpened())
+            continue;
+
+        const auto tracks = tracksFile->getTracks();
+        const auto segments = tracksFile->getSegments();
+        for (auto segmentIdx = 0u; segmentIdx < static_cast<unsigned int>(segments.size()); segmentIdx++)
+        {
+            const auto& segment = segments[segmentIdx];
+            if (segment.pointsCount == 0)
+                continue;
+
+            const std::shared_ptr<ColumnarTracklineMapObject> newMapObject(new ColumnarTracklineMapObject(
+                tracksFile,
+                segmentIdx,
+                segment.bbox31,
+                tracks[segment.trackIndex].name));
+            mapObjects.append(newMapObject);
+        }
+    }
+
     return mapObjects;
 }
 
 std::shared_ptr<OsmAnd::IMapObjectsProvider> OsmAnd::GeoInfoPresenter_P::createMapObjectsProvider() const
 {
-    const auto mapObjects = generateMapObjects(owner->documents);
+    const auto mapObjects = generateMapObjects(owner->documents, owner->tracksFiles);
     return std::shared_ptr<MapObjectsProvider>(new MapObjectsProvider(
-        copyAs< QList< std::shared_ptr<const OsmAnd::MapObject> > >(mapObjects)));
+        copyAs< QList< std::shared_ptr<const OsmAnd::MapObject> > >(mapObjects),
+        true));
 }
@@ -27,6 +27,7 @@ namespace OsmAnd
         typedef GeoInfoPresenter::WaypointMapObject WaypointMapObject;
         typedef GeoInfoPresenter::TrackpointMapObject TrackpointMapObject;
         typedef GeoInfoPresenter::TracklineMapObject TracklineMapObject;
+        typedef GeoInfoPresenter::ColumnarTracklineMapObject ColumnarTracklineMapObject;
         typedef GeoInfoPresenter::RoutepointMapObject RoutepointMapObject;
         typedef GeoInfoPresenter::RoutelineMapObject RoutelineMapObject;
 
@@ -35,7 +36,8 @@ namespace OsmAnd
         GeoInfoPresenter_P(GeoInfoPresenter* const owner);
 
         static QList< std::shared_ptr<const MapObject> > generateMapObjects(
-            const QList< std::shared_ptr<const GeoInfoDocument> >& geoInfoDocuments);
+            const QList< std::shared_ptr<const GeoInfoDocument> >& geoInfoDocuments,
+            const QList< std::shared_ptr<const ColumnarTracksFile> >& tracksFiles);
     public:
         virtual ~GeoInfoPresenter_P();
 
@@ -0,0 +1,92 @@
+#include "HeightmapTileCache.h"
+#include "HeightmapTileCache_P.h"
+
+OsmAnd::HeightmapTileCache::HeightmapTileCache(const unsigned int capacityInBytes /*= DefaultCapacityInBytes*/)
+    : _p(new HeightmapTileCache_P(this, capacityInBytes))
+{
+}
+
+OsmAnd::HeightmapTileCache::~HeightmapTileCache()
+{
+}
+
+unsigned int OsmAnd::HeightmapTileCache::capacityInBytes() const
+{
+    return _p->capacityInBytes();
+}
+
+void OsmAnd::HeightmapTileCache::setCapacityInBytes(const unsigned int capacityInBytes)
+{
+    _p->setCapacityInBytes(capacityInBytes);
+}
+
+bool OsmAnd::HeightmapTileCache::obtainTile(const TileId tileId, const ZoomLevel zoom, QVector<float>& outGrid)
+{
+    return _p->obtainTile(tileId, zoom, outGrid);
+}
+
+void OsmAnd::HeightmapTileCache::insertTile(const TileId tileId, const ZoomLevel zoom, const QVector<float>& grid)
+{
+    _p->insertTile(tileId, zoom, grid);
+}
+
+bool OsmAnd::HeightmapTileCache::obtainStitchedTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const unsigned int tileSize,
+    QVector<float>& outGrid,
+    unsigned int* const pOutMissingNeighboursCount /*= nullptr*/)
+{
+    return _p->obtainStitchedTile(tileId, zoom, tileSize, outGrid, pOutMissingNeighboursCount);
+}
+
+OsmAnd::HeightmapTileCache::Statistics OsmAnd::HeightmapTileCache::getStatistics() const
+{
+    return _p->getStatistics();
+}
+
+void OsmAnd::HeightmapTileCache::resetStatistics()
+{
+    _p->resetStatistics();
+}
+
+void OsmAnd::HeightmapTileCache::clear()
+{
+    _p->clear();
+}
+
+OsmAnd::HeightmapTileCache::Statistics::Statistics()
+    : hits(0)
+    , misses(0)
+    , evictions(0)
+    , stitchedTiles(0)
+    , missingNeighbours(0)
+    , entriesCount(0)
+    , sizeInBytes(0)
+    , capacityInBytes(0)
+{
+}
+
+float OsmAnd::HeightmapTileCache::Statistics::getHitRatio() const
+{
+    const auto lookups = hits + misses;
+    if (lookups == 0)
+        return 0.0f;
+    return static_cast<float>(static_cast<double>(hits) / static_cast<double>(lookups));
+}
+
+QString OsmAnd::HeightmapTileCache::Statistics::toString(const QString& prefix /*= QString::null*/) const
+{
+    QString output;
+
+    output += prefix + QString(QLatin1String("hits = %1")).arg(hits);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("misses = %1")).arg(misses);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("hit ratio = %1%")).arg(getHitRatio() * 100.0f, 0, 'f', 1);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("evictions = %1")).arg(evictions);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("stitched tiles = %1")).arg(stitchedTiles);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("missing neighbours = %1")).arg(missingNeighbours);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("entries = %1")).arg(entriesCount);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("size = %1 of %2 bytes")).arg(sizeInBytes).arg(capacityInBytes);
+
+    return output;
+}
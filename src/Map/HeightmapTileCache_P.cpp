@@ -0,0 +1,200 @@
+#include "HeightmapTileCache_P.h"
+#include "HeightmapTileCache.h"
+
+OsmAnd::HeightmapTileCache_P::HeightmapTileCache_P(HeightmapTileCache* const owner_, const unsigned int capacityInBytes)
+    : _cache(static_cast<int>(capacityInBytes))
+    , _hits(0)
+    , _misses(0)
+    , _evictions(0)
+    , _stitchedTiles(0)
+    , _missingNeighbours(0)
+    , owner(owner_)
+{
+}
+
+OsmAnd::HeightmapTileCache_P::~HeightmapTileCache_P()
+{
+}
+
+OsmAnd::HeightmapTileCache_P::Key OsmAnd::HeightmapTileCache_P::makeKey(const TileId tileId, const ZoomLevel zoom)
+{
+    Key key;
+    key.tileId = tileId;
+    key.zoom = zoom;
+    return key;
+}
+
+unsigned int OsmAnd::HeightmapTileCache_P::getSizeInBytes(const QVector<float>& grid)
+{
+    return static_cast<unsigned int>(sizeof(Key) + sizeof(QVector<float>) + grid.size() * sizeof(float));
+}
+
+unsigned int OsmAnd::HeightmapTileCache_P::capacityInBytes() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return static_cast<unsigned int>(_cache.maxCost());
+}
+
+void OsmAnd::HeightmapTileCache_P::setCapacityInBytes(const unsigned int capacityInBytes)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    const auto countBefore = _cache.count();
+    _cache.setMaxCost(static_cast<int>(capacityInBytes));
+    _evictions += countBefore - _cache.count();
+}
+
+bool OsmAnd::HeightmapTileCache_P::obtainTile(const TileId tileId, const ZoomLevel zoom, QVector<float>& outGrid)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    const auto pGrid = _cache.object(makeKey(tileId, zoom));
+    if (!pGrid)
+    {
+        _misses++;
+        return false;
+    }
+
+    _hits++;
+    outGrid = *pGrid;
+    return true;
+}
+
+void OsmAnd::HeightmapTileCache_P::insertTile(const TileId tileId, const ZoomLevel zoom, const QVector<float>& grid)
+{
+    const auto key = makeKey(tileId, zoom);
+    const auto sizeInBytes = static_cast<int>(getSizeInBytes(grid));
+    const auto pGrid = new QVector<float>(grid);
+
+    QMutexLocker scopedLocker(&_mutex);
+
+    // Another thread may have decoded same tile concurrently, in that case grid gets replaced
+    const auto countBefore = _cache.count() - (_cache.contains(key) ? 1 : 0);
+    const auto inserted = _cache.insert(key, pGrid, sizeInBytes);
+    _evictions += countBefore - (_cache.count() - (inserted ? 1 : 0));
+}
+
+bool OsmAnd::HeightmapTileCache_P::obtainStitchedTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const unsigned int tileSize_,
+    QVector<float>& outGrid,
+    unsigned int* const pOutMissingNeighboursCount)
+{
+    const auto tileSize = static_cast<int>(tileSize_);
+    const auto stitchedSize = tileSize + 2;
+    const auto tilesPerSide = static_cast<int64_t>(1) << zoom;
+
+    QMutexLocker scopedLocker(&_mutex);
+
+    const auto pCenter = _cache.object(makeKey(tileId, zoom));
+    if (!pCenter || pCenter->size() != tileSize * tileSize)
+        return false;
+
+    // Neighbours are indexed by (dy + 1) * 3 + (dx + 1). Tiles wrap around antimeridian, but not poles
+    const QVector<float>* neighbours[9];
+    unsigned int missingNeighboursCount = 0;
+    for (auto dy = -1; dy <= 1; dy++)
+    {
+        for (auto dx = -1; dx <= 1; dx++)
+        {
+            auto& pNeighbour = neighbours[(dy + 1) * 3 + (dx + 1)];
+            if (dx == 0 && dy == 0)
+            {
+                pNeighbour = pCenter;
+                continue;
+            }
+
+            pNeighbour = nullptr;
+            const auto y = static_cast<int64_t>(tileId.y) + dy;
+            if (y >= 0 && y < tilesPerSide)
+            {
+                const auto x = (static_cast<int64_t>(tileId.x) + dx + tilesPerSide) % tilesPerSide;
+                const auto neighbourTileId = TileId::fromXY(static_cast<int32_t>(x), static_cast<int32_t>(y));
+                pNeighbour = _cache.object(makeKey(neighbourTileId, zoom));
+            }
+            if (!pNeighbour || pNeighbour->size() != tileSize * tileSize)
+            {
+                pNeighbour = nullptr;
+                missingNeighboursCount++;
+            }
+        }
+    }
+
+    outGrid.resize(stitchedSize * stitchedSize);
+    const auto pOutGrid = outGrid.data();
+    for (auto row = -1; row <= tileSize; row++)
+    {
+        const auto dy = (row < 0) ? -1 : (row < tileSize ? 0 : 1);
+        for (auto col = -1; col <= tileSize; col++)
+        {
+            const auto dx = (col < 0) ? -1 : (col < tileSize ? 0 : 1);
+
+            float value;
+            if (const auto pNeighbour = neighbours[(dy + 1) * 3 + (dx + 1)])
+            {
+                const auto neighbourRow = row - dy * tileSize;
+                const auto neighbourCol = col - dx * tileSize;
+                value = pNeighbour->at(neighbourRow * tileSize + neighbourCol);
+            }
+            else
+            {
+                const auto clampedRow = qBound(0, row, tileSize - 1);
+                const auto clampedCol = qBound(0, col, tileSize - 1);
+                value = pCenter->at(clampedRow * tileSize + clampedCol);
+            }
+            pOutGrid[(row + 1) * stitchedSize + (col + 1)] = value;
+        }
+    }
+
+    _stitchedTiles++;
+    _missingNeighbours += missingNeighboursCount;
+    if (pOutMissingNeighboursCount)
+        *pOutMissingNeighboursCount = missingNeighboursCount;
+    return true;
+}
+
+OsmAnd::HeightmapTileCache_P::Statistics OsmAnd::HeightmapTileCache_P::getStatistics() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    Statistics statistics;
+    statistics.hits = _hits;
+    statistics.misses = _misses;
+    statistics.evictions = _evictions;
+    statistics.stitchedTiles = _stitchedTiles;
+    statistics.missingNeighbours = _missingNeighbours;
+    statistics.entriesCount = _cache.count();
+    statistics.sizeInBytes = _cache.totalCost();
+    statistics.capacityInBytes = _cache.maxCost();
+    return statistics;
+}
+
+void OsmAnd::HeightmapTileCache_P::resetStatistics()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+    _stitchedTiles = 0;
+    _missingNeighbours = 0;
+}
+
+void OsmAnd::HeightmapTileCache_P::clear()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    _cache.clear();
+}
+
+bool OsmAnd::HeightmapTileCache_P::Key::operator==(const Key& that) const
+{
+    return tileId.id == that.tileId.id && zoom == that.zoom;
+}
+
+uint OsmAnd::qHash(const HeightmapTileCache_P::Key& key, uint seed /*= 0*/) Q_DECL_NOTHROW
+{
+    return ::qHash(static_cast<uint64_t>(key.tileId), seed) * 31 + static_cast<uint>(key.zoom);
+}
@@ -0,0 +1,75 @@
+#ifndef _OSMAND_CORE_HEIGHTMAP_TILE_CACHE_P_H_
+#define _OSMAND_CORE_HEIGHTMAP_TILE_CACHE_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QVector>
+#include <QCache>
+#include <QMutex>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "HeightmapTileCache.h"
+
+namespace OsmAnd
+{
+    class HeightmapTileCache_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(HeightmapTileCache_P);
+
+    public:
+        typedef HeightmapTileCache::Statistics Statistics;
+
+        struct Key Q_DECL_FINAL
+        {
+            TileId tileId;
+            ZoomLevel zoom;
+
+            bool operator==(const Key& that) const;
+        };
+
+    private:
+        mutable QMutex _mutex;
+        QCache<Key, QVector<float> > _cache;
+        uint64_t _hits;
+        uint64_t _misses;
+        uint64_t _evictions;
+        uint64_t _stitchedTiles;
+        uint64_t _missingNeighbours;
+
+        static Key makeKey(const TileId tileId, const ZoomLevel zoom);
+        static unsigned int getSizeInBytes(const QVector<float>& grid);
+    protected:
+        HeightmapTileCache_P(HeightmapTileCache* const owner, const unsigned int capacityInBytes);
+    public:
+        ~HeightmapTileCache_P();
+
+        ImplementationInterface<HeightmapTileCache> owner;
+
+        unsigned int capacityInBytes() const;
+        void setCapacityInBytes(const unsigned int capacityInBytes);
+
+        bool obtainTile(const TileId tileId, const ZoomLevel zoom, QVector<float>& outGrid);
+        void insertTile(const TileId tileId, const ZoomLevel zoom, const QVector<float>& grid);
+        bool obtainStitchedTile(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            const unsigned int tileSize,
+            QVector<float>& outGrid,
+            unsigned int* const pOutMissingNeighboursCount);
+
+        Statistics getStatistics() const;
+        void resetStatistics();
+        void clear();
+
+    friend class OsmAnd::HeightmapTileCache;
+    };
+
+    uint qHash(const HeightmapTileCache_P::Key& key, uint seed = 0) Q_DECL_NOTHROW;
+}
+
+#endif // !defined(_OSMAND_CORE_HEIGHTMAP_TILE_CACHE_P_H_)
@@ -1,6 +1,8 @@
 #include "HeightmapTileProvider.h"
 #include "HeightmapTileProvider_P.h"
 
+#include "MapDataProviderHelpers.h"
+
 const QString OsmAnd::HeightmapTileProvider::defaultIndexFilename(QLatin1String("heightmap.index"));
 
 OsmAnd::HeightmapTileProvider::HeightmapTileProvider(const QString& dataPath_, const QString& indexFilename_ /*= QString::null*/)
@@ -19,6 +21,11 @@ void OsmAnd::HeightmapTileProvider::rebuildTileDbIndex()
     _p->rebuildTileDbIndex();
 }
 
+std::shared_ptr<OsmAnd::HeightmapTileCache> OsmAnd::HeightmapTileProvider::getTileCache() const
+{
+    return _p->getTileCache();
+}
+
 OsmAnd::ZoomLevel OsmAnd::HeightmapTileProvider::getMinZoom() const
 {
     return _p->getMinZoom();
@@ -34,6 +41,11 @@ uint32_t OsmAnd::HeightmapTileProvider::getTileSize() const
     return _p->getTileSize();
 }
 
+bool OsmAnd::HeightmapTileProvider::supportsNaturalObtainData() const
+{
+    return true;
+}
+
 bool OsmAnd::HeightmapTileProvider::obtainData(
     const IMapDataProvider::Request& request,
     std::shared_ptr<IMapDataProvider::Data>& outData,
@@ -41,3 +53,16 @@ bool OsmAnd::HeightmapTileProvider::obtainData(
 {
     return _p->obtainData(request, outData, pOutMetric);
 }
+
+bool OsmAnd::HeightmapTileProvider::supportsNaturalObtainDataAsync() const
+{
+    return false;
+}
+
+void OsmAnd::HeightmapTileProvider::obtainDataAsync(
+    const IMapDataProvider::Request& request,
+    const IMapDataProvider::ObtainDataAsyncCallback callback,
+    const bool collectMetric /*= false*/)
+{
+    MapDataProviderHelpers::nonNaturalObtainDataAsync(this, request, callback, collectMetric);
+}
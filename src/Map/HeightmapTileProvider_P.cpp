@@ -16,8 +16,9 @@ OsmAnd::HeightmapTileProvider_P::HeightmapTileProvider_P(
     HeightmapTileProvider* const owner_,
     const QString& dataPath,
     const QString& indexFilename)
-    : owner(owner_)
+    : _tileCache(new HeightmapTileCache())
     , _tileDb(dataPath, indexFilename)
+    , owner(owner_)
 {
 }
 
@@ -30,6 +31,11 @@ void OsmAnd::HeightmapTileProvider_P::rebuildTileDbIndex()
     _tileDb.rebuildIndex();
 }
 
+std::shared_ptr<OsmAnd::HeightmapTileCache> OsmAnd::HeightmapTileProvider_P::getTileCache() const
+{
+    return _tileCache;
+}
+
 OsmAnd::ZoomLevel OsmAnd::HeightmapTileProvider_P::getMinZoom() const
 {
     return MinZoomLevel;
@@ -55,17 +61,50 @@ bool OsmAnd::HeightmapTileProvider_P::obtainData(
     if (pOutMetric)
         pOutMetric->reset();
 
-    // Obtain raw data from DB
-    QByteArray data;
-    bool ok = _tileDb.obtainTileData(request.tileId, request.zoom, data);
-    if (!ok || data.length() == 0)
+    QVector<float> grid;
+    if (!_tileCache->obtainTile(request.tileId, request.zoom, grid))
     {
-        // There was no data at all, to avoid further requests, mark this tile as empty
+        // Obtain raw data from DB
+        QByteArray data;
+        bool ok = _tileDb.obtainTileData(request.tileId, request.zoom, data);
+        if (ok && data.length() > 0)
+        {
+            if (!decodeTile(request.tileId, request.zoom, data, grid))
+                return false;
+        }
+
+        // Tile without data is cached as empty grid, to avoid further requests
+        _tileCache->insertTile(request.tileId, request.zoom, grid);
+    }
+
+    if (grid.isEmpty())
+    {
+        // There was no data at all, mark this tile as empty
         outData.reset();
         return true;
     }
 
-    // We have the data, use GDAL to decode this GeoTIFF
+    // Cached grid is shared, so data gets own copy of it
+    const auto tileSize = getTileSize();
+    const auto buffer = new float[tileSize*tileSize];
+    memcpy(buffer, grid.constData(), tileSize*tileSize*sizeof(float));
+    outData.reset(new IMapElevationDataProvider::Data(
+        request.tileId,
+        request.zoom,
+        sizeof(float)*tileSize,
+        tileSize,
+        buffer));
+
+    return true;
+}
+
+bool OsmAnd::HeightmapTileProvider_P::decodeTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    QByteArray& data,
+    QVector<float>& outGrid) const
+{
+    // Use GDAL to decode this GeoTIFF
     const auto tileSize = getTileSize();
     bool success = false;
     QString vmemFilename;
@@ -84,18 +123,18 @@ bool OsmAnd::HeightmapTileProvider_P::obtainData(
             {
                 LogPrintf(LogSeverityLevel::Error,
                     "Height tile %dx%d@%d has %d bands instead of 1",
-                    request.tileId.x,
-                    request.tileId.y,
-                    request.zoom,
+                    tileId.x,
+                    tileId.y,
+                    zoom,
                     dataset->GetRasterCount());
             }
             if (dataset->GetRasterXSize() != tileSize || dataset->GetRasterYSize() != tileSize)
             {
                 LogPrintf(LogSeverityLevel::Error,
                     "Height tile %dx%d@%d has %dx%x size instead of %d",
-                    request.tileId.x,
-                    request.tileId.y,
-                    request.zoom,
+                    tileId.x,
+                    tileId.y,
+                    zoom,
                     dataset->GetRasterXSize(),
                     dataset->GetRasterYSize(),
                     tileSize);
@@ -114,30 +153,30 @@ bool OsmAnd::HeightmapTileProvider_P::obtainData(
                 {
                     LogPrintf(LogSeverityLevel::Error,
                         "Height tile %dx%d@%d has color table",
-                        request.tileId.x,
-                        request.tileId.y,
-                        request.zoom);
+                        tileId.x,
+                        tileId.y,
+                        zoom);
                 }
                 if (band->GetRasterDataType() != GDT_Int16)
                 {
                     LogPrintf(LogSeverityLevel::Error,
                         "Height tile %dx%d@%d has %s data type in band 1",
-                        request.tileId.x,
-                        request.tileId.y,
-                        request.zoom,
+                        tileId.x,
+                        tileId.y,
+                        zoom,
                         GDALGetDataTypeName(band->GetRasterDataType()));
                 }
             }
             else
             {
-                const auto buffer = new float[tileSize*tileSize];
+                outGrid.resize(tileSize*tileSize);
                 const auto res = dataset->RasterIO(
                     GF_Read,
                     0,
                     0,
                     tileSize,
                     tileSize,
-                    buffer,
+                    outGrid.data(),
                     tileSize,
                     tileSize,
                     GDT_Float32,
@@ -148,24 +187,16 @@ bool OsmAnd::HeightmapTileProvider_P::obtainData(
                     0);
                 if (res != CE_None)
                 {
-                    delete[] buffer;
+                    outGrid.clear();
                     LogPrintf(LogSeverityLevel::Error,
                         "Failed to decode height tile %dx%d@%d: %s",
-                        request.tileId.x,
-                        request.tileId.y,
-                        request.zoom,
+                        tileId.x,
+                        tileId.y,
+                        zoom,
                         CPLGetLastErrorMsg());
                 }
                 else
-                {
-                    outData.reset(new IMapElevationDataProvider::Data(
-                        request.tileId,
-                        request.zoom,
-                        tileSize,
-                        sizeof(float)*tileSize,
-                        buffer));
                     success = true;
-                }
             }
         }
 
@@ -8,12 +8,14 @@
 #include <QMutex>
 #include <QQueue>
 #include <QSet>
+#include <QVector>
 
 #include "OsmAndCore.h"
 #include "CommonTypes.h"
 #include "PrivateImplementation.h"
 #include "TileDB.h"
 #include "IMapElevationDataProvider.h"
+#include "HeightmapTileCache.h"
 #include "HeightmapTileProvider.h"
 
 namespace OsmAnd
@@ -22,6 +24,9 @@ namespace OsmAnd
     {
         Q_DISABLE_COPY_AND_MOVE(HeightmapTileProvider_P);
     private:
+        const std::shared_ptr<HeightmapTileCache> _tileCache;
+
+        bool decodeTile(const TileId tileId, const ZoomLevel zoom, QByteArray& data, QVector<float>& outGrid) const;
     protected:
         HeightmapTileProvider_P(HeightmapTileProvider* const owner,
             const QString& dataPath,//TODO:refactor-remove
@@ -34,6 +39,7 @@ namespace OsmAnd
         ImplementationInterface<HeightmapTileProvider> owner;
 
         void rebuildTileDbIndex();
+        std::shared_ptr<HeightmapTileCache> getTileCache() const;
 
         ZoomLevel getMinZoom() const;
         ZoomLevel getMaxZoom() const;
@@ -0,0 +1,126 @@
+#include "HillshadeTileProvider.h"
+#include "HillshadeTileProvider_P.h"
+
+#include "MapDataProviderHelpers.h"
+
+OsmAnd::HillshadeTileProvider::HillshadeTileProvider(
+    const std::shared_ptr<IMapElevationDataProvider>& elevationProvider_,
+    const Mode mode_ /*= Mode::Hillshade*/,
+    const uint32_t tileSize_ /*= 256*/,
+    const float densityFactor_ /*= 1.0f*/,
+    const float azimuth_ /*= 315.0f*/,
+    const float altitude_ /*= 45.0f*/,
+    const float zFactor_ /*= 1.0f*/)
+    : _p(new HillshadeTileProvider_P(this, elevationProvider_))
+    , elevationProvider(elevationProvider_)
+    , mode(mode_)
+    , tileSize(tileSize_)
+    , densityFactor(densityFactor_)
+    , azimuth(azimuth_)
+    , altitude(altitude_)
+    , zFactor(zFactor_)
+{
+}
+
+OsmAnd::HillshadeTileProvider::~HillshadeTileProvider()
+{
+}
+
+unsigned int OsmAnd::HillshadeTileProvider::getCacheCapacityInBytes() const
+{
+    return _p->getCacheCapacityInBytes();
+}
+
+void OsmAnd::HillshadeTileProvider::setCacheCapacityInBytes(const unsigned int capacityInBytes)
+{
+    _p->setCacheCapacityInBytes(capacityInBytes);
+}
+
+unsigned int OsmAnd::HillshadeTileProvider::getCachedTilesCount() const
+{
+    return _p->getCachedTilesCount();
+}
+
+void OsmAnd::HillshadeTileProvider::clearCache()
+{
+    _p->clearCache();
+}
+
+OsmAnd::MapStubStyle OsmAnd::HillshadeTileProvider::getDesiredStubsStyle() const
+{
+    return MapStubStyle::Unspecified;
+}
+
+float OsmAnd::HillshadeTileProvider::getTileDensityFactor() const
+{
+    return densityFactor;
+}
+
+uint32_t OsmAnd::HillshadeTileProvider::getTileSize() const
+{
+    return tileSize;
+}
+
+bool OsmAnd::HillshadeTileProvider::supportsNaturalObtainData() const
+{
+    return true;
+}
+
+bool OsmAnd::HillshadeTileProvider::obtainData(
+    const IMapDataProvider::Request& request,
+    std::shared_ptr<IMapDataProvider::Data>& outData,
+    std::shared_ptr<Metric>* const pOutMetric /*= nullptr*/)
+{
+    return _p->obtainData(request, outData, pOutMetric);
+}
+
+bool OsmAnd::HillshadeTileProvider::supportsNaturalObtainDataAsync() const
+{
+    return false;
+}
+
+void OsmAnd::HillshadeTileProvider::obtainDataAsync(
+    const IMapDataProvider::Request& request,
+    const IMapDataProvider::ObtainDataAsyncCallback callback,
+    const bool collectMetric /*= false*/)
+{
+    MapDataProviderHelpers::nonNaturalObtainDataAsync(this, request, callback, collectMetric);
+}
+
+OsmAnd::ZoomLevel OsmAnd::HillshadeTileProvider::getMinZoom() const
+{
+    return elevationProvider->getMinZoom();
+}
+
+OsmAnd::ZoomLevel OsmAnd::HillshadeTileProvider::getMaxZoom() const
+{
+    return elevationProvider->getMaxZoom();
+}
+
+void OsmAnd::HillshadeTileProvider::computeShading(
+    const float* const pElevations,
+    const unsigned int size,
+    const float cellSize,
+    const Mode mode,
+    const float azimuth,
+    const float altitude,
+    const float zFactor,
+    uint8_t* const pOutShading,
+    const bool allowVectorized /*= true*/)
+{
+    HillshadeTileProvider_P::computeShading(
+        pElevations,
+        size,
+        cellSize,
+        mode,
+        azimuth,
+        altitude,
+        zFactor,
+        pOutShading,
+        allowVectorized);
+}
+
+bool OsmAnd::HillshadeTileProvider::isVectorizedShadingSupported()
+{
+    return HillshadeTileProvider_P::isVectorizedShadingSupported();
+}
@@ -0,0 +1,525 @@
+#include "HillshadeTileProvider_P.h"
+#include "HillshadeTileProvider.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "ignore_warnings_on_external_includes.h"
+#include <SkBitmap.h>
+#include <SkColorPriv.h>
+#include "restore_internal_warnings.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define OSMAND_HILLSHADE_SSE2 1
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define OSMAND_HILLSHADE_NEON 1
+#   include <arm_neon.h>
+#endif
+
+#include "HeightmapTileProvider.h"
+#include "MapDataProviderHelpers.h"
+#include "Utilities.h"
+#include "Logging.h"
+
+OsmAnd::HillshadeTileProvider_P::HillshadeTileProvider_P(
+    HillshadeTileProvider* const owner_,
+    const std::shared_ptr<IMapElevationDataProvider>& elevationProvider)
+    : _isElevationCacheShared(false)
+    , _cache(static_cast<int>(HillshadeTileProvider::DefaultCacheCapacityInBytes))
+    , owner(owner_)
+{
+    if (const auto heightmapProvider = std::dynamic_pointer_cast<HeightmapTileProvider>(elevationProvider))
+    {
+        _elevationCache = heightmapProvider->getTileCache();
+        _isElevationCacheShared = true;
+    }
+    else
+        _elevationCache.reset(new HeightmapTileCache());
+}
+
+OsmAnd::HillshadeTileProvider_P::~HillshadeTileProvider_P()
+{
+}
+
+unsigned int OsmAnd::HillshadeTileProvider_P::getCacheCapacityInBytes() const
+{
+    QMutexLocker scopedLocker(&_cacheMutex);
+
+    return static_cast<unsigned int>(_cache.maxCost());
+}
+
+void OsmAnd::HillshadeTileProvider_P::setCacheCapacityInBytes(const unsigned int capacityInBytes)
+{
+    QMutexLocker scopedLocker(&_cacheMutex);
+
+    _cache.setMaxCost(static_cast<int>(capacityInBytes));
+}
+
+unsigned int OsmAnd::HillshadeTileProvider_P::getCachedTilesCount() const
+{
+    QMutexLocker scopedLocker(&_cacheMutex);
+
+    return static_cast<unsigned int>(_cache.count());
+}
+
+void OsmAnd::HillshadeTileProvider_P::clearCache()
+{
+    QMutexLocker scopedLocker(&_cacheMutex);
+
+    _cache.clear();
+}
+
+bool OsmAnd::HillshadeTileProvider_P::obtainData(
+    const IMapDataProvider::Request& request_,
+    std::shared_ptr<IMapDataProvider::Data>& outData,
+    std::shared_ptr<Metric>* const pOutMetric)
+{
+    const auto& request = MapDataProviderHelpers::castRequest<HillshadeTileProvider::Request>(request_);
+    if (pOutMetric)
+        pOutMetric->reset();
+
+    if (request.zoom > owner->getMaxZoom() || request.zoom < owner->getMinZoom())
+    {
+        outData.reset();
+        return true;
+    }
+
+    Key key;
+    key.tileId = request.tileId;
+    key.zoom = request.zoom;
+
+    std::shared_ptr<const SkBitmap> bitmap;
+    bool cached = false;
+    {
+        QMutexLocker scopedLocker(&_cacheMutex);
+
+        if (const auto pCachedBitmap = _cache.object(key))
+        {
+            bitmap = *pCachedBitmap;
+            cached = true;
+        }
+    }
+
+    if (!cached)
+    {
+        QVector<float> stitchedElevations;
+        if (!obtainStitchedElevations(request.tileId, request.zoom, stitchedElevations))
+            return false;
+
+        if (!stitchedElevations.isEmpty())
+        {
+            bitmap = renderTile(request.tileId, request.zoom, stitchedElevations);
+            if (!bitmap)
+                return false;
+        }
+
+        const auto sizeInBytes = bitmap ? static_cast<int>(bitmap->getSize()) : 1;
+        QMutexLocker scopedLocker(&_cacheMutex);
+        _cache.insert(key, new std::shared_ptr<const SkBitmap>(bitmap), sizeInBytes);
+    }
+
+    if (!bitmap)
+    {
+        outData.reset();
+        return true;
+    }
+
+    outData.reset(new IRasterMapLayerProvider::Data(
+        request.tileId,
+        request.zoom,
+        AlphaChannelPresence::Present,
+        owner->densityFactor,
+        bitmap));
+    return true;
+}
+
+bool OsmAnd::HillshadeTileProvider_P::obtainElevations(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    QVector<float>& outElevations)
+{
+    if (_elevationCache->obtainTile(tileId, zoom, outElevations))
+        return true;
+
+    IMapElevationDataProvider::Request request;
+    request.tileId = tileId;
+    request.zoom = zoom;
+    std::shared_ptr<IMapElevationDataProvider::Data> elevationData;
+    if (!owner->elevationProvider->obtainElevationData(request, elevationData))
+        return false;
+
+    outElevations.clear();
+    if (elevationData)
+    {
+        const auto size = static_cast<int>(elevationData->size);
+        outElevations.resize(size * size);
+        const auto pRawData = reinterpret_cast<const uint8_t*>(elevationData->pRawData);
+        for (auto row = 0; row < size; row++)
+        {
+            memcpy(
+                outElevations.data() + row * size,
+                pRawData + row * elevationData->rowLength,
+                size * sizeof(float));
+        }
+    }
+
+    // HeightmapTileProvider has already put decoded tile to its cache
+    if (!_isElevationCacheShared)
+        _elevationCache->insertTile(tileId, zoom, outElevations);
+
+    return true;
+}
+
+bool OsmAnd::HillshadeTileProvider_P::obtainStitchedElevations(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    QVector<float>& outElevations)
+{
+    const auto elevationsSize = owner->elevationProvider->getTileSize();
+    const auto tilesPerSide = static_cast<int64_t>(1) << zoom;
+
+    QVector<float> elevations;
+    if (!obtainElevations(tileId, zoom, elevations))
+        return false;
+    if (elevations.isEmpty())
+    {
+        outElevations.clear();
+        return true;
+    }
+    if (elevations.size() != static_cast<int>(elevationsSize * elevationsSize))
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Elevation tile %dx%d@%d has %d samples instead of %d",
+            tileId.x,
+            tileId.y,
+            zoom,
+            elevations.size(),
+            elevationsSize * elevationsSize);
+        return false;
+    }
+
+    // Tiles are stitched in separate cache, since neighbours may get evicted from shared one meanwhile.
+    // Neighbours that can not be obtained just leave border without data
+    HeightmapTileCache stitchingCache;
+    stitchingCache.insertTile(tileId, zoom, elevations);
+    for (auto dy = -1; dy <= 1; dy++)
+    {
+        const auto y = static_cast<int64_t>(tileId.y) + dy;
+        if (y < 0 || y >= tilesPerSide)
+            continue;
+
+        for (auto dx = -1; dx <= 1; dx++)
+        {
+            if (dx == 0 && dy == 0)
+                continue;
+
+            const auto x = (static_cast<int64_t>(tileId.x) + dx + tilesPerSide) % tilesPerSide;
+            const auto neighbourTileId = TileId::fromXY(static_cast<int32_t>(x), static_cast<int32_t>(y));
+            QVector<float> neighbourElevations;
+            if (obtainElevations(neighbourTileId, zoom, neighbourElevations))
+                stitchingCache.insertTile(neighbourTileId, zoom, neighbourElevations);
+        }
+    }
+
+    return stitchingCache.obtainStitchedTile(tileId, zoom, elevationsSize, outElevations);
+}
+
+std::shared_ptr<SkBitmap> OsmAnd::HillshadeTileProvider_P::renderTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const QVector<float>& stitchedElevations) const
+{
+    const auto tileSize = static_cast<int>(owner->tileSize);
+
+    QVector<float> elevations;
+    upsampleElevations(stitchedElevations, owner->elevationProvider->getTileSize(), tileSize, elevations);
+
+    // Mercator cells are square, with size depending on latitude of tile
+    const auto cellSize = static_cast<float>(Utilities::getMetersPerTileUnit(zoom, tileId.y + 0.5, tileSize));
+    QVector<uint8_t> shading(tileSize * tileSize);
+    computeShading(
+        elevations.constData(),
+        tileSize,
+        cellSize,
+        owner->mode,
+        owner->azimuth,
+        owner->altitude,
+        owner->zFactor,
+        shading.data(),
+        true);
+
+    const std::shared_ptr<SkBitmap> bitmap(new SkBitmap());
+    if (!bitmap->tryAllocPixels(SkImageInfo::MakeN32Premul(tileSize, tileSize)))
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to allocate buffer for hillshade tile %dx%d",
+            tileSize,
+            tileSize);
+        return nullptr;
+    }
+
+    // Shadow is black with opacity, lit areas are transparent
+    auto pShading = shading.constData();
+    for (auto row = 0; row < tileSize; row++)
+    {
+        auto pPixel = bitmap->getAddr32(0, row);
+        for (auto col = 0; col < tileSize; col++)
+            *(pPixel++) = SkPackARGB32(255 - *(pShading++), 0, 0, 0);
+    }
+
+    return bitmap;
+}
+
+void OsmAnd::HillshadeTileProvider_P::upsampleElevations(
+    const QVector<float>& stitchedElevations,
+    const int elevationsSize,
+    const int size,
+    QVector<float>& outElevations)
+{
+    // Output has one-cell border too. Centers of output cells are mapped to stitched samples,
+    // whose centers are at (index - 0.5) / elevationsSize of tile
+    const auto stitchedSize = elevationsSize + 2;
+    const auto outputSize = size + 2;
+    QVector<int> firstIndices(outputSize);
+    QVector<float> weights(outputSize);
+    for (auto idx = 0; idx < outputSize; idx++)
+    {
+        const auto position = qBound(
+            0.0f,
+            (idx - 0.5f) * elevationsSize / size + 0.5f,
+            static_cast<float>(stitchedSize - 1));
+        const auto firstIndex = qMin(static_cast<int>(position), stitchedSize - 2);
+        firstIndices[idx] = firstIndex;
+        weights[idx] = position - firstIndex;
+    }
+
+    outElevations.resize(outputSize * outputSize);
+    QVector<float> rowElevations(stitchedSize);
+    const auto pStitched = stitchedElevations.constData();
+    auto pOutput = outElevations.data();
+    for (auto row = 0; row < outputSize; row++)
+    {
+        const auto pFirstRow = pStitched + firstIndices[row] * stitchedSize;
+        const auto pSecondRow = pFirstRow + stitchedSize;
+        const auto rowWeight = weights[row];
+        for (auto col = 0; col < stitchedSize; col++)
+            rowElevations[col] = pFirstRow[col] + (pSecondRow[col] - pFirstRow[col]) * rowWeight;
+
+        for (auto col = 0; col < outputSize; col++)
+        {
+            const auto firstIndex = firstIndices[col];
+            const auto first = rowElevations[firstIndex];
+            *(pOutput++) = first + (rowElevations[firstIndex + 1] - first) * weights[col];
+        }
+    }
+}
+
+void OsmAnd::HillshadeTileProvider_P::computeShading(
+    const float* const pElevations,
+    const unsigned int size_,
+    const float cellSize,
+    const Mode mode,
+    const float azimuth,
+    const float altitude,
+    const float zFactor,
+    uint8_t* const pOutShading,
+    const bool allowVectorized)
+{
+    const auto size = static_cast<int>(size_);
+    const auto elevationsSize = size + 2;
+
+    ShadingCoefficients coefficients;
+    coefficients.kx = zFactor / (8.0f * cellSize);
+    coefficients.ky = coefficients.kx;
+    if (mode == Mode::Slope)
+    {
+        coefficients.lx = 0.0f;
+        coefficients.ly = 0.0f;
+        coefficients.lz = 1.0f;
+    }
+    else
+    {
+        const auto azimuthInRadians = qDegreesToRadians(azimuth);
+        const auto altitudeInRadians = qDegreesToRadians(altitude);
+        coefficients.lx = std::cos(altitudeInRadians) * std::sin(azimuthInRadians);
+        coefficients.ly = std::cos(altitudeInRadians) * std::cos(azimuthInRadians);
+        coefficients.lz = std::sin(altitudeInRadians);
+    }
+
+    for (auto row = 0; row < size; row++)
+    {
+        const auto pTop = pElevations + row * elevationsSize;
+        const auto pMiddle = pTop + elevationsSize;
+        const auto pBottom = pMiddle + elevationsSize;
+        const auto pOutRow = pOutShading + row * size;
+
+        const auto firstCol = allowVectorized
+            ? computeShadingRowVectorized(pTop, pMiddle, pBottom, size, coefficients, pOutRow)
+            : 0;
+        computeShadingRow(pTop, pMiddle, pBottom, firstCol, size, coefficients, pOutRow);
+    }
+}
+
+// Normal of surface is (-dz/dx, dz/dy, 1), since rows go to south. Shading is cosine of angle between it and light,
+// that needs no trigonometry per cell, unlike classic slope-aspect formula
+void OsmAnd::HillshadeTileProvider_P::computeShadingRow(
+    const float* const pTop,
+    const float* const pMiddle,
+    const float* const pBottom,
+    const int firstCol,
+    const int size,
+    const ShadingCoefficients& coefficients,
+    uint8_t* const pOutShading)
+{
+    for (auto col = firstCol; col < size; col++)
+    {
+        const auto a = pTop[col];
+        const auto b = pTop[col + 1];
+        const auto c = pTop[col + 2];
+        const auto d = pMiddle[col];
+        const auto f = pMiddle[col + 2];
+        const auto g = pBottom[col];
+        const auto h = pBottom[col + 1];
+        const auto i = pBottom[col + 2];
+
+        const auto dzdx = ((c + 2.0f * f + i) - (a + 2.0f * d + g)) * coefficients.kx;
+        const auto dzdy = ((g + 2.0f * h + i) - (a + 2.0f * b + c)) * coefficients.ky;
+        const auto dot = coefficients.lz - coefficients.lx * dzdx + coefficients.ly * dzdy;
+        const auto shade = qMax(0.0f, dot / std::sqrt(1.0f + dzdx * dzdx + dzdy * dzdy));
+        pOutShading[col] = static_cast<uint8_t>(qMin(shade * 255.0f + 0.5f, 255.0f));
+    }
+}
+
+// Same as computeShadingRow() for 4 cells at once, returns number of processed cells
+int OsmAnd::HillshadeTileProvider_P::computeShadingRowVectorized(
+    const float* const pTop,
+    const float* const pMiddle,
+    const float* const pBottom,
+    const int size,
+    const ShadingCoefficients& coefficients,
+    uint8_t* const pOutShading)
+{
+    auto col = 0;
+#if defined(OSMAND_HILLSHADE_SSE2)
+    const auto two = _mm_set1_ps(2.0f);
+    const auto one = _mm_set1_ps(1.0f);
+    const auto zero = _mm_setzero_ps();
+    const auto half = _mm_set1_ps(0.5f);
+    const auto scale = _mm_set1_ps(255.0f);
+    const auto kx = _mm_set1_ps(coefficients.kx);
+    const auto ky = _mm_set1_ps(coefficients.ky);
+    const auto lx = _mm_set1_ps(coefficients.lx);
+    const auto ly = _mm_set1_ps(coefficients.ly);
+    const auto lz = _mm_set1_ps(coefficients.lz);
+    for (; col + 4 <= size; col += 4)
+    {
+        const auto a = _mm_loadu_ps(pTop + col);
+        const auto b = _mm_loadu_ps(pTop + col + 1);
+        const auto c = _mm_loadu_ps(pTop + col + 2);
+        const auto d = _mm_loadu_ps(pMiddle + col);
+        const auto f = _mm_loadu_ps(pMiddle + col + 2);
+        const auto g = _mm_loadu_ps(pBottom + col);
+        const auto h = _mm_loadu_ps(pBottom + col + 1);
+        const auto i = _mm_loadu_ps(pBottom + col + 2);
+
+        const auto dzdx = _mm_mul_ps(
+            _mm_sub_ps(
+                _mm_add_ps(_mm_add_ps(c, _mm_mul_ps(two, f)), i),
+                _mm_add_ps(_mm_add_ps(a, _mm_mul_ps(two, d)), g)),
+            kx);
+        const auto dzdy = _mm_mul_ps(
+            _mm_sub_ps(
+                _mm_add_ps(_mm_add_ps(g, _mm_mul_ps(two, h)), i),
+                _mm_add_ps(_mm_add_ps(a, _mm_mul_ps(two, b)), c)),
+            ky);
+        const auto dot = _mm_add_ps(_mm_sub_ps(lz, _mm_mul_ps(lx, dzdx)), _mm_mul_ps(ly, dzdy));
+        const auto length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(one, _mm_mul_ps(dzdx, dzdx)), _mm_mul_ps(dzdy, dzdy)));
+        const auto shade = _mm_max_ps(zero, _mm_div_ps(dot, length));
+        const auto values = _mm_cvttps_epi32(_mm_min_ps(_mm_add_ps(_mm_mul_ps(shade, scale), half), scale));
+
+        const auto packedValues = _mm_packus_epi16(_mm_packs_epi32(values, values), _mm_setzero_si128());
+        const auto packedValue = _mm_cvtsi128_si32(packedValues);
+        memcpy(pOutShading + col, &packedValue, 4);
+    }
+#elif defined(OSMAND_HILLSHADE_NEON)
+    const auto two = vdupq_n_f32(2.0f);
+    const auto one = vdupq_n_f32(1.0f);
+    const auto zero = vdupq_n_f32(0.0f);
+    const auto half = vdupq_n_f32(0.5f);
+    const auto scale = vdupq_n_f32(255.0f);
+    const auto kx = vdupq_n_f32(coefficients.kx);
+    const auto ky = vdupq_n_f32(coefficients.ky);
+    const auto lx = vdupq_n_f32(coefficients.lx);
+    const auto ly = vdupq_n_f32(coefficients.ly);
+    const auto lz = vdupq_n_f32(coefficients.lz);
+    for (; col + 4 <= size; col += 4)
+    {
+        const auto a = vld1q_f32(pTop + col);
+        const auto b = vld1q_f32(pTop + col + 1);
+        const auto c = vld1q_f32(pTop + col + 2);
+        const auto d = vld1q_f32(pMiddle + col);
+        const auto f = vld1q_f32(pMiddle + col + 2);
+        const auto g = vld1q_f32(pBottom + col);
+        const auto h = vld1q_f32(pBottom + col + 1);
+        const auto i = vld1q_f32(pBottom + col + 2);
+
+        const auto dzdx = vmulq_f32(
+            vsubq_f32(
+                vaddq_f32(vaddq_f32(c, vmulq_f32(two, f)), i),
+                vaddq_f32(vaddq_f32(a, vmulq_f32(two, d)), g)),
+            kx);
+        const auto dzdy = vmulq_f32(
+            vsubq_f32(
+                vaddq_f32(vaddq_f32(g, vmulq_f32(two, h)), i),
+                vaddq_f32(vaddq_f32(a, vmulq_f32(two, b)), c)),
+            ky);
+        const auto dot = vaddq_f32(vsubq_f32(lz, vmulq_f32(lx, dzdx)), vmulq_f32(ly, dzdy));
+        const auto squaredLength = vaddq_f32(vaddq_f32(one, vmulq_f32(dzdx, dzdx)), vmulq_f32(dzdy, dzdy));
+#   if defined(__aarch64__)
+        const auto ratio = vdivq_f32(dot, vsqrtq_f32(squaredLength));
+#   else
+        // ARMv7 has no division, reciprocal square root estimate is refined with two Newton-Raphson steps
+        auto inverseLength = vrsqrteq_f32(squaredLength);
+        inverseLength = vmulq_f32(inverseLength, vrsqrtsq_f32(vmulq_f32(squaredLength, inverseLength), inverseLength));
+        inverseLength = vmulq_f32(inverseLength, vrsqrtsq_f32(vmulq_f32(squaredLength, inverseLength), inverseLength));
+        const auto ratio = vmulq_f32(dot, inverseLength);
+#   endif
+        const auto shade = vmaxq_f32(zero, ratio);
+        const auto values = vcvtq_u32_f32(vminq_f32(vaddq_f32(vmulq_f32(shade, scale), half), scale));
+
+        const auto narrowedValues = vmovn_u32(values);
+        const auto packedValues = vmovn_u16(vcombine_u16(narrowedValues, narrowedValues));
+        uint8_t bytes[8];
+        vst1_u8(bytes, packedValues);
+        memcpy(pOutShading + col, bytes, 4);
+    }
+#else
+    Q_UNUSED(pTop);
+    Q_UNUSED(pMiddle);
+    Q_UNUSED(pBottom);
+    Q_UNUSED(size);
+    Q_UNUSED(coefficients);
+    Q_UNUSED(pOutShading);
+#endif
+    return col;
+}
+
+bool OsmAnd::HillshadeTileProvider_P::isVectorizedShadingSupported()
+{
+#if defined(OSMAND_HILLSHADE_SSE2) || defined(OSMAND_HILLSHADE_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool OsmAnd::HillshadeTileProvider_P::Key::operator==(const Key& that) const
+{
+    return tileId.id == that.tileId.id && zoom == that.zoom;
+}
+
+uint OsmAnd::qHash(const HillshadeTileProvider_P::Key& key, uint seed /*= 0*/) Q_DECL_NOTHROW
+{
+    return ::qHash(static_cast<uint64_t>(key.tileId), seed) * 31 + static_cast<uint>(key.zoom);
+}
@@ -0,0 +1,120 @@
+#ifndef _OSMAND_CORE_HILLSHADE_TILE_PROVIDER_P_H_
+#define _OSMAND_CORE_HILLSHADE_TILE_PROVIDER_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QVector>
+#include <QCache>
+#include <QMutex>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "IMapElevationDataProvider.h"
+#include "HeightmapTileCache.h"
+#include "HillshadeTileProvider.h"
+
+class SkBitmap;
+
+namespace OsmAnd
+{
+    class HillshadeTileProvider_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(HillshadeTileProvider_P);
+    public:
+        typedef HillshadeTileProvider::Mode Mode;
+
+        struct Key Q_DECL_FINAL
+        {
+            TileId tileId;
+            ZoomLevel zoom;
+
+            bool operator==(const Key& that) const;
+        };
+
+    private:
+        struct ShadingCoefficients
+        {
+            // Horn's derivatives are multiplied by these to get them in meters per meter
+            float kx;
+            float ky;
+
+            // Direction to light in east-north-up axes
+            float lx;
+            float ly;
+            float lz;
+        };
+
+        // Decoded elevations of HeightmapTileProvider or own ones for other providers
+        std::shared_ptr<HeightmapTileCache> _elevationCache;
+        bool _isElevationCacheShared;
+
+        mutable QMutex _cacheMutex;
+        // Null bitmap marks tile without elevation data
+        QCache< Key, std::shared_ptr<const SkBitmap> > _cache;
+
+        bool obtainElevations(const TileId tileId, const ZoomLevel zoom, QVector<float>& outElevations);
+        bool obtainStitchedElevations(const TileId tileId, const ZoomLevel zoom, QVector<float>& outElevations);
+        std::shared_ptr<SkBitmap> renderTile(const TileId tileId, const ZoomLevel zoom, const QVector<float>& stitchedElevations) const;
+
+        static void upsampleElevations(
+            const QVector<float>& stitchedElevations,
+            const int elevationsSize,
+            const int size,
+            QVector<float>& outElevations);
+        static void computeShadingRow(
+            const float* const pTop,
+            const float* const pMiddle,
+            const float* const pBottom,
+            const int firstCol,
+            const int size,
+            const ShadingCoefficients& coefficients,
+            uint8_t* const pOutShading);
+        static int computeShadingRowVectorized(
+            const float* const pTop,
+            const float* const pMiddle,
+            const float* const pBottom,
+            const int size,
+            const ShadingCoefficients& coefficients,
+            uint8_t* const pOutShading);
+    protected:
+        HillshadeTileProvider_P(
+            HillshadeTileProvider* const owner,
+            const std::shared_ptr<IMapElevationDataProvider>& elevationProvider);
+    public:
+        ~HillshadeTileProvider_P();
+
+        ImplementationInterface<HillshadeTileProvider> owner;
+
+        unsigned int getCacheCapacityInBytes() const;
+        void setCacheCapacityInBytes(const unsigned int capacityInBytes);
+        unsigned int getCachedTilesCount() const;
+        void clearCache();
+
+        bool obtainData(
+            const IMapDataProvider::Request& request,
+            std::shared_ptr<IMapDataProvider::Data>& outData,
+            std::shared_ptr<Metric>* const pOutMetric);
+
+        static void computeShading(
+            const float* const pElevations,
+            const unsigned int size,
+            const float cellSize,
+            const Mode mode,
+            const float azimuth,
+            const float altitude,
+            const float zFactor,
+            uint8_t* const pOutShading,
+            const bool allowVectorized);
+        static bool isVectorizedShadingSupported();
+
+    friend class OsmAnd::HillshadeTileProvider;
+    };
+
+    uint qHash(const HillshadeTileProvider_P::Key& key, uint seed = 0) Q_DECL_NOTHROW;
+}
+
+#endif // !defined(_OSMAND_CORE_HILLSHADE_TILE_PROVIDER_P_H_)
@@ -10,6 +10,13 @@ OsmAnd::IMapKeyedDataProvider::~IMapKeyedDataProvider()
 {
 }
 
+QList<OsmAnd::IMapKeyedDataProvider::Key> OsmAnd::IMapKeyedDataProvider::getProvidedDataKeysForTiles(
+    const QVector<TileId>& tiles,
+    const ZoomLevel zoom) const
+{
+    return getProvidedDataKeys();
+}
+
 bool OsmAnd::IMapKeyedDataProvider::obtainKeyedData(
     const Request& request,
     std::shared_ptr<Data>& outKeyedData,
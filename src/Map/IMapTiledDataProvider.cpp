@@ -18,6 +18,10 @@ bool OsmAnd::IMapTiledDataProvider::obtainTiledData(
     return MapDataProviderHelpers::obtainData(this, request, outTiledData, pOutMetric);
 }
 
+void OsmAnd::IMapTiledDataProvider::prefetch(const PrefetchHint& hint)
+{
+}
+
 OsmAnd::IMapTiledDataProvider::Data::Data(
     const TileId tileId_,
     const ZoomLevel zoom_,
@@ -67,3 +71,12 @@ std::shared_ptr<OsmAnd::IMapDataProvider::Request> OsmAnd::IMapTiledDataProvider
 {
     return std::shared_ptr<IMapDataProvider::Request>(new Request(*this));
 }
+
+OsmAnd::IMapTiledDataProvider::PrefetchHint::PrefetchHint()
+    : zoom(InvalidZoomLevel)
+{
+}
+
+OsmAnd::IMapTiledDataProvider::PrefetchHint::~PrefetchHint()
+{
+}
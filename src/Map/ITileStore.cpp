@@ -0,0 +1,9 @@
+#include "ITileStore.h"
+
+OsmAnd::ITileStore::ITileStore()
+{
+}
+
+OsmAnd::ITileStore::~ITileStore()
+{
+}
@@ -6,10 +6,25 @@
 #include "QtExtensions.h"
 #include <QMutex>
 #include <QWaitCondition>
-#include <QThreadPool>
+#include <QThread>
 
 #include "OsmAndCore.h"
 #include "QRunnableFunctor.h"
+#include "WorkerPool.h"
+
+namespace
+{
+    // Shares workers with map renderer resources and other pools in same mode, so that providers
+    // don't add threads of their own on top of them
+    OsmAnd::Concurrent::WorkerPool& getProvidersWorkerPool()
+    {
+        static OsmAnd::Concurrent::WorkerPool workerPool(
+            OsmAnd::Concurrent::WorkerPool::Order::FIFO,
+            QThread::idealThreadCount(),
+            OsmAnd::Concurrent::WorkerPool::Scheduler::SharedWorkStealing);
+        return workerPool;
+    }
+}
 
 OsmAnd::MapDataProviderHelpers::MapDataProviderHelpers()
 {
@@ -81,5 +96,5 @@ void OsmAnd::MapDataProviderHelpers::nonNaturalObtainDataAsync(
 
     const auto taskRunnable = new QRunnableFunctor(task);
     taskRunnable->setAutoDelete(true);
-    QThreadPool::globalInstance()->start(taskRunnable);
+    getProvidersWorkerPool().enqueue(taskRunnable);
 }
@@ -75,10 +75,17 @@ OsmAnd::PointI OsmAnd::MapMarker_P::getPosition() const
 
 void OsmAnd::MapMarker_P::setPosition(const PointI position)
 {
-    QWriteLocker scopedLocker(&_lock);
+    PointI previousPosition;
+    {
+        QWriteLocker scopedLocker(&_lock);
 
-    _position = position;
-    _hasUnappliedChanges = true;
+        previousPosition = _position;
+        _position = position;
+        _hasUnappliedChanges = true;
+    }
+
+    if (previousPosition != position)
+        owner->positionChangeObservable.notify(owner, previousPosition);
 }
 
 float OsmAnd::MapMarker_P::getOnMapSurfaceIconDirection(const MapMarker::OnSurfaceIconKey key) const
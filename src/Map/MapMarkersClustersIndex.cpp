@@ -0,0 +1,310 @@
+#include "MapMarkersClustersIndex.h"
+
+#include "Common.h"
+
+OsmAnd::MapMarkersClustersIndex::MapMarkersClustersIndex(const ZoomLevel maxClusteredZoom_)
+    : _cells(maxClusteredZoom_ + 1)
+    , _lastClusterId(0)
+    , maxClusteredZoom(maxClusteredZoom_)
+{
+    assert(maxClusteredZoom + CellZoomShift <= MaxZoomLevel);
+}
+
+OsmAnd::MapMarkersClustersIndex::~MapMarkersClustersIndex()
+{
+}
+
+OsmAnd::MapMarkersClustersIndex::Cell::Cell()
+    : markersCount(0)
+    , clusterKey(nullptr)
+{
+}
+
+OsmAnd::TileId OsmAnd::MapMarkersClustersIndex::getCellId(const PointI position31, const ZoomLevel zoom)
+{
+    const auto zoomShift = ZoomLevel31 - (zoom + CellZoomShift);
+    return TileId::fromXY(position31.x >> zoomShift, position31.y >> zoomShift);
+}
+
+bool OsmAnd::MapMarkersClustersIndex::isClusterKey(const Key key)
+{
+    // Markers are referred by their addresses, which are never odd
+    return (reinterpret_cast<uintptr_t>(key) & 1u) != 0;
+}
+
+void OsmAnd::MapMarkersClustersIndex::renewClusterKey(Cell& cell, const ZoomLevel zoom, const TileId cellId)
+{
+    if (cell.clusterKey)
+    {
+        _clusters.remove(cell.clusterKey);
+        cell.clusterKey = nullptr;
+    }
+    if (cell.markersCount < 2)
+        return;
+
+    _lastClusterId++;
+    cell.clusterKey = reinterpret_cast<Key>((_lastClusterId << 1) | 1u);
+
+    ClusterLocation location;
+    location.zoom = zoom;
+    location.cellId = cellId;
+    _clusters.insert(cell.clusterKey, location);
+}
+
+void OsmAnd::MapMarkersClustersIndex::insertIntoCell(
+    const Key markerKey,
+    const PointI position31,
+    const ZoomLevel zoom,
+    const bool membershipChanged)
+{
+    const auto cellId = getCellId(position31, zoom);
+    auto& cell = _cells[zoom][cellId];
+
+    cell.markersCount++;
+    cell.positionsSum += PointI64(position31);
+    if (zoom == maxClusteredZoom)
+        cell.markersKeys.push_back(markerKey);
+
+    if (membershipChanged)
+        renewClusterKey(cell, zoom, cellId);
+}
+
+void OsmAnd::MapMarkersClustersIndex::removeFromCell(
+    const Key markerKey,
+    const PointI position31,
+    const ZoomLevel zoom,
+    const bool membershipChanged)
+{
+    auto& cells = _cells[zoom];
+    const auto cellId = getCellId(position31, zoom);
+    const auto itCell = cells.find(cellId);
+    if (itCell == cells.end())
+        return;
+    auto& cell = *itCell;
+
+    cell.markersCount--;
+    cell.positionsSum -= PointI64(position31);
+    if (zoom == maxClusteredZoom)
+        cell.markersKeys.removeOne(markerKey);
+
+    if (cell.markersCount <= 0)
+    {
+        if (cell.clusterKey)
+            _clusters.remove(cell.clusterKey);
+        cells.erase(itCell);
+        return;
+    }
+
+    if (membershipChanged)
+        renewClusterKey(cell, zoom, cellId);
+}
+
+void OsmAnd::MapMarkersClustersIndex::insert(const Key markerKey, const PointI position31)
+{
+    if (_markersPositions.contains(markerKey))
+        return;
+    _markersPositions.insert(markerKey, position31);
+
+    for (auto zoom = MinZoomLevel; zoom <= maxClusteredZoom; zoom = static_cast<ZoomLevel>(zoom + 1))
+        insertIntoCell(markerKey, position31, zoom, true);
+}
+
+void OsmAnd::MapMarkersClustersIndex::remove(const Key markerKey)
+{
+    const auto itPosition = _markersPositions.find(markerKey);
+    if (itPosition == _markersPositions.end())
+        return;
+    const auto position31 = *itPosition;
+    _markersPositions.erase(itPosition);
+
+    for (auto zoom = MinZoomLevel; zoom <= maxClusteredZoom; zoom = static_cast<ZoomLevel>(zoom + 1))
+        removeFromCell(markerKey, position31, zoom, true);
+}
+
+void OsmAnd::MapMarkersClustersIndex::move(const Key markerKey, const PointI position31)
+{
+    const auto itPosition = _markersPositions.find(markerKey);
+    if (itPosition == _markersPositions.end())
+        return;
+    const auto previousPosition31 = *itPosition;
+    *itPosition = position31;
+
+    for (auto zoom = MinZoomLevel; zoom <= maxClusteredZoom; zoom = static_cast<ZoomLevel>(zoom + 1))
+    {
+        const auto previousCellId = getCellId(previousPosition31, zoom);
+        const auto cellId = getCellId(position31, zoom);
+        if (previousCellId.id == cellId.id)
+        {
+            // Moving within a cell keeps cluster markers, but its mean position changes, so symbols are
+            // to be obtained again under new key
+            const auto itCell = _cells[zoom].find(cellId);
+            if (itCell != _cells[zoom].end())
+            {
+                itCell->positionsSum += PointI64(position31) - PointI64(previousPosition31);
+                renewClusterKey(*itCell, zoom, cellId);
+            }
+            continue;
+        }
+
+        removeFromCell(markerKey, previousPosition31, zoom, true);
+        insertIntoCell(markerKey, position31, zoom, true);
+    }
+}
+
+void OsmAnd::MapMarkersClustersIndex::clear()
+{
+    for (auto& cells : _cells)
+        cells.clear();
+    _markersPositions.clear();
+    _clusters.clear();
+}
+
+OsmAnd::MapMarkersClustersIndex::Key OsmAnd::MapMarkersClustersIndex::getSingleMarkerKey(
+    const ZoomLevel zoom_,
+    const TileId cellId_) const
+{
+    auto zoom = zoom_;
+    auto cellId = cellId_;
+    while (zoom < maxClusteredZoom)
+    {
+        // Only one of child cells exists, since empty cells are removed
+        const auto& childCells = _cells[zoom + 1];
+        auto childFound = false;
+        for (auto childIdx = 0; childIdx < 4 && !childFound; childIdx++)
+        {
+            const auto childCellId = TileId::fromXY((cellId.x << 1) + (childIdx & 1), (cellId.y << 1) + (childIdx >> 1));
+            if (childCells.contains(childCellId))
+            {
+                cellId = childCellId;
+                childFound = true;
+            }
+        }
+        if (!childFound)
+            return nullptr;
+
+        zoom = static_cast<ZoomLevel>(zoom + 1);
+    }
+
+    const auto citCell = _cells[zoom].constFind(cellId);
+    if (citCell == _cells[zoom].cend() || citCell->markersKeys.isEmpty())
+        return nullptr;
+    return citCell->markersKeys.first();
+}
+
+void OsmAnd::MapMarkersClustersIndex::collectMarkersKeys(
+    const ZoomLevel zoom,
+    const TileId cellId,
+    QList<Key>& outMarkersKeys) const
+{
+    if (zoom == maxClusteredZoom)
+    {
+        const auto citCell = _cells[zoom].constFind(cellId);
+        if (citCell != _cells[zoom].cend())
+            outMarkersKeys.append(citCell->markersKeys);
+        return;
+    }
+
+    const auto childZoom = static_cast<ZoomLevel>(zoom + 1);
+    for (auto childIdx = 0; childIdx < 4; childIdx++)
+    {
+        const auto childCellId = TileId::fromXY((cellId.x << 1) + (childIdx & 1), (cellId.y << 1) + (childIdx >> 1));
+        if (_cells[childZoom].contains(childCellId))
+            collectMarkersKeys(childZoom, childCellId, outMarkersKeys);
+    }
+}
+
+QList<OsmAnd::MapMarkersClustersIndex::Key> OsmAnd::MapMarkersClustersIndex::getKeys(
+    const QVector<TileId>& tiles,
+    const ZoomLevel zoom) const
+{
+    QSet<Key> keys;
+
+    // Active zone may be not yet known
+    if (zoom == InvalidZoomLevel)
+        return keys.toList();
+
+    if (zoom <= maxClusteredZoom)
+    {
+        // Each cell of tile is presented either by cluster or by its single marker
+        const auto& cells = _cells[zoom];
+        const auto cellsPerTileSide = 1 << CellZoomShift;
+        for (const auto& tileId : constOf(tiles))
+        {
+            for (auto cellY = 0; cellY < cellsPerTileSide; cellY++)
+            {
+                for (auto cellX = 0; cellX < cellsPerTileSide; cellX++)
+                {
+                    const auto cellId = TileId::fromXY(
+                        (tileId.x << CellZoomShift) + cellX,
+                        (tileId.y << CellZoomShift) + cellY);
+                    const auto citCell = cells.constFind(cellId);
+                    if (citCell == cells.cend())
+                        continue;
+
+                    const auto key = citCell->markersCount > 1
+                        ? citCell->clusterKey
+                        : getSingleMarkerKey(zoom, cellId);
+                    if (key)
+                        keys.insert(key);
+                }
+            }
+        }
+
+        return keys.toList();
+    }
+
+    // Beyond last clustered zoom, all markers of cells that cover tiles are presented
+    const auto& cells = _cells[maxClusteredZoom];
+    const auto cellsZoom = maxClusteredZoom + CellZoomShift;
+    for (const auto& tileId : constOf(tiles))
+    {
+        TileId firstCellId;
+        auto cellsPerTileSide = 1;
+        if (zoom >= cellsZoom)
+        {
+            firstCellId = TileId::fromXY(tileId.x >> (zoom - cellsZoom), tileId.y >> (zoom - cellsZoom));
+        }
+        else
+        {
+            cellsPerTileSide = 1 << (cellsZoom - zoom);
+            firstCellId = TileId::fromXY(tileId.x << (cellsZoom - zoom), tileId.y << (cellsZoom - zoom));
+        }
+
+        for (auto cellY = 0; cellY < cellsPerTileSide; cellY++)
+        {
+            for (auto cellX = 0; cellX < cellsPerTileSide; cellX++)
+            {
+                const auto citCell = cells.constFind(TileId::fromXY(firstCellId.x + cellX, firstCellId.y + cellY));
+                if (citCell == cells.cend())
+                    continue;
+
+                for (const auto& markerKey : constOf(citCell->markersKeys))
+                    keys.insert(markerKey);
+            }
+        }
+    }
+
+    return keys.toList();
+}
+
+bool OsmAnd::MapMarkersClustersIndex::getCluster(const Key clusterKey, Cluster& outCluster) const
+{
+    const auto citLocation = _clusters.constFind(clusterKey);
+    if (citLocation == _clusters.cend())
+        return false;
+    const auto& location = *citLocation;
+
+    const auto citCell = _cells[location.zoom].constFind(location.cellId);
+    if (citCell == _cells[location.zoom].cend())
+        return false;
+    const auto& cell = *citCell;
+
+    outCluster.zoom = location.zoom;
+    outCluster.position31 = PointI(
+        static_cast<int32_t>(cell.positionsSum.x / cell.markersCount),
+        static_cast<int32_t>(cell.positionsSum.y / cell.markersCount));
+    outCluster.markersKeys.clear();
+    collectMarkersKeys(location.zoom, location.cellId, outCluster.markersKeys);
+
+    return true;
+}
@@ -0,0 +1,92 @@
+#ifndef _OSMAND_CORE_MAP_MARKERS_CLUSTERS_INDEX_H_
+#define _OSMAND_CORE_MAP_MARKERS_CLUSTERS_INDEX_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QVector>
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PointsAndAreas.h"
+#include "IMapKeyedDataProvider.h"
+
+namespace OsmAnd
+{
+    // Hierarchical grid of markers: for each zoom level up to the last clustered one, markers are grouped into
+    // cells of a quarter of tile size. Cell of a zoom level is made of 4 cells of the next one.
+    // Not thread-safe, owner is responsible for locking
+    class MapMarkersClustersIndex Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapMarkersClustersIndex);
+
+    public:
+        typedef IMapKeyedDataProvider::Key Key;
+
+        enum : int {
+            // Cells of zoom level are tiles of that much more detailed zoom level
+            CellZoomShift = 2,
+        };
+
+        struct Cluster
+        {
+            ZoomLevel zoom;
+            PointI position31;
+            QList<Key> markersKeys;
+        };
+
+    private:
+        struct Cell
+        {
+            Cell();
+
+            int markersCount;
+            PointI64 positionsSum;
+            // Valid only if cell has more than one marker, otherwise marker itself represents the cell
+            Key clusterKey;
+            // Only cells of last clustered zoom level hold markers
+            QList<Key> markersKeys;
+        };
+
+        struct ClusterLocation
+        {
+            ZoomLevel zoom;
+            TileId cellId;
+        };
+
+        QVector< QHash<TileId, Cell> > _cells;
+        QHash<Key, PointI> _markersPositions;
+        QHash<Key, ClusterLocation> _clusters;
+        uintptr_t _lastClusterId;
+
+        static TileId getCellId(const PointI position31, const ZoomLevel zoom);
+        void renewClusterKey(Cell& cell, const ZoomLevel zoom, const TileId cellId);
+        void insertIntoCell(const Key markerKey, const PointI position31, const ZoomLevel zoom, const bool membershipChanged);
+        void removeFromCell(const Key markerKey, const PointI position31, const ZoomLevel zoom, const bool membershipChanged);
+        Key getSingleMarkerKey(const ZoomLevel zoom, const TileId cellId) const;
+        void collectMarkersKeys(const ZoomLevel zoom, const TileId cellId, QList<Key>& outMarkersKeys) const;
+    protected:
+    public:
+        MapMarkersClustersIndex(const ZoomLevel maxClusteredZoom);
+        ~MapMarkersClustersIndex();
+
+        const ZoomLevel maxClusteredZoom;
+
+        void insert(const Key markerKey, const PointI position31);
+        void remove(const Key markerKey);
+        void move(const Key markerKey, const PointI position31);
+        void clear();
+
+        // Keys of markers and clusters that present given tiles. Key of cluster changes each time set of its markers
+        // or position of any of them does
+        QList<Key> getKeys(const QVector<TileId>& tiles, const ZoomLevel zoom) const;
+        bool getCluster(const Key clusterKey, Cluster& outCluster) const;
+
+        static bool isClusterKey(const Key key);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_MARKERS_CLUSTERS_INDEX_H_)
@@ -31,11 +31,35 @@ void OsmAnd::MapMarkersCollection::removeAllMarkers()
     _p->removeAllMarkers();
 }
 
+void OsmAnd::MapMarkersCollection::setClusteringEnabled(
+    const bool enabled,
+    const ZoomLevel maxClusteredZoom /*= ZoomLevel16*/)
+{
+    _p->setClusteringEnabled(enabled, maxClusteredZoom);
+}
+
+bool OsmAnd::MapMarkersCollection::isClusteringEnabled() const
+{
+    return _p->isClusteringEnabled();
+}
+
+void OsmAnd::MapMarkersCollection::setClusterSymbolsGroupFactory(const ClusterSymbolsGroupFactory factory)
+{
+    _p->setClusterSymbolsGroupFactory(factory);
+}
+
 QList<OsmAnd::IMapKeyedSymbolsProvider::Key> OsmAnd::MapMarkersCollection::getProvidedDataKeys() const
 {
     return _p->getProvidedDataKeys();
 }
 
+QList<OsmAnd::IMapKeyedSymbolsProvider::Key> OsmAnd::MapMarkersCollection::getProvidedDataKeysForTiles(
+    const QVector<TileId>& tiles,
+    const ZoomLevel zoom) const
+{
+    return _p->getProvidedDataKeysForTiles(tiles, zoom);
+}
+
 bool OsmAnd::MapMarkersCollection::supportsNaturalObtainData() const
 {
     return true;
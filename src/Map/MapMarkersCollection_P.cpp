@@ -3,6 +3,8 @@
 
 #include "MapDataProviderHelpers.h"
 #include "MapMarker.h"
+#include "MapMarkersClustersIndex.h"
+#include "QKeyValueIterator.h"
 
 OsmAnd::MapMarkersCollection_P::MapMarkersCollection_P(MapMarkersCollection* const owner_)
     : owner(owner_)
@@ -11,6 +13,10 @@ OsmAnd::MapMarkersCollection_P::MapMarkersCollection_P(MapMarkersCollection* con
 
 OsmAnd::MapMarkersCollection_P::~MapMarkersCollection_P()
 {
+    QWriteLocker scopedLocker(&_markersLock);
+
+    for (const auto& marker : constOf(_markers))
+        marker->positionChangeObservable.detach(this);
 }
 
 QList< std::shared_ptr<OsmAnd::MapMarker> > OsmAnd::MapMarkersCollection_P::getMarkers() const
@@ -30,6 +36,16 @@ bool OsmAnd::MapMarkersCollection_P::addMarker(const std::shared_ptr<MapMarker>&
 
     _markers.insert(key, marker);
 
+    // Clusters follow markers as they move
+    marker->positionChangeObservable.attach(this,
+        [this]
+        (const MapMarker* const changedMarker, const PointI previousPosition)
+        {
+            onMarkerPositionChanged(changedMarker);
+        });
+    if (_clustersIndex)
+        _clustersIndex->insert(key, marker->getPosition());
+
     return true;
 }
 
@@ -37,7 +53,14 @@ bool OsmAnd::MapMarkersCollection_P::removeMarker(const std::shared_ptr<MapMarke
 {
     QWriteLocker scopedLocker(&_markersLock);
 
-    const bool removed = (_markers.remove(reinterpret_cast<IMapKeyedSymbolsProvider::Key>(marker.get())) > 0);
+    const auto key = reinterpret_cast<IMapKeyedSymbolsProvider::Key>(marker.get());
+    const bool removed = (_markers.remove(key) > 0);
+    if (removed)
+    {
+        marker->positionChangeObservable.detach(this);
+        if (_clustersIndex)
+            _clustersIndex->remove(key);
+    }
     return removed;
 }
 
@@ -45,7 +68,59 @@ void OsmAnd::MapMarkersCollection_P::removeAllMarkers()
 {
     QWriteLocker scopedLocker(&_markersLock);
 
+    for (const auto& marker : constOf(_markers))
+        marker->positionChangeObservable.detach(this);
     _markers.clear();
+    if (_clustersIndex)
+        _clustersIndex->clear();
+}
+
+void OsmAnd::MapMarkersCollection_P::onMarkerPositionChanged(const MapMarker* const marker)
+{
+    QWriteLocker scopedLocker(&_markersLock);
+
+    if (!_clustersIndex)
+        return;
+
+    // Index tracks where marker was, so notifications that race with each other still end up at current position
+    _clustersIndex->move(reinterpret_cast<IMapKeyedSymbolsProvider::Key>(marker), marker->getPosition());
+}
+
+void OsmAnd::MapMarkersCollection_P::setClusteringEnabled(const bool enabled, const ZoomLevel maxClusteredZoom_)
+{
+    QWriteLocker scopedLocker(&_markersLock);
+
+    if (!enabled)
+    {
+        _clustersIndex.reset();
+        return;
+    }
+
+    const auto maxClusteredZoom = static_cast<ZoomLevel>(qMin(
+        static_cast<int>(maxClusteredZoom_),
+        static_cast<int>(MaxZoomLevel) - MapMarkersClustersIndex::CellZoomShift));
+    if (_clustersIndex && _clustersIndex->maxClusteredZoom == maxClusteredZoom)
+        return;
+
+    // Index is built once, then kept up to date as markers are added, removed or moved
+    _clustersIndex.reset(new MapMarkersClustersIndex(maxClusteredZoom));
+    for (const auto& itMarker : rangeOf(constOf(_markers)))
+        _clustersIndex->insert(itMarker.key(), itMarker.value()->getPosition());
+}
+
+bool OsmAnd::MapMarkersCollection_P::isClusteringEnabled() const
+{
+    QReadLocker scopedLocker(&_markersLock);
+
+    return static_cast<bool>(_clustersIndex);
+}
+
+void OsmAnd::MapMarkersCollection_P::setClusterSymbolsGroupFactory(
+    const MapMarkersCollection::ClusterSymbolsGroupFactory factory)
+{
+    QWriteLocker scopedLocker(&_markersLock);
+
+    _clusterSymbolsGroupFactory = factory;
 }
 
 QList<OsmAnd::IMapKeyedSymbolsProvider::Key> OsmAnd::MapMarkersCollection_P::getProvidedDataKeys() const
@@ -55,12 +130,58 @@ QList<OsmAnd::IMapKeyedSymbolsProvider::Key> OsmAnd::MapMarkersCollection_P::get
     return _markers.keys();
 }
 
+QList<OsmAnd::IMapKeyedSymbolsProvider::Key> OsmAnd::MapMarkersCollection_P::getProvidedDataKeysForTiles(
+    const QVector<TileId>& tiles,
+    const ZoomLevel zoom) const
+{
+    QReadLocker scopedLocker(&_markersLock);
+
+    if (!_clustersIndex)
+        return _markers.keys();
+
+    return _clustersIndex->getKeys(tiles, zoom);
+}
+
 bool OsmAnd::MapMarkersCollection_P::obtainData(
     const IMapDataProvider::Request& request_,
     std::shared_ptr<IMapDataProvider::Data>& outData)
 {
     const auto& request = MapDataProviderHelpers::castRequest<MapMarkersCollection::Request>(request_);
 
+    if (MapMarkersClustersIndex::isClusterKey(request.key))
+    {
+        MapMarkersCollection::Cluster cluster;
+        MapMarkersCollection::ClusterSymbolsGroupFactory clusterSymbolsGroupFactory;
+        {
+            QReadLocker scopedLocker(&_markersLock);
+
+            MapMarkersClustersIndex::Cluster indexedCluster;
+            if (!_clustersIndex || !_clustersIndex->getCluster(request.key, indexedCluster))
+                return false;
+
+            cluster.zoom = indexedCluster.zoom;
+            cluster.position31 = indexedCluster.position31;
+            for (const auto& markerKey : constOf(indexedCluster.markersKeys))
+                cluster.markers.push_back(_markers.value(markerKey));
+            clusterSymbolsGroupFactory = _clusterSymbolsGroupFactory;
+        }
+        if (cluster.markers.isEmpty())
+            return false;
+
+        // Factory is called without lock, so it may query collection
+        std::shared_ptr<MapSymbolsGroup> symbolsGroup;
+        if (clusterSymbolsGroupFactory)
+            symbolsGroup = clusterSymbolsGroupFactory(cluster);
+        else
+            symbolsGroup = cluster.markers.first()->createSymbolsGroup();
+        if (!symbolsGroup)
+            return false;
+
+        outData.reset(new IMapKeyedSymbolsProvider::Data(request.key, symbolsGroup));
+
+        return true;
+    }
+
     QReadLocker scopedLocker(&_markersLock);
 
     const auto citMarker = _markers.constFind(request.key);
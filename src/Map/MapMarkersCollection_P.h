@@ -7,6 +7,7 @@
 #include "QtExtensions.h"
 #include <QHash>
 #include <QList>
+#include <QVector>
 #include <QReadWriteLock>
 
 #include "OsmAndCore.h"
@@ -15,6 +16,7 @@
 #include "IMapKeyedSymbolsProvider.h"
 #include "MapMarker.h"
 #include "MapMarkerBuilder.h"
+#include "MapMarkersCollection.h"
 
 class SkBitmap;
 
@@ -23,6 +25,8 @@ namespace OsmAnd
     class MapMarkerBuilder;
     class MapMarkerBuilder_P;
 
+    class MapMarkersClustersIndex;
+
     class MapMarkersCollection;
     class MapMarkersCollection_P Q_DECL_FINAL
     {
@@ -34,8 +38,12 @@ namespace OsmAnd
 
         mutable QReadWriteLock _markersLock;
         QHash< IMapKeyedSymbolsProvider::Key, std::shared_ptr<MapMarker> > _markers;
+        // Present only while clustering is enabled, guarded by markers lock
+        std::unique_ptr<MapMarkersClustersIndex> _clustersIndex;
+        MapMarkersCollection::ClusterSymbolsGroupFactory _clusterSymbolsGroupFactory;
 
         bool addMarker(const std::shared_ptr<MapMarker>& marker);
+        void onMarkerPositionChanged(const MapMarker* const marker);
     public:
         virtual ~MapMarkersCollection_P();
 
@@ -45,7 +53,12 @@ namespace OsmAnd
         bool removeMarker(const std::shared_ptr<MapMarker>& marker);
         void removeAllMarkers();
 
+        void setClusteringEnabled(const bool enabled, const ZoomLevel maxClusteredZoom);
+        bool isClusteringEnabled() const;
+        void setClusterSymbolsGroupFactory(const MapMarkersCollection::ClusterSymbolsGroupFactory factory);
+
         QList<IMapKeyedSymbolsProvider::Key> getProvidedDataKeys() const;
+        QList<IMapKeyedSymbolsProvider::Key> getProvidedDataKeysForTiles(const QVector<TileId>& tiles, const ZoomLevel zoom) const;
         bool obtainData(
             const IMapDataProvider::Request& request,
             std::shared_ptr<IMapDataProvider::Data>& outData);
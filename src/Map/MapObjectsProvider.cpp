@@ -3,9 +3,12 @@
 
 #include "MapDataProviderHelpers.h"
 
-OsmAnd::MapObjectsProvider::MapObjectsProvider(const QList< std::shared_ptr<const MapObject> >& mapObjects_)
+OsmAnd::MapObjectsProvider::MapObjectsProvider(
+    const QList< std::shared_ptr<const MapObject> >& mapObjects_,
+    const bool clipPolylines_ /*= false*/)
     : _p(new MapObjectsProvider_P(this))
     , mapObjects(mapObjects_)
+    , clipPolylines(clipPolylines_)
 {
     _p->prepareData();
 }
@@ -14,6 +17,14 @@ OsmAnd::MapObjectsProvider::~MapObjectsProvider()
 {
 }
 
+OsmAnd::MapObjectsProvider::IDeferredPolyline::IDeferredPolyline()
+{
+}
+
+OsmAnd::MapObjectsProvider::IDeferredPolyline::~IDeferredPolyline()
+{
+}
+
 OsmAnd::ZoomLevel OsmAnd::MapObjectsProvider::getMinZoom() const
 {
     return _p->getMinZoom();
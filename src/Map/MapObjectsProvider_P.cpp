@@ -28,6 +28,8 @@ bool OsmAnd::MapObjectsProvider_P::prepareData()
     {
         const auto minZoom = mapObject->getMinZoomLevel();
         const auto maxZoom = mapObject->getMaxZoomLevel();
+        if (minZoom > maxZoom)
+            continue;
 
         if (minZoom < _preparedData->minZoom)
             _preparedData->minZoom = minZoom;
@@ -35,33 +37,154 @@ bool OsmAnd::MapObjectsProvider_P::prepareData()
             _preparedData->maxZoom = maxZoom;
 
         _preparedData->bbox31.enlargeToInclude(mapObject->bbox31);
+        _preparedData->mapObjectsList.append(mapObject);
 
-        for (int zoomLevel = minZoom; zoomLevel <= maxZoom; zoomLevel++)
-            _preparedData->dataByZoomLevel[static_cast<ZoomLevel>(zoomLevel)].mapObjectsList.append(mapObject);
+        const auto deferredPolyline = dynamic_cast<const MapObjectsProvider::IDeferredPolyline*>(mapObject.get());
+        if (deferredPolyline || (owner->clipPolylines && isPolyline(*mapObject)))
+        {
+            const std::shared_ptr<Polyline> polyline(new Polyline());
+            polyline->deferredPolyline = deferredPolyline;
+            _preparedData->polylines.insert(mapObject.get(), polyline);
+        }
     }
-    for (int zoomLevel = _preparedData->minZoom; zoomLevel <= _preparedData->maxZoom; zoomLevel++)
-    {
-        auto& dataByZoom = _preparedData->dataByZoomLevel[static_cast<ZoomLevel>(zoomLevel)];
+    if (_preparedData->mapObjectsList.isEmpty())
+        return true;
+
+    // QuadTree root node needs to be outer rectangle with each side being power of two
+    auto treeRootArea = _preparedData->bbox31;
+    treeRootArea.top() = Utilities::getPreviousPowerOfTwo(treeRootArea.top());
+    treeRootArea.left() = Utilities::getPreviousPowerOfTwo(treeRootArea.left());
+    treeRootArea.bottom() = qMin(Utilities::getNextPowerOfTwo(treeRootArea.bottom()), static_cast<uint32_t>(std::numeric_limits<int32_t>::max()));
+    treeRootArea.right() = qMin(Utilities::getNextPowerOfTwo(treeRootArea.right()), static_cast<uint32_t>(std::numeric_limits<int32_t>::max()));
+    _preparedData->mapObjectsTree = qMove(MapObjectsTree(treeRootArea, 4));
+
+    for (const auto& mapObject : constOf(_preparedData->mapObjectsList))
+        _preparedData->mapObjectsTree.insert(mapObject, mapObject->bbox31);
+
+    return true;
+}
+
+OsmAnd::MapObjectsProvider_P::Polyline::Polyline()
+    : deferredPolyline(nullptr)
+{
+}
 
-        dataByZoom.bbox31.top() = dataByZoom.bbox31.left() = std::numeric_limits<int32_t>::max();
-        dataByZoom.bbox31.bottom() = dataByZoom.bbox31.right() = std::numeric_limits<int32_t>::min();
+bool OsmAnd::MapObjectsProvider_P::isPolyline(const MapObject& mapObject)
+{
+    return !mapObject.isArea && mapObject.innerPolygonsPoints31.isEmpty() && mapObject.points31.size() > 2;
+}
 
-        for (const auto& mapObject : constOf(dataByZoom.mapObjectsList))
-            dataByZoom.bbox31.enlargeToInclude(mapObject->bbox31);
+void OsmAnd::MapObjectsProvider_P::computePointsSignificance(
+    const QVector<PointI>& points31,
+    const AreaI* const pClipArea31,
+    QVector<double>& outPointsSignificance)
+{
+    // Chunks limit cost of degenerate polylines and keep start of each chunk at any zoom
+    const auto pointsCount = points31.size();
+    outPointsSignificance.fill(0.0, pointsCount);
+    for (auto chunkStart = 0; chunkStart < pointsCount - 1; chunkStart += SimplificationChunkSize)
+    {
+        const auto chunkEnd = qMin(chunkStart + SimplificationChunkSize, pointsCount - 1);
 
-        // QuadTree root node needs to be outer rectangle with each side being power of two
-        auto treeRootArea = dataByZoom.bbox31;
-        treeRootArea.top() = Utilities::getPreviousPowerOfTwo(treeRootArea.top());
-        treeRootArea.left() = Utilities::getPreviousPowerOfTwo(treeRootArea.left());
-        treeRootArea.bottom() = qMin(Utilities::getNextPowerOfTwo(treeRootArea.bottom()), static_cast<uint32_t>(std::numeric_limits<int32_t>::max()));
-        treeRootArea.right() = qMin(Utilities::getNextPowerOfTwo(treeRootArea.right()), static_cast<uint32_t>(std::numeric_limits<int32_t>::max()));
-        dataByZoom.mapObjectsTree = qMove(MapObjectsTree(treeRootArea, 4));
+        // Segments of chunk that is out of clip area are out of it after simplification as well
+        if (pClipArea31)
+        {
+            AreaI chunkBBox31(points31[chunkStart], points31[chunkStart]);
+            for (auto pointIdx = chunkStart + 1; pointIdx <= chunkEnd; pointIdx++)
+                chunkBBox31.enlargeToInclude(points31[pointIdx]);
+            if (!pClipArea31->intersects(chunkBBox31))
+            {
+                outPointsSignificance[chunkStart] = outPointsSignificance[chunkEnd] = std::numeric_limits<double>::max();
+                continue;
+            }
+        }
 
-        for (const auto& mapObject : constOf(dataByZoom.mapObjectsList))
-            dataByZoom.mapObjectsTree.insert(mapObject, mapObject->bbox31);
+        Utilities::computePointsSignificance(points31, chunkStart, chunkEnd, outPointsSignificance);
     }
+}
 
-    return true;
+const QVector<double>& OsmAnd::MapObjectsProvider_P::getPointsSignificance(
+    const MapObject& mapObject,
+    Polyline& polyline)
+{
+    std::call_once(polyline.pointsSignificanceComputed,
+        [&mapObject, &polyline]
+        ()
+        {
+            computePointsSignificance(mapObject.points31, nullptr, polyline.pointsSignificance);
+        });
+
+    return polyline.pointsSignificance;
+}
+
+void OsmAnd::MapObjectsProvider_P::clipPolyline(
+    const std::shared_ptr<const MapObject>& mapObject,
+    const QVector<PointI>& points31,
+    const QVector<double>& pointsSignificance,
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const AreaI& clipArea31,
+    QList< std::shared_ptr<const MapObject> >& outMapObjects)
+{
+    const auto pointsCount = points31.size();
+    if (pointsCount < 2)
+        return;
+    const auto tolerance = static_cast<double>(1u << (ZoomLevel31 - zoom)) / (TileSizeInPixels * 2);
+
+    // Captions go with segment that covers middle point, and only in tile that contains that point
+    const auto captionPointIdx = pointsCount / 2;
+    const auto& captionPoint31 = points31[captionPointIdx];
+    const auto captionInTile = (TileId::fromXY(
+        captionPoint31.x >> (ZoomLevel31 - zoom),
+        captionPoint31.y >> (ZoomLevel31 - zoom)) == tileId);
+
+    // Each run of consecutive segments that touch clip area becomes separate piece. Ends of polyline
+    // are always significant, so the first and the last points are never skipped
+    std::shared_ptr<ClippedMapObject> piece;
+    auto startPointIdx = 0;
+    for (auto endPointIdx = 1; endPointIdx < pointsCount; endPointIdx++)
+    {
+        if (pointsSignificance[endPointIdx] < tolerance)
+            continue;
+
+        const auto& start31 = points31[startPointIdx];
+        const auto& end31 = points31[endPointIdx];
+        const auto isCaptionSegment = captionInTile && startPointIdx <= captionPointIdx && captionPointIdx < endPointIdx;
+        startPointIdx = endPointIdx;
+
+        const AreaI segmentBBox31(
+            qMin(start31.y, end31.y),
+            qMin(start31.x, end31.x),
+            qMax(start31.y, end31.y),
+            qMax(start31.x, end31.x));
+        if (!clipArea31.intersects(segmentBBox31))
+        {
+            if (piece)
+            {
+                piece->computeBBox31();
+                outMapObjects.push_back(piece);
+                piece.reset();
+            }
+            continue;
+        }
+
+        if (!piece)
+        {
+            piece.reset(new ClippedMapObject(mapObject));
+            piece->points31.push_back(start31);
+        }
+        piece->points31.push_back(end31);
+        if (isCaptionSegment)
+        {
+            piece->captions = mapObject->captions;
+            piece->captionsOrder = mapObject->captionsOrder;
+        }
+    }
+    if (piece)
+    {
+        piece->computeBBox31();
+        outMapObjects.push_back(piece);
+    }
 }
 
 OsmAnd::ZoomLevel OsmAnd::MapObjectsProvider_P::getMinZoom() const
@@ -152,67 +275,72 @@ bool OsmAnd::MapObjectsProvider_P::obtainData(
         outData.reset();
         return true;
     }
-    const auto citDataByZoom = _preparedData->dataByZoomLevel.constFind(request.zoom);
-    if (citDataByZoom == _preparedData->dataByZoomLevel.cend())
-    {
-        // Store flag that there was no data and mark tile entry as 'Loaded'
-        tileEntry->dataIsPresent = false;
-        tileEntry->setState(TileState::Loaded);
-
-        // Notify that tile has been loaded
-        {
-            QWriteLocker scopedLcoker(&tileEntry->loadedConditionLock);
-            tileEntry->loadedCondition.wakeAll();
-        }
-
-        outData.reset();
-        return true;
-    }
-
-    const auto& dataByZoom = *citDataByZoom;
     const auto tileBBox31 = Utilities::tileBoundingBox31(request.tileId, request.zoom);
-
-    // In case bbox31 entirely contains all data on given zoom level, return every object
-    if (tileBBox31.contains(dataByZoom.bbox31))
+    const auto clipMargin31 = static_cast<int64_t>(1u << (ZoomLevel31 - request.zoom)) / ClipMarginDivisor;
+    const AreaI clipArea31(
+        static_cast<int32_t>(qMax<int64_t>(tileBBox31.top() - clipMargin31, 0)),
+        static_cast<int32_t>(qMax<int64_t>(tileBBox31.left() - clipMargin31, 0)),
+        static_cast<int32_t>(qMin<int64_t>(tileBBox31.bottom() + clipMargin31, std::numeric_limits<int32_t>::max())),
+        static_cast<int32_t>(qMin<int64_t>(tileBBox31.right() + clipMargin31, std::numeric_limits<int32_t>::max())));
+
+    // Query map objects quad-tree to select objects of given zoom level that are inside bbox or intersect it
+    QList< std::shared_ptr<const MapObject> > mapObjectsInTileBBox;
+    if (_preparedData->bbox31.intersects(clipArea31))
     {
-        const std::shared_ptr<MapObjectsProvider::Data> newTiledData(new MapObjectsProvider::Data(
-            request.tileId,
-            request.zoom,
-            MapSurfaceType::Undefined,
-            dataByZoom.mapObjectsList));
-
-        // Publish new tile
-        outData = newTiledData;
-
-        // Store weak reference to new tile and mark it as 'Loaded'
-        tileEntry->dataIsPresent = true;
-        tileEntry->dataWeakRef = newTiledData;
-        tileEntry->setState(TileState::Loaded);
-
-        return true;
+        const auto zoom = request.zoom;
+        _preparedData->mapObjectsTree.query(clipArea31, mapObjectsInTileBBox, false,
+            [zoom]
+            (const std::shared_ptr<const MapObject>& mapObject, const MapObjectsTree::BBox& bbox) -> bool
+            {
+                return mapObject->getMinZoomLevel() <= zoom && zoom <= mapObject->getMaxZoomLevel();
+            });
     }
 
-    // Otherwise, check if there's common area between zoom area and tile bbox
-    if (!dataByZoom.bbox31.contains(tileBBox31) && !dataByZoom.bbox31.intersects(tileBBox31))
+    // Polylines are replaced with their simplified pieces that cross the tile
+    if (!_preparedData->polylines.isEmpty())
     {
-        // Store flag that there was no data and mark tile entry as 'Loaded'
-        tileEntry->dataIsPresent = false;
-        tileEntry->setState(TileState::Loaded);
-
-        // Notify that tile has been loaded
+        QList< std::shared_ptr<const MapObject> > clippedMapObjects;
+        for (const auto& mapObject : constOf(mapObjectsInTileBBox))
         {
-            QWriteLocker scopedLcoker(&tileEntry->loadedConditionLock);
-            tileEntry->loadedCondition.wakeAll();
-        }
+            const auto citPolyline = _preparedData->polylines.constFind(mapObject.get());
+            if (citPolyline == _preparedData->polylines.cend())
+            {
+                clippedMapObjects.push_back(mapObject);
+                continue;
+            }
+            const auto& polyline = *citPolyline;
 
-        outData.reset();
-        return true;
+            if (const auto deferredPolyline = polyline->deferredPolyline)
+            {
+                // Points are read for this tile only and dropped once pieces are made
+                QVector<PointI> points31;
+                if (!deferredPolyline->readPoints31(points31))
+                    continue;
+                QVector<double> pointsSignificance;
+                computePointsSignificance(points31, &clipArea31, pointsSignificance);
+                clipPolyline(
+                    mapObject,
+                    points31,
+                    pointsSignificance,
+                    request.tileId,
+                    request.zoom,
+                    clipArea31,
+                    clippedMapObjects);
+                continue;
+            }
+
+            clipPolyline(
+                mapObject,
+                mapObject->points31,
+                getPointsSignificance(*mapObject, *polyline),
+                request.tileId,
+                request.zoom,
+                clipArea31,
+                clippedMapObjects);
+        }
+        mapObjectsInTileBBox = qMove(clippedMapObjects);
     }
 
-    // Query map objects quad-tree to select objects that are inside bbox or intersect it
-    QList< std::shared_ptr<const MapObject> > mapObjectsInTileBBox;
-    dataByZoom.mapObjectsTree.query(tileBBox31, mapObjectsInTileBBox);
-
     // Check if there are map objects for specified tile
     if (mapObjectsInTileBBox.isEmpty())
     {
@@ -263,3 +391,36 @@ OsmAnd::MapObjectsProvider_P::RetainableCacheMetadata::~RetainableCacheMetadata(
             link->collection.removeEntry(tileEntry->tileId, tileEntry->zoom);
     }
 }
+
+OsmAnd::MapObjectsProvider_P::ClippedMapObject::ClippedMapObject(const std::shared_ptr<const MapObject>& original_)
+    : original(original_)
+{
+    attributeMapping = original->attributeMapping;
+    isArea = original->isArea;
+    attributeIds = original->attributeIds;
+    additionalAttributeIds = original->additionalAttributeIds;
+}
+
+OsmAnd::MapObjectsProvider_P::ClippedMapObject::~ClippedMapObject()
+{
+}
+
+bool OsmAnd::MapObjectsProvider_P::ClippedMapObject::obtainSortingKey(SortingKey& outKey) const
+{
+    return original->obtainSortingKey(outKey);
+}
+
+OsmAnd::ZoomLevel OsmAnd::MapObjectsProvider_P::ClippedMapObject::getMinZoomLevel() const
+{
+    return original->getMinZoomLevel();
+}
+
+OsmAnd::ZoomLevel OsmAnd::MapObjectsProvider_P::ClippedMapObject::getMaxZoomLevel() const
+{
+    return original->getMaxZoomLevel();
+}
+
+OsmAnd::MapObject::LayerType OsmAnd::MapObjectsProvider_P::ClippedMapObject::getLayerType() const
+{
+    return original->getLayerType();
+}
@@ -2,12 +2,13 @@
 #define _OSMAND_CORE_MAP_OBJECTS_PROVIDER_P_H_
 
 #include "stdlib_common.h"
+#include <mutex>
 
 #include "QtExtensions.h"
 #include "ignore_warnings_on_external_includes.h"
-#include <QMap>
+#include <QHash>
 #include <QList>
-#include <QMutex>
+#include <QVector>
 #include <QReadWriteLock>
 #include <QWaitCondition>
 #include "restore_internal_warnings.h"
@@ -18,11 +19,10 @@
 #include "TiledEntriesCollection.h"
 #include "MapObjectsProvider.h"
 #include "QuadTree.h"
+#include "MapObject.h"
 
 namespace OsmAnd
 {
-    class MapObject;
-
     class MapObjectsProvider_P Q_DECL_FINAL
     {
         Q_DISABLE_COPY_AND_MOVE(MapObjectsProvider_P);
@@ -31,27 +31,82 @@ namespace OsmAnd
     protected:
         MapObjectsProvider_P(MapObjectsProvider* const owner);
 
+        enum : int32_t {
+            SimplificationChunkSize = 1024,
+            // Pixels of tile, simplification drops points that are closer than half of pixel to simplified line
+            TileSizeInPixels = 256,
+            // Pieces of polylines are taken from tile enlarged by this part of tile size, so that joins are not visible
+            ClipMarginDivisor = 8,
+        };
+
         bool prepareData();
 
         typedef QuadTree< std::shared_ptr<const MapObject>, int32_t > MapObjectsTree;
 
+        // Points of polyline that are kept at each zoom are selected by their Douglas-Peucker significance,
+        // which is computed once on first request to any tile that polyline crosses. Deferred polylines have
+        // no points to keep it for, so they're simplified on each request
+        struct Polyline
+        {
+            Polyline();
+
+            const MapObjectsProvider::IDeferredPolyline* deferredPolyline;
+            std::once_flag pointsSignificanceComputed;
+            QVector<double> pointsSignificance;
+        };
+
         struct PreparedData
         {
             ZoomLevel minZoom;
             ZoomLevel maxZoom;
             AreaI bbox31;
 
-            struct DataByZoomLevel
-            {
-                AreaI bbox31;
+            // Single index for all zoom levels, objects are filtered by their zoom range on query
+            QList< std::shared_ptr<const MapObject> > mapObjectsList;
+            MapObjectsTree mapObjectsTree;
 
-                QList< std::shared_ptr<const MapObject> > mapObjectsList;
-                MapObjectsTree mapObjectsTree;
-            };
-            QMap<ZoomLevel, DataByZoomLevel> dataByZoomLevel;
+            // Filled in prepareData() and not modified after that, so lookups need no lock
+            QHash< const MapObject*, std::shared_ptr<Polyline> > polylines;
         };
         Ref<PreparedData> _preparedData;
 
+        static bool isPolyline(const MapObject& mapObject);
+        // Only chunks that may cross clip area get actual significance, points of other chunks except the ends
+        // are dropped at any zoom
+        static void computePointsSignificance(
+            const QVector<PointI>& points31,
+            const AreaI* const pClipArea31,
+            QVector<double>& outPointsSignificance);
+        static const QVector<double>& getPointsSignificance(const MapObject& mapObject, Polyline& polyline);
+        static void clipPolyline(
+            const std::shared_ptr<const MapObject>& mapObject,
+            const QVector<PointI>& points31,
+            const QVector<double>& pointsSignificance,
+            const TileId tileId,
+            const ZoomLevel zoom,
+            const AreaI& clipArea31,
+            QList< std::shared_ptr<const MapObject> >& outMapObjects);
+
+        // Piece of polyline that shares attributes with original object. Captions are kept only by single piece
+        // among all tiles, the one that contains middle point of polyline, so that name is not repeated on every tile
+        class ClippedMapObject : public MapObject
+        {
+            Q_DISABLE_COPY_AND_MOVE(ClippedMapObject);
+
+        private:
+        protected:
+        public:
+            ClippedMapObject(const std::shared_ptr<const MapObject>& original);
+            virtual ~ClippedMapObject();
+
+            const std::shared_ptr<const MapObject> original;
+
+            virtual bool obtainSortingKey(SortingKey& outKey) const Q_DECL_OVERRIDE;
+            virtual ZoomLevel getMinZoomLevel() const Q_DECL_OVERRIDE;
+            virtual ZoomLevel getMaxZoomLevel() const Q_DECL_OVERRIDE;
+            virtual LayerType getLayerType() const Q_DECL_OVERRIDE;
+        };
+
         enum class TileState
         {
             Undefined = -1,
@@ -136,7 +136,7 @@ bool OsmAnd::MapObjectsSymbolsProvider_P::obtainData(
                     // Collect intersection classes
                     for (const auto& intersectsWithClass : constOf(rasterizedSpriteSymbol->primitiveSymbol->intersectsWith))
                     {
-                        billboardRasterSymbol->intersectsWithClasses.insert(mapSymbolIntersectionClassesRegistry.getOrRegisterClassIdByName(intersectsWithClass));
+                        billboardRasterSymbol->intersectsWithClasses.set(mapSymbolIntersectionClassesRegistry.getOrRegisterClassIdByName(intersectsWithClass));
                     }
                 }
                 symbol.reset(billboardRasterSymbol);
@@ -157,7 +157,7 @@ bool OsmAnd::MapObjectsSymbolsProvider_P::obtainData(
                 onPathSymbol->glyphsWidth = rasterizedOnPathSymbol->glyphsWidth;
                 for (const auto& intersectsWithClass : constOf(rasterizedOnPathSymbol->primitiveSymbol->intersectsWith))
                 {
-                    onPathSymbol->intersectsWithClasses.insert(mapSymbolIntersectionClassesRegistry.getOrRegisterClassIdByName(intersectsWithClass));
+                    onPathSymbol->intersectsWithClasses.set(mapSymbolIntersectionClassesRegistry.getOrRegisterClassIdByName(intersectsWithClass));
                 }
                 symbol.reset(onPathSymbol);
             }
@@ -8,6 +8,7 @@
 
 #include "IMapObjectsProvider.h"
 #include "Stopwatch.h"
+#include "Tracing.h"
 #include "Utilities.h"
 #include "Logging.h"
 
@@ -26,6 +27,8 @@ bool OsmAnd::MapPrimitivesProvider_P::obtainData(
     std::shared_ptr<IMapDataProvider::Data>& outData,
     std::shared_ptr<Metric>* const pOutMetric)
 {
+    OSMAND_TRACE_SCOPE("MapPrimitivesProvider", "obtainData");
+
     if (pOutMetric)
     {
         if (!pOutMetric->get() || !dynamic_cast<MapPrimitivesProvider_Metrics::Metric_obtainData*>(pOutMetric->get()))
@@ -19,6 +19,7 @@
 #include "BinaryMapObject.h"
 #include "Road.h"
 #include "Stopwatch.h"
+#include "Tracing.h"
 #include "Utilities.h"
 #include "QKeyValueIterator.h"
 #include "QCachingIterator.h"
@@ -122,6 +123,8 @@ std::shared_ptr<OsmAnd::MapPrimitiviser_P::PrimitivisedObjects> OsmAnd::MapPrimi
     const std::shared_ptr<const IQueryController>& queryController,
     MapPrimitiviser_Metrics::Metric_primitiviseWithSurface* const metric)
 {
+    OSMAND_TRACE_SCOPE("MapPrimitiviser", "primitiviseWithSurface");
+
     const Stopwatch totalStopwatch(metric != nullptr);
 
     //////////////////////////////////////////////////////////////////////////
@@ -477,6 +480,8 @@ std::shared_ptr<OsmAnd::MapPrimitiviser_P::PrimitivisedObjects> OsmAnd::MapPrimi
     const std::shared_ptr<const IQueryController>& queryController,
     MapPrimitiviser_Metrics::Metric_primitiviseWithoutSurface* const metric)
 {
+    OSMAND_TRACE_SCOPE("MapPrimitiviser", "primitiviseWithoutSurface");
+
     const Stopwatch totalStopwatch(metric != nullptr);
 
     const Context context(owner->environment, zoom);
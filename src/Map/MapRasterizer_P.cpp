@@ -25,6 +25,7 @@
 #include "QKeyValueIterator.h"
 #include "QCachingIterator.h"
 #include "Stopwatch.h"
+#include "Tracing.h"
 #include "Utilities.h"
 #include "Logging.h"
 
@@ -57,6 +58,8 @@ void OsmAnd::MapRasterizer_P::rasterize(
     MapRasterizer_Metrics::Metric_rasterize* const metric,
     const std::shared_ptr<const IQueryController>& queryController)
 {
+    OSMAND_TRACE_SCOPE("MapRasterizer", "rasterize");
+
     const Stopwatch totalStopwatch(metric != nullptr);
 
     const Context context(
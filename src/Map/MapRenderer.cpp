@@ -902,6 +902,7 @@ void OsmAnd::MapRenderer::doPublishMapSymbol(
     symbolReferencedResources.insert(resource);
 
     _publishedMapSymbolsGroups[symbolGroup] += 1;
+    _publishedMapSymbolsVersion.fetchAndAddOrdered(1);
 
 #if OSMAND_LOG_MAP_SYMBOLS_REGISTRATION_LIFECYCLE
     LogPrintf(LogSeverityLevel::Debug,
@@ -978,6 +979,7 @@ void OsmAnd::MapRenderer::doUnpublishMapSymbol(
         assert(false);
         return;
     }
+    _publishedMapSymbolsVersion.fetchAndAddOrdered(1);
 #if OSMAND_LOG_MAP_SYMBOLS_REGISTRATION_LIFECYCLE
     const auto symbolReferencedResourcesSize = symbolReferencedResources.size();
 #endif // OSMAND_LOG_MAP_SYMBOLS_REGISTRATION_LIFECYCLE
@@ -1052,6 +1054,11 @@ bool OsmAnd::MapRenderer::validatePublishedMapSymbolsIntegrity()
     return integrityValid;
 }
 
+unsigned int OsmAnd::MapRenderer::getPublishedMapSymbolsVersion() const
+{
+    return _publishedMapSymbolsVersion.loadAcquire();
+}
+
 unsigned int OsmAnd::MapRenderer::getSymbolsCount() const
 {
     return _publishedMapSymbolsCount.loadAcquire();
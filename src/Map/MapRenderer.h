@@ -79,6 +79,7 @@ namespace OsmAnd
         PublishedMapSymbolsByOrder _publishedMapSymbolsByOrder;
         QHash< std::shared_ptr<const MapSymbolsGroup>, SmartPOD<unsigned int, 0> > _publishedMapSymbolsGroups;
         QAtomicInt _publishedMapSymbolsCount;
+        QAtomicInt _publishedMapSymbolsVersion;
         void doPublishMapSymbol(
             const std::shared_ptr<const MapSymbolsGroup>& symbolGroup,
             const std::shared_ptr<const MapSymbol>& symbol,
@@ -186,6 +187,8 @@ namespace OsmAnd
             const QList< PublishOrUnpublishMapSymbol >& mapSymbolsToPublish);
         void batchUnpublishMapSymbols(
             const QList< PublishOrUnpublishMapSymbol >& mapSymbolsToUnublish);
+        // Changes each time any map symbol is published or unpublished
+        unsigned int getPublishedMapSymbolsVersion() const;
 
         // General:
 
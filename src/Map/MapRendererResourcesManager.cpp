@@ -63,7 +63,10 @@
 
 OsmAnd::MapRendererResourcesManager::MapRendererResourcesManager(MapRenderer* const owner_)
     : _taskHostBridge(this)
-    , _resourcesRequestWorkerPool(Concurrent::WorkerPool::Order::LIFO)
+    , _resourcesRequestWorkerPool(
+        Concurrent::WorkerPool::Order::Priority,
+        QThread::idealThreadCount(),
+        Concurrent::WorkerPool::Scheduler::SharedWorkStealing)
     , _workerThreadIsAlive(false)
     , _workerThreadId(nullptr)
     , _workerThread(new Concurrent::Thread(std::bind(&MapRendererResourcesManager::workerThreadProcedure, this)))
@@ -74,6 +77,10 @@ OsmAnd::MapRendererResourcesManager::MapRendererResourcesManager(MapRenderer* co
     resetResourceWorkerThreadsLimit();
 
     _requestedResourcesTasks.reserve(1024);
+    _activeZoom = InvalidZoomLevel;
+    _prioritizedCenterTileId = TileId::zero();
+    _prioritizedZoom = InvalidZoomLevel;
+    _movementDirection = PointI(0, 0);
 
     // Start worker thread
     _workerThreadIsAlive = true;
@@ -632,6 +639,9 @@ void OsmAnd::MapRendererResourcesManager::requestNeededResources(
     const QVector<TileId>& activeTiles,
     const ZoomLevel activeZoom)
 {
+    // Hint depends on previous center, so it's prepared before center is updated below
+    updatePrefetchHint(centerTileId, activeTiles, activeZoom);
+
     _requestedResourcesTasks.resize(0);
     for (const auto& resourcesCollection : constOf(resourcesCollections))
     {
@@ -641,19 +651,25 @@ void OsmAnd::MapRendererResourcesManager::requestNeededResources(
         requestNeededResources(resourcesCollection, activeTiles, activeZoom);
     }
 
-    _resourcesRequestWorkerPool.enqueue(
-        _requestedResourcesTasks,
+    // Priority of each task is evaluated once on enqueue. Already queued tasks are re-evaluated
+    // (in linear time) only when center tile or zoom has changed
+    const auto reprioritize =
+        _prioritizedCenterTileId.id != centerTileId.id ||
+        _prioritizedZoom != activeZoom;
+    _prioritizedCenterTileId = centerTileId;
+    _prioritizedZoom = activeZoom;
+    _resourcesRequestWorkerPool.setPriorityFunction(
         [centerTileId, activeTiles, activeZoom]
-        (QRunnable* const l_, QRunnable* const r_) -> bool
+        (QRunnable* const runnable_) -> int64_t
         {
-            const auto l = static_cast<ResourceRequestTask*>(l_);
-            const auto r = static_cast<ResourceRequestTask*>(r_);
+            const auto runnable = static_cast<ResourceRequestTask*>(runnable_);
 
-            const auto lPriority = l->calculatePriority(centerTileId, activeTiles, activeZoom);
-            const auto rPriority = r->calculatePriority(centerTileId, activeTiles, activeZoom);
+            return runnable->calculatePriority(centerTileId, activeTiles, activeZoom);
+        },
+        reprioritize);
 
-            return lPriority < rPriority;
-        });
+    if (!_requestedResourcesTasks.isEmpty())
+        _resourcesRequestWorkerPool.enqueue(_requestedResourcesTasks);
 }
 
 void OsmAnd::MapRendererResourcesManager::requestNeededResources(
@@ -673,12 +689,111 @@ void OsmAnd::MapRendererResourcesManager::requestNeededResources(
             tiledResourcesCollection,
             activeTiles,
             activeZoom);
+
+        // Let provider download tiles that are likely to be needed next
+        if (resourcesCollection->getType() == MapRendererResourceType::MapLayer)
+        {
+            if (const auto tiledProvider = std::dynamic_pointer_cast<IMapTiledDataProvider>(mapDataProvider))
+                tiledProvider->prefetch(_prefetchHint);
+        }
     }
     else if (const auto keyedResourcesCollection =
             std::dynamic_pointer_cast<MapRendererKeyedResourcesCollection>(resourcesCollection))
     {
         requestNeededKeyedResources(
-            keyedResourcesCollection);
+            keyedResourcesCollection,
+            activeTiles,
+            activeZoom);
+    }
+}
+
+void OsmAnd::MapRendererResourcesManager::updatePrefetchHint(
+    const TileId centerTileId,
+    const QVector<TileId>& activeTiles,
+    const ZoomLevel activeZoom)
+{
+    _prefetchHint.tileIds.resize(0);
+    _prefetchHint.nextZoomTileIds.resize(0);
+    _prefetchHint.zoom = activeZoom;
+    if (activeTiles.isEmpty())
+        return;
+
+    // Direction of movement is kept while map stands still and is lost on zoom change
+    if (_prioritizedZoom != activeZoom)
+    {
+        _movementDirection = PointI(0, 0);
+    }
+    else if (_prioritizedCenterTileId.id != centerTileId.id)
+    {
+        _movementDirection.x = qBound(-1, centerTileId.x - _prioritizedCenterTileId.x, 1);
+        _movementDirection.y = qBound(-1, centerTileId.y - _prioritizedCenterTileId.y, 1);
+    }
+
+    int64_t minX = activeTiles.first().x;
+    int64_t minY = activeTiles.first().y;
+    int64_t maxX = minX;
+    int64_t maxY = minY;
+    for (const auto& activeTileId : constOf(activeTiles))
+    {
+        minX = qMin<int64_t>(minX, activeTileId.x);
+        minY = qMin<int64_t>(minY, activeTileId.y);
+        maxX = qMax<int64_t>(maxX, activeTileId.x);
+        maxY = qMax<int64_t>(maxY, activeTileId.y);
+    }
+
+    const auto tilesCount = static_cast<int64_t>(1) << activeZoom;
+    QSet<TileId> hintedTiles;
+    const auto hintTile =
+        [this, tilesCount, &hintedTiles]
+        (const int64_t x, const int64_t y)
+        {
+            if (x < 0 || y < 0 || x >= tilesCount || y >= tilesCount)
+                return;
+
+            const auto tileId = TileId::fromXY(static_cast<int32_t>(x), static_cast<int32_t>(y));
+            if (hintedTiles.contains(tileId))
+                return;
+            hintedTiles.insert(tileId);
+            _prefetchHint.tileIds.push_back(tileId);
+        };
+
+    // Tiles in direction of movement go first
+    for (int distance = 1; distance <= PrefetchLookAheadInTiles; distance++)
+    {
+        if (_movementDirection.x != 0)
+        {
+            const auto x = _movementDirection.x > 0 ? maxX + distance : minX - distance;
+            for (auto y = minY - 1; y <= maxY + 1; y++)
+                hintTile(x, y);
+        }
+        if (_movementDirection.y != 0)
+        {
+            const auto y = _movementDirection.y > 0 ? maxY + distance : minY - distance;
+            for (auto x = minX - 1; x <= maxX + 1; x++)
+                hintTile(x, y);
+        }
+    }
+
+    // Then ring of tiles around visible ones
+    for (auto x = minX - 1; x <= maxX + 1; x++)
+    {
+        hintTile(x, minY - 1);
+        hintTile(x, maxY + 1);
+    }
+    for (auto y = minY; y <= maxY; y++)
+    {
+        hintTile(minX - 1, y);
+        hintTile(maxX + 1, y);
+    }
+
+    // Zooming in most likely targets center of the screen
+    if (activeZoom < MaxZoomLevel)
+    {
+        for (auto dy = 0; dy <= 1; dy++)
+        {
+            for (auto dx = 0; dx <= 1; dx++)
+                _prefetchHint.nextZoomTileIds.push_back(TileId::fromXY(centerTileId.x * 2 + dx, centerTileId.y * 2 + dy));
+        }
     }
 }
 
@@ -888,7 +1003,9 @@ void OsmAnd::MapRendererResourcesManager::requestNeededTiledResources(
 }
 
 void OsmAnd::MapRendererResourcesManager::requestNeededKeyedResources(
-    const std::shared_ptr<MapRendererKeyedResourcesCollection>& resourcesCollection)
+    const std::shared_ptr<MapRendererKeyedResourcesCollection>& resourcesCollection,
+    const QVector<TileId>& activeTiles,
+    const ZoomLevel activeZoom)
 {
     // Get keyed provider
     std::shared_ptr<IMapDataProvider> provider_;
@@ -898,8 +1015,8 @@ void OsmAnd::MapRendererResourcesManager::requestNeededKeyedResources(
     if (!provider)
         return;
 
-    // Get list of keys this provider has and check that all are present
-    const auto& resourceKeys = provider->getProvidedDataKeys();
+    // Get list of keys this provider has for active zone and check that all are present
+    const auto& resourceKeys = provider->getProvidedDataKeysForTiles(activeTiles, activeZoom);
     for (const auto& resourceKey : constOf(resourceKeys))
     {
         // Obtain a resource entry and if it's state is "Unknown", create a task that will
@@ -1165,6 +1282,16 @@ bool OsmAnd::MapRendererResourcesManager::updatesPresent() const
 {
     bool updatesPresent = false;
 
+    // Local copy of active zone
+    QVector<TileId> activeTiles;
+    ZoomLevel activeZoom;
+    {
+        QMutexLocker scopedLocker(&_workerThreadWakeupMutex);
+
+        activeTiles = _activeTiles;
+        activeZoom = _activeZoom;
+    }
+
     for (const auto& resourcesCollections : constOf(_storageByType))
     {
         for (const auto& resourcesCollection : constOf(resourcesCollections))
@@ -1182,7 +1309,9 @@ bool OsmAnd::MapRendererResourcesManager::updatesPresent() const
                 {
                     const auto provider = std::static_pointer_cast<IMapKeyedDataProvider>(provider_);
 
-                    if (keyedResourcesCollection->getKeys().toSet() != provider->getProvidedDataKeys().toSet())
+                    // Only keys of active zone are requested, so e.g. clusters of other zooms are not expected
+                    const auto providedKeys = provider->getProvidedDataKeysForTiles(activeTiles, activeZoom);
+                    if (keyedResourcesCollection->getKeys().toSet() != providedKeys.toSet())
                         updatesPresent = true;
                 }
             }
@@ -1206,6 +1335,16 @@ bool OsmAnd::MapRendererResourcesManager::checkForUpdatesAndApply(const MapState
     bool updatesApplied = false;
     bool updatesPresent = false;
 
+    // Local copy of active zone
+    QVector<TileId> activeTiles;
+    ZoomLevel activeZoom;
+    {
+        QMutexLocker scopedLocker(&_workerThreadWakeupMutex);
+
+        activeTiles = _activeTiles;
+        activeZoom = _activeZoom;
+    }
+
     for (const auto& resourcesCollections : constOf(_storageByType))
     {
         for (const auto& resourcesCollection : constOf(resourcesCollections))
@@ -1223,7 +1362,9 @@ bool OsmAnd::MapRendererResourcesManager::checkForUpdatesAndApply(const MapState
                 {
                     const auto provider = std::static_pointer_cast<IMapKeyedDataProvider>(provider_);
 
-                    if (keyedResourcesCollection->getKeys().toSet() != provider->getProvidedDataKeys().toSet())
+                    // Only keys of active zone are requested, so e.g. clusters of other zooms are not expected
+                    const auto providedKeys = provider->getProvidedDataKeysForTiles(activeTiles, activeZoom);
+                    if (keyedResourcesCollection->getKeys().toSet() != providedKeys.toSet())
                         updatesPresent = true;
                 }
             }
@@ -1513,7 +1654,7 @@ void OsmAnd::MapRendererResourcesManager::cleanupJunkResources(
         if (dataProvider != nullptr && std::dynamic_pointer_cast<IMapRendererKeyedResourcesCollection>(resourcesCollection))
         {
             const auto keyedDataProvider = std::static_pointer_cast<IMapKeyedDataProvider>(dataProvider);
-            const auto providedKeysSet = keyedDataProvider->getProvidedDataKeys().toSet();
+            const auto providedKeysSet = keyedDataProvider->getProvidedDataKeysForTiles(activeTiles, activeZoom).toSet();
 
             resourcesCollection->removeResources(
                 [this, &needsResourcesUploadOrUnload, providedKeysSet]
@@ -40,6 +40,8 @@
 #include "HostedTask.h"
 #include "WorkerPool.h"
 #include "IQueryController.h"
+#include "IMapTiledDataProvider.h"
+#include "PointsAndAreas.h"
 
 namespace OsmAnd
 {
@@ -141,6 +143,17 @@ namespace OsmAnd
         QVector<TileId> _activeTiles;
         ZoomLevel _activeZoom;
         QVector<QRunnable*> _requestedResourcesTasks;
+        TileId _prioritizedCenterTileId;
+        ZoomLevel _prioritizedZoom;
+        enum : int {
+            PrefetchLookAheadInTiles = 2,
+        };
+        IMapTiledDataProvider::PrefetchHint _prefetchHint;
+        PointI _movementDirection;
+        void updatePrefetchHint(
+            const TileId centerTileId,
+            const QVector<TileId>& activeTiles,
+            const ZoomLevel activeZoom);
         bool updatesPresent() const;
         virtual bool checkForUpdatesAndApply(const MapState& mapState) const;
         void updateResources(
@@ -161,7 +174,9 @@ namespace OsmAnd
             const QVector<TileId>& tiles,
             const ZoomLevel zoom);
         void requestNeededKeyedResources(
-            const std::shared_ptr<MapRendererKeyedResourcesCollection>& resourcesCollection);
+            const std::shared_ptr<MapRendererKeyedResourcesCollection>& resourcesCollection,
+            const QVector<TileId>& tiles,
+            const ZoomLevel zoom);
         void requestNeededResource(
             const std::shared_ptr<MapRendererBaseResource>& resource);
         bool beginResourceRequestProcessing(const std::shared_ptr<MapRendererBaseResource>& resource);
@@ -15,6 +15,24 @@ OsmAnd::MapRendererStage::MapRendererStage(MapRenderer* const renderer_)
 {
 }
 
+OsmAnd::MapRendererStage::MapRendererStage(
+    MapRenderer* const renderer_,
+    const std::shared_ptr<const MapRendererConfiguration>& configuration_,
+    const MapRendererState& state_,
+    const MapRendererInternalState& internalState_,
+    const std::shared_ptr<const MapRendererDebugSettings>& debugSettings_)
+    : renderer(renderer_)
+    , gpuAPI(renderer->gpuAPI)
+    , setupOptions(renderer->setupOptions)
+    , currentConfiguration(configuration_)
+    , currentState(state_)
+    , internalState(internalState_)
+    , debugSettings(debugSettings_)
+    , publishedMapSymbolsByOrderLock(renderer->publishedMapSymbolsByOrderLock)
+    , publishedMapSymbolsByOrder(renderer->publishedMapSymbolsByOrder)
+{
+}
+
 OsmAnd::MapRendererStage::~MapRendererStage()
 {
 }
@@ -24,6 +42,11 @@ const OsmAnd::MapRendererResourcesManager& OsmAnd::MapRendererStage::getResource
     return renderer->getResources();
 }
 
+unsigned int OsmAnd::MapRendererStage::getPublishedMapSymbolsVersion() const
+{
+    return renderer->getPublishedMapSymbolsVersion();
+}
+
 void OsmAnd::MapRendererStage::invalidateFrame()
 {
     renderer->invalidateFrame();
@@ -24,6 +24,14 @@ namespace OsmAnd
         Q_DISABLE_COPY_AND_MOVE(MapRendererStage);
     protected:
         void invalidateFrame();
+
+        // Stage bound to given snapshot of state, instead of renderer's current one
+        MapRendererStage(
+            MapRenderer* const renderer,
+            const std::shared_ptr<const MapRendererConfiguration>& configuration,
+            const MapRendererState& state,
+            const MapRendererInternalState& internalState,
+            const std::shared_ptr<const MapRendererDebugSettings>& debugSettings);
     public:
         MapRendererStage(MapRenderer* const renderer);
         virtual ~MapRendererStage();
@@ -31,6 +39,7 @@ namespace OsmAnd
         MapRenderer* const renderer;
 
         const MapRendererResourcesManager& getResources() const;
+        unsigned int getPublishedMapSymbolsVersion() const;
 
         const std::unique_ptr<GPUAPI>& gpuAPI;
         const MapRendererSetupOptions& setupOptions;
@@ -1,6 +1,8 @@
 #include "MapSymbolIntersectionClassesRegistry_P.h"
 #include "MapSymbolIntersectionClassesRegistry.h"
 
+#include "Logging.h"
+
 OsmAnd::MapSymbolIntersectionClassesRegistry_P::MapSymbolIntersectionClassesRegistry_P(MapSymbolIntersectionClassesRegistry* const owner_)
     : owner(owner_)
     , anyClass(unsafeRegisterClassIdByName(QLatin1String("any")))
@@ -45,6 +47,17 @@ OsmAnd::MapSymbolIntersectionClassesRegistry_P::ClassId OsmAnd::MapSymbolInterse
 
 OsmAnd::MapSymbolIntersectionClassesRegistry_P::ClassId OsmAnd::MapSymbolIntersectionClassesRegistry_P::unsafeRegisterClassIdByName(const QString& className)
 {
+    if (_nameById.size() >= MaxMapSymbolIntersectionClassesCount)
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "Intersection class '%s' exceeds limit of %u classes, treated as 'any'",
+            qPrintable(className),
+            static_cast<unsigned int>(MaxMapSymbolIntersectionClassesCount));
+
+        _idByName[className] = anyClass;
+        return anyClass;
+    }
+
     const ClassId newId = _nameById.size();
     _nameById.push_back(className);
     _idByName[className] = newId;
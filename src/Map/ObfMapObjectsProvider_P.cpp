@@ -16,6 +16,7 @@
 #include "ObfRoutingSectionReader_Metrics.h"
 #include "Road.h"
 #include "Stopwatch.h"
+#include "Tracing.h"
 #include "Utilities.h"
 #include "Logging.h"
 
@@ -37,6 +38,8 @@ bool OsmAnd::ObfMapObjectsProvider_P::obtainData(
     std::shared_ptr<IMapDataProvider::Data>& outData,
     std::shared_ptr<Metric>* const pOutMetric)
 {
+    OSMAND_TRACE_SCOPE("ObfMapObjectsProvider", "obtainData");
+
     if (pOutMetric)
     {
         if (!pOutMetric->get() || !dynamic_cast<ObfMapObjectsProvider_Metrics::Metric_obtainData*>(pOutMetric->get()))
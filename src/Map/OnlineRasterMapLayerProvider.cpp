@@ -8,6 +8,7 @@
 #include "OsmAndCore.h"
 #include "MapDataProviderHelpers.h"
 #include "QRunnableFunctor.h"
+#include "FileTileStore.h"
 
 #include <Logging.h>
 
@@ -40,6 +41,7 @@ OsmAnd::OnlineRasterMapLayerProvider::OnlineRasterMapLayerProvider(
     _p->_localCachePath = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath(pathSuffix);
     if (_p->_localCachePath.isEmpty())
         _p->_localCachePath = QLatin1String(".");
+    _p->_localTileStore.reset(new FileTileStore(_p->_localCachePath));
 }
 
 OsmAnd::OnlineRasterMapLayerProvider::~OnlineRasterMapLayerProvider()
@@ -56,6 +58,19 @@ void OsmAnd::OnlineRasterMapLayerProvider::setLocalCachePath(
     _p->_localCachePath = appendPathSuffix
         ? QDir(localCachePath).absoluteFilePath(pathSuffix)
         : localCachePath;
+    _p->_localTileStore.reset(new FileTileStore(_p->_localCachePath));
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider::setLocalTileStore(const std::shared_ptr<ITileStore>& localTileStore)
+{
+    QMutexLocker scopedLocker(&_p->_localCachePathMutex);
+    _p->_localTileStore = localTileStore;
+}
+
+std::shared_ptr<OsmAnd::ITileStore> OsmAnd::OnlineRasterMapLayerProvider::getLocalTileStore() const
+{
+    QMutexLocker scopedLocker(&_p->_localCachePathMutex);
+    return _p->_localTileStore;
 }
 
 void OsmAnd::OnlineRasterMapLayerProvider::setNetworkAccessPermission(bool allowed)
@@ -63,6 +78,31 @@ void OsmAnd::OnlineRasterMapLayerProvider::setNetworkAccessPermission(bool allow
     _p->_networkAccessAllowed = allowed;
 }
 
+void OsmAnd::OnlineRasterMapLayerProvider::setPrefetchEnabled(const bool enabled)
+{
+    _p->setPrefetchEnabled(enabled);
+}
+
+bool OsmAnd::OnlineRasterMapLayerProvider::isPrefetchEnabled() const
+{
+    return _p->isPrefetchEnabled();
+}
+
+OsmAnd::OnlineRasterMapLayerProvider::PrefetchStatistics OsmAnd::OnlineRasterMapLayerProvider::getPrefetchStatistics() const
+{
+    return _p->getPrefetchStatistics();
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider::resetPrefetchStatistics()
+{
+    _p->resetPrefetchStatistics();
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider::prefetch(const PrefetchHint& hint)
+{
+    _p->prefetch(hint);
+}
+
 OsmAnd::MapStubStyle OsmAnd::OnlineRasterMapLayerProvider::getDesiredStubsStyle() const
 {
     return MapStubStyle::Unspecified;
@@ -163,3 +203,18 @@ OsmAnd::ZoomLevel OsmAnd::OnlineRasterMapLayerProvider::getMaxZoom() const
 {
     return maxZoom;
 }
+
+OsmAnd::OnlineRasterMapLayerProvider::PrefetchStatistics::PrefetchStatistics()
+    : startedCount(0)
+    , downloadedCount(0)
+    , usefulCount(0)
+    , wastedCount(0)
+    , cancelledCount(0)
+    , droppedCount(0)
+    , failedCount(0)
+{
+}
+
+OsmAnd::OnlineRasterMapLayerProvider::PrefetchStatistics::~PrefetchStatistics()
+{
+}
@@ -7,10 +7,8 @@
 #include <QCoreApplication>
 #include <QNetworkRequest>
 #include <QNetworkReply>
-#include <QFile>
 
 #include "ignore_warnings_on_external_includes.h"
-#include <SkStream.h>
 #include <SkImageDecoder.h>
 #include "restore_internal_warnings.h"
 
@@ -24,11 +22,16 @@ OsmAnd::OnlineRasterMapLayerProvider_P::OnlineRasterMapLayerProvider_P(
     : owner(owner_)
     , _downloadManager(downloadManager_)
     , _networkAccessAllowed(true)
+    , _prefetchEnabled(true)
 {
+    if (const auto webClient = std::dynamic_pointer_cast<const WebClient>(_downloadManager))
+        _prefetcher.reset(new Prefetcher(webClient));
 }
 
 OsmAnd::OnlineRasterMapLayerProvider_P::~OnlineRasterMapLayerProvider_P()
 {
+    if (_prefetcher)
+        _prefetcher->stop();
 }
 
 bool OsmAnd::OnlineRasterMapLayerProvider_P::obtainData(
@@ -52,58 +55,62 @@ bool OsmAnd::OnlineRasterMapLayerProvider_P::obtainData(
     // to mark that as being processed.
     lockTile(request.tileId, request.zoom);
 
+    // If tile is being prefetched, wait for that download instead of starting another one
+    if (_prefetcher)
+    {
+        if (const auto prefetchRequest = _prefetcher->claimTile(request.tileId, request.zoom))
+        {
+            prefetchRequest->waitUntilFinished();
+
+            const auto requestResult = prefetchRequest->getRequestResult();
+            if (requestResult && requestResult->isSuccessful())
+            {
+                unlockTile(request.tileId, request.zoom);
+                return decodeTile(request, prefetchRequest->getData(), outData);
+            }
+
+            const auto httpRequestResult = std::dynamic_pointer_cast<const IWebClient::IHttpRequestResult>(requestResult);
+            if (httpRequestResult && httpRequestResult->getHttpStatusCode() == 404)
+            {
+                unlockTile(request.tileId, request.zoom);
+                outData.reset();
+                return true;
+            }
+
+            // Otherwise tile is obtained as usual
+        }
+    }
+
     // Check if requested tile is already in local storage.
-    const auto tileLocalRelativePath =
-        QString::number(request.zoom) + QDir::separator() +
-        QString::number(request.tileId.x) + QDir::separator() +
-        QString::number(request.tileId.y) + QLatin1String(".tile");
-    QFileInfo localFile;
+    std::shared_ptr<ITileStore> localTileStore;
     {
         QMutexLocker scopedLocker(&_localCachePathMutex);
-        localFile.setFile(QDir(_localCachePath).absoluteFilePath(tileLocalRelativePath));
+        localTileStore = _localTileStore;
     }
-    if (localFile.exists())
+    QByteArray localData;
+    bool isLocalDataExpired = false;
+    const auto hasLocalData = localTileStore &&
+        localTileStore->obtainTile(request.tileId, request.zoom, localData, &isLocalDataExpired);
+
+    // Expired tile is used as-is when it can not be updated
+    if (hasLocalData && (!isLocalDataExpired || !_networkAccessAllowed))
     {
         // Since tile is in local storage, it's safe to unmark it as being processed
         unlockTile(request.tileId, request.zoom);
 
-        // If local file is empty, it means that requested tile does not exist (has no data)
-        if (localFile.size() == 0)
+        // If local data is empty, it means that requested tile does not exist (has no data)
+        if (localData.isEmpty())
         {
             outData.reset();
             return true;
         }
 
-        const std::shared_ptr<SkBitmap> bitmap(new SkBitmap());
-        SkFILEStream fileStream(qPrintable(localFile.absoluteFilePath()));
-        if (!SkImageDecoder::DecodeStream(
-                &fileStream,
-                bitmap.get(),
-                SkColorType::kUnknown_SkColorType,
-                SkImageDecoder::kDecodePixels_Mode))
+        if (!decodeTile(request, localData, outData))
         {
-            LogPrintf(LogSeverityLevel::Error,
-                "Failed to decode tile file '%s'",
-                qPrintable(localFile.absoluteFilePath()));
-
-            QFile tileFile(localFile.absoluteFilePath());
-            if (tileFile.exists())
-                tileFile.remove();
-
+            localTileStore->removeTile(request.tileId, request.zoom);
             return false;
         }
 
-        assert(bitmap->width() == bitmap->height());
-        assert(bitmap->width() == owner->tileSize);
-
-        // Return tile
-        outData.reset(new OnlineRasterMapLayerProvider::Data(
-            request.tileId,
-            request.zoom,
-            owner->alphaChannelPresence,
-            owner->getTileDensityFactor(),
-            bitmap));
-        
         return true;
     }
 
@@ -120,20 +127,10 @@ bool OsmAnd::OnlineRasterMapLayerProvider_P::obtainData(
     }
 
     // Perform synchronous download
-    const auto tileSize = (1u << request.zoom);
-    const auto tileUrl = QString(owner->urlPattern)
-        .replace(QLatin1String("${osm_zoom}"), QString::number(request.zoom))
-        .replace(QLatin1String("${osm_x}"), QString::number(request.tileId.x))
-        .replace(QLatin1String("${osm_x_inv}"), QString::number(tileSize - request.tileId.x - 1))
-        .replace(QLatin1String("${osm_y}"), QString::number(request.tileId.y))
-        .replace(QLatin1String("${osm_y_inv}"), QString::number(tileSize - request.tileId.y - 1))
-        .replace(QLatin1String("${quadkey}"), Utilities::getQuadKey(request.tileId.x, request.tileId.y, request.zoom));
+    const auto tileUrl = getTileUrl(request.tileId, request.zoom);
     std::shared_ptr<const IWebClient::IRequestResult> requestResult;
     const auto& downloadResult = _downloadManager->downloadData(tileUrl, &requestResult);
 
-    // Ensure that all directories are created in path to local tile
-    localFile.dir().mkpath(QLatin1String("."));
-
     // If there was error, check what the error was
     if (!requestResult->isSuccessful())
     {
@@ -144,33 +141,42 @@ bool OsmAnd::OnlineRasterMapLayerProvider_P::obtainData(
             qPrintable(tileUrl),
             httpStatus);
 
-        // 404 means that this tile does not exist, so create a zero file
+        // 404 means that this tile does not exist, so store it with empty data
         if (httpStatus == 404)
         {
-            // Save to a file
-            QFile tileFile(localFile.absoluteFilePath());
-            if (tileFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
-            {
-                tileFile.close();
-
-                // Unlock the tile
-                unlockTile(request.tileId, request.zoom);
-                return true;
-            }
-            else
+            if (localTileStore && !localTileStore->storeTile(request.tileId, request.zoom, QByteArray()))
             {
                 LogPrintf(LogSeverityLevel::Error,
-                    "Failed to mark tile as non-existent with empty file '%s'",
-                    qPrintable(localFile.absoluteFilePath()));
+                    "Failed to mark tile %dx%d@%d as non-existent",
+                    request.tileId.x,
+                    request.tileId.y,
+                    request.zoom);
 
                 // Unlock the tile
                 unlockTile(request.tileId, request.zoom);
                 return false;
             }
+
+            // Unlock the tile
+            unlockTile(request.tileId, request.zoom);
+            outData.reset();
+            return true;
         }
 
         // Unlock the tile
         unlockTile(request.tileId, request.zoom);
+
+        // Expired tile is still better than nothing
+        if (hasLocalData)
+        {
+            if (localData.isEmpty())
+            {
+                outData.reset();
+                return true;
+            }
+            return decodeTile(request, localData, outData);
+        }
+
         return false;
     }
 
@@ -179,39 +185,52 @@ bool OsmAnd::OnlineRasterMapLayerProvider_P::obtainData(
         "Downloaded tile from %s",
         qPrintable(tileUrl));
 
-    // Save to a file
-    QFile tileFile(localFile.absoluteFilePath());
-    if (tileFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    // Save to local storage
+    if (localTileStore && localTileStore->storeTile(request.tileId, request.zoom, downloadResult))
     {
-        tileFile.write(downloadResult);
-        tileFile.close();
-
         LogPrintf(LogSeverityLevel::Verbose,
-            "Saved tile from %s to %s",
-            qPrintable(tileUrl),
-            qPrintable(localFile.absoluteFilePath()));
-    }
-    else
-    {
-        LogPrintf(LogSeverityLevel::Error,
-            "Failed to save tile to '%s'",
-            qPrintable(localFile.absoluteFilePath()));
+            "Saved tile from %s to local storage",
+            qPrintable(tileUrl));
     }
 
     // Unlock tile, since local storage work is done
     unlockTile(request.tileId, request.zoom);
 
     // Decode in-memory
+    return decodeTile(request, downloadResult, outData);
+}
+
+QString OsmAnd::OnlineRasterMapLayerProvider_P::getTileUrl(const TileId tileId, const ZoomLevel zoom) const
+{
+    const auto tilesCount = (1u << zoom);
+    return QString(owner->urlPattern)
+        .replace(QLatin1String("${osm_zoom}"), QString::number(zoom))
+        .replace(QLatin1String("${osm_x}"), QString::number(tileId.x))
+        .replace(QLatin1String("${osm_x_inv}"), QString::number(tilesCount - tileId.x - 1))
+        .replace(QLatin1String("${osm_y}"), QString::number(tileId.y))
+        .replace(QLatin1String("${osm_y_inv}"), QString::number(tilesCount - tileId.y - 1))
+        .replace(QLatin1String("${quadkey}"), Utilities::getQuadKey(tileId.x, tileId.y, zoom));
+}
+
+bool OsmAnd::OnlineRasterMapLayerProvider_P::decodeTile(
+    const IMapDataProvider::Request& request_,
+    const QByteArray& data,
+    std::shared_ptr<IMapDataProvider::Data>& outData) const
+{
+    const auto& request = MapDataProviderHelpers::castRequest<OnlineRasterMapLayerProvider::Request>(request_);
+
     const std::shared_ptr<SkBitmap> bitmap(new SkBitmap());
     if (!SkImageDecoder::DecodeMemory(
-            downloadResult.constData(), downloadResult.size(),
+            data.constData(), data.size(),
             bitmap.get(),
             SkColorType::kUnknown_SkColorType,
             SkImageDecoder::kDecodePixels_Mode))
     {
         LogPrintf(LogSeverityLevel::Error,
-            "Failed to decode tile file from '%s'",
-            qPrintable(tileUrl));
+            "Failed to decode tile %dx%d@%d",
+            request.tileId.x,
+            request.tileId.y,
+            request.zoom);
 
         return false;
     }
@@ -247,3 +266,354 @@ void OsmAnd::OnlineRasterMapLayerProvider_P::unlockTile(const TileId tileId, con
 
     _waitUntilAnyTileIsProcessed.wakeAll();
 }
+
+void OsmAnd::OnlineRasterMapLayerProvider_P::setPrefetchEnabled(const bool enabled)
+{
+    _prefetchEnabled = enabled;
+
+    if (!enabled && _prefetcher)
+        _prefetcher->setQueue(QList<Prefetcher::QueuedTile>(), nullptr);
+}
+
+bool OsmAnd::OnlineRasterMapLayerProvider_P::isPrefetchEnabled() const
+{
+    return _prefetchEnabled;
+}
+
+OsmAnd::OnlineRasterMapLayerProvider_P::PrefetchStatistics OsmAnd::OnlineRasterMapLayerProvider_P::getPrefetchStatistics() const
+{
+    if (!_prefetcher)
+        return PrefetchStatistics();
+
+    return _prefetcher->getStatistics();
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider_P::resetPrefetchStatistics()
+{
+    if (_prefetcher)
+        _prefetcher->resetStatistics();
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider_P::prefetch(const IMapTiledDataProvider::PrefetchHint& hint)
+{
+    if (!_prefetcher || !_prefetchEnabled || !_networkAccessAllowed || hint.zoom == InvalidZoomLevel)
+        return;
+
+    // Prefetched tiles have to be kept somewhere
+    std::shared_ptr<ITileStore> localTileStore;
+    {
+        QMutexLocker scopedLocker(&_localCachePathMutex);
+        localTileStore = _localTileStore;
+    }
+    if (!localTileStore)
+        return;
+
+    QList<Prefetcher::QueuedTile> queue;
+    std::array< QSet<TileId>, ZoomLevelsCount > queuedTiles;
+    const auto enqueue =
+        [this, &queue, &queuedTiles, &localTileStore]
+        (const QVector<TileId>& tileIds, const ZoomLevel zoom)
+        {
+            if (zoom < owner->minZoom || zoom > owner->maxZoom)
+                return;
+
+            for (const auto& tileId : constOf(tileIds))
+            {
+                if (queue.size() >= MaxQueuedPrefetches)
+                    return;
+                if (queuedTiles[zoom].contains(tileId))
+                    continue;
+
+                // Tiles that are fresh in local storage or are being obtained right now are not needed
+                bool isExpired = false;
+                if (localTileStore->containsTile(tileId, zoom, &isExpired) && !isExpired)
+                    continue;
+                {
+                    QMutexLocker scopedLocker(&_tilesInProcessMutex);
+                    if (_tilesInProcess[zoom].contains(tileId))
+                        continue;
+                }
+
+                Prefetcher::QueuedTile queuedTile;
+                queuedTile.tileId = tileId;
+                queuedTile.zoom = zoom;
+                queuedTile.url = getTileUrl(tileId, zoom);
+                queue.push_back(queuedTile);
+                queuedTiles[zoom].insert(tileId);
+            }
+        };
+    enqueue(hint.tileIds, hint.zoom);
+    if (hint.zoom < MaxZoomLevel)
+        enqueue(hint.nextZoomTileIds, static_cast<ZoomLevel>(hint.zoom + 1));
+
+    _prefetcher->setQueue(queue, localTileStore);
+}
+
+OsmAnd::OnlineRasterMapLayerProvider_P::Prefetcher::Prefetcher(const std::shared_ptr<const WebClient>& webClient_)
+    : _inFlightTilesCount(0)
+    , _unusedTilesCount(0)
+    , _lastRequestId(0)
+    , webClient(webClient_)
+{
+}
+
+OsmAnd::OnlineRasterMapLayerProvider_P::Prefetcher::~Prefetcher()
+{
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider_P::Prefetcher::setQueue(
+    const QList<QueuedTile>& queue,
+    const std::shared_ptr<ITileStore>& tileStore)
+{
+    QList< std::shared_ptr<WebClient::AsyncRequest> > cancelledRequests;
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        _tileStore = tileStore;
+
+        std::array< QSet<TileId>, ZoomLevelsCount > hintedTiles;
+        for (const auto& queuedTile : constOf(queue))
+            hintedTiles[queuedTile.zoom].insert(queuedTile.tileId);
+
+        for (const auto& queuedTile : constOf(_queue))
+        {
+            if (!hintedTiles[queuedTile.zoom].contains(queuedTile.tileId))
+                _statistics.droppedCount++;
+        }
+
+        // Viewport moved away from tiles that are being downloaded, unless someone waits for them
+        for (auto zoom = MinZoomLevel; zoom <= MaxZoomLevel; zoom = static_cast<ZoomLevel>(zoom + 1))
+        {
+            auto itInFlightTile = mutableIteratorOf(_inFlightTiles[zoom]);
+            while (itInFlightTile.hasNext())
+            {
+                const auto& inFlightTile = itInFlightTile.next();
+                if (inFlightTile.value().isClaimed || hintedTiles[zoom].contains(inFlightTile.key()))
+                    continue;
+
+                if (inFlightTile.value().request)
+                    cancelledRequests.push_back(inFlightTile.value().request);
+                itInFlightTile.remove();
+                _inFlightTilesCount--;
+                _statistics.cancelledCount++;
+            }
+        }
+
+        _queue.clear();
+        for (const auto& queuedTile : constOf(queue))
+        {
+            if (_inFlightTiles[queuedTile.zoom].contains(queuedTile.tileId) ||
+                _unusedTiles[queuedTile.zoom].contains(queuedTile.tileId))
+            {
+                continue;
+            }
+
+            _queue.push_back(queuedTile);
+        }
+    }
+
+    for (const auto& request : constOf(cancelledRequests))
+        request->cancel();
+
+    startQueued();
+}
+
+std::shared_ptr<OsmAnd::WebClient::AsyncRequest> OsmAnd::OnlineRasterMapLayerProvider_P::Prefetcher::claimTile(
+    const TileId tileId,
+    const ZoomLevel zoom)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    const auto itInFlightTile = _inFlightTiles[zoom].find(tileId);
+    if (itInFlightTile != _inFlightTiles[zoom].end())
+    {
+        // Download may be not yet started, then requester downloads it on its own
+        if (!itInFlightTile->request)
+            return nullptr;
+
+        itInFlightTile->isClaimed = true;
+        return itInFlightTile->request;
+    }
+
+    if (_unusedTiles[zoom].remove(tileId))
+    {
+        _unusedTilesCount--;
+        _statistics.usefulCount++;
+        return nullptr;
+    }
+
+    // Requester is going to download queued tile right now
+    auto itQueuedTile = mutableIteratorOf(_queue);
+    while (itQueuedTile.hasNext())
+    {
+        const auto& queuedTile = itQueuedTile.next();
+        if (queuedTile.zoom == zoom && queuedTile.tileId == tileId)
+        {
+            itQueuedTile.remove();
+            break;
+        }
+    }
+
+    return nullptr;
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider_P::Prefetcher::stop()
+{
+    QList< std::shared_ptr<WebClient::AsyncRequest> > cancelledRequests;
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        _statistics.droppedCount += _queue.size();
+        _queue.clear();
+        for (auto& inFlightTiles : _inFlightTiles)
+        {
+            for (const auto& inFlightTile : constOf(inFlightTiles))
+            {
+                if (inFlightTile.request)
+                    cancelledRequests.push_back(inFlightTile.request);
+                _statistics.cancelledCount++;
+            }
+            inFlightTiles.clear();
+        }
+        _inFlightTilesCount = 0;
+        _tileStore.reset();
+    }
+
+    for (const auto& request : constOf(cancelledRequests))
+        request->cancel();
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider_P::Prefetcher::startQueued()
+{
+    QList< std::pair<QueuedTile, uint64_t> > startedTiles;
+    std::shared_ptr<ITileStore> tileStore;
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        if (!_tileStore)
+            return;
+        tileStore = _tileStore;
+
+        while (_inFlightTilesCount < MaxConcurrentPrefetches && !_queue.isEmpty())
+        {
+            const auto queuedTile = _queue.takeFirst();
+
+            // Request itself is set once started, since it may finish right away
+            InFlightTile inFlightTile;
+            inFlightTile.id = ++_lastRequestId;
+            inFlightTile.isClaimed = false;
+            _inFlightTiles[queuedTile.zoom].insert(queuedTile.tileId, inFlightTile);
+            _inFlightTilesCount++;
+            _statistics.startedCount++;
+
+            startedTiles.push_back(std::make_pair(queuedTile, inFlightTile.id));
+        }
+    }
+
+    const std::weak_ptr<Prefetcher> weakThis(shared_from_this());
+    for (const auto& startedTile : constOf(startedTiles))
+    {
+        const auto tileId = startedTile.first.tileId;
+        const auto zoom = startedTile.first.zoom;
+        const auto requestId = startedTile.second;
+        const auto request = webClient->downloadDataAsync(startedTile.first.url,
+            [weakThis, tileId, zoom, requestId, tileStore]
+            (const QByteArray& data, const std::shared_ptr<const IWebClient::IRequestResult>& requestResult)
+            {
+                if (const auto prefetcher = weakThis.lock())
+                    prefetcher->onRequestFinished(tileId, zoom, requestId, tileStore, data, requestResult);
+            });
+
+        auto cancelRequest = false;
+        {
+            QMutexLocker scopedLocker(&_mutex);
+
+            const auto itInFlightTile = _inFlightTiles[zoom].find(tileId);
+            if (itInFlightTile != _inFlightTiles[zoom].end() && itInFlightTile->id == requestId)
+                itInFlightTile->request = request;
+            else
+                cancelRequest = true;
+        }
+
+        // Tile was cancelled (or request has already finished) in the meantime
+        if (cancelRequest)
+            request->cancel();
+    }
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider_P::Prefetcher::onRequestFinished(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const uint64_t requestId,
+    const std::shared_ptr<ITileStore>& tileStore,
+    const QByteArray& data,
+    const std::shared_ptr<const IWebClient::IRequestResult>& requestResult)
+{
+    bool isClaimed;
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        // Cancelled tiles were already removed
+        const auto itInFlightTile = _inFlightTiles[zoom].find(tileId);
+        if (itInFlightTile == _inFlightTiles[zoom].end() || itInFlightTile->id != requestId)
+            return;
+
+        isClaimed = itInFlightTile->isClaimed;
+        _inFlightTiles[zoom].erase(itInFlightTile);
+        _inFlightTilesCount--;
+    }
+
+    const auto isSuccessful = requestResult && requestResult->isSuccessful();
+    const auto httpRequestResult = std::dynamic_pointer_cast<const IWebClient::IHttpRequestResult>(requestResult);
+    const auto doesNotExist = !isSuccessful && httpRequestResult && httpRequestResult->getHttpStatusCode() == 404;
+    if (isSuccessful || doesNotExist)
+    {
+        tileStore->storeTile(tileId, zoom, isSuccessful ? data : QByteArray());
+
+        QMutexLocker scopedLocker(&_mutex);
+
+        _statistics.downloadedCount++;
+        if (isClaimed)
+        {
+            _statistics.usefulCount++;
+        }
+        else
+        {
+            if (_unusedTilesCount >= MaxUnusedPrefetchedTiles)
+            {
+                for (auto& unusedTiles : _unusedTiles)
+                    unusedTiles.clear();
+                _unusedTilesCount = 0;
+            }
+            _unusedTiles[zoom].insert(tileId);
+            _unusedTilesCount++;
+        }
+    }
+    else
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        _statistics.failedCount++;
+    }
+
+    startQueued();
+}
+
+OsmAnd::OnlineRasterMapLayerProvider_P::PrefetchStatistics OsmAnd::OnlineRasterMapLayerProvider_P::Prefetcher::getStatistics() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    auto statistics = _statistics;
+    // Tiles downloaded before statistics were reset may be used after that
+    statistics.wastedCount = statistics.downloadedCount > statistics.usefulCount
+        ? statistics.downloadedCount - statistics.usefulCount
+        : 0;
+    return statistics;
+}
+
+void OsmAnd::OnlineRasterMapLayerProvider_P::Prefetcher::resetStatistics()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    _statistics = PrefetchStatistics();
+}
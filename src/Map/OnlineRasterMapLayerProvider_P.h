@@ -6,6 +6,8 @@
 
 #include "QtExtensions.h"
 #include <QSet>
+#include <QHash>
+#include <QList>
 #include <QDir>
 #include <QUrl>
 #include <QNetworkReply>
@@ -19,11 +21,81 @@
 #include "IRasterMapLayerProvider.h"
 #include "OnlineRasterMapLayerProvider.h"
 #include "IWebClient.h"
+#include "WebClient.h"
+#include "ITileStore.h"
 
 namespace OsmAnd
 {
     class OnlineRasterMapLayerProvider_P Q_DECL_FINAL
     {
+    public:
+        typedef OnlineRasterMapLayerProvider::PrefetchStatistics PrefetchStatistics;
+
+        enum : int {
+            // Prefetch leaves rest of per-host connections to tiles that are needed right now
+            MaxConcurrentPrefetches = 2,
+            MaxQueuedPrefetches = 64,
+            // Prefetched tiles that were not requested are forgotten after this many (still counted as wasted)
+            MaxUnusedPrefetchedTiles = 1024,
+        };
+
+        // Downloads hinted tiles in background and puts them to local tile store. Download callbacks
+        // hold only weak reference, so prefetcher may be destroyed while requests are still finishing
+        class Prefetcher Q_DECL_FINAL : public std::enable_shared_from_this<Prefetcher>
+        {
+            Q_DISABLE_COPY_AND_MOVE(Prefetcher);
+        public:
+            struct QueuedTile
+            {
+                TileId tileId;
+                ZoomLevel zoom;
+                QString url;
+            };
+
+        private:
+            struct InFlightTile
+            {
+                uint64_t id;
+                std::shared_ptr<WebClient::AsyncRequest> request;
+                // Tile was requested while being prefetched, so result is taken by requester
+                bool isClaimed;
+            };
+
+            mutable QMutex _mutex;
+            std::shared_ptr<ITileStore> _tileStore;
+            QList<QueuedTile> _queue;
+            std::array< QHash<TileId, InFlightTile>, ZoomLevelsCount > _inFlightTiles;
+            unsigned int _inFlightTilesCount;
+            std::array< QSet<TileId>, ZoomLevelsCount > _unusedTiles;
+            unsigned int _unusedTilesCount;
+            uint64_t _lastRequestId;
+            PrefetchStatistics _statistics;
+
+            void startQueued();
+            void onRequestFinished(
+                const TileId tileId,
+                const ZoomLevel zoom,
+                const uint64_t requestId,
+                const std::shared_ptr<ITileStore>& tileStore,
+                const QByteArray& data,
+                const std::shared_ptr<const IWebClient::IRequestResult>& requestResult);
+        protected:
+        public:
+            Prefetcher(const std::shared_ptr<const WebClient>& webClient);
+            ~Prefetcher();
+
+            const std::shared_ptr<const WebClient> webClient;
+
+            // Queue is replaced, tiles that are no longer hinted are dropped or cancelled
+            void setQueue(const QList<QueuedTile>& queue, const std::shared_ptr<ITileStore>& tileStore);
+            // Returns request if tile is being prefetched, result of that request is then up to caller
+            std::shared_ptr<WebClient::AsyncRequest> claimTile(const TileId tileId, const ZoomLevel zoom);
+            void stop();
+
+            PrefetchStatistics getStatistics() const;
+            void resetStatistics();
+        };
+
     private:
     protected:
         OnlineRasterMapLayerProvider_P(
@@ -34,14 +106,24 @@ namespace OsmAnd
 
         mutable QMutex _localCachePathMutex;
         QString _localCachePath;
+        std::shared_ptr<ITileStore> _localTileStore;
         bool _networkAccessAllowed;
 
+        std::shared_ptr<Prefetcher> _prefetcher;
+        volatile bool _prefetchEnabled;
+
         mutable QMutex _tilesInProcessMutex;
         std::array< QSet< TileId >, ZoomLevelsCount > _tilesInProcess;
         QWaitCondition _waitUntilAnyTileIsProcessed;
 
         void lockTile(const TileId tileId, const ZoomLevel zoom);
         void unlockTile(const TileId tileId, const ZoomLevel zoom);
+
+        QString getTileUrl(const TileId tileId, const ZoomLevel zoom) const;
+        bool decodeTile(
+            const IMapDataProvider::Request& request,
+            const QByteArray& data,
+            std::shared_ptr<IMapDataProvider::Data>& outData) const;
     public:
         virtual ~OnlineRasterMapLayerProvider_P();
 
@@ -52,6 +134,12 @@ namespace OsmAnd
             std::shared_ptr<IMapDataProvider::Data>& outData,
             std::shared_ptr<Metric>* const pOutMetric);
 
+        void setPrefetchEnabled(const bool enabled);
+        bool isPrefetchEnabled() const;
+        PrefetchStatistics getPrefetchStatistics() const;
+        void resetPrefetchStatistics();
+        void prefetch(const IMapTiledDataProvider::PrefetchHint& hint);
+
     friend class OsmAnd::OnlineRasterMapLayerProvider;
     };
 }
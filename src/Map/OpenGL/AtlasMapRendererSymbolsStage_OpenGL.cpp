@@ -197,6 +197,8 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderOnSurfaceSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::release(const bool gpuContextLost)
 {
+    releaseSymbolsPlacementWorker();
+
     bool ok = true;
     ok = ok && releaseBillboardRaster(gpuContextLost);
     ok = ok && releaseOnPath(gpuContextLost);
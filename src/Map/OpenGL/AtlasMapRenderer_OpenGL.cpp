@@ -334,6 +334,11 @@ OsmAnd::MapRendererInternalState& OsmAnd::AtlasMapRenderer_OpenGL::getInternalSt
     return _internalState;
 }
 
+OsmAnd::MapRendererInternalState* OsmAnd::AtlasMapRenderer_OpenGL::createInternalState() const
+{
+    return new InternalState();
+}
+
 void OsmAnd::AtlasMapRenderer_OpenGL::updateFrustum(InternalState* internalState, const MapRendererState& state) const
 {
     // 4 points of frustum near clipping box in camera coordinate space
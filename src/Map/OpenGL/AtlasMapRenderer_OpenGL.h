@@ -38,6 +38,7 @@ namespace OsmAnd
         virtual MapRendererInternalState* getInternalStateRef();
         virtual const MapRendererInternalState& getInternalState() const;
         virtual MapRendererInternalState& getInternalState();
+        virtual MapRendererInternalState* createInternalState() const;
         virtual bool updateInternalState(
             MapRendererInternalState& outInternalState,
             const MapRendererState& state,
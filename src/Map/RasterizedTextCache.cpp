@@ -0,0 +1,86 @@
+#include "RasterizedTextCache.h"
+#include "RasterizedTextCache_P.h"
+
+#include "RasterizedTextCache_private.h"
+
+OsmAnd::RasterizedTextCache::RasterizedTextCache(const unsigned int capacityInBytes /*= DefaultCapacityInBytes*/)
+    : _p(new RasterizedTextCache_P(this, capacityInBytes))
+{
+}
+
+OsmAnd::RasterizedTextCache::~RasterizedTextCache()
+{
+}
+
+unsigned int OsmAnd::RasterizedTextCache::capacityInBytes() const
+{
+    return _p->capacityInBytes();
+}
+
+void OsmAnd::RasterizedTextCache::setCapacityInBytes(const unsigned int capacityInBytes)
+{
+    _p->setCapacityInBytes(capacityInBytes);
+}
+
+OsmAnd::RasterizedTextCache::Statistics OsmAnd::RasterizedTextCache::getStatistics() const
+{
+    return _p->getStatistics();
+}
+
+void OsmAnd::RasterizedTextCache::resetStatistics()
+{
+    _p->resetStatistics();
+}
+
+void OsmAnd::RasterizedTextCache::clear()
+{
+    _p->clear();
+}
+
+static std::shared_ptr<OsmAnd::RasterizedTextCache> s_defaultRasterizedTextCache;
+std::shared_ptr<OsmAnd::RasterizedTextCache> OsmAnd::RasterizedTextCache::getDefault()
+{
+    return s_defaultRasterizedTextCache;
+}
+
+void OsmAnd::RasterizedTextCache_initializeGlobalInstance()
+{
+    s_defaultRasterizedTextCache.reset(new RasterizedTextCache());
+}
+
+void OsmAnd::RasterizedTextCache_releaseGlobalInstance()
+{
+    s_defaultRasterizedTextCache.reset();
+}
+
+OsmAnd::RasterizedTextCache::Statistics::Statistics()
+    : hits(0)
+    , misses(0)
+    , evictions(0)
+    , entriesCount(0)
+    , sizeInBytes(0)
+    , capacityInBytes(0)
+{
+}
+
+float OsmAnd::RasterizedTextCache::Statistics::getHitRatio() const
+{
+    const auto lookups = hits + misses;
+    if (lookups == 0)
+        return 0.0f;
+    return static_cast<float>(static_cast<double>(hits) / static_cast<double>(lookups));
+}
+
+QString OsmAnd::RasterizedTextCache::Statistics::toString(const QString& prefix /*= QString::null*/) const
+{
+    QString output;
+
+    output += prefix + QString(QLatin1String("hits = %1")).arg(hits);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("misses = %1")).arg(misses);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("hit ratio = %1%")).arg(getHitRatio() * 100.0f, 0, 'f', 1);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("evictions = %1")).arg(evictions);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("entries = %1")).arg(entriesCount);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("size = %1 of %2 bytes")).arg(sizeInBytes).arg(capacityInBytes);
+
+    return output;
+}
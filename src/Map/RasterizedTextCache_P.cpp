@@ -0,0 +1,144 @@
+#include "RasterizedTextCache_P.h"
+#include "RasterizedTextCache.h"
+
+OsmAnd::RasterizedTextCache_P::RasterizedTextCache_P(RasterizedTextCache* const owner_, const unsigned int capacityInBytes)
+    : _cache(static_cast<int>(capacityInBytes))
+    , _hits(0)
+    , _misses(0)
+    , _evictions(0)
+    , owner(owner_)
+{
+}
+
+OsmAnd::RasterizedTextCache_P::~RasterizedTextCache_P()
+{
+}
+
+unsigned int OsmAnd::RasterizedTextCache_P::capacityInBytes() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return static_cast<unsigned int>(_cache.maxCost());
+}
+
+void OsmAnd::RasterizedTextCache_P::setCapacityInBytes(const unsigned int capacityInBytes)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    const auto countBefore = _cache.count();
+    _cache.setMaxCost(static_cast<int>(capacityInBytes));
+    _evictions += countBefore - _cache.count();
+}
+
+OsmAnd::RasterizedTextCache_P::Statistics OsmAnd::RasterizedTextCache_P::getStatistics() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    Statistics statistics;
+    statistics.hits = _hits;
+    statistics.misses = _misses;
+    statistics.evictions = _evictions;
+    statistics.entriesCount = _cache.count();
+    statistics.sizeInBytes = _cache.totalCost();
+    statistics.capacityInBytes = _cache.maxCost();
+    return statistics;
+}
+
+void OsmAnd::RasterizedTextCache_P::resetStatistics()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
+
+void OsmAnd::RasterizedTextCache_P::clear()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    _cache.clear();
+}
+
+bool OsmAnd::RasterizedTextCache_P::obtain(const Key& key, Entry& outEntry)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    const auto pEntry = _cache.object(key);
+    if (!pEntry)
+    {
+        _misses++;
+        return false;
+    }
+
+    _hits++;
+    outEntry = *pEntry;
+    return true;
+}
+
+void OsmAnd::RasterizedTextCache_P::insert(const Key& key, const Entry& entry)
+{
+    const auto sizeInBytes = static_cast<int>(entry.getSizeInBytes());
+    const auto pEntry = new Entry(entry);
+
+    QMutexLocker scopedLocker(&_mutex);
+
+    // Another thread may have rasterized same text concurrently, in that case entry gets replaced
+    const auto countBefore = _cache.count() - (_cache.contains(key) ? 1 : 0);
+    const auto inserted = _cache.insert(key, pEntry, sizeInBytes);
+    _evictions += countBefore - (_cache.count() - (inserted ? 1 : 0));
+}
+
+OsmAnd::RasterizedTextCache_P::Key::Key()
+    : scaleFactor(1.0f)
+    , withGlyphsWidth(false)
+{
+}
+
+bool OsmAnd::RasterizedTextCache_P::Key::operator==(const Key& that) const
+{
+    return
+        textRasterizer == that.textRasterizer &&
+        withGlyphsWidth == that.withGlyphsWidth &&
+        qFuzzyCompare(scaleFactor, that.scaleFactor) &&
+        style.wrapWidth == that.style.wrapWidth &&
+        qFuzzyCompare(style.size, that.style.size) &&
+        style.bold == that.style.bold &&
+        style.italic == that.style.italic &&
+        style.color == that.style.color &&
+        style.haloRadius == that.style.haloRadius &&
+        style.haloColor == that.style.haloColor &&
+        style.textAlignment == that.style.textAlignment &&
+        backgroundLayers == that.backgroundLayers &&
+        text == that.text;
+}
+
+OsmAnd::RasterizedTextCache_P::Entry::Entry()
+    : extraTopSpace(0.0f)
+    , extraBottomSpace(0.0f)
+    , lineSpacing(0.0f)
+{
+}
+
+unsigned int OsmAnd::RasterizedTextCache_P::Entry::getSizeInBytes() const
+{
+    auto sizeInBytes = sizeof(Entry) + glyphsWidth.size() * sizeof(SkScalar);
+    if (bitmap)
+        sizeInBytes += bitmap->getSize();
+    return static_cast<unsigned int>(sizeInBytes);
+}
+
+uint OsmAnd::qHash(const RasterizedTextCache_P::Key& key, uint seed /*= 0*/) Q_DECL_NOTHROW
+{
+    auto hash = ::qHash(key.text, seed);
+    hash = hash * 31 + ::qHash(key.textRasterizer.get());
+    hash = hash * 31 + static_cast<uint>(key.style.wrapWidth);
+    hash = hash * 31 + ::qHash(static_cast<int>(key.style.size * 64.0f));
+    hash = hash * 31 + (key.style.bold ? 1u : 0u) + (key.style.italic ? 2u : 0u) + (key.withGlyphsWidth ? 4u : 0u);
+    hash = hash * 31 + key.style.color.argb;
+    hash = hash * 31 + key.style.haloRadius;
+    hash = hash * 31 + key.style.haloColor.argb;
+    for (const auto& backgroundLayer : constOf(key.backgroundLayers))
+        hash = hash * 31 + ::qHash(backgroundLayer.get());
+    return hash;
+}
@@ -0,0 +1,96 @@
+#ifndef _OSMAND_CORE_RASTERIZED_TEXT_CACHE_P_H_
+#define _OSMAND_CORE_RASTERIZED_TEXT_CACHE_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QCache>
+#include <QMutex>
+#include "restore_internal_warnings.h"
+
+#include "ignore_warnings_on_external_includes.h"
+#include <SkBitmap.h>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "TextRasterizer.h"
+#include "RasterizedTextCache.h"
+
+namespace OsmAnd
+{
+    class RasterizedTextCache_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RasterizedTextCache_P);
+
+    public:
+        typedef RasterizedTextCache::Statistics Statistics;
+
+        struct Key Q_DECL_FINAL
+        {
+            Key();
+
+            // Rasterizer is held to keep its address from being reused by another one with different fonts
+            std::shared_ptr<const TextRasterizer> textRasterizer;
+            QString text;
+
+            // Style without background bitmap, since it's produced from layers below
+            TextRasterizer::Style style;
+
+            // Shield and underlay icon bitmaps, as obtained from presentation environment by their names.
+            // Environment caches them, so same names of same environment give same pointers
+            QList< std::shared_ptr<const SkBitmap> > backgroundLayers;
+            float scaleFactor;
+            bool withGlyphsWidth;
+
+            bool operator==(const Key& that) const;
+        };
+
+        struct Entry Q_DECL_FINAL
+        {
+            Entry();
+
+            std::shared_ptr<const SkBitmap> bitmap;
+            QVector<SkScalar> glyphsWidth;
+            float extraTopSpace;
+            float extraBottomSpace;
+            float lineSpacing;
+
+            unsigned int getSizeInBytes() const;
+        };
+
+    private:
+        mutable QMutex _mutex;
+        QCache<Key, Entry> _cache;
+        uint64_t _hits;
+        uint64_t _misses;
+        uint64_t _evictions;
+    protected:
+        RasterizedTextCache_P(RasterizedTextCache* const owner, const unsigned int capacityInBytes);
+    public:
+        ~RasterizedTextCache_P();
+
+        ImplementationInterface<RasterizedTextCache> owner;
+
+        unsigned int capacityInBytes() const;
+        void setCapacityInBytes(const unsigned int capacityInBytes);
+
+        Statistics getStatistics() const;
+        void resetStatistics();
+        void clear();
+
+        bool obtain(const Key& key, Entry& outEntry);
+        void insert(const Key& key, const Entry& entry);
+
+    friend class OsmAnd::RasterizedTextCache;
+    };
+
+    uint qHash(const RasterizedTextCache_P::Key& key, uint seed = 0) Q_DECL_NOTHROW;
+}
+
+#endif // !defined(_OSMAND_CORE_RASTERIZED_TEXT_CACHE_P_H_)
@@ -0,0 +1,16 @@
+#ifndef _OSMAND_CORE_RASTERIZED_TEXT_CACHE_PRIVATE_H_
+#define _OSMAND_CORE_RASTERIZED_TEXT_CACHE_PRIVATE_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+
+#include "OsmAndCore.h"
+
+namespace OsmAnd
+{
+    void RasterizedTextCache_initializeGlobalInstance();
+    void RasterizedTextCache_releaseGlobalInstance();
+}
+
+#endif // !defined(_OSMAND_CORE_RASTERIZED_TEXT_CACHE_PRIVATE_H_)
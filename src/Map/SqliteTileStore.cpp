@@ -0,0 +1,88 @@
+#include "SqliteTileStore.h"
+#include "SqliteTileStore_P.h"
+
+OsmAnd::SqliteTileStore::SqliteTileStore(
+    const QString& filename_,
+    const uint64_t maxSize_ /*= Unbounded*/,
+    const int64_t expiryPeriod_ /*= NeverExpires*/)
+    : _p(new SqliteTileStore_P(this))
+    , filename(filename_)
+    , maxSize(maxSize_)
+    , expiryPeriod(expiryPeriod_)
+{
+}
+
+OsmAnd::SqliteTileStore::~SqliteTileStore()
+{
+    _p->close();
+}
+
+bool OsmAnd::SqliteTileStore::open()
+{
+    return _p->open();
+}
+
+void OsmAnd::SqliteTileStore::close()
+{
+    _p->close();
+}
+
+bool OsmAnd::SqliteTileStore::isOpened() const
+{
+    return _p->isOpened();
+}
+
+bool OsmAnd::SqliteTileStore::flush()
+{
+    return _p->flush();
+}
+
+unsigned int OsmAnd::SqliteTileStore::getTilesCount() const
+{
+    return _p->getTilesCount();
+}
+
+uint64_t OsmAnd::SqliteTileStore::getEvictedTilesCount() const
+{
+    return _p->getEvictedTilesCount();
+}
+
+bool OsmAnd::SqliteTileStore::importDirectory(
+    const QString& path,
+    const bool removeImportedFiles /*= true*/,
+    unsigned int* const pOutImportedCount /*= nullptr*/)
+{
+    return _p->importDirectory(path, removeImportedFiles, pOutImportedCount);
+}
+
+bool OsmAnd::SqliteTileStore::obtainTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    QByteArray& outData,
+    bool* const pOutExpired /*= nullptr*/)
+{
+    return _p->obtainTile(tileId, zoom, outData, pOutExpired);
+}
+
+bool OsmAnd::SqliteTileStore::containsTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    bool* const pOutExpired /*= nullptr*/) const
+{
+    return _p->containsTile(tileId, zoom, pOutExpired);
+}
+
+bool OsmAnd::SqliteTileStore::storeTile(const TileId tileId, const ZoomLevel zoom, const QByteArray& data)
+{
+    return _p->storeTile(tileId, zoom, data);
+}
+
+bool OsmAnd::SqliteTileStore::removeTile(const TileId tileId, const ZoomLevel zoom)
+{
+    return _p->removeTile(tileId, zoom);
+}
+
+uint64_t OsmAnd::SqliteTileStore::getTotalSize() const
+{
+    return _p->getTotalSize();
+}
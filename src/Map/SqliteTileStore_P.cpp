@@ -0,0 +1,668 @@
+#include "SqliteTileStore_P.h"
+#include "SqliteTileStore.h"
+
+#include "QtExtensions.h"
+#include <QtSql>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QDateTime>
+#include <QSet>
+
+#include "Logging.h"
+
+OsmAnd::SqliteTileStore_P::SqliteTileStore_P(SqliteTileStore* const owner_)
+    : owner(owner_)
+    , _connectionName(QLatin1String("tilestore-sqlite:") + QString::number(reinterpret_cast<quintptr>(this), 16))
+    , _totalSize(0)
+    , _tilesCount(0)
+    , _evictedTilesCount(0)
+    , _lastAccessOrder(0)
+    , _pendingAccessOrdersCount(0)
+{
+}
+
+OsmAnd::SqliteTileStore_P::~SqliteTileStore_P()
+{
+    close();
+}
+
+bool OsmAnd::SqliteTileStore_P::open()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    if (_database.isOpen())
+        return true;
+
+    _database = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), _connectionName);
+    _database.setDatabaseName(owner->filename);
+    if (!_database.open())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to open tile store '%s': %s",
+            qPrintable(owner->filename),
+            qPrintable(_database.lastError().text()));
+        closeDatabase();
+        return false;
+    }
+
+    if (!createSchema() || !prepareQueries() || !loadTotals())
+    {
+        closeDatabase();
+        return false;
+    }
+
+    return true;
+}
+
+void OsmAnd::SqliteTileStore_P::close()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    if (!_database.isOpen())
+        return;
+
+    writeAccessOrders();
+    closeDatabase();
+}
+
+bool OsmAnd::SqliteTileStore_P::isOpened() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _database.isOpen();
+}
+
+void OsmAnd::SqliteTileStore_P::closeDatabase()
+{
+    // All queries and database handles must be released before connection is removed
+    _selectQuery = QSqlQuery();
+    _selectCreatedAtQuery = QSqlQuery();
+    _selectSizeQuery = QSqlQuery();
+    _insertQuery = QSqlQuery();
+    _deleteQuery = QSqlQuery();
+    _updateAccessOrderQuery = QSqlQuery();
+    _selectLeastRecentlyUsedQuery = QSqlQuery();
+    if (_database.isOpen())
+        _database.close();
+    _database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(_connectionName);
+
+    _totalSize = 0;
+    _tilesCount = 0;
+    _lastAccessOrder = 0;
+    for (auto& pendingAccessOrders : _pendingAccessOrders)
+        pendingAccessOrders.clear();
+    _pendingAccessOrdersCount = 0;
+}
+
+bool OsmAnd::SqliteTileStore_P::createSchema()
+{
+    QSqlQuery q(_database);
+
+    // Store is a cache, so durability of last transactions is traded for write speed
+    q.exec(QLatin1String("PRAGMA journal_mode=WAL"));
+    q.exec(QLatin1String("PRAGMA synchronous=NORMAL"));
+
+    // 'tiles' and 'metadata' tables follow MBTiles, extra columns are ignored by MBTiles readers
+    const auto ok =
+        q.exec(QLatin1String(
+            "CREATE TABLE IF NOT EXISTS metadata ("
+            "    name TEXT,"
+            "    value TEXT"
+            ")")) &&
+        q.exec(QLatin1String(
+            "CREATE TABLE IF NOT EXISTS tiles ("
+            "    zoom_level INTEGER NOT NULL,"
+            "    tile_column INTEGER NOT NULL,"
+            "    tile_row INTEGER NOT NULL,"
+            "    tile_data BLOB,"
+            "    created_at INTEGER NOT NULL,"
+            "    access_order INTEGER NOT NULL,"
+            "    PRIMARY KEY (zoom_level, tile_column, tile_row)"
+            ")")) &&
+        q.exec(QLatin1String(
+            "CREATE INDEX IF NOT EXISTS tiles_access_order"
+            "    ON tiles(access_order)"));
+    if (!ok)
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to create schema of tile store '%s': %s",
+            qPrintable(owner->filename),
+            qPrintable(q.lastError().text()));
+        return false;
+    }
+
+    return true;
+}
+
+bool OsmAnd::SqliteTileStore_P::prepareQueries()
+{
+    _selectQuery = QSqlQuery(_database);
+    _selectCreatedAtQuery = QSqlQuery(_database);
+    _selectSizeQuery = QSqlQuery(_database);
+    _insertQuery = QSqlQuery(_database);
+    _deleteQuery = QSqlQuery(_database);
+    _updateAccessOrderQuery = QSqlQuery(_database);
+    _selectLeastRecentlyUsedQuery = QSqlQuery(_database);
+
+    const auto ok =
+        _selectQuery.prepare(QLatin1String(
+            "SELECT tile_data, created_at FROM tiles"
+            "    WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?")) &&
+        _selectCreatedAtQuery.prepare(QLatin1String(
+            "SELECT created_at FROM tiles"
+            "    WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?")) &&
+        _selectSizeQuery.prepare(QLatin1String(
+            "SELECT length(tile_data) FROM tiles"
+            "    WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?")) &&
+        _insertQuery.prepare(QLatin1String(
+            "INSERT OR REPLACE INTO tiles (zoom_level, tile_column, tile_row, tile_data, created_at, access_order)"
+            "    VALUES ( ?, ?, ?, ?, ?, ? )")) &&
+        _deleteQuery.prepare(QLatin1String(
+            "DELETE FROM tiles"
+            "    WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?")) &&
+        _updateAccessOrderQuery.prepare(QLatin1String(
+            "UPDATE tiles SET access_order = ?"
+            "    WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?")) &&
+        _selectLeastRecentlyUsedQuery.prepare(QLatin1String(
+            "SELECT zoom_level, tile_column, tile_row, length(tile_data) FROM tiles"
+            "    ORDER BY access_order ASC LIMIT ?"));
+    if (!ok)
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to prepare queries of tile store '%s': %s",
+            qPrintable(owner->filename),
+            qPrintable(_database.lastError().text()));
+        return false;
+    }
+
+    return true;
+}
+
+bool OsmAnd::SqliteTileStore_P::loadTotals()
+{
+    QSqlQuery q(_database);
+    if (!q.exec(QLatin1String("SELECT COUNT(*), TOTAL(length(tile_data)), MAX(access_order) FROM tiles")) || !q.next())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to read totals of tile store '%s': %s",
+            qPrintable(owner->filename),
+            qPrintable(q.lastError().text()));
+        return false;
+    }
+
+    _tilesCount = q.value(0).toUInt();
+    _totalSize = static_cast<uint64_t>(q.value(1).toDouble());
+    _lastAccessOrder = q.value(2).toLongLong();
+
+    return true;
+}
+
+int64_t OsmAnd::SqliteTileStore_P::getTmsRow(const TileId tileId, const ZoomLevel zoom)
+{
+    return (static_cast<int64_t>(1) << zoom) - 1 - tileId.y;
+}
+
+bool OsmAnd::SqliteTileStore_P::insertTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const QByteArray& data,
+    const int64_t createdAt)
+{
+    const auto tmsRow = getTmsRow(tileId, zoom);
+
+    // Size of replaced tile is needed to keep total size exact
+    uint64_t replacedSize = 0;
+    auto isReplaced = false;
+    _selectSizeQuery.addBindValue(static_cast<int>(zoom));
+    _selectSizeQuery.addBindValue(tileId.x);
+    _selectSizeQuery.addBindValue(static_cast<qint64>(tmsRow));
+    if (_selectSizeQuery.exec() && _selectSizeQuery.next())
+    {
+        isReplaced = true;
+        replacedSize = _selectSizeQuery.value(0).toULongLong();
+    }
+    _selectSizeQuery.finish();
+
+    _insertQuery.addBindValue(static_cast<int>(zoom));
+    _insertQuery.addBindValue(tileId.x);
+    _insertQuery.addBindValue(static_cast<qint64>(tmsRow));
+    // Non-null empty blob, so that tile without data is distinguishable from failure
+    _insertQuery.addBindValue(data.isNull() ? QByteArray("") : data);
+    _insertQuery.addBindValue(static_cast<qint64>(createdAt));
+    _insertQuery.addBindValue(static_cast<qint64>(++_lastAccessOrder));
+    if (!_insertQuery.exec())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to store tile %dx%d@%d in '%s': %s",
+            tileId.x,
+            tileId.y,
+            zoom,
+            qPrintable(owner->filename),
+            qPrintable(_insertQuery.lastError().text()));
+        return false;
+    }
+
+    if (isReplaced)
+        _totalSize -= replacedSize;
+    else
+        _tilesCount++;
+    _totalSize += data.size();
+
+    // Access order was just written
+    if (_pendingAccessOrders[zoom].remove(tileId) > 0)
+        _pendingAccessOrdersCount--;
+
+    return true;
+}
+
+bool OsmAnd::SqliteTileStore_P::deleteTile(const TileId tileId, const ZoomLevel zoom)
+{
+    if (_pendingAccessOrders[zoom].remove(tileId) > 0)
+        _pendingAccessOrdersCount--;
+
+    _deleteQuery.addBindValue(static_cast<int>(zoom));
+    _deleteQuery.addBindValue(tileId.x);
+    _deleteQuery.addBindValue(static_cast<qint64>(getTmsRow(tileId, zoom)));
+    if (!_deleteQuery.exec())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to remove tile %dx%d@%d from '%s': %s",
+            tileId.x,
+            tileId.y,
+            zoom,
+            qPrintable(owner->filename),
+            qPrintable(_deleteQuery.lastError().text()));
+        return false;
+    }
+
+    return _deleteQuery.numRowsAffected() > 0;
+}
+
+bool OsmAnd::SqliteTileStore_P::writeAccessOrders()
+{
+    if (_pendingAccessOrdersCount == 0)
+        return true;
+
+    auto ok = _database.transaction();
+    for (auto zoom = MinZoomLevel; ok && zoom <= MaxZoomLevel; zoom = static_cast<ZoomLevel>(zoom + 1))
+    {
+        for (const auto& entry : rangeOf(constOf(_pendingAccessOrders[zoom])))
+        {
+            const auto tileId = entry.key();
+
+            _updateAccessOrderQuery.addBindValue(static_cast<qint64>(entry.value()));
+            _updateAccessOrderQuery.addBindValue(static_cast<int>(zoom));
+            _updateAccessOrderQuery.addBindValue(tileId.x);
+            _updateAccessOrderQuery.addBindValue(static_cast<qint64>(getTmsRow(tileId, zoom)));
+            if (!_updateAccessOrderQuery.exec())
+            {
+                ok = false;
+                break;
+            }
+        }
+    }
+    if (!ok || !_database.commit())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to write access times to '%s': %s",
+            qPrintable(owner->filename),
+            qPrintable(_updateAccessOrderQuery.lastError().text()));
+        _database.rollback();
+        return false;
+    }
+
+    for (auto& pendingAccessOrders : _pendingAccessOrders)
+        pendingAccessOrders.clear();
+    _pendingAccessOrdersCount = 0;
+
+    return true;
+}
+
+bool OsmAnd::SqliteTileStore_P::evictTiles()
+{
+    if (owner->maxSize == SqliteTileStore::Unbounded || _totalSize <= owner->maxSize)
+        return true;
+
+    // Least recently used tiles can only be found once all access times are in database
+    if (!writeAccessOrders())
+        return false;
+
+    const auto targetSize = owner->maxSize * EvictionTargetPercent / 100;
+    if (!_database.transaction())
+        return false;
+    while (_totalSize > targetSize && _tilesCount > 0)
+    {
+        struct EvictedTile
+        {
+            TileId tileId;
+            ZoomLevel zoom;
+            uint64_t size;
+        };
+        QList<EvictedTile> evictedTiles;
+        uint64_t evictedSize = 0;
+        _selectLeastRecentlyUsedQuery.addBindValue(static_cast<int>(EvictionBatchSize));
+        if (!_selectLeastRecentlyUsedQuery.exec())
+            break;
+        while (_selectLeastRecentlyUsedQuery.next() && _totalSize - evictedSize > targetSize)
+        {
+            EvictedTile evictedTile;
+            evictedTile.zoom = static_cast<ZoomLevel>(_selectLeastRecentlyUsedQuery.value(0).toInt());
+            const auto x = _selectLeastRecentlyUsedQuery.value(1).toInt();
+            const auto tmsRow = _selectLeastRecentlyUsedQuery.value(2).toLongLong();
+            const auto y = static_cast<int32_t>((static_cast<int64_t>(1) << evictedTile.zoom) - 1 - tmsRow);
+            evictedTile.tileId = TileId::fromXY(x, y);
+            evictedTile.size = _selectLeastRecentlyUsedQuery.value(3).toULongLong();
+            evictedTiles.push_back(evictedTile);
+            evictedSize += evictedTile.size;
+        }
+        _selectLeastRecentlyUsedQuery.finish();
+        if (evictedTiles.isEmpty())
+            break;
+
+        // Totals are updated only for tiles that were actually removed
+        auto deletedTilesCount = 0;
+        for (const auto& evictedTile : constOf(evictedTiles))
+        {
+            if (!deleteTile(evictedTile.tileId, evictedTile.zoom))
+                continue;
+
+            _tilesCount--;
+            _totalSize -= qMin(evictedTile.size, _totalSize);
+            deletedTilesCount++;
+        }
+        _evictedTilesCount += deletedTilesCount;
+
+        // Same tiles would be selected again
+        if (deletedTilesCount == 0)
+            break;
+    }
+    if (!_database.commit())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to evict tiles from '%s': %s",
+            qPrintable(owner->filename),
+            qPrintable(_database.lastError().text()));
+        _database.rollback();
+
+        // Totals no longer match database
+        loadTotals();
+        return false;
+    }
+
+    return true;
+}
+
+bool OsmAnd::SqliteTileStore_P::isExpired(const int64_t createdAt) const
+{
+    return owner->expiryPeriod != ITileStore::NeverExpires &&
+        QDateTime::currentMSecsSinceEpoch() - createdAt >= owner->expiryPeriod * 1000;
+}
+
+bool OsmAnd::SqliteTileStore_P::flush()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    if (!_database.isOpen())
+        return false;
+
+    return writeAccessOrders();
+}
+
+unsigned int OsmAnd::SqliteTileStore_P::getTilesCount() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _tilesCount;
+}
+
+uint64_t OsmAnd::SqliteTileStore_P::getEvictedTilesCount() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _evictedTilesCount;
+}
+
+bool OsmAnd::SqliteTileStore_P::importDirectory(
+    const QString& path,
+    const bool removeImportedFiles,
+    unsigned int* const pOutImportedCount)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    if (pOutImportedCount)
+        *pOutImportedCount = 0;
+
+    if (!_database.isOpen())
+        return false;
+
+    const QDir rootDir(path);
+    QStringList importedFiles;
+    QSet<QString> importedDirs;
+    auto ok = true;
+    const auto commitImported =
+        [this, &importedFiles, &importedDirs, removeImportedFiles, pOutImportedCount]
+        () -> bool
+        {
+            if (!_database.commit())
+            {
+                LogPrintf(LogSeverityLevel::Error,
+                    "Failed to import tiles to '%s': %s",
+                    qPrintable(owner->filename),
+                    qPrintable(_database.lastError().text()));
+                _database.rollback();
+                loadTotals();
+                return false;
+            }
+
+            if (pOutImportedCount)
+                *pOutImportedCount += importedFiles.size();
+            if (removeImportedFiles)
+            {
+                for (const auto& importedFile : constOf(importedFiles))
+                {
+                    QFile(importedFile).remove();
+                    importedDirs.insert(QFileInfo(importedFile).absolutePath());
+                }
+            }
+            importedFiles.clear();
+            return true;
+        };
+
+    if (!_database.transaction())
+        return false;
+    QDirIterator it(path, QStringList() << QLatin1String("*.tile"), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        it.next();
+        const auto tileFileInfo = it.fileInfo();
+
+        // Only 'zoom/x/y.tile' files are tiles
+        const auto pathComponents = rootDir.relativeFilePath(tileFileInfo.absoluteFilePath()).split(QLatin1Char('/'));
+        if (pathComponents.size() != 3)
+            continue;
+        bool zoomOk = false;
+        bool xOk = false;
+        bool yOk = false;
+        const auto zoom = pathComponents[0].toInt(&zoomOk);
+        const auto x = pathComponents[1].toInt(&xOk);
+        const auto y = tileFileInfo.completeBaseName().toInt(&yOk);
+        if (!zoomOk || !xOk || !yOk || zoom < MinZoomLevel || zoom > MaxZoomLevel)
+            continue;
+        const auto tilesCount = static_cast<int64_t>(1) << zoom;
+        if (x < 0 || x >= tilesCount || y < 0 || y >= tilesCount)
+            continue;
+
+        QByteArray data;
+        if (tileFileInfo.size() > 0)
+        {
+            QFile tileFile(tileFileInfo.absoluteFilePath());
+            if (!tileFile.open(QIODevice::ReadOnly))
+            {
+                LogPrintf(LogSeverityLevel::Warning,
+                    "Failed to open tile file '%s' for import",
+                    qPrintable(tileFileInfo.absoluteFilePath()));
+                continue;
+            }
+            data = tileFile.readAll();
+            tileFile.close();
+        }
+
+        if (!insertTile(
+                TileId::fromXY(x, y),
+                static_cast<ZoomLevel>(zoom),
+                data,
+                tileFileInfo.lastModified().toMSecsSinceEpoch()))
+        {
+            ok = false;
+            break;
+        }
+        importedFiles.push_back(tileFileInfo.absoluteFilePath());
+
+        if (importedFiles.size() >= ImportTransactionSize)
+        {
+            if (!commitImported() || !_database.transaction())
+                return false;
+        }
+    }
+    if (!ok)
+    {
+        _database.rollback();
+        loadTotals();
+        return false;
+    }
+    if (!commitImported())
+        return false;
+
+    // Remove 'x' directories and then 'zoom' directories that became empty
+    QSet<QString> zoomDirs;
+    for (const auto& importedDir : constOf(importedDirs))
+    {
+        if (QDir().rmdir(importedDir))
+            zoomDirs.insert(QFileInfo(importedDir).absolutePath());
+    }
+    for (const auto& zoomDir : constOf(zoomDirs))
+        QDir().rmdir(zoomDir);
+
+    return evictTiles();
+}
+
+bool OsmAnd::SqliteTileStore_P::obtainTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    QByteArray& outData,
+    bool* const pOutExpired)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    if (!_database.isOpen())
+        return false;
+
+    _selectQuery.addBindValue(static_cast<int>(zoom));
+    _selectQuery.addBindValue(tileId.x);
+    _selectQuery.addBindValue(static_cast<qint64>(getTmsRow(tileId, zoom)));
+    if (!_selectQuery.exec())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to query tile %dx%d@%d from '%s': %s",
+            tileId.x,
+            tileId.y,
+            zoom,
+            qPrintable(owner->filename),
+            qPrintable(_selectQuery.lastError().text()));
+        return false;
+    }
+    if (!_selectQuery.next())
+    {
+        _selectQuery.finish();
+        return false;
+    }
+    outData = _selectQuery.value(0).toByteArray();
+    const auto createdAt = _selectQuery.value(1).toLongLong();
+    _selectQuery.finish();
+
+    if (pOutExpired)
+        *pOutExpired = isExpired(createdAt);
+
+    auto& pendingAccessOrder = _pendingAccessOrders[zoom][tileId];
+    if (pendingAccessOrder == 0)
+        _pendingAccessOrdersCount++;
+    pendingAccessOrder = ++_lastAccessOrder;
+    if (_pendingAccessOrdersCount >= AccessOrdersFlushThreshold)
+        writeAccessOrders();
+
+    return true;
+}
+
+bool OsmAnd::SqliteTileStore_P::containsTile(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    bool* const pOutExpired) const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    if (!_database.isOpen())
+        return false;
+
+    _selectCreatedAtQuery.addBindValue(static_cast<int>(zoom));
+    _selectCreatedAtQuery.addBindValue(tileId.x);
+    _selectCreatedAtQuery.addBindValue(static_cast<qint64>(getTmsRow(tileId, zoom)));
+    if (!_selectCreatedAtQuery.exec() || !_selectCreatedAtQuery.next())
+    {
+        _selectCreatedAtQuery.finish();
+        return false;
+    }
+    const auto createdAt = _selectCreatedAtQuery.value(0).toLongLong();
+    _selectCreatedAtQuery.finish();
+
+    if (pOutExpired)
+        *pOutExpired = isExpired(createdAt);
+
+    return true;
+}
+
+bool OsmAnd::SqliteTileStore_P::storeTile(const TileId tileId, const ZoomLevel zoom, const QByteArray& data)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    if (!_database.isOpen())
+        return false;
+
+    if (!insertTile(tileId, zoom, data, QDateTime::currentMSecsSinceEpoch()))
+        return false;
+
+    evictTiles();
+    return true;
+}
+
+bool OsmAnd::SqliteTileStore_P::removeTile(const TileId tileId, const ZoomLevel zoom)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    if (!_database.isOpen())
+        return false;
+
+    uint64_t size = 0;
+    _selectSizeQuery.addBindValue(static_cast<int>(zoom));
+    _selectSizeQuery.addBindValue(tileId.x);
+    _selectSizeQuery.addBindValue(static_cast<qint64>(getTmsRow(tileId, zoom)));
+    if (_selectSizeQuery.exec() && _selectSizeQuery.next())
+        size = _selectSizeQuery.value(0).toULongLong();
+    _selectSizeQuery.finish();
+
+    if (!deleteTile(tileId, zoom))
+        return false;
+
+    _tilesCount--;
+    _totalSize -= size;
+    return true;
+}
+
+uint64_t OsmAnd::SqliteTileStore_P::getTotalSize() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _totalSize;
+}
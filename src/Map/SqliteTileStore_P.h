@@ -0,0 +1,100 @@
+#ifndef _OSMAND_CORE_SQLITE_TILE_STORE_P_H_
+#define _OSMAND_CORE_SQLITE_TILE_STORE_P_H_
+
+#include "stdlib_common.h"
+#include <array>
+
+#include "QtExtensions.h"
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "SqliteTileStore.h"
+
+namespace OsmAnd
+{
+    class SqliteTileStore;
+    class SqliteTileStore_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(SqliteTileStore_P);
+    public:
+        enum : int {
+            // Pending access times are written once there are this many of them
+            AccessOrdersFlushThreshold = 1024,
+            EvictionBatchSize = 256,
+            // Eviction stops once total size drops to this percent of maximal size,
+            // so that following insertions do not trigger eviction one by one
+            EvictionTargetPercent = 90,
+            ImportTransactionSize = 1024,
+        };
+
+    private:
+        const QString _connectionName;
+
+        mutable QMutex _mutex;
+        QSqlDatabase _database;
+        QSqlQuery _selectQuery;
+        mutable QSqlQuery _selectCreatedAtQuery;
+        QSqlQuery _selectSizeQuery;
+        QSqlQuery _insertQuery;
+        QSqlQuery _deleteQuery;
+        QSqlQuery _updateAccessOrderQuery;
+        QSqlQuery _selectLeastRecentlyUsedQuery;
+
+        uint64_t _totalSize;
+        unsigned int _tilesCount;
+        uint64_t _evictedTilesCount;
+
+        // Access order is a counter that is increased on each access, so LRU order does not depend on clock resolution
+        int64_t _lastAccessOrder;
+        std::array< QHash<TileId, int64_t>, ZoomLevelsCount > _pendingAccessOrders;
+        unsigned int _pendingAccessOrdersCount;
+
+        bool createSchema();
+        bool prepareQueries();
+        bool loadTotals();
+        void closeDatabase();
+
+        bool insertTile(const TileId tileId, const ZoomLevel zoom, const QByteArray& data, const int64_t createdAt);
+        bool deleteTile(const TileId tileId, const ZoomLevel zoom);
+        bool writeAccessOrders();
+        bool evictTiles();
+        bool isExpired(const int64_t createdAt) const;
+
+        static int64_t getTmsRow(const TileId tileId, const ZoomLevel zoom);
+    protected:
+        SqliteTileStore_P(SqliteTileStore* const owner);
+    public:
+        ~SqliteTileStore_P();
+
+        ImplementationInterface<SqliteTileStore> owner;
+
+        bool open();
+        void close();
+        bool isOpened() const;
+
+        bool flush();
+
+        unsigned int getTilesCount() const;
+        uint64_t getEvictedTilesCount() const;
+
+        bool importDirectory(const QString& path, const bool removeImportedFiles, unsigned int* const pOutImportedCount);
+
+        bool obtainTile(const TileId tileId, const ZoomLevel zoom, QByteArray& outData, bool* const pOutExpired);
+        bool containsTile(const TileId tileId, const ZoomLevel zoom, bool* const pOutExpired) const;
+        bool storeTile(const TileId tileId, const ZoomLevel zoom, const QByteArray& data);
+        bool removeTile(const TileId tileId, const ZoomLevel zoom);
+
+        uint64_t getTotalSize() const;
+
+    friend class OsmAnd::SqliteTileStore;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_SQLITE_TILE_STORE_P_H_)
@@ -2,9 +2,11 @@
 #include "SymbolRasterizer_P.h"
 
 OsmAnd::SymbolRasterizer::SymbolRasterizer(
-    const std::shared_ptr<const TextRasterizer>& textRasterizer_ /*= TextRasterizer::getDefault()*/)
+    const std::shared_ptr<const TextRasterizer>& textRasterizer_ /*= TextRasterizer::getDefault()*/,
+    const std::shared_ptr<RasterizedTextCache>& rasterizedTextCache_ /*= RasterizedTextCache::getDefault()*/)
     : _p(new SymbolRasterizer_P(this))
     , textRasterizer(textRasterizer_)
+    , rasterizedTextCache(rasterizedTextCache_)
 {
 }
 
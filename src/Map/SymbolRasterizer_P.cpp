@@ -21,6 +21,7 @@
 #include "QCachingIterator.h"
 #include "Stopwatch.h"
 #include "SkiaUtilities.h"
+#include "RasterizedTextCache_P.h"
 #include "Utilities.h"
 #include "Logging.h"
 
@@ -105,15 +106,6 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                         backgroundLayers.push_back(icon);
                 }
 
-                style.backgroundBitmap = SkiaUtilities::mergeBitmaps(backgroundLayers);
-                if (!qFuzzyCompare(textSymbol->scaleFactor, 1.0f) && style.backgroundBitmap)
-                {
-                    style.backgroundBitmap = SkiaUtilities::scaleBitmap(
-                        style.backgroundBitmap,
-                        textSymbol->scaleFactor,
-                        textSymbol->scaleFactor);
-                }
-
                 style
                     .setBold(textSymbol->isBold)
                     .setItalic(textSymbol->isItalic)
@@ -127,17 +119,48 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                         .setHaloRadius(textSymbol->shadowRadius);
                 }
 
-                float lineSpacing;
-                float symbolExtraTopSpace;
-                float symbolExtraBottomSpace;
-                QVector<SkScalar> glyphsWidth;
-                const auto rasterizedText = owner->textRasterizer->rasterize(
-                    textSymbol->value,
-                    style,
-                    textSymbol->drawOnPath ? &glyphsWidth : nullptr,
-                    &symbolExtraTopSpace,
-                    &symbolExtraBottomSpace,
-                    &lineSpacing);
+                // Same caption with same style usually appears in many tiles, so look it up in shared cache first
+                const auto& rasterizedTextCache = owner->rasterizedTextCache;
+                RasterizedTextCache_P::Key cacheKey;
+                RasterizedTextCache_P::Entry cacheEntry;
+                if (rasterizedTextCache)
+                {
+                    cacheKey.textRasterizer = owner->textRasterizer;
+                    cacheKey.text = textSymbol->value;
+                    cacheKey.style = style;
+                    cacheKey.backgroundLayers = backgroundLayers;
+                    cacheKey.scaleFactor = textSymbol->scaleFactor;
+                    cacheKey.withGlyphsWidth = textSymbol->drawOnPath;
+                }
+                if (!rasterizedTextCache || !rasterizedTextCache->_p->obtain(cacheKey, cacheEntry))
+                {
+                    style.backgroundBitmap = SkiaUtilities::mergeBitmaps(backgroundLayers);
+                    if (!qFuzzyCompare(textSymbol->scaleFactor, 1.0f) && style.backgroundBitmap)
+                    {
+                        style.backgroundBitmap = SkiaUtilities::scaleBitmap(
+                            style.backgroundBitmap,
+                            textSymbol->scaleFactor,
+                            textSymbol->scaleFactor);
+                    }
+
+                    cacheEntry.bitmap = owner->textRasterizer->rasterize(
+                        textSymbol->value,
+                        style,
+                        textSymbol->drawOnPath ? &cacheEntry.glyphsWidth : nullptr,
+                        &cacheEntry.extraTopSpace,
+                        &cacheEntry.extraBottomSpace,
+                        &cacheEntry.lineSpacing);
+
+                    // Failures are cached as well, since they would fail again
+                    if (rasterizedTextCache)
+                        rasterizedTextCache->_p->insert(cacheKey, cacheEntry);
+                }
+
+                const auto& rasterizedText = cacheEntry.bitmap;
+                const auto lineSpacing = cacheEntry.lineSpacing;
+                const auto symbolExtraTopSpace = cacheEntry.extraTopSpace;
+                const auto symbolExtraBottomSpace = cacheEntry.extraBottomSpace;
+                const auto& glyphsWidth = cacheEntry.glyphsWidth;
                 if (!rasterizedText)
                     continue;
 
@@ -157,7 +180,7 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                     const std::shared_ptr<RasterizedOnPathSymbol> rasterizedSymbol(new RasterizedOnPathSymbol(
                         group,
                         textSymbol));
-                    rasterizedSymbol->bitmap = qMove(rasterizedText);
+                    rasterizedSymbol->bitmap = rasterizedText;
                     rasterizedSymbol->order = textSymbol->order;
                     rasterizedSymbol->contentType = RasterizedSymbol::ContentType::Text;
                     rasterizedSymbol->content = textSymbol->value;
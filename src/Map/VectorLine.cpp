@@ -42,6 +42,11 @@ void OsmAnd::VectorLine::setPoints(const QVector<OsmAnd::PointI>& points)
     _p->setPoints(points);    
 }
 
+void OsmAnd::VectorLine::appendPoints(const QVector<OsmAnd::PointI>& points)
+{
+    _p->appendPoints(points);
+}
+
 bool OsmAnd::VectorLine::hasUnappliedChanges() const
 {
     return _p->hasUnappliedChanges();
@@ -28,6 +28,14 @@ OsmAnd::VectorLine_P::~VectorLine_P()
 {
 }
 
+OsmAnd::VectorLine_P::Tessellation::Tessellation()
+    : isValid(false)
+    , zoomLevel(InvalidZoomLevel)
+    , radius(0.0)
+    , pointsCount(0)
+{
+}
+
 bool OsmAnd::VectorLine_P::isHidden() const
 {
     QReadLocker scopedLocker(&_lock);
@@ -55,11 +63,26 @@ void OsmAnd::VectorLine_P::setPoints(const QVector<PointI>& points)
     QWriteLocker scopedLocker(&_lock);
     
     _points = points;
+    invalidateGeometry();
     
     _hasUnappliedPrimitiveChanges = true;
     _hasUnappliedChanges = true;
 }
 
+void OsmAnd::VectorLine_P::appendPoints(const QVector<PointI>& points)
+{
+    QWriteLocker scopedLocker(&_lock);
+
+    if (points.isEmpty())
+        return;
+
+    // Geometry of points that were already there is kept, only the tail gets updated
+    _points += points;
+
+    _hasUnappliedPrimitiveChanges = true;
+    _hasUnappliedChanges = true;
+}
+
 bool OsmAnd::VectorLine_P::hasUnappliedChanges() const
 {
     QReadLocker scopedLocker(&_lock);
@@ -80,6 +103,14 @@ bool OsmAnd::VectorLine_P::isMapStateChanged(const MapState& mapState) const
     //_mapZoomLevel != mapState.zoomLevel ||
     //_mapVisualZoom != mapState.visualZoom ||
     //_mapVisualZoomShift != mapState.visualZoomShift;
+    if (!changed && _mapZoomLevel != InvalidZoomLevel)
+    {
+        // Clip area is kept until target gets too close to its edge
+        const auto zoomShift = ZoomLevel31 - _mapZoomLevel;
+        const auto tilesDeltaX = qAbs((mapState.target31.x >> zoomShift) - (_mapTarget31.x >> zoomShift));
+        const auto tilesDeltaY = qAbs((mapState.target31.y >> zoomShift) - (_mapTarget31.y >> zoomShift));
+        changed = qMax(tilesDeltaX, tilesDeltaY) > ClipAreaTilesRadius / 2;
+    }
     return changed;
 }
 
@@ -89,6 +120,7 @@ void OsmAnd::VectorLine_P::applyMapState(const MapState& mapState)
     _mapZoomLevel = mapState.zoomLevel;
     _mapVisualZoom = mapState.visualZoom;
     _mapVisualZoomShift = mapState.visualZoomShift;
+    _mapTarget31 = mapState.target31;
 }
 
 bool OsmAnd::VectorLine_P::update(const MapState& mapState)
@@ -226,40 +258,303 @@ double OsmAnd::VectorLine_P::scalarMultiplication(double xA, double yA, double x
     return (xB - xA) * (xC - xA) + (yB - yA) * (yC - yA);
 }
 
-int OsmAnd::VectorLine_P::simplifyDouglasPeucker(std::vector<PointD>& points, uint start, uint end, double epsilon, std::vector<bool>& include) const
+float OsmAnd::VectorLine_P::zoom() const
 {
-    double dmax = -1;
-    int index = -1;
-    for (int i = start + 1; i <= end - 1; i++) {
-        PointD proj = getProjection(points[i],points[start], points[end]);
-        double d = qSqrt((points[i].x-proj.x)*(points[i].x-proj.x)+
-                         (points[i].y-proj.y)*(points[i].y-proj.y));
-        // calculate distance from line
-        if (d > dmax) {
-            dmax = d;
-            index = i;
-        }
+    return _mapZoomLevel + (_mapVisualZoom >= 1.0f ? _mapVisualZoom - 1.0f : (_mapVisualZoom - 1.0f) * 2.0f);
+}
+
+double OsmAnd::VectorLine_P::getRadius(const ZoomLevel zoomLevel, const float zoom) const
+{
+    return owner->lineWidth * Utilities::getPowZoom(31 - zoomLevel) * qSqrt(zoom) /
+        (IAtlasMapRenderer::TileSize3D * IAtlasMapRenderer::TileSize3D);
+}
+
+OsmAnd::AreaI OsmAnd::VectorLine_P::getClipArea31() const
+{
+    const auto zoomShift = ZoomLevel31 - _mapZoomLevel;
+    const auto maxTileIndex = static_cast<int32_t>((1u << _mapZoomLevel) - 1);
+    const auto targetTileX = _mapTarget31.x >> zoomShift;
+    const auto targetTileY = _mapTarget31.y >> zoomShift;
+
+    const auto topLeftTileId = TileId::fromXY(
+        qMax(targetTileX - ClipAreaTilesRadius, 0),
+        qMax(targetTileY - ClipAreaTilesRadius, 0));
+    const auto bottomRightTileId = TileId::fromXY(
+        qMin(targetTileX + ClipAreaTilesRadius, maxTileIndex),
+        qMin(targetTileY + ClipAreaTilesRadius, maxTileIndex));
+
+    return AreaI(
+        Utilities::tileBoundingBox31(topLeftTileId, _mapZoomLevel).topLeft,
+        Utilities::tileBoundingBox31(bottomRightTileId, _mapZoomLevel).bottomRight);
+}
+
+int OsmAnd::VectorLine_P::getLastChunkStart(const int pointsCount)
+{
+    if (pointsCount < 2)
+        return 0;
+
+    return ((pointsCount - 2) / SimplificationChunkSize) * SimplificationChunkSize;
+}
+
+void OsmAnd::VectorLine_P::invalidateGeometry()
+{
+    QMutexLocker scopedLocker(&_geometryMutex);
+
+    _pointsSignificance.clear();
+    for (auto& pointsIndices : _simplifiedPointsIndices)
+        pointsIndices.clear();
+    _tessellation = Tessellation();
+}
+
+void OsmAnd::VectorLine_P::updatePointsSignificance() const
+{
+    const auto pointsCount = _points.size();
+    const auto oldPointsCount = _pointsSignificance.size();
+    if (pointsCount == oldPointsCount)
+        return;
+
+    // Chunks before the last one are not affected by appended points
+    const auto firstChunkStart = getLastChunkStart(oldPointsCount);
+    _pointsSignificance.resize(pointsCount);
+    if (pointsCount == 1)
+        _pointsSignificance[0] = std::numeric_limits<double>::max();
+    for (auto chunkStart = firstChunkStart; chunkStart < pointsCount - 1; chunkStart += SimplificationChunkSize)
+    {
+        Utilities::computePointsSignificance(
+            _points,
+            chunkStart,
+            qMin(chunkStart + SimplificationChunkSize, pointsCount - 1),
+            _pointsSignificance);
     }
-    if (dmax >= epsilon) {
-        int enabled1 = simplifyDouglasPeucker(points, start, index, epsilon, include);
-        int enabled2 = simplifyDouglasPeucker(points, index, end, epsilon, include);
-        return enabled1 + enabled2 ;
-    } else {
-        include[end] = true;
-        return 1;
+
+    // Simplified points of recomputed chunks are collected again on demand. Start of chunk is always kept,
+    // so what remains is still valid
+    for (auto& pointsIndices : _simplifiedPointsIndices)
+    {
+        while (!pointsIndices.isEmpty() && pointsIndices.last() >= firstChunkStart)
+            pointsIndices.removeLast();
     }
 }
 
-float OsmAnd::VectorLine_P::zoom() const
+const QVector<int>& OsmAnd::VectorLine_P::getSimplifiedPointsIndices(const ZoomLevel zoomLevel) const
 {
-    return _mapZoomLevel + (_mapVisualZoom >= 1.0f ? _mapVisualZoom - 1.0f : (_mapVisualZoom - 1.0f) * 2.0f);
+    auto& pointsIndices = _simplifiedPointsIndices[zoomLevel];
+
+    // Points that are already there are up to date, so only the rest is checked
+    const auto tolerance = getRadius(zoomLevel, zoomLevel) / 3;
+    const auto pointsCount = _points.size();
+    for (auto pointIdx = pointsIndices.isEmpty() ? 0 : pointsIndices.last() + 1; pointIdx < pointsCount; pointIdx++)
+    {
+        if (_pointsSignificance[pointIdx] >= tolerance)
+            pointsIndices.push_back(pointIdx);
+    }
+
+    return pointsIndices;
+}
+
+bool OsmAnd::VectorLine_P::isSegmentVisible(
+    const QVector<int>& pointsIndices,
+    const int position,
+    const AreaI& clipArea31) const
+{
+    if (position <= 0 || position >= pointsIndices.size())
+        return false;
+
+    const auto& start = _points[pointsIndices[position - 1]];
+    const auto& end = _points[pointsIndices[position]];
+    return clipArea31.intersects(
+        qMin(start.y, end.y),
+        qMin(start.x, end.x),
+        qMax(start.y, end.y),
+        qMax(start.x, end.x));
+}
+
+void OsmAnd::VectorLine_P::updateTessellation() const
+{
+    updatePointsSignificance();
+
+    const auto& pointsIndices = getSimplifiedPointsIndices(_mapZoomLevel);
+    const auto radius = getRadius(_mapZoomLevel, zoom());
+    const auto clipArea31 = getClipArea31();
+
+    auto firstPosition = 0;
+    if (_tessellation.isValid &&
+        _tessellation.zoomLevel == _mapZoomLevel &&
+        _tessellation.radius == radius &&
+        _tessellation.clipArea31 == clipArea31)
+    {
+        if (_tessellation.pointsCount == _points.size())
+            return;
+
+        // Only points of the last chunk could have changed, and geometry of its start depends on them as well
+        const auto chunkStart = getLastChunkStart(_tessellation.pointsCount);
+        firstPosition = std::lower_bound(pointsIndices.cbegin(), pointsIndices.cend(), chunkStart) - pointsIndices.cbegin();
+    }
+
+    auto& vertices = _tessellation.vertices;
+    auto& piecesOffsets = _tessellation.piecesOffsets;
+    vertices.resize(firstPosition < piecesOffsets.size() ? piecesOffsets[firstPosition] : 0);
+    piecesOffsets.resize(firstPosition);
+    for (auto position = firstPosition; position < pointsIndices.size(); position++)
+    {
+        piecesOffsets.push_back(static_cast<int>(vertices.size()));
+        tessellatePiece(pointsIndices, position, radius, clipArea31, vertices);
+    }
+
+    _tessellation.isValid = true;
+    _tessellation.zoomLevel = _mapZoomLevel;
+    _tessellation.radius = radius;
+    _tessellation.clipArea31 = clipArea31;
+    _tessellation.pointsCount = _points.size();
+}
+
+void OsmAnd::VectorLine_P::tessellatePiece(
+    const QVector<int>& pointsIndices,
+    const int position,
+    const double radius,
+    const AreaI& clipArea31,
+    std::vector<VectorMapSymbol::Vertex>& vertices) const
+{
+    // Only visible segments are tessellated, invisible points are skipped
+    const auto visibleBefore = isSegmentVisible(pointsIndices, position, clipArea31);
+    const auto visibleAfter = isSegmentVisible(pointsIndices, position + 1, clipArea31);
+    if (!visibleBefore && !visibleAfter)
+        return;
+
+    const auto& origin31 = _points[0];
+    const auto getPoint = [this, &pointsIndices, &origin31](const int pointPosition) -> PointD
+    {
+        const auto& point31 = _points[pointsIndices[pointPosition]];
+        return PointD(point31.x - origin31.x, point31.y - origin31.y);
+    };
+    // Shift from segment ending at given position to its first side
+    const auto getSideOffset = [this, &pointsIndices, radius](const int pointPosition) -> PointD
+    {
+        const auto& start = _points[pointsIndices[pointPosition - 1]];
+        const auto& end = _points[pointsIndices[pointPosition]];
+        const double dx = end.x - start.x;
+        const double dy = end.y - start.y;
+        const auto length = qSqrt(dx * dx + dy * dy);
+        if (length <= 0.0)
+            return PointD(-radius, 0.0);
+        return PointD(-radius * dy / length, radius * dx / length);
+    };
+
+    VectorMapSymbol::Vertex vertex;
+    vertex.color = owner->fillColor;
+    const auto pushVertex = [&vertices, &vertex](const PointD& point)
+    {
+        vertex.positionXY[0] = point.x;
+        vertex.positionXY[1] = point.y;
+        vertices.push_back(vertex);
+    };
+
+    const auto point = getPoint(position);
+    if (!visibleBefore)
+    {
+        const auto offset = getSideOffset(position + 1);
+        if (!vertices.empty())
+        {
+            // Stitch to previous visible part using degenerate triangles
+            vertices.push_back(vertices.back());
+            pushVertex(point - offset);
+        }
+        pushVertex(point - offset);
+        pushVertex(point + offset);
+        return;
+    }
+    if (!visibleAfter)
+    {
+        const auto offset = getSideOffset(position);
+        pushVertex(point - offset);
+        pushVertex(point + offset);
+        return;
+    }
+
+    const auto prevPoint = getPoint(position - 1);
+    const auto nextPoint = getPoint(position + 1);
+    const auto offsetBefore = getSideOffset(position);
+    const auto offsetAfter = getSideOffset(position + 1);
+    const PointD e1Prev(prevPoint + offsetBefore), b1(point + offsetBefore), e1(point + offsetAfter), b1Next(nextPoint + offsetAfter);
+    const PointD e2Prev(prevPoint - offsetBefore), b2(point - offsetBefore), e2(point - offsetAfter), b2Next(nextPoint - offsetAfter);
+
+    int smoothLevel = 1; // could be constant & could be dynamic depends on the angle
+    PointD l1 = findLineIntersection(e1Prev, b1, e1, b1Next);
+    PointD l2 = findLineIntersection(e2Prev, b2, e2, b2Next);
+    bool l1Intersects = (l1.x >= qMin(e1Prev.x, b1.x) && l1.x <= qMax(e1Prev.x, b1.x)) ||
+                        (l1.x >= qMin(e1.x, b1Next.x) && l1.x <= qMax(e1.x, b1Next.x));
+    bool l2Intersects = (l2.x >= qMin(e2Prev.x, b2.x) && l2.x <= qMax(e2Prev.x, b2.x)) ||
+                        (l2.x >= qMin(e2.x, b2Next.x) && l2.x <= qMax(e2.x, b2Next.x));
+
+    // bewel - connecting only 3 points (one excluded depends on angle)
+    // miter - connecting 4 points
+    // round - generating between 2-3 point triangles (in place of triangle different between bewel/miter)
+
+    if (!l2Intersects && !l1Intersects)
+    {
+        // skip point
+        return;
+    }
+
+    bool startDirection = l2Intersects;
+    const PointD& lp = startDirection ? l2 : l1;
+    const PointD& bp = startDirection ? b1 : b2;
+    const PointD& ep = startDirection ? e1 : e2;
+    // Strip direction never flips while joins are smoothed
+    int phase = startDirection ? 0 : 2;
+    if (phase % 3 == 0)
+    {
+        pushVertex(lp);
+        phase++;
+    }
+
+    pushVertex(bp);
+    phase++;
+    if (phase % 3 == 0)
+    {
+        pushVertex(lp);
+        phase++;
+    }
+
+    if (smoothLevel > 0)
+    {
+        double dv = 1.0 / (1 << smoothLevel);
+        double nt = dv;
+        while (nt < 1)
+        {
+            double rx = bp.x * nt + ep.x * (1 - nt);
+            double ry = bp.y * nt + ep.y * (1 - nt);
+            double ld = (rx - point.x) * (rx - point.x) + (ry - point.y) * (ry - point.y);
+            pushVertex(PointD(point.x + radius / sqrt(ld) * (rx - point.x), point.y + radius / sqrt(ld) * (ry - point.y)));
+            phase++;
+            if (phase % 3 == 0)
+            {
+                // avoid overlap
+                vertices.push_back(vertex);
+
+                pushVertex(lp);
+                phase++;
+            }
+            nt += dv;
+        }
+    }
+
+    pushVertex(ep);
+    phase++;
+    if (phase % 3 == 0)
+    {
+        // avoid overlap
+        vertices.push_back(vertex);
+
+        pushVertex(lp);
+        phase++;
+    }
 }
 
 std::shared_ptr<OsmAnd::OnSurfaceVectorMapSymbol> OsmAnd::VectorLine_P::generatePrimitive(const std::shared_ptr<OnSurfaceVectorMapSymbol> vectorLine) const
 {
     int order = owner->baseOrder;
-    int pointsCount = _points.size();
-    
+
     vectorLine->order = order++;
     vectorLine->position31 = _points[0];
     vectorLine->primitiveType = VectorMapSymbol::PrimitiveType::TriangleStrip;
@@ -268,215 +563,46 @@ std::shared_ptr<OsmAnd::OnSurfaceVectorMapSymbol> OsmAnd::VectorLine_P::generate
     // Line has no reusable vertices - TODO clarify
     verticesAndIndexes->indices = nullptr;
     verticesAndIndexes->indicesCount = 0;
-    
+
     vectorLine->scaleType = VectorMapSymbol::ScaleType::In31;
     vectorLine->scale = 1.0;
     vectorLine->direction = 0.f;
-    
-    float zoom = this->zoom();
-    double radius = owner->lineWidth * Utilities::getPowZoom( 31 - _mapZoomLevel) * qSqrt(zoom) /
-                        (IAtlasMapRenderer::TileSize3D * IAtlasMapRenderer::TileSize3D);
-    // generate array of points
-    std::vector<OsmAnd::PointD> pointsToPlot(pointsCount);
-    for (auto pointIdx = 0u; pointIdx < pointsCount; pointIdx++)
-    {
-        pointsToPlot[pointIdx] = PointD((_points[pointIdx].x-_points[0].x), (_points[pointIdx].y-_points[0].y));
-    }
-    
-    std::vector<bool> include(pointsCount, false);
-    include[0] = true;
-    int pointsSimpleCount = simplifyDouglasPeucker(pointsToPlot, 0, (uint) pointsToPlot.size() - 1, radius / 3, include) + 1;
-    
-    // generate base points for connecting lines with triangles
-    std::vector<OsmAnd::PointD> b1(pointsSimpleCount), b2(pointsSimpleCount), e1(pointsSimpleCount), e2(pointsSimpleCount), original(pointsSimpleCount);
-    double ntan = 0, nx1 = 0, ny1 = 0;
-    uint prevPointIdx = 0;
-    uint insertIdx = 0;
-    for (auto pointIdx = 0u; pointIdx < pointsCount; pointIdx++)
-    {
-        if(!include[pointIdx])
-        {
-            continue;
-        }
-        PointD pnt = pointsToPlot[pointIdx];
-        PointD prevPnt = pointsToPlot[prevPointIdx];
-        original[insertIdx]=pnt;
-        if(pointIdx > 0)
-        {
-            ntan = atan2(_points[pointIdx].x - _points[prevPointIdx].x,
-                            _points[pointIdx].y - _points[prevPointIdx].y);
-            nx1 = radius * sin(M_PI_2 - ntan) ;
-            ny1 = radius * cos(M_PI_2 - ntan) ;
-            e1[insertIdx] = b1[insertIdx] = OsmAnd::PointD(pnt.x - nx1, pnt.y + ny1);
-            e2[insertIdx] = b2[insertIdx] = OsmAnd::PointD(pnt.x + nx1, pnt.y - ny1);
-            e1[insertIdx-1] = OsmAnd::PointD(prevPnt.x - nx1, prevPnt.y + ny1);
-            e2[insertIdx-1] = OsmAnd::PointD(prevPnt.x + nx1, prevPnt.y - ny1);
-        } else {
-            b2[insertIdx] = b1[insertIdx] = pnt;
-        }
-        prevPointIdx = pointIdx;
-        insertIdx++;
-    }
-    
+
     verticesAndIndexes->position31 = new PointI(vectorLine->position31.x, vectorLine->position31.y);
-    
-    std::vector<VectorMapSymbol::Vertex> vertices;
-    VectorMapSymbol::Vertex vertex;
-    VectorMapSymbol::Vertex* pVertex = &vertex;
-    
-    //OsmAnd::LogPrintf(OsmAnd::LogSeverityLevel::Info, "=== pointsCount=%d zoom=%d visualZoom=%f metersPerPixel=%f radius=%f simpleCount=%d cnt=%d", verticesAndIndexes->verticesCount,
-    //  _mapZoomLevel, _mapVisualZoom, _metersPerPixel, radius, pointsSimpleCount,pointsCount);
-    bool direction = true;
-    
-    // generate triangles
-    for (auto pointIdx = 0u; pointIdx < pointsSimpleCount; pointIdx++)
+
     {
-        
-        if (pointIdx == 0)
-        {
-            pVertex->positionXY[0] = e2[pointIdx].x;
-            pVertex->positionXY[1] = e2[pointIdx].y;
-            pVertex->color = owner->fillColor;
-            vertices.push_back(vertex);
-            
-            pVertex->positionXY[0] = e1[pointIdx].x;
-            pVertex->positionXY[1] = e1[pointIdx].y;
-            pVertex->color = owner->fillColor;
-            vertices.push_back(vertex);
-            
-            direction = true;
-        }
-        else if (pointIdx == pointsSimpleCount - 1)
+        QMutexLocker scopedLocker(&_geometryMutex);
+
+        // Simplification and tessellation are reused as long as zoom and clip area stay the same,
+        // and only extended for appended points
+        updateTessellation();
+
+        const auto& vertices = _tessellation.vertices;
+        if (vertices.empty())
         {
-            if(!direction) {
-                pVertex->positionXY[0] = b1[pointIdx].x;
-                pVertex->positionXY[1] = b1[pointIdx].y;
-                pVertex->color = owner->fillColor;
-                vertices.push_back(vertex);
-            }
-            
-            pVertex->positionXY[0] = b2[pointIdx].x;
-            pVertex->positionXY[1] = b2[pointIdx].y;
-            pVertex->color = owner->fillColor;
-            vertices.push_back(vertex);
-            if(direction) {
-                pVertex->positionXY[0] = b1[pointIdx].x;
-                pVertex->positionXY[1] = b1[pointIdx].y;
-                pVertex->color = owner->fillColor;
-                vertices.push_back(vertex);
+            // Whole line is clipped out, yet mesh can't be empty
+            verticesAndIndexes->verticesCount = 3;
+            verticesAndIndexes->vertices = new VectorMapSymbol::Vertex[3];
+            for (auto vertexIdx = 0u; vertexIdx < verticesAndIndexes->verticesCount; vertexIdx++)
+            {
+                auto& vertex = verticesAndIndexes->vertices[vertexIdx];
+                vertex.positionXY[0] = 0.0f;
+                vertex.positionXY[1] = 0.0f;
+                vertex.color = owner->fillColor;
             }
         }
         else
         {
-            int smoothLevel = 1; // could be constant & could be dynamic depends on the angle
-            PointD l1 = findLineIntersection(e1[pointIdx-1], b1[pointIdx], e1[pointIdx], b1[pointIdx+1]);
-            PointD l2 = findLineIntersection(e2[pointIdx-1], b2[pointIdx], e2[pointIdx], b2[pointIdx+1]);
-            bool l1Intersects = (l1.x >= qMin(e1[pointIdx-1].x,b1[pointIdx].x)
-                                  && l1.x <= qMax(e1[pointIdx-1].x,b1[pointIdx].x)) ||
-                                (l1.x >= qMin(e1[pointIdx].x,b1[pointIdx+1].x)
-                                  && l1.x <= qMax(e1[pointIdx].x,b1[pointIdx+1].x));
-            bool l2Intersects = (l2.x >= qMin(e2[pointIdx-1].x,b2[pointIdx].x)
-                                 && l2.x <= qMax(e2[pointIdx-1].x,b2[pointIdx].x)) ||
-                                (l2.x >= qMin(e2[pointIdx].x,b2[pointIdx+1].x)
-                                 && l2.x <= qMax(e2[pointIdx].x,b2[pointIdx+1].x));
-            
-            // bewel - connecting only 3 points (one excluded depends on angle)
-            // miter - connecting 4 points
-            // round - generating between 2-3 point triangles (in place of triangle different between bewel/miter)
-            
-            if(!l2Intersects && !l1Intersects) {
-                // skip point
-            } else {
-                bool startDirection = l2Intersects;
-                const PointD& lp = startDirection ? l2 : l1;
-                const std::vector<OsmAnd::PointD>& bp = startDirection ? b1 : b2;
-                const std::vector<OsmAnd::PointD>& ep = startDirection ? e1 : e2;
-                int phase = direction == startDirection ? 0 : 2;
-                if(phase % 3 == 0) {
-                    pVertex->positionXY[0] = lp.x;
-                    pVertex->positionXY[1] = lp.y;
-                    pVertex->color = owner->fillColor;
-                    vertices.push_back(vertex);
-                    phase++;
-                }
-                
-                pVertex->positionXY[0] = bp[pointIdx].x;
-                pVertex->positionXY[1] = bp[pointIdx].y;
-                pVertex->color = owner->fillColor;
-                vertices.push_back(vertex);
-                phase++;
-                if(phase % 3 == 0) {
-                    pVertex->positionXY[0] = lp.x;
-                    pVertex->positionXY[1] = lp.y;
-                    pVertex->color = owner->fillColor;
-                    vertices.push_back(vertex);
-                    phase++;
-                }
-                
-                
-                if(smoothLevel > 0) {
-                    double dv = 1.0 / (1 << smoothLevel);
-                    double nt = dv;
-                    while(nt < 1) {
-                        double rx = bp[pointIdx].x*nt + ep[pointIdx].x*(1-nt);
-                        double ry = bp[pointIdx].y*nt + ep[pointIdx].y*(1-nt);
-                        double ld = (rx-original[pointIdx].x)*(rx-original[pointIdx].x) +
-                                    (ry-original[pointIdx].y)*(ry-original[pointIdx].y);
-                        pVertex->positionXY[0] = original[pointIdx].x + radius/sqrt(ld)*(rx-original[pointIdx].x);
-                        pVertex->positionXY[1] = original[pointIdx].y + radius/sqrt(ld)*(ry-original[pointIdx].y);
-                        pVertex->color = owner->fillColor;
-                        vertices.push_back(vertex);
-                        phase++;
-                        if(phase % 3 == 0) {
-                            // avoid overlap
-                            vertices.push_back(vertex);
-                            
-                            pVertex->positionXY[0] = lp.x;
-                            pVertex->positionXY[1] = lp.y;
-                            pVertex->color = owner->fillColor;
-                            vertices.push_back(vertex);
-                            phase++;
-                        }
-                        nt += dv;
-                    }
-                }
-                
-                
-                pVertex->positionXY[0] = ep[pointIdx].x;
-                pVertex->positionXY[1] = ep[pointIdx].y;
-                pVertex->color = owner->fillColor;
-                vertices.push_back(vertex);
-                phase++;
-                if(phase % 3 == 0) {
-                    // avoid overlap
-                    vertices.push_back(vertex);
-                    
-                    pVertex->positionXY[0] = lp.x;
-                    pVertex->positionXY[1] = lp.y;
-                    pVertex->color = owner->fillColor;
-                    vertices.push_back(vertex);
-                    phase++;
-                }
-                if(smoothLevel > 0) {
-                    //direction = direction;
-                } else {
-                    direction = !direction;
-                }
-            }
-
-            
+            verticesAndIndexes->verticesCount = vertices.size();
+            verticesAndIndexes->vertices = new VectorMapSymbol::Vertex[vertices.size()];
+            std::copy(vertices.begin(), vertices.end(), verticesAndIndexes->vertices);
         }
     }
-    
-    //verticesAndIndexes->verticesCount = (pointsSimpleCount - 2) * 2 + 2 * 2;
-    verticesAndIndexes->verticesCount = vertices.size();
-    verticesAndIndexes->vertices = new VectorMapSymbol::Vertex[vertices.size()];
-    std::copy(vertices.begin(), vertices.end(), verticesAndIndexes->vertices);
 
     vectorLine->isHidden = _isHidden;
-    
+
     vectorLine->setVerticesAndIndexes(verticesAndIndexes);
-    
+
     return vectorLine;
 }
 
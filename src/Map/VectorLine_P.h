@@ -2,9 +2,12 @@
 #define _OSMAND_CORE_MAP_LINE_P_H_
 
 #include "stdlib_common.h"
+#include <array>
+#include <vector>
 
 #include "QtExtensions.h"
 #include <QReadWriteLock>
+#include <QMutex>
 #include <QHash>
 #include <QVector>
 
@@ -29,6 +32,51 @@ namespace OsmAnd
         Q_DISABLE_COPY_AND_MOVE(VectorLine_P);
 
     private:
+        enum : int {
+            // Simplification is done per chunk of points, so appending points affects only the last chunk
+            SimplificationChunkSize = 512,
+            // Only segments within that many tiles from target are tessellated
+            ClipAreaTilesRadius = 16,
+        };
+
+        struct Tessellation
+        {
+            Tessellation();
+
+            bool isValid;
+            ZoomLevel zoomLevel;
+            double radius;
+            AreaI clipArea31;
+            int pointsCount;
+
+            // Offset of first vertex generated for each simplified point
+            QVector<int> piecesOffsets;
+            std::vector<VectorMapSymbol::Vertex> vertices;
+        };
+
+        // Geometry caches are shared by all symbols groups and are built lazily, so they're guarded separately
+        mutable QMutex _geometryMutex;
+        // Point is kept by simplification while tolerance doesn't exceed its significance
+        mutable QVector<double> _pointsSignificance;
+        // Simplified points for each zoom level, empty if not yet computed
+        mutable std::array<QVector<int>, ZoomLevelsCount> _simplifiedPointsIndices;
+        mutable Tessellation _tessellation;
+
+        void invalidateGeometry();
+        void updatePointsSignificance() const;
+        const QVector<int>& getSimplifiedPointsIndices(const ZoomLevel zoomLevel) const;
+        void updateTessellation() const;
+        void tessellatePiece(
+            const QVector<int>& pointsIndices,
+            const int position,
+            const double radius,
+            const AreaI& clipArea31,
+            std::vector<VectorMapSymbol::Vertex>& vertices) const;
+        bool isSegmentVisible(const QVector<int>& pointsIndices, const int position, const AreaI& clipArea31) const;
+        double getRadius(const ZoomLevel zoomLevel, const float zoom) const;
+        AreaI getClipArea31() const;
+
+        static int getLastChunkStart(const int pointsCount);
     protected:
         VectorLine_P(VectorLine* const owner);
 
@@ -44,6 +92,7 @@ namespace OsmAnd
         ZoomLevel _mapZoomLevel;
         float _mapVisualZoom;
         float _mapVisualZoomShift;
+        PointI _mapTarget31;
 
         float zoom() const;
 
@@ -68,9 +117,6 @@ namespace OsmAnd
         PointD getProjection(PointD point, PointD from, PointD to ) const;
         double scalarMultiplication(double xA, double yA, double xB, double yB, double xC, double yC) const;
         
-        int simplifyDouglasPeucker(std::vector<PointD>& points, uint begin, uint end, double epsilon,
-                                   std::vector<bool>& include) const;
-        
     public:
         virtual ~VectorLine_P();
 
@@ -81,6 +127,7 @@ namespace OsmAnd
 
         QVector<PointI> getPoints() const;
         void setPoints(const QVector<PointI>& points);
+        void appendPoints(const QVector<PointI>& points);
 
         bool hasUnappliedChanges() const;
         bool hasUnappliedPrimitiveChanges() const;
@@ -27,6 +27,7 @@
 #include "EmbeddedFontFinder_internal.h"
 #include "TextRasterizer_internal.h"
 #include "MapSymbolIntersectionClassesRegistry_private.h"
+#include "RasterizedTextCache_private.h"
 
 #if defined(OSMAND_TARGET_OS_)
 #   error CMAKE_TARGET_OS defined incorrectly
@@ -132,6 +133,7 @@ OSMAND_CORE_API bool OSMAND_CORE_CALL OsmAnd::InitializeCore(const std::shared_p
     EmbeddedFontFinder_initialize();
     TextRasterizer_initialize();
     MapSymbolIntersectionClassesRegistry_initializeGlobalInstance();
+    RasterizedTextCache_initializeGlobalInstance();
 
     return true;
 }
@@ -154,6 +156,7 @@ OSMAND_CORE_API void OSMAND_CORE_CALL OsmAnd::ReleaseCore()
         releaseInAppThread();
     }
 
+    RasterizedTextCache_releaseGlobalInstance();
     MapSymbolIntersectionClassesRegistry_releaseGlobalInstance();
     EmbeddedFontFinder_release();
     TextRasterizer_release();
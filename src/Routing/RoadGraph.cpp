@@ -0,0 +1,91 @@
+#include "RoadGraph.h"
+#include "RoadGraph_P.h"
+
+#include "QtExtensions.h"
+#include <QSet>
+
+#include "ObfDataInterface.h"
+#include "Road.h"
+
+OsmAnd::RoadGraph::RoadGraph()
+    : _p(new RoadGraph_P(this))
+{
+}
+
+OsmAnd::RoadGraph::~RoadGraph()
+{
+}
+
+unsigned int OsmAnd::RoadGraph::getNodesCount() const
+{
+    return _p->nodesPositions31.size();
+}
+
+unsigned int OsmAnd::RoadGraph::getEdgesCount() const
+{
+    return _p->outEdgesTargets.size();
+}
+
+unsigned int OsmAnd::RoadGraph::getRoadsCount() const
+{
+    return _p->roads.size();
+}
+
+OsmAnd::PointI OsmAnd::RoadGraph::getNodePosition31(const NodeIndex nodeIndex) const
+{
+    return _p->nodesPositions31[nodeIndex];
+}
+
+OsmAnd::RoadGraph::NodeIndex OsmAnd::RoadGraph::findNearestNode(const PointI& point31) const
+{
+    return _p->findNearestNode(point31);
+}
+
+float OsmAnd::RoadGraph::getMaxSpeed() const
+{
+    return _p->maxSpeed;
+}
+
+std::shared_ptr<const OsmAnd::RoadGraph> OsmAnd::RoadGraph::build(
+    const QList< std::shared_ptr<const Road> >& roads,
+    const std::shared_ptr<RoutingProfileContext>& profileContext)
+{
+    const std::shared_ptr<RoadGraph> graph(new RoadGraph());
+    graph->_p->build(roads, profileContext);
+    return graph;
+}
+
+std::shared_ptr<const OsmAnd::RoadGraph> OsmAnd::RoadGraph::load(
+    const std::shared_ptr<ObfDataInterface>& dataInterface,
+    const std::shared_ptr<RoutingProfileContext>& profileContext,
+    const AreaI* const bbox31 /*= nullptr*/,
+    const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/)
+{
+    QList< std::shared_ptr<const Road> > loadedRoads;
+    const auto loaded = dataInterface->loadRoads(
+        RoutingDataLevel::Detailed,
+        bbox31,
+        &loadedRoads,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        queryController);
+    if (!loaded)
+        return nullptr;
+
+    // Same road may be stored in several files with overlapping areas
+    QList< std::shared_ptr<const Road> > roads;
+    QSet<uint64_t> roadsIds;
+    roads.reserve(loadedRoads.size());
+    for (const auto& road : constOf(loadedRoads))
+    {
+        if (roadsIds.contains(road->id.id))
+            continue;
+        roadsIds.insert(road->id.id);
+
+        roads.push_back(road);
+    }
+
+    return build(roads, profileContext);
+}
@@ -0,0 +1,496 @@
+#include "RoadGraph_P.h"
+#include "RoadGraph.h"
+
+#include <cmath>
+#include <limits>
+
+#include "QtExtensions.h"
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
+
+#include "Road.h"
+#include "RoutingProfile.h"
+#include "RoutingProfileContext.h"
+#include "Tracing.h"
+#include "Utilities.h"
+
+namespace
+{
+    struct PendingEdge
+    {
+        OsmAnd::RoadGraph::NodeIndex source;
+        OsmAnd::RoadGraph::NodeIndex target;
+        float time;
+        float distance;
+        uint32_t road;
+        uint32_t firstPoint;
+        uint32_t lastPoint;
+    };
+
+    inline uint64_t getPointKey(const OsmAnd::PointI& point31)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(point31.x)) << 32) | static_cast<uint32_t>(point31.y);
+    }
+
+    float getRoadSpeed(const OsmAnd::RoutingProfileContext::RoadRules& rules, const OsmAnd::RoutingProfile& profile)
+    {
+        auto speed = rules.speed * rules.priority;
+        if (qFuzzyIsNull(speed))
+            speed = profile.minDefaultSpeed * rules.priority;
+
+        // Speed can not exceed max default speed, since it's used for estimates
+        if (speed > profile.maxDefaultSpeed)
+            speed = profile.maxDefaultSpeed;
+
+        return speed;
+    }
+
+    inline bool isOnlyRestriction(const OsmAnd::RoadRestriction restriction)
+    {
+        return restriction >= OsmAnd::RoadRestriction::OnlyRightTurn && restriction <= OsmAnd::RoadRestriction::OnlyStraightOn;
+    }
+
+    inline bool isNoRestriction(const OsmAnd::RoadRestriction restriction)
+    {
+        return restriction >= OsmAnd::RoadRestriction::NoRightTurn && restriction <= OsmAnd::RoadRestriction::NoStraightOn;
+    }
+
+    // Restriction is stored in road it starts from and applies at node shared with destination road. Incoming edge
+    // of such road, if some of outgoing edges of its target node are forbidden after it, is redirected to own copy
+    // of target node that has only allowed outgoing edges. Thus search over nodes respects restrictions as is.
+    void applyTurnRestrictions(
+        const QVector< std::shared_ptr<const OsmAnd::Road> >& roads,
+        QVector<PendingEdge>& pendingEdges,
+        QVector<OsmAnd::PointI>& nodesPositions31,
+        QMultiHash<OsmAnd::RoadGraph::NodeIndex, OsmAnd::RoadGraph::NodeIndex>& nodesCopies)
+    {
+        typedef OsmAnd::RoadGraph::NodeIndex NodeIndex;
+
+        // Edges (both incoming and outgoing ones) of nodes where restricted roads end up
+        QHash< NodeIndex, QVector<int> > viaNodesEdges;
+        for (const auto& edge : constOf(pendingEdges))
+        {
+            if (!roads[edge.road]->restrictions.isEmpty())
+                viaNodesEdges.insert(edge.target, QVector<int>());
+        }
+        if (viaNodesEdges.isEmpty())
+            return;
+        for (auto edgeIndex = 0; edgeIndex < pendingEdges.size(); edgeIndex++)
+        {
+            const auto& edge = pendingEdges[edgeIndex];
+            auto itViaNodeEdges = viaNodesEdges.find(edge.source);
+            if (itViaNodeEdges != viaNodesEdges.end())
+                itViaNodeEdges->push_back(edgeIndex);
+            itViaNodeEdges = viaNodesEdges.find(edge.target);
+            if (itViaNodeEdges != viaNodesEdges.end())
+                itViaNodeEdges->push_back(edgeIndex);
+        }
+
+        struct Split
+        {
+            int edge;
+            NodeIndex copy;
+            QVector<int> allowedEdges;
+        };
+        QList<Split> splits;
+        for (auto citViaNodeEdges = viaNodesEdges.cbegin(); citViaNodeEdges != viaNodesEdges.cend(); ++citViaNodeEdges)
+        {
+            const auto viaNode = citViaNodeEdges.key();
+            const auto viaNodePosition31 = nodesPositions31[viaNode];
+            const auto& viaNodeEdges = citViaNodeEdges.value();
+
+            QSet<uint64_t> viaNodeRoadsIds;
+            for (const auto edgeIndex : constOf(viaNodeEdges))
+                viaNodeRoadsIds.insert(roads[pendingEdges[edgeIndex].road]->id.id);
+
+            for (const auto incomingEdgeIndex : constOf(viaNodeEdges))
+            {
+                const auto& incomingEdge = pendingEdges[incomingEdgeIndex];
+                const auto& restrictions = roads[incomingEdge.road]->restrictions;
+                if (incomingEdge.target != viaNode || restrictions.isEmpty())
+                    continue;
+
+                // Only restrictions towards roads that pass via node apply here
+                auto hasOnlyRestriction = false;
+                for (auto citRestriction = restrictions.cbegin(); citRestriction != restrictions.cend(); ++citRestriction)
+                {
+                    if (isOnlyRestriction(citRestriction.value()) && viaNodeRoadsIds.contains(citRestriction.key().id))
+                        hasOnlyRestriction = true;
+                }
+
+                Split split;
+                split.edge = incomingEdgeIndex;
+                auto outgoingEdgesCount = 0;
+                for (const auto edgeIndex : constOf(viaNodeEdges))
+                {
+                    const auto& edge = pendingEdges[edgeIndex];
+                    if (edge.source != viaNode)
+                        continue;
+                    outgoingEdgesCount++;
+
+                    // Restriction from road to itself refers only to turning back along it
+                    const auto isSameRoad = (edge.road == incomingEdge.road);
+                    const auto isUTurn = isSameRoad
+                        && edge.firstPoint == incomingEdge.lastPoint
+                        && edge.lastPoint == incomingEdge.firstPoint;
+                    const auto restriction = (!isSameRoad || isUTurn)
+                        ? restrictions.value(roads[edge.road]->id, OsmAnd::RoadRestriction::Invalid)
+                        : OsmAnd::RoadRestriction::Invalid;
+
+                    const auto isAllowed = hasOnlyRestriction
+                        ? isOnlyRestriction(restriction)
+                        : !isNoRestriction(restriction);
+                    if (isAllowed)
+                        split.allowedEdges.push_back(edgeIndex);
+                }
+
+                if (split.allowedEdges.size() == outgoingEdgesCount)
+                    continue;
+
+                split.copy = nodesPositions31.size();
+                nodesPositions31.push_back(viaNodePosition31);
+                nodesCopies.insert(viaNode, split.copy);
+                splits.push_back(split);
+            }
+        }
+
+        // Edges are redirected before allowed ones are copied, so copy of restricted edge leads to copy of node too
+        for (const auto& split : constOf(splits))
+            pendingEdges[split.edge].target = split.copy;
+        for (const auto& split : constOf(splits))
+        {
+            for (const auto edgeIndex : constOf(split.allowedEdges))
+            {
+                auto edge = pendingEdges[edgeIndex];
+                edge.source = split.copy;
+                pendingEdges.push_back(edge);
+            }
+        }
+    }
+}
+
+OsmAnd::RoadGraph_P::RoadGraph_P(RoadGraph* const owner_)
+    : owner(owner_)
+    , gridCellSize31(1)
+    , gridColumns(0)
+    , gridRows(0)
+    , maxSpeed(0.0f)
+{
+}
+
+OsmAnd::RoadGraph_P::~RoadGraph_P()
+{
+}
+
+void OsmAnd::RoadGraph_P::build(
+    const QList< std::shared_ptr<const Road> >& roads_,
+    const std::shared_ptr<RoutingProfileContext>& profileContext)
+{
+    OSMAND_TRACE_SCOPE("RoadGraph", "build");
+
+    // Most roads share few sets of types, so way rules are taken from cache of profile context
+    QVector<float> roadsSpeeds;
+    QVector<RoadDirection> roadsDirections;
+    for (const auto& road : constOf(roads_))
+    {
+        if (road->points31.size() < 2)
+            continue;
+
+        const auto rules = profileContext->getRoadRules(road);
+        if (!rules.accepted)
+            continue;
+
+        const auto speed = getRoadSpeed(rules, *profileContext->profile);
+        if (speed <= 0.0f)
+            continue;
+
+        roads.push_back(road);
+        roadsSpeeds.push_back(speed);
+        roadsDirections.push_back(rules.getDirection());
+    }
+
+    // Points that are referenced more than once (including ends of roads, that are counted twice) become nodes
+    QHash<uint64_t, unsigned int> pointsReferencesCount;
+    for (const auto& road : constOf(roads))
+    {
+        const auto lastPointIndex = road->points31.size() - 1;
+        for (auto pointIndex = 0; pointIndex <= lastPointIndex; pointIndex++)
+        {
+            const auto increment = (pointIndex == 0 || pointIndex == lastPointIndex) ? 2u : 1u;
+            pointsReferencesCount[getPointKey(road->points31[pointIndex])] += increment;
+        }
+    }
+
+    QHash<uint64_t, NodeIndex> nodesIndices;
+    const auto obtainNode =
+        [this, &nodesIndices]
+        (const PointI& point31) -> NodeIndex
+        {
+            const auto key = getPointKey(point31);
+            const auto citNode = nodesIndices.constFind(key);
+            if (citNode != nodesIndices.cend())
+                return *citNode;
+
+            const NodeIndex nodeIndex = nodesPositions31.size();
+            nodesPositions31.push_back(point31);
+            nodesIndices.insert(key, nodeIndex);
+            return nodeIndex;
+        };
+
+    QVector<PendingEdge> pendingEdges;
+    for (auto roadIndex = 0; roadIndex < roads.size(); roadIndex++)
+    {
+        const auto& road = roads[roadIndex];
+        const auto& points31 = road->points31;
+
+        // Oneway rules give +1 for roads passable only in order of points and -1 for opposite order,
+        // that match RoadDirection::OneWayReverse and RoadDirection::OneWayForward values
+        const auto direction = roadsDirections[roadIndex];
+        const auto forwardAllowed = (direction != RoadDirection::OneWayForward);
+        const auto backwardAllowed = (direction != RoadDirection::OneWayReverse);
+        const auto speed = roadsSpeeds[roadIndex];
+
+        auto pieceSourceNode = obtainNode(points31[0]);
+        auto pieceFirstPoint = 0;
+        auto pieceDistance = 0.0;
+        auto pieceForwardObstaclesTime = 0.0f;
+        auto pieceBackwardObstaclesTime = 0.0f;
+        auto pieceForwardPassable = true;
+        auto pieceBackwardPassable = true;
+        auto previousPointObstacleTime = profileContext->getRoutingObstaclesExtraTime(road, 0);
+        for (auto pointIndex = 1; pointIndex < points31.size(); pointIndex++)
+        {
+            pieceDistance += Utilities::distance31(points31[pointIndex - 1], points31[pointIndex]);
+
+            // Obstacle is passed when point is reached, that's previous point in case of backward direction.
+            // Negative time means that obstacle can not be passed at all.
+            const auto pointObstacleTime = profileContext->getRoutingObstaclesExtraTime(road, pointIndex);
+            if (pointObstacleTime < 0.0f)
+                pieceForwardPassable = false;
+            else
+                pieceForwardObstaclesTime += pointObstacleTime;
+            if (previousPointObstacleTime < 0.0f)
+                pieceBackwardPassable = false;
+            else
+                pieceBackwardObstaclesTime += previousPointObstacleTime;
+            previousPointObstacleTime = pointObstacleTime;
+
+            if (pointsReferencesCount[getPointKey(points31[pointIndex])] < 2)
+                continue;
+
+            const auto pieceTargetNode = obtainNode(points31[pointIndex]);
+            if (pieceTargetNode != pieceSourceNode)
+            {
+                const auto time = static_cast<float>(pieceDistance / speed);
+
+                PendingEdge edge;
+                edge.distance = static_cast<float>(pieceDistance);
+                edge.road = roadIndex;
+                if (forwardAllowed && pieceForwardPassable)
+                {
+                    edge.source = pieceSourceNode;
+                    edge.target = pieceTargetNode;
+                    edge.time = time + pieceForwardObstaclesTime;
+                    edge.firstPoint = pieceFirstPoint;
+                    edge.lastPoint = pointIndex;
+                    pendingEdges.push_back(edge);
+                }
+                if (backwardAllowed && pieceBackwardPassable)
+                {
+                    edge.source = pieceTargetNode;
+                    edge.target = pieceSourceNode;
+                    edge.time = time + pieceBackwardObstaclesTime;
+                    edge.firstPoint = pointIndex;
+                    edge.lastPoint = pieceFirstPoint;
+                    pendingEdges.push_back(edge);
+                }
+                if ((forwardAllowed && pieceForwardPassable) || (backwardAllowed && pieceBackwardPassable))
+                    maxSpeed = qMax(maxSpeed, speed);
+            }
+
+            pieceSourceNode = pieceTargetNode;
+            pieceFirstPoint = pointIndex;
+            pieceDistance = 0.0;
+            pieceForwardObstaclesTime = 0.0f;
+            pieceBackwardObstaclesTime = 0.0f;
+            pieceForwardPassable = true;
+            pieceBackwardPassable = true;
+        }
+    }
+
+    applyTurnRestrictions(roads, pendingEdges, nodesPositions31, nodesCopies);
+
+    // Group edges by source node
+    const auto nodesCount = nodesPositions31.size();
+    const auto edgesCount = pendingEdges.size();
+    outEdgesOffsets.fill(0, nodesCount + 1);
+    for (const auto& edge : constOf(pendingEdges))
+        outEdgesOffsets[edge.source + 1]++;
+    for (auto nodeIndex = 0; nodeIndex < nodesCount; nodeIndex++)
+        outEdgesOffsets[nodeIndex + 1] += outEdgesOffsets[nodeIndex];
+
+    outEdgesTargets.resize(edgesCount);
+    outEdgesTimes.resize(edgesCount);
+    edgesRoads.resize(edgesCount);
+    edgesFirstPoints.resize(edgesCount);
+    edgesLastPoints.resize(edgesCount);
+    edgesDistances.resize(edgesCount);
+    auto nextOutEdges = outEdgesOffsets;
+    for (const auto& edge : constOf(pendingEdges))
+    {
+        const auto edgeIndex = nextOutEdges[edge.source]++;
+        outEdgesTargets[edgeIndex] = edge.target;
+        outEdgesTimes[edgeIndex] = edge.time;
+        edgesRoads[edgeIndex] = edge.road;
+        edgesFirstPoints[edgeIndex] = edge.firstPoint;
+        edgesLastPoints[edgeIndex] = edge.lastPoint;
+        edgesDistances[edgeIndex] = edge.distance;
+    }
+    pendingEdges.clear();
+
+    // Group same edges by target node
+    inEdgesOffsets.fill(0, nodesCount + 1);
+    for (const auto target : constOf(outEdgesTargets))
+        inEdgesOffsets[target + 1]++;
+    for (auto nodeIndex = 0; nodeIndex < nodesCount; nodeIndex++)
+        inEdgesOffsets[nodeIndex + 1] += inEdgesOffsets[nodeIndex];
+
+    inEdgesSources.resize(edgesCount);
+    inEdgesTimes.resize(edgesCount);
+    inEdgesIds.resize(edgesCount);
+    auto nextInEdges = inEdgesOffsets;
+    for (auto nodeIndex = 0; nodeIndex < nodesCount; nodeIndex++)
+    {
+        for (auto edgeIndex = outEdgesOffsets[nodeIndex]; edgeIndex < outEdgesOffsets[nodeIndex + 1]; edgeIndex++)
+        {
+            const auto inEdgeIndex = nextInEdges[outEdgesTargets[edgeIndex]]++;
+            inEdgesSources[inEdgeIndex] = nodeIndex;
+            inEdgesTimes[inEdgeIndex] = outEdgesTimes[edgeIndex];
+            inEdgesIds[inEdgeIndex] = edgeIndex;
+        }
+    }
+
+    buildNodesGrid();
+}
+
+int OsmAnd::RoadGraph_P::getGridColumn(const int32_t x31) const
+{
+    const auto column = (static_cast<int64_t>(x31) - gridOrigin31.x) / gridCellSize31;
+    return static_cast<int>(qBound<int64_t>(0, column, gridColumns - 1));
+}
+
+int OsmAnd::RoadGraph_P::getGridRow(const int32_t y31) const
+{
+    const auto row = (static_cast<int64_t>(y31) - gridOrigin31.y) / gridCellSize31;
+    return static_cast<int>(qBound<int64_t>(0, row, gridRows - 1));
+}
+
+void OsmAnd::RoadGraph_P::buildNodesGrid()
+{
+    gridCellSize31 = 1;
+    gridColumns = 0;
+    gridRows = 0;
+    gridCellsOffsets.clear();
+    gridNodes.clear();
+
+    const auto nodesCount = nodesPositions31.size();
+    if (nodesCount == 0)
+        return;
+
+    auto left = std::numeric_limits<int32_t>::max();
+    auto top = std::numeric_limits<int32_t>::max();
+    auto right = std::numeric_limits<int32_t>::min();
+    auto bottom = std::numeric_limits<int32_t>::min();
+    for (const auto& position31 : constOf(nodesPositions31))
+    {
+        left = qMin(left, position31.x);
+        top = qMin(top, position31.y);
+        right = qMax(right, position31.x);
+        bottom = qMax(bottom, position31.y);
+    }
+    gridOrigin31 = PointI(left, top);
+
+    // Square cells, but not less than needed to keep cells count close to desired one in case nodes are along a line
+    const auto width = static_cast<int64_t>(right) - left + 1;
+    const auto height = static_cast<int64_t>(bottom) - top + 1;
+    const auto desiredCellsCount = qMax(1, nodesCount / NodesPerGridCell);
+    const auto cellSize = qMax(
+        static_cast<int64_t>(std::ceil(std::sqrt(static_cast<double>(width) * height / desiredCellsCount))),
+        (qMax(width, height) + desiredCellsCount - 1) / desiredCellsCount);
+    gridCellSize31 = static_cast<int32_t>(qBound<int64_t>(1, cellSize, std::numeric_limits<int32_t>::max()));
+    gridColumns = static_cast<int>((width + gridCellSize31 - 1) / gridCellSize31);
+    gridRows = static_cast<int>((height + gridCellSize31 - 1) / gridCellSize31);
+
+    const auto cellsCount = gridColumns * gridRows;
+    gridCellsOffsets.fill(0, cellsCount + 1);
+    for (const auto& position31 : constOf(nodesPositions31))
+        gridCellsOffsets[getGridRow(position31.y) * gridColumns + getGridColumn(position31.x) + 1]++;
+    for (auto cellIndex = 0; cellIndex < cellsCount; cellIndex++)
+        gridCellsOffsets[cellIndex + 1] += gridCellsOffsets[cellIndex];
+
+    gridNodes.resize(nodesCount);
+    auto nextCellNodes = gridCellsOffsets;
+    for (auto nodeIndex = 0; nodeIndex < nodesCount; nodeIndex++)
+    {
+        const auto& position31 = nodesPositions31[nodeIndex];
+        gridNodes[nextCellNodes[getGridRow(position31.y) * gridColumns + getGridColumn(position31.x)]++] = nodeIndex;
+    }
+}
+
+OsmAnd::RoadGraph_P::NodeIndex OsmAnd::RoadGraph_P::getEdgeSource(const EdgeIndex edgeIndex) const
+{
+    // Source is the last node which outgoing edges start at or before given edge
+    const auto citOffset = std::upper_bound(outEdgesOffsets.cbegin(), outEdgesOffsets.cend(), edgeIndex);
+    return static_cast<NodeIndex>(citOffset - outEdgesOffsets.cbegin()) - 1;
+}
+
+OsmAnd::RoadGraph_P::NodeIndex OsmAnd::RoadGraph_P::findNearestNode(const PointI& point31) const
+{
+    NodeIndex nearestNodeIndex = RoadGraph::InvalidIndex;
+    if (gridNodes.isEmpty())
+        return nearestNodeIndex;
+
+    // Cells are visited in rings around cell of point (or nearest one in case point is outside of grid),
+    // nodes in ring R are at least R - 1 cells away from point
+    const auto column = getGridColumn(point31.x);
+    const auto row = getGridRow(point31.y);
+    const auto maxRing = qMax(qMax(column, gridColumns - 1 - column), qMax(row, gridRows - 1 - row));
+    const auto cellSizeInMeters = qMin(Utilities::x31toMeters(gridCellSize31), Utilities::y31toMeters(gridCellSize31));
+    auto minSquareDistance = std::numeric_limits<double>::max();
+    for (auto ring = 0; ring <= maxRing; ring++)
+    {
+        const auto ringDistance = (ring - 1) * cellSizeInMeters;
+        if (ring > 1 && ringDistance * ringDistance >= minSquareDistance)
+            break;
+
+        for (auto cellRow = qMax(0, row - ring); cellRow <= qMin(gridRows - 1, row + ring); cellRow++)
+        {
+            // Inner rows of ring have only first and last cells
+            const auto isOuterRow = (cellRow == row - ring || cellRow == row + ring);
+            const auto columnStep = (isOuterRow || ring == 0) ? 1 : 2 * ring;
+            for (auto cellColumn = column - ring; cellColumn <= column + ring; cellColumn += columnStep)
+            {
+                if (cellColumn < 0 || cellColumn >= gridColumns)
+                    continue;
+
+                const auto cellIndex = cellRow * gridColumns + cellColumn;
+                for (auto gridNodeIndex = gridCellsOffsets[cellIndex]; gridNodeIndex < gridCellsOffsets[cellIndex + 1]; gridNodeIndex++)
+                {
+                    const auto nodeIndex = gridNodes[gridNodeIndex];
+                    const auto squareDistance = Utilities::squareDistance31(nodesPositions31[nodeIndex], point31);
+                    if (squareDistance > minSquareDistance)
+                        continue;
+
+                    // Original node is preferred to its copies that have same position
+                    if (squareDistance == minSquareDistance && nodeIndex > nearestNodeIndex)
+                        continue;
+
+                    minSquareDistance = squareDistance;
+                    nearestNodeIndex = nodeIndex;
+                }
+            }
+        }
+    }
+    return nearestNodeIndex;
+}
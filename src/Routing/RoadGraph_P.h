@@ -0,0 +1,95 @@
+#ifndef _OSMAND_CORE_ROAD_GRAPH_P_H_
+#define _OSMAND_CORE_ROAD_GRAPH_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include <QList>
+#include <QMultiHash>
+#include <QVector>
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "RoadGraph.h"
+
+namespace OsmAnd
+{
+    class Road;
+    class RoutingProfileContext;
+
+    class RoadGraph;
+    class RoadGraph_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoadGraph_P);
+    public:
+        typedef RoadGraph::NodeIndex NodeIndex;
+        typedef RoadGraph::EdgeIndex EdgeIndex;
+
+    private:
+        enum : int {
+            // Average count of nodes in cell of nodes grid
+            NodesPerGridCell = 4,
+        };
+
+        int getGridColumn(const int32_t x31) const;
+        int getGridRow(const int32_t y31) const;
+        void buildNodesGrid();
+    protected:
+        RoadGraph_P(RoadGraph* const owner);
+    public:
+        ~RoadGraph_P();
+
+        ImplementationInterface<RoadGraph> owner;
+
+        // Roads that edges were made of
+        QVector< std::shared_ptr<const Road> > roads;
+
+        QVector<PointI> nodesPositions31;
+
+        // Copies of nodes that were split by turn restrictions, by original node. Copy has same position as
+        // original node and is target of restricted incoming edge, outgoing edges of copy are only allowed ones.
+        QMultiHash<NodeIndex, NodeIndex> nodesCopies;
+
+        // Outgoing edges of node N are [outEdgesOffsets[N], outEdgesOffsets[N + 1]).
+        // Edge index is a position in these arrays.
+        QVector<uint32_t> outEdgesOffsets;
+        QVector<NodeIndex> outEdgesTargets;
+        QVector<float> outEdgesTimes;
+
+        // Incoming edges of node N are [inEdgesOffsets[N], inEdgesOffsets[N + 1]),
+        // each one refers to index of same edge in outgoing arrays
+        QVector<uint32_t> inEdgesOffsets;
+        QVector<NodeIndex> inEdgesSources;
+        QVector<float> inEdgesTimes;
+        QVector<EdgeIndex> inEdgesIds;
+
+        // Geometry of each edge: road and its points from first to last one (in order of passing)
+        QVector<uint32_t> edgesRoads;
+        QVector<uint32_t> edgesFirstPoints;
+        QVector<uint32_t> edgesLastPoints;
+        QVector<float> edgesDistances;
+
+        // Nodes grouped by cells of uniform grid that covers all nodes, nodes of cell C (that's row * columns + column)
+        // are gridNodes[gridCellsOffsets[C], gridCellsOffsets[C + 1])
+        PointI gridOrigin31;
+        int32_t gridCellSize31;
+        int gridColumns;
+        int gridRows;
+        QVector<uint32_t> gridCellsOffsets;
+        QVector<NodeIndex> gridNodes;
+
+        float maxSpeed;
+
+        void build(
+            const QList< std::shared_ptr<const Road> >& roads,
+            const std::shared_ptr<RoutingProfileContext>& profileContext);
+
+        NodeIndex getEdgeSource(const EdgeIndex edgeIndex) const;
+        NodeIndex findNearestNode(const PointI& point31) const;
+
+    friend class OsmAnd::RoadGraph;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ROAD_GRAPH_P_H_)
@@ -0,0 +1,447 @@
+#include "RoutePlanner_P.h"
+#include "RoutePlanner.h"
+
+#include "QtExtensions.h"
+
+#include "RoadGraph_P.h"
+#include "RouteSegment.h"
+#include "Road.h"
+#include "Tracing.h"
+#include "Utilities.h"
+
+OsmAnd::RoutePlanner_P::RoutePlanner_P(RoutePlanner* const owner_)
+    : _graph(nullptr)
+    , _inverseMaxSpeed(0.0f)
+    , _generation(0)
+    , _bestTime(std::numeric_limits<float>::infinity())
+    , _meetingNode(RoadGraph::InvalidIndex)
+    , owner(owner_)
+    , lastSettledNodesCount(0)
+{
+}
+
+OsmAnd::RoutePlanner_P::~RoutePlanner_P()
+{
+}
+
+void OsmAnd::RoutePlanner_P::initialize()
+{
+    _graph = owner->graph->_p.get();
+
+    const auto maxSpeed = _graph->maxSpeed;
+    _inverseMaxSpeed = (maxSpeed > 0.0f) ? 1.0f / maxSpeed : 0.0f;
+
+    const auto nodesCount = _graph->nodesPositions31.size();
+    for (auto direction = 0; direction < SearchDirectionsCount; direction++)
+    {
+        _times[direction].resize(nodesCount);
+        _stamps[direction].fill(0, nodesCount);
+        _parentNodes[direction].resize(nodesCount);
+        _parentEdges[direction].resize(nodesCount);
+    }
+}
+
+void OsmAnd::RoutePlanner_P::beginSearch(const PointI& start31, const PointI& end31)
+{
+    // Instead of clearing labels of all nodes, labels of previous search are invalidated by new generation
+    _generation++;
+    if (_generation == 0)
+    {
+        for (auto direction = 0; direction < SearchDirectionsCount; direction++)
+            _stamps[direction].fill(0);
+        _generation = 1;
+    }
+
+    for (auto direction = 0; direction < SearchDirectionsCount; direction++)
+        _heaps[direction].clear();
+
+    _start31 = start31;
+    _end31 = end31;
+    _bestTime = std::numeric_limits<float>::infinity();
+    _meetingNode = RoadGraph::InvalidIndex;
+    lastSettledNodesCount = 0;
+}
+
+float OsmAnd::RoutePlanner_P::getPotential(const NodeIndex node) const
+{
+    // Average of estimates to end and from start keeps potentials of both directions consistent,
+    // so search may stop as soon as sum of top keys reaches best found time
+    const auto& position31 = _graph->nodesPositions31[node];
+    const auto timeToEnd = Utilities::distance31(position31, _end31) * _inverseMaxSpeed;
+    const auto timeFromStart = Utilities::distance31(_start31, position31) * _inverseMaxSpeed;
+    return static_cast<float>((timeToEnd - timeFromStart) * 0.5);
+}
+
+inline bool OsmAnd::RoutePlanner_P::isReached(const SearchDirection direction, const NodeIndex node) const
+{
+    return _stamps[direction][node] == _generation;
+}
+
+void OsmAnd::RoutePlanner_P::updateLabel(
+    const SearchDirection direction,
+    const NodeIndex node,
+    const float time,
+    const NodeIndex parentNode,
+    const EdgeIndex parentEdge)
+{
+    if (isReached(direction, node) && _times[direction][node] <= time)
+        return;
+
+    _stamps[direction][node] = _generation;
+    _times[direction][node] = time;
+    _parentNodes[direction][node] = parentNode;
+    _parentEdges[direction][node] = parentEdge;
+
+    HeapEntry entry;
+    entry.time = time;
+    entry.node = node;
+    entry.key = time + (direction == Forward ? getPotential(node) : -getPotential(node));
+    auto& heap = _heaps[direction];
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end());
+
+    const auto oppositeDirection = (direction == Forward) ? Backward : Forward;
+    if (isReached(oppositeDirection, node))
+    {
+        const auto routeTime = time + _times[oppositeDirection][node];
+        if (routeTime < _bestTime)
+        {
+            _bestTime = routeTime;
+            _meetingNode = node;
+        }
+    }
+}
+
+void OsmAnd::RoutePlanner_P::expand(const SearchDirection direction, const NodeIndex node, const float time)
+{
+    if (direction == Forward)
+    {
+        const auto edgesEnd = _graph->outEdgesOffsets[node + 1];
+        for (auto edge = _graph->outEdgesOffsets[node]; edge < edgesEnd; edge++)
+            updateLabel(Forward, _graph->outEdgesTargets[edge], time + _graph->outEdgesTimes[edge], node, edge);
+    }
+    else
+    {
+        const auto edgesEnd = _graph->inEdgesOffsets[node + 1];
+        for (auto inEdge = _graph->inEdgesOffsets[node]; inEdge < edgesEnd; inEdge++)
+        {
+            updateLabel(
+                Backward,
+                _graph->inEdgesSources[inEdge],
+                time + _graph->inEdgesTimes[inEdge],
+                node,
+                _graph->inEdgesIds[inEdge]);
+        }
+    }
+}
+
+bool OsmAnd::RoutePlanner_P::search()
+{
+    OSMAND_TRACE_SCOPE("RoutePlanner", "search");
+
+    auto& forwardHeap = _heaps[Forward];
+    auto& backwardHeap = _heaps[Backward];
+    while (!forwardHeap.empty() && !backwardHeap.empty())
+    {
+        if (forwardHeap.front().key + backwardHeap.front().key >= _bestTime)
+            break;
+
+        const auto direction = (forwardHeap.size() <= backwardHeap.size()) ? Forward : Backward;
+        auto& heap = _heaps[direction];
+        std::pop_heap(heap.begin(), heap.end());
+        const auto entry = heap.back();
+        heap.pop_back();
+
+        // Node may be queued several times, only entry with actual time is expanded
+        if (entry.time > _times[direction][entry.node])
+            continue;
+
+        lastSettledNodesCount++;
+        expand(direction, entry.node, entry.time);
+    }
+
+    return _bestTime < std::numeric_limits<float>::infinity();
+}
+
+bool OsmAnd::RoutePlanner_P::findNearestRoadPoint(const PointI& point31, RoadPoint& outRoadPoint) const
+{
+    auto minSquareDistance = std::numeric_limits<double>::max();
+    for (auto roadIndex = 0; roadIndex < _graph->roads.size(); roadIndex++)
+    {
+        const auto& points31 = _graph->roads[roadIndex]->points31;
+        for (auto pointIndex = 0; pointIndex < points31.size(); pointIndex++)
+        {
+            const auto squareDistance = Utilities::squareDistance31(points31[pointIndex], point31);
+            if (squareDistance >= minSquareDistance)
+                continue;
+
+            minSquareDistance = squareDistance;
+            outRoadPoint.road = roadIndex;
+            outRoadPoint.pointIndex = pointIndex;
+            outRoadPoint.position31 = points31[pointIndex];
+        }
+    }
+
+    return minSquareDistance < std::numeric_limits<double>::max();
+}
+
+double OsmAnd::RoutePlanner_P::measureRoad(const uint32_t road, const uint32_t fromPoint, const uint32_t toPoint) const
+{
+    const auto& points31 = _graph->roads[road]->points31;
+
+    auto distance = 0.0;
+    for (auto pointIndex = qMin(fromPoint, toPoint); pointIndex < qMax(fromPoint, toPoint); pointIndex++)
+        distance += Utilities::distance31(points31[pointIndex], points31[pointIndex + 1]);
+    return distance;
+}
+
+float OsmAnd::RoutePlanner_P::getPartialEdgeTime(const EdgeIndex edge, const double distance) const
+{
+    const auto edgeDistance = _graph->edgesDistances[edge];
+    if (edgeDistance <= 0.0f)
+        return 0.0f;
+    return static_cast<float>(_graph->outEdgesTimes[edge] * distance / edgeDistance);
+}
+
+bool OsmAnd::RoutePlanner_P::findRoute(
+    const PointI& start31,
+    const PointI& end31,
+    QList< std::shared_ptr<const RouteSegment> >* const outRoute,
+    float* const outTime)
+{
+    RoadPoint startPoint;
+    RoadPoint endPoint;
+    if (!findNearestRoadPoint(start31, startPoint) || !findNearestRoadPoint(end31, endPoint))
+        return false;
+
+    beginSearch(startPoint.position31, endPoint.position31);
+
+    // Route starts at nodes ahead of start point on edges that contain it, and ends at nodes behind end point
+    auto directEdge = RoadGraph::InvalidIndex;
+    const auto edgesCount = _graph->outEdgesTargets.size();
+    for (EdgeIndex edge = 0; edge < edgesCount; edge++)
+    {
+        const auto road = _graph->edgesRoads[edge];
+        if (road != startPoint.road && road != endPoint.road)
+            continue;
+
+        const auto firstPoint = _graph->edgesFirstPoints[edge];
+        const auto lastPoint = _graph->edgesLastPoints[edge];
+        const auto minPoint = qMin(firstPoint, lastPoint);
+        const auto maxPoint = qMax(firstPoint, lastPoint);
+        const auto isIncrement = (firstPoint < lastPoint);
+
+        const auto containsStart =
+            (road == startPoint.road && minPoint <= startPoint.pointIndex && startPoint.pointIndex <= maxPoint);
+        const auto containsEnd =
+            (road == endPoint.road && minPoint <= endPoint.pointIndex && endPoint.pointIndex <= maxPoint);
+
+        if (containsStart)
+        {
+            const auto target = _graph->outEdgesTargets[edge];
+            if (startPoint.pointIndex == firstPoint)
+                updateLabel(Forward, _graph->getEdgeSource(edge), 0.0f, RoadGraph::InvalidIndex, RoadGraph::InvalidIndex);
+            else if (startPoint.pointIndex == lastPoint)
+                updateLabel(Forward, target, 0.0f, RoadGraph::InvalidIndex, RoadGraph::InvalidIndex);
+            else
+            {
+                const auto time = getPartialEdgeTime(edge, measureRoad(road, startPoint.pointIndex, lastPoint));
+                updateLabel(Forward, target, time, RoadGraph::InvalidIndex, edge);
+            }
+        }
+
+        if (containsEnd)
+        {
+            const auto source = _graph->getEdgeSource(edge);
+            if (endPoint.pointIndex == firstPoint)
+                updateLabel(Backward, source, 0.0f, RoadGraph::InvalidIndex, RoadGraph::InvalidIndex);
+            else if (endPoint.pointIndex == lastPoint)
+                updateLabel(Backward, _graph->outEdgesTargets[edge], 0.0f, RoadGraph::InvalidIndex, RoadGraph::InvalidIndex);
+            else
+            {
+                const auto time = getPartialEdgeTime(edge, measureRoad(road, firstPoint, endPoint.pointIndex));
+                updateLabel(Backward, source, time, RoadGraph::InvalidIndex, edge);
+            }
+        }
+
+        // Both points may be on same edge, with end point ahead of start point
+        if (containsStart && containsEnd)
+        {
+            const auto isAhead = isIncrement
+                ? (startPoint.pointIndex <= endPoint.pointIndex)
+                : (startPoint.pointIndex >= endPoint.pointIndex);
+            if (isAhead)
+            {
+                const auto time = getPartialEdgeTime(edge, measureRoad(road, startPoint.pointIndex, endPoint.pointIndex));
+                if (time < _bestTime)
+                {
+                    _bestTime = time;
+                    _meetingNode = RoadGraph::InvalidIndex;
+                    directEdge = edge;
+                }
+            }
+        }
+    }
+
+    if (!search())
+        return false;
+
+    if (outTime)
+        *outTime = _bestTime;
+    if (outRoute)
+    {
+        outRoute->clear();
+        if (_meetingNode == RoadGraph::InvalidIndex)
+        {
+            RoutePiece piece;
+            piece.road = startPoint.road;
+            piece.firstPoint = startPoint.pointIndex;
+            piece.lastPoint = endPoint.pointIndex;
+            piece.distance = static_cast<float>(measureRoad(piece.road, piece.firstPoint, piece.lastPoint));
+            piece.time = getPartialEdgeTime(directEdge, piece.distance);
+            obtainRoute(QList<RoutePiece>() << piece, *outRoute);
+        }
+        else
+            obtainRoute(&startPoint, &endPoint, *outRoute);
+    }
+
+    return true;
+}
+
+bool OsmAnd::RoutePlanner_P::findRoute(
+    const NodeIndex startNode,
+    const NodeIndex endNode,
+    QList< std::shared_ptr<const RouteSegment> >* const outRoute,
+    float* const outTime)
+{
+    const auto nodesCount = static_cast<NodeIndex>(_graph->nodesPositions31.size());
+    if (startNode >= nodesCount || endNode >= nodesCount)
+        return false;
+
+    beginSearch(_graph->nodesPositions31[startNode], _graph->nodesPositions31[endNode]);
+    updateLabel(Forward, startNode, 0.0f, RoadGraph::InvalidIndex, RoadGraph::InvalidIndex);
+    updateLabel(Backward, endNode, 0.0f, RoadGraph::InvalidIndex, RoadGraph::InvalidIndex);
+
+    // Edges that are restricted to turn at end node lead to its copies, yet route may end there
+    const auto endNodeCopies = _graph->nodesCopies.values(endNode);
+    for (const auto endNodeCopy : constOf(endNodeCopies))
+        updateLabel(Backward, endNodeCopy, 0.0f, RoadGraph::InvalidIndex, RoadGraph::InvalidIndex);
+
+    if (!search())
+        return false;
+
+    if (outTime)
+        *outTime = _bestTime;
+    if (outRoute)
+    {
+        outRoute->clear();
+        obtainRoute(nullptr, nullptr, *outRoute);
+    }
+
+    return true;
+}
+
+void OsmAnd::RoutePlanner_P::obtainRoute(
+    const RoadPoint* const startPoint,
+    const RoadPoint* const endPoint,
+    QList< std::shared_ptr<const RouteSegment> >& outRoute) const
+{
+    QList<RoutePiece> pieces;
+
+    // Edges from start to meeting node, collected in reverse order
+    auto node = _meetingNode;
+    while (node != RoadGraph::InvalidIndex)
+    {
+        const auto edge = _parentEdges[Forward][node];
+        if (edge == RoadGraph::InvalidIndex)
+            break;
+
+        const auto parentNode = _parentNodes[Forward][node];
+        RoutePiece piece;
+        piece.road = _graph->edgesRoads[edge];
+        piece.lastPoint = _graph->edgesLastPoints[edge];
+        if (parentNode != RoadGraph::InvalidIndex)
+        {
+            piece.firstPoint = _graph->edgesFirstPoints[edge];
+            piece.distance = _graph->edgesDistances[edge];
+            piece.time = _graph->outEdgesTimes[edge];
+        }
+        else
+        {
+            piece.firstPoint = startPoint->pointIndex;
+            piece.distance = static_cast<float>(measureRoad(piece.road, piece.firstPoint, piece.lastPoint));
+            piece.time = getPartialEdgeTime(edge, piece.distance);
+        }
+        pieces.prepend(piece);
+
+        node = parentNode;
+    }
+
+    // Edges from meeting node to end
+    node = _meetingNode;
+    while (node != RoadGraph::InvalidIndex)
+    {
+        const auto edge = _parentEdges[Backward][node];
+        if (edge == RoadGraph::InvalidIndex)
+            break;
+
+        const auto parentNode = _parentNodes[Backward][node];
+        RoutePiece piece;
+        piece.road = _graph->edgesRoads[edge];
+        piece.firstPoint = _graph->edgesFirstPoints[edge];
+        if (parentNode != RoadGraph::InvalidIndex)
+        {
+            piece.lastPoint = _graph->edgesLastPoints[edge];
+            piece.distance = _graph->edgesDistances[edge];
+            piece.time = _graph->outEdgesTimes[edge];
+        }
+        else
+        {
+            piece.lastPoint = endPoint->pointIndex;
+            piece.distance = static_cast<float>(measureRoad(piece.road, piece.firstPoint, piece.lastPoint));
+            piece.time = getPartialEdgeTime(edge, piece.distance);
+        }
+        pieces.append(piece);
+
+        node = parentNode;
+    }
+
+    obtainRoute(pieces, outRoute);
+}
+
+void OsmAnd::RoutePlanner_P::obtainRoute(
+    const QList<RoutePiece>& pieces,
+    QList< std::shared_ptr<const RouteSegment> >& outRoute) const
+{
+    // Consecutive pieces of same road that are passed in same direction make single segment
+    QList<RoutePiece> mergedPieces;
+    for (const auto& piece : constOf(pieces))
+    {
+        if (!mergedPieces.isEmpty())
+        {
+            auto& previousPiece = mergedPieces.last();
+            const auto isSameDirection =
+                (previousPiece.firstPoint < previousPiece.lastPoint) == (piece.firstPoint < piece.lastPoint);
+            if (previousPiece.road == piece.road && previousPiece.lastPoint == piece.firstPoint && isSameDirection)
+            {
+                previousPiece.lastPoint = piece.lastPoint;
+                previousPiece.distance += piece.distance;
+                previousPiece.time += piece.time;
+                continue;
+            }
+        }
+
+        mergedPieces.append(piece);
+    }
+
+    for (const auto& piece : constOf(mergedPieces))
+    {
+        const std::shared_ptr<const RouteSegment> segment(new RouteSegment(
+            _graph->roads[piece.road],
+            piece.firstPoint,
+            piece.lastPoint,
+            piece.distance,
+            piece.time));
+        outRoute.push_back(segment);
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef _OSMAND_CORE_ROUTE_PLANNER_P_H_
+#define _OSMAND_CORE_ROUTE_PLANNER_P_H_
+
+#include "stdlib_common.h"
+#include <vector>
+
+#include "QtExtensions.h"
+#include <QList>
+#include <QVector>
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "RoadGraph.h"
+
+namespace OsmAnd
+{
+    class Road;
+    class RoadGraph_P;
+    class RouteSegment;
+
+    class RoutePlanner;
+    class RoutePlanner_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoutePlanner_P);
+    public:
+        typedef RoadGraph::NodeIndex NodeIndex;
+        typedef RoadGraph::EdgeIndex EdgeIndex;
+
+    private:
+        enum SearchDirection : int
+        {
+            Forward = 0,
+            Backward = 1,
+
+            SearchDirectionsCount
+        };
+
+        struct HeapEntry
+        {
+            float key;
+            float time;
+            NodeIndex node;
+
+            inline bool operator<(const HeapEntry& that) const
+            {
+                // Heap keeps entry with largest value on top
+                return key > that.key;
+            }
+        };
+
+        // Location where route starts or ends, projected to nearest point of road
+        struct RoadPoint
+        {
+            uint32_t road;
+            uint32_t pointIndex;
+            PointI position31;
+        };
+
+        // Part of road passed by route, points are in order of passing
+        struct RoutePiece
+        {
+            uint32_t road;
+            uint32_t firstPoint;
+            uint32_t lastPoint;
+            float distance;
+            float time;
+        };
+
+        const RoadGraph_P* _graph;
+        float _inverseMaxSpeed;
+
+        // Labels of both search directions, label of node is valid only if its stamp equals current generation
+        uint32_t _generation;
+        QVector<float> _times[SearchDirectionsCount];
+        QVector<uint32_t> _stamps[SearchDirectionsCount];
+        QVector<NodeIndex> _parentNodes[SearchDirectionsCount];
+        // Index of edge (in outgoing edges arrays) that node was reached by, in case parent node is
+        // invalid it's a partial edge from road point where route starts or ends
+        QVector<EdgeIndex> _parentEdges[SearchDirectionsCount];
+        std::vector<HeapEntry> _heaps[SearchDirectionsCount];
+
+        PointI _start31;
+        PointI _end31;
+        float _bestTime;
+        NodeIndex _meetingNode;
+
+        void beginSearch(const PointI& start31, const PointI& end31);
+        float getPotential(const NodeIndex node) const;
+        inline bool isReached(const SearchDirection direction, const NodeIndex node) const;
+        void updateLabel(
+            const SearchDirection direction,
+            const NodeIndex node,
+            const float time,
+            const NodeIndex parentNode,
+            const EdgeIndex parentEdge);
+        void expand(const SearchDirection direction, const NodeIndex node, const float time);
+        bool search();
+
+        bool findNearestRoadPoint(const PointI& point31, RoadPoint& outRoadPoint) const;
+        double measureRoad(const uint32_t road, const uint32_t fromPoint, const uint32_t toPoint) const;
+        float getPartialEdgeTime(const EdgeIndex edge, const double distance) const;
+        void obtainRoute(
+            const RoadPoint* const startPoint,
+            const RoadPoint* const endPoint,
+            QList< std::shared_ptr<const RouteSegment> >& outRoute) const;
+        void obtainRoute(
+            const QList<RoutePiece>& pieces,
+            QList< std::shared_ptr<const RouteSegment> >& outRoute) const;
+    protected:
+        RoutePlanner_P(RoutePlanner* const owner);
+
+        void initialize();
+    public:
+        ~RoutePlanner_P();
+
+        ImplementationInterface<RoutePlanner> owner;
+
+        unsigned int lastSettledNodesCount;
+
+        bool findRoute(
+            const PointI& start31,
+            const PointI& end31,
+            QList< std::shared_ptr<const RouteSegment> >* const outRoute,
+            float* const outTime);
+        bool findRoute(
+            const NodeIndex startNode,
+            const NodeIndex endNode,
+            QList< std::shared_ptr<const RouteSegment> >* const outRoute,
+            float* const outTime);
+
+    friend class OsmAnd::RoutePlanner;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ROUTE_PLANNER_P_H_)
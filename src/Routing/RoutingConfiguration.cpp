@@ -8,7 +8,8 @@
 #include <QStringList>
 
 #include "Common.h"
-#include "EmbeddedResources.h"
+#include "OsmAndCore.h"
+#include "ICoreResourcesProvider.h"
 #include "Utilities.h"
 #include "Logging.h"
 #include "LoggingAssert.h"
@@ -154,7 +155,7 @@ void OsmAnd::RoutingConfiguration::parseRoutingParameter( QXmlStreamReader* xmlP
 
 void OsmAnd::RoutingConfiguration::loadDefault( RoutingConfiguration& outConfig )
 {
-    auto rawDefaultConfig = EmbeddedResources::decompressResource("routing.xml");
+    auto rawDefaultConfig = getCoreResourcesProvider()->getResource(QLatin1String("routing/routing.xml"));
     QBuffer defaultConfig(&rawDefaultConfig);
     bool ok = false;
     ok = defaultConfig.open(QIODevice::ReadOnly | QIODevice::Text);
@@ -271,7 +272,6 @@ QString OsmAnd::RoutingConfiguration::resolveAttribute( const QString& vehicle,
 
 bool OsmAnd::RoutingConfiguration::parseTypedValue( const QString& value, const QString& type, float& parsedValue )
 {
-    parsedValue;
     bool ok;
     
     if (type == "speed")
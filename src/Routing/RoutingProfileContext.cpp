@@ -1,5 +1,8 @@
 #include "RoutingProfileContext.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "ObfRoutingSectionInfo.h"
 #include "Road.h"
 
@@ -24,52 +27,90 @@ std::shared_ptr<OsmAnd::RoutingRulesetContext> OsmAnd::RoutingProfileContext::ge
     return _rulesetContexts[static_cast<int>(type)];
 }
 
-OsmAnd::Model::RoadDirection OsmAnd::RoutingProfileContext::getDirection( const std::shared_ptr<const OsmAnd::Model::Road>& road )
+OsmAnd::RoadDirection OsmAnd::RoutingProfileContext::getDirection( const std::shared_ptr<const OsmAnd::Road>& road )
 {
     auto value = getRulesetContext(RoutingRuleset::OneWay)->evaluateAsInteger(road, 0);
-    return static_cast<Model::RoadDirection>(value);
+    return static_cast<RoadDirection>(value);
 }
 
-bool OsmAnd::RoutingProfileContext::acceptsRoad( const std::shared_ptr<const OsmAnd::Model::Road>& road )
+bool OsmAnd::RoutingProfileContext::acceptsRoad( const std::shared_ptr<const OsmAnd::Road>& road )
 {
     auto value = getRulesetContext(RoutingRuleset::Access)->evaluateAsInteger(road, 0);
     return value >= 0;
 }
 
-bool OsmAnd::RoutingProfileContext::acceptsBorderLinePoint( const std::shared_ptr<const ObfRoutingSectionInfo>& section, const std::shared_ptr<const ObfRoutingBorderLinePoint>& point )
-{
-    auto value = getRulesetContext(RoutingRuleset::Access)->evaluateAsInteger(section, point->types, 0);
-    return value >= 0;
-}
-
-float OsmAnd::RoutingProfileContext::getSpeedPriority( const std::shared_ptr<const OsmAnd::Model::Road>& road )
+float OsmAnd::RoutingProfileContext::getSpeedPriority( const std::shared_ptr<const OsmAnd::Road>& road )
 {
     auto value = getRulesetContext(RoutingRuleset::RoadPriorities)->evaluateAsFloat(road, 1.0f);
     return value;
 }
 
-float OsmAnd::RoutingProfileContext::getSpeed( const std::shared_ptr<const OsmAnd::Model::Road>& road )
+float OsmAnd::RoutingProfileContext::getSpeed( const std::shared_ptr<const OsmAnd::Road>& road )
 {
     auto value = getRulesetContext(RoutingRuleset::RoadSpeed)->evaluateAsFloat(road, profile->minDefaultSpeed);
     return value;
 }
 
-float OsmAnd::RoutingProfileContext::getObstaclesExtraTime( const std::shared_ptr<const OsmAnd::Model::Road>& road, uint32_t pointIndex )
+float OsmAnd::RoutingProfileContext::getObstaclesExtraTime( const std::shared_ptr<const OsmAnd::Road>& road, uint32_t pointIndex )
 {
     auto itPointTypes = road->pointsTypes.constFind(pointIndex);
     if (itPointTypes == road->pointsTypes.cend())
         return 0.0f;
 
-    auto value = getRulesetContext(RoutingRuleset::Obstacles)->evaluateAsFloat(road->subsection->section, *itPointTypes, 0.0f);
+    auto value = getRulesetContext(RoutingRuleset::Obstacles)->evaluateAsFloat(road->section, *itPointTypes, 0.0f);
     return value;
 }
 
-float OsmAnd::RoutingProfileContext::getRoutingObstaclesExtraTime( const std::shared_ptr<const OsmAnd::Model::Road>& road, uint32_t pointIndex )
+float OsmAnd::RoutingProfileContext::getRoutingObstaclesExtraTime( const std::shared_ptr<const OsmAnd::Road>& road, uint32_t pointIndex )
 {
     auto itPointTypes = road->pointsTypes.constFind(pointIndex);
     if (itPointTypes == road->pointsTypes.cend())
         return 0.0f;
 
-    auto value = getRulesetContext(RoutingRuleset::RoutingObstacles)->evaluateAsFloat(road->subsection->section, *itPointTypes, 0.0f);
+    auto value = getRulesetContext(RoutingRuleset::RoutingObstacles)->evaluateAsFloat(road->section, *itPointTypes, 0.0f);
     return value;
 }
+
+OsmAnd::RoutingProfileContext::RoadRules OsmAnd::RoutingProfileContext::getRoadRules( const std::shared_ptr<const OsmAnd::Road>& road )
+{
+    auto itSectionCache = _roadRulesCache.find(road->section);
+    if (itSectionCache == _roadRulesCache.end())
+        itSectionCache = _roadRulesCache.insert(road->section, QHash< QVector<uint32_t>, RoadRules >());
+
+    // Same set of types may be stored in different order
+    auto types = road->attributeIds;
+    if (std::adjacent_find(types.cbegin(), types.cend(), std::greater_equal<uint32_t>()) != types.cend())
+    {
+        std::sort(types.begin(), types.end());
+        types.erase(std::unique(types.begin(), types.end()), types.end());
+    }
+
+    const auto citRules = itSectionCache->constFind(types);
+    if (citRules != itSectionCache->cend())
+        return *citRules;
+
+    RoadRules rules;
+    rules.accepted = acceptsRoad(road);
+    rules.speed = getSpeed(road);
+    rules.priority = getSpeedPriority(road);
+    rules.direction = static_cast<int8_t>(getDirection(road));
+    itSectionCache->insert(types, rules);
+
+    return rules;
+}
+
+unsigned int OsmAnd::RoutingProfileContext::getCachedRoadRulesCount() const
+{
+    unsigned int count = 0;
+    for (const auto& sectionCache : constOf(_roadRulesCache))
+        count += sectionCache.size();
+    return count;
+}
+
+uint64_t OsmAnd::RoutingProfileContext::getRulesEvaluationsCount() const
+{
+    uint64_t count = 0;
+    for (const auto& rulesetContext : constOf(_rulesetContexts))
+        count += rulesetContext->getEvaluationsCount();
+    return count;
+}
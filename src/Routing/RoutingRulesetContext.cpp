@@ -4,33 +4,37 @@
 
 #include "Road.h"
 #include "ObfRoutingSectionInfo.h"
-#include "ObfRoutingSectionInfo_P.h"
 #include "RoutingProfile.h"
 #include "RoutingProfileContext.h"
 
-bool checkParameter(std::shared_ptr<OsmAnd::RoutingRuleExpression> rt,
-                    const QHash<QString, QString>& contextValues_) {
-
-    for (QString p : rt->parameters) {
-        bool nott = false;
-        if (p.startsWith("-")) {
-            nott = true;
-            p = p.right(-1);
-        }
-        bool val = contextValues_.contains(p);
-        if (nott && val) {
-            return false;
-        } else if (!nott && !val) {
-            return false;
+namespace
+{
+    bool checkParameter(
+        const std::shared_ptr<OsmAnd::RoutingRuleExpression>& rt,
+        const QHash<QString, QString>& contextValues_)
+    {
+        for (auto p : rt->parameters)
+        {
+            bool nott = false;
+            if (p.startsWith("-"))
+            {
+                nott = true;
+                p = p.mid(1);
+            }
+            const bool val = contextValues_.contains(p);
+            if (nott && val)
+                return false;
+            else if (!nott && !val)
+                return false;
         }
+        return true;
     }
-    return true;
-
 }
 
 OsmAnd::RoutingRulesetContext::RoutingRulesetContext(RoutingProfileContext* owner_, const std::shared_ptr<RoutingRuleset>& ruleset_, QHash<QString, QString>* contextValues_)
     : owner(owner_)
     ,_ruleset(new RoutingRuleset(ruleset_->owner, ruleset_->type))
+    , _evaluationsCount(0)
     , ruleset(_ruleset)
     , contextValues(_contextValues)
 {
@@ -48,7 +52,7 @@ OsmAnd::RoutingRulesetContext::~RoutingRulesetContext()
 {
 }
 
-int OsmAnd::RoutingRulesetContext::evaluateAsInteger( const std::shared_ptr<const Model::Road>& road, int defaultValue )
+int OsmAnd::RoutingRulesetContext::evaluateAsInteger( const std::shared_ptr<const Road>& road, int defaultValue )
 {
     int result;
     if (!evaluate(road, RoutingRuleExpression::ResultType::Integer, &result))
@@ -56,7 +60,7 @@ int OsmAnd::RoutingRulesetContext::evaluateAsInteger( const std::shared_ptr<cons
     return result;
 }
 
-float OsmAnd::RoutingRulesetContext::evaluateAsFloat( const std::shared_ptr<const Model::Road>& road, float defaultValue )
+float OsmAnd::RoutingRulesetContext::evaluateAsFloat( const std::shared_ptr<const Road>& road, float defaultValue )
 {
     float result;
     if (!evaluate(road, RoutingRuleExpression::ResultType::Float, &result))
@@ -80,13 +84,20 @@ float OsmAnd::RoutingRulesetContext::evaluateAsFloat( const std::shared_ptr<cons
     return result;
 }
 
-bool OsmAnd::RoutingRulesetContext::evaluate( const std::shared_ptr<const Model::Road>& road, RoutingRuleExpression::ResultType type, void* result )
+uint64_t OsmAnd::RoutingRulesetContext::getEvaluationsCount() const
 {
-    return evaluate(encode(road->subsection->section, road->types), type, result);
+    return _evaluationsCount;
+}
+
+bool OsmAnd::RoutingRulesetContext::evaluate( const std::shared_ptr<const Road>& road, RoutingRuleExpression::ResultType type, void* result )
+{
+    return evaluate(encode(road->section, road->attributeIds), type, result);
 }
 
 bool OsmAnd::RoutingRulesetContext::evaluate( const QBitArray& types, RoutingRuleExpression::ResultType type, void* result )
 {
+    _evaluationsCount++;
+
     for(const auto& expression : constOf(ruleset->expressions))
     {
         if (expression->evaluate(types, this, type, result))
@@ -108,10 +119,11 @@ QBitArray OsmAnd::RoutingRulesetContext::encode( const std::shared_ptr<const Obf
         auto itId = itTagValueAttribIdCache->find(type);
         if (itId == itTagValueAttribIdCache->end())
         {
-            const auto& encodingRule = section->_p->_encodingRules[type];
-            assert(encodingRule);
+            const auto pTagValue = section->getAttributeMapping()->decodeMap.getRef(type);
+            if (!pTagValue)
+                continue;
 
-            auto id = ruleset->owner->registerTagValueAttribute(encodingRule->_tag, encodingRule->_value);
+            auto id = ruleset->owner->registerTagValueAttribute(pTagValue->tag, pTagValue->value);
             itId = itTagValueAttribIdCache->insert(type, id);
         }
         auto id = *itId;
@@ -30,6 +30,9 @@ OsmAnd::TextRasterizer_P::TextRasterizer_P(TextRasterizer* const owner_)
 
 OsmAnd::TextRasterizer_P::~TextRasterizer_P()
 {
+    QWriteLocker scopedLocker(&_fontRunsCacheLock);
+
+    clearFontRunsCache();
 }
 
 QVector<OsmAnd::TextRasterizer_P::LinePaint> OsmAnd::TextRasterizer_P::evaluatePaints(
@@ -47,8 +50,6 @@ QVector<OsmAnd::TextRasterizer_P::LinePaint> OsmAnd::TextRasterizer_P::evaluateP
         SkFontStyle::kNormal_Width,
         style.italic ? SkFontStyle::kItalic_Slant : SkFontStyle::kUpright_Slant);
 
-    const auto pText = lineRefs.first().string()->constData();
-
     QVector<LinePaint> linePaints;
     linePaints.reserve(lineRefs.count());
     for (const auto& lineRef : constOf(lineRefs))
@@ -56,101 +57,159 @@ QVector<OsmAnd::TextRasterizer_P::LinePaint> OsmAnd::TextRasterizer_P::evaluateP
         LinePaint linePaint;
         linePaint.line = lineRef;
 
-        TextPaint* pTextPaint = nullptr;
-        const auto pLine = lineRef.constData();
-        const auto pEnd = pLine + lineRef.size();
-        auto pNextCharacter = pLine;
-        while (pNextCharacter != pEnd)
+        const auto fontRuns = obtainFontRuns(lineRef, fontStyle);
+        linePaint.textPaints.reserve(fontRuns.size());
+        for (const auto& fontRun : constOf(fontRuns))
         {
-            const auto pCharacter = pNextCharacter;
-            const auto position = pNextCharacter - pText;
-            const auto characterUCS4 = SkUTF16_NextUnichar(reinterpret_cast<const uint16_t**>(&pNextCharacter));
-            
-            // First of all check previous font if it contains this character
-            auto font = pTextPaint ? pTextPaint->paint.getTypeface() : nullptr;
-            if (font)
-            {
-                SkPaint paint;
-                paint.setTextEncoding(SkPaint::kUTF32_TextEncoding);
-                paint.setTypeface(font);
-                if (!paint.containsText(&characterUCS4, sizeof(uint32_t)))
-                    font = nullptr;
-#if OSMAND_LOG_CHARACTERS_FONT
-                else
-                {
-                    SkString fontName;
-                    font->getFamilyName(&fontName);
-
-                    LogPrintf(LogSeverityLevel::Warning,
-                        "UCS4 character 0x%08x (%u) has been found in '%s' font (reused)",
-                        characterUCS4,
-                        characterUCS4,
-                        fontName.c_str());
-                }
-#endif // OSMAND_LOG_CHARACTERS_FONT
-            }
-            if (!font)
-            {
-                font = owner->fontFinder->findFontForCharacterUCS4(characterUCS4, fontStyle);
+            const auto font = fontRun.font;
 
-#if OSMAND_LOG_CHARACTERS_WITHOUT_FONT
-                if (!font)
-                {
-                    LogPrintf(LogSeverityLevel::Warning,
-                        "UCS4 character 0x%08x (%u) has not been found in any font",
-                        characterUCS4,
-                        characterUCS4);
-                }
-#endif // OSMAND_LOG_CHARACTERS_WITHOUT_FONT
+            linePaint.textPaints.push_back(qMove(TextPaint()));
+            const auto pTextPaint = &linePaint.textPaints.last();
+
+            pTextPaint->text = QStringRef(lineRef.string(), lineRef.position() + fontRun.offset, fontRun.length);
+            pTextPaint->paint = paint;
+            pTextPaint->paint.setTypeface(font);
+
+            SkPaint::FontMetrics metrics;
+            pTextPaint->height = paint.getFontMetrics(&metrics);
+            linePaint.maxFontHeight = qMax(linePaint.maxFontHeight, pTextPaint->height);
+            linePaint.minFontHeight = qMin(linePaint.minFontHeight, pTextPaint->height);
+            linePaint.maxFontLineSpacing = qMax(linePaint.maxFontLineSpacing, metrics.fLeading);
+            linePaint.minFontLineSpacing = qMin(linePaint.minFontLineSpacing, metrics.fLeading);
+            linePaint.maxFontTop = qMax(linePaint.maxFontTop, -metrics.fTop);
+            linePaint.minFontTop = qMin(linePaint.minFontTop, -metrics.fTop);
+            linePaint.maxFontBottom = qMax(linePaint.maxFontBottom, metrics.fBottom);
+            linePaint.minFontBottom = qMin(linePaint.minFontBottom, metrics.fBottom);
+
+            if (style.bold && (!font || (font && font->fontStyle().weight() <= SkFontStyle::kNormal_Weight)))
+                pTextPaint->paint.setFakeBoldText(true);
+        }
+
+        linePaints.push_back(qMove(linePaint));
+    }
+
+    return linePaints;
+}
+
+QVector<OsmAnd::TextRasterizer_P::FontRun> OsmAnd::TextRasterizer_P::obtainFontRuns(
+    const QStringRef& line,
+    const SkFontStyle& fontStyle) const
+{
+    static_assert(sizeof(SkFontStyle) == sizeof(uint32_t), "Check size of SkFontStyle");
+    const FontRunsKey key(line.toString(), *reinterpret_cast<const uint32_t*>(&fontStyle));
+
+    {
+        QReadLocker scopedLocker(&_fontRunsCacheLock);
 
+        const auto citFontRuns = _fontRunsCache.constFind(key);
+        if (citFontRuns != _fontRunsCache.cend())
+            return *citFontRuns;
+    }
+
+    const auto fontRuns = segmentIntoFontRuns(line, fontStyle);
+
+    {
+        QWriteLocker scopedLocker(&_fontRunsCacheLock);
+
+        if (_fontRunsCache.contains(key))
+            return fontRuns;
+
+        // Simplest bound: labels of current area will quickly fill cache again
+        if (_fontRunsCache.size() >= MaxFontRunsCacheSize)
+            clearFontRunsCache();
+
+        _fontRunsCache.insert(key, fontRuns);
+    }
+
+    return fontRuns;
+}
+
+QVector<OsmAnd::TextRasterizer_P::FontRun> OsmAnd::TextRasterizer_P::segmentIntoFontRuns(
+    const QStringRef& line,
+    const SkFontStyle& fontStyle) const
+{
+    QVector<FontRun> fontRuns;
+
+    FontRun* pFontRun = nullptr;
+    const auto pLine = line.constData();
+    const auto pEnd = pLine + line.size();
+    auto pNextCharacter = pLine;
+    while (pNextCharacter != pEnd)
+    {
+        const auto offset = pNextCharacter - pLine;
+        const auto characterUCS4 = SkUTF16_NextUnichar(reinterpret_cast<const uint16_t**>(&pNextCharacter));
+        const auto length = pNextCharacter - pLine - offset;
+
+        // First of all check previous font if it contains this character
+        auto font = pFontRun ? pFontRun->font : nullptr;
+        if (font)
+        {
+            SkPaint paint;
+            paint.setTextEncoding(SkPaint::kUTF32_TextEncoding);
+            paint.setTypeface(font);
+            if (!paint.containsText(&characterUCS4, sizeof(uint32_t)))
+                font = nullptr;
 #if OSMAND_LOG_CHARACTERS_FONT
-                if (font)
-                {
-                    SkString fontName;
-                    font->getFamilyName(&fontName);
-
-                    LogPrintf(LogSeverityLevel::Warning,
-                        "UCS4 character 0x%08x (%u) has been found in '%s' font",
-                        characterUCS4,
-                        characterUCS4,
-                        fontName.c_str());
-                }
-#endif // OSMAND_LOG_CHARACTERS_FONT
+            else
+            {
+                SkString fontName;
+                font->getFamilyName(&fontName);
+
+                LogPrintf(LogSeverityLevel::Warning,
+                    "UCS4 character 0x%08x (%u) has been found in '%s' font (reused)",
+                    characterUCS4,
+                    characterUCS4,
+                    fontName.c_str());
             }
+#endif // OSMAND_LOG_CHARACTERS_FONT
+        }
+        if (!font)
+        {
+            font = owner->fontFinder->findFontForCharacterUCS4(characterUCS4, fontStyle);
 
-            if (pTextPaint == nullptr || pTextPaint->paint.getTypeface() != font)
+#if OSMAND_LOG_CHARACTERS_WITHOUT_FONT
+            if (!font)
             {
-                linePaint.textPaints.push_back(qMove(TextPaint()));
-                pTextPaint = &linePaint.textPaints.last();
-
-                pTextPaint->text = QStringRef(lineRef.string(), position, 1);
-                pTextPaint->paint = paint;
-                pTextPaint->paint.setTypeface(font);
-
-                SkPaint::FontMetrics metrics;
-                pTextPaint->height = paint.getFontMetrics(&metrics);
-                linePaint.maxFontHeight = qMax(linePaint.maxFontHeight, pTextPaint->height);
-                linePaint.minFontHeight = qMin(linePaint.minFontHeight, pTextPaint->height);
-                linePaint.maxFontLineSpacing = qMax(linePaint.maxFontLineSpacing, metrics.fLeading);
-                linePaint.minFontLineSpacing = qMin(linePaint.minFontLineSpacing, metrics.fLeading);
-                linePaint.maxFontTop = qMax(linePaint.maxFontTop, -metrics.fTop);
-                linePaint.minFontTop = qMin(linePaint.minFontTop, -metrics.fTop);
-                linePaint.maxFontBottom = qMax(linePaint.maxFontBottom, metrics.fBottom);
-                linePaint.minFontBottom = qMin(linePaint.minFontBottom, metrics.fBottom);
-
-                if (style.bold && (!font || (font && font->fontStyle().weight() <= SkFontStyle::kNormal_Weight)))
-                    pTextPaint->paint.setFakeBoldText(true);
+                LogPrintf(LogSeverityLevel::Warning,
+                    "UCS4 character 0x%08x (%u) has not been found in any font",
+                    characterUCS4,
+                    characterUCS4);
             }
-            else
+#endif // OSMAND_LOG_CHARACTERS_WITHOUT_FONT
+
+#if OSMAND_LOG_CHARACTERS_FONT
+            if (font)
             {
-                pTextPaint->text = QStringRef(lineRef.string(), pTextPaint->text.position(), pTextPaint->text.size() + 1);
+                SkString fontName;
+                font->getFamilyName(&fontName);
+
+                LogPrintf(LogSeverityLevel::Warning,
+                    "UCS4 character 0x%08x (%u) has been found in '%s' font",
+                    characterUCS4,
+                    characterUCS4,
+                    fontName.c_str());
             }
+#endif // OSMAND_LOG_CHARACTERS_FONT
         }
 
-        linePaints.push_back(qMove(linePaint));
+        if (pFontRun == nullptr || pFontRun->font != font)
+        {
+            fontRuns.push_back(FontRun(static_cast<int>(offset), static_cast<int>(length), font));
+            pFontRun = &fontRuns.last();
+        }
+        else
+        {
+            pFontRun->length += static_cast<int>(length);
+        }
     }
 
-    return linePaints;
+    return fontRuns;
+}
+
+void OsmAnd::TextRasterizer_P::clearFontRunsCache() const
+{
+    // Fonts are released by runs themselves, once no copy of them is in use
+    _fontRunsCache.clear();
 }
 
 void OsmAnd::TextRasterizer_P::measureText(QVector<LinePaint>& paints, SkScalar& outMaxLineWidth) const
@@ -8,11 +8,15 @@
 #include "ignore_warnings_on_external_includes.h"
 #include <QList>
 #include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QReadWriteLock>
 #include "restore_internal_warnings.h"
 
 #include "ignore_warnings_on_external_includes.h"
 #include <SkCanvas.h>
 #include <SkPaint.h>
+#include <SkTypeface.h>
 #include "restore_internal_warnings.h"
 
 #include "OsmAndCore.h"
@@ -34,6 +38,58 @@ namespace OsmAnd
     private:
         SkPaint _defaultPaint;
 
+        // Segmentation of a line into runs of characters that are rendered with same font. It depends
+        // only on text and font style, and same labels are rasterized over and over again, so it's cached
+        struct FontRun
+        {
+            inline FontRun(const int offset_ = 0, const int length_ = 0, SkTypeface* const font_ = nullptr)
+                : offset(offset_)
+                , length(length_)
+                , font(SkSafeRef(font_))
+            {
+            }
+
+            inline FontRun(const FontRun& that)
+                : offset(that.offset)
+                , length(that.length)
+                , font(SkSafeRef(that.font))
+            {
+            }
+
+            inline ~FontRun()
+            {
+                SkSafeUnref(font);
+            }
+
+            inline FontRun& operator=(const FontRun& that)
+            {
+                if (this != &that)
+                {
+                    SkSafeRef(that.font);
+                    SkSafeUnref(font);
+                    offset = that.offset;
+                    length = that.length;
+                    font = that.font;
+                }
+                return *this;
+            }
+
+            int offset;
+            int length;
+
+            // Each run owns a reference, so runs taken from cache stay valid after cache is cleared
+            SkTypeface* font;
+        };
+        typedef QPair<QString, uint32_t> FontRunsKey;
+        enum {
+            MaxFontRunsCacheSize = 8192
+        };
+        mutable QReadWriteLock _fontRunsCacheLock;
+        mutable QHash< FontRunsKey, QVector<FontRun> > _fontRunsCache;
+        QVector<FontRun> obtainFontRuns(const QStringRef& line, const SkFontStyle& fontStyle) const;
+        QVector<FontRun> segmentIntoFontRuns(const QStringRef& line, const SkFontStyle& fontStyle) const;
+        void clearFontRunsCache() const;
+
         struct TextPaint
         {
             inline TextPaint()
@@ -1,6 +1,7 @@
 #include "TileDB.h"
 
 #include <cassert>
+#include <algorithm>
 
 #include <OsmAndCore/QtExtensions.h>
 #include <QtSql>
@@ -23,6 +24,9 @@ OsmAnd::TileDB::TileDB( const QDir& dataPath_, const QString& indexFilename_/* =
 
 OsmAnd::TileDB::~TileDB()
 {
+    QMutexLocker scopeLock(&_indexMutex);
+
+    closeFiles();
     if (_indexDb.isOpen())
         _indexDb.close();
 }
@@ -31,20 +35,28 @@ bool OsmAnd::TileDB::openIndex()
 {
     QMutexLocker scopeLock(&_indexMutex);
 
-    bool ok;
     bool shouldRebuild = indexFilename.isEmpty() || !QFile(indexFilename).exists();
 
+    if (!openIndexDb())
+        return false;
+
+    if (shouldRebuild)
+        return rebuildIndex();
+
+    return loadIndex();
+}
+
+bool OsmAnd::TileDB::openIndexDb()
+{
+    QMutexLocker scopeLock(&_indexMutex);
+
     _indexDb.setDatabaseName(indexFilename.isEmpty() ? ":memory:" : indexFilename);
-    ok = _indexDb.open();
-    if (!ok)
+    if (!_indexDb.open())
     {
         LogPrintf(LogSeverityLevel::Error, "Failed to open TileDB index from '%s': %s", qPrintable(indexFilename), qPrintable(_indexDb.lastError().text()));
         return false;
     }
 
-    if (shouldRebuild)
-        rebuildIndex();
-
     return true;
 }
 
@@ -57,7 +69,7 @@ bool OsmAnd::TileDB::rebuildIndex()
     // Open index database if it's not yet
     if (!_indexDb.isOpen())
     {
-        if (!openIndex())
+        if (!openIndexDb())
             return false;
     }
     QSqlQuery q(_indexDb);
@@ -66,15 +78,12 @@ bool OsmAnd::TileDB::rebuildIndex()
     auto beginTimestamp = std::chrono::steady_clock::now();
 
     // Recreate index db structure
-    if (!indexFilename.isEmpty())
-    {
-        ok = q.exec("DROP TABLE IF EXISTS tiledb_files");
-        assert(ok);
-        ok = q.exec("DROP TABLE IF EXISTS tiledb_index");
-        assert(ok);
-        ok = q.exec("DROP INDEX IF EXISTS _tiledb_index");
-        assert(ok);
-    }
+    ok = q.exec("DROP TABLE IF EXISTS tiledb_files");
+    assert(ok);
+    ok = q.exec("DROP TABLE IF EXISTS tiledb_index");
+    assert(ok);
+    ok = q.exec("DROP INDEX IF EXISTS _tiledb_index");
+    assert(ok);
     ok = q.exec(
         "CREATE TABLE tiledb_files ("
         "    id INTEGER PRIMARY KEY AUTOINCREMENT,"
@@ -161,11 +170,160 @@ bool OsmAnd::TileDB::rebuildIndex()
 
     auto endTimestamp = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast< std::chrono::duration<uint64_t, std::milli> >(endTimestamp - beginTimestamp).count();
-    LogPrintf(LogSeverityLevel::Info, "Finished indexing '%s', took %lldms, average %lldms/db", qPrintable(dataPath.absolutePath()), duration, duration / files.length());
+    LogPrintf(LogSeverityLevel::Info, "Finished indexing '%s', took %lldms, average %lldms/db", qPrintable(dataPath.absolutePath()), duration, duration / qMax(files.length(), 1));
+
+    return loadIndex();
+}
+
+bool OsmAnd::TileDB::loadIndex()
+{
+    QMutexLocker scopeLock(&_indexMutex);
+
+    closeFiles();
+    _filenames.clear();
+    for (auto& boundsOfZoom : _bounds)
+        boundsOfZoom.clear();
+
+    QSqlQuery filesQuery(_indexDb);
+    if (!filesQuery.exec("SELECT id, filename FROM tiledb_files"))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to load TileDB index of '%s': %s", qPrintable(dataPath.absolutePath()), qPrintable(filesQuery.lastError().text()));
+        return false;
+    }
+    while (filesQuery.next())
+        _filenames.insert(filesQuery.value(0).toInt(), filesQuery.value(1).toString());
+
+    // Order of files is kept, so that first file that has tile is used as before
+    QSqlQuery boundsQuery(_indexDb);
+    if (!boundsQuery.exec("SELECT id, zoom, xMin, yMin, xMax, yMax FROM tiledb_index ORDER BY id"))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to load TileDB index of '%s': %s", qPrintable(dataPath.absolutePath()), qPrintable(boundsQuery.lastError().text()));
+        return false;
+    }
+    while (boundsQuery.next())
+    {
+        const auto zoom = boundsQuery.value(1).toInt();
+        if (zoom < MinZoomLevel || zoom > MaxZoomLevel)
+            continue;
+
+        FileBounds bounds;
+        bounds.fileId = boundsQuery.value(0).toInt();
+        bounds.xMin = boundsQuery.value(2).toInt();
+        bounds.yMin = boundsQuery.value(3).toInt();
+        bounds.xMax = boundsQuery.value(4).toInt();
+        bounds.yMax = boundsQuery.value(5).toInt();
+        _bounds[zoom].push_back(bounds);
+    }
 
     return true;
 }
 
+std::shared_ptr<OsmAnd::TileDB::File> OsmAnd::TileDB::obtainFile(const int fileId)
+{
+    const auto citOpenedFile = _openedFiles.constFind(fileId);
+    if (citOpenedFile != _openedFiles.cend())
+        return *citOpenedFile;
+
+    const auto citFilename = _filenames.constFind(fileId);
+    if (citFilename == _filenames.cend())
+        return nullptr;
+
+    const std::shared_ptr<File> file(new File());
+    file->filename = *citFilename;
+    file->connectionName = QLatin1String("tiledb-sqlite:") + file->filename;
+    if (!QSqlDatabase::contains(file->connectionName))
+        file->db = QSqlDatabase::addDatabase("QSQLITE", file->connectionName);
+    else
+        file->db = QSqlDatabase::database(file->connectionName);
+    file->db.setDatabaseName(file->filename);
+    if (!file->db.open())
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to open TileDB from '%s': %s", qPrintable(file->filename), qPrintable(file->db.lastError().text()));
+        return nullptr;
+    }
+
+    file->selectDataQuery = QSqlQuery(file->db);
+    file->selectBatchDataQuery = QSqlQuery(file->db);
+    if (!file->selectDataQuery.prepare("SELECT data FROM tiles WHERE rowid=?") ||
+        !file->selectBatchDataQuery.prepare(getBatchQuerySql(BatchSize)))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to prepare TileDB queries for '%s': %s", qPrintable(file->filename), qPrintable(file->db.lastError().text()));
+        file->selectDataQuery = QSqlQuery();
+        file->selectBatchDataQuery = QSqlQuery();
+        file->db.close();
+        return nullptr;
+    }
+
+    const auto beginTimestamp = std::chrono::steady_clock::now();
+
+    QSqlQuery rowIdsQuery(file->db);
+    rowIdsQuery.setForwardOnly(true);
+    if (!rowIdsQuery.exec("SELECT rowid, zoom, x, y FROM tiles"))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to read tiles of TileDB '%s': %s", qPrintable(file->filename), qPrintable(rowIdsQuery.lastError().text()));
+        file->selectDataQuery = QSqlQuery();
+        file->selectBatchDataQuery = QSqlQuery();
+        file->db.close();
+        return nullptr;
+    }
+    unsigned int tilesCount = 0;
+    while (rowIdsQuery.next())
+    {
+        const auto zoom = rowIdsQuery.value(1).toInt();
+        if (zoom < MinZoomLevel || zoom > MaxZoomLevel)
+            continue;
+
+        const auto tileId = TileId::fromXY(rowIdsQuery.value(2).toInt(), rowIdsQuery.value(3).toInt());
+        file->rowIds[zoom].insert(tileId, rowIdsQuery.value(0).toLongLong());
+        tilesCount++;
+    }
+
+    const auto endTimestamp = std::chrono::steady_clock::now();
+    const auto duration = std::chrono::duration_cast< std::chrono::duration<uint64_t, std::milli> >(endTimestamp - beginTimestamp).count();
+    LogPrintf(LogSeverityLevel::Debug, "Opened TileDB '%s' with %u tiles, indexing took %lldms", qPrintable(file->filename), tilesCount, duration);
+
+    _openedFiles.insert(fileId, file);
+    return file;
+}
+
+void OsmAnd::TileDB::closeFiles()
+{
+    for (const auto& file : constOf(_openedFiles))
+    {
+        // Connection can be removed only when no queries and database handles reference it
+        file->selectDataQuery = QSqlQuery();
+        file->selectBatchDataQuery = QSqlQuery();
+        file->db.close();
+        file->db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(file->connectionName);
+    }
+    _openedFiles.clear();
+}
+
+bool OsmAnd::TileDB::findTile(const TileId tileId, const ZoomLevel zoom, int& outFileId, qint64& outRowId)
+{
+    for (const auto& bounds : constOf(_bounds[zoom]))
+    {
+        if (bounds.xMin > tileId.x || bounds.xMax < tileId.x || bounds.yMin > tileId.y || bounds.yMax < tileId.y)
+            continue;
+
+        const auto file = obtainFile(bounds.fileId);
+        if (!file)
+            continue;
+
+        const auto& rowIds = file->rowIds[zoom];
+        const auto citRowId = rowIds.constFind(tileId);
+        if (citRowId == rowIds.cend())
+            continue;
+
+        outFileId = bounds.fileId;
+        outRowId = *citRowId;
+        return true;
+    }
+
+    return false;
+}
+
 bool OsmAnd::TileDB::obtainTileData( const TileId tileId, const ZoomLevel zoom, QByteArray& data )
 {
     QMutexLocker scopeLock(&_indexMutex);
@@ -177,53 +335,115 @@ bool OsmAnd::TileDB::obtainTileData( const TileId tileId, const ZoomLevel zoom,
             return false;
     }
 
-    QSqlQuery query(_indexDb);
-    query.prepare("SELECT filename FROM tiledb_files WHERE id IN (SELECT id FROM tiledb_index WHERE xMin<=? AND xMax>=? AND yMin<=? AND yMax>=? AND zoom=?)");
-    query.addBindValue(tileId.x);
-    query.addBindValue(tileId.x);
-    query.addBindValue(tileId.y);
-    query.addBindValue(tileId.y);
-    query.addBindValue(zoom);
-    if (!query.exec())
+    if (zoom < MinZoomLevel || zoom > MaxZoomLevel)
+        return false;
+
+    int fileId;
+    qint64 rowId;
+    if (!findTile(tileId, zoom, fileId, rowId))
         return false;
+    const auto file = obtainFile(fileId);
 
-    bool hit = false;
-    while(!hit && query.next())
+    auto& query = file->selectDataQuery;
+    query.addBindValue(rowId);
+    if (!query.exec() || !query.next())
     {
-        const auto dbFilename = query.value(0).toString();
+        LogPrintf(LogSeverityLevel::Error, "Failed to read tile from TileDB '%s': %s", qPrintable(file->filename), qPrintable(query.lastError().text()));
+        return false;
+    }
+    data = query.value(0).toByteArray();
+    query.finish();
 
-        //TODO: manage access to database
-        //QMutexLocker scopeLock(&dbEntry->mutex);
+    return true;
+}
 
-        // Open database
-        const auto connectionName = QLatin1String("tiledb-sqlite:") + dbFilename;
-        QSqlDatabase db;
-        if (!QSqlDatabase::contains(connectionName))
-            db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
-        else
-            db = QSqlDatabase::database(connectionName);
-        db.setDatabaseName(dbFilename);
-        if (!db.open())
-        {
-            LogPrintf(LogSeverityLevel::Error, "Failed to open TileDB index from '%s': %s", qPrintable(dbFilename), qPrintable(db.lastError().text()));
+bool OsmAnd::TileDB::obtainTilesData(const QVector<TileId>& tileIds, const ZoomLevel zoom, QHash<TileId, QByteArray>& outData)
+{
+    QMutexLocker scopeLock(&_indexMutex);
+
+    // Check that index is available
+    if (!_indexDb.isOpen())
+    {
+        if (!openIndex())
             return false;
-        }
+    }
+
+    if (zoom < MinZoomLevel || zoom > MaxZoomLevel)
+        return false;
+
+    // Group tiles by file they are stored in
+    QHash<int, QVector<qint64> > rowIdsByFile;
+    QHash<int, QHash<qint64, TileId> > tileIdsByFile;
+    for (const auto& tileId : constOf(tileIds))
+    {
+        int fileId;
+        qint64 rowId;
+        if (!findTile(tileId, zoom, fileId, rowId))
+            continue;
+
+        auto& tileIdsByRowId = tileIdsByFile[fileId];
+        if (tileIdsByRowId.contains(rowId))
+            continue;
+        tileIdsByRowId.insert(rowId, tileId);
+        rowIdsByFile[fileId].push_back(rowId);
+    }
+
+    bool ok = true;
+    for (const auto& entry : rangeOf(rowIdsByFile))
+    {
+        const auto file = obtainFile(entry.key());
+        const auto& tileIdsByRowId = tileIdsByFile[entry.key()];
+
+        // Read in order of rowids, that is close to order of pages in file
+        auto& rowIds = entry.value();
+        std::sort(rowIds.begin(), rowIds.end());
+        for (auto offset = 0; offset < rowIds.size(); offset += BatchSize)
+            ok = readBatch(*file, rowIds.mid(offset, BatchSize), tileIdsByRowId, outData) && ok;
+    }
 
-        // Get tile from
-        QSqlQuery query(db);
-        query.prepare("SELECT data FROM tiles WHERE x=? AND y=? AND zoom=?");
-        query.addBindValue(tileId.x);
-        query.addBindValue(tileId.y);
-        query.addBindValue(static_cast<int>(zoom));
-        if (query.exec() && query.next())
+    return ok;
+}
+
+bool OsmAnd::TileDB::readBatch(
+    File& file,
+    const QVector<qint64>& rowIds,
+    const QHash<qint64, TileId>& tileIdsByRowId,
+    QHash<TileId, QByteArray>& outData)
+{
+    // Only last batch may be incomplete, it's prepared each time
+    QSqlQuery incompleteBatchQuery;
+    auto pQuery = &file.selectBatchDataQuery;
+    if (rowIds.size() != BatchSize)
+    {
+        incompleteBatchQuery = QSqlQuery(file.db);
+        if (!incompleteBatchQuery.prepare(getBatchQuerySql(rowIds.size())))
         {
-            data = query.value(0).toByteArray();
-            hit = true;
+            LogPrintf(LogSeverityLevel::Error, "Failed to prepare TileDB query for '%s': %s", qPrintable(file.filename), qPrintable(incompleteBatchQuery.lastError().text()));
+            return false;
         }
+        pQuery = &incompleteBatchQuery;
+    }
 
-        // Close database
-        db.close();
+    for (const auto rowId : constOf(rowIds))
+        pQuery->addBindValue(rowId);
+    if (!pQuery->exec())
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to read tiles from TileDB '%s': %s", qPrintable(file.filename), qPrintable(pQuery->lastError().text()));
+        return false;
     }
-    
-    return hit;
+    while (pQuery->next())
+        outData.insert(tileIdsByRowId.value(pQuery->value(0).toLongLong()), pQuery->value(1).toByteArray());
+    pQuery->finish();
+
+    return true;
+}
+
+QString OsmAnd::TileDB::getBatchQuerySql(const int rowIdsCount)
+{
+    QString placeholders;
+    placeholders.reserve(rowIdsCount * 2);
+    for (auto idx = 0; idx < rowIdsCount; idx++)
+        placeholders += (idx == 0) ? QLatin1String("?") : QLatin1String(",?");
+
+    return QLatin1String("SELECT rowid, data FROM tiles WHERE rowid IN (") + placeholders + QLatin1String(")");
 }
@@ -0,0 +1,303 @@
+#include "Tracing.h"
+
+#include <chrono>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QThreadStorage>
+#include <QFile>
+#include <QCoreApplication>
+#include "restore_internal_warnings.h"
+
+#include "Common.h"
+#include "Logging.h"
+
+namespace
+{
+    struct Span
+    {
+        const char* category;
+        const char* name;
+        int64_t beginTimestamp;
+        int64_t endTimestamp;
+    };
+
+    // Written only by owner thread. Spans are published by count, so buffer may be exported while
+    // owner keeps recording. Buffer is reset lazily by its owner once it sees new generation of tracer.
+    struct ThreadBuffer
+    {
+        ThreadBuffer(const int threadIndex_)
+            : threadIndex(threadIndex_)
+            , generation(0)
+            , count(0)
+            , isReleased(false)
+            , spans(new Span[OsmAnd::Tracer::ThreadBufferCapacity])
+        {
+        }
+
+        const int threadIndex;
+        QString threadName;
+        std::atomic<unsigned int> generation;
+        std::atomic<unsigned int> count;
+        // Thread has finished, so buffer may be taken by another thread once its spans are outdated
+        std::atomic<bool> isReleased;
+        const std::unique_ptr<Span[]> spans;
+    };
+
+    struct ThreadBufferHolder
+    {
+        ThreadBufferHolder(ThreadBuffer* const buffer_)
+            : buffer(buffer_)
+        {
+        }
+
+        ~ThreadBufferHolder()
+        {
+            buffer->isReleased.store(true, std::memory_order_release);
+        }
+
+        ThreadBuffer* const buffer;
+    };
+
+    struct TracerState
+    {
+        TracerState()
+            : generation(1)
+            , droppedCount(0)
+            , startTimestamp(0)
+        {
+        }
+
+        QMutex buffersMutex;
+        QList<ThreadBuffer*> buffers;
+        QThreadStorage<ThreadBufferHolder*> currentThreadBuffer;
+
+        std::atomic<unsigned int> generation;
+        std::atomic<uint64_t> droppedCount;
+        std::atomic<int64_t> startTimestamp;
+    };
+
+    // State is never destroyed, since threads may still record spans and release their buffers
+    // during static destruction
+    TracerState& getState()
+    {
+        static TracerState* const state = new TracerState();
+        return *state;
+    }
+
+    ThreadBuffer* obtainCurrentThreadBuffer(TracerState& state)
+    {
+        if (state.currentThreadBuffer.hasLocalData())
+            return state.currentThreadBuffer.localData()->buffer;
+
+        QMutexLocker scopedLocker(&state.buffersMutex);
+
+        const auto generation = state.generation.load(std::memory_order_acquire);
+        ThreadBuffer* buffer = nullptr;
+        for (const auto releasedBuffer : constOf(state.buffers))
+        {
+            if (releasedBuffer->isReleased.load(std::memory_order_acquire) &&
+                releasedBuffer->generation.load(std::memory_order_relaxed) != generation)
+            {
+                buffer = releasedBuffer;
+                buffer->isReleased.store(false, std::memory_order_relaxed);
+                break;
+            }
+        }
+        if (!buffer)
+        {
+            buffer = new ThreadBuffer(state.buffers.size() + 1);
+            state.buffers.push_back(buffer);
+        }
+
+        const auto thread = QThread::currentThread();
+        buffer->threadName = thread ? thread->objectName() : QString();
+        if (buffer->threadName.isEmpty())
+            buffer->threadName = QString(QLatin1String("Thread %1")).arg(buffer->threadIndex);
+
+        state.currentThreadBuffer.setLocalData(new ThreadBufferHolder(buffer));
+        return buffer;
+    }
+
+    void appendJsonString(QByteArray& output, const char* const value)
+    {
+        output.append('"');
+        for (auto pChar = value; *pChar; pChar++)
+        {
+            if (*pChar == '"' || *pChar == '\\')
+                output.append('\\');
+            if (static_cast<unsigned char>(*pChar) < 0x20)
+                continue;
+            output.append(*pChar);
+        }
+        output.append('"');
+    }
+
+    // Chrome trace uses microseconds
+    QByteArray toTraceTime(const int64_t nanoseconds)
+    {
+        return QByteArray::number(nanoseconds / 1000.0, 'f', 3);
+    }
+}
+
+std::atomic<bool> OsmAnd::Tracer::_isStarted(false);
+
+OsmAnd::Tracer::Tracer()
+{
+}
+
+OsmAnd::Tracer::~Tracer()
+{
+}
+
+void OsmAnd::Tracer::start()
+{
+    auto& state = getState();
+    QMutexLocker scopedLocker(&state.buffersMutex);
+
+    state.droppedCount.store(0, std::memory_order_relaxed);
+    state.startTimestamp.store(now(), std::memory_order_relaxed);
+    state.generation.fetch_add(1, std::memory_order_release);
+    _isStarted.store(true, std::memory_order_release);
+}
+
+void OsmAnd::Tracer::stop()
+{
+    _isStarted.store(false, std::memory_order_release);
+}
+
+int64_t OsmAnd::Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void OsmAnd::Tracer::recordSpan(
+    const char* const category,
+    const char* const name,
+    const int64_t beginTimestamp,
+    const int64_t endTimestamp)
+{
+    auto& state = getState();
+
+    // Span began before tracer was restarted
+    if (beginTimestamp < state.startTimestamp.load(std::memory_order_relaxed))
+        return;
+
+    const auto buffer = obtainCurrentThreadBuffer(state);
+    const auto generation = state.generation.load(std::memory_order_acquire);
+    if (buffer->generation.load(std::memory_order_relaxed) != generation)
+    {
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->generation.store(generation, std::memory_order_release);
+    }
+
+    const auto index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= ThreadBufferCapacity)
+    {
+        state.droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& span = buffer->spans[index];
+    span.category = category;
+    span.name = name;
+    span.beginTimestamp = beginTimestamp;
+    span.endTimestamp = endTimestamp;
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+unsigned int OsmAnd::Tracer::getRecordedSpansCount()
+{
+    auto& state = getState();
+    QMutexLocker scopedLocker(&state.buffersMutex);
+
+    const auto generation = state.generation.load(std::memory_order_acquire);
+    unsigned int count = 0;
+    for (const auto buffer : constOf(state.buffers))
+    {
+        if (buffer->generation.load(std::memory_order_acquire) == generation)
+            count += buffer->count.load(std::memory_order_acquire);
+    }
+
+    return count;
+}
+
+uint64_t OsmAnd::Tracer::getDroppedSpansCount()
+{
+    return getState().droppedCount.load(std::memory_order_relaxed);
+}
+
+QByteArray OsmAnd::Tracer::exportChromeTrace()
+{
+    auto& state = getState();
+    QMutexLocker scopedLocker(&state.buffersMutex);
+
+    const auto generation = state.generation.load(std::memory_order_acquire);
+    const auto startTimestamp = state.startTimestamp.load(std::memory_order_relaxed);
+    const auto pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray output;
+    output.append("{\"traceEvents\":[");
+    bool isFirstEvent = true;
+    for (const auto buffer : constOf(state.buffers))
+    {
+        if (buffer->generation.load(std::memory_order_acquire) != generation)
+            continue;
+        const auto count = buffer->count.load(std::memory_order_acquire);
+        if (count == 0)
+            continue;
+
+        const auto tid = QByteArray::number(buffer->threadIndex);
+        if (!isFirstEvent)
+            output.append(',');
+        isFirstEvent = false;
+        output.append("\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":");
+        appendJsonString(output, buffer->threadName.toUtf8().constData());
+        output.append("}}");
+
+        for (auto spanIndex = 0u; spanIndex < count; spanIndex++)
+        {
+            const auto& span = buffer->spans[spanIndex];
+            output.append(",\n{\"cat\":");
+            appendJsonString(output, span.category);
+            output.append(",\"name\":");
+            appendJsonString(output, span.name);
+            output.append(",\"ph\":\"X\",\"ts\":" + toTraceTime(span.beginTimestamp - startTimestamp));
+            output.append(",\"dur\":" + toTraceTime(span.endTimestamp - span.beginTimestamp));
+            output.append(",\"pid\":" + pid + ",\"tid\":" + tid + "}");
+        }
+    }
+    output.append("\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    return output;
+}
+
+bool OsmAnd::Tracer::saveChromeTrace(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to open '%s' to save trace",
+            qPrintable(filename));
+        return false;
+    }
+
+    const auto data = exportChromeTrace();
+    const auto written = file.write(data);
+    file.close();
+
+    if (written != data.size())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to write trace to '%s'",
+            qPrintable(filename));
+        return false;
+    }
+
+    return true;
+}
@@ -560,3 +560,57 @@ QString OsmAnd::Utilities::resolveColorFromPalette(const QString& input, const b
 
     return value;
 }
+
+void OsmAnd::Utilities::computePointsSignificance(
+    const QVector<PointI>& points31,
+    const int start,
+    const int end,
+    QVector<double>& pointsSignificance)
+{
+    const auto maxSignificance = std::numeric_limits<double>::max();
+    pointsSignificance[start] = maxSignificance;
+    pointsSignificance[end] = maxSignificance;
+
+    // Douglas-Peucker without tolerance: each split point gets its distance from the chord, limited by significance
+    // of the chord itself
+    struct Chord
+    {
+        int start;
+        int end;
+        double significance;
+    };
+    QVector<Chord> chords;
+    chords.push_back({ start, end, maxSignificance });
+    while (!chords.isEmpty())
+    {
+        const auto chord = chords.takeLast();
+        const PointD from(points31[chord.start]);
+        const PointD chordVector = PointD(points31[chord.end]) - from;
+        const auto chordLengthSquared = chordVector.x * chordVector.x + chordVector.y * chordVector.y;
+
+        double maxDistance = -1;
+        int splitIndex = -1;
+        for (auto pointIdx = chord.start + 1; pointIdx < chord.end; pointIdx++)
+        {
+            const PointD pointVector = PointD(points31[pointIdx]) - from;
+            auto t = 0.0;
+            if (chordLengthSquared > 0.0)
+                t = qBound(0.0, (pointVector.x * chordVector.x + pointVector.y * chordVector.y) / chordLengthSquared, 1.0);
+            const auto dx = pointVector.x - chordVector.x * t;
+            const auto dy = pointVector.y - chordVector.y * t;
+            const auto distance = qSqrt(dx * dx + dy * dy);
+            if (distance > maxDistance)
+            {
+                maxDistance = distance;
+                splitIndex = pointIdx;
+            }
+        }
+        if (splitIndex < 0)
+            continue;
+
+        const auto significance = qMin(maxDistance, chord.significance);
+        pointsSignificance[splitIndex] = significance;
+        chords.push_back({ chord.start, splitIndex, significance });
+        chords.push_back({ splitIndex, chord.end, significance });
+    }
+}
@@ -1,6 +1,9 @@
 #include "WebClient.h"
 #include "WebClient_P.h"
 
+#include "QtCommon.h"
+#include <QElapsedTimer>
+
 OsmAnd::WebClient::WebClient(
     const QString& userAgent /*= QLatin1String("OsmAnd Core")*/,
     const unsigned int concurrentRequestsLimit /*= 1*/,
@@ -54,6 +57,16 @@ void OsmAnd::WebClient::setFollowRedirects(const bool followRedirects)
     _p->setFollowRedirects(followRedirects);
 }
 
+unsigned int OsmAnd::WebClient::getPerHostRequestsLimit() const
+{
+    return _p->getPerHostRequestsLimit();
+}
+
+void OsmAnd::WebClient::setPerHostRequestsLimit(const unsigned int newLimit)
+{
+    _p->setPerHostRequestsLimit(newLimit);
+}
+
 QByteArray OsmAnd::WebClient::downloadData(
     const QNetworkRequest& networkRequest,
     std::shared_ptr<const IWebClient::IRequestResult>* const requestResult /*= nullptr*/,
@@ -79,6 +92,20 @@ bool OsmAnd::WebClient::downloadFile(
     return _p->downloadFile(networkRequest, fileName, requestResult, progressCallback);
 }
 
+std::shared_ptr<OsmAnd::WebClient::AsyncRequest> OsmAnd::WebClient::downloadDataAsync(
+    const QNetworkRequest& networkRequest,
+    const RequestFinishedCallback callback /*= nullptr*/) const
+{
+    return _p->downloadDataAsync(networkRequest, callback);
+}
+
+std::shared_ptr<OsmAnd::WebClient::AsyncRequest> OsmAnd::WebClient::downloadDataAsync(
+    const QString& url,
+    const RequestFinishedCallback callback /*= nullptr*/) const
+{
+    return downloadDataAsync(QNetworkRequest(url), callback);
+}
+
 QByteArray OsmAnd::WebClient::downloadData(
     const QString& url,
     std::shared_ptr<const IWebClient::IRequestResult>* const requestResult /*= nullptr*/,
@@ -132,3 +159,97 @@ unsigned int OsmAnd::WebClient::HttpRequestResult::getHttpStatusCode() const
 {
     return httpStatusCode;
 }
+
+OsmAnd::WebClient::AsyncRequest::AsyncRequest(
+    const QNetworkRequest& networkRequest_,
+    const QString& userAgent_,
+    const unsigned int retriesLimit_,
+    const bool followRedirects_,
+    const RequestFinishedCallback callback_)
+    : _isFinished(false)
+    , _isCancelled(0)
+    , networkRequest(networkRequest_)
+    , userAgent(userAgent_)
+    , retriesLimit(retriesLimit_)
+    , followRedirects(followRedirects_)
+    , callback(callback_)
+{
+}
+
+OsmAnd::WebClient::AsyncRequest::~AsyncRequest()
+{
+}
+
+void OsmAnd::WebClient::AsyncRequest::finish(
+    const QByteArray& data,
+    const std::shared_ptr<const IWebClient::IRequestResult>& requestResult)
+{
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        _data = data;
+        _requestResult = requestResult;
+        _isFinished = true;
+        _finishedCondition.wakeAll();
+    }
+
+    if (callback)
+        callback(data, requestResult);
+}
+
+void OsmAnd::WebClient::AsyncRequest::cancel()
+{
+    if (_isCancelled.fetchAndStoreOrdered(1) == 0 && _cancelledHandler)
+        _cancelledHandler();
+}
+
+bool OsmAnd::WebClient::AsyncRequest::isCancelled() const
+{
+    return _isCancelled.loadAcquire() != 0;
+}
+
+bool OsmAnd::WebClient::AsyncRequest::isFinished() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _isFinished;
+}
+
+void OsmAnd::WebClient::AsyncRequest::waitUntilFinished() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    while (!_isFinished)
+        REPEAT_UNTIL(_finishedCondition.wait(&_mutex));
+}
+
+bool OsmAnd::WebClient::AsyncRequest::waitUntilFinished(const unsigned long timeoutInMilliseconds) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker scopedLocker(&_mutex);
+
+    while (!_isFinished)
+    {
+        const auto elapsed = static_cast<unsigned long>(timer.elapsed());
+        if (elapsed >= timeoutInMilliseconds)
+            break;
+        _finishedCondition.wait(&_mutex, timeoutInMilliseconds - elapsed);
+    }
+    return _isFinished;
+}
+
+QByteArray OsmAnd::WebClient::AsyncRequest::getData() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _data;
+}
+
+std::shared_ptr<const OsmAnd::IWebClient::IRequestResult> OsmAnd::WebClient::AsyncRequest::getRequestResult() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _requestResult;
+}
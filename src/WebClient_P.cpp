@@ -7,6 +7,8 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QNetworkAccessManager>
+#include <QCoreApplication>
+#include <QSet>
 
 #include "OsmAndCore_private.h"
 #include "QNetworkWaitable.h"
@@ -21,12 +23,22 @@ OsmAnd::WebClient_P::WebClient_P(
     , _userAgent(userAgent_)
     , _retriesLimit(retriesLimit_)
     , _followRedirects(followRedirects_ ? 1 : 0)
+    , _perHostRequestsLimit(WebClient::DefaultPerHostRequestsLimit)
 {
     _threadPool.setMaxThreadCount(concurrentRequestsLimit_);
 }
 
 OsmAnd::WebClient_P::~WebClient_P()
 {
+    // Network thread finishes pending requests, their callbacks must not run under lock
+    std::shared_ptr<NetworkThread> networkThread;
+    {
+        QMutexLocker scopedLocker(&_networkThreadMutex);
+        networkThread = qMove(_networkThread);
+        _networkThread.reset();
+    }
+    networkThread.reset();
+
     _threadPool.clear();
     REPEAT_UNTIL(_threadPool.waitForDone());
 }
@@ -75,6 +87,16 @@ void OsmAnd::WebClient_P::setFollowRedirects(const bool followRedirects)
     _followRedirects.fetchAndStoreOrdered(followRedirects ? 1 : 0);
 }
 
+unsigned int OsmAnd::WebClient_P::getPerHostRequestsLimit() const
+{
+    return _perHostRequestsLimit.loadAcquire();
+}
+
+void OsmAnd::WebClient_P::setPerHostRequestsLimit(const unsigned int newLimit)
+{
+    _perHostRequestsLimit.fetchAndStoreOrdered(newLimit);
+}
+
 QByteArray OsmAnd::WebClient_P::downloadData(
     const QNetworkRequest& networkRequest,
     std::shared_ptr<const IWebClient::IRequestResult>* const requestResult,
@@ -269,6 +291,40 @@ bool OsmAnd::WebClient_P::downloadFile(
     return true;
 }
 
+std::shared_ptr<OsmAnd::WebClient_P::AsyncRequest> OsmAnd::WebClient_P::downloadDataAsync(
+    const QNetworkRequest& networkRequest,
+    const RequestFinishedCallback callback) const
+{
+    const std::shared_ptr<AsyncRequest> request(new AsyncRequest(
+        networkRequest,
+        getUserAgent(),
+        getRetriesLimit(),
+        getFollowRedirects(),
+        callback));
+
+    // Network thread is started on first asynchronous request
+    std::shared_ptr<NetworkThread> networkThread;
+    {
+        QMutexLocker scopedLocker(&_networkThreadMutex);
+
+        if (!_networkThread)
+            _networkThread.reset(new NetworkThread(this));
+        networkThread = _networkThread;
+    }
+
+    const std::weak_ptr<NetworkThread> networkThreadWeakRef(networkThread);
+    request->_cancelledHandler =
+        [networkThreadWeakRef]
+        () -> void
+        {
+            if (const auto networkThread = networkThreadWeakRef.lock())
+                networkThread->notifyCancelled();
+        };
+    networkThread->enqueue(request);
+
+    return request;
+}
+
 OsmAnd::WebClient_P::Request::Request(
     const QNetworkRequest& networkRequest_,
     const QString& userAgent_,
@@ -451,3 +507,292 @@ void OsmAnd::WebClient_P::Request::waitUntilFinished() const
     QMutexLocker scopedLocker(&_finishedConditionMutex);
     REPEAT_UNTIL(_finishedCondition.wait(&_finishedConditionMutex));
 }
+
+OsmAnd::WebClient_P::NetworkThread::NetworkThread(const WebClient_P* const owner_)
+    : _thread(new Concurrent::Thread(std::bind(&NetworkThread::threadProcedure, this)))
+    , _isStarted(false)
+    , _dispatcher(nullptr)
+    , _hasCancelledRequests(false)
+    , _isStopping(false)
+    , _eventLoop(nullptr)
+    , _networkAccessManager(nullptr)
+    , owner(owner_)
+{
+    _thread->start();
+
+    QMutexLocker scopedLocker(&_mutex);
+    while (!_isStarted)
+        REPEAT_UNTIL(_startedCondition.wait(&_mutex));
+}
+
+OsmAnd::WebClient_P::NetworkThread::~NetworkThread()
+{
+    postEvent(QuitEventType);
+    REPEAT_UNTIL(_thread->wait());
+}
+
+void OsmAnd::WebClient_P::NetworkThread::threadProcedure()
+{
+    QEventLoop eventLoop;
+    QNetworkAccessManager networkAccessManager;
+    Dispatcher dispatcher(this);
+    _eventLoop = &eventLoop;
+    _networkAccessManager = &networkAccessManager;
+
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        _dispatcher = &dispatcher;
+        _isStarted = true;
+        _startedCondition.wakeAll();
+    }
+
+    eventLoop.exec();
+
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        _dispatcher = nullptr;
+    }
+
+    // Requests that weren't completed are finished as failed ones
+    abortAll();
+
+    _networkAccessManager = nullptr;
+    _eventLoop = nullptr;
+}
+
+QString OsmAnd::WebClient_P::NetworkThread::getHostKey(const QUrl& url)
+{
+    return url.scheme() + QLatin1String("://") + url.authority(QUrl::RemoveUserInfo);
+}
+
+bool OsmAnd::WebClient_P::NetworkThread::isRetriable(const QNetworkReply::NetworkError error)
+{
+    // Only network layer errors are worth retrying, HTTP errors would be same again
+    return error != QNetworkReply::NoError &&
+        error != QNetworkReply::OperationCanceledError &&
+        error < QNetworkReply::ProxyConnectionRefusedError;
+}
+
+void OsmAnd::WebClient_P::NetworkThread::postEvent(const EventType eventType)
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    if (_dispatcher)
+        QCoreApplication::postEvent(_dispatcher, new QEvent(static_cast<QEvent::Type>(eventType)));
+}
+
+void OsmAnd::WebClient_P::NetworkThread::enqueue(const std::shared_ptr<AsyncRequest>& request)
+{
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        if (_dispatcher)
+        {
+            _newRequests.append(request);
+            QCoreApplication::postEvent(_dispatcher, new QEvent(static_cast<QEvent::Type>(ProcessRequestsEventType)));
+            return;
+        }
+    }
+
+    // Network thread is already stopped
+    request->finish(QByteArray(), nullptr);
+}
+
+void OsmAnd::WebClient_P::NetworkThread::notifyCancelled()
+{
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        _hasCancelledRequests = true;
+    }
+
+    postEvent(ProcessRequestsEventType);
+}
+
+void OsmAnd::WebClient_P::NetworkThread::processRequests()
+{
+    QList< std::shared_ptr<AsyncRequest> > newRequests;
+    bool hasCancelledRequests;
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        newRequests = qMove(_newRequests);
+        _newRequests.clear();
+        hasCancelledRequests = _hasCancelledRequests;
+        _hasCancelledRequests = false;
+    }
+
+    QSet<QString> hostKeys;
+    for (const auto& request : constOf(newRequests))
+    {
+        const auto hostKey = getHostKey(request->networkRequest.url());
+        _queuedRequestsByHost[hostKey].append(request);
+        hostKeys.insert(hostKey);
+    }
+
+    if (hasCancelledRequests)
+    {
+        // Requests that are in progress are aborted, that finishes them
+        QList<QNetworkReply*> cancelledNetworkReplies;
+        for (const auto activeRequestEntry : rangeOf(constOf(_activeRequests)))
+        {
+            if (activeRequestEntry.value().request->isCancelled())
+                cancelledNetworkReplies.append(activeRequestEntry.key());
+        }
+        for (const auto networkReply : constOf(cancelledNetworkReplies))
+            networkReply->abort();
+
+        // Queued requests are dropped when their turn comes, but let it come sooner
+        hostKeys.unite(QSet<QString>::fromList(_queuedRequestsByHost.keys()));
+    }
+
+    for (const auto& hostKey : constOf(hostKeys))
+        startQueuedRequests(hostKey);
+}
+
+void OsmAnd::WebClient_P::NetworkThread::startQueuedRequests(const QString& hostKey)
+{
+    auto itQueuedRequests = _queuedRequestsByHost.find(hostKey);
+    if (itQueuedRequests == _queuedRequestsByHost.end())
+        return;
+    auto& queuedRequests = *itQueuedRequests;
+
+    const auto perHostRequestsLimit = qMax(owner->getPerHostRequestsLimit(), 1u);
+    auto activeRequestsCount = _activeRequestsCountByHost.value(hostKey);
+    QList< std::shared_ptr<AsyncRequest> > cancelledRequests;
+    while (!queuedRequests.isEmpty())
+    {
+        const auto request = queuedRequests.first();
+        if (request->isCancelled())
+        {
+            queuedRequests.removeFirst();
+            cancelledRequests.append(request);
+            continue;
+        }
+
+        if (activeRequestsCount >= perHostRequestsLimit)
+            break;
+        queuedRequests.removeFirst();
+
+        ActiveRequest activeRequest;
+        activeRequest.request = request;
+        activeRequest.hostKey = hostKey;
+        activeRequest.attemptsCount = 1;
+        startRequest(request->networkRequest, activeRequest);
+        activeRequestsCount++;
+    }
+    if (queuedRequests.isEmpty())
+        _queuedRequestsByHost.erase(itQueuedRequests);
+    if (activeRequestsCount > 0)
+        _activeRequestsCountByHost[hostKey] = activeRequestsCount;
+
+    // Callbacks are invoked only after state is consistent, since they may enqueue new requests
+    for (const auto& request : constOf(cancelledRequests))
+        request->finish(QByteArray(), nullptr);
+}
+
+void OsmAnd::WebClient_P::NetworkThread::startRequest(QNetworkRequest networkRequest, const ActiveRequest& activeRequest)
+{
+    const auto& request = activeRequest.request;
+    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, request->userAgent.toLatin1());
+    networkRequest.setAttribute(QNetworkRequest::FollowRedirectsAttribute, request->followRedirects);
+    networkRequest.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+
+    const auto networkReply = _networkAccessManager->get(networkRequest);
+    _activeRequests.insert(networkReply, activeRequest);
+    QObject::connect(
+        networkReply, &QNetworkReply::finished,
+        (std::function<void()>)std::bind(&NetworkThread::onReplyFinished, this, networkReply));
+}
+
+void OsmAnd::WebClient_P::NetworkThread::onReplyFinished(QNetworkReply* const networkReply)
+{
+    const auto itActiveRequest = _activeRequests.find(networkReply);
+    if (itActiveRequest == _activeRequests.end())
+        return;
+    auto activeRequest = *itActiveRequest;
+    _activeRequests.erase(itActiveRequest);
+    networkReply->deleteLater();
+
+    const auto& request = activeRequest.request;
+    if (!_isStopping &&
+        !request->isCancelled() &&
+        isRetriable(networkReply->error()) &&
+        activeRequest.attemptsCount < request->retriesLimit)
+    {
+        activeRequest.attemptsCount++;
+        startRequest(request->networkRequest, activeRequest);
+        return;
+    }
+
+    const auto data = networkReply->error() == QNetworkReply::NoError
+        ? networkReply->readAll()
+        : QByteArray();
+    const std::shared_ptr<const IWebClient::IRequestResult> requestResult(new HttpRequestResult(networkReply));
+
+    const auto itActiveRequestsCount = _activeRequestsCountByHost.find(activeRequest.hostKey);
+    if (itActiveRequestsCount != _activeRequestsCountByHost.end() && --(*itActiveRequestsCount) == 0)
+        _activeRequestsCountByHost.erase(itActiveRequestsCount);
+
+    request->finish(data, requestResult);
+
+    if (!_isStopping)
+        startQueuedRequests(activeRequest.hostKey);
+}
+
+void OsmAnd::WebClient_P::NetworkThread::abortAll()
+{
+    _isStopping = true;
+
+    for (const auto networkReply : _activeRequests.keys())
+        networkReply->abort();
+    for (const auto activeRequestEntry : rangeOf(constOf(_activeRequests)))
+    {
+        const std::shared_ptr<const IWebClient::IRequestResult> requestResult(
+            new HttpRequestResult(activeRequestEntry.key()));
+        activeRequestEntry.value().request->finish(QByteArray(), requestResult);
+    }
+    _activeRequests.clear();
+    _activeRequestsCountByHost.clear();
+
+    QList< std::shared_ptr<AsyncRequest> > pendingRequests;
+    for (const auto& queuedRequests : constOf(_queuedRequestsByHost))
+        pendingRequests.append(queuedRequests);
+    _queuedRequestsByHost.clear();
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        pendingRequests.append(_newRequests);
+        _newRequests.clear();
+    }
+    for (const auto& request : constOf(pendingRequests))
+        request->finish(QByteArray(), nullptr);
+}
+
+OsmAnd::WebClient_P::NetworkThread::Dispatcher::Dispatcher(NetworkThread* const owner_)
+    : owner(owner_)
+{
+}
+
+OsmAnd::WebClient_P::NetworkThread::Dispatcher::~Dispatcher()
+{
+}
+
+bool OsmAnd::WebClient_P::NetworkThread::Dispatcher::event(QEvent* e)
+{
+    switch (static_cast<int>(e->type()))
+    {
+        case ProcessRequestsEventType:
+            owner->processRequests();
+            return true;
+
+        case QuitEventType:
+            owner->_eventLoop->quit();
+            return true;
+
+        default:
+            return QObject::event(e);
+    }
+}
@@ -14,10 +14,17 @@
 #include <QThreadPool>
 #include <QRunnable>
 #include <QAtomicInt>
+#include <QHash>
+#include <QList>
+#include <QEvent>
+#include <QObject>
+#include <QEventLoop>
+#include <QNetworkAccessManager>
 
 #include "OsmAndCore.h"
 #include "PrivateImplementation.h"
 #include "WebClient.h"
+#include "Thread.h"
 
 namespace OsmAnd
 {
@@ -29,6 +36,8 @@ namespace OsmAnd
         typedef WebClient::RequestProgressCallbackSignature RequestProgressCallbackSignature;
         typedef WebClient::RequestResult RequestResult;
         typedef WebClient::HttpRequestResult HttpRequestResult;
+        typedef WebClient::AsyncRequest AsyncRequest;
+        typedef WebClient::RequestFinishedCallback RequestFinishedCallback;
 
     private:
     protected:
@@ -90,6 +99,75 @@ namespace OsmAnd
 
         friend class OsmAnd::WebClient_P;
         };
+
+        // Owns QNetworkAccessManager that lives as long as WebClient does, so that its connections are reused.
+        // Work is passed to network thread using posted events, since its objects may be touched only there
+        class NetworkThread Q_DECL_FINAL
+        {
+            Q_DISABLE_COPY_AND_MOVE(NetworkThread);
+
+        private:
+            enum EventType : int {
+                ProcessRequestsEventType = QEvent::User + 1,
+                QuitEventType,
+            };
+
+            class Dispatcher : public QObject
+            {
+            public:
+                Dispatcher(NetworkThread* const owner);
+                virtual ~Dispatcher();
+
+                NetworkThread* const owner;
+
+                virtual bool event(QEvent* e);
+            };
+
+            struct ActiveRequest
+            {
+                std::shared_ptr<AsyncRequest> request;
+                QString hostKey;
+                unsigned int attemptsCount;
+            };
+
+            const std::unique_ptr<Concurrent::Thread> _thread;
+            void threadProcedure();
+
+            mutable QMutex _mutex;
+            QWaitCondition _startedCondition;
+            bool _isStarted;
+            Dispatcher* _dispatcher;
+            QList< std::shared_ptr<AsyncRequest> > _newRequests;
+            bool _hasCancelledRequests;
+
+            // Touched only by network thread
+            bool _isStopping;
+            QEventLoop* _eventLoop;
+            QNetworkAccessManager* _networkAccessManager;
+            QHash< QString, QList< std::shared_ptr<AsyncRequest> > > _queuedRequestsByHost;
+            QHash< QString, unsigned int > _activeRequestsCountByHost;
+            QHash< QNetworkReply*, ActiveRequest > _activeRequests;
+
+            static QString getHostKey(const QUrl& url);
+            static bool isRetriable(const QNetworkReply::NetworkError error);
+            void postEvent(const EventType eventType);
+            void processRequests();
+            void startQueuedRequests(const QString& hostKey);
+            void startRequest(QNetworkRequest networkRequest, const ActiveRequest& activeRequest);
+            void onReplyFinished(QNetworkReply* const networkReply);
+            void abortAll();
+        public:
+            NetworkThread(const WebClient_P* const owner);
+            ~NetworkThread();
+
+            const WebClient_P* const owner;
+
+            void enqueue(const std::shared_ptr<AsyncRequest>& request);
+            void notifyCancelled();
+        };
+        mutable QMutex _networkThreadMutex;
+        mutable std::shared_ptr<NetworkThread> _networkThread;
+        mutable QAtomicInt _perHostRequestsLimit;
     public:
         virtual ~WebClient_P();
 
@@ -111,6 +189,10 @@ namespace OsmAnd
         bool getFollowRedirects() const;
         void setFollowRedirects(const bool followRedirects);
 
+        // Per-host limit of asynchronous requests:
+        unsigned int getPerHostRequestsLimit() const;
+        void setPerHostRequestsLimit(const unsigned int newLimit);
+
         // Operations:
         QByteArray downloadData(
             const QNetworkRequest& networkRequest,
@@ -126,6 +208,10 @@ namespace OsmAnd
             std::shared_ptr<const IWebClient::IRequestResult>* const requestResult,
             const IWebClient::RequestProgressCallbackSignature progressCallback) const;
 
+        std::shared_ptr<AsyncRequest> downloadDataAsync(
+            const QNetworkRequest& networkRequest,
+            const RequestFinishedCallback callback) const;
+
     friend class OsmAnd::WebClient;
     };
 }
@@ -14,9 +14,12 @@ OsmAnd::zlibUtilities::~zlibUtilities()
 {
 }
 
-QByteArray OsmAnd::zlibUtilities::decompress(const QByteArray& input, const int windowBits)
+QByteArray OsmAnd::zlibUtilities::decompress(
+    const QByteArray& input,
+    const int windowBits,
+    const int maxOutputSize /*= -1*/)
 {
-    QByteArray output(input.size() * 6, Qt::Initialization::Uninitialized);
+    QByteArray output(maxOutputSize >= 0 ? maxOutputSize : input.size() * 6, Qt::Initialization::Uninitialized);
 
     z_stream stream;
     memset(&stream, 0, sizeof(z_stream));
@@ -38,7 +41,7 @@ QByteArray OsmAnd::zlibUtilities::decompress(const QByteArray& input, const int
         {
             inflateEnd(&stream);
 
-            if (err == Z_BUF_ERROR)
+            if (err == Z_BUF_ERROR && maxOutputSize < 0)
             {
                 output.resize(output.size() * 2);
                 continue;
@@ -56,9 +59,9 @@ QByteArray OsmAnd::zlibUtilities::decompress(const QByteArray& input, const int
     return output;
 }
 
-QByteArray OsmAnd::zlibUtilities::zlibDecompress(const QByteArray& input)
+QByteArray OsmAnd::zlibUtilities::zlibDecompress(const QByteArray& input, const int maxOutputSize /*= -1*/)
 {
-    return decompress(input, MAX_WBITS);
+    return decompress(input, MAX_WBITS, maxOutputSize);
 }
 
 QByteArray OsmAnd::zlibUtilities::deflateDecompress(const QByteArray& input)
@@ -70,3 +73,37 @@ QByteArray OsmAnd::zlibUtilities::gzipDecompress(const QByteArray& input)
 {
     return decompress(input, MAX_WBITS | 16);
 }
+
+QByteArray OsmAnd::zlibUtilities::compress(const QByteArray& input, const int windowBits, const int level)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return QByteArray();
+
+    QByteArray output(static_cast<int>(deflateBound(&stream, input.size())), Qt::Initialization::Uninitialized);
+
+    stream.next_in = reinterpret_cast<const Bytef*>(input.constData());
+    stream.avail_in = input.size();
+
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = output.size();
+
+    const auto err = deflate(&stream, Z_FINISH);
+    if (err != Z_STREAM_END)
+    {
+        deflateEnd(&stream);
+        return QByteArray();
+    }
+
+    output.resize(stream.total_out);
+
+    deflateEnd(&stream);
+
+    return output;
+}
+
+QByteArray OsmAnd::zlibUtilities::zlibCompress(const QByteArray& input, const int level /*= -1*/)
+{
+    return compress(input, MAX_WBITS, level);
+}
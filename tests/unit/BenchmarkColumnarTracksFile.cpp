@@ -0,0 +1,249 @@
+#include <OsmAndCore/GpxDocument.h>
+#include <OsmAndCore/ColumnarTracksFile.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryFile>
+
+using namespace OsmAnd;
+
+class BenchmarkColumnarTracksFile : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        // Fleet of vehicles, each reporting position every 5 seconds during a day
+        VehiclesCount = 200,
+        PointsPerVehicleCount = 17280,
+        PointsPerSegmentCount = 720,
+        PointsCount = VehiclesCount * PointsPerVehicleCount,
+    };
+
+    QTemporaryFile _gpxFile;
+    QTemporaryFile _uncompressedFile;
+    QTemporaryFile _compressedFile;
+
+    static bool writeFleetGpx(QFile& file);
+    static void reportThroughput(const char* const name, const qint64 elapsedNs, const qint64 bytes, const qint64 pointsCount);
+    static void readAllSegments(const QString& filename);
+private slots:
+    void initTestCase();
+    void loadFrom();
+    void loadTracksFrom();
+    void convertGpx();
+    void readUncompressed();
+    void readCompressed();
+    void readTracklines();
+};
+
+bool BenchmarkColumnarTracksFile::writeFleetGpx(QFile& file)
+{
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    const auto startTime = QDateTime(QDate(2020, 6, 1), QTime(6, 0, 0), Qt::UTC).toMSecsSinceEpoch();
+    QByteArray chunk;
+    chunk.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    chunk.append("<gpx version=\"1.1\" creator=\"BenchmarkColumnarTracksFile\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n");
+    for (auto vehicleIdx = 0; vehicleIdx < VehiclesCount; vehicleIdx++)
+    {
+        chunk.append("  <trk>\n    <name>Vehicle ");
+        chunk.append(QByteArray::number(vehicleIdx));
+        chunk.append("</name>\n    <trkseg>\n");
+
+        auto latitude = 52.0 + 0.01 * (vehicleIdx % 20);
+        auto longitude = 4.0 + 0.01 * (vehicleIdx / 20);
+        for (auto pointIdx = 0; pointIdx < PointsPerVehicleCount; pointIdx++)
+        {
+            if (pointIdx > 0 && pointIdx % PointsPerSegmentCount == 0)
+                chunk.append("    </trkseg>\n    <trkseg>\n");
+
+            latitude += 0.00007 * ((pointIdx / 300 + vehicleIdx) % 3 - 1) + 0.0000001 * (pointIdx % 7);
+            longitude += 0.00011 * ((pointIdx / 500 + vehicleIdx) % 3 - 1) + 0.0000001 * (pointIdx % 5);
+            const auto elevation = 5.0 + (pointIdx % 400) * 0.1;
+            const auto timestamp = QDateTime::fromMSecsSinceEpoch(startTime + pointIdx * 5000ll, Qt::UTC);
+            chunk.append("      <trkpt lat=\"");
+            chunk.append(QByteArray::number(latitude, 'f', 7));
+            chunk.append("\" lon=\"");
+            chunk.append(QByteArray::number(longitude, 'f', 7));
+            chunk.append("\"><ele>");
+            chunk.append(QByteArray::number(elevation, 'f', 1));
+            chunk.append("</ele><time>");
+            chunk.append(timestamp.toString(Qt::ISODate).toLatin1());
+            chunk.append("</time></trkpt>\n");
+
+            if (chunk.size() >= 1024 * 1024)
+            {
+                if (file.write(chunk) != chunk.size())
+                    return false;
+                chunk.clear();
+            }
+        }
+        chunk.append("    </trkseg>\n  </trk>\n");
+    }
+    chunk.append("</gpx>\n");
+    if (file.write(chunk) != chunk.size())
+        return false;
+
+    file.close();
+    return true;
+}
+
+void BenchmarkColumnarTracksFile::reportThroughput(
+    const char* const name,
+    const qint64 elapsedNs,
+    const qint64 bytes,
+    const qint64 pointsCount)
+{
+    const auto seconds = elapsedNs / 1e9;
+    qDebug("%s: %lld points, %.1f MB in %.3f s: %.1f MB/s, %.2f M points/s",
+        name,
+        pointsCount,
+        bytes / (1024.0 * 1024.0),
+        seconds,
+        bytes / (1024.0 * 1024.0) / seconds,
+        pointsCount / 1e6 / seconds);
+}
+
+void BenchmarkColumnarTracksFile::readAllSegments(const QString& filename)
+{
+    qint64 pointsCount = 0;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        pointsCount = 0;
+
+        ColumnarTracksFile tracksFile(filename);
+        QVERIFY(tracksFile.open());
+        QVector<PointI> points31;
+        QVector<int64_t> timestamps;
+        QVector<double> elevations;
+        const auto segmentsCount = tracksFile.getSegments().size();
+        for (auto segmentIdx = 0; segmentIdx < segmentsCount; segmentIdx++)
+        {
+            QVERIFY(tracksFile.readSegment(segmentIdx, &points31, &timestamps, &elevations));
+            pointsCount += points31.size();
+        }
+    }
+
+    QCOMPARE(pointsCount, static_cast<qint64>(PointsCount));
+    reportThroughput("ColumnarTracksFile::readSegment", timer.nsecsElapsed(), QFileInfo(filename).size(), pointsCount);
+}
+
+void BenchmarkColumnarTracksFile::initTestCase()
+{
+    QVERIFY(_gpxFile.open());
+    _gpxFile.close();
+    QVERIFY(writeFleetGpx(_gpxFile));
+
+    QVERIFY(_uncompressedFile.open());
+    _uncompressedFile.close();
+    QVERIFY(ColumnarTracksFile::convertGpx(
+        _gpxFile.fileName(),
+        _uncompressedFile.fileName(),
+        ColumnarTracksFile::Compression::None));
+
+    QVERIFY(_compressedFile.open());
+    _compressedFile.close();
+    QVERIFY(ColumnarTracksFile::convertGpx(
+        _gpxFile.fileName(),
+        _compressedFile.fileName(),
+        ColumnarTracksFile::Compression::Zlib));
+
+    qDebug("GPX: %.1f MB, uncompressed: %.1f MB, zlib: %.1f MB",
+        _gpxFile.size() / (1024.0 * 1024.0),
+        _uncompressedFile.size() / (1024.0 * 1024.0),
+        _compressedFile.size() / (1024.0 * 1024.0));
+}
+
+void BenchmarkColumnarTracksFile::loadFrom()
+{
+    std::shared_ptr<GpxDocument> document;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        document = GpxDocument::loadFrom(_gpxFile.fileName());
+    }
+
+    QVERIFY(document);
+    QCOMPARE(document->tracks.size(), static_cast<int>(VehiclesCount));
+    reportThroughput("GpxDocument::loadFrom", timer.nsecsElapsed(), _gpxFile.size(), PointsCount);
+}
+
+void BenchmarkColumnarTracksFile::loadTracksFrom()
+{
+    std::shared_ptr<GpxDocument> document;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        document = GpxDocument::loadTracksFrom(_gpxFile.fileName());
+    }
+
+    QVERIFY(document);
+    QCOMPARE(document->tracks.size(), static_cast<int>(VehiclesCount));
+    reportThroughput("GpxDocument::loadTracksFrom", timer.nsecsElapsed(), _gpxFile.size(), PointsCount);
+}
+
+void BenchmarkColumnarTracksFile::convertGpx()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.close();
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        QVERIFY(ColumnarTracksFile::convertGpx(_gpxFile.fileName(), file.fileName()));
+    }
+
+    reportThroughput("ColumnarTracksFile::convertGpx", timer.nsecsElapsed(), _gpxFile.size(), PointsCount);
+}
+
+void BenchmarkColumnarTracksFile::readUncompressed()
+{
+    readAllSegments(_uncompressedFile.fileName());
+}
+
+void BenchmarkColumnarTracksFile::readCompressed()
+{
+    readAllSegments(_compressedFile.fileName());
+}
+
+// Only coordinates are needed to present track lines
+void BenchmarkColumnarTracksFile::readTracklines()
+{
+    qint64 pointsCount = 0;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        pointsCount = 0;
+
+        ColumnarTracksFile tracksFile(_compressedFile.fileName());
+        QVERIFY(tracksFile.open());
+        QVector<PointI> points31;
+        const auto segmentsCount = tracksFile.getSegments().size();
+        for (auto segmentIdx = 0; segmentIdx < segmentsCount; segmentIdx++)
+        {
+            QVERIFY(tracksFile.readSegment(segmentIdx, &points31));
+            pointsCount += points31.size();
+        }
+    }
+
+    QCOMPARE(pointsCount, static_cast<qint64>(PointsCount));
+    reportThroughput("ColumnarTracksFile::readSegment (coordinates)", timer.nsecsElapsed(), _compressedFile.size(), pointsCount);
+}
+
+QTEST_MAIN(BenchmarkColumnarTracksFile)
+#include "BenchmarkColumnarTracksFile.moc"
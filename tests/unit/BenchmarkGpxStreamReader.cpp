@@ -0,0 +1,190 @@
+#include <OsmAndCore/GpxDocument.h>
+#include <OsmAndCore/GpxStreamReader.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryFile>
+
+using namespace OsmAnd;
+
+class BenchmarkGpxStreamReader : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        // Points of large track, only streamed
+        LargePointsCount = 4000000,
+        // Points of track that is loaded into GpxDocument, full parser needs a lot of memory per point
+        DocumentPointsCount = 500000,
+        PointsPerSegmentCount = 10000,
+    };
+
+    QTemporaryFile _largeFile;
+    QTemporaryFile _documentFile;
+
+    static bool writeSyntheticGpx(QFile& file, const int pointsCount);
+    static void reportThroughput(const char* const name, const qint64 elapsedNs, const qint64 bytes, const qint64 pointsCount);
+private slots:
+    void initTestCase();
+    void streamLarge();
+    void streamDocument();
+    void loadTracksFrom();
+    void loadFrom();
+};
+
+// Track like ones recorded by OsmAnd: point per second with elevation, time and some extensions
+bool BenchmarkGpxStreamReader::writeSyntheticGpx(QFile& file, const int pointsCount)
+{
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    const auto startTime = QDateTime(QDate(2020, 6, 1), QTime(8, 0, 0), Qt::UTC).toMSecsSinceEpoch();
+    QByteArray chunk;
+    chunk.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    chunk.append("<gpx version=\"1.1\" creator=\"BenchmarkGpxStreamReader\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n");
+    chunk.append("  <metadata><name>Synthetic</name></metadata>\n");
+    chunk.append("  <trk>\n    <name>Synthetic track</name>\n    <trkseg>\n");
+    for (auto pointIdx = 0; pointIdx < pointsCount; pointIdx++)
+    {
+        if (pointIdx > 0 && pointIdx % PointsPerSegmentCount == 0)
+            chunk.append("    </trkseg>\n    <trkseg>\n");
+
+        const auto latitude = 52.0 + 0.00001 * (pointIdx % 100000) + 0.0000001 * (pointIdx % 7);
+        const auto longitude = 4.0 + 0.00001 * (pointIdx / 100000) + 0.000013 * (pointIdx % 97);
+        const auto elevation = 10.0 + (pointIdx % 1000) * 0.1;
+        const auto timestamp = QDateTime::fromMSecsSinceEpoch(startTime + pointIdx * 1000ll, Qt::UTC);
+        chunk.append("      <trkpt lat=\"");
+        chunk.append(QByteArray::number(latitude, 'f', 7));
+        chunk.append("\" lon=\"");
+        chunk.append(QByteArray::number(longitude, 'f', 7));
+        chunk.append("\">\n        <ele>");
+        chunk.append(QByteArray::number(elevation, 'f', 1));
+        chunk.append("</ele>\n        <time>");
+        chunk.append(timestamp.toString(Qt::ISODate).toLatin1());
+        chunk.append("</time>\n        <extensions><speed>1.5</speed></extensions>\n      </trkpt>\n");
+
+        if (chunk.size() >= 1024 * 1024)
+        {
+            if (file.write(chunk) != chunk.size())
+                return false;
+            chunk.clear();
+        }
+    }
+    chunk.append("    </trkseg>\n  </trk>\n</gpx>\n");
+    if (file.write(chunk) != chunk.size())
+        return false;
+
+    file.close();
+    return true;
+}
+
+void BenchmarkGpxStreamReader::reportThroughput(
+    const char* const name,
+    const qint64 elapsedNs,
+    const qint64 bytes,
+    const qint64 pointsCount)
+{
+    const auto seconds = elapsedNs / 1e9;
+    qDebug("%s: %lld points, %.1f MB in %.3f s: %.1f MB/s, %.2f M points/s",
+        name,
+        pointsCount,
+        bytes / (1024.0 * 1024.0),
+        seconds,
+        bytes / (1024.0 * 1024.0) / seconds,
+        pointsCount / 1e6 / seconds);
+}
+
+void BenchmarkGpxStreamReader::initTestCase()
+{
+    QVERIFY(_largeFile.open());
+    _largeFile.close();
+    QVERIFY(writeSyntheticGpx(_largeFile, LargePointsCount));
+
+    QVERIFY(_documentFile.open());
+    _documentFile.close();
+    QVERIFY(writeSyntheticGpx(_documentFile, DocumentPointsCount));
+}
+
+void BenchmarkGpxStreamReader::streamLarge()
+{
+    qint64 pointsCount = 0;
+    GpxStreamReader reader;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        pointsCount = 0;
+        QVERIFY(reader.read(_largeFile.fileName(),
+            [&pointsCount]
+            (const GpxStreamReader::TrackPointsBatch& batch) -> bool
+            {
+                pointsCount += batch.size();
+                return true;
+            }));
+    }
+
+    QCOMPARE(pointsCount, static_cast<qint64>(LargePointsCount));
+    reportThroughput("GpxStreamReader", timer.nsecsElapsed(), _largeFile.size(), pointsCount);
+}
+
+void BenchmarkGpxStreamReader::streamDocument()
+{
+    qint64 pointsCount = 0;
+    GpxStreamReader reader;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        pointsCount = 0;
+        QVERIFY(reader.read(_documentFile.fileName(),
+            [&pointsCount]
+            (const GpxStreamReader::TrackPointsBatch& batch) -> bool
+            {
+                pointsCount += batch.size();
+                return true;
+            }));
+    }
+
+    QCOMPARE(pointsCount, static_cast<qint64>(DocumentPointsCount));
+    reportThroughput("GpxStreamReader", timer.nsecsElapsed(), _documentFile.size(), pointsCount);
+}
+
+void BenchmarkGpxStreamReader::loadTracksFrom()
+{
+    std::shared_ptr<GpxDocument> document;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        document = GpxDocument::loadTracksFrom(_documentFile.fileName());
+    }
+
+    QVERIFY(document);
+    QCOMPARE(document->tracks.size(), 1);
+    reportThroughput("GpxDocument::loadTracksFrom", timer.nsecsElapsed(), _documentFile.size(), DocumentPointsCount);
+}
+
+void BenchmarkGpxStreamReader::loadFrom()
+{
+    std::shared_ptr<GpxDocument> document;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        document = GpxDocument::loadFrom(_documentFile.fileName());
+    }
+
+    QVERIFY(document);
+    QCOMPARE(document->tracks.size(), 1);
+    reportThroughput("GpxDocument::loadFrom", timer.nsecsElapsed(), _documentFile.size(), DocumentPointsCount);
+}
+
+QTEST_MAIN(BenchmarkGpxStreamReader)
+#include "BenchmarkGpxStreamReader.moc"
@@ -0,0 +1,158 @@
+#include <OsmAndCore/Map/HeightmapTileCache.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+using namespace OsmAnd;
+
+// Replays panning trace over visible tiles, as renderer requests them from HeightmapTileProvider.
+// GDAL decoding is only available after core initialization with embedded resources, so decoding
+// is replaced with filling the grid, and each such fill is counted as a decode call.
+class BenchmarkHeightmapTileCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        TileSize = 32,
+        TraceZoom = ZoomLevel12,
+        // Visible area of tablet screen at 256px tiles
+        ViewportWidth = 8,
+        ViewportHeight = 6,
+        // Square loop of panning steps, one tile per step, done several times
+        LoopSide = 24,
+        LoopsCount = 4,
+        FirstX = 2000,
+        FirstY = 1300,
+    };
+
+    struct Step
+    {
+        int x;
+        int y;
+    };
+    QVector<Step> _trace;
+
+    static QVector<float> decodeTile(const TileId tileId);
+    void replay(HeightmapTileCache& cache, uint64_t& outRequestsCount, uint64_t& outDecodesCount);
+private slots:
+    void initTestCase();
+    void replayTrace_data();
+    void replayTrace();
+};
+
+QVector<float> BenchmarkHeightmapTileCache::decodeTile(const TileId tileId)
+{
+    QVector<float> grid(TileSize * TileSize);
+    for (auto row = 0; row < TileSize; row++)
+    {
+        for (auto col = 0; col < TileSize; col++)
+            grid[row * TileSize + col] = static_cast<float>((tileId.x * TileSize + col) % 4096 + (tileId.y * TileSize + row) % 2048);
+    }
+    return grid;
+}
+
+void BenchmarkHeightmapTileCache::replay(HeightmapTileCache& cache, uint64_t& outRequestsCount, uint64_t& outDecodesCount)
+{
+    const auto zoom = static_cast<ZoomLevel>(TraceZoom);
+    outRequestsCount = 0;
+    outDecodesCount = 0;
+
+    for (const auto& step : constOf(_trace))
+    {
+        for (auto y = step.y; y < step.y + ViewportHeight; y++)
+        {
+            for (auto x = step.x; x < step.x + ViewportWidth; x++)
+            {
+                const auto tileId = TileId::fromXY(x, y);
+                QVector<float> grid;
+                if (!cache.obtainTile(tileId, zoom, grid))
+                {
+                    grid = decodeTile(tileId);
+                    cache.insertTile(tileId, zoom, grid);
+                    outDecodesCount++;
+                }
+                outRequestsCount++;
+            }
+        }
+
+        // Borders of visible tiles are stitched once all of them were requested
+        for (auto y = step.y; y < step.y + ViewportHeight; y++)
+        {
+            for (auto x = step.x; x < step.x + ViewportWidth; x++)
+            {
+                QVector<float> stitchedGrid;
+                cache.obtainStitchedTile(TileId::fromXY(x, y), zoom, TileSize, stitchedGrid);
+            }
+        }
+    }
+}
+
+void BenchmarkHeightmapTileCache::initTestCase()
+{
+    Step step;
+    step.x = FirstX;
+    step.y = FirstY;
+    for (auto loopIdx = 0; loopIdx < LoopsCount; loopIdx++)
+    {
+        const int directions[4][2] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+        for (const auto& direction : directions)
+        {
+            for (auto stepIdx = 0; stepIdx < LoopSide; stepIdx++)
+            {
+                step.x += direction[0];
+                step.y += direction[1];
+                _trace.push_back(step);
+            }
+        }
+    }
+}
+
+void BenchmarkHeightmapTileCache::replayTrace_data()
+{
+    QTest::addColumn<unsigned int>("capacityInTiles");
+
+    const auto visibleTilesCount = static_cast<unsigned int>(ViewportWidth * ViewportHeight);
+    QTest::newRow("disabled") << 0u;
+    QTest::newRow("visible area") << visibleTilesCount;
+    QTest::newRow("visible area x4") << visibleTilesCount * 4;
+    QTest::newRow("whole loop") << static_cast<unsigned int>((LoopSide + ViewportWidth) * (LoopSide + ViewportHeight));
+}
+
+void BenchmarkHeightmapTileCache::replayTrace()
+{
+    QFETCH(unsigned int, capacityInTiles);
+
+    HeightmapTileCache cache;
+    cache.insertTile(TileId::fromXY(0, 0), ZoomLevel0, decodeTile(TileId::fromXY(0, 0)));
+    const auto tileSizeInBytes = cache.getStatistics().sizeInBytes;
+    cache.clear();
+    cache.setCapacityInBytes(capacityInTiles * tileSizeInBytes);
+    cache.resetStatistics();
+
+    QElapsedTimer timer;
+    uint64_t requestsCount = 0;
+    uint64_t decodesCount = 0;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        replay(cache, requestsCount, decodesCount);
+    }
+
+    const auto statistics = cache.getStatistics();
+    QCOMPARE(statistics.misses, decodesCount);
+    qDebug("%u tiles: %llu requests, %llu decodes, %llu decodes saved (%.1f%%), %llu evictions, %llu missing neighbours in %.3f s",
+        capacityInTiles,
+        static_cast<unsigned long long>(requestsCount),
+        static_cast<unsigned long long>(decodesCount),
+        static_cast<unsigned long long>(requestsCount - decodesCount),
+        (requestsCount - decodesCount) * 100.0 / requestsCount,
+        static_cast<unsigned long long>(statistics.evictions),
+        static_cast<unsigned long long>(statistics.missingNeighbours),
+        timer.nsecsElapsed() / 1e9);
+}
+
+QTEST_MAIN(BenchmarkHeightmapTileCache)
+#include "BenchmarkHeightmapTileCache.moc"
@@ -0,0 +1,191 @@
+#include <OsmAndCore/Map/HillshadeTileProvider.h>
+#include <OsmAndCore/Map/MapDataProviderHelpers.h>
+
+#include <cmath>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+using namespace OsmAnd;
+
+namespace
+{
+    // Rolling hills, generated without any decoding, so that only shading is measured
+    class SyntheticElevationProvider : public IMapElevationDataProvider
+    {
+    public:
+        SyntheticElevationProvider(const unsigned int tileSize_)
+            : tileSize(tileSize_)
+        {
+        }
+
+        const unsigned int tileSize;
+
+        virtual unsigned int getTileSize() const Q_DECL_OVERRIDE
+        {
+            return tileSize;
+        }
+
+        virtual ZoomLevel getMinZoom() const Q_DECL_OVERRIDE
+        {
+            return MinZoomLevel;
+        }
+
+        virtual ZoomLevel getMaxZoom() const Q_DECL_OVERRIDE
+        {
+            return MaxZoomLevel;
+        }
+
+        virtual bool supportsNaturalObtainData() const Q_DECL_OVERRIDE
+        {
+            return true;
+        }
+
+        virtual bool obtainData(
+            const IMapDataProvider::Request& request_,
+            std::shared_ptr<IMapDataProvider::Data>& outData,
+            std::shared_ptr<Metric>* const pOutMetric = nullptr) Q_DECL_OVERRIDE
+        {
+            const auto& request = MapDataProviderHelpers::castRequest<Request>(request_);
+            if (pOutMetric)
+                pOutMetric->reset();
+
+            const auto pRawData = new float[tileSize * tileSize];
+            for (auto row = 0u; row < tileSize; row++)
+            {
+                for (auto col = 0u; col < tileSize; col++)
+                {
+                    pRawData[row * tileSize + col] = 500.0f +
+                        300.0f * std::sin((request.tileId.x * tileSize + col) * 0.07f) *
+                        std::cos((request.tileId.y * tileSize + row) * 0.05f);
+                }
+            }
+            outData.reset(new Data(request.tileId, request.zoom, sizeof(float) * tileSize, tileSize, pRawData));
+            return true;
+        }
+
+        virtual bool supportsNaturalObtainDataAsync() const Q_DECL_OVERRIDE
+        {
+            return false;
+        }
+
+        virtual void obtainDataAsync(
+            const IMapDataProvider::Request& request,
+            const IMapDataProvider::ObtainDataAsyncCallback callback,
+            const bool collectMetric = false) Q_DECL_OVERRIDE
+        {
+            MapDataProviderHelpers::nonNaturalObtainDataAsync(this, request, callback, collectMetric);
+        }
+    };
+}
+
+// Throughput in tiles per second of single core, for shading kernel alone and for whole provider
+class BenchmarkHillshadeTileProvider : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        TileSize = 256,
+        ElevationTileSize = 32,
+        KernelIterations = 200,
+        // Row of tiles, as rendered while panning
+        TilesCount = 64,
+        FirstX = 2000,
+        TileY = 1300,
+        Zoom = ZoomLevel12,
+    };
+private slots:
+    void shadingKernel_data();
+    void shadingKernel();
+    void obtainData();
+};
+
+void BenchmarkHillshadeTileProvider::shadingKernel_data()
+{
+    QTest::addColumn<bool>("vectorized");
+
+    QTest::newRow("scalar") << false;
+    if (HillshadeTileProvider::isVectorizedShadingSupported())
+        QTest::newRow("vectorized") << true;
+}
+
+void BenchmarkHillshadeTileProvider::shadingKernel()
+{
+    QFETCH(bool, vectorized);
+
+    const auto size = static_cast<int>(TileSize) + 2;
+    QVector<float> elevations(size * size);
+    for (auto row = 0; row < size; row++)
+    {
+        for (auto col = 0; col < size; col++)
+            elevations[row * size + col] = 500.0f + 300.0f * std::sin(col * 0.07f) * std::cos(row * 0.05f);
+    }
+    QVector<uint8_t> shading(TileSize * TileSize);
+
+    QElapsedTimer timer;
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        for (auto iteration = 0; iteration < KernelIterations; iteration++)
+        {
+            HillshadeTileProvider::computeShading(
+                elevations.constData(),
+                TileSize,
+                38.0f,
+                HillshadeTileProvider::Mode::Hillshade,
+                315.0f,
+                45.0f,
+                1.0f,
+                shading.data(),
+                vectorized);
+        }
+    }
+
+    const auto seconds = timer.nsecsElapsed() / 1e9;
+    qDebug("%s kernel: %d tiles %dx%d in %.3f s, %.1f tiles/s/core",
+        vectorized ? "vectorized" : "scalar",
+        static_cast<int>(KernelIterations),
+        static_cast<int>(TileSize),
+        static_cast<int>(TileSize),
+        seconds,
+        KernelIterations / seconds);
+}
+
+// Includes stitching, upsampling and conversion to bitmap. Rendered tiles are not cached,
+// elevation tiles are decoded once and reused as neighbours
+void BenchmarkHillshadeTileProvider::obtainData()
+{
+    const auto elevationProvider = std::make_shared<SyntheticElevationProvider>(ElevationTileSize);
+    HillshadeTileProvider provider(elevationProvider, HillshadeTileProvider::Mode::Hillshade, TileSize);
+    provider.setCacheCapacityInBytes(0);
+
+    QElapsedTimer timer;
+    auto obtainedTilesCount = 0;
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        for (auto x = FirstX; x < FirstX + TilesCount; x++)
+        {
+            HillshadeTileProvider::Request request;
+            request.tileId = TileId::fromXY(x, TileY);
+            request.zoom = static_cast<ZoomLevel>(Zoom);
+
+            std::shared_ptr<IMapDataProvider::Data> data;
+            if (provider.obtainData(request, data) && data)
+                obtainedTilesCount++;
+        }
+    }
+
+    QCOMPARE(obtainedTilesCount, static_cast<int>(TilesCount));
+    const auto seconds = timer.nsecsElapsed() / 1e9;
+    qDebug("provider (%s kernel): %d tiles in %.3f s, %.1f tiles/s/core",
+        HillshadeTileProvider::isVectorizedShadingSupported() ? "vectorized" : "scalar",
+        obtainedTilesCount,
+        seconds,
+        obtainedTilesCount / seconds);
+}
+
+QTEST_MAIN(BenchmarkHillshadeTileProvider)
+#include "BenchmarkHillshadeTileProvider.moc"
@@ -0,0 +1,116 @@
+#include <OsmAndCore/Logging.h>
+#include <OsmAndCore/QIODeviceLogSink.h>
+
+#include <thread>
+#include <vector>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+using namespace OsmAnd;
+
+// Threads log concurrently to file sink, as rasterizer and worker pools do with verbose logging.
+// Reports time spent by logging threads, and total time until all messages reach the file.
+class BenchmarkLogging : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        MessagesPerThreadCount = 20000
+    };
+
+    LogSeverityLevel _previousThreshold;
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void contention_data();
+    void contention();
+};
+
+void BenchmarkLogging::initTestCase()
+{
+    _previousThreshold = Logger::get()->setSeverityLevelThreshold(LogSeverityLevel::Verbose);
+}
+
+void BenchmarkLogging::cleanupTestCase()
+{
+    Logger::get()->setSeverityLevelThreshold(_previousThreshold);
+}
+
+void BenchmarkLogging::contention_data()
+{
+    QTest::addColumn<int>("threadsCount");
+    QTest::addColumn<bool>("asynchronous");
+
+    for (const auto threadsCount : { 1, 2, 4, 8, 16 })
+    {
+        QTest::newRow(qPrintable(QString("%1 threads, synchronous").arg(threadsCount))) << threadsCount << false;
+        QTest::newRow(qPrintable(QString("%1 threads, asynchronous").arg(threadsCount))) << threadsCount << true;
+    }
+}
+
+void BenchmarkLogging::contention()
+{
+    QFETCH(int, threadsCount);
+    QFETCH(bool, asynchronous);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const std::shared_ptr<ILogSink> sink = QIODeviceLogSink::createFileLogSink(tempDir.path() + QLatin1String("/log.txt"));
+    QVERIFY(sink);
+    Logger::get()->addLogSink(sink);
+    Logger::get()->setAsynchronous(asynchronous);
+    const auto statisticsBefore = Logger::get()->getAsyncStatistics();
+
+    QElapsedTimer timer;
+    qint64 loggingTime = 0;
+    qint64 totalTime = 0;
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        std::vector<std::thread> threads;
+        threads.reserve(threadsCount);
+        for (auto threadIndex = 0; threadIndex < threadsCount; threadIndex++)
+        {
+            threads.emplace_back(
+                [threadIndex]
+                ()
+                {
+                    for (auto messageIndex = 0; messageIndex < MessagesPerThreadCount; messageIndex++)
+                    {
+                        LogPrintf(LogSeverityLevel::Verbose,
+                            "Tile %dx%d@%d obtained in %fs",
+                            threadIndex,
+                            messageIndex,
+                            15,
+                            messageIndex * 0.001);
+                    }
+                });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        loggingTime = timer.nsecsElapsed();
+
+        LogFlush();
+        totalTime = timer.nsecsElapsed();
+    }
+
+    const auto statistics = Logger::get()->getAsyncStatistics();
+    Logger::get()->setAsynchronous(false);
+    Logger::get()->removeLogSink(sink);
+
+    const auto messagesCount = threadsCount * MessagesPerThreadCount;
+    qDebug("%d threads, %s: %.0f messages/s while logging (%.3f s), %.3f s until written, %llu dropped",
+        threadsCount,
+        asynchronous ? "asynchronous" : "synchronous",
+        messagesCount / (loggingTime / 1e9),
+        loggingTime / 1e9,
+        totalTime / 1e9,
+        static_cast<unsigned long long>(statistics.droppedCount - statisticsBefore.droppedCount));
+}
+
+QTEST_MAIN(BenchmarkLogging)
+#include "BenchmarkLogging.moc"
@@ -0,0 +1,170 @@
+#include <random>
+
+#include <OsmAndCore/ObfDataInterface.h>
+#include <OsmAndCore/Data/ObfFile.h>
+#include <OsmAndCore/Data/ObfReader.h>
+#include <OsmAndCore/Routing/RoadGraph.h>
+#include <OsmAndCore/Routing/RoutePlanner.h>
+#include <OsmAndCore/Routing/RoutingConfiguration.h>
+#include <OsmAndCore/Routing/RoutingProfileContext.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include "SyntheticRoutingObf.h"
+
+using namespace OsmAnd;
+
+// Routes per second between random nodes of grid network, where every tenth row and column is a faster road
+// and shape points lie between intersections, like on real roads.
+class BenchmarkRoutePlanner : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum : int {
+        GridSize = 100,
+        Spacing31 = 1 << 14,
+        Origin31 = 1 << 30,
+        FastLinesInterval = 10,
+        RoutesCount = 1000,
+        RandomSeed = 42,
+    };
+
+    static const char* const RoutingConfig;
+
+    QTemporaryDir _dataDir;
+    std::shared_ptr<ObfDataInterface> _dataInterface;
+    std::shared_ptr<RoutingProfileContext> _profileContext;
+
+    static void createNetwork(SyntheticRoutingObf& obf);
+private slots:
+    void initTestCase();
+    void loadGraph();
+    void findRoutes();
+};
+
+const char* const BenchmarkRoutePlanner::RoutingConfig =
+    "<osmand_routing_config defaultProfile=\"car\">"
+    "  <routingProfile name=\"car\" minDefaultSpeed=\"45\" maxDefaultSpeed=\"130\">"
+    "    <way attribute=\"speed\">"
+    "      <select value=\"90\" t=\"highway\" v=\"primary\"/>"
+    "      <select value=\"30\" t=\"highway\" v=\"residential\"/>"
+    "    </way>"
+    "  </routingProfile>"
+    "</osmand_routing_config>";
+
+void BenchmarkRoutePlanner::createNetwork(SyntheticRoutingObf& obf)
+{
+    for (auto line = 0; line < GridSize * 2; line++)
+    {
+        const auto horizontal = (line < GridSize);
+        const auto lineIndex = line % GridSize;
+
+        SyntheticRoutingObf::Road road;
+        road.id = line + 1;
+        for (auto index = 0; index < GridSize; index++)
+        {
+            const auto offset31 = index * Spacing31;
+            const auto lineOffset31 = lineIndex * Spacing31;
+            road.points31.push_back(horizontal
+                ? PointI(Origin31 + offset31, Origin31 + lineOffset31)
+                : PointI(Origin31 + lineOffset31, Origin31 + offset31));
+            if (index == GridSize - 1)
+                continue;
+
+            // Single shape point between intersections
+            road.points31.push_back(horizontal
+                ? PointI(Origin31 + offset31 + Spacing31 / 2, Origin31 + lineOffset31 + 256)
+                : PointI(Origin31 + lineOffset31 + 256, Origin31 + offset31 + Spacing31 / 2));
+        }
+        road.tags.push_back(qMakePair(
+            QString(QLatin1String("highway")),
+            QString(QLatin1String(lineIndex % FastLinesInterval == 0 ? "primary" : "residential"))));
+        obf.roads.push_back(road);
+    }
+}
+
+void BenchmarkRoutePlanner::initTestCase()
+{
+    QVERIFY(_dataDir.isValid());
+
+    SyntheticRoutingObf obf;
+    createNetwork(obf);
+    const auto obfFilePath = _dataDir.filePath(QLatin1String("grid.obf"));
+    QVERIFY(obf.write(obfFilePath));
+
+    RoutingConfiguration configuration;
+    QBuffer configurationBuffer;
+    configurationBuffer.setData(RoutingConfig);
+    QVERIFY(configurationBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(RoutingConfiguration::parseConfiguration(&configurationBuffer, configuration));
+    _profileContext.reset(new RoutingProfileContext(configuration.routingProfiles[QLatin1String("car")]));
+
+    const std::shared_ptr<const ObfFile> obfFile(new ObfFile(obfFilePath));
+    const std::shared_ptr<const ObfReader> obfReader(new ObfReader(obfFile));
+    QVERIFY(obfReader->obtainInfo());
+    _dataInterface.reset(new ObfDataInterface(QList< std::shared_ptr<const ObfReader> >() << obfReader));
+}
+
+void BenchmarkRoutePlanner::loadGraph()
+{
+    QElapsedTimer timer;
+    std::shared_ptr<const RoadGraph> graph;
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        graph = RoadGraph::load(_dataInterface, _profileContext);
+    }
+    const auto elapsedTime = timer.elapsed();
+
+    QVERIFY(graph);
+    QCOMPARE(graph->getNodesCount(), static_cast<unsigned int>(GridSize * GridSize));
+    qDebug("Loaded %u nodes and %u edges of %u roads in %lld ms",
+        graph->getNodesCount(),
+        graph->getEdgesCount(),
+        graph->getRoadsCount(),
+        static_cast<long long>(elapsedTime));
+}
+
+void BenchmarkRoutePlanner::findRoutes()
+{
+    const auto graph = RoadGraph::load(_dataInterface, _profileContext);
+    QVERIFY(graph);
+    RoutePlanner planner(graph);
+
+    std::mt19937 randomGenerator(RandomSeed);
+    std::uniform_int_distribution<RoadGraph::NodeIndex> nodesDistribution(0, graph->getNodesCount() - 1);
+    QVector< QPair<RoadGraph::NodeIndex, RoadGraph::NodeIndex> > routesEnds;
+    for (auto routeIndex = 0; routeIndex < RoutesCount; routeIndex++)
+        routesEnds.push_back(qMakePair(nodesDistribution(randomGenerator), nodesDistribution(randomGenerator)));
+
+    QElapsedTimer timer;
+    qint64 elapsedTime = 0;
+    uint64_t settledNodesCount = 0;
+    auto foundRoutesCount = 0;
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        for (const auto& routeEnds : constOf(routesEnds))
+        {
+            auto time = 0.0f;
+            if (planner.findRoute(routeEnds.first, routeEnds.second, nullptr, &time))
+                foundRoutesCount++;
+            settledNodesCount += planner.getLastSettledNodesCount();
+        }
+        elapsedTime = timer.nsecsElapsed();
+    }
+
+    // Grid is connected in both directions, so every route exists
+    QCOMPARE(foundRoutesCount, static_cast<int>(RoutesCount));
+    qDebug("%.1f routes per second, %.1f settled nodes per route",
+        RoutesCount / (elapsedTime / 1000000000.0),
+        settledNodesCount / static_cast<double>(RoutesCount));
+}
+
+QTEST_MAIN(BenchmarkRoutePlanner)
+#include "BenchmarkRoutePlanner.moc"
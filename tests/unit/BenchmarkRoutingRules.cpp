@@ -0,0 +1,247 @@
+#include <random>
+
+#include <OsmAndCore/ObfDataInterface.h>
+#include <OsmAndCore/Data/ObfFile.h>
+#include <OsmAndCore/Data/ObfReader.h>
+#include <OsmAndCore/Data/Road.h>
+#include <OsmAndCore/Routing/RoadGraph.h>
+#include <OsmAndCore/Routing/RoutePlanner.h>
+#include <OsmAndCore/Routing/RoutingConfiguration.h>
+#include <OsmAndCore/Routing/RoutingProfileContext.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include "SyntheticRoutingObf.h"
+
+using namespace OsmAnd;
+
+// Cost of way rules evaluation for every road of grid network, where each piece of grid is a separate road
+// with one of few dozens combinations of tags. Rules are either evaluated for each road separately,
+// or once per distinct set of types. Graph build and search time are measured with cached rules.
+class BenchmarkRoutingRules : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum : int {
+        GridSize = 120,
+        Spacing31 = 1 << 14,
+        Origin31 = 1 << 30,
+        RoutesCount = 500,
+        RandomSeed = 42,
+    };
+
+    enum class Mode
+    {
+        PerRoad,
+        PerTypesSet,
+    };
+
+    static const char* const RoutingConfig;
+
+    QTemporaryDir _dataDir;
+    std::shared_ptr<RoutingProfile> _profile;
+    QList< std::shared_ptr<const Road> > _roads;
+
+    static void createNetwork(SyntheticRoutingObf& obf);
+private slots:
+    void initTestCase();
+    void evaluateRules_data();
+    void evaluateRules();
+    void buildGraphAndSearch();
+};
+
+const char* const BenchmarkRoutingRules::RoutingConfig =
+    "<osmand_routing_config defaultProfile=\"car\">"
+    "  <routingProfile name=\"car\" minDefaultSpeed=\"45\" maxDefaultSpeed=\"130\">"
+    "    <way attribute=\"access\">"
+    "      <select value=\"-1\" t=\"access\" v=\"no\"/>"
+    "      <select value=\"-1\" t=\"highway\" v=\"footway\"/>"
+    "    </way>"
+    "    <way attribute=\"oneway\">"
+    "      <select value=\"1\" t=\"oneway\" v=\"yes\"/>"
+    "      <select value=\"-1\" t=\"oneway\" v=\"-1\"/>"
+    "    </way>"
+    "    <way attribute=\"priority\">"
+    "      <select value=\"0.7\" t=\"surface\" v=\"gravel\"/>"
+    "      <select value=\"0.5\" t=\"surface\" v=\"ground\"/>"
+    "      <select value=\"0.8\" t=\"lanes\" v=\"1\"/>"
+    "    </way>"
+    "    <way attribute=\"speed\">"
+    "      <select value=\"110\" t=\"highway\" v=\"trunk\"/>"
+    "      <select value=\"90\" t=\"highway\" v=\"primary\"/>"
+    "      <select value=\"70\" t=\"highway\" v=\"secondary\"/>"
+    "      <select value=\"50\" t=\"highway\" v=\"tertiary\"/>"
+    "      <select value=\"30\" t=\"highway\" v=\"residential\"/>"
+    "      <select value=\"20\" t=\"highway\" v=\"service\"/>"
+    "    </way>"
+    "  </routingProfile>"
+    "</osmand_routing_config>";
+
+void BenchmarkRoutingRules::createNetwork(SyntheticRoutingObf& obf)
+{
+    static const char* const highways[] = { "trunk", "primary", "secondary", "tertiary", "residential", "service" };
+    static const char* const surfaces[] = { "asphalt", "gravel", "ground" };
+
+    std::mt19937 randomGenerator(RandomSeed);
+    const auto addRoad =
+        [&obf, &randomGenerator]
+        (const PointI& start31, const PointI& end31)
+        {
+            SyntheticRoutingObf::Road road;
+            road.id = obf.roads.size() + 1;
+            road.points31.push_back(start31);
+            road.points31.push_back(PointI((start31.x + end31.x) / 2 + 256, (start31.y + end31.y) / 2 + 256));
+            road.points31.push_back(end31);
+
+            // Tags are listed in random order, so that same set of types is stored differently
+            const auto randomValue = randomGenerator();
+            road.tags.push_back(qMakePair(
+                QString(QLatin1String("highway")),
+                QString(QLatin1String(highways[randomValue % 6]))));
+            road.tags.push_back(qMakePair(
+                QString(QLatin1String("surface")),
+                QString(QLatin1String(surfaces[(randomValue / 6) % 3]))));
+            if ((randomValue / 18) % 4 == 0)
+                road.tags.push_back(qMakePair(QString(QLatin1String("lanes")), QString(QLatin1String("1"))));
+            if ((randomValue / 72) % 8 == 0)
+                road.tags.push_back(qMakePair(QString(QLatin1String("oneway")), QString(QLatin1String("yes"))));
+            std::shuffle(road.tags.begin(), road.tags.end(), randomGenerator);
+
+            obf.roads.push_back(road);
+        };
+
+    for (auto row = 0; row < GridSize; row++)
+    {
+        for (auto column = 0; column < GridSize; column++)
+        {
+            const PointI node31(Origin31 + column * Spacing31, Origin31 + row * Spacing31);
+            if (column + 1 < GridSize)
+                addRoad(node31, PointI(node31.x + Spacing31, node31.y));
+            if (row + 1 < GridSize)
+                addRoad(node31, PointI(node31.x, node31.y + Spacing31));
+        }
+    }
+}
+
+void BenchmarkRoutingRules::initTestCase()
+{
+    QVERIFY(_dataDir.isValid());
+
+    SyntheticRoutingObf obf;
+    createNetwork(obf);
+    const auto obfFilePath = _dataDir.filePath(QLatin1String("grid.obf"));
+    QVERIFY(obf.write(obfFilePath));
+
+    RoutingConfiguration configuration;
+    QBuffer configurationBuffer;
+    configurationBuffer.setData(RoutingConfig);
+    QVERIFY(configurationBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(RoutingConfiguration::parseConfiguration(&configurationBuffer, configuration));
+    _profile = configuration.routingProfiles[QLatin1String("car")];
+
+    const std::shared_ptr<const ObfFile> obfFile(new ObfFile(obfFilePath));
+    const std::shared_ptr<const ObfReader> obfReader(new ObfReader(obfFile));
+    QVERIFY(obfReader->obtainInfo());
+    ObfDataInterface dataInterface(QList< std::shared_ptr<const ObfReader> >() << obfReader);
+    QVERIFY(dataInterface.loadRoads(RoutingDataLevel::Detailed, nullptr, &_roads));
+    QCOMPARE(_roads.size(), obf.roads.size());
+}
+
+void BenchmarkRoutingRules::evaluateRules_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("per road") << static_cast<int>(Mode::PerRoad);
+    QTest::newRow("per types set") << static_cast<int>(Mode::PerTypesSet);
+}
+
+void BenchmarkRoutingRules::evaluateRules()
+{
+    QFETCH(int, mode);
+    const auto evaluationMode = static_cast<Mode>(mode);
+
+    RoutingProfileContext profileContext(_profile);
+    QElapsedTimer timer;
+    qint64 elapsedTime = 0;
+    double speedsSum = 0.0;
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        for (const auto& road : constOf(_roads))
+        {
+            if (evaluationMode == Mode::PerRoad)
+            {
+                if (!profileContext.acceptsRoad(road))
+                    continue;
+                const auto direction = profileContext.getDirection(road);
+                speedsSum += profileContext.getSpeed(road) * profileContext.getSpeedPriority(road)
+                    + static_cast<int>(direction);
+            }
+            else
+            {
+                const auto rules = profileContext.getRoadRules(road);
+                if (!rules.accepted)
+                    continue;
+                speedsSum += rules.speed * rules.priority + static_cast<int>(rules.getDirection());
+            }
+        }
+        elapsedTime = timer.nsecsElapsed();
+    }
+
+    qDebug("%s: %llu rulesets evaluations for %d roads (%u distinct sets of types) in %.2f ms (checksum %.1f)",
+        evaluationMode == Mode::PerRoad ? "per road" : "per types set",
+        static_cast<unsigned long long>(profileContext.getRulesEvaluationsCount()),
+        _roads.size(),
+        profileContext.getCachedRoadRulesCount(),
+        elapsedTime / 1000000.0,
+        speedsSum);
+}
+
+void BenchmarkRoutingRules::buildGraphAndSearch()
+{
+    const std::shared_ptr<RoutingProfileContext> profileContext(new RoutingProfileContext(_profile));
+
+    QElapsedTimer timer;
+    qint64 buildTime = 0;
+    qint64 searchTime = 0;
+    std::shared_ptr<const RoadGraph> graph;
+    auto foundRoutesCount = 0;
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        graph = RoadGraph::build(_roads, profileContext);
+        buildTime = timer.nsecsElapsed();
+        QVERIFY(graph);
+
+        RoutePlanner planner(graph);
+        std::mt19937 randomGenerator(RandomSeed);
+        std::uniform_int_distribution<RoadGraph::NodeIndex> nodesDistribution(0, graph->getNodesCount() - 1);
+        timer.start();
+        for (auto routeIndex = 0; routeIndex < RoutesCount; routeIndex++)
+        {
+            const auto startNode = nodesDistribution(randomGenerator);
+            const auto endNode = nodesDistribution(randomGenerator);
+            if (planner.findRoute(startNode, endNode))
+                foundRoutesCount++;
+        }
+        searchTime = timer.nsecsElapsed();
+    }
+
+    // Rules are evaluated while graph is built, search uses only times of edges
+    QVERIFY(profileContext->getRulesEvaluationsCount() <= profileContext->getCachedRoadRulesCount() * 4u);
+    qDebug("Graph of %u edges built in %.2f ms with %llu rulesets evaluations, %d of %d routes found in %.2f ms",
+        graph->getEdgesCount(),
+        buildTime / 1000000.0,
+        static_cast<unsigned long long>(profileContext->getRulesEvaluationsCount()),
+        foundRoutesCount,
+        static_cast<int>(RoutesCount),
+        searchTime / 1000000.0);
+}
+
+QTEST_MAIN(BenchmarkRoutingRules)
+#include "BenchmarkRoutingRules.moc"
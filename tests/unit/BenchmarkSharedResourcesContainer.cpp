@@ -0,0 +1,173 @@
+#include <OsmAndCore/SharedResourcesContainer.h>
+#include <OsmAndCore/SharedByZoomResourcesContainer.h>
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+
+using namespace OsmAnd;
+
+class BenchmarkSharedResourcesContainer : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        OperationsPerThreadCount = 20000
+    };
+
+    typedef SharedResourcesContainer<uint64_t, const uint64_t> Container;
+    typedef SharedByZoomResourcesContainer<uint64_t, const uint64_t> ByZoomContainer;
+
+    static void addRows();
+    template<typename FUNCTION>
+    static void runThreads(const int threadsCount, const FUNCTION function);
+private slots:
+    void contention_data();
+    void contention();
+    void contentionByZoom_data();
+    void contentionByZoom();
+};
+
+void BenchmarkSharedResourcesContainer::addRows()
+{
+    QTest::addColumn<int>("threadsCount");
+    QTest::addColumn<int>("keysCount");
+
+    for (const auto threadsCount : { 1, 2, 4, 8, 16, 32 })
+    {
+        // Few hot keys: threads mostly share resources and wait on each other's promises
+        QTest::newRow(qPrintable(QString("%1 threads, 64 keys").arg(threadsCount))) << threadsCount << 64;
+
+        // Many keys: threads mostly work on distinct resources, as tiles loading different data blocks do
+        QTest::newRow(qPrintable(QString("%1 threads, 65536 keys").arg(threadsCount))) << threadsCount << 65536;
+    }
+}
+
+template<typename FUNCTION>
+void BenchmarkSharedResourcesContainer::runThreads(const int threadsCount, const FUNCTION function)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount);
+    for (auto threadIndex = 0; threadIndex < threadsCount; threadIndex++)
+        threads.emplace_back(function, threadIndex);
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void BenchmarkSharedResourcesContainer::contention_data()
+{
+    addRows();
+}
+
+// Each operation is the obtain-or-promise / fulfil / release cycle that data block caches perform per block
+void BenchmarkSharedResourcesContainer::contention()
+{
+    QFETCH(int, threadsCount);
+    QFETCH(int, keysCount);
+
+    Container container;
+    std::atomic<int> mismatchesCount(0);
+
+    QBENCHMARK
+    {
+        runThreads(threadsCount,
+            [&container, &mismatchesCount, keysCount]
+            (const int threadIndex)
+            {
+                std::mt19937 randomGenerator(threadIndex);
+                std::uniform_int_distribution<uint64_t> keysDistribution(0, keysCount - 1);
+
+                for (auto operationIndex = 0; operationIndex < OperationsPerThreadCount; operationIndex++)
+                {
+                    const auto key = keysDistribution(randomGenerator);
+
+                    Container::ResourcePtr resource;
+                    proper::shared_future<Container::ResourcePtr> futureResource;
+                    if (!container.obtainReferenceOrFutureReferenceOrMakePromise(key, resource, futureResource))
+                    {
+                        resource = std::make_shared<const uint64_t>(key);
+                        container.fulfilPromiseAndReference(key, resource);
+                    }
+                    else if (!resource)
+                    {
+                        resource = futureResource.get();
+                    }
+
+                    if (*resource != key)
+                        mismatchesCount.fetch_add(1);
+
+                    container.releaseReference(key, resource);
+                }
+            });
+    }
+
+    QCOMPARE(mismatchesCount.load(), 0);
+    for (auto key = 0; key < keysCount; key++)
+        QCOMPARE(container.getReferencesCount(key), static_cast<uintmax_t>(0));
+}
+
+void BenchmarkSharedResourcesContainer::contentionByZoom_data()
+{
+    addRows();
+}
+
+void BenchmarkSharedResourcesContainer::contentionByZoom()
+{
+    QFETCH(int, threadsCount);
+    QFETCH(int, keysCount);
+
+    ByZoomContainer container;
+    std::atomic<int> mismatchesCount(0);
+
+    QBENCHMARK
+    {
+        runThreads(threadsCount,
+            [&container, &mismatchesCount, keysCount]
+            (const int threadIndex)
+            {
+                std::mt19937 randomGenerator(threadIndex);
+                std::uniform_int_distribution<uint64_t> keysDistribution(0, keysCount - 1);
+
+                for (auto operationIndex = 0; operationIndex < OperationsPerThreadCount; operationIndex++)
+                {
+                    const auto key = keysDistribution(randomGenerator);
+
+                    // Every key is shared by a fixed group of zoom levels, like data blocks are
+                    const auto firstZoom = static_cast<ZoomLevel>(MinZoomLevel + (key % 4) * 4);
+                    QSet<ZoomLevel> zoomLevels;
+                    for (auto zoom = 0; zoom < 4; zoom++)
+                        zoomLevels.insert(static_cast<ZoomLevel>(firstZoom + zoom));
+                    const auto zoom = static_cast<ZoomLevel>(firstZoom + (operationIndex % 4));
+
+                    ByZoomContainer::ResourcePtr resource;
+                    proper::shared_future<ByZoomContainer::ResourcePtr> futureResource;
+                    if (!container.obtainReferenceOrFutureReferenceOrMakePromise(key, zoom, zoomLevels, resource, futureResource))
+                    {
+                        resource = std::make_shared<const uint64_t>(key);
+                        container.fulfilPromiseAndReference(key, zoomLevels, resource);
+                    }
+                    else if (!resource)
+                    {
+                        resource = futureResource.get();
+                    }
+
+                    if (*resource != key)
+                        mismatchesCount.fetch_add(1);
+
+                    container.releaseReference(key, zoom, resource);
+                }
+            });
+    }
+
+    QCOMPARE(mismatchesCount.load(), 0);
+    for (auto key = 0; key < keysCount; key++)
+        QCOMPARE(container.getReferencesCount(key), static_cast<uintmax_t>(0));
+}
+
+QTEST_MAIN(BenchmarkSharedResourcesContainer)
+#include "BenchmarkSharedResourcesContainer.moc"
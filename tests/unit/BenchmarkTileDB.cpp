@@ -0,0 +1,304 @@
+#include <OsmAndCore/TileDB.h>
+
+#include <algorithm>
+#include <random>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+
+using namespace OsmAnd;
+
+class BenchmarkTileDB : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        TilesCount = 100000,
+        TilesPerRow = 400,
+        TileSize = 512,
+        FirstX = 4000,
+        FirstY = 2000,
+        // Lookups that prepare queries and open database each time are slow, so only part of tiles is used
+        LegacyLookupsCount = 10000,
+        // Side of square block of tiles that is obtained at once, as visible area of map
+        BatchSide = 4,
+    };
+
+    QTemporaryDir _dir;
+    QVector<TileId> _lookupOrder;
+
+    QString getDataPath() const;
+    QString getDbFilename() const;
+    static QByteArray makeTileData(const TileId tileId);
+    bool generate();
+    bool obtainTileDataLegacy(QSqlDatabase& indexDb, const TileId tileId, QByteArray& data) const;
+private slots:
+    void initTestCase();
+    void open();
+    void lookupLegacy();
+    void lookup();
+    void lookupBatch();
+};
+
+QString BenchmarkTileDB::getDataPath() const
+{
+    return QDir(_dir.path()).absoluteFilePath(QLatin1String("data"));
+}
+
+QString BenchmarkTileDB::getDbFilename() const
+{
+    return QDir(getDataPath()).absoluteFilePath(QLatin1String("heightmap.sqlite"));
+}
+
+QByteArray BenchmarkTileDB::makeTileData(const TileId tileId)
+{
+    std::minstd_rand generator(static_cast<uint32_t>(tileId.id));
+    QByteArray data(TileSize, Qt::Uninitialized);
+    for (auto& byte : data)
+        byte = static_cast<char>(generator());
+    return data;
+}
+
+// Layout of generated file is same as of heightmap TileDB files: 'tiles' with index by coordinates and 'bounds'
+bool BenchmarkTileDB::generate()
+{
+    if (!QDir(_dir.path()).mkpath(QLatin1String("data")))
+        return false;
+
+    bool ok = true;
+    {
+        auto db = QSqlDatabase::addDatabase("QSQLITE", QLatin1String("benchmark-generate"));
+        db.setDatabaseName(getDbFilename());
+        ok = db.open();
+
+        QSqlQuery query(db);
+        ok = ok && query.exec("CREATE TABLE tiles (x INTEGER, y INTEGER, zoom INTEGER, data BLOB)");
+        ok = ok && query.exec("CREATE INDEX tiles_index ON tiles(x, y, zoom)");
+        ok = ok && query.exec("CREATE TABLE bounds (zoom INTEGER, xMin INTEGER, yMin INTEGER, xMax INTEGER, yMax INTEGER)");
+
+        ok = ok && db.transaction();
+        QSqlQuery insertQuery(db);
+        ok = ok && insertQuery.prepare("INSERT INTO tiles (x, y, zoom, data) VALUES (?, ?, ?, ?)");
+        for (auto tileIdx = 0; ok && tileIdx < TilesCount; tileIdx++)
+        {
+            const auto tileId = TileId::fromXY(FirstX + tileIdx % TilesPerRow, FirstY + tileIdx / TilesPerRow);
+            insertQuery.addBindValue(tileId.x);
+            insertQuery.addBindValue(tileId.y);
+            insertQuery.addBindValue(static_cast<int>(ZoomLevel14));
+            insertQuery.addBindValue(makeTileData(tileId));
+            ok = insertQuery.exec();
+        }
+        ok = ok && db.commit();
+
+        QSqlQuery boundsQuery(db);
+        ok = ok && boundsQuery.prepare("INSERT INTO bounds (zoom, xMin, yMin, xMax, yMax) VALUES (?, ?, ?, ?, ?)");
+        boundsQuery.addBindValue(static_cast<int>(ZoomLevel14));
+        boundsQuery.addBindValue(static_cast<int>(FirstX));
+        boundsQuery.addBindValue(static_cast<int>(FirstY));
+        boundsQuery.addBindValue(static_cast<int>(FirstX + TilesPerRow - 1));
+        boundsQuery.addBindValue(static_cast<int>(FirstY + (TilesCount - 1) / TilesPerRow));
+        ok = ok && boundsQuery.exec();
+
+        if (!ok)
+            qWarning("Failed to generate TileDB: %s", qPrintable(db.lastError().text()));
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QLatin1String("benchmark-generate"));
+
+    return ok;
+}
+
+// Same queries as TileDB used to do for each tile: lookup in index, open database, prepare query and close it
+bool BenchmarkTileDB::obtainTileDataLegacy(QSqlDatabase& indexDb, const TileId tileId, QByteArray& data) const
+{
+    QSqlQuery query(indexDb);
+    query.prepare("SELECT filename FROM tiledb_files WHERE id IN (SELECT id FROM tiledb_index WHERE xMin<=? AND xMax>=? AND yMin<=? AND yMax>=? AND zoom=?)");
+    query.addBindValue(tileId.x);
+    query.addBindValue(tileId.x);
+    query.addBindValue(tileId.y);
+    query.addBindValue(tileId.y);
+    query.addBindValue(static_cast<int>(ZoomLevel14));
+    if (!query.exec() || !query.next())
+        return false;
+
+    auto db = QSqlDatabase::database(QLatin1String("benchmark-legacy"), false);
+    db.setDatabaseName(query.value(0).toString());
+    if (!db.open())
+        return false;
+
+    bool hit = false;
+    {
+        QSqlQuery tileQuery(db);
+        tileQuery.prepare("SELECT data FROM tiles WHERE x=? AND y=? AND zoom=?");
+        tileQuery.addBindValue(tileId.x);
+        tileQuery.addBindValue(tileId.y);
+        tileQuery.addBindValue(static_cast<int>(ZoomLevel14));
+        if (tileQuery.exec() && tileQuery.next())
+        {
+            data = tileQuery.value(0).toByteArray();
+            hit = true;
+        }
+    }
+    db.close();
+
+    return hit;
+}
+
+void BenchmarkTileDB::initTestCase()
+{
+    QVERIFY(_dir.isValid());
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(generate());
+    qDebug("generated %d tiles of %d bytes in %.3f s",
+        static_cast<int>(TilesCount),
+        static_cast<int>(TileSize),
+        timer.nsecsElapsed() / 1e9);
+
+    for (auto tileIdx = 0; tileIdx < TilesCount; tileIdx++)
+        _lookupOrder.push_back(TileId::fromXY(FirstX + tileIdx % TilesPerRow, FirstY + tileIdx / TilesPerRow));
+    std::shuffle(_lookupOrder.begin(), _lookupOrder.end(), std::minstd_rand(42));
+}
+
+// Index of files and in-memory index of tiles are built on first access
+void BenchmarkTileDB::open()
+{
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        TileDB tileDb(getDataPath());
+        QByteArray data;
+
+        timer.start();
+        QVERIFY(tileDb.obtainTileData(_lookupOrder.first(), ZoomLevel14, data));
+    }
+
+    qDebug("open: indexed %d tiles in %.3f s",
+        static_cast<int>(TilesCount),
+        timer.nsecsElapsed() / 1e9);
+}
+
+void BenchmarkTileDB::lookupLegacy()
+{
+    QByteArray data;
+    QElapsedTimer timer;
+    int foundCount = 0;
+    {
+        auto indexDb = QSqlDatabase::addDatabase("QSQLITE", QLatin1String("benchmark-legacy-index"));
+        indexDb.setDatabaseName(QLatin1String(":memory:"));
+        QVERIFY(indexDb.open());
+        QSqlQuery query(indexDb);
+        QVERIFY(query.exec("CREATE TABLE tiledb_files (id INTEGER PRIMARY KEY AUTOINCREMENT, filename TEXT)"));
+        QVERIFY(query.exec("CREATE TABLE tiledb_index (xMin INTEGER, yMin INTEGER, xMax INTEGER, yMax INTEGER, zoom INTEGER, id INTEGER)"));
+        QVERIFY(query.exec("CREATE INDEX _tiledb_index ON tiledb_index(xMin, yMin, xMax, yMax, zoom)"));
+        QVERIFY(query.exec(QString("INSERT INTO tiledb_files (filename) VALUES ('%1')").arg(getDbFilename())));
+        QVERIFY(query.exec(QString("INSERT INTO tiledb_index VALUES (%1, %2, %3, %4, %5, 1)")
+            .arg(static_cast<int>(FirstX))
+            .arg(static_cast<int>(FirstY))
+            .arg(static_cast<int>(FirstX + TilesPerRow - 1))
+            .arg(static_cast<int>(FirstY + (TilesCount - 1) / TilesPerRow))
+            .arg(static_cast<int>(ZoomLevel14))));
+        QSqlDatabase::addDatabase("QSQLITE", QLatin1String("benchmark-legacy"));
+
+        QBENCHMARK_ONCE
+        {
+            timer.start();
+            for (auto lookupIdx = 0; lookupIdx < LegacyLookupsCount; lookupIdx++)
+            {
+                const auto tileId = _lookupOrder[lookupIdx];
+                if (obtainTileDataLegacy(indexDb, tileId, data))
+                    foundCount++;
+            }
+        }
+
+        indexDb.close();
+    }
+    QSqlDatabase::removeDatabase(QLatin1String("benchmark-legacy"));
+    QSqlDatabase::removeDatabase(QLatin1String("benchmark-legacy-index"));
+
+    QCOMPARE(foundCount, static_cast<int>(LegacyLookupsCount));
+    QCOMPARE(data, makeTileData(_lookupOrder[LegacyLookupsCount - 1]));
+    qDebug("legacy lookup: %d tiles in %.3f s: %.1f us per tile",
+        foundCount,
+        timer.nsecsElapsed() / 1e9,
+        timer.nsecsElapsed() / 1e3 / foundCount);
+}
+
+void BenchmarkTileDB::lookup()
+{
+    TileDB tileDb(getDataPath());
+    QByteArray data;
+    QVERIFY(tileDb.obtainTileData(_lookupOrder.first(), ZoomLevel14, data));
+
+    QElapsedTimer timer;
+    int foundCount = 0;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        for (const auto& tileId : constOf(_lookupOrder))
+        {
+            if (tileDb.obtainTileData(tileId, ZoomLevel14, data))
+                foundCount++;
+        }
+    }
+
+    QCOMPARE(foundCount, static_cast<int>(TilesCount));
+    QCOMPARE(data, makeTileData(_lookupOrder.last()));
+    qDebug("indexed lookup: %d tiles in %.3f s: %.1f us per tile",
+        foundCount,
+        timer.nsecsElapsed() / 1e9,
+        timer.nsecsElapsed() / 1e3 / foundCount);
+}
+
+void BenchmarkTileDB::lookupBatch()
+{
+    TileDB tileDb(getDataPath());
+    QByteArray data;
+    QVERIFY(tileDb.obtainTileData(_lookupOrder.first(), ZoomLevel14, data));
+
+    QElapsedTimer timer;
+    int foundCount = 0;
+    int batchesCount = 0;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        for (auto yOffset = 0; yOffset + BatchSide <= TilesCount / TilesPerRow; yOffset += BatchSide)
+        {
+            for (auto xOffset = 0; xOffset + BatchSide <= TilesPerRow; xOffset += BatchSide)
+            {
+                QVector<TileId> tileIds;
+                for (auto y = 0; y < BatchSide; y++)
+                {
+                    for (auto x = 0; x < BatchSide; x++)
+                        tileIds.push_back(TileId::fromXY(FirstX + xOffset + x, FirstY + yOffset + y));
+                }
+
+                QHash<TileId, QByteArray> tilesData;
+                QVERIFY(tileDb.obtainTilesData(tileIds, ZoomLevel14, tilesData));
+                foundCount += tilesData.size();
+                batchesCount++;
+            }
+        }
+    }
+
+    QCOMPARE(foundCount, static_cast<int>(TilesCount));
+    qDebug("batch lookup: %d tiles in %d batches in %.3f s: %.1f us per tile",
+        foundCount,
+        batchesCount,
+        timer.nsecsElapsed() / 1e9,
+        timer.nsecsElapsed() / 1e3 / foundCount);
+}
+
+QTEST_MAIN(BenchmarkTileDB)
+#include "BenchmarkTileDB.moc"
@@ -0,0 +1,258 @@
+#include <OsmAndCore/Map/FileTileStore.h>
+#include <OsmAndCore/Map/SqliteTileStore.h>
+
+#include <memory>
+#include <algorithm>
+#include <random>
+#if defined(Q_OS_UNIX)
+#   include <sys/stat.h>
+#endif
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QDirIterator>
+#include <QDir>
+
+using namespace OsmAnd;
+
+class BenchmarkTileStore : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        TilesCount = 20000,
+        TilesPerRow = 200,
+        MinTileSize = 2 * 1024,
+        MaxTileSize = 20 * 1024,
+        // Part of tiles that are known to not exist, as ocean tiles of some sources
+        EmptyTileEvery = 10,
+    };
+
+    QTemporaryDir _dir;
+    QVector<TileId> _tiles;
+    QVector<TileId> _lookupOrder;
+
+    QString getFilesPath() const;
+    QString getSqliteFilename() const;
+    std::shared_ptr<ITileStore> createStore(const QString& kind) const;
+    static QByteArray makeTileData(const int tileIndex);
+    static bool populate(ITileStore& store, const QVector<TileId>& tiles);
+    static void measureFootprint(const QString& path, qint64& outBytes, qint64& outAllocatedBytes, int& outFilesCount);
+    void lookupAll(ITileStore& store, const char* const name, const char* const kind);
+private slots:
+    void initTestCase();
+    void footprint();
+    void lookup_data();
+    void lookup();
+    void migrate();
+};
+
+QString BenchmarkTileStore::getFilesPath() const
+{
+    return QDir(_dir.path()).absoluteFilePath(QLatin1String("files"));
+}
+
+QString BenchmarkTileStore::getSqliteFilename() const
+{
+    return QDir(_dir.path()).absoluteFilePath(QLatin1String("tiles.sqlitedb"));
+}
+
+std::shared_ptr<ITileStore> BenchmarkTileStore::createStore(const QString& kind) const
+{
+    if (kind == QLatin1String("files"))
+        return std::make_shared<FileTileStore>(getFilesPath());
+
+    const auto store = std::make_shared<SqliteTileStore>(getSqliteFilename());
+    if (!store->open())
+        return nullptr;
+    return store;
+}
+
+// Sizes vary like those of rendered PNG tiles
+QByteArray BenchmarkTileStore::makeTileData(const int tileIndex)
+{
+    if (tileIndex % EmptyTileEvery == 0)
+        return QByteArray();
+
+    std::minstd_rand generator(tileIndex);
+    const auto size = MinTileSize + static_cast<int>(generator() % (MaxTileSize - MinTileSize));
+    QByteArray data(size, Qt::Uninitialized);
+    for (auto& byte : data)
+        byte = static_cast<char>(generator());
+    return data;
+}
+
+bool BenchmarkTileStore::populate(ITileStore& store, const QVector<TileId>& tiles)
+{
+    for (auto tileIdx = 0; tileIdx < tiles.size(); tileIdx++)
+    {
+        if (!store.storeTile(tiles[tileIdx], ZoomLevel14, makeTileData(tileIdx)))
+            return false;
+    }
+    return true;
+}
+
+void BenchmarkTileStore::measureFootprint(
+    const QString& path,
+    qint64& outBytes,
+    qint64& outAllocatedBytes,
+    int& outFilesCount)
+{
+    outBytes = 0;
+    outAllocatedBytes = 0;
+    outFilesCount = 0;
+
+    QStringList filenames;
+    if (QFileInfo(path).isDir())
+    {
+        QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            filenames.push_back(it.next());
+    }
+    else
+    {
+        // Write-ahead log is part of database
+        for (const auto& suffix : QStringList() << QString() << QLatin1String("-wal") << QLatin1String("-shm"))
+        {
+            if (QFile::exists(path + suffix))
+                filenames.push_back(path + suffix);
+        }
+    }
+
+    for (const auto& filename : filenames)
+    {
+        const QFileInfo fileInfo(filename);
+        outBytes += fileInfo.size();
+        outFilesCount++;
+#if defined(Q_OS_UNIX)
+        struct stat fileStat;
+        if (stat(QFile::encodeName(filename).constData(), &fileStat) == 0)
+            outAllocatedBytes += static_cast<qint64>(fileStat.st_blocks) * 512;
+#else
+        outAllocatedBytes += (fileInfo.size() + 4095) / 4096 * 4096;
+#endif
+    }
+}
+
+void BenchmarkTileStore::initTestCase()
+{
+    QVERIFY(_dir.isValid());
+
+    for (auto tileIdx = 0; tileIdx < TilesCount; tileIdx++)
+        _tiles.push_back(TileId::fromXY(8000 + tileIdx % TilesPerRow, 5000 + tileIdx / TilesPerRow));
+    _lookupOrder = _tiles;
+    std::shuffle(_lookupOrder.begin(), _lookupOrder.end(), std::minstd_rand(42));
+
+    for (const auto& kind : QStringList() << QLatin1String("files") << QLatin1String("sqlite"))
+    {
+        const auto store = createStore(kind);
+        QVERIFY(store);
+
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(populate(*store, _tiles));
+        qDebug("%s: stored %d tiles in %.3f s",
+            qPrintable(kind),
+            static_cast<int>(TilesCount),
+            timer.nsecsElapsed() / 1e9);
+    }
+}
+
+void BenchmarkTileStore::footprint()
+{
+    for (const auto& path : QStringList() << getFilesPath() << getSqliteFilename())
+    {
+        qint64 bytes = 0;
+        qint64 allocatedBytes = 0;
+        int filesCount = 0;
+        measureFootprint(path, bytes, allocatedBytes, filesCount);
+        QVERIFY(filesCount > 0);
+
+        qDebug("%s: %d files, %.1f MB of data, %.1f MB allocated on disk",
+            qPrintable(QFileInfo(path).fileName()),
+            filesCount,
+            bytes / (1024.0 * 1024.0),
+            allocatedBytes / (1024.0 * 1024.0));
+    }
+}
+
+void BenchmarkTileStore::lookupAll(ITileStore& store, const char* const name, const char* const kind)
+{
+    QElapsedTimer timer;
+    qint64 bytes = 0;
+    int foundCount = 0;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        for (const auto& tileId : _lookupOrder)
+        {
+            QByteArray data;
+            if (store.obtainTile(tileId, ZoomLevel14, data))
+            {
+                foundCount++;
+                bytes += data.size();
+            }
+        }
+    }
+
+    QCOMPARE(foundCount, static_cast<int>(TilesCount));
+    qDebug("%s %s lookup: %d tiles, %.1f MB in %.3f s: %.1f us per tile",
+        name,
+        kind,
+        foundCount,
+        bytes / (1024.0 * 1024.0),
+        timer.nsecsElapsed() / 1e9,
+        timer.nsecsElapsed() / 1e3 / foundCount);
+}
+
+void BenchmarkTileStore::lookup_data()
+{
+    QTest::addColumn<QString>("kind");
+
+    QTest::newRow("files") << QString(QLatin1String("files"));
+    QTest::newRow("sqlite") << QString(QLatin1String("sqlite"));
+}
+
+// Cold pass is done right after store is opened, OS file cache is not dropped since that needs root
+void BenchmarkTileStore::lookup()
+{
+    QFETCH(QString, kind);
+
+    const auto store = createStore(kind);
+    QVERIFY(store);
+
+    lookupAll(*store, qPrintable(kind), "cold");
+    lookupAll(*store, qPrintable(kind), "warm");
+}
+
+void BenchmarkTileStore::migrate()
+{
+    const auto cachePath = QDir(_dir.path()).absoluteFilePath(QLatin1String("migrated"));
+    const auto filename = QDir(_dir.path()).absoluteFilePath(QLatin1String("migrated.sqlitedb"));
+
+    FileTileStore fileStore(cachePath);
+    QVERIFY(populate(fileStore, _tiles));
+
+    SqliteTileStore store(filename);
+    QVERIFY(store.open());
+    QElapsedTimer timer;
+    unsigned int importedCount = 0;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        QVERIFY(store.importDirectory(cachePath, true, &importedCount));
+    }
+
+    QCOMPARE(importedCount, static_cast<unsigned int>(TilesCount));
+    qDebug("migration: %u tiles in %.3f s",
+        importedCount,
+        timer.nsecsElapsed() / 1e9);
+}
+
+QTEST_MAIN(BenchmarkTileStore)
+#include "BenchmarkTileStore.moc"
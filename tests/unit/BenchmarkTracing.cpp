@@ -0,0 +1,98 @@
+#include <OsmAndCore/Tracing.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+using namespace OsmAnd;
+
+// Cost of a span around tiny piece of work, when tracer is compiled in but not started (which is
+// the case for all normal runs), and while it records. Baseline is same work without span.
+class BenchmarkTracing : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        SpansCount = 50000,
+        RepetitionsCount = 20,
+    };
+
+    enum class Mode
+    {
+        Baseline,
+        Idle,
+        Recording,
+    };
+
+    static uint64_t doWork(const uint64_t seed);
+private slots:
+    void spanOverhead_data();
+    void spanOverhead();
+};
+
+// Kept out of line, so that loop is not optimized away
+Q_NEVER_INLINE uint64_t BenchmarkTracing::doWork(const uint64_t seed)
+{
+    return seed * 6364136223846793005ull + 1442695040888963407ull;
+}
+
+void BenchmarkTracing::spanOverhead_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("without span") << static_cast<int>(Mode::Baseline);
+    QTest::newRow("idle tracer") << static_cast<int>(Mode::Idle);
+    QTest::newRow("recording tracer") << static_cast<int>(Mode::Recording);
+}
+
+void BenchmarkTracing::spanOverhead()
+{
+    QFETCH(int, mode);
+    const auto tracingMode = static_cast<Mode>(mode);
+
+    QElapsedTimer timer;
+    qint64 elapsedTime = 0;
+    uint64_t value = 0;
+    QBENCHMARK_ONCE
+    {
+        for (auto repetitionIndex = 0; repetitionIndex < RepetitionsCount; repetitionIndex++)
+        {
+            // Each repetition fits into buffer, so that recording never drops spans
+            if (tracingMode == Mode::Recording)
+                Tracer::start();
+            else
+                Tracer::stop();
+
+            timer.start();
+            if (tracingMode == Mode::Baseline)
+            {
+                for (auto spanIndex = 0; spanIndex < SpansCount; spanIndex++)
+                    value = doWork(value);
+            }
+            else
+            {
+                for (auto spanIndex = 0; spanIndex < SpansCount; spanIndex++)
+                {
+                    OSMAND_TRACE_SCOPE("Benchmark", "span");
+                    value = doWork(value);
+                }
+            }
+            elapsedTime += timer.nsecsElapsed();
+        }
+        Tracer::stop();
+    }
+
+    if (tracingMode == Mode::Recording)
+    {
+        QCOMPARE(Tracer::getRecordedSpansCount(), static_cast<unsigned int>(SpansCount));
+        QCOMPARE(Tracer::getDroppedSpansCount(), static_cast<uint64_t>(0));
+    }
+    qDebug("%s: %.2f ns per iteration (checksum %llu)",
+        tracingMode == Mode::Baseline ? "without span" : (tracingMode == Mode::Idle ? "idle tracer" : "recording tracer"),
+        elapsedTime / static_cast<double>(SpansCount * RepetitionsCount),
+        static_cast<unsigned long long>(value));
+}
+
+QTEST_MAIN(BenchmarkTracing)
+#include "BenchmarkTracing.moc"
@@ -0,0 +1,144 @@
+#include <OsmAndCore/WebClient.h>
+#include <OsmAndCore/QRunnableFunctor.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QAtomicInt>
+
+#include "LoopbackHttpServer.h"
+
+using namespace OsmAnd;
+
+class BenchmarkWebClient : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        TilesCount = 500,
+        // Emulated round trip of tile server
+        ResponseDelayMs = 20,
+        PayloadSize = 16 * 1024,
+        // Same as number of tile workers that download tiles
+        WorkersCount = 4,
+        TimeoutMs = 60000,
+    };
+
+    std::unique_ptr<LoopbackHttpServer> _server;
+
+    QString getTileUrl(const int tileIdx) const;
+    void report(const char* const name, const qint64 elapsedNs, const int tilesCount) const;
+private slots:
+    void initTestCase();
+    void init();
+    void blockingWorkers();
+    void asyncRequests_data();
+    void asyncRequests();
+};
+
+QString BenchmarkWebClient::getTileUrl(const int tileIdx) const
+{
+    return _server->getBaseUrl() + QString(QLatin1String("/tile/15/%1/%2.png")).arg(tileIdx % 100).arg(tileIdx / 100);
+}
+
+void BenchmarkWebClient::report(const char* const name, const qint64 elapsedNs, const int tilesCount) const
+{
+    const auto seconds = elapsedNs / 1e9;
+    qDebug("%s: %d tiles in %.3f s: %.1f tiles/s, %d requests, %d connections, %d requests in progress at most",
+        name,
+        tilesCount,
+        seconds,
+        tilesCount / seconds,
+        _server->getRequestsCount(),
+        _server->getConnectionsCount(),
+        _server->getMaxRequestsInProgressCount());
+}
+
+void BenchmarkWebClient::initTestCase()
+{
+    _server.reset(new LoopbackHttpServer(ResponseDelayMs, PayloadSize));
+    QVERIFY(_server->startListening());
+}
+
+void BenchmarkWebClient::init()
+{
+    _server->resetCounters();
+}
+
+// Each tile worker blocks on its own request, that uses new connection each time
+void BenchmarkWebClient::blockingWorkers()
+{
+    WebClient webClient(QLatin1String("OsmAnd Core"), WorkersCount);
+    QThreadPool workers;
+    workers.setMaxThreadCount(WorkersCount);
+    QAtomicInt succeededCount;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        for (auto tileIdx = 0; tileIdx < TilesCount; tileIdx++)
+        {
+            const auto url = getTileUrl(tileIdx);
+            workers.start(new QRunnableFunctor(
+                [&webClient, &succeededCount, url]
+                (const QRunnableFunctor* const runnable)
+                {
+                    std::shared_ptr<const IWebClient::IRequestResult> requestResult;
+                    webClient.downloadData(url, &requestResult);
+                    if (requestResult && requestResult->isSuccessful())
+                        succeededCount.fetchAndAddOrdered(1);
+                }));
+        }
+        QVERIFY(workers.waitForDone(TimeoutMs));
+    }
+
+    QCOMPARE(succeededCount.loadAcquire(), static_cast<int>(TilesCount));
+    report("Blocking workers", timer.nsecsElapsed(), TilesCount);
+}
+
+void BenchmarkWebClient::asyncRequests_data()
+{
+    QTest::addColumn<unsigned int>("perHostRequestsLimit");
+
+    QTest::newRow("1 per host") << 1u;
+    QTest::newRow("4 per host") << 4u;
+    QTest::newRow("6 per host") << 6u;
+}
+
+// All requests are issued at once from single thread, network thread keeps connections alive
+void BenchmarkWebClient::asyncRequests()
+{
+    QFETCH(unsigned int, perHostRequestsLimit);
+
+    WebClient webClient;
+    webClient.setPerHostRequestsLimit(perHostRequestsLimit);
+    QAtomicInt succeededCount;
+    QElapsedTimer timer;
+
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        QList< std::shared_ptr<WebClient::AsyncRequest> > requests;
+        for (auto tileIdx = 0; tileIdx < TilesCount; tileIdx++)
+        {
+            requests.append(webClient.downloadDataAsync(getTileUrl(tileIdx),
+                [&succeededCount]
+                (const QByteArray& data, const std::shared_ptr<const IWebClient::IRequestResult>& requestResult)
+                {
+                    if (requestResult && requestResult->isSuccessful() && data.size() == PayloadSize)
+                        succeededCount.fetchAndAddOrdered(1);
+                }));
+        }
+        for (const auto& request : requests)
+            QVERIFY(request->waitUntilFinished(TimeoutMs));
+    }
+
+    QCOMPARE(succeededCount.loadAcquire(), static_cast<int>(TilesCount));
+    report(QTest::currentDataTag(), timer.nsecsElapsed(), TilesCount);
+}
+
+QTEST_MAIN(BenchmarkWebClient)
+#include "BenchmarkWebClient.moc"
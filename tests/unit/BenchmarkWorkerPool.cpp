@@ -0,0 +1,266 @@
+#include <OsmAndCore/Concurrent/WorkerPool.h>
+#include <OsmAndCore/QRunnableFunctor.h>
+
+#include <atomic>
+#include <algorithm>
+#include <vector>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+using namespace OsmAnd;
+using namespace OsmAnd::Concurrent;
+Q_DECLARE_METATYPE(WorkerPool::Scheduler)
+
+class BenchmarkWorkerPool : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        FlatTasksCount = 100000,
+        ParentTasksCount = 1000,
+        ChildTasksPerParentCount = 100,
+        LatencySamplesCount = 10000
+    };
+
+    void addSchedulerRows();
+private slots:
+    void throughputFlat_data();
+    void throughputFlat();
+    void throughputNested_data();
+    void throughputNested();
+    void latency_data();
+    void latency();
+    void dequeue_data();
+    void dequeue();
+    void sharedAcrossPools();
+};
+
+void BenchmarkWorkerPool::addSchedulerRows()
+{
+    QTest::addColumn<WorkerPool::Scheduler>("scheduler");
+
+    QTest::newRow("SharedQueue") << WorkerPool::Scheduler::SharedQueue;
+    QTest::newRow("WorkStealing") << WorkerPool::Scheduler::WorkStealing;
+    QTest::newRow("SharedWorkStealing") << WorkerPool::Scheduler::SharedWorkStealing;
+}
+
+void BenchmarkWorkerPool::throughputFlat_data()
+{
+    addSchedulerRows();
+}
+
+// Many tiny runnables enqueued from single non-worker thread
+void BenchmarkWorkerPool::throughputFlat()
+{
+    QFETCH(WorkerPool::Scheduler, scheduler);
+
+    WorkerPool pool(WorkerPool::Order::FIFO, QThread::idealThreadCount(), scheduler);
+    std::atomic<int> executedCount(0);
+
+    QBENCHMARK
+    {
+        executedCount.store(0);
+        for (auto taskIndex = 0; taskIndex < FlatTasksCount; taskIndex++)
+        {
+            pool.enqueue(new QRunnableFunctor(
+                [&executedCount]
+                (const QRunnableFunctor* const runnable)
+                {
+                    executedCount.fetch_add(1, std::memory_order_relaxed);
+                }));
+        }
+        QVERIFY(pool.waitForDone());
+    }
+
+    QCOMPARE(executedCount.load(), static_cast<int>(FlatTasksCount));
+}
+
+void BenchmarkWorkerPool::throughputNested_data()
+{
+    addSchedulerRows();
+}
+
+// Runnables that fan out into subtasks from inside worker threads, as tile requests producing symbol requests do
+void BenchmarkWorkerPool::throughputNested()
+{
+    QFETCH(WorkerPool::Scheduler, scheduler);
+
+    WorkerPool pool(WorkerPool::Order::FIFO, QThread::idealThreadCount(), scheduler);
+    std::atomic<int> executedCount(0);
+
+    QBENCHMARK
+    {
+        executedCount.store(0);
+        QVector<QRunnable*> parentTasks;
+        parentTasks.reserve(ParentTasksCount);
+        for (auto taskIndex = 0; taskIndex < ParentTasksCount; taskIndex++)
+        {
+            parentTasks.push_back(new QRunnableFunctor(
+                [&pool, &executedCount]
+                (const QRunnableFunctor* const runnable)
+                {
+                    for (auto childIndex = 0; childIndex < ChildTasksPerParentCount; childIndex++)
+                    {
+                        pool.enqueue(new QRunnableFunctor(
+                            [&executedCount]
+                            (const QRunnableFunctor* const runnable)
+                            {
+                                executedCount.fetch_add(1, std::memory_order_relaxed);
+                            }));
+                    }
+                    executedCount.fetch_add(1, std::memory_order_relaxed);
+                }));
+        }
+        pool.enqueue(parentTasks);
+        QVERIFY(pool.waitForDone());
+    }
+
+    QCOMPARE(executedCount.load(), static_cast<int>(ParentTasksCount * (ChildTasksPerParentCount + 1)));
+}
+
+void BenchmarkWorkerPool::latency_data()
+{
+    addSchedulerRows();
+}
+
+// Time from enqueue() call until runnable starts executing, one runnable in flight at a time
+void BenchmarkWorkerPool::latency()
+{
+    QFETCH(WorkerPool::Scheduler, scheduler);
+
+    WorkerPool pool(WorkerPool::Order::FIFO, QThread::idealThreadCount(), scheduler);
+    std::vector<qint64> samples;
+    samples.reserve(LatencySamplesCount);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (auto sampleIndex = 0; sampleIndex < LatencySamplesCount; sampleIndex++)
+    {
+        std::atomic<qint64> startedAt(-1);
+        const auto enqueuedAt = timer.nsecsElapsed();
+        pool.enqueue(new QRunnableFunctor(
+            [&timer, &startedAt]
+            (const QRunnableFunctor* const runnable)
+            {
+                startedAt.store(timer.nsecsElapsed());
+            }));
+        QVERIFY(pool.waitForDone());
+
+        samples.push_back(startedAt.load() - enqueuedAt);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    qint64 totalNs = 0;
+    for (const auto sample : samples)
+        totalNs += sample;
+    const auto p50 = samples[samples.size() / 2];
+    const auto p99 = samples[(samples.size() * 99) / 100];
+    qDebug("enqueue-to-start latency: mean %lld ns, p50 %lld ns, p99 %lld ns",
+        totalNs / static_cast<qint64>(samples.size()), p50, p99);
+
+    QTest::setBenchmarkResult(static_cast<qreal>(p50), QTest::WalltimeNanoseconds);
+}
+
+void BenchmarkWorkerPool::dequeue_data()
+{
+    addSchedulerRows();
+}
+
+// Dequeued runnables must not run and must not be counted as pending
+void BenchmarkWorkerPool::dequeue()
+{
+    QFETCH(WorkerPool::Scheduler, scheduler);
+
+    WorkerPool pool(WorkerPool::Order::FIFO, 1, scheduler);
+    QMutex gateMutex;
+    gateMutex.lock();
+    std::atomic<int> executedCount(0);
+
+    pool.enqueue(new QRunnableFunctor(
+        [&gateMutex]
+        (const QRunnableFunctor* const runnable)
+        {
+            QMutexLocker scopedLocker(&gateMutex);
+        }));
+
+    QVector<QRunnable*> tasks;
+    for (auto taskIndex = 0; taskIndex < 100; taskIndex++)
+    {
+        const auto task = new QRunnableFunctor(
+            [&executedCount]
+            (const QRunnableFunctor* const runnable)
+            {
+                executedCount.fetch_add(1);
+            });
+        task->setAutoDelete(false);
+        tasks.push_back(task);
+    }
+    pool.enqueue(tasks);
+
+    auto dequeuedCount = 0;
+    for (auto taskIndex = 0; taskIndex < tasks.size(); taskIndex += 2)
+    {
+        if (pool.dequeue(tasks[taskIndex]))
+            dequeuedCount++;
+    }
+    gateMutex.unlock();
+    QVERIFY(pool.waitForDone());
+
+    QCOMPARE(dequeuedCount, 50);
+    QCOMPARE(executedCount.load(), 50);
+    qDeleteAll(tasks);
+}
+
+// Pools in shared mode together never run more runnables at once than shared scheduler has workers,
+// while each pool still honours its own limit and priority order
+void BenchmarkWorkerPool::sharedAcrossPools()
+{
+    const auto idealThreadCount = QThread::idealThreadCount();
+    WorkerPool firstPool(WorkerPool::Order::Priority, idealThreadCount, WorkerPool::Scheduler::SharedWorkStealing);
+    WorkerPool secondPool(WorkerPool::Order::FIFO, idealThreadCount, WorkerPool::Scheduler::SharedWorkStealing);
+    std::atomic<int> runningCount(0);
+    std::atomic<int> maxRunningCount(0);
+    std::atomic<int> executedCount(0);
+
+    const auto createTask =
+        [&runningCount, &maxRunningCount, &executedCount]
+        () -> QRunnable*
+        {
+            return new QRunnableFunctor(
+                [&runningCount, &maxRunningCount, &executedCount]
+                (const QRunnableFunctor* const runnable)
+                {
+                    const auto running = runningCount.fetch_add(1) + 1;
+                    auto maxRunning = maxRunningCount.load();
+                    while (running > maxRunning && !maxRunningCount.compare_exchange_weak(maxRunning, running));
+
+                    QThread::usleep(100);
+
+                    runningCount.fetch_sub(1);
+                    executedCount.fetch_add(1);
+                });
+        };
+
+    QElapsedTimer timer;
+    timer.start();
+    for (auto taskIndex = 0; taskIndex < 1000; taskIndex++)
+    {
+        firstPool.enqueue(createTask());
+        secondPool.enqueue(createTask());
+    }
+    QVERIFY(firstPool.waitForDone());
+    QVERIFY(secondPool.waitForDone());
+
+    QCOMPARE(executedCount.load(), 2000);
+    QVERIFY(maxRunningCount.load() <= idealThreadCount);
+    qDebug("2 pools: at most %d of %d runnables at once, %lld ms",
+        maxRunningCount.load(),
+        idealThreadCount,
+        static_cast<long long>(timer.elapsed()));
+}
+
+QTEST_MAIN(BenchmarkWorkerPool)
+#include "BenchmarkWorkerPool.moc"
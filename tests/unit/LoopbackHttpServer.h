@@ -0,0 +1,212 @@
+#ifndef _OSMAND_CORE_TESTS_LOOPBACK_HTTP_SERVER_H_
+#define _OSMAND_CORE_TESTS_LOOPBACK_HTTP_SERVER_H_
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QByteArray>
+#include <QString>
+
+// HTTP/1.1 server on loopback interface that runs on own thread and records how it's used:
+// - "/hang" is never answered
+// - "/status/<code>" is answered with given status code
+// - any other path is answered with body that starts with path, padded to payload size, or with response body if set
+// Responses are delayed to emulate network latency. Connections are kept alive and pipelined requests are
+// answered in order.
+class LoopbackHttpServer : public QThread
+{
+public:
+    LoopbackHttpServer(const int responseDelayMs_ = 0, const int payloadSize_ = 0)
+        : responseDelayMs(responseDelayMs_)
+        , payloadSize(payloadSize_)
+        , _port(0)
+        , _isListening(false)
+    {
+    }
+
+    virtual ~LoopbackHttpServer()
+    {
+        quit();
+        wait();
+    }
+
+    const int responseDelayMs;
+    const int payloadSize;
+
+    bool startListening()
+    {
+        start();
+
+        QMutexLocker scopedLocker(&_mutex);
+        while (!_isListening && isRunning())
+            _listeningCondition.wait(&_mutex, 100);
+        return _port != 0;
+    }
+
+    QString getBaseUrl() const
+    {
+        return QString(QLatin1String("http://127.0.0.1:%1")).arg(_port);
+    }
+
+    void setResponseBody(const QByteArray& responseBody)
+    {
+        QMutexLocker scopedLocker(&_mutex);
+        _responseBody = responseBody;
+    }
+
+    void resetCounters()
+    {
+        _connectionsCount.storeRelease(0);
+        _requestsCount.storeRelease(0);
+        _maxRequestsInProgressCount.storeRelease(_requestsInProgressCount.loadAcquire());
+    }
+
+    int getConnectionsCount() const
+    {
+        return _connectionsCount.loadAcquire();
+    }
+
+    int getRequestsCount() const
+    {
+        return _requestsCount.loadAcquire();
+    }
+
+    int getMaxRequestsInProgressCount() const
+    {
+        return _maxRequestsInProgressCount.loadAcquire();
+    }
+
+    static QByteArray getExpectedBody(const QByteArray& path, const int payloadSize)
+    {
+        auto body = path;
+        if (body.size() < payloadSize)
+            body.append(QByteArray(payloadSize - body.size(), '.'));
+        return body;
+    }
+
+protected:
+    virtual void run()
+    {
+        QTcpServer server;
+        server.listen(QHostAddress::LocalHost, 0);
+        QObject::connect(&server, &QTcpServer::newConnection,
+            [this, &server]
+            ()
+            {
+                while (const auto socket = server.nextPendingConnection())
+                {
+                    _connectionsCount.fetchAndAddOrdered(1);
+                    QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+                    QObject::connect(socket, &QTcpSocket::readyRead,
+                        [this, socket]
+                        ()
+                        {
+                            onReadyRead(socket);
+                        });
+                }
+            });
+
+        {
+            QMutexLocker scopedLocker(&_mutex);
+            _port = server.isListening() ? server.serverPort() : 0;
+            _isListening = true;
+            _listeningCondition.wakeAll();
+        }
+
+        exec();
+    }
+
+private:
+    mutable QMutex _mutex;
+    QWaitCondition _listeningCondition;
+    quint16 _port;
+    bool _isListening;
+    QByteArray _responseBody;
+
+    QAtomicInt _connectionsCount;
+    QAtomicInt _requestsCount;
+    QAtomicInt _requestsInProgressCount;
+    QAtomicInt _maxRequestsInProgressCount;
+
+    void onReadyRead(QTcpSocket* const socket)
+    {
+        auto buffer = socket->property("buffer").toByteArray();
+        buffer.append(socket->readAll());
+
+        for (;;)
+        {
+            const auto headersEnd = buffer.indexOf("\r\n\r\n");
+            if (headersEnd < 0)
+                break;
+            const auto requestLine = buffer.left(buffer.indexOf("\r\n"));
+            buffer.remove(0, headersEnd + 4);
+
+            const auto requestLineParts = requestLine.split(' ');
+            if (requestLineParts.size() < 2)
+            {
+                socket->disconnectFromHost();
+                return;
+            }
+            onRequest(socket, requestLineParts[0], requestLineParts[1]);
+        }
+
+        socket->setProperty("buffer", buffer);
+    }
+
+    void onRequest(QTcpSocket* const socket, const QByteArray& method, const QByteArray& path)
+    {
+        _requestsCount.fetchAndAddOrdered(1);
+        if (path == "/hang")
+            return;
+
+        const auto requestsInProgressCount = _requestsInProgressCount.fetchAndAddOrdered(1) + 1;
+        for (;;)
+        {
+            const auto maxRequestsInProgressCount = _maxRequestsInProgressCount.loadAcquire();
+            if (requestsInProgressCount <= maxRequestsInProgressCount ||
+                _maxRequestsInProgressCount.testAndSetOrdered(maxRequestsInProgressCount, requestsInProgressCount))
+            {
+                break;
+            }
+        }
+
+        QByteArray response;
+        if (path.startsWith("/status/"))
+        {
+            const auto body = path;
+            response.append("HTTP/1.1 " + path.mid(8) + " Status\r\n");
+            response.append("Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n");
+            if (method != "HEAD")
+                response.append(body);
+        }
+        else
+        {
+            QByteArray body;
+            {
+                QMutexLocker scopedLocker(&_mutex);
+                body = _responseBody;
+            }
+            if (body.isEmpty())
+                body = getExpectedBody(path, payloadSize);
+            response.append("HTTP/1.1 200 OK\r\n");
+            response.append("Content-Type: application/octet-stream\r\n");
+            response.append("Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n");
+            if (method != "HEAD")
+                response.append(body);
+        }
+
+        QTimer::singleShot(responseDelayMs, socket,
+            [this, socket, response]
+            ()
+            {
+                _requestsInProgressCount.fetchAndAddOrdered(-1);
+                socket->write(response);
+            });
+    }
+};
+
+#endif // !defined(_OSMAND_CORE_TESTS_LOOPBACK_HTTP_SERVER_H_)
@@ -0,0 +1,266 @@
+#ifndef _OSMAND_CORE_TESTS_SYNTHETIC_ROUTING_OBF_H_
+#define _OSMAND_CORE_TESTS_SYNTHETIC_ROUTING_OBF_H_
+
+#include <limits>
+
+#include <OsmAndCore/CommonTypes.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <QtEndian>
+
+// Writes OBF file with single routing section that contains given roads, encoded the same way as map creator does:
+// all roads are stored in one data block of one root box. Coordinates are stored with precision of 16 units of
+// 31 zoom, so points of roads should be multiples of 16.
+class SyntheticRoutingObf
+{
+public:
+    typedef QPair<QString, QString> TagValue;
+
+    struct Road
+    {
+        uint64_t id;
+        QVector<OsmAnd::PointI> points31;
+        QList<TagValue> tags;
+        QHash< int, QList<TagValue> > pointsTags;
+        // Types of restrictions (values of RoadRestriction) by id of destination road
+        QHash<uint64_t, int> restrictions;
+    };
+
+    enum : int {
+        Version = 2,
+        ShiftCoordinates = 4,
+    };
+
+    QList<Road> roads;
+
+    bool write(const QString& filePath) const
+    {
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return false;
+        const auto data = encode();
+        return file.write(data) == data.size();
+    }
+
+    QByteArray encode() const
+    {
+        QList<TagValue> rules;
+        for (const auto& road : roads)
+        {
+            for (const auto& tagValue : road.tags)
+            {
+                if (!rules.contains(tagValue))
+                    rules.push_back(tagValue);
+            }
+            for (const auto& pointTags : road.pointsTags)
+            {
+                for (const auto& tagValue : pointTags)
+                {
+                    if (!rules.contains(tagValue))
+                        rules.push_back(tagValue);
+                }
+            }
+        }
+
+        auto left = std::numeric_limits<int32_t>::max();
+        auto top = std::numeric_limits<int32_t>::max();
+        auto right = 0;
+        auto bottom = 0;
+        for (const auto& road : roads)
+        {
+            for (const auto& point31 : road.points31)
+            {
+                left = qMin(left, point31.x);
+                top = qMin(top, point31.y);
+                right = qMax(right, point31.x);
+                bottom = qMax(bottom, point31.y);
+            }
+        }
+        left &= ~((1 << ShiftCoordinates) - 1);
+        top &= ~((1 << ShiftCoordinates) - 1);
+
+        // Section: name, encoding rules, root box and data block right after it
+        QByteArray section;
+        writeLengthDelimited(section, 1, QString(QLatin1String("Synthetic")).toUtf8());
+        for (auto ruleIndex = 0; ruleIndex < rules.size(); ruleIndex++)
+        {
+            QByteArray rule;
+            writeLengthDelimited(rule, 3, rules[ruleIndex].first.toUtf8());
+            writeLengthDelimited(rule, 5, rules[ruleIndex].second.toUtf8());
+            writeTag(rule, 7, WireVarint);
+            writeVarint(rule, getRuleId(ruleIndex));
+            writeLengthDelimited(section, 2, rule);
+        }
+
+        QByteArray box;
+        writeTag(box, 1, WireVarint);
+        writeSInt(box, left);
+        writeTag(box, 2, WireVarint);
+        writeSInt(box, right);
+        writeTag(box, 3, WireVarint);
+        writeSInt(box, top);
+        writeTag(box, 4, WireVarint);
+        writeSInt(box, bottom);
+        // Offset to length of data block, counted from start of box, that's followed by tag of data block
+        writeTag(box, 5, WireFixed32);
+        writeBigEndianInt(box, box.size() + 4 + 1);
+        writeFixed32LengthDelimited(section, 3, box);
+
+        QByteArray idsTable;
+        QByteArray block;
+        uint64_t previousId = 0;
+        for (auto roadIndex = 0; roadIndex < roads.size(); roadIndex++)
+        {
+            const auto& road = roads[roadIndex];
+
+            writeTag(idsTable, 1, WireVarint);
+            writeSInt(idsTable, static_cast<int64_t>(road.id - previousId));
+            previousId = road.id;
+
+            QByteArray points;
+            auto previousX = left >> ShiftCoordinates;
+            auto previousY = top >> ShiftCoordinates;
+            for (const auto& point31 : road.points31)
+            {
+                const auto x = point31.x >> ShiftCoordinates;
+                const auto y = point31.y >> ShiftCoordinates;
+                writeSInt(points, x - previousX);
+                writeSInt(points, y - previousY);
+                previousX = x;
+                previousY = y;
+            }
+
+            QByteArray pointsTypes;
+            for (auto pointIndex = 0; pointIndex < road.points31.size(); pointIndex++)
+            {
+                const auto citPointTags = road.pointsTags.constFind(pointIndex);
+                if (citPointTags == road.pointsTags.cend())
+                    continue;
+
+                QByteArray pointTypes;
+                for (const auto& tagValue : *citPointTags)
+                    writeVarint(pointTypes, getRuleId(rules.indexOf(tagValue)));
+                writeVarint(pointsTypes, pointIndex);
+                writeVarint(pointsTypes, pointTypes.size());
+                pointsTypes.append(pointTypes);
+            }
+
+            QByteArray types;
+            for (const auto& tagValue : road.tags)
+                writeVarint(types, getRuleId(rules.indexOf(tagValue)));
+
+            QByteArray routeData;
+            writeLengthDelimited(routeData, 1, points);
+            if (!pointsTypes.isEmpty())
+                writeLengthDelimited(routeData, 4, pointsTypes);
+            writeLengthDelimited(routeData, 7, types);
+            writeTag(routeData, 12, WireVarint);
+            writeVarint(routeData, roadIndex);
+
+            writeLengthDelimited(block, 6, routeData);
+        }
+        // Restrictions follow roads and refer to them by index in data block
+        for (auto roadIndex = 0; roadIndex < roads.size(); roadIndex++)
+        {
+            const auto& road = roads[roadIndex];
+            for (auto citRestriction = road.restrictions.cbegin(); citRestriction != road.restrictions.cend(); ++citRestriction)
+            {
+                auto destinationRoadIndex = 0;
+                while (destinationRoadIndex < roads.size() && roads[destinationRoadIndex].id != citRestriction.key())
+                    destinationRoadIndex++;
+                if (destinationRoadIndex == roads.size())
+                    continue;
+
+                QByteArray restriction;
+                writeTag(restriction, 1, WireVarint);
+                writeVarint(restriction, citRestriction.value());
+                writeTag(restriction, 2, WireVarint);
+                writeVarint(restriction, roadIndex);
+                writeTag(restriction, 3, WireVarint);
+                writeVarint(restriction, destinationRoadIndex);
+                writeLengthDelimited(block, 7, restriction);
+            }
+        }
+        block.prepend(lengthDelimited(5, idsTable));
+        writeLengthDelimited(section, 5, block);
+
+        // File: version, routing section and confirmation of version
+        QByteArray file;
+        writeTag(file, 1, WireVarint);
+        writeVarint(file, Version);
+        writeFixed32LengthDelimited(file, 9, section);
+        writeTag(file, 32, WireVarint);
+        writeVarint(file, Version);
+        return file;
+    }
+
+private:
+    enum : int {
+        WireVarint = 0,
+        WireLengthDelimited = 2,
+        WireFixed32 = 5,
+        // Length is stored as big-endian 32-bit value
+        WireFixed32LengthDelimited = 6,
+    };
+
+    static uint32_t getRuleId(const int ruleIndex)
+    {
+        return static_cast<uint32_t>(ruleIndex + 1);
+    }
+
+    static void writeVarint(QByteArray& output, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            output.append(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        output.append(static_cast<char>(value));
+    }
+
+    static void writeSInt(QByteArray& output, const int64_t value)
+    {
+        writeVarint(output, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    static void writeTag(QByteArray& output, const int field, const int wireType)
+    {
+        writeVarint(output, (static_cast<uint32_t>(field) << 3) | wireType);
+    }
+
+    static void writeBigEndianInt(QByteArray& output, const uint32_t value)
+    {
+        uchar bytes[4];
+        qToBigEndian(value, bytes);
+        output.append(reinterpret_cast<const char*>(bytes), 4);
+    }
+
+    static QByteArray lengthDelimited(const int field, const QByteArray& data)
+    {
+        QByteArray output;
+        writeLengthDelimited(output, field, data);
+        return output;
+    }
+
+    static void writeLengthDelimited(QByteArray& output, const int field, const QByteArray& data)
+    {
+        writeTag(output, field, WireLengthDelimited);
+        writeVarint(output, data.size());
+        output.append(data);
+    }
+
+    static void writeFixed32LengthDelimited(QByteArray& output, const int field, const QByteArray& data)
+    {
+        writeTag(output, field, WireFixed32LengthDelimited);
+        writeBigEndianInt(output, data.size());
+        output.append(data);
+    }
+};
+
+#endif // !defined(_OSMAND_CORE_TESTS_SYNTHETIC_ROUTING_OBF_H_)
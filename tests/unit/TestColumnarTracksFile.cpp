@@ -0,0 +1,305 @@
+#include <OsmAndCore/GpxDocument.h>
+#include <OsmAndCore/ColumnarTracksFile.h>
+#include <OsmAndCore/Utilities.h>
+
+#include <cmath>
+#include <limits>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QTemporaryFile>
+
+using namespace OsmAnd;
+
+Q_DECLARE_METATYPE(OsmAnd::ColumnarTracksFile::Compression)
+
+class TestColumnarTracksFile : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const char* const Document;
+
+    static std::shared_ptr<GpxDocument> loadDocument();
+    static void compareTracks(
+        const std::shared_ptr<const GeoInfoDocument>& document,
+        const std::shared_ptr<const GeoInfoDocument>& expectedDocument);
+private slots:
+    void saveTo_data();
+    void saveTo();
+    void readSegment();
+    void convertGpx();
+    void corrupted();
+};
+
+const char* const TestColumnarTracksFile::Document =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<gpx version=\"1.1\" creator=\"TestColumnarTracksFile\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+    "  <wpt lat=\"10\" lon=\"20\"><name>Waypoint</name></wpt>\n"
+    "  <trk>\n"
+    "    <name>Track</name>\n"
+    "    <desc>Description</desc>\n"
+    "    <type>hiking</type>\n"
+    "    <trkseg>\n"
+    "      <trkpt lat=\"52.3712345\" lon=\"4.8901\"><ele>10.5</ele><time>2020-01-02T03:04:05Z</time></trkpt>\n"
+    "      <trkpt lat=\"52.38\" lon=\"4.89\"><time>2020-01-02T03:04:06.500Z</time></trkpt>\n"
+    "      <trkpt lat=\"52.39\" lon=\"4.88\"><ele>-12.25</ele></trkpt>\n"
+    "    </trkseg>\n"
+    "    <trkseg></trkseg>\n"
+    "    <trkseg><trkpt lat=\"-85.5\" lon=\"-179.5\"/><trkpt lat=\"85.5\" lon=\"179.5\"/></trkseg>\n"
+    "  </trk>\n"
+    "  <trk><name>Empty</name></trk>\n"
+    "  <trk><name>Second</name><trkseg><trkpt lat=\"0\" lon=\"0\"><ele>0</ele><time>1970-01-01T00:00:00Z</time></trkpt></trkseg></trk>\n"
+    "</gpx>\n";
+
+std::shared_ptr<GpxDocument> TestColumnarTracksFile::loadDocument()
+{
+    QByteArray data(Document);
+    QBuffer buffer(&data);
+    if (!buffer.open(QIODevice::ReadOnly))
+        return nullptr;
+    return GpxDocument::loadFrom(buffer);
+}
+
+// Coordinates are stored as 31-bit ones, so they match within few centimeters
+void TestColumnarTracksFile::compareTracks(
+    const std::shared_ptr<const GeoInfoDocument>& document,
+    const std::shared_ptr<const GeoInfoDocument>& expectedDocument)
+{
+    QCOMPARE(document->tracks.size(), expectedDocument->tracks.size());
+    for (auto trackIdx = 0; trackIdx < expectedDocument->tracks.size(); trackIdx++)
+    {
+        const auto& expectedTrack = expectedDocument->tracks[trackIdx];
+        const auto& track = document->tracks[trackIdx];
+        QCOMPARE(track->name, expectedTrack->name);
+        QCOMPARE(track->description, expectedTrack->description);
+        QCOMPARE(track->type, expectedTrack->type);
+        QCOMPARE(track->segments.size(), expectedTrack->segments.size());
+        for (auto segmentIdx = 0; segmentIdx < expectedTrack->segments.size(); segmentIdx++)
+        {
+            const auto& expectedPoints = expectedTrack->segments[segmentIdx]->points;
+            const auto& points = track->segments[segmentIdx]->points;
+            QCOMPARE(points.size(), expectedPoints.size());
+            for (auto pointIdx = 0; pointIdx < expectedPoints.size(); pointIdx++)
+            {
+                const auto& point = points[pointIdx];
+                const auto& expectedPoint = expectedPoints[pointIdx];
+                QVERIFY(qAbs(point->position.latitude - expectedPoint->position.latitude) < 1e-6);
+                QVERIFY(qAbs(point->position.longitude - expectedPoint->position.longitude) < 1e-6);
+                QCOMPARE(std::isnan(point->elevation), std::isnan(expectedPoint->elevation));
+                if (!std::isnan(expectedPoint->elevation))
+                    QVERIFY(qAbs(point->elevation - expectedPoint->elevation) < 0.01);
+                QCOMPARE(point->timestamp, expectedPoint->timestamp);
+            }
+        }
+    }
+}
+
+void TestColumnarTracksFile::saveTo_data()
+{
+    QTest::addColumn<ColumnarTracksFile::Compression>("compression");
+
+    QTest::newRow("none") << ColumnarTracksFile::Compression::None;
+    QTest::newRow("zlib") << ColumnarTracksFile::Compression::Zlib;
+}
+
+void TestColumnarTracksFile::saveTo()
+{
+    QFETCH(ColumnarTracksFile::Compression, compression);
+
+    const auto document = loadDocument();
+    QVERIFY(document);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.close();
+    QVERIFY(ColumnarTracksFile::saveTo(file.fileName(), document, compression));
+
+    ColumnarTracksFile tracksFile(file.fileName());
+    QVERIFY(tracksFile.open());
+    QVERIFY(tracksFile.isOpened());
+
+    const auto tracks = tracksFile.getTracks();
+    QCOMPARE(tracks.size(), 3);
+    QCOMPARE(tracks[0].segmentsCount, 3u);
+    QCOMPARE(tracks[1].segmentsCount, 0u);
+    QCOMPARE(tracks[2].firstSegmentIndex, 3u);
+    QCOMPARE(tracksFile.getSegments().size(), 4);
+
+    const auto restoredDocument = tracksFile.toGpxDocument();
+    QVERIFY(restoredDocument);
+    QVERIFY(restoredDocument->locationMarks.isEmpty());
+    compareTracks(restoredDocument, document);
+
+    tracksFile.close();
+    QVERIFY(!tracksFile.isOpened());
+}
+
+void TestColumnarTracksFile::readSegment()
+{
+    const auto document = loadDocument();
+    QVERIFY(document);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.close();
+    QVERIFY(ColumnarTracksFile::saveTo(file.fileName(), document));
+
+    ColumnarTracksFile tracksFile(file.fileName());
+    QVERIFY(tracksFile.open());
+
+    const auto segments = tracksFile.getSegments();
+    QCOMPARE(segments[0].pointsCount, 3u);
+    QVERIFY(segments[0].hasTimestamps);
+    QVERIFY(segments[0].hasElevations);
+    QCOMPARE(segments[1].pointsCount, 0u);
+    QVERIFY(!segments[2].hasTimestamps);
+    QVERIFY(!segments[2].hasElevations);
+
+    // Segment bounding box is known without decoding the segment
+    const auto topLeft31 = Utilities::convertLatLonTo31(LatLon(85.5, -179.5));
+    const auto bottomRight31 = Utilities::convertLatLonTo31(LatLon(-85.5, 179.5));
+    QCOMPARE(segments[2].bbox31.topLeft, topLeft31);
+    QCOMPARE(segments[2].bbox31.bottomRight, bottomRight31);
+
+    QVector<PointI> points31;
+    QVector<int64_t> timestamps;
+    QVector<double> elevations;
+    QVERIFY(tracksFile.readSegment(0, &points31, &timestamps, &elevations));
+    QCOMPARE(points31.size(), 3);
+    QCOMPARE(points31[0], Utilities::convertLatLonTo31(LatLon(52.3712345, 4.8901)));
+    const auto expectedTimestamp = QDateTime(QDate(2020, 1, 2), QTime(3, 4, 5), Qt::UTC).toMSecsSinceEpoch();
+    QCOMPARE(timestamps[0], static_cast<int64_t>(expectedTimestamp));
+    QCOMPARE(timestamps[1], static_cast<int64_t>(expectedTimestamp + 1500));
+    QCOMPARE(timestamps[2], static_cast<int64_t>(ColumnarTracksFile::NoTimestamp));
+    QCOMPARE(elevations[0], 10.5);
+    QVERIFY(std::isnan(elevations[1]));
+    QCOMPARE(elevations[2], -12.25);
+
+    QVERIFY(tracksFile.readSegment(1, &points31));
+    QVERIFY(points31.isEmpty());
+
+    QVERIFY(tracksFile.readSegment(3, &points31, &timestamps, &elevations));
+    QCOMPARE(points31.size(), 1);
+    QCOMPARE(timestamps[0], static_cast<int64_t>(0));
+    QCOMPARE(elevations[0], 0.0);
+
+    QVERIFY(!tracksFile.readSegment(4, &points31));
+}
+
+// Streamed conversion must produce same file content as conversion of loaded document
+void TestColumnarTracksFile::convertGpx()
+{
+    QTemporaryFile gpxFile;
+    QVERIFY(gpxFile.open());
+    QVERIFY(gpxFile.write(Document) > 0);
+    gpxFile.close();
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.close();
+    QVERIFY(ColumnarTracksFile::convertGpx(gpxFile.fileName(), file.fileName()));
+
+    QTemporaryFile expectedFile;
+    QVERIFY(expectedFile.open());
+    expectedFile.close();
+    const auto document = GpxDocument::loadFrom(gpxFile.fileName());
+    QVERIFY(document);
+    QVERIFY(ColumnarTracksFile::saveTo(expectedFile.fileName(), document));
+
+    QVERIFY(file.open());
+    QVERIFY(expectedFile.open());
+    QCOMPARE(file.readAll(), expectedFile.readAll());
+}
+
+void TestColumnarTracksFile::corrupted()
+{
+    const auto document = loadDocument();
+    QVERIFY(document);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.close();
+    QVERIFY(ColumnarTracksFile::saveTo(file.fileName(), document, ColumnarTracksFile::Compression::None));
+
+    QVERIFY(file.open());
+    const auto data = file.readAll();
+    file.close();
+
+    QList<QByteArray> corruptedFiles;
+    corruptedFiles.append(QByteArray());
+    corruptedFiles.append(data.left(16));
+    corruptedFiles.append(data.left(data.size() - 1));
+    corruptedFiles.append(QByteArray("OACX").append(data.mid(4)));
+
+    // Segments table offset that points past the end of file
+    auto badOffset = data;
+    for (auto byteIdx = 32; byteIdx < 40; byteIdx++)
+        badOffset[byteIdx] = '\xff';
+    corruptedFiles.append(badOffset);
+
+    // Points count of first segment that can't fit into its block
+    auto badPointsCount = data;
+    const auto segmentsTableOffset = qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(data.constData() + 32));
+    for (auto byteIdx = 4; byteIdx < 8; byteIdx++)
+        badPointsCount[static_cast<int>(segmentsTableOffset) + byteIdx] = '\xff';
+    corruptedFiles.append(badPointsCount);
+
+    for (const auto& corruptedData : constOf(corruptedFiles))
+    {
+        QTemporaryFile corruptedFile;
+        QVERIFY(corruptedFile.open());
+        QCOMPARE(corruptedFile.write(corruptedData), static_cast<qint64>(corruptedData.size()));
+        corruptedFile.close();
+
+        ColumnarTracksFile tracksFile(corruptedFile.fileName());
+        QVERIFY(!tracksFile.open());
+        QVERIFY(!tracksFile.isOpened());
+    }
+
+    ColumnarTracksFile missingFile(file.fileName() + QLatin1String(".missing"));
+    QVERIFY(!missingFile.open());
+
+    QTemporaryFile compressedFile;
+    QVERIFY(compressedFile.open());
+    compressedFile.close();
+    QVERIFY(ColumnarTracksFile::saveTo(compressedFile.fileName(), document, ColumnarTracksFile::Compression::Zlib));
+    QVERIFY(compressedFile.open());
+    const auto compressedData = compressedFile.readAll();
+    compressedFile.close();
+    const auto rawSizeOffset = static_cast<int>(
+        qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(compressedData.constData() + 32))) + 36;
+    const auto rawSize = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(compressedData.constData() + rawSizeOffset));
+
+    // Raw size of first segment that deflate can't produce from its block
+    auto hugeRawSize = compressedData;
+    qToLittleEndian<quint32>(std::numeric_limits<int>::max(), reinterpret_cast<uchar*>(hugeRawSize.data() + rawSizeOffset));
+    {
+        QTemporaryFile corruptedFile;
+        QVERIFY(corruptedFile.open());
+        QCOMPARE(corruptedFile.write(hugeRawSize), static_cast<qint64>(hugeRawSize.size()));
+        corruptedFile.close();
+
+        ColumnarTracksFile tracksFile(corruptedFile.fileName());
+        QVERIFY(!tracksFile.open());
+    }
+
+    // Raw size of first segment that is less than its block inflates to
+    auto smallRawSize = compressedData;
+    qToLittleEndian<quint32>(rawSize - 1, reinterpret_cast<uchar*>(smallRawSize.data() + rawSizeOffset));
+    {
+        QTemporaryFile corruptedFile;
+        QVERIFY(corruptedFile.open());
+        QCOMPARE(corruptedFile.write(smallRawSize), static_cast<qint64>(smallRawSize.size()));
+        corruptedFile.close();
+
+        ColumnarTracksFile tracksFile(corruptedFile.fileName());
+        QVERIFY(tracksFile.open());
+        QVector<PointI> points31;
+        QVERIFY(!tracksFile.readSegment(0, &points31));
+    }
+}
+
+QTEST_MAIN(TestColumnarTracksFile)
+#include "TestColumnarTracksFile.moc"
@@ -0,0 +1,216 @@
+#include <OsmAndCore/GpxDocument.h>
+#include <OsmAndCore/GpxStreamReader.h>
+
+#include <cmath>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QBuffer>
+
+using namespace OsmAnd;
+
+class TestGpxStreamReader : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const char* const Document;
+private slots:
+    void read_data();
+    void read();
+    void stop();
+    void malformed();
+    void loadTracksFrom();
+};
+
+const char* const TestGpxStreamReader::Document =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<gpx version=\"1.1\" creator=\"OsmAnd &amp; co\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+    "  <metadata><name>Metadata</name></metadata>\n"
+    "  <wpt lat=\"10\" lon=\"20\"><name>Waypoint</name></wpt>\n"
+    "  <trk>\n"
+    "    <name>Track &lt;1&gt;</name>\n"
+    "    <type><![CDATA[hiking]]></type>\n"
+    "    <trkseg>\n"
+    "      <trkpt lat=\"52.3712345\" lon=\"4.8901\"><ele>10.5</ele><time>2020-01-02T03:04:05Z</time></trkpt>\n"
+    "      <!-- comment with <trkpt> inside -->\n"
+    "      <trkpt lat='52.38' lon='4.89'><time>2020-01-02T05:04:06.500+02:00</time></trkpt>\n"
+    "      <trkpt lat=\"52.39\" lon=\"4.88\"/>\n"
+    "    </trkseg>\n"
+    "    <trkseg></trkseg>\n"
+    "    <trkseg><trkpt lat=\"-1.5\" lon=\"-2.5\"><ele>-3</ele><extensions><speed>1</speed></extensions></trkpt></trkseg>\n"
+    "  </trk>\n"
+    "  <trk><name>Second</name></trk>\n"
+    "</gpx>\n";
+
+void TestGpxStreamReader::read_data()
+{
+    QTest::addColumn<int>("batchSize");
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("defaults") << static_cast<int>(GpxStreamReader::DefaultBatchSize) << static_cast<int>(GpxStreamReader::DefaultChunkSize);
+    QTest::newRow("single point batches") << 1 << static_cast<int>(GpxStreamReader::DefaultChunkSize);
+    QTest::newRow("single byte chunks") << static_cast<int>(GpxStreamReader::DefaultBatchSize) << 1;
+    QTest::newRow("small batches and chunks") << 2 << 7;
+}
+
+// Result must not depend on where batches and chunks end
+void TestGpxStreamReader::read()
+{
+    QFETCH(int, batchSize);
+    QFETCH(int, chunkSize);
+
+    QByteArray data(Document);
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QList<QList<PointD>> segments;
+    QVector<double> elevations;
+    QVector<int64_t> timestamps;
+    QList<GpxStreamReader::TrackInfo> tracks;
+    GpxStreamReader reader(batchSize, chunkSize);
+    QList<PointD> segment;
+    const auto ok = reader.read(buffer,
+        [&segments, &segment, &elevations, &timestamps]
+        (const GpxStreamReader::TrackPointsBatch& batch) -> bool
+        {
+            for (auto pointIdx = 0u; pointIdx < batch.size(); pointIdx++)
+            {
+                segment.push_back(PointD(batch.latitudes[pointIdx], batch.longitudes[pointIdx]));
+                elevations.push_back(batch.elevations[pointIdx]);
+                timestamps.push_back(batch.timestamps[pointIdx]);
+            }
+            if (batch.isLastInSegment)
+            {
+                segments.push_back(segment);
+                segment.clear();
+            }
+            return true;
+        },
+        [&tracks]
+        (const GpxStreamReader::TrackInfo& track) -> bool
+        {
+            tracks.push_back(track);
+            return true;
+        });
+    QVERIFY(ok);
+
+    QCOMPARE(reader.getVersion(), QString("1.1"));
+    QCOMPARE(reader.getCreator(), QString("OsmAnd & co"));
+    QVERIFY(reader.hasSkippedContent());
+    QCOMPARE(reader.getBytesRead(), static_cast<uint64_t>(data.size()));
+
+    QCOMPARE(tracks.size(), 2);
+    QCOMPARE(tracks[0].name, QString("Track <1>"));
+    QCOMPARE(tracks[0].type, QString("hiking"));
+    QCOMPARE(tracks[0].segmentsCount, 3);
+    QCOMPARE(tracks[0].pointsCount, 4u);
+    QCOMPARE(tracks[1].name, QString("Second"));
+    QCOMPARE(tracks[1].segmentsCount, 0);
+
+    QCOMPARE(segments.size(), 3);
+    QCOMPARE(segments[0].size(), 3);
+    QCOMPARE(segments[1].size(), 0);
+    QCOMPARE(segments[2].size(), 1);
+    QCOMPARE(segments[0][0], PointD(52.3712345, 4.8901));
+    QCOMPARE(segments[0][1], PointD(52.38, 4.89));
+    QCOMPARE(segments[2][0], PointD(-1.5, -2.5));
+
+    QCOMPARE(elevations[0], 10.5);
+    QVERIFY(std::isnan(elevations[1]));
+    QVERIFY(std::isnan(elevations[2]));
+    QCOMPARE(elevations[3], -3.0);
+
+    const auto expectedTimestamp = QDateTime(QDate(2020, 1, 2), QTime(3, 4, 5), Qt::UTC).toMSecsSinceEpoch();
+    QCOMPARE(timestamps[0], static_cast<int64_t>(expectedTimestamp));
+    QCOMPARE(timestamps[1], static_cast<int64_t>(expectedTimestamp + 1500));
+    QCOMPARE(timestamps[2], static_cast<int64_t>(GpxStreamReader::NoTimestamp));
+}
+
+void TestGpxStreamReader::stop()
+{
+    QByteArray data(Document);
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    auto batchesCount = 0;
+    GpxStreamReader reader(1);
+    QVERIFY(reader.read(buffer,
+        [&batchesCount]
+        (const GpxStreamReader::TrackPointsBatch& batch) -> bool
+        {
+            batchesCount++;
+            return false;
+        }));
+    QCOMPARE(batchesCount, 1);
+}
+
+void TestGpxStreamReader::malformed()
+{
+    const auto noop =
+        []
+        (const GpxStreamReader::TrackPointsBatch& batch) -> bool
+        {
+            return true;
+        };
+
+    GpxStreamReader reader;
+    for (const auto& document : QList<QByteArray>()
+        << "<kml></kml>"
+        << "<gpx><trk><trkseg><trkpt lat=\"1\" lon=\"2\">"
+        << "<gpx></gpx></gpx>"
+        << "<gpx><trk><trkseg><trkpt lat=\"1\" lon=\"2\"></trkseg></trk></gpx")
+    {
+        QByteArray data(document);
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QVERIFY(!reader.read(buffer, noop));
+    }
+}
+
+// Fast path must load same tracks as full parser does
+void TestGpxStreamReader::loadTracksFrom()
+{
+    QByteArray data(Document);
+    QBuffer buffer(&data);
+
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    const auto fullDocument = GpxDocument::loadFrom(buffer);
+    buffer.close();
+    QVERIFY(fullDocument);
+
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    const auto tracksDocument = GpxDocument::loadTracksFrom(buffer);
+    buffer.close();
+    QVERIFY(tracksDocument);
+
+    QCOMPARE(tracksDocument->version, fullDocument->version);
+    QCOMPARE(tracksDocument->creator, fullDocument->creator);
+    QVERIFY(tracksDocument->locationMarks.isEmpty());
+    QCOMPARE(tracksDocument->tracks.size(), fullDocument->tracks.size());
+    for (auto trackIdx = 0; trackIdx < fullDocument->tracks.size(); trackIdx++)
+    {
+        const auto& expectedTrack = fullDocument->tracks[trackIdx];
+        const auto& track = tracksDocument->tracks[trackIdx];
+        QCOMPARE(track->name, expectedTrack->name);
+        QCOMPARE(track->segments.size(), expectedTrack->segments.size());
+        for (auto segmentIdx = 0; segmentIdx < expectedTrack->segments.size(); segmentIdx++)
+        {
+            const auto& expectedPoints = expectedTrack->segments[segmentIdx]->points;
+            const auto& points = track->segments[segmentIdx]->points;
+            QCOMPARE(points.size(), expectedPoints.size());
+            for (auto pointIdx = 0; pointIdx < expectedPoints.size(); pointIdx++)
+            {
+                QCOMPARE(points[pointIdx]->position.latitude, expectedPoints[pointIdx]->position.latitude);
+                QCOMPARE(points[pointIdx]->position.longitude, expectedPoints[pointIdx]->position.longitude);
+                QCOMPARE(std::isnan(points[pointIdx]->elevation), std::isnan(expectedPoints[pointIdx]->elevation));
+                if (!std::isnan(expectedPoints[pointIdx]->elevation))
+                    QCOMPARE(points[pointIdx]->elevation, expectedPoints[pointIdx]->elevation);
+                QCOMPARE(points[pointIdx]->timestamp, expectedPoints[pointIdx]->timestamp);
+            }
+        }
+    }
+}
+
+QTEST_MAIN(TestGpxStreamReader)
+#include "TestGpxStreamReader.moc"
@@ -0,0 +1,181 @@
+#include <OsmAndCore/Map/HeightmapTileCache.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+
+using namespace OsmAnd;
+
+class TestHeightmapTileCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        TileSize = 4,
+        StitchedSize = TileSize + 2,
+    };
+
+    // Elevation is unique function of global sample coordinates, so stitched border can be checked
+    static float getElevation(const int globalX, const int globalY);
+    static QVector<float> makeGrid(const TileId tileId);
+private slots:
+    void obtainTile();
+    void evictions();
+    void stitchedTile();
+    void stitchedTileWithMissingNeighbours();
+    void stitchedTileAcrossAntimeridian();
+};
+
+float TestHeightmapTileCache::getElevation(const int globalX, const int globalY)
+{
+    return static_cast<float>(globalX * 1000 + globalY);
+}
+
+QVector<float> TestHeightmapTileCache::makeGrid(const TileId tileId)
+{
+    QVector<float> grid;
+    for (auto row = 0; row < TileSize; row++)
+    {
+        for (auto col = 0; col < TileSize; col++)
+            grid.push_back(getElevation(tileId.x * TileSize + col, tileId.y * TileSize + row));
+    }
+    return grid;
+}
+
+void TestHeightmapTileCache::obtainTile()
+{
+    HeightmapTileCache cache;
+    const auto tileId = TileId::fromXY(10, 20);
+    QVector<float> grid;
+
+    QVERIFY(!cache.obtainTile(tileId, ZoomLevel10, grid));
+    cache.insertTile(tileId, ZoomLevel10, makeGrid(tileId));
+    QVERIFY(cache.obtainTile(tileId, ZoomLevel10, grid));
+    QCOMPARE(grid, makeGrid(tileId));
+
+    // Same tile id on other zoom is other tile
+    QVERIFY(!cache.obtainTile(tileId, ZoomLevel11, grid));
+
+    // Tile without data
+    cache.insertTile(tileId, ZoomLevel11, QVector<float>());
+    QVERIFY(cache.obtainTile(tileId, ZoomLevel11, grid));
+    QVERIFY(grid.isEmpty());
+
+    const auto statistics = cache.getStatistics();
+    QCOMPARE(statistics.hits, static_cast<uint64_t>(2));
+    QCOMPARE(statistics.misses, static_cast<uint64_t>(2));
+    QCOMPARE(statistics.entriesCount, 2u);
+}
+
+void TestHeightmapTileCache::evictions()
+{
+    HeightmapTileCache cache;
+    cache.insertTile(TileId::fromXY(0, 0), ZoomLevel10, makeGrid(TileId::fromXY(0, 0)));
+    const auto tileSizeInBytes = cache.getStatistics().sizeInBytes;
+
+    // Room for three tiles, least recently used ones are evicted
+    cache.setCapacityInBytes(tileSizeInBytes * 3);
+    for (auto x = 1; x < 5; x++)
+        cache.insertTile(TileId::fromXY(x, 0), ZoomLevel10, makeGrid(TileId::fromXY(x, 0)));
+
+    QVector<float> grid;
+    QVERIFY(!cache.obtainTile(TileId::fromXY(1, 0), ZoomLevel10, grid));
+    QVERIFY(cache.obtainTile(TileId::fromXY(2, 0), ZoomLevel10, grid));
+    auto statistics = cache.getStatistics();
+    QCOMPARE(statistics.evictions, static_cast<uint64_t>(2));
+    QCOMPARE(statistics.entriesCount, 3u);
+    QVERIFY(statistics.sizeInBytes <= statistics.capacityInBytes);
+
+    // Zero capacity disables cache
+    cache.setCapacityInBytes(0);
+    cache.insertTile(TileId::fromXY(0, 0), ZoomLevel10, makeGrid(TileId::fromXY(0, 0)));
+    QVERIFY(!cache.obtainTile(TileId::fromXY(0, 0), ZoomLevel10, grid));
+    statistics = cache.getStatistics();
+    QCOMPARE(statistics.evictions, static_cast<uint64_t>(5));
+    QCOMPARE(statistics.entriesCount, 0u);
+}
+
+void TestHeightmapTileCache::stitchedTile()
+{
+    HeightmapTileCache cache;
+    const auto tileId = TileId::fromXY(10, 20);
+    for (auto dy = -1; dy <= 1; dy++)
+    {
+        for (auto dx = -1; dx <= 1; dx++)
+        {
+            const auto neighbourTileId = TileId::fromXY(tileId.x + dx, tileId.y + dy);
+            cache.insertTile(neighbourTileId, ZoomLevel10, makeGrid(neighbourTileId));
+        }
+    }
+
+    QVector<float> grid;
+    unsigned int missingNeighboursCount = 0;
+    QVERIFY(cache.obtainStitchedTile(tileId, ZoomLevel10, TileSize, grid, &missingNeighboursCount));
+    QCOMPARE(missingNeighboursCount, 0u);
+    QCOMPARE(grid.size(), static_cast<int>(StitchedSize * StitchedSize));
+    for (auto row = 0; row < StitchedSize; row++)
+    {
+        for (auto col = 0; col < StitchedSize; col++)
+        {
+            const auto expected = getElevation(tileId.x * TileSize + col - 1, tileId.y * TileSize + row - 1);
+            QCOMPARE(grid[row * StitchedSize + col], expected);
+        }
+    }
+
+    // Tile that is not cached can not be stitched
+    QVERIFY(!cache.obtainStitchedTile(TileId::fromXY(0, 0), ZoomLevel10, TileSize, grid));
+
+    // Neighbours are not counted as lookups
+    const auto statistics = cache.getStatistics();
+    QCOMPARE(statistics.hits, static_cast<uint64_t>(0));
+    QCOMPARE(statistics.misses, static_cast<uint64_t>(0));
+    QCOMPARE(statistics.stitchedTiles, static_cast<uint64_t>(1));
+}
+
+void TestHeightmapTileCache::stitchedTileWithMissingNeighbours()
+{
+    HeightmapTileCache cache;
+    const auto tileId = TileId::fromXY(10, 20);
+    const auto eastTileId = TileId::fromXY(11, 20);
+    cache.insertTile(tileId, ZoomLevel10, makeGrid(tileId));
+    cache.insertTile(eastTileId, ZoomLevel10, makeGrid(eastTileId));
+    cache.insertTile(TileId::fromXY(9, 20), ZoomLevel10, QVector<float>());
+
+    QVector<float> grid;
+    unsigned int missingNeighboursCount = 0;
+    QVERIFY(cache.obtainStitchedTile(tileId, ZoomLevel10, TileSize, grid, &missingNeighboursCount));
+    QCOMPARE(missingNeighboursCount, 7u);
+    QCOMPARE(cache.getStatistics().missingNeighbours, static_cast<uint64_t>(7));
+
+    for (auto row = 0; row < StitchedSize; row++)
+    {
+        for (auto col = 0; col < StitchedSize; col++)
+        {
+            // East border is taken from neighbour, others repeat edge of tile
+            const auto clampedRow = qBound(0, row - 1, TileSize - 1);
+            const auto clampedCol = (col == StitchedSize - 1 && row > 0 && row < StitchedSize - 1)
+                ? TileSize
+                : qBound(0, col - 1, TileSize - 1);
+            const auto expected = getElevation(tileId.x * TileSize + clampedCol, tileId.y * TileSize + clampedRow);
+            QCOMPARE(grid[row * StitchedSize + col], expected);
+        }
+    }
+}
+
+void TestHeightmapTileCache::stitchedTileAcrossAntimeridian()
+{
+    HeightmapTileCache cache;
+    const auto tileId = TileId::fromXY(0, 0);
+    const auto westTileId = TileId::fromXY(3, 0);
+    cache.insertTile(tileId, ZoomLevel2, makeGrid(tileId));
+    cache.insertTile(westTileId, ZoomLevel2, makeGrid(westTileId));
+
+    QVector<float> grid;
+    unsigned int missingNeighboursCount = 0;
+    QVERIFY(cache.obtainStitchedTile(tileId, ZoomLevel2, TileSize, grid, &missingNeighboursCount));
+    QCOMPARE(missingNeighboursCount, 7u);
+    QCOMPARE(grid[1 * StitchedSize + 0], getElevation(westTileId.x * TileSize + TileSize - 1, 0));
+}
+
+QTEST_MAIN(TestHeightmapTileCache)
+#include "TestHeightmapTileCache.moc"
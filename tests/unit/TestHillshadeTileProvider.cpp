@@ -0,0 +1,309 @@
+#include <OsmAndCore/Utilities.h>
+#include <OsmAndCore/Map/HillshadeTileProvider.h>
+#include <OsmAndCore/Map/MapDataProviderHelpers.h>
+#include <SkBitmap.h>
+#include <SkColorPriv.h>
+
+#include <cmath>
+#include <functional>
+#include <random>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QtMath>
+
+using namespace OsmAnd;
+
+namespace
+{
+    // Synthetic DEM, elevation in meters is function of global sample coordinates
+    class SyntheticElevationProvider : public IMapElevationDataProvider
+    {
+    public:
+        typedef std::function<float(const int sampleX, const int sampleY)> ElevationFunction;
+
+        SyntheticElevationProvider(const unsigned int tileSize_, const ElevationFunction& elevation_)
+            : tileSize(tileSize_)
+            , elevation(elevation_)
+            , obtainedTilesCount(0)
+        {
+        }
+
+        const unsigned int tileSize;
+        const ElevationFunction elevation;
+        // Tiles in this row have no data
+        int emptyRow = -1;
+        int obtainedTilesCount;
+
+        virtual unsigned int getTileSize() const Q_DECL_OVERRIDE
+        {
+            return tileSize;
+        }
+
+        virtual ZoomLevel getMinZoom() const Q_DECL_OVERRIDE
+        {
+            return MinZoomLevel;
+        }
+
+        virtual ZoomLevel getMaxZoom() const Q_DECL_OVERRIDE
+        {
+            return MaxZoomLevel;
+        }
+
+        virtual bool supportsNaturalObtainData() const Q_DECL_OVERRIDE
+        {
+            return true;
+        }
+
+        virtual bool obtainData(
+            const IMapDataProvider::Request& request_,
+            std::shared_ptr<IMapDataProvider::Data>& outData,
+            std::shared_ptr<Metric>* const pOutMetric = nullptr) Q_DECL_OVERRIDE
+        {
+            const auto& request = MapDataProviderHelpers::castRequest<Request>(request_);
+            if (pOutMetric)
+                pOutMetric->reset();
+
+            obtainedTilesCount++;
+            if (request.tileId.y == emptyRow)
+            {
+                outData.reset();
+                return true;
+            }
+
+            const auto pRawData = new float[tileSize * tileSize];
+            for (auto row = 0u; row < tileSize; row++)
+            {
+                for (auto col = 0u; col < tileSize; col++)
+                {
+                    pRawData[row * tileSize + col] = elevation(
+                        request.tileId.x * tileSize + col,
+                        request.tileId.y * tileSize + row);
+                }
+            }
+            outData.reset(new Data(request.tileId, request.zoom, sizeof(float) * tileSize, tileSize, pRawData));
+            return true;
+        }
+
+        virtual bool supportsNaturalObtainDataAsync() const Q_DECL_OVERRIDE
+        {
+            return false;
+        }
+
+        virtual void obtainDataAsync(
+            const IMapDataProvider::Request& request,
+            const IMapDataProvider::ObtainDataAsyncCallback callback,
+            const bool collectMetric = false) Q_DECL_OVERRIDE
+        {
+            MapDataProviderHelpers::nonNaturalObtainDataAsync(this, request, callback, collectMetric);
+        }
+    };
+}
+
+class TestHillshadeTileProvider : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        ElevationTileSize = 16,
+        TileSize = 64,
+        TileX = 500,
+        TileY = 400,
+        Zoom = ZoomLevel10,
+    };
+
+    static double getMetersPerSample();
+    static uint8_t getExpectedShading(const double dzdx, const double dzdy, const HillshadeTileProvider::Mode mode);
+    static std::shared_ptr<const SkBitmap> obtainTile(HillshadeTileProvider& provider, const int tileY = TileY);
+    static void verifyTile(const SkBitmap& bitmap, const uint8_t expectedShading);
+private slots:
+    void flatTerrain();
+    void inclinedPlane_data();
+    void inclinedPlane();
+    void vectorizedKernel();
+    void tileWithoutData();
+    void cachedTile();
+};
+
+double TestHillshadeTileProvider::getMetersPerSample()
+{
+    return Utilities::getMetersPerTileUnit(Zoom, TileY + 0.5, ElevationTileSize);
+}
+
+// Independent of provider: cosine of angle between normal and light, computed via slope and aspect
+uint8_t TestHillshadeTileProvider::getExpectedShading(
+    const double dzdx,
+    const double dzdy,
+    const HillshadeTileProvider::Mode mode)
+{
+    const auto slope = std::atan(std::sqrt(dzdx * dzdx + dzdy * dzdy));
+    if (mode == HillshadeTileProvider::Mode::Slope)
+        return static_cast<uint8_t>(255.0 * std::cos(slope) + 0.5);
+
+    // Aspect is direction downhill, clockwise from north. Rows go to south, so dz/dNorth is -dzdy
+    const auto aspect = std::atan2(dzdx, -dzdy) + M_PI;
+    const auto zenith = qDegreesToRadians(90.0 - 45.0);
+    const auto azimuth = qDegreesToRadians(315.0);
+    const auto shade = std::cos(zenith) * std::cos(slope) + std::sin(zenith) * std::sin(slope) * std::cos(azimuth - aspect);
+    return static_cast<uint8_t>(qMax(0.0, shade) * 255.0 + 0.5);
+}
+
+std::shared_ptr<const SkBitmap> TestHillshadeTileProvider::obtainTile(HillshadeTileProvider& provider, const int tileY)
+{
+    HillshadeTileProvider::Request request;
+    request.tileId = TileId::fromXY(TileX, tileY);
+    request.zoom = static_cast<ZoomLevel>(Zoom);
+
+    std::shared_ptr<IMapDataProvider::Data> data;
+    if (!provider.obtainData(request, data) || !data)
+        return nullptr;
+    return std::static_pointer_cast<IRasterMapLayerProvider::Data>(data)->bitmap;
+}
+
+// All pixels, including ones near borders that are shaded using neighbour tiles
+void TestHillshadeTileProvider::verifyTile(const SkBitmap& bitmap, const uint8_t expectedShading)
+{
+    QCOMPARE(bitmap.width(), static_cast<int>(TileSize));
+    QCOMPARE(bitmap.height(), static_cast<int>(TileSize));
+    for (auto y = 0; y < TileSize; y++)
+    {
+        for (auto x = 0; x < TileSize; x++)
+        {
+            const auto alpha = static_cast<int>(SkGetPackedA32(*bitmap.getAddr32(x, y)));
+            if (qAbs(alpha - (255 - expectedShading)) > 1)
+            {
+                QFAIL(qPrintable(QString("Pixel %1x%2 has alpha %3 instead of %4")
+                    .arg(x)
+                    .arg(y)
+                    .arg(alpha)
+                    .arg(255 - expectedShading)));
+            }
+        }
+    }
+}
+
+void TestHillshadeTileProvider::flatTerrain()
+{
+    const auto elevationProvider = std::make_shared<SyntheticElevationProvider>(
+        ElevationTileSize,
+        [](const int, const int) { return 120.0f; });
+    HillshadeTileProvider provider(elevationProvider, HillshadeTileProvider::Mode::Hillshade, TileSize);
+
+    const auto bitmap = obtainTile(provider);
+    QVERIFY(bitmap);
+    // Light at 45 degrees above horizon
+    verifyTile(*bitmap, 180);
+}
+
+void TestHillshadeTileProvider::inclinedPlane_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<double>("dzdx");
+    QTest::addColumn<double>("dzdy");
+
+    const auto hillshade = static_cast<int>(HillshadeTileProvider::Mode::Hillshade);
+    const auto slope = static_cast<int>(HillshadeTileProvider::Mode::Slope);
+    QTest::newRow("rising to east") << hillshade << 0.5 << 0.0;
+    QTest::newRow("rising to west") << hillshade << -0.5 << 0.0;
+    QTest::newRow("rising to south") << hillshade << 0.0 << 0.5;
+    QTest::newRow("rising to north") << hillshade << 0.0 << -0.5;
+    QTest::newRow("facing light") << hillshade << 0.7 << 0.7;
+    QTest::newRow("in shadow") << hillshade << -3.0 << -3.0;
+    QTest::newRow("slope") << slope << 0.5 << -0.25;
+}
+
+void TestHillshadeTileProvider::inclinedPlane()
+{
+    QFETCH(int, mode);
+    QFETCH(double, dzdx);
+    QFETCH(double, dzdy);
+
+    // Plane is relative to tile, so that elevations stay small enough for float precision
+    const auto metersPerSample = getMetersPerSample();
+    const auto elevationProvider = std::make_shared<SyntheticElevationProvider>(
+        ElevationTileSize,
+        [metersPerSample, dzdx, dzdy](const int sampleX, const int sampleY)
+        {
+            return static_cast<float>(
+                ((sampleX - TileX * ElevationTileSize) * dzdx + (sampleY - TileY * ElevationTileSize) * dzdy) * metersPerSample);
+        });
+    const auto shadingMode = static_cast<HillshadeTileProvider::Mode>(mode);
+    HillshadeTileProvider provider(elevationProvider, shadingMode, TileSize);
+
+    const auto bitmap = obtainTile(provider);
+    QVERIFY(bitmap);
+    verifyTile(*bitmap, getExpectedShading(dzdx, dzdy, shadingMode));
+}
+
+// Vectorized and scalar kernels give same result, on rows with length that is not multiple of vector width
+void TestHillshadeTileProvider::vectorizedKernel()
+{
+    if (!HillshadeTileProvider::isVectorizedShadingSupported())
+        QSKIP("Vectorized shading is not supported on this platform");
+
+    const auto size = 67;
+    std::minstd_rand generator(7);
+    std::uniform_real_distribution<float> distribution(0.0f, 500.0f);
+    QVector<float> elevations((size + 2) * (size + 2));
+    for (auto& elevation : elevations)
+        elevation = distribution(generator);
+
+    for (const auto mode : { HillshadeTileProvider::Mode::Hillshade, HillshadeTileProvider::Mode::Slope })
+    {
+        QVector<uint8_t> scalarShading(size * size);
+        QVector<uint8_t> vectorizedShading(size * size);
+        HillshadeTileProvider::computeShading(elevations.constData(), size, 100.0f, mode, 315.0f, 45.0f, 1.0f, scalarShading.data(), false);
+        HillshadeTileProvider::computeShading(elevations.constData(), size, 100.0f, mode, 315.0f, 45.0f, 1.0f, vectorizedShading.data(), true);
+
+        for (auto idx = 0; idx < size * size; idx++)
+            QVERIFY(qAbs(static_cast<int>(scalarShading[idx]) - static_cast<int>(vectorizedShading[idx])) <= 1);
+    }
+}
+
+void TestHillshadeTileProvider::tileWithoutData()
+{
+    const auto elevationProvider = std::make_shared<SyntheticElevationProvider>(
+        ElevationTileSize,
+        [](const int, const int) { return 120.0f; });
+    elevationProvider->emptyRow = TileY;
+    HillshadeTileProvider provider(elevationProvider, HillshadeTileProvider::Mode::Hillshade, TileSize);
+
+    HillshadeTileProvider::Request request;
+    request.tileId = TileId::fromXY(TileX, TileY);
+    request.zoom = static_cast<ZoomLevel>(Zoom);
+    std::shared_ptr<IMapDataProvider::Data> data;
+    QVERIFY(provider.obtainData(request, data));
+    QVERIFY(!data);
+
+    // Row of tiles without data next to tile is stitched with its own edge, as flat terrain
+    const auto bitmap = obtainTile(provider, TileY + 1);
+    QVERIFY(bitmap);
+    verifyTile(*bitmap, 180);
+}
+
+void TestHillshadeTileProvider::cachedTile()
+{
+    const auto elevationProvider = std::make_shared<SyntheticElevationProvider>(
+        ElevationTileSize,
+        [](const int sampleX, const int) { return static_cast<float>(sampleX % 7); });
+    HillshadeTileProvider provider(elevationProvider, HillshadeTileProvider::Mode::Hillshade, TileSize);
+
+    const auto bitmap = obtainTile(provider);
+    QVERIFY(bitmap);
+    QCOMPARE(provider.getCachedTilesCount(), 1u);
+    QCOMPARE(elevationProvider->obtainedTilesCount, 9);
+    QCOMPARE(obtainTile(provider), bitmap);
+
+    // Elevations of neighbour are decoded once and reused for next tile
+    QVERIFY(obtainTile(provider, TileY + 1));
+    QCOMPARE(elevationProvider->obtainedTilesCount, 12);
+
+    provider.setCacheCapacityInBytes(0);
+    QCOMPARE(provider.getCachedTilesCount(), 0u);
+    QVERIFY(obtainTile(provider) != bitmap);
+    QCOMPARE(elevationProvider->obtainedTilesCount, 12);
+}
+
+QTEST_MAIN(TestHillshadeTileProvider)
+#include "TestHillshadeTileProvider.moc"
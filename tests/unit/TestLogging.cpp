@@ -0,0 +1,222 @@
+#include <OsmAndCore/Logging.h>
+#include <OsmAndCore/ILogSink.h>
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QSemaphore>
+
+using namespace OsmAnd;
+
+namespace
+{
+    // Records messages. Message "block" holds thread that writes it until gate is opened
+    class RecordingLogSink : public ILogSink
+    {
+    public:
+        RecordingLogSink()
+        {
+        }
+
+        mutable QMutex mutex;
+        QStringList messages;
+        QSemaphore blockEntered;
+        QSemaphore gate;
+
+        virtual void log(const LogSeverityLevel level, const char* format, va_list args) Q_DECL_OVERRIDE
+        {
+            Q_UNUSED(level);
+
+            char message[1024];
+            vsnprintf(message, sizeof(message), format, args);
+            {
+                QMutexLocker scopedLocker(&mutex);
+                messages.append(QString::fromLatin1(message));
+            }
+
+            if (qstrcmp(message, "block") == 0)
+            {
+                blockEntered.release();
+                gate.acquire();
+            }
+        }
+
+        virtual void flush() Q_DECL_OVERRIDE
+        {
+        }
+
+        QStringList getMessages() const
+        {
+            QMutexLocker scopedLocker(&mutex);
+            return messages;
+        }
+    };
+}
+
+class TestLogging : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        ThreadsCount = 4,
+        MessagesPerThreadCount = 400,
+    };
+
+    std::shared_ptr<RecordingLogSink> _sink;
+    LogSeverityLevel _previousThreshold;
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void asyncKeepsOrderOfEachThread();
+    void asyncDropsWhenQueueIsFull();
+    void asyncTruncatesLongMessages();
+    void switchToSynchronousWritesQueuedFirst();
+    void flushOnCrashWithStuckDrainer();
+};
+
+void TestLogging::initTestCase()
+{
+    _previousThreshold = Logger::get()->setSeverityLevelThreshold(LogSeverityLevel::Verbose);
+}
+
+void TestLogging::cleanupTestCase()
+{
+    Logger::get()->setSeverityLevelThreshold(_previousThreshold);
+}
+
+void TestLogging::init()
+{
+    _sink.reset(new RecordingLogSink());
+    Logger::get()->addLogSink(_sink);
+}
+
+void TestLogging::cleanup()
+{
+    Logger::get()->setAsynchronous(false);
+    Logger::get()->removeLogSink(_sink);
+    _sink.reset();
+}
+
+void TestLogging::asyncKeepsOrderOfEachThread()
+{
+    Logger::get()->setAsynchronous(true);
+    QVERIFY(Logger::get()->isAsynchronous());
+    const auto statisticsBefore = Logger::get()->getAsyncStatistics();
+
+    std::vector<std::thread> threads;
+    for (auto threadIndex = 0; threadIndex < ThreadsCount; threadIndex++)
+    {
+        threads.emplace_back(
+            [threadIndex]
+            ()
+            {
+                for (auto messageIndex = 0; messageIndex < MessagesPerThreadCount; messageIndex++)
+                    LogPrintf(LogSeverityLevel::Info, "%d %d", threadIndex, messageIndex);
+            });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    LogFlush();
+
+    const auto statistics = Logger::get()->getAsyncStatistics();
+    QCOMPARE(statistics.droppedCount, statisticsBefore.droppedCount);
+    QCOMPARE(statistics.enqueuedCount - statisticsBefore.enqueuedCount,
+        static_cast<uint64_t>(ThreadsCount * MessagesPerThreadCount));
+
+    const auto messages = _sink->getMessages();
+    QCOMPARE(messages.size(), static_cast<int>(ThreadsCount * MessagesPerThreadCount));
+    QVector<int> lastMessageIndices(ThreadsCount, -1);
+    for (const auto& message : messages)
+    {
+        const auto parts = message.split(QLatin1Char(' '));
+        QCOMPARE(parts.size(), 2);
+        const auto threadIndex = parts[0].toInt();
+        const auto messageIndex = parts[1].toInt();
+        QCOMPARE(messageIndex, lastMessageIndices[threadIndex] + 1);
+        lastMessageIndices[threadIndex] = messageIndex;
+    }
+}
+
+// While background thread is stuck in sink, queue is filled and overflowing messages are dropped without blocking
+void TestLogging::asyncDropsWhenQueueIsFull()
+{
+    Logger::get()->setAsynchronous(true);
+    const auto statisticsBefore = Logger::get()->getAsyncStatistics();
+
+    LogPrintf(LogSeverityLevel::Info, "block");
+    QVERIFY(_sink->blockEntered.tryAcquire(1, 5000));
+
+    const auto overflowCount = 100u;
+    for (auto messageIndex = 0u; messageIndex < Logger::AsyncQueueCapacity + overflowCount; messageIndex++)
+        LogPrintf(LogSeverityLevel::Info, "%u", messageIndex);
+
+    const auto statistics = Logger::get()->getAsyncStatistics();
+    QCOMPARE(statistics.droppedCount - statisticsBefore.droppedCount, static_cast<uint64_t>(overflowCount));
+
+    _sink->gate.release();
+    LogFlush();
+
+    const auto messages = _sink->getMessages();
+    QCOMPARE(messages.size(), static_cast<int>(1 + Logger::AsyncQueueCapacity));
+    QCOMPARE(messages.last(), QString::number(Logger::AsyncQueueCapacity - 1));
+}
+
+void TestLogging::asyncTruncatesLongMessages()
+{
+    Logger::get()->setAsynchronous(true);
+    const auto statisticsBefore = Logger::get()->getAsyncStatistics();
+
+    const QByteArray longMessage(1000, 'x');
+    LogPrintf(LogSeverityLevel::Info, "%s", longMessage.constData());
+    LogFlush();
+
+    const auto statistics = Logger::get()->getAsyncStatistics();
+    QCOMPARE(statistics.truncatedCount - statisticsBefore.truncatedCount, static_cast<uint64_t>(1));
+    const auto messages = _sink->getMessages();
+    QCOMPARE(messages.size(), 1);
+    QCOMPARE(messages.first().size(), static_cast<int>(Logger::AsyncMessageMaxLength));
+}
+
+void TestLogging::switchToSynchronousWritesQueuedFirst()
+{
+    Logger::get()->setAsynchronous(true);
+    for (auto messageIndex = 0; messageIndex < 10; messageIndex++)
+        LogPrintf(LogSeverityLevel::Info, "%d", messageIndex);
+    Logger::get()->setAsynchronous(false);
+    QVERIFY(!Logger::get()->isAsynchronous());
+    LogPrintf(LogSeverityLevel::Info, "%d", 10);
+
+    const auto messages = _sink->getMessages();
+    QCOMPARE(messages.size(), 11);
+    for (auto messageIndex = 0; messageIndex < messages.size(); messageIndex++)
+        QCOMPARE(messages[messageIndex], QString::number(messageIndex));
+}
+
+// Crash handler writes queued messages even if background thread never returns from sink
+void TestLogging::flushOnCrashWithStuckDrainer()
+{
+    Logger::get()->setAsynchronous(true);
+
+    LogPrintf(LogSeverityLevel::Info, "block");
+    QVERIFY(_sink->blockEntered.tryAcquire(1, 5000));
+    LogPrintf(LogSeverityLevel::Error, "crash 1");
+    LogPrintf(LogSeverityLevel::Error, "crash 2");
+
+    Logger::get()->flushOnCrash();
+    QCOMPARE(_sink->getMessages(), QStringList() << "block" << "crash 1" << "crash 2");
+
+    _sink->gate.release();
+    LogFlush();
+    QCOMPARE(_sink->getMessages().size(), 3);
+}
+
+QTEST_MAIN(TestLogging)
+#include "TestLogging.moc"
@@ -0,0 +1,159 @@
+#include <OsmAndCore/Utilities.h>
+#include <OsmAndCore/Map/MapMarker.h>
+#include <OsmAndCore/Map/MapMarkerBuilder.h>
+#include <OsmAndCore/Map/MapMarkersCollection.h>
+#include <OsmAndCore/Map/MapSymbolsGroup.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+
+using namespace OsmAnd;
+
+class TestMapMarkersClustering : public QObject
+{
+    Q_OBJECT
+
+private:
+    std::shared_ptr<MapMarker> addMarker(
+        const std::shared_ptr<MapMarkersCollection>& collection,
+        const PointI position31);
+    QVector<TileId> getTiles(const PointI position31, const ZoomLevel zoom);
+    IMapKeyedDataProvider::Key getKey(const std::shared_ptr<MapMarker>& marker);
+private slots:
+    void nearbyMarkersAreClustered();
+    void markersAreNotClusteredBeyondMaxClusteredZoom();
+    void clusterFollowsMovedMarker();
+    void clusterIsDissolvedOnRemove();
+    void disabledClusteringProvidesAllMarkers();
+};
+
+std::shared_ptr<MapMarker> TestMapMarkersClustering::addMarker(
+    const std::shared_ptr<MapMarkersCollection>& collection,
+    const PointI position31)
+{
+    MapMarkerBuilder builder;
+    builder.setPosition(position31);
+    return builder.buildAndAddToCollection(collection);
+}
+
+QVector<TileId> TestMapMarkersClustering::getTiles(const PointI position31, const ZoomLevel zoom)
+{
+    return QVector<TileId>() << TileId::fromXY(position31.x >> (ZoomLevel31 - zoom), position31.y >> (ZoomLevel31 - zoom));
+}
+
+IMapKeyedDataProvider::Key TestMapMarkersClustering::getKey(const std::shared_ptr<MapMarker>& marker)
+{
+    return reinterpret_cast<IMapKeyedDataProvider::Key>(marker.get());
+}
+
+void TestMapMarkersClustering::nearbyMarkersAreClustered()
+{
+    const std::shared_ptr<MapMarkersCollection> collection(new MapMarkersCollection());
+    collection->setClusteringEnabled(true, ZoomLevel16);
+
+    const auto origin = Utilities::convertLatLonTo31(LatLon(52.37, 4.89));
+    const auto first = addMarker(collection, origin);
+    const auto second = addMarker(collection, origin + PointI(100, 100));
+    const auto far = addMarker(collection, Utilities::convertLatLonTo31(LatLon(48.85, 2.35)));
+
+    const auto keys = collection->getProvidedDataKeysForTiles(getTiles(origin, ZoomLevel10), ZoomLevel10);
+    QCOMPARE(keys.size(), 1);
+    QVERIFY(!keys.contains(getKey(first)));
+    QVERIFY(!keys.contains(getKey(second)));
+    QVERIFY(!keys.contains(getKey(far)));
+
+    const auto farKeys = collection->getProvidedDataKeysForTiles(getTiles(far->getPosition(), ZoomLevel10), ZoomLevel10);
+    QCOMPARE(farKeys.size(), 1);
+    QVERIFY(farKeys.contains(getKey(far)));
+}
+
+void TestMapMarkersClustering::markersAreNotClusteredBeyondMaxClusteredZoom()
+{
+    const std::shared_ptr<MapMarkersCollection> collection(new MapMarkersCollection());
+    collection->setClusteringEnabled(true, ZoomLevel12);
+
+    const auto origin = Utilities::convertLatLonTo31(LatLon(52.37, 4.89));
+    const auto first = addMarker(collection, origin);
+    const auto second = addMarker(collection, origin + PointI(100, 100));
+
+    const auto keys = collection->getProvidedDataKeysForTiles(getTiles(origin, ZoomLevel17), ZoomLevel17);
+    QCOMPARE(keys.size(), 2);
+    QVERIFY(keys.contains(getKey(first)));
+    QVERIFY(keys.contains(getKey(second)));
+}
+
+void TestMapMarkersClustering::clusterFollowsMovedMarker()
+{
+    const std::shared_ptr<MapMarkersCollection> collection(new MapMarkersCollection());
+    collection->setClusteringEnabled(true, ZoomLevel16);
+
+    const auto origin = Utilities::convertLatLonTo31(LatLon(52.37, 4.89));
+    const auto first = addMarker(collection, origin);
+    const auto second = addMarker(collection, origin + PointI(100, 100));
+
+    PointI clusterPosition31;
+    collection->setClusterSymbolsGroupFactory(
+        [&clusterPosition31]
+        (const MapMarkersCollection::Cluster& cluster) -> std::shared_ptr<MapSymbolsGroup>
+        {
+            clusterPosition31 = cluster.position31;
+            return std::make_shared<MapSymbolsGroup>();
+        });
+
+    const auto clusteredKeys = collection->getProvidedDataKeysForTiles(getTiles(origin, ZoomLevel10), ZoomLevel10);
+    QCOMPARE(clusteredKeys.size(), 1);
+
+    // Moving within cell keeps markers clustered, but cluster is presented under new key at new mean position
+    second->setPosition(origin + PointI(200, 200));
+    const auto movedKeys = collection->getProvidedDataKeysForTiles(getTiles(origin, ZoomLevel10), ZoomLevel10);
+    QCOMPARE(movedKeys.size(), 1);
+    QVERIFY(movedKeys.first() != clusteredKeys.first());
+    QVERIFY(!movedKeys.contains(getKey(first)));
+    QVERIFY(!movedKeys.contains(getKey(second)));
+    IMapKeyedSymbolsProvider::Request request;
+    request.key = movedKeys.first();
+    std::shared_ptr<IMapKeyedSymbolsProvider::Data> data;
+    QVERIFY(collection->obtainKeyedSymbols(request, data));
+    QCOMPARE(clusterPosition31, origin + PointI(100, 100));
+
+    // Moving far away splits cluster
+    const auto farPosition = Utilities::convertLatLonTo31(LatLon(48.85, 2.35));
+    second->setPosition(farPosition);
+    const auto keys = collection->getProvidedDataKeysForTiles(getTiles(origin, ZoomLevel10), ZoomLevel10);
+    QCOMPARE(keys.size(), 1);
+    QVERIFY(keys.contains(getKey(first)));
+    const auto farKeys = collection->getProvidedDataKeysForTiles(getTiles(farPosition, ZoomLevel10), ZoomLevel10);
+    QCOMPARE(farKeys.size(), 1);
+    QVERIFY(farKeys.contains(getKey(second)));
+}
+
+void TestMapMarkersClustering::clusterIsDissolvedOnRemove()
+{
+    const std::shared_ptr<MapMarkersCollection> collection(new MapMarkersCollection());
+    collection->setClusteringEnabled(true, ZoomLevel16);
+
+    const auto origin = Utilities::convertLatLonTo31(LatLon(52.37, 4.89));
+    const auto first = addMarker(collection, origin);
+    const auto second = addMarker(collection, origin + PointI(100, 100));
+
+    QVERIFY(collection->removeMarker(second));
+    const auto keys = collection->getProvidedDataKeysForTiles(getTiles(origin, ZoomLevel10), ZoomLevel10);
+    QCOMPARE(keys.size(), 1);
+    QVERIFY(keys.contains(getKey(first)));
+}
+
+void TestMapMarkersClustering::disabledClusteringProvidesAllMarkers()
+{
+    const std::shared_ptr<MapMarkersCollection> collection(new MapMarkersCollection());
+
+    const auto origin = Utilities::convertLatLonTo31(LatLon(52.37, 4.89));
+    addMarker(collection, origin);
+    addMarker(collection, origin + PointI(100, 100));
+    addMarker(collection, Utilities::convertLatLonTo31(LatLon(48.85, 2.35)));
+
+    QVERIFY(!collection->isClusteringEnabled());
+    QCOMPARE(collection->getProvidedDataKeysForTiles(getTiles(origin, ZoomLevel10), ZoomLevel10).size(), 3);
+}
+
+QTEST_MAIN(TestMapMarkersClustering)
+#include "TestMapMarkersClustering.moc"
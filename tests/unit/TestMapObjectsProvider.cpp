@@ -0,0 +1,278 @@
+#include <OsmAndCore/Data/MapObject.h>
+#include <OsmAndCore/Map/MapObjectsProvider.h>
+#include <OsmAndCore/Utilities.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+
+using namespace OsmAnd;
+
+class TestMapObjectsProvider : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        PointsCount = 4000,
+        // Polyline goes through tiles of this zoom
+        LineZoom = 15,
+        LineTileX = 17000,
+        LineTileY = 11000,
+        LineTilesCount = 4,
+        // Deviation of each other point from straight line, it's more than pixel at LineZoom
+        Jitter31 = 1000,
+    };
+
+    class ZoomLimitedMapObject : public MapObject
+    {
+    public:
+        ZoomLimitedMapObject(const ZoomLevel minZoom_, const ZoomLevel maxZoom_)
+            : minZoom(minZoom_)
+            , maxZoom(maxZoom_)
+        {
+        }
+
+        const ZoomLevel minZoom;
+        const ZoomLevel maxZoom;
+
+        virtual ZoomLevel getMinZoomLevel() const Q_DECL_OVERRIDE
+        {
+            return minZoom;
+        }
+
+        virtual ZoomLevel getMaxZoomLevel() const Q_DECL_OVERRIDE
+        {
+            return maxZoom;
+        }
+    };
+
+    class DeferredLineMapObject
+        : public MapObject
+        , public MapObjectsProvider::IDeferredPolyline
+    {
+    public:
+        DeferredLineMapObject(const std::shared_ptr<const MapObject>& line_)
+            : line(line_)
+            , readsCount(0)
+        {
+            bbox31 = line->bbox31;
+            attributeIds = line->attributeIds;
+        }
+
+        const std::shared_ptr<const MapObject> line;
+        mutable QAtomicInt readsCount;
+
+        virtual bool readPoints31(QVector<PointI>& outPoints31) const Q_DECL_OVERRIDE
+        {
+            readsCount.fetchAndAddOrdered(1);
+            outPoints31 = line->points31;
+            return true;
+        }
+    };
+
+    static std::shared_ptr<MapObject> createLine();
+    static std::shared_ptr<MapObject> createPoint(const PointI& position31, const ZoomLevel minZoom);
+    static TileId getTileId(const PointI& point31, const ZoomLevel zoom);
+    static QList< std::shared_ptr<const MapObject> > obtainMapObjects(
+        MapObjectsProvider& provider,
+        const TileId tileId,
+        const ZoomLevel zoom);
+    static int countPoints(const QList< std::shared_ptr<const MapObject> >& mapObjects);
+private slots:
+    void unclipped();
+    void clipped();
+    void simplified();
+    void captions();
+    void zoomRange();
+    void deferred();
+};
+
+std::shared_ptr<MapObject> TestMapObjectsProvider::createLine()
+{
+    const std::shared_ptr<MapObject> line(new MapObject());
+    const auto tileSize31 = 1 << (ZoomLevel31 - LineZoom);
+    const auto x0 = LineTileX * tileSize31;
+    const auto y0 = LineTileY * tileSize31 + tileSize31 / 2;
+    for (auto pointIdx = 0; pointIdx < PointsCount; pointIdx++)
+    {
+        line->points31.push_back(PointI(
+            x0 + static_cast<int32_t>(static_cast<int64_t>(pointIdx) * LineTilesCount * tileSize31 / PointsCount),
+            y0 + (pointIdx % 2) * Jitter31));
+    }
+    line->computeBBox31();
+    line->captions.insert(line->attributeMapping->nativeNameAttributeId, QLatin1String("Line"));
+    line->captionsOrder.push_back(line->attributeMapping->nativeNameAttributeId);
+    return line;
+}
+
+std::shared_ptr<MapObject> TestMapObjectsProvider::createPoint(const PointI& position31, const ZoomLevel minZoom)
+{
+    const std::shared_ptr<MapObject> point(new ZoomLimitedMapObject(minZoom, MaxZoomLevel));
+    point->points31.push_back(position31);
+    point->computeBBox31();
+    return point;
+}
+
+TileId TestMapObjectsProvider::getTileId(const PointI& point31, const ZoomLevel zoom)
+{
+    return TileId::fromXY(point31.x >> (ZoomLevel31 - zoom), point31.y >> (ZoomLevel31 - zoom));
+}
+
+QList< std::shared_ptr<const MapObject> > TestMapObjectsProvider::obtainMapObjects(
+    MapObjectsProvider& provider,
+    const TileId tileId,
+    const ZoomLevel zoom)
+{
+    MapObjectsProvider::Request request;
+    request.tileId = tileId;
+    request.zoom = zoom;
+
+    std::shared_ptr<MapObjectsProvider::Data> data;
+    if (!provider.obtainTiledMapObjects(request, data) || !data)
+        return QList< std::shared_ptr<const MapObject> >();
+    return data->mapObjects;
+}
+
+int TestMapObjectsProvider::countPoints(const QList< std::shared_ptr<const MapObject> >& mapObjects)
+{
+    auto pointsCount = 0;
+    for (const auto& mapObject : mapObjects)
+        pointsCount += mapObject->points31.size();
+    return pointsCount;
+}
+
+void TestMapObjectsProvider::unclipped()
+{
+    const auto line = createLine();
+    MapObjectsProvider provider(QList< std::shared_ptr<const MapObject> >() << line);
+
+    const auto mapObjects = obtainMapObjects(provider, TileId::fromXY(LineTileX + 1, LineTileY), ZoomLevel15);
+    QCOMPARE(mapObjects.size(), 1);
+    QCOMPARE(mapObjects.first(), std::shared_ptr<const MapObject>(line));
+
+    QVERIFY(obtainMapObjects(provider, TileId::fromXY(LineTileX + 1, LineTileY + 2), ZoomLevel15).isEmpty());
+}
+
+void TestMapObjectsProvider::clipped()
+{
+    const auto line = createLine();
+    MapObjectsProvider provider(QList< std::shared_ptr<const MapObject> >() << line, true);
+
+    const auto tileId = TileId::fromXY(LineTileX + 1, LineTileY);
+    const auto tileBBox31 = Utilities::tileBoundingBox31(tileId, ZoomLevel15);
+    const auto mapObjects = obtainMapObjects(provider, tileId, ZoomLevel15);
+    QCOMPARE(mapObjects.size(), 1);
+
+    // Piece covers the tile and a bit around it, but not the whole line
+    const auto& piece = mapObjects.first();
+    QVERIFY(piece->points31.size() > 2);
+    QVERIFY(piece->points31.size() < PointsCount / 2);
+    QVERIFY(piece->bbox31.left() < tileBBox31.left());
+    QVERIFY(piece->bbox31.right() > tileBBox31.right());
+    QVERIFY(piece->bbox31.left() > line->bbox31.left());
+    QVERIFY(piece->bbox31.right() < line->bbox31.right());
+    QVERIFY(piece->captions.isEmpty());
+    for (const auto& point31 : constOf(piece->points31))
+        QVERIFY(line->points31.contains(point31));
+
+    QVERIFY(obtainMapObjects(provider, TileId::fromXY(LineTileX + LineTilesCount + 1, LineTileY), ZoomLevel15).isEmpty());
+}
+
+void TestMapObjectsProvider::simplified()
+{
+    const auto line = createLine();
+    MapObjectsProvider provider(QList< std::shared_ptr<const MapObject> >() << line, true);
+
+    // Jitter is far below pixel, so only ends of simplification chunks remain
+    const auto point31 = line->points31[PointsCount / 2];
+    const auto zoom5MapObjects = obtainMapObjects(provider, getTileId(point31, ZoomLevel5), ZoomLevel5);
+    QCOMPARE(zoom5MapObjects.size(), 1);
+    QVERIFY(zoom5MapObjects.first()->points31.size() < 10);
+    QCOMPARE(zoom5MapObjects.first()->points31.first(), line->points31.first());
+    QCOMPARE(zoom5MapObjects.first()->points31.last(), line->points31.last());
+
+    // Jitter is bigger than pixel, so every point is kept
+    const auto zoom22MapObjects = obtainMapObjects(provider, getTileId(point31, ZoomLevel22), ZoomLevel22);
+    QVERIFY(!zoom22MapObjects.isEmpty());
+    auto pointFound = false;
+    for (const auto& mapObject : constOf(zoom22MapObjects))
+        pointFound = pointFound || mapObject->points31.contains(point31);
+    QVERIFY(pointFound);
+    const auto tileBBox31 = Utilities::tileBoundingBox31(getTileId(point31, ZoomLevel22), ZoomLevel22);
+    auto pointsInTileCount = 0;
+    for (const auto& linePoint31 : constOf(line->points31))
+    {
+        if (tileBBox31.contains(linePoint31))
+            pointsInTileCount++;
+    }
+    QVERIFY(countPoints(zoom22MapObjects) >= pointsInTileCount);
+}
+
+void TestMapObjectsProvider::captions()
+{
+    const auto line = createLine();
+    MapObjectsProvider provider(QList< std::shared_ptr<const MapObject> >() << line, true);
+
+    // Only piece in tile of middle point has captions, though pieces of neighbour tiles overlap it
+    const auto captionTileId = getTileId(line->points31[PointsCount / 2], ZoomLevel15);
+    auto piecesWithCaptionsCount = 0;
+    for (auto tileX = LineTileX - 1; tileX <= LineTileX + LineTilesCount; tileX++)
+    {
+        const auto tileId = TileId::fromXY(tileX, LineTileY);
+        for (const auto& mapObject : constOf(obtainMapObjects(provider, tileId, ZoomLevel15)))
+        {
+            if (mapObject->captions.isEmpty())
+                continue;
+
+            piecesWithCaptionsCount++;
+            QCOMPARE(tileId.id, captionTileId.id);
+            QCOMPARE(mapObject->getCaptionInNativeLanguage(), QString("Line"));
+        }
+    }
+    QCOMPARE(piecesWithCaptionsCount, 1);
+}
+
+void TestMapObjectsProvider::zoomRange()
+{
+    const auto line = createLine();
+    const auto point = createPoint(line->points31[PointsCount / 2], ZoomLevel10);
+    MapObjectsProvider provider(QList< std::shared_ptr<const MapObject> >() << line << point, true);
+    QCOMPARE(provider.getMinZoom(), MinZoomLevel);
+    QCOMPARE(provider.getMaxZoom(), MaxZoomLevel);
+
+    const auto zoom9MapObjects = obtainMapObjects(provider, getTileId(point->points31.first(), ZoomLevel9), ZoomLevel9);
+    QCOMPARE(zoom9MapObjects.size(), 1);
+    QVERIFY(zoom9MapObjects.first() != point);
+
+    // Points are provided as is
+    const auto zoom10MapObjects = obtainMapObjects(provider, getTileId(point->points31.first(), ZoomLevel10), ZoomLevel10);
+    QCOMPARE(zoom10MapObjects.size(), 2);
+    QVERIFY(zoom10MapObjects.contains(point));
+}
+
+void TestMapObjectsProvider::deferred()
+{
+    const auto line = createLine();
+    const std::shared_ptr<DeferredLineMapObject> deferredLine(new DeferredLineMapObject(line));
+    MapObjectsProvider provider(QList< std::shared_ptr<const MapObject> >() << line, true);
+    MapObjectsProvider deferredProvider(QList< std::shared_ptr<const MapObject> >() << deferredLine);
+    QCOMPARE(deferredLine->readsCount.load(), 0);
+
+    // Points are read for each tile, and pieces are the same as of line that has them upfront
+    for (const auto zoom : { ZoomLevel5, ZoomLevel15, ZoomLevel22 })
+    {
+        const auto tileId = getTileId(line->points31[PointsCount / 3], zoom);
+        const auto mapObjects = obtainMapObjects(provider, tileId, zoom);
+        const auto deferredMapObjects = obtainMapObjects(deferredProvider, tileId, zoom);
+        QCOMPARE(deferredMapObjects.size(), mapObjects.size());
+        for (auto mapObjectIdx = 0; mapObjectIdx < mapObjects.size(); mapObjectIdx++)
+            QVERIFY(deferredMapObjects[mapObjectIdx]->points31 == mapObjects[mapObjectIdx]->points31);
+    }
+    QCOMPARE(deferredLine->readsCount.load(), 3);
+
+    QVERIFY(obtainMapObjects(deferredProvider, TileId::fromXY(LineTileX + 1, LineTileY + 2), ZoomLevel15).isEmpty());
+    QCOMPARE(deferredLine->readsCount.load(), 3);
+}
+
+QTEST_MAIN(TestMapObjectsProvider)
+#include "TestMapObjectsProvider.moc"
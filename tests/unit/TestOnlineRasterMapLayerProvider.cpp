@@ -0,0 +1,220 @@
+#include <OsmAndCore/WebClient.h>
+#include <OsmAndCore/Map/OnlineRasterMapLayerProvider.h>
+
+#include <functional>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "LoopbackHttpServer.h"
+
+using namespace OsmAnd;
+
+class TestOnlineRasterMapLayerProvider : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        WaitTimeoutMs = 5000,
+        HintZoom = ZoomLevel10,
+    };
+
+    // 1x1 PNG, provider is created with tile size of 1
+    static const QByteArray TileData;
+
+    static std::shared_ptr<OnlineRasterMapLayerProvider> createProvider(
+        const LoopbackHttpServer& server,
+        const QTemporaryDir& cacheDir);
+    static IMapTiledDataProvider::PrefetchHint createHint(const int firstX, const int tilesCount);
+    static bool obtainTile(OnlineRasterMapLayerProvider& provider, const int x);
+    static bool waitFor(const std::function<bool()>& condition);
+private slots:
+    void prefetchUseful();
+    void prefetchCancelled();
+    void prefetchDeduplicated();
+    void prefetchClaimedWhileInFlight();
+    void prefetchDisabled();
+};
+
+const QByteArray TestOnlineRasterMapLayerProvider::TileData(
+    "\x89\x50\x4e\x47\x0d\x0a\x1a\x0a\x00\x00\x00\x0d\x49\x48\x44\x52\x00\x00\x00\x01\x00\x00\x00\x01"
+    "\x08\x06\x00\x00\x00\x1f\x15\xc4\x89\x00\x00\x00\x0d\x49\x44\x41\x54\x78\x9c\x63\x50\x70\x48\xf8"
+    "\x0f\x00\x03\x04\x01\xc0\x80\x28\x70\xda\x00\x00\x00\x00\x49\x45\x4e\x44\xae\x42\x60\x82",
+    70);
+
+std::shared_ptr<OnlineRasterMapLayerProvider> TestOnlineRasterMapLayerProvider::createProvider(
+    const LoopbackHttpServer& server,
+    const QTemporaryDir& cacheDir)
+{
+    const std::shared_ptr<OnlineRasterMapLayerProvider> provider(new OnlineRasterMapLayerProvider(
+        QLatin1String("Test"),
+        server.getBaseUrl() + QLatin1String("/${osm_zoom}/${osm_x}/${osm_y}.png"),
+        ZoomLevel0,
+        ZoomLevel20,
+        1,
+        1));
+    provider->setLocalCachePath(cacheDir.path(), false);
+    return provider;
+}
+
+IMapTiledDataProvider::PrefetchHint TestOnlineRasterMapLayerProvider::createHint(const int firstX, const int tilesCount)
+{
+    IMapTiledDataProvider::PrefetchHint hint;
+    hint.zoom = static_cast<ZoomLevel>(HintZoom);
+    for (auto x = firstX; x < firstX + tilesCount; x++)
+        hint.tileIds.push_back(TileId::fromXY(x, 100));
+    return hint;
+}
+
+bool TestOnlineRasterMapLayerProvider::obtainTile(OnlineRasterMapLayerProvider& provider, const int x)
+{
+    OnlineRasterMapLayerProvider::Request request;
+    request.tileId = TileId::fromXY(x, 100);
+    request.zoom = static_cast<ZoomLevel>(HintZoom);
+
+    std::shared_ptr<IMapDataProvider::Data> data;
+    return provider.obtainData(request, data) && data;
+}
+
+bool TestOnlineRasterMapLayerProvider::waitFor(const std::function<bool()>& condition)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition())
+    {
+        if (timer.elapsed() > WaitTimeoutMs)
+            return false;
+        QThread::msleep(5);
+    }
+    return true;
+}
+
+// Hinted tiles are downloaded in background and later obtained without network requests
+void TestOnlineRasterMapLayerProvider::prefetchUseful()
+{
+    LoopbackHttpServer server(10);
+    server.setResponseBody(TileData);
+    QVERIFY(server.startListening());
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    const auto provider = createProvider(server, cacheDir);
+    QVERIFY(provider->isPrefetchEnabled());
+    provider->prefetch(createHint(0, 3));
+    QVERIFY(waitFor([provider]() { return provider->getPrefetchStatistics().downloadedCount == 3; }));
+
+    QVERIFY(obtainTile(*provider, 0));
+    QVERIFY(obtainTile(*provider, 1));
+    QCOMPARE(server.getRequestsCount(), 3);
+
+    const auto statistics = provider->getPrefetchStatistics();
+    QCOMPARE(statistics.startedCount, 3u);
+    QCOMPARE(statistics.usefulCount, 2u);
+    QCOMPARE(statistics.wastedCount, 1u);
+    QCOMPARE(statistics.failedCount, 0u);
+
+    // Tile that was not hinted is downloaded on request
+    QVERIFY(obtainTile(*provider, 10));
+    QCOMPARE(server.getRequestsCount(), 4);
+    QCOMPARE(provider->getPrefetchStatistics().usefulCount, 2u);
+}
+
+// Tiles that are no longer hinted are dropped from queue or cancelled while being downloaded
+void TestOnlineRasterMapLayerProvider::prefetchCancelled()
+{
+    LoopbackHttpServer server(2000);
+    server.setResponseBody(TileData);
+    QVERIFY(server.startListening());
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    const auto provider = createProvider(server, cacheDir);
+    provider->prefetch(createHint(0, 6));
+    auto statistics = provider->getPrefetchStatistics();
+    QCOMPARE(statistics.startedCount, 2u);
+
+    provider->prefetch(createHint(100, 1));
+    statistics = provider->getPrefetchStatistics();
+    QCOMPARE(statistics.cancelledCount, 2u);
+    QCOMPARE(statistics.droppedCount, 4u);
+    QCOMPARE(statistics.startedCount, 3u);
+
+    QVERIFY(waitFor([provider]() { return provider->getPrefetchStatistics().downloadedCount == 1; }));
+    statistics = provider->getPrefetchStatistics();
+    QCOMPARE(statistics.wastedCount, 1u);
+    QCOMPARE(statistics.failedCount, 0u);
+}
+
+// Repeated hints, tiles in local storage and tiles being downloaded are not prefetched again
+void TestOnlineRasterMapLayerProvider::prefetchDeduplicated()
+{
+    LoopbackHttpServer server(10);
+    server.setResponseBody(TileData);
+    QVERIFY(server.startListening());
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    const auto provider = createProvider(server, cacheDir);
+    QVERIFY(obtainTile(*provider, 0));
+
+    auto hint = createHint(0, 3);
+    hint.tileIds.push_back(TileId::fromXY(2, 100));
+    provider->prefetch(hint);
+    provider->prefetch(hint);
+    QVERIFY(waitFor([provider]() { return provider->getPrefetchStatistics().downloadedCount == 2; }));
+    provider->prefetch(hint);
+
+    const auto statistics = provider->getPrefetchStatistics();
+    QCOMPARE(statistics.startedCount, 2u);
+    QCOMPARE(statistics.cancelledCount, 0u);
+    QCOMPARE(statistics.droppedCount, 0u);
+    QCOMPARE(server.getRequestsCount(), 3);
+}
+
+// Tile requested while it's being prefetched is taken from that download
+void TestOnlineRasterMapLayerProvider::prefetchClaimedWhileInFlight()
+{
+    LoopbackHttpServer server(300);
+    server.setResponseBody(TileData);
+    QVERIFY(server.startListening());
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    const auto provider = createProvider(server, cacheDir);
+    provider->prefetch(createHint(0, 1));
+    QVERIFY(obtainTile(*provider, 0));
+
+    // Claimed tile is kept even if it's no longer hinted
+    QVERIFY(waitFor([provider]() { return provider->getPrefetchStatistics().downloadedCount == 1; }));
+    const auto statistics = provider->getPrefetchStatistics();
+    QCOMPARE(statistics.usefulCount, 1u);
+    QCOMPARE(statistics.wastedCount, 0u);
+    QCOMPARE(server.getRequestsCount(), 1);
+}
+
+void TestOnlineRasterMapLayerProvider::prefetchDisabled()
+{
+    LoopbackHttpServer server(10);
+    server.setResponseBody(TileData);
+    QVERIFY(server.startListening());
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+
+    const auto provider = createProvider(server, cacheDir);
+    provider->setPrefetchEnabled(false);
+    provider->prefetch(createHint(0, 3));
+    provider->setPrefetchEnabled(true);
+    provider->setNetworkAccessPermission(false);
+    provider->prefetch(createHint(0, 3));
+
+    QTest::qSleep(100);
+    QCOMPARE(provider->getPrefetchStatistics().startedCount, 0u);
+    QCOMPARE(server.getRequestsCount(), 0);
+}
+
+QTEST_MAIN(TestOnlineRasterMapLayerProvider)
+#include "TestOnlineRasterMapLayerProvider.moc"
@@ -0,0 +1,611 @@
+#include <limits>
+
+#include <OsmAndCore/ObfDataInterface.h>
+#include <OsmAndCore/Data/ObfFile.h>
+#include <OsmAndCore/Data/ObfReader.h>
+#include <OsmAndCore/Data/Road.h>
+#include <OsmAndCore/Routing/RoadGraph.h>
+#include <OsmAndCore/Routing/RoutePlanner.h>
+#include <OsmAndCore/Routing/RoutingConfiguration.h>
+#include <OsmAndCore/Routing/RoutingProfileContext.h>
+#include <OsmAndCore/Utilities.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QTemporaryDir>
+
+#include "SyntheticRoutingObf.h"
+
+using namespace OsmAnd;
+
+// Network is a grid of roads with few special cases: row 1 and column 2 are faster, column 3 is oneway,
+// piece of row 3 is closed by a gate, footway is not accessible by car and one road is not connected to grid.
+class TestRoutePlanner : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum : int {
+        GridSize = 4,
+        Spacing31 = 1 << 16,
+        Origin31 = 1 << 30,
+        // Shape points between nodes are shifted aside from straight line
+        ShapeOffset31 = 1024,
+        FastRow = 1,
+        FastColumn = 2,
+        OnewayColumn = 3,
+        GateRow = 3,
+        GateColumn = 1,
+        IsolatedNode = 100,
+    };
+
+    enum : int {
+        FastSpeed = 60,
+        SlowSpeed = 30,
+    };
+
+    struct ReferenceEdge
+    {
+        int source;
+        int target;
+        double time;
+    };
+
+    static const char* const RoutingConfig;
+
+    QTemporaryDir _dataDir;
+    std::shared_ptr<RoutingProfile> _profile;
+    std::shared_ptr<ObfDataInterface> _dataInterface;
+    std::shared_ptr<const RoadGraph> _graph;
+    QList<ReferenceEdge> _referenceEdges;
+    QHash<int, PointI> _referenceNodesPositions31;
+
+    static PointI getGridPoint31(const int row, const int column);
+    static QVector<PointI> createGridRoad(const bool horizontal, const int line);
+    static double measure(const QVector<PointI>& points31, const int fromPoint, const int toPoint);
+    void addRoad(
+        SyntheticRoutingObf& obf,
+        const QVector<PointI>& points31,
+        const QString& highway,
+        const bool oneway = false,
+        const int gatePoint = -1);
+    void createNetwork(SyntheticRoutingObf& obf);
+    QHash<int, double> findReferenceTimes(const int source) const;
+    RoadGraph::NodeIndex getNode(const int referenceNode) const;
+    static void verifyRoute(const QList< std::shared_ptr<const RouteSegment> >& route, const float time);
+private slots:
+    void initTestCase();
+    void graphStructure();
+    void nodeToNodeRoutes();
+    void oneway();
+    void routeFromRoadPoint();
+    void routeOnSameEdge();
+    void unreachable();
+    void settledNodes();
+    void nearestNode();
+    void turnRestrictions();
+    void cachedRoadRules();
+};
+
+const char* const TestRoutePlanner::RoutingConfig =
+    "<osmand_routing_config defaultProfile=\"car\">"
+    "  <routingProfile name=\"car\" minDefaultSpeed=\"45\" maxDefaultSpeed=\"130\">"
+    "    <way attribute=\"access\">"
+    "      <select value=\"-1\" t=\"highway\" v=\"footway\"/>"
+    "    </way>"
+    "    <way attribute=\"oneway\">"
+    "      <select value=\"1\" t=\"oneway\" v=\"yes\"/>"
+    "      <select value=\"-1\" t=\"oneway\" v=\"-1\"/>"
+    "    </way>"
+    "    <way attribute=\"speed\">"
+    "      <select value=\"60\" t=\"highway\" v=\"primary\"/>"
+    "      <select value=\"30\" t=\"highway\" v=\"residential\"/>"
+    "    </way>"
+    "    <point attribute=\"obstacle\">"
+    "      <select value=\"-1\" t=\"barrier\" v=\"gate\"/>"
+    "    </point>"
+    "  </routingProfile>"
+    "</osmand_routing_config>";
+
+PointI TestRoutePlanner::getGridPoint31(const int row, const int column)
+{
+    return PointI(Origin31 + column * Spacing31, Origin31 + row * Spacing31);
+}
+
+QVector<PointI> TestRoutePlanner::createGridRoad(const bool horizontal, const int line)
+{
+    // Two shape points between each pair of nodes, aligned to storage precision
+    const auto shapeStep31 = (Spacing31 / 3) & ~15;
+
+    QVector<PointI> points31;
+    for (auto index = 0; index < GridSize; index++)
+    {
+        const auto node31 = horizontal ? getGridPoint31(line, index) : getGridPoint31(index, line);
+        points31.push_back(node31);
+        if (index == GridSize - 1)
+            break;
+
+        if (horizontal)
+        {
+            points31.push_back(PointI(node31.x + shapeStep31, node31.y + ShapeOffset31));
+            points31.push_back(PointI(node31.x + 2 * shapeStep31, node31.y - ShapeOffset31));
+        }
+        else
+        {
+            points31.push_back(PointI(node31.x + ShapeOffset31, node31.y + shapeStep31));
+            points31.push_back(PointI(node31.x - ShapeOffset31, node31.y + 2 * shapeStep31));
+        }
+    }
+    return points31;
+}
+
+double TestRoutePlanner::measure(const QVector<PointI>& points31, const int fromPoint, const int toPoint)
+{
+    auto distance = 0.0;
+    for (auto pointIndex = qMin(fromPoint, toPoint); pointIndex < qMax(fromPoint, toPoint); pointIndex++)
+        distance += Utilities::distance31(points31[pointIndex], points31[pointIndex + 1]);
+    return distance;
+}
+
+void TestRoutePlanner::addRoad(
+    SyntheticRoutingObf& obf,
+    const QVector<PointI>& points31,
+    const QString& highway,
+    const bool oneway /*= false*/,
+    const int gatePoint /*= -1*/)
+{
+    SyntheticRoutingObf::Road road;
+    road.id = obf.roads.size() + 1;
+    road.points31 = points31;
+    road.tags.push_back(qMakePair(QString(QLatin1String("highway")), highway));
+    if (oneway)
+        road.tags.push_back(qMakePair(QString(QLatin1String("oneway")), QString(QLatin1String("yes"))));
+    if (gatePoint >= 0)
+        road.pointsTags[gatePoint].push_back(qMakePair(QString(QLatin1String("barrier")), QString(QLatin1String("gate"))));
+    obf.roads.push_back(road);
+
+    if (highway == QLatin1String("footway"))
+        return;
+
+    // Reference edges connect points of road that are known nodes
+    const auto speed = (highway == QLatin1String("primary") ? FastSpeed : SlowSpeed) / 3.6;
+    auto previousNodePoint = -1;
+    auto previousNode = -1;
+    for (auto pointIndex = 0; pointIndex < points31.size(); pointIndex++)
+    {
+        const auto citNode = std::find(
+            _referenceNodesPositions31.cbegin(),
+            _referenceNodesPositions31.cend(),
+            points31[pointIndex]);
+        if (citNode == _referenceNodesPositions31.cend())
+            continue;
+
+        if (previousNode >= 0 && !(gatePoint > previousNodePoint && gatePoint < pointIndex))
+        {
+            ReferenceEdge edge;
+            edge.time = measure(points31, previousNodePoint, pointIndex) / speed;
+            edge.source = previousNode;
+            edge.target = citNode.key();
+            _referenceEdges.push_back(edge);
+            if (!oneway)
+            {
+                std::swap(edge.source, edge.target);
+                _referenceEdges.push_back(edge);
+            }
+        }
+        previousNodePoint = pointIndex;
+        previousNode = citNode.key();
+    }
+}
+
+void TestRoutePlanner::createNetwork(SyntheticRoutingObf& obf)
+{
+    for (auto row = 0; row < GridSize; row++)
+    {
+        for (auto column = 0; column < GridSize; column++)
+            _referenceNodesPositions31.insert(row * GridSize + column, getGridPoint31(row, column));
+    }
+    const auto isolatedStart31 = getGridPoint31(GridSize * 3, GridSize * 3);
+    const auto isolatedEnd31 = getGridPoint31(GridSize * 3, GridSize * 3 + 1);
+    _referenceNodesPositions31.insert(IsolatedNode, isolatedStart31);
+    _referenceNodesPositions31.insert(IsolatedNode + 1, isolatedEnd31);
+
+    for (auto row = 0; row < GridSize; row++)
+    {
+        // Gate is at first shape point after node of gate column
+        const auto gatePoint = (row == GateRow) ? GateColumn * 3 + 1 : -1;
+        addRoad(
+            obf,
+            createGridRoad(true, row),
+            QLatin1String(row == FastRow ? "primary" : "residential"),
+            false,
+            gatePoint);
+    }
+    for (auto column = 0; column < GridSize; column++)
+    {
+        addRoad(
+            obf,
+            createGridRoad(false, column),
+            QLatin1String(column == FastColumn ? "primary" : "residential"),
+            column == OnewayColumn);
+    }
+
+    const auto footwayStart31 = getGridPoint31(0, 0);
+    const auto footwayEnd31 = getGridPoint31(1, 1);
+    addRoad(
+        obf,
+        QVector<PointI>()
+            << footwayStart31
+            << PointI(footwayStart31.x + Spacing31 / 2, footwayStart31.y + Spacing31 / 2)
+            << footwayEnd31,
+        QLatin1String("footway"));
+
+    addRoad(obf, QVector<PointI>() << isolatedStart31 << isolatedEnd31, QLatin1String("residential"));
+}
+
+QHash<int, double> TestRoutePlanner::findReferenceTimes(const int source) const
+{
+    QHash<int, double> times;
+    QSet<int> settled;
+    times.insert(source, 0.0);
+    for (;;)
+    {
+        auto bestNode = -1;
+        for (auto itTime = times.cbegin(); itTime != times.cend(); ++itTime)
+        {
+            if (settled.contains(itTime.key()))
+                continue;
+            if (bestNode < 0 || itTime.value() < times[bestNode])
+                bestNode = itTime.key();
+        }
+        if (bestNode < 0)
+            break;
+        settled.insert(bestNode);
+
+        for (const auto& edge : constOf(_referenceEdges))
+        {
+            if (edge.source != bestNode)
+                continue;
+            const auto time = times[bestNode] + edge.time;
+            if (!times.contains(edge.target) || time < times[edge.target])
+                times[edge.target] = time;
+        }
+    }
+    return times;
+}
+
+RoadGraph::NodeIndex TestRoutePlanner::getNode(const int referenceNode) const
+{
+    const auto position31 = _referenceNodesPositions31[referenceNode];
+    const auto node = _graph->findNearestNode(position31);
+    return _graph->getNodePosition31(node) == position31 ? node : RoadGraph::InvalidIndex;
+}
+
+void TestRoutePlanner::verifyRoute(const QList< std::shared_ptr<const RouteSegment> >& route, const float time)
+{
+    QVERIFY(!route.isEmpty());
+
+    auto routeTime = 0.0f;
+    for (auto segmentIndex = 0; segmentIndex < route.size(); segmentIndex++)
+    {
+        const auto& segment = route[segmentIndex];
+        routeTime += segment->time;
+        QVERIFY(segment->distance >= 0.0f);
+        if (segmentIndex == 0)
+            continue;
+
+        // Each segment starts where previous one ends
+        const auto& previousSegment = route[segmentIndex - 1];
+        QCOMPARE(
+            segment->road->points31[segment->startPointIndex],
+            previousSegment->road->points31[previousSegment->endPointIndex]);
+    }
+    QVERIFY(qAbs(routeTime - time) < 0.01f);
+}
+
+void TestRoutePlanner::initTestCase()
+{
+    QVERIFY(_dataDir.isValid());
+
+    SyntheticRoutingObf obf;
+    createNetwork(obf);
+    const auto obfFilePath = _dataDir.filePath(QLatin1String("grid.obf"));
+    QVERIFY(obf.write(obfFilePath));
+
+    RoutingConfiguration configuration;
+    QBuffer configurationBuffer;
+    configurationBuffer.setData(RoutingConfig);
+    QVERIFY(configurationBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(RoutingConfiguration::parseConfiguration(&configurationBuffer, configuration));
+    QVERIFY(configuration.routingProfiles.contains(QLatin1String("car")));
+    _profile = configuration.routingProfiles[QLatin1String("car")];
+    const std::shared_ptr<RoutingProfileContext> profileContext(new RoutingProfileContext(_profile));
+
+    const std::shared_ptr<const ObfFile> obfFile(new ObfFile(obfFilePath));
+    const std::shared_ptr<const ObfReader> obfReader(new ObfReader(obfFile));
+    QVERIFY(obfReader->obtainInfo());
+    QCOMPARE(obfReader->obtainInfo()->routingSections.size(), 1);
+
+    _dataInterface.reset(new ObfDataInterface(QList< std::shared_ptr<const ObfReader> >() << obfReader));
+    _graph = RoadGraph::load(_dataInterface, profileContext);
+    QVERIFY(_graph);
+}
+
+void TestRoutePlanner::graphStructure()
+{
+    // Footway is excluded, the rest of roads are kept
+    QCOMPARE(_graph->getRoadsCount(), static_cast<unsigned int>(GridSize * 2 + 1));
+    QCOMPARE(_graph->getNodesCount(), static_cast<unsigned int>(_referenceNodesPositions31.size()));
+    QCOMPARE(_graph->getEdgesCount(), static_cast<unsigned int>(_referenceEdges.size()));
+    QVERIFY(qAbs(_graph->getMaxSpeed() - FastSpeed / 3.6f) < 0.001f);
+
+    // Shape points are not nodes
+    for (const auto& position31 : constOf(_referenceNodesPositions31))
+        QCOMPARE(_graph->getNodePosition31(_graph->findNearestNode(position31)), position31);
+}
+
+void TestRoutePlanner::nodeToNodeRoutes()
+{
+    RoutePlanner planner(_graph);
+    for (auto source = 0; source < GridSize * GridSize; source++)
+    {
+        const auto referenceTimes = findReferenceTimes(source);
+        for (auto target = 0; target < GridSize * GridSize; target++)
+        {
+            QList< std::shared_ptr<const RouteSegment> > route;
+            auto time = 0.0f;
+            QVERIFY(planner.findRoute(getNode(source), getNode(target), &route, &time));
+            QVERIFY(referenceTimes.contains(target));
+            QVERIFY2(
+                qAbs(time - referenceTimes[target]) < 0.01,
+                qPrintable(QString(QLatin1String("%1 -> %2: %3 instead of %4"))
+                    .arg(source)
+                    .arg(target)
+                    .arg(time)
+                    .arg(referenceTimes[target])));
+
+            if (source == target)
+            {
+                QVERIFY(route.isEmpty());
+                continue;
+            }
+            verifyRoute(route, time);
+            QCOMPARE(route.first()->road->points31[route.first()->startPointIndex], _referenceNodesPositions31[source]);
+            QCOMPARE(route.last()->road->points31[route.last()->endPointIndex], _referenceNodesPositions31[target]);
+        }
+    }
+}
+
+void TestRoutePlanner::oneway()
+{
+    RoutePlanner planner(_graph);
+    const auto top = OnewayColumn;
+    const auto bottom = (GridSize - 1) * GridSize + OnewayColumn;
+
+    QList< std::shared_ptr<const RouteSegment> > route;
+    auto forwardTime = 0.0f;
+    QVERIFY(planner.findRoute(getNode(top), getNode(bottom), &route, &forwardTime));
+    // Oneway road is passed from start to end in order of its points
+    QCOMPARE(route.size(), 1);
+    QVERIFY(route.first()->startPointIndex < route.first()->endPointIndex);
+
+    auto backwardTime = 0.0f;
+    QVERIFY(planner.findRoute(getNode(bottom), getNode(top), &route, &backwardTime));
+    QVERIFY(backwardTime > forwardTime);
+    for (const auto& segment : constOf(route))
+    {
+        const auto& points31 = segment->road->points31;
+        if (points31.first() == _referenceNodesPositions31[top] && points31.last() == _referenceNodesPositions31[bottom])
+            QVERIFY(segment->startPointIndex < segment->endPointIndex);
+    }
+    QVERIFY(qAbs(backwardTime - findReferenceTimes(bottom)[top]) < 0.01);
+}
+
+void TestRoutePlanner::routeFromRoadPoint()
+{
+    RoutePlanner planner(_graph);
+
+    // Start at shape point of row 0 between columns 0 and 1, slightly off the road
+    const auto row0Points31 = createGridRoad(true, 0);
+    const auto startPointIndex = 2;
+    const auto start31 = row0Points31[startPointIndex] + PointI(100, 100);
+    const auto end = GridSize * GridSize - 1;
+
+    QList< std::shared_ptr<const RouteSegment> > route;
+    auto time = 0.0f;
+    QVERIFY(planner.findRoute(start31, _referenceNodesPositions31[end], &route, &time));
+    verifyRoute(route, time);
+    QCOMPARE(route.first()->road->points31[route.first()->startPointIndex], row0Points31[startPointIndex]);
+    QCOMPARE(route.last()->road->points31[route.last()->endPointIndex], _referenceNodesPositions31[end]);
+
+    const auto referenceTimes0 = findReferenceTimes(0);
+    const auto referenceTimes1 = findReferenceTimes(1);
+    const auto speed = SlowSpeed / 3.6;
+    const auto expectedTime = qMin(
+        measure(row0Points31, startPointIndex, 0) / speed + referenceTimes0[end],
+        measure(row0Points31, startPointIndex, 3) / speed + referenceTimes1[end]);
+    QVERIFY(qAbs(time - expectedTime) < 0.01);
+}
+
+void TestRoutePlanner::routeOnSameEdge()
+{
+    RoutePlanner planner(_graph);
+
+    // Both points are between same pair of nodes, so route doesn't pass any node
+    const auto row0Points31 = createGridRoad(true, 0);
+    QList< std::shared_ptr<const RouteSegment> > route;
+    auto time = 0.0f;
+    QVERIFY(planner.findRoute(row0Points31[5], row0Points31[4], &route, &time));
+    QCOMPARE(route.size(), 1);
+    QCOMPARE(route.first()->startPointIndex, 5u);
+    QCOMPARE(route.first()->endPointIndex, 4u);
+    QVERIFY(qAbs(time - measure(row0Points31, 4, 5) / (SlowSpeed / 3.6)) < 0.01);
+    verifyRoute(route, time);
+}
+
+void TestRoutePlanner::unreachable()
+{
+    RoutePlanner planner(_graph);
+
+    QList< std::shared_ptr<const RouteSegment> > route;
+    QVERIFY(!planner.findRoute(getNode(0), getNode(IsolatedNode), &route));
+    QVERIFY(!planner.findRoute(_referenceNodesPositions31[IsolatedNode], _referenceNodesPositions31[0], &route));
+
+    // Planner is usable after failed search
+    auto time = 0.0f;
+    QVERIFY(planner.findRoute(getNode(IsolatedNode), getNode(IsolatedNode + 1), &route, &time));
+    QCOMPARE(route.size(), 1);
+}
+
+void TestRoutePlanner::settledNodes()
+{
+    RoutePlanner planner(_graph);
+
+    // Search towards neighbour node doesn't explore whole grid
+    QVERIFY(planner.findRoute(getNode(GridSize + 1), getNode(GridSize + 2)));
+    QVERIFY(planner.getLastSettledNodesCount() > 0u);
+    QVERIFY(planner.getLastSettledNodesCount() < _graph->getNodesCount());
+}
+
+void TestRoutePlanner::nearestNode()
+{
+    // Points inside of network, around it and far away from it
+    QList<PointI> points31;
+    for (auto row = -2; row <= GridSize * 3 + 2; row++)
+    {
+        for (auto column = -2; column <= GridSize * 3 + 2; column++)
+            points31.push_back(getGridPoint31(row, column) + PointI(Spacing31 / 3, Spacing31 / 5));
+    }
+    points31.push_back(PointI(0, 0));
+    points31.push_back(PointI(std::numeric_limits<int32_t>::max(), 0));
+
+    for (const auto& point31 : constOf(points31))
+    {
+        auto minSquareDistance = std::numeric_limits<double>::max();
+        for (auto nodeIndex = 0u; nodeIndex < _graph->getNodesCount(); nodeIndex++)
+        {
+            minSquareDistance = qMin(
+                minSquareDistance,
+                Utilities::squareDistance31(_graph->getNodePosition31(nodeIndex), point31));
+        }
+
+        const auto node = _graph->findNearestNode(point31);
+        QVERIFY(node != RoadGraph::InvalidIndex);
+        QCOMPARE(Utilities::squareDistance31(_graph->getNodePosition31(node), point31), minSquareDistance);
+    }
+}
+
+void TestRoutePlanner::turnRestrictions()
+{
+    // Road 1 goes from A to V, road 2 continues it to B and road 4 goes aside from V to D. Road 3 is a detour
+    // from A to B. Going straight on from road 1 to road 2 is forbidden, while from road 2 only going straight
+    // on to road 1 is allowed.
+    const auto a31 = getGridPoint31(0, 0);
+    const auto v31 = getGridPoint31(0, 1);
+    const auto b31 = getGridPoint31(0, 2);
+    const auto d31 = getGridPoint31(-1, 1);
+    const auto road1Points31 = QVector<PointI>() << a31 << v31;
+    const auto road2Points31 = QVector<PointI>() << v31 << b31;
+    const auto road3Points31 = QVector<PointI>() << a31 << getGridPoint31(1, 1) << b31;
+    const auto road4Points31 = QVector<PointI>() << v31 << d31;
+
+    SyntheticRoutingObf obf;
+    const QList< QVector<PointI> > roadsPoints31 = QList< QVector<PointI> >()
+        << road1Points31
+        << road2Points31
+        << road3Points31
+        << road4Points31;
+    for (const auto& points31 : constOf(roadsPoints31))
+    {
+        SyntheticRoutingObf::Road road;
+        road.id = obf.roads.size() + 1;
+        road.points31 = points31;
+        road.tags.push_back(qMakePair(QString(QLatin1String("highway")), QString(QLatin1String("residential"))));
+        obf.roads.push_back(road);
+    }
+    obf.roads[0].restrictions.insert(2, static_cast<int>(RoadRestriction::NoStraightOn));
+    obf.roads[1].restrictions.insert(1, static_cast<int>(RoadRestriction::OnlyStraightOn));
+    const auto obfFilePath = _dataDir.filePath(QLatin1String("restrictions.obf"));
+    QVERIFY(obf.write(obfFilePath));
+
+    const std::shared_ptr<const ObfFile> obfFile(new ObfFile(obfFilePath));
+    const std::shared_ptr<const ObfReader> obfReader(new ObfReader(obfFile));
+    const std::shared_ptr<ObfDataInterface> dataInterface(
+        new ObfDataInterface(QList< std::shared_ptr<const ObfReader> >() << obfReader));
+    const std::shared_ptr<RoutingProfileContext> profileContext(new RoutingProfileContext(_profile));
+    const auto graph = RoadGraph::load(dataInterface, profileContext);
+    QVERIFY(graph);
+
+    // Node V is split for both restricted roads
+    QCOMPARE(graph->getNodesCount(), 5u + 2u);
+
+    const auto speed = SlowSpeed / 3.6;
+    const auto road1Time = measure(road1Points31, 0, 1) / speed;
+    const auto road2Time = measure(road2Points31, 0, 1) / speed;
+    const auto road3Time = measure(road3Points31, 0, 2) / speed;
+    const auto road4Time = measure(road4Points31, 0, 1) / speed;
+    const auto getRoadsIds =
+        []
+        (const QList< std::shared_ptr<const RouteSegment> >& route) -> QList<uint64_t>
+        {
+            QList<uint64_t> roadsIds;
+            for (const auto& segment : constOf(route))
+                roadsIds.push_back(segment->road->id.id);
+            return roadsIds;
+        };
+
+    RoutePlanner planner(graph);
+    QList< std::shared_ptr<const RouteSegment> > route;
+    auto time = 0.0f;
+
+    // From A to B detour is taken instead of going straight on
+    QVERIFY(planner.findRoute(a31, b31, &route, &time));
+    verifyRoute(route, time);
+    QCOMPARE(getRoadsIds(route), QList<uint64_t>() << 3);
+    QVERIFY(qAbs(time - road3Time) < 0.01);
+
+    // From B to A going straight on is allowed
+    QVERIFY(planner.findRoute(b31, a31, &route, &time));
+    verifyRoute(route, time);
+    QCOMPARE(getRoadsIds(route), QList<uint64_t>() << 2 << 1);
+    QVERIFY(qAbs(time - (road2Time + road1Time)) < 0.01);
+
+    // From B to D turn at V is forbidden, so route goes straight on to A, turns back and passes V again
+    QVERIFY(planner.findRoute(b31, d31, &route, &time));
+    verifyRoute(route, time);
+    QCOMPARE(getRoadsIds(route), QList<uint64_t>() << 2 << 1 << 1 << 4);
+    QVERIFY(qAbs(time - (road2Time + 2 * road1Time + road4Time)) < 0.01);
+
+    // Restricted road still leads to V itself
+    QVERIFY(planner.findRoute(graph->findNearestNode(a31), graph->findNearestNode(v31), &route, &time));
+    verifyRoute(route, time);
+    QCOMPARE(getRoadsIds(route), QList<uint64_t>() << 1);
+    QVERIFY(qAbs(time - road1Time) < 0.01);
+}
+
+void TestRoutePlanner::cachedRoadRules()
+{
+    QList< std::shared_ptr<const Road> > roads;
+    QVERIFY(_dataInterface->loadRoads(RoutingDataLevel::Detailed, nullptr, &roads));
+    QCOMPARE(roads.size(), GridSize * 2 + 2);
+
+    RoutingProfileContext cachingContext(_profile);
+    RoutingProfileContext profileContext(_profile);
+    for (const auto& road : constOf(roads))
+    {
+        const auto rules = cachingContext.getRoadRules(road);
+        QCOMPARE(rules.accepted, profileContext.acceptsRoad(road));
+        QCOMPARE(rules.speed, profileContext.getSpeed(road));
+        QCOMPARE(rules.priority, profileContext.getSpeedPriority(road));
+        QVERIFY(rules.getDirection() == profileContext.getDirection(road));
+    }
+
+    // Residential, primary, oneway residential and footway, each one needs 4 rulesets to be evaluated
+    QCOMPARE(cachingContext.getCachedRoadRulesCount(), 4u);
+    QCOMPARE(cachingContext.getRulesEvaluationsCount(), static_cast<uint64_t>(4 * 4));
+    QCOMPARE(profileContext.getRulesEvaluationsCount(), static_cast<uint64_t>(roads.size() * 4));
+}
+
+QTEST_MAIN(TestRoutePlanner)
+#include "TestRoutePlanner.moc"
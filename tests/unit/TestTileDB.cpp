@@ -0,0 +1,177 @@
+#include <OsmAndCore/TileDB.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+using namespace OsmAnd;
+
+class TestTileDB : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        // Each file has square block of tiles, with tiles on diagonal missing
+        TilesPerSide = 12,
+        FirstFileX = 100,
+        SecondFileX = 200,
+        FirstY = 300,
+    };
+
+    QTemporaryDir _dir;
+
+    QString getDataPath() const;
+    static QByteArray makeTileData(const TileId tileId);
+    static bool isPresent(const TileId tileId);
+    bool createFile(const QString& name, const int firstX);
+private slots:
+    void initTestCase();
+    void obtainTileData();
+    void obtainTilesData();
+    void rebuildIndex();
+};
+
+QString TestTileDB::getDataPath() const
+{
+    return QDir(_dir.path()).absoluteFilePath(QLatin1String("data"));
+}
+
+QByteArray TestTileDB::makeTileData(const TileId tileId)
+{
+    return QString("%1/%2").arg(tileId.x).arg(tileId.y).toLatin1();
+}
+
+bool TestTileDB::isPresent(const TileId tileId)
+{
+    return (tileId.x % TilesPerSide) != ((tileId.y - FirstY) % TilesPerSide);
+}
+
+bool TestTileDB::createFile(const QString& name, const int firstX)
+{
+    bool ok = true;
+    {
+        auto db = QSqlDatabase::addDatabase("QSQLITE", name);
+        db.setDatabaseName(QDir(getDataPath()).absoluteFilePath(name));
+        ok = db.open();
+
+        QSqlQuery query(db);
+        ok = ok && query.exec("CREATE TABLE tiles (x INTEGER, y INTEGER, zoom INTEGER, data BLOB)");
+        ok = ok && query.exec("CREATE TABLE bounds (zoom INTEGER, xMin INTEGER, yMin INTEGER, xMax INTEGER, yMax INTEGER)");
+        ok = ok && query.exec(QString("INSERT INTO bounds VALUES (%1, %2, %3, %4, %5)")
+            .arg(static_cast<int>(ZoomLevel12))
+            .arg(firstX)
+            .arg(static_cast<int>(FirstY))
+            .arg(firstX + TilesPerSide - 1)
+            .arg(FirstY + TilesPerSide - 1));
+
+        QSqlQuery insertQuery(db);
+        ok = ok && insertQuery.prepare("INSERT INTO tiles (x, y, zoom, data) VALUES (?, ?, ?, ?)");
+        for (auto y = FirstY; ok && y < FirstY + TilesPerSide; y++)
+        {
+            for (auto x = firstX; ok && x < firstX + TilesPerSide; x++)
+            {
+                const auto tileId = TileId::fromXY(x, y);
+                if (!isPresent(tileId))
+                    continue;
+
+                insertQuery.addBindValue(x);
+                insertQuery.addBindValue(y);
+                insertQuery.addBindValue(static_cast<int>(ZoomLevel12));
+                insertQuery.addBindValue(makeTileData(tileId));
+                ok = insertQuery.exec();
+            }
+        }
+
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(name);
+
+    return ok;
+}
+
+void TestTileDB::initTestCase()
+{
+    QVERIFY(_dir.isValid());
+    QVERIFY(QDir(_dir.path()).mkpath(QLatin1String("data")));
+    QVERIFY(createFile(QLatin1String("first.sqlite"), FirstFileX));
+    QVERIFY(createFile(QLatin1String("second.sqlite"), SecondFileX));
+}
+
+void TestTileDB::obtainTileData()
+{
+    TileDB tileDb(getDataPath());
+    QByteArray data;
+
+    for (const auto firstX : { FirstFileX, SecondFileX })
+    {
+        for (auto y = FirstY; y < FirstY + TilesPerSide; y++)
+        {
+            for (auto x = firstX; x < firstX + TilesPerSide; x++)
+            {
+                const auto tileId = TileId::fromXY(x, y);
+                QCOMPARE(tileDb.obtainTileData(tileId, ZoomLevel12, data), isPresent(tileId));
+                if (isPresent(tileId))
+                    QCOMPARE(data, makeTileData(tileId));
+            }
+        }
+    }
+
+    // Outside of bounds and on other zoom
+    QVERIFY(!tileDb.obtainTileData(TileId::fromXY(FirstFileX - 1, FirstY), ZoomLevel12, data));
+    QVERIFY(!tileDb.obtainTileData(TileId::fromXY(FirstFileX + 1, FirstY), ZoomLevel13, data));
+}
+
+void TestTileDB::obtainTilesData()
+{
+    TileDB tileDb(getDataPath());
+
+    // More tiles than fit in one batch, from both files and with missing ones
+    QVector<TileId> tileIds;
+    int presentCount = 0;
+    for (const auto firstX : { FirstFileX, SecondFileX })
+    {
+        for (auto y = FirstY; y < FirstY + TilesPerSide; y++)
+        {
+            for (auto x = firstX; x < firstX + TilesPerSide; x++)
+            {
+                const auto tileId = TileId::fromXY(x, y);
+                tileIds.push_back(tileId);
+                if (isPresent(tileId))
+                    presentCount++;
+            }
+        }
+    }
+    tileIds.push_back(tileIds.first());
+    tileIds.push_back(TileId::fromXY(FirstFileX - 1, FirstY));
+    QVERIFY(tileIds.size() > TileDB::BatchSize);
+
+    QHash<TileId, QByteArray> tilesData;
+    QVERIFY(tileDb.obtainTilesData(tileIds, ZoomLevel12, tilesData));
+
+    for (const auto& tileId : constOf(tileIds))
+    {
+        QCOMPARE(tilesData.contains(tileId), isPresent(tileId));
+        if (isPresent(tileId))
+            QCOMPARE(tilesData.value(tileId), makeTileData(tileId));
+    }
+    QCOMPARE(tilesData.size(), presentCount);
+}
+
+void TestTileDB::rebuildIndex()
+{
+    TileDB tileDb(getDataPath());
+    const auto tileId = TileId::fromXY(SecondFileX + 1, FirstY);
+    QByteArray data;
+
+    QVERIFY(tileDb.obtainTileData(tileId, ZoomLevel12, data));
+    QVERIFY(tileDb.rebuildIndex());
+    QVERIFY(tileDb.obtainTileData(tileId, ZoomLevel12, data));
+    QCOMPARE(data, makeTileData(tileId));
+}
+
+QTEST_MAIN(TestTileDB)
+#include "TestTileDB.moc"
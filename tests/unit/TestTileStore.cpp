@@ -0,0 +1,225 @@
+#include <OsmAndCore/Map/FileTileStore.h>
+#include <OsmAndCore/Map/SqliteTileStore.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+
+using namespace OsmAnd;
+
+class TestTileStore : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray makeTileData(const int size, const char fill);
+    static void verifyRoundTrip(ITileStore& store);
+private slots:
+    void fileStore();
+    void sqliteStore();
+    void sqliteStoreReopen();
+    void sqliteStoreEviction();
+    void sqliteStoreExpiry();
+    void importDirectory();
+};
+
+QByteArray TestTileStore::makeTileData(const int size, const char fill)
+{
+    return QByteArray(size, fill);
+}
+
+void TestTileStore::verifyRoundTrip(ITileStore& store)
+{
+    const auto tileId = TileId::fromXY(1234, 567);
+    QByteArray data;
+    bool expired = true;
+
+    QVERIFY(!store.obtainTile(tileId, ZoomLevel12, data));
+
+    QVERIFY(store.storeTile(tileId, ZoomLevel12, makeTileData(1000, 'a')));
+    QVERIFY(store.obtainTile(tileId, ZoomLevel12, data, &expired));
+    QCOMPARE(data, makeTileData(1000, 'a'));
+    QVERIFY(!expired);
+    QVERIFY(!store.obtainTile(tileId, ZoomLevel13, data));
+
+    // Replaced tile must not be counted twice
+    QVERIFY(store.storeTile(tileId, ZoomLevel12, makeTileData(300, 'b')));
+    QVERIFY(store.obtainTile(tileId, ZoomLevel12, data));
+    QCOMPARE(data, makeTileData(300, 'b'));
+    QCOMPARE(store.getTotalSize(), static_cast<uint64_t>(300));
+
+    // Tile that does not exist is stored with empty data
+    const auto missingTileId = TileId::fromXY(0, 0);
+    QVERIFY(store.storeTile(missingTileId, ZoomLevel0, QByteArray()));
+    data = makeTileData(1, 'c');
+    QVERIFY(store.obtainTile(missingTileId, ZoomLevel0, data));
+    QVERIFY(data.isEmpty());
+
+    QVERIFY(store.removeTile(tileId, ZoomLevel12));
+    QVERIFY(!store.removeTile(tileId, ZoomLevel12));
+    QVERIFY(!store.obtainTile(tileId, ZoomLevel12, data));
+    QCOMPARE(store.getTotalSize(), static_cast<uint64_t>(0));
+}
+
+void TestTileStore::fileStore()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    FileTileStore store(dir.path());
+    verifyRoundTrip(store);
+    QVERIFY(QFile::exists(dir.path() + QLatin1String("/0/0/0.tile")));
+}
+
+void TestTileStore::sqliteStore()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    SqliteTileStore store(QDir(dir.path()).absoluteFilePath(QLatin1String("tiles.sqlitedb")));
+    QByteArray data;
+    QVERIFY(!store.storeTile(TileId::fromXY(0, 0), ZoomLevel0, makeTileData(1, 'a')));
+    QVERIFY(!store.obtainTile(TileId::fromXY(0, 0), ZoomLevel0, data));
+
+    QVERIFY(store.open());
+    verifyRoundTrip(store);
+    QCOMPARE(store.getTilesCount(), 1u);
+}
+
+void TestTileStore::sqliteStoreReopen()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto filename = QDir(dir.path()).absoluteFilePath(QLatin1String("tiles.sqlitedb"));
+
+    {
+        SqliteTileStore store(filename);
+        QVERIFY(store.open());
+        for (auto x = 0; x < 10; x++)
+            QVERIFY(store.storeTile(TileId::fromXY(x, 3), ZoomLevel5, makeTileData(100 + x, 'a' + x)));
+    }
+
+    SqliteTileStore store(filename);
+    QVERIFY(store.open());
+    QCOMPARE(store.getTilesCount(), 10u);
+    QCOMPARE(store.getTotalSize(), static_cast<uint64_t>(10 * 100 + 45));
+    for (auto x = 0; x < 10; x++)
+    {
+        QByteArray data;
+        QVERIFY(store.obtainTile(TileId::fromXY(x, 3), ZoomLevel5, data));
+        QCOMPARE(data, makeTileData(100 + x, 'a' + x));
+    }
+}
+
+void TestTileStore::sqliteStoreEviction()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto filename = QDir(dir.path()).absoluteFilePath(QLatin1String("tiles.sqlitedb"));
+
+    SqliteTileStore store(filename, 10 * 1000);
+    QVERIFY(store.open());
+    for (auto x = 0; x < 10; x++)
+        QVERIFY(store.storeTile(TileId::fromXY(x, 0), ZoomLevel10, makeTileData(1000, 'a')));
+    QCOMPARE(store.getEvictedTilesCount(), static_cast<uint64_t>(0));
+
+    // Tile 0 becomes most recently used, so tiles 1 and 2 are evicted to get to 90% of maximal size
+    QByteArray data;
+    QVERIFY(store.obtainTile(TileId::fromXY(0, 0), ZoomLevel10, data));
+    QVERIFY(store.storeTile(TileId::fromXY(10, 0), ZoomLevel10, makeTileData(1000, 'b')));
+
+    QCOMPARE(store.getEvictedTilesCount(), static_cast<uint64_t>(2));
+    QCOMPARE(store.getTilesCount(), 9u);
+    QCOMPARE(store.getTotalSize(), static_cast<uint64_t>(9 * 1000));
+    QVERIFY(store.obtainTile(TileId::fromXY(0, 0), ZoomLevel10, data));
+    QVERIFY(!store.obtainTile(TileId::fromXY(1, 0), ZoomLevel10, data));
+    QVERIFY(!store.obtainTile(TileId::fromXY(2, 0), ZoomLevel10, data));
+    for (auto x = 3; x <= 10; x++)
+        QVERIFY(store.obtainTile(TileId::fromXY(x, 0), ZoomLevel10, data));
+
+    // Access order must survive reopening
+    QVERIFY(store.obtainTile(TileId::fromXY(3, 0), ZoomLevel10, data));
+    store.close();
+    QVERIFY(store.open());
+    QVERIFY(store.storeTile(TileId::fromXY(11, 0), ZoomLevel10, makeTileData(2000, 'c')));
+    QVERIFY(store.obtainTile(TileId::fromXY(3, 0), ZoomLevel10, data));
+    QVERIFY(!store.obtainTile(TileId::fromXY(0, 0), ZoomLevel10, data));
+    QVERIFY(!store.obtainTile(TileId::fromXY(4, 0), ZoomLevel10, data));
+    QVERIFY(store.getTotalSize() <= static_cast<uint64_t>(9 * 1000));
+}
+
+void TestTileStore::sqliteStoreExpiry()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    SqliteTileStore store(QDir(dir.path()).absoluteFilePath(QLatin1String("tiles.sqlitedb")), SqliteTileStore::Unbounded, 1);
+    QVERIFY(store.open());
+    QVERIFY(store.storeTile(TileId::fromXY(1, 1), ZoomLevel1, makeTileData(10, 'a')));
+
+    QByteArray data;
+    bool expired = true;
+    QVERIFY(store.obtainTile(TileId::fromXY(1, 1), ZoomLevel1, data, &expired));
+    QVERIFY(!expired);
+
+    // Expired tile is still returned
+    QTest::qSleep(1100);
+    QVERIFY(store.obtainTile(TileId::fromXY(1, 1), ZoomLevel1, data, &expired));
+    QVERIFY(expired);
+    QCOMPARE(data, makeTileData(10, 'a'));
+
+    // Stored again, tile is fresh
+    QVERIFY(store.storeTile(TileId::fromXY(1, 1), ZoomLevel1, makeTileData(10, 'b')));
+    QVERIFY(store.obtainTile(TileId::fromXY(1, 1), ZoomLevel1, data, &expired));
+    QVERIFY(!expired);
+}
+
+void TestTileStore::importDirectory()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto cachePath = QDir(dir.path()).absoluteFilePath(QLatin1String("cache"));
+
+    FileTileStore fileStore(cachePath);
+    QVERIFY(fileStore.storeTile(TileId::fromXY(0, 0), ZoomLevel0, makeTileData(50, 'a')));
+    QVERIFY(fileStore.storeTile(TileId::fromXY(10, 20), ZoomLevel7, makeTileData(60, 'b')));
+    QVERIFY(fileStore.storeTile(TileId::fromXY(11, 20), ZoomLevel7, QByteArray()));
+
+    // Files that are not tiles of valid coordinates are left untouched
+    QVERIFY(QDir(cachePath).mkpath(QLatin1String("5/abc")));
+    QFile(cachePath + QLatin1String("/5/abc/1.tile")).open(QIODevice::WriteOnly);
+    QFile(cachePath + QLatin1String("/1/2/0.tile")).open(QIODevice::WriteOnly);
+    QFile(cachePath + QLatin1String("/readme.tile")).open(QIODevice::WriteOnly);
+
+    SqliteTileStore store(QDir(dir.path()).absoluteFilePath(QLatin1String("tiles.sqlitedb")));
+    QVERIFY(store.open());
+    unsigned int importedCount = 0;
+    QVERIFY(store.importDirectory(cachePath, true, &importedCount));
+    QCOMPARE(importedCount, 3u);
+    QCOMPARE(store.getTilesCount(), 3u);
+    QCOMPARE(store.getTotalSize(), static_cast<uint64_t>(110));
+
+    QByteArray data;
+    QVERIFY(store.obtainTile(TileId::fromXY(0, 0), ZoomLevel0, data));
+    QCOMPARE(data, makeTileData(50, 'a'));
+    QVERIFY(store.obtainTile(TileId::fromXY(10, 20), ZoomLevel7, data));
+    QCOMPARE(data, makeTileData(60, 'b'));
+    QVERIFY(store.obtainTile(TileId::fromXY(11, 20), ZoomLevel7, data));
+    QVERIFY(data.isEmpty());
+
+    QVERIFY(!QDir(cachePath).exists(QLatin1String("0")));
+    QVERIFY(!QDir(cachePath).exists(QLatin1String("7")));
+    QVERIFY(QFile::exists(cachePath + QLatin1String("/5/abc/1.tile")));
+    QVERIFY(QFile::exists(cachePath + QLatin1String("/1/2/0.tile")));
+    QVERIFY(QFile::exists(cachePath + QLatin1String("/readme.tile")));
+
+    // Import is one-shot
+    QVERIFY(store.importDirectory(cachePath, true, &importedCount));
+    QCOMPARE(importedCount, 0u);
+    QCOMPARE(store.getTilesCount(), 3u);
+}
+
+QTEST_MAIN(TestTileStore)
+#include "TestTileStore.moc"
@@ -0,0 +1,207 @@
+#include <OsmAndCore/Tracing.h>
+
+#include <thread>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTemporaryDir>
+
+using namespace OsmAnd;
+
+class TestTracing : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QJsonArray exportEvents();
+    static QList<QJsonObject> findSpans(const QJsonArray& events, const QString& name);
+private slots:
+    void cleanup();
+
+    void nestedSpans();
+    void spansOfDifferentThreads();
+    void notStarted();
+    void restartDiscardsSpans();
+    void fullBufferDropsSpans();
+    void saveToFile();
+};
+
+QJsonArray TestTracing::exportEvents()
+{
+    QJsonParseError error;
+    const auto document = QJsonDocument::fromJson(Tracer::exportChromeTrace(), &error);
+    if (error.error != QJsonParseError::NoError)
+        qWarning("Trace is not valid JSON: %s", qPrintable(error.errorString()));
+    return document.object().value(QLatin1String("traceEvents")).toArray();
+}
+
+QList<QJsonObject> TestTracing::findSpans(const QJsonArray& events, const QString& name)
+{
+    QList<QJsonObject> spans;
+    for (const auto& event : events)
+    {
+        const auto object = event.toObject();
+        if (object.value(QLatin1String("ph")).toString() == QLatin1String("X") &&
+            object.value(QLatin1String("name")).toString() == name)
+        {
+            spans.append(object);
+        }
+    }
+    return spans;
+}
+
+void TestTracing::cleanup()
+{
+    Tracer::stop();
+}
+
+void TestTracing::nestedSpans()
+{
+    Tracer::start();
+    QVERIFY(Tracer::isStarted());
+    {
+        OSMAND_TRACE_SCOPE("Test", "outer");
+        QTest::qSleep(2);
+        {
+            OSMAND_TRACE_SCOPE("Test", "inner \"quoted\"");
+            QTest::qSleep(2);
+        }
+    }
+    Tracer::stop();
+    QCOMPARE(Tracer::getRecordedSpansCount(), 2u);
+
+    const auto events = exportEvents();
+    const auto outerSpans = findSpans(events, QLatin1String("outer"));
+    const auto innerSpans = findSpans(events, QLatin1String("inner \"quoted\""));
+    QCOMPARE(outerSpans.size(), 1);
+    QCOMPARE(innerSpans.size(), 1);
+
+    const auto& outer = outerSpans.first();
+    const auto& inner = innerSpans.first();
+    QCOMPARE(outer.value(QLatin1String("cat")).toString(), QString(QLatin1String("Test")));
+    QCOMPARE(outer.value(QLatin1String("tid")).toInt(), inner.value(QLatin1String("tid")).toInt());
+    const auto outerBegin = outer.value(QLatin1String("ts")).toDouble();
+    const auto outerEnd = outerBegin + outer.value(QLatin1String("dur")).toDouble();
+    const auto innerBegin = inner.value(QLatin1String("ts")).toDouble();
+    const auto innerEnd = innerBegin + inner.value(QLatin1String("dur")).toDouble();
+    QVERIFY(outerBegin >= 0.0);
+    QVERIFY(innerBegin >= outerBegin);
+    QVERIFY(innerEnd <= outerEnd);
+    // Timestamps are in microseconds
+    QVERIFY(inner.value(QLatin1String("dur")).toDouble() >= 1000.0);
+}
+
+void TestTracing::spansOfDifferentThreads()
+{
+    Tracer::start();
+    {
+        OSMAND_TRACE_SCOPE("Test", "main");
+        std::thread thread(
+            []
+            ()
+            {
+                OSMAND_TRACE_SCOPE("Test", "worker");
+            });
+        thread.join();
+    }
+    Tracer::stop();
+
+    const auto events = exportEvents();
+    const auto mainSpans = findSpans(events, QLatin1String("main"));
+    const auto workerSpans = findSpans(events, QLatin1String("worker"));
+    QCOMPARE(mainSpans.size(), 1);
+    QCOMPARE(workerSpans.size(), 1);
+    const auto mainTid = mainSpans.first().value(QLatin1String("tid")).toInt();
+    const auto workerTid = workerSpans.first().value(QLatin1String("tid")).toInt();
+    QVERIFY(mainTid != workerTid);
+
+    // Each thread is named with metadata event
+    auto threadNamesCount = 0;
+    for (const auto& event : events)
+    {
+        const auto object = event.toObject();
+        if (object.value(QLatin1String("ph")).toString() == QLatin1String("M"))
+        {
+            QCOMPARE(object.value(QLatin1String("name")).toString(), QString(QLatin1String("thread_name")));
+            threadNamesCount++;
+        }
+    }
+    QCOMPARE(threadNamesCount, 2);
+}
+
+void TestTracing::notStarted()
+{
+    Tracer::start();
+    Tracer::stop();
+    QVERIFY(!Tracer::isStarted());
+    {
+        OSMAND_TRACE_SCOPE("Test", "ignored");
+    }
+    QCOMPARE(Tracer::getRecordedSpansCount(), 0u);
+
+    // Span that began before tracer was started is not recorded either
+    {
+        OSMAND_TRACE_SCOPE("Test", "ignored");
+        Tracer::start();
+    }
+    QCOMPARE(Tracer::getRecordedSpansCount(), 0u);
+}
+
+void TestTracing::restartDiscardsSpans()
+{
+    Tracer::start();
+    {
+        OSMAND_TRACE_SCOPE("Test", "first");
+    }
+    QCOMPARE(Tracer::getRecordedSpansCount(), 1u);
+
+    Tracer::start();
+    QCOMPARE(Tracer::getRecordedSpansCount(), 0u);
+    {
+        OSMAND_TRACE_SCOPE("Test", "second");
+    }
+
+    const auto events = exportEvents();
+    QCOMPARE(findSpans(events, QLatin1String("first")).size(), 0);
+    QCOMPARE(findSpans(events, QLatin1String("second")).size(), 1);
+}
+
+void TestTracing::fullBufferDropsSpans()
+{
+    Tracer::start();
+    const auto overflowCount = 10u;
+    for (auto spanIndex = 0u; spanIndex < Tracer::ThreadBufferCapacity + overflowCount; spanIndex++)
+    {
+        OSMAND_TRACE_SCOPE("Test", "span");
+    }
+    Tracer::stop();
+
+    QCOMPARE(Tracer::getRecordedSpansCount(), static_cast<unsigned int>(Tracer::ThreadBufferCapacity));
+    QCOMPARE(Tracer::getDroppedSpansCount(), static_cast<uint64_t>(overflowCount));
+}
+
+void TestTracing::saveToFile()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const auto filename = tempDir.path() + QLatin1String("/trace.json");
+
+    Tracer::start();
+    {
+        OSMAND_TRACE_SCOPE("Test", "saved");
+    }
+    Tracer::stop();
+    QVERIFY(Tracer::saveChromeTrace(filename));
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const auto document = QJsonDocument::fromJson(file.readAll());
+    const auto events = document.object().value(QLatin1String("traceEvents")).toArray();
+    QCOMPARE(findSpans(events, QLatin1String("saved")).size(), 1);
+}
+
+QTEST_MAIN(TestTracing)
+#include "TestTracing.moc"
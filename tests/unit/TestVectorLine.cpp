@@ -0,0 +1,175 @@
+#include <cstring>
+
+#include <OsmAndCore/Map/MapRendererState.h>
+#include <OsmAndCore/Map/OnSurfaceVectorMapSymbol.h>
+#include <OsmAndCore/Map/VectorLine.h>
+#include <OsmAndCore/Map/VectorLineBuilder.h>
+#include <OsmAndCore/Map/VectorLinesCollection.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+
+using namespace OsmAnd;
+
+class TestVectorLine : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        // Few simplification chunks are covered
+        PointsCount = 2000,
+        // Polyline goes through tiles of this zoom
+        LineZoom = 15,
+        LineTileX = 17000,
+        LineTileY = 11000,
+        LineTilesCount = 4,
+        // Deviation of each other point from straight line, it's below pixel at low zooms and above it at high ones
+        Jitter31 = 1000,
+        LineWidth = 10,
+    };
+
+    static QVector<PointI> createPoints();
+    static std::shared_ptr<VectorLine> createLine(const QVector<PointI>& points);
+    static MapState createMapState(const ZoomLevel zoomLevel, const PointI& target31);
+    static std::shared_ptr<const VectorMapSymbol::VerticesAndIndexes> getVerticesAndIndexes(
+        const std::shared_ptr<VectorLine::SymbolsGroup>& symbolsGroup);
+private slots:
+    void appendedPoints();
+    void simplified();
+    void clipped();
+};
+
+QVector<PointI> TestVectorLine::createPoints()
+{
+    QVector<PointI> points;
+    const auto tileSize31 = 1 << (ZoomLevel31 - LineZoom);
+    const auto x0 = LineTileX * tileSize31;
+    const auto y0 = LineTileY * tileSize31 + tileSize31 / 2;
+    for (auto pointIdx = 0; pointIdx < PointsCount; pointIdx++)
+    {
+        points.push_back(PointI(
+            x0 + static_cast<int32_t>(static_cast<int64_t>(pointIdx) * LineTilesCount * tileSize31 / PointsCount),
+            y0 + (pointIdx % 2) * Jitter31));
+    }
+    return points;
+}
+
+std::shared_ptr<VectorLine> TestVectorLine::createLine(const QVector<PointI>& points)
+{
+    const auto collection = std::make_shared<VectorLinesCollection>();
+    VectorLineBuilder builder;
+    builder
+        .setLineId(1)
+        .setBaseOrder(1000)
+        .setLineWidth(LineWidth)
+        .setFillColor(FColorARGB(1.0f, 1.0f, 0.0f, 0.0f))
+        .setPoints(points);
+    return builder.buildAndAddToCollection(collection);
+}
+
+MapState TestVectorLine::createMapState(const ZoomLevel zoomLevel, const PointI& target31)
+{
+    MapState mapState;
+    mapState.zoomLevel = zoomLevel;
+    mapState.target31 = target31;
+    return mapState;
+}
+
+std::shared_ptr<const VectorMapSymbol::VerticesAndIndexes> TestVectorLine::getVerticesAndIndexes(
+    const std::shared_ptr<VectorLine::SymbolsGroup>& symbolsGroup)
+{
+    if (!symbolsGroup || symbolsGroup->symbols.size() != 1)
+        return nullptr;
+
+    const auto symbol = std::dynamic_pointer_cast<const OnSurfaceVectorMapSymbol>(symbolsGroup->symbols.first());
+    if (!symbol)
+        return nullptr;
+    return symbol->getVerticesAndIndexes();
+}
+
+void TestVectorLine::appendedPoints()
+{
+    const auto points = createPoints();
+    const auto mapState = createMapState(ZoomLevel16, points[PointsCount / 2]);
+
+    const auto line = createLine(points);
+    QVERIFY(line);
+    const auto verticesAndIndexes = getVerticesAndIndexes(line->createSymbolsGroup(mapState));
+    QVERIFY(verticesAndIndexes);
+
+    // Line grows by portions that don't match simplification chunks, yet result is the same as for all points at once
+    const auto growingLine = createLine(points.mid(0, 700));
+    QVERIFY(growingLine);
+    const auto symbolsGroup = growingLine->createSymbolsGroup(mapState);
+    growingLine->appendPoints(points.mid(700, 600));
+    symbolsGroup->update(mapState);
+    growingLine->appendPoints(points.mid(1300));
+    QVERIFY(growingLine->hasUnappliedChanges());
+    symbolsGroup->update(mapState);
+    QVERIFY(!growingLine->hasUnappliedChanges());
+    QVERIFY(growingLine->getPoints() == points);
+
+    const auto growingVerticesAndIndexes = getVerticesAndIndexes(symbolsGroup);
+    QVERIFY(growingVerticesAndIndexes);
+    QCOMPARE(growingVerticesAndIndexes->verticesCount, verticesAndIndexes->verticesCount);
+    QVERIFY(std::memcmp(
+        growingVerticesAndIndexes->vertices,
+        verticesAndIndexes->vertices,
+        verticesAndIndexes->verticesCount * sizeof(VectorMapSymbol::Vertex)) == 0);
+}
+
+void TestVectorLine::simplified()
+{
+    const auto points = createPoints();
+    const auto line = createLine(points);
+    QVERIFY(line);
+
+    // Jitter is far below pixel, so almost all points are dropped
+    const auto zoom5VerticesAndIndexes = getVerticesAndIndexes(
+        line->createSymbolsGroup(createMapState(ZoomLevel5, points[PointsCount / 2])));
+    QVERIFY(zoom5VerticesAndIndexes);
+    QVERIFY(zoom5VerticesAndIndexes->verticesCount > 3);
+    QVERIFY(zoom5VerticesAndIndexes->verticesCount < PointsCount / 10);
+
+    // Jitter is bigger than pixel, so every point in clip area is kept
+    const auto zoom20VerticesAndIndexes = getVerticesAndIndexes(
+        line->createSymbolsGroup(createMapState(ZoomLevel20, points[PointsCount / 2])));
+    QVERIFY(zoom20VerticesAndIndexes);
+    QVERIFY(zoom20VerticesAndIndexes->verticesCount > PointsCount / 4);
+}
+
+void TestVectorLine::clipped()
+{
+    const auto points = createPoints();
+    const auto line = createLine(points);
+    QVERIFY(line);
+
+    // Clip area at zoom 20 is smaller than line, so only part of it is tessellated
+    const auto middleVerticesAndIndexes = getVerticesAndIndexes(
+        line->createSymbolsGroup(createMapState(ZoomLevel20, points[PointsCount / 2])));
+    const auto startVerticesAndIndexes = getVerticesAndIndexes(
+        line->createSymbolsGroup(createMapState(ZoomLevel20, points.first())));
+    QVERIFY(middleVerticesAndIndexes);
+    QVERIFY(startVerticesAndIndexes);
+    QVERIFY(startVerticesAndIndexes->verticesCount < middleVerticesAndIndexes->verticesCount);
+
+    // Line is away from clip area, so only stub mesh is there
+    const auto tileSize31 = 1 << (ZoomLevel31 - LineZoom);
+    const auto farVerticesAndIndexes = getVerticesAndIndexes(
+        line->createSymbolsGroup(createMapState(ZoomLevel20, points.first() - PointI(tileSize31, tileSize31))));
+    QVERIFY(farVerticesAndIndexes);
+    QCOMPARE(farVerticesAndIndexes->verticesCount, 3u);
+
+    // Moving target within clip area keeps geometry, while moving it further updates it
+    const auto symbolsGroup = line->createSymbolsGroup(createMapState(ZoomLevel20, points[PointsCount / 2]));
+    const auto tileSize31AtZoom20 = 1 << (ZoomLevel31 - ZoomLevel20);
+    QVERIFY(symbolsGroup->update(createMapState(ZoomLevel20, points[PointsCount / 2] + PointI(tileSize31AtZoom20, 0))) ==
+        IUpdatableMapSymbolsGroup::UpdateResult::None);
+    QVERIFY(symbolsGroup->update(createMapState(ZoomLevel20, points.first())) !=
+        IUpdatableMapSymbolsGroup::UpdateResult::None);
+    QCOMPARE(getVerticesAndIndexes(symbolsGroup)->verticesCount, startVerticesAndIndexes->verticesCount);
+}
+
+QTEST_MAIN(TestVectorLine)
+#include "TestVectorLine.moc"
@@ -0,0 +1,171 @@
+#include <OsmAndCore/WebClient.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+
+#include "LoopbackHttpServer.h"
+
+using namespace OsmAnd;
+
+class TestWebClient : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum {
+        RequestsCount = 50,
+        ResponseDelayMs = 5,
+        PayloadSize = 1024,
+        TimeoutMs = 10000,
+    };
+
+    std::unique_ptr<LoopbackHttpServer> _server;
+
+    QString getUrl(const QString& path) const;
+private slots:
+    void initTestCase();
+    void init();
+    void downloadDataAsync();
+    void perHostRequestsLimit();
+    void callback();
+    void httpError();
+    void cancel();
+};
+
+QString TestWebClient::getUrl(const QString& path) const
+{
+    return _server->getBaseUrl() + path;
+}
+
+void TestWebClient::initTestCase()
+{
+    _server.reset(new LoopbackHttpServer(ResponseDelayMs, PayloadSize));
+    QVERIFY(_server->startListening());
+}
+
+void TestWebClient::init()
+{
+    _server->resetCounters();
+}
+
+// Sequential requests go through same kept-alive connection
+void TestWebClient::downloadDataAsync()
+{
+    WebClient webClient;
+    for (auto requestIdx = 0; requestIdx < RequestsCount; requestIdx++)
+    {
+        const auto path = QString(QLatin1String("/tile/%1")).arg(requestIdx);
+        const auto request = webClient.downloadDataAsync(getUrl(path));
+        QVERIFY(request->waitUntilFinished(TimeoutMs));
+
+        const auto requestResult = std::dynamic_pointer_cast<const IWebClient::IHttpRequestResult>(
+            request->getRequestResult());
+        QVERIFY(requestResult);
+        QVERIFY(requestResult->isSuccessful());
+        QCOMPARE(requestResult->getHttpStatusCode(), 200u);
+        QCOMPARE(request->getData(), LoopbackHttpServer::getExpectedBody(path.toLatin1(), PayloadSize));
+    }
+
+    QCOMPARE(_server->getRequestsCount(), static_cast<int>(RequestsCount));
+    QCOMPARE(_server->getConnectionsCount(), 1);
+}
+
+void TestWebClient::perHostRequestsLimit()
+{
+    WebClient webClient;
+    webClient.setPerHostRequestsLimit(2);
+
+    QList< std::shared_ptr<WebClient::AsyncRequest> > requests;
+    for (auto requestIdx = 0; requestIdx < RequestsCount; requestIdx++)
+        requests.append(webClient.downloadDataAsync(getUrl(QString(QLatin1String("/tile/%1")).arg(requestIdx))));
+    for (auto requestIdx = 0; requestIdx < RequestsCount; requestIdx++)
+    {
+        const auto& request = requests[requestIdx];
+        QVERIFY(request->waitUntilFinished(TimeoutMs));
+        QVERIFY(request->getRequestResult());
+        QVERIFY(request->getRequestResult()->isSuccessful());
+        QCOMPARE(request->getData(), LoopbackHttpServer::getExpectedBody(
+            QString(QLatin1String("/tile/%1")).arg(requestIdx).toLatin1(), PayloadSize));
+    }
+
+    QCOMPARE(_server->getRequestsCount(), static_cast<int>(RequestsCount));
+    QVERIFY(_server->getMaxRequestsInProgressCount() <= 2);
+    QVERIFY(_server->getConnectionsCount() <= 2);
+}
+
+void TestWebClient::callback()
+{
+    WebClient webClient;
+
+    QAtomicInt succeededCount;
+    QList< std::shared_ptr<WebClient::AsyncRequest> > requests;
+    for (auto requestIdx = 0; requestIdx < RequestsCount; requestIdx++)
+    {
+        const auto expectedData = LoopbackHttpServer::getExpectedBody(
+            QString(QLatin1String("/tile/%1")).arg(requestIdx).toLatin1(), PayloadSize);
+        requests.append(webClient.downloadDataAsync(getUrl(QString(QLatin1String("/tile/%1")).arg(requestIdx)),
+            [&succeededCount, expectedData]
+            (const QByteArray& data, const std::shared_ptr<const IWebClient::IRequestResult>& requestResult)
+            {
+                if (requestResult && requestResult->isSuccessful() && data == expectedData)
+                    succeededCount.fetchAndAddOrdered(1);
+            }));
+    }
+    for (const auto& request : requests)
+        QVERIFY(request->waitUntilFinished(TimeoutMs));
+
+    QCOMPARE(succeededCount.loadAcquire(), static_cast<int>(RequestsCount));
+}
+
+void TestWebClient::httpError()
+{
+    WebClient webClient;
+
+    const auto request = webClient.downloadDataAsync(getUrl(QLatin1String("/status/404")));
+    QVERIFY(request->waitUntilFinished(TimeoutMs));
+
+    const auto requestResult = std::dynamic_pointer_cast<const IWebClient::IHttpRequestResult>(
+        request->getRequestResult());
+    QVERIFY(requestResult);
+    QVERIFY(!requestResult->isSuccessful());
+    QCOMPARE(requestResult->getHttpStatusCode(), 404u);
+    QVERIFY(request->getData().isEmpty());
+
+    // HTTP errors are not retried
+    QCOMPARE(_server->getRequestsCount(), 1);
+}
+
+void TestWebClient::cancel()
+{
+    WebClient webClient;
+    webClient.setPerHostRequestsLimit(1);
+
+    const auto hangingRequest = webClient.downloadDataAsync(getUrl(QLatin1String("/hang")));
+    const auto queuedRequest = webClient.downloadDataAsync(getUrl(QLatin1String("/tile/queued")));
+    QVERIFY(!hangingRequest->waitUntilFinished(100));
+    QVERIFY(!queuedRequest->isFinished());
+
+    // Queued request is dropped without being sent
+    queuedRequest->cancel();
+    QVERIFY(queuedRequest->isCancelled());
+    QVERIFY(queuedRequest->waitUntilFinished(TimeoutMs));
+    QVERIFY(!queuedRequest->getRequestResult());
+
+    // Request in progress is aborted
+    hangingRequest->cancel();
+    QVERIFY(hangingRequest->waitUntilFinished(TimeoutMs));
+    QVERIFY(hangingRequest->getRequestResult());
+    QVERIFY(!hangingRequest->getRequestResult()->isSuccessful());
+    QCOMPARE(_server->getRequestsCount(), 1);
+
+    // Requests that are still pending when client is destroyed are finished
+    std::shared_ptr<WebClient::AsyncRequest> pendingRequest;
+    {
+        WebClient otherWebClient;
+        pendingRequest = otherWebClient.downloadDataAsync(getUrl(QLatin1String("/hang")));
+    }
+    QVERIFY(pendingRequest->isFinished());
+}
+
+QTEST_MAIN(TestWebClient)
+#include "TestWebClient.moc"
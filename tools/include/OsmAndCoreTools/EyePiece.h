@@ -56,6 +56,8 @@ namespace OsmAndTools
             float mapScale;
             float symbolsScale;
             QString locale;
+            // If set, Chrome trace of rendering is saved there
+            QString traceFilename;
             bool verbose;
 #if defined(OSMAND_TARGET_OS_linux)
             bool useLegacyContext;
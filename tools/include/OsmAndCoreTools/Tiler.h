@@ -0,0 +1,131 @@
+#ifndef _OSMAND_CORE_TOOLS_TILER_H_
+#define _OSMAND_CORE_TOOLS_TILER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <iostream>
+#include <sstream>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QStringList>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PointsAndAreas.h>
+#include <OsmAndCore/IObfsCollection.h>
+#include <OsmAndCore/Map/IMapStylesCollection.h>
+
+#include <OsmAndCoreTools.h>
+
+class SkImageEncoder;
+
+namespace OsmAndTools
+{
+    class OSMAND_CORE_TOOLS_API Tiler Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(Tiler);
+
+    public:
+        enum class ImageFormat
+        {
+            PNG,
+            JPEG,
+            WebP
+        };
+
+        enum class OutputFormat
+        {
+            // <outputPath>/<zoom>/<x>/<y>.<extension>
+            Directory,
+
+            // Single SQLite file following MBTiles 1.1 schema (TMS row numbering)
+            MBTiles
+        };
+
+        struct OSMAND_CORE_TOOLS_API Configuration Q_DECL_FINAL
+        {
+            Configuration();
+
+            std::shared_ptr<OsmAnd::IObfsCollection> obfsCollection;
+            std::shared_ptr<OsmAnd::IMapStylesCollection> stylesCollection;
+            QString styleName;
+            QHash< QString, QString > styleSettings;
+            OsmAnd::AreaI bbox31;
+            OsmAnd::ZoomLevel minZoom;
+            OsmAnd::ZoomLevel maxZoom;
+            unsigned int referenceTileSize;
+            float displayDensityFactor;
+            float mapScale;
+            float symbolsScale;
+            QString locale;
+            QString outputPath;
+            OutputFormat outputFormat;
+            ImageFormat outputImageFormat;
+            int outputImageQuality;
+            unsigned int threadsCount;
+            bool metrics;
+            bool verbose;
+
+            static bool parseFromCommandLineArguments(
+                const QStringList& commandLineArgs,
+                Configuration& outConfiguration,
+                QString& outError);
+        };
+
+        struct OSMAND_CORE_TOOLS_API Statistics Q_DECL_FINAL
+        {
+            Statistics();
+
+            uint64_t tilesTotal;
+            unsigned int tilesRendered;
+            unsigned int tilesEmpty;
+            unsigned int tilesFailed;
+            uint64_t bytesWritten;
+
+            // Wall-clock time of entire run
+            float elapsedTime;
+
+            // Per-stage times summed over all worker threads, taken from *_Metrics structures
+            float elapsedTimeForObtainingMapObjects;
+            float elapsedTimeForPrimitivisation;
+            float elapsedTimeForRasterization;
+            float elapsedTimeForObtainingRasterTile;
+            float elapsedTimeForEncoding;
+            float elapsedTimeForWriting;
+
+            // Peak resident set size of the process, in bytes (0 if not available)
+            uint64_t peakResidentSetSize;
+
+            float getTilesPerSecond() const;
+            QString toString(const QString& prefix = QString::null) const;
+        };
+
+    private:
+#if defined(_UNICODE) || defined(UNICODE)
+        bool generate(Statistics& outStatistics, std::wostream& output);
+#else
+        bool generate(Statistics& outStatistics, std::ostream& output);
+#endif
+
+        static SkImageEncoder* createImageEncoder(const ImageFormat imageFormat);
+    protected:
+    public:
+        Tiler(const Configuration& configuration);
+        ~Tiler();
+
+        const Configuration configuration;
+
+        bool generate(Statistics* const pOutStatistics = nullptr, QString *pLog = nullptr);
+
+        static uint64_t getPeakResidentSetSize();
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TOOLS_TILER_H_)
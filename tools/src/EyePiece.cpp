@@ -8,6 +8,7 @@
 #include <OsmAndCore.h>
 #include <OsmAndCore/ObfsCollection.h>
 #include <OsmAndCore/Stopwatch.h>
+#include <OsmAndCore/Tracing.h>
 #include <OsmAndCore/Utilities.h>
 #include <OsmAndCore/CoreResourcesEmbeddedBundle.h>
 #include <OsmAndCore/Map/IMapRenderer.h>
@@ -957,6 +958,8 @@ bool OsmAndTools::EyePiece::rasterize(std::ostream& output)
         // Repeat processing and rendering until everything is complete
         if (configuration.verbose)
             output << xT("Rendering frames...") << std::endl;
+        if (!configuration.traceFilename.isEmpty())
+            OsmAnd::Tracer::start();
         OsmAnd::Stopwatch renderingStopwatch(true);
         auto framesCounter = 0u;
         bool wasInterrupted = false;
@@ -1009,6 +1012,25 @@ bool OsmAndTools::EyePiece::rasterize(std::ostream& output)
         glFinish();
         glVerifyResult(output);
 
+        // Save trace of everything that was done to render image
+        if (!configuration.traceFilename.isEmpty())
+        {
+            OsmAnd::Tracer::stop();
+            if (configuration.verbose)
+            {
+                output
+                    << xT("Saving trace of ") << OsmAnd::Tracer::getRecordedSpansCount() << xT(" spans (")
+                    << OsmAnd::Tracer::getDroppedSpansCount() << xT(" dropped) to '")
+                    << QStringToStlString(configuration.traceFilename) << xT("'...") << std::endl;
+            }
+            if (!OsmAnd::Tracer::saveChromeTrace(configuration.traceFilename))
+            {
+                output << xT("Failed to save trace to '") << QStringToStlString(configuration.traceFilename) << xT("'") << std::endl;
+
+                success = false;
+            }
+        }
+
         // Release rendering
         if (configuration.verbose)
             output << xT("Releasing rendering...") << std::endl;
@@ -1478,6 +1500,12 @@ bool OsmAndTools::EyePiece::Configuration::parseFromCommandLineArguments(
 
             outConfiguration.locale = value;
         }
+        else if (arg.startsWith(QLatin1String("-traceFilename=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-traceFilename=")));
+
+            outConfiguration.traceFilename = value;
+        }
         else if (arg == QLatin1String("-verbose"))
         {
             outConfiguration.verbose = true;
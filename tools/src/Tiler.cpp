@@ -0,0 +1,931 @@
+#include "Tiler.h"
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <iomanip>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QVector>
+#include <QList>
+#include <QByteArray>
+#include <QFileInfo>
+#include <QtSql>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/ObfsCollection.h>
+#include <OsmAndCore/Stopwatch.h>
+#include <OsmAndCore/Utilities.h>
+#include <OsmAndCore/QRunnableFunctor.h>
+#include <OsmAndCore/QKeyValueIterator.h>
+#include <OsmAndCore/Map/MapStylesCollection.h>
+#include <OsmAndCore/Map/MapPresentationEnvironment.h>
+#include <OsmAndCore/Map/MapPrimitiviser.h>
+#include <OsmAndCore/Map/MapPrimitiviser_Metrics.h>
+#include <OsmAndCore/Map/ObfMapObjectsProvider.h>
+#include <OsmAndCore/Map/ObfMapObjectsProvider_Metrics.h>
+#include <OsmAndCore/Map/MapPrimitivesProvider.h>
+#include <OsmAndCore/Map/MapRasterLayerProvider_Software.h>
+#include <OsmAndCore/Map/MapRasterLayerProvider_Metrics.h>
+#include <OsmAndCore/Map/MapRasterizer_Metrics.h>
+
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#if defined(OSMAND_TARGET_OS_windows)
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#   include <psapi.h>
+#else
+#   include <sys/resource.h>
+#endif
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <SkBitmap.h>
+#include <SkImageEncoder.h>
+#include <SkData.h>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCoreTools.h>
+#include <OsmAndCoreTools/Utilities.h>
+
+namespace OsmAndTools
+{
+    // Tiles of single zoom are handed out by index of cursor: column-major order inside bbox of that zoom
+    struct TilerZoomRange
+    {
+        OsmAnd::ZoomLevel zoom;
+        int32_t left;
+        int32_t top;
+        uint64_t rowsCount;
+        uint64_t tilesCount;
+        QAtomicInteger<quint64> nextTileIndex;
+    };
+
+    struct TilerEncodedTile
+    {
+        OsmAnd::TileId tileId;
+        OsmAnd::ZoomLevel zoom;
+        QByteArray data;
+    };
+}
+
+OsmAndTools::Tiler::Tiler(const Configuration& configuration_)
+    : configuration(configuration_)
+{
+}
+
+OsmAndTools::Tiler::~Tiler()
+{
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Tiler::generate(Statistics& outStatistics, std::wostream& output)
+#else
+bool OsmAndTools::Tiler::generate(Statistics& outStatistics, std::ostream& output)
+#endif
+{
+    outStatistics = Statistics();
+    OsmAnd::Stopwatch totalStopwatch(true);
+
+    // Find style
+    if (configuration.verbose)
+        output << xT("Resolving style '") << QStringToStlString(configuration.styleName) << xT("'...") << std::endl;
+    const auto mapStyle = configuration.stylesCollection->getResolvedStyleByName(configuration.styleName);
+    if (!mapStyle)
+    {
+        output << "Failed to resolve style '" << QStringToStlString(configuration.styleName) << "' from collection" << std::endl;
+        return false;
+    }
+
+    // Find out ranges of tiles that have to be generated. Tiles themselves are not collected,
+    // since count of them grows 4 times per zoom and doesn't fit into memory on high zooms
+    QVector<TilerZoomRange> zoomRanges;
+    uint64_t tilesTotal = 0;
+    for (int zoom = configuration.minZoom; zoom <= configuration.maxZoom; zoom++)
+    {
+        const auto zoomShift = OsmAnd::ZoomLevel31 - zoom;
+        const auto tilesMaxIndex = static_cast<int32_t>((1u << zoom) - 1);
+        const auto left = qBound(0, configuration.bbox31.left() >> zoomShift, tilesMaxIndex);
+        const auto right = qBound(0, configuration.bbox31.right() >> zoomShift, tilesMaxIndex);
+        const auto top = qBound(0, configuration.bbox31.top() >> zoomShift, tilesMaxIndex);
+        const auto bottom = qBound(0, configuration.bbox31.bottom() >> zoomShift, tilesMaxIndex);
+
+        TilerZoomRange zoomRange;
+        zoomRange.zoom = static_cast<OsmAnd::ZoomLevel>(zoom);
+        zoomRange.left = left;
+        zoomRange.top = top;
+        zoomRange.rowsCount = static_cast<uint64_t>(bottom - top) + 1;
+        zoomRange.tilesCount = (static_cast<uint64_t>(right - left) + 1) * zoomRange.rowsCount;
+        zoomRange.nextTileIndex.store(0);
+        zoomRanges.push_back(zoomRange);
+        tilesTotal += zoomRange.tilesCount;
+    }
+    outStatistics.tilesTotal = tilesTotal;
+    if (configuration.verbose)
+    {
+        output
+            << xT("Going to generate ")
+            << tilesTotal
+            << xT(" tiles for zooms ")
+            << configuration.minZoom
+            << xT("-")
+            << configuration.maxZoom
+            << xT(" using ")
+            << configuration.threadsCount
+            << xT(" threads") << std::endl;
+    }
+
+    // Prepare output
+    QString imageExtension;
+    QString mbtilesFormat;
+    switch (configuration.outputImageFormat)
+    {
+        case ImageFormat::PNG:
+            imageExtension = QLatin1String("png");
+            mbtilesFormat = QLatin1String("png");
+            break;
+        case ImageFormat::JPEG:
+            imageExtension = QLatin1String("jpg");
+            mbtilesFormat = QLatin1String("jpg");
+            break;
+        case ImageFormat::WebP:
+            imageExtension = QLatin1String("webp");
+            mbtilesFormat = QLatin1String("webp");
+            break;
+    }
+    {
+        // Check that encoder is actually available in this build
+        std::unique_ptr<SkImageEncoder> imageEncoder(createImageEncoder(configuration.outputImageFormat));
+        if (!imageEncoder)
+        {
+            output << xT("Image encoder for '") << QStringToStlString(imageExtension) << xT("' is not available") << std::endl;
+            return false;
+        }
+    }
+
+    const auto mbtilesConnectionName = QString(QLatin1String("tiler-mbtiles:%1")).arg(configuration.outputPath);
+    QSqlDatabase mbtilesDb;
+    std::unique_ptr<QSqlQuery> insertTileQuery;
+    if (configuration.outputFormat == OutputFormat::MBTiles)
+    {
+        QFileInfo(configuration.outputPath).absoluteDir().mkpath(QLatin1String("."));
+
+        mbtilesDb = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), mbtilesConnectionName);
+        mbtilesDb.setDatabaseName(configuration.outputPath);
+        if (!mbtilesDb.open())
+        {
+            output << xT("Failed to open '") << QStringToStlString(configuration.outputPath) << xT("'") << std::endl;
+            mbtilesDb = QSqlDatabase();
+            QSqlDatabase::removeDatabase(mbtilesConnectionName);
+            return false;
+        }
+
+        QSqlQuery q(mbtilesDb);
+        q.exec(QLatin1String("PRAGMA synchronous = OFF"));
+        q.exec(QLatin1String("PRAGMA journal_mode = MEMORY"));
+        q.exec(QLatin1String("CREATE TABLE IF NOT EXISTS metadata (name TEXT, value TEXT)"));
+        q.exec(QLatin1String(
+            "CREATE TABLE IF NOT EXISTS tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)"));
+        q.exec(QLatin1String(
+            "CREATE UNIQUE INDEX IF NOT EXISTS tile_index ON tiles (zoom_level, tile_column, tile_row)"));
+        q.exec(QLatin1String("DELETE FROM metadata"));
+
+        const auto topLeft = OsmAnd::Utilities::convert31ToLatLon(configuration.bbox31.topLeft);
+        const auto bottomRight = OsmAnd::Utilities::convert31ToLatLon(configuration.bbox31.bottomRight);
+        QHash<QString, QString> metadata;
+        metadata[QLatin1String("name")] = configuration.styleName;
+        metadata[QLatin1String("type")] = QLatin1String("baselayer");
+        metadata[QLatin1String("version")] = QLatin1String("1.1");
+        metadata[QLatin1String("description")] = QLatin1String("Generated by OsmAnd Tiler");
+        metadata[QLatin1String("format")] = mbtilesFormat;
+        metadata[QLatin1String("minzoom")] = QString::number(configuration.minZoom);
+        metadata[QLatin1String("maxzoom")] = QString::number(configuration.maxZoom);
+        metadata[QLatin1String("bounds")] = QString(QLatin1String("%1,%2,%3,%4"))
+            .arg(topLeft.longitude)
+            .arg(bottomRight.latitude)
+            .arg(bottomRight.longitude)
+            .arg(topLeft.latitude);
+        QSqlQuery insertMetadataQuery(mbtilesDb);
+        insertMetadataQuery.prepare(QLatin1String("INSERT INTO metadata (name, value) VALUES (?, ?)"));
+        for (const auto& metadataEntry : OsmAnd::rangeOf(OsmAnd::constOf(metadata)))
+        {
+            insertMetadataQuery.addBindValue(metadataEntry.key());
+            insertMetadataQuery.addBindValue(metadataEntry.value());
+            insertMetadataQuery.exec();
+        }
+
+        insertTileQuery.reset(new QSqlQuery(mbtilesDb));
+        insertTileQuery->prepare(QLatin1String(
+            "INSERT OR REPLACE INTO tiles (zoom_level, tile_column, tile_row, tile_data) VALUES (?, ?, ?, ?)"));
+    }
+    else
+    {
+        if (!QDir(configuration.outputPath).mkpath(QLatin1String(".")))
+        {
+            output << xT("Failed to create '") << QStringToStlString(configuration.outputPath) << xT("'") << std::endl;
+            return false;
+        }
+    }
+
+    // Prepare providers. All of them are shared by all worker threads
+    if (configuration.verbose)
+        output << xT("Creating providers...") << std::endl;
+    const std::shared_ptr<OsmAnd::MapPresentationEnvironment> mapPresentationEnvironment(new OsmAnd::MapPresentationEnvironment(
+        mapStyle,
+        configuration.displayDensityFactor,
+        configuration.mapScale,
+        configuration.symbolsScale,
+        configuration.locale));
+    mapPresentationEnvironment->setSettings(configuration.styleSettings);
+    const std::shared_ptr<OsmAnd::MapPrimitiviser> primitiviser(new OsmAnd::MapPrimitiviser(
+        mapPresentationEnvironment));
+    const std::shared_ptr<OsmAnd::ObfMapObjectsProvider> mapObjectsProvider(new OsmAnd::ObfMapObjectsProvider(
+        configuration.obfsCollection));
+    const std::shared_ptr<OsmAnd::MapPrimitivesProvider> mapPrimitivesProvider(new OsmAnd::MapPrimitivesProvider(
+        mapObjectsProvider,
+        primitiviser,
+        configuration.referenceTileSize));
+    const std::shared_ptr<OsmAnd::MapRasterLayerProvider_Software> mapRasterLayerProvider(new OsmAnd::MapRasterLayerProvider_Software(
+        mapPrimitivesProvider));
+
+    // Workers take tiles from cursors of zoom ranges (one zoom after another) and push encoded results into
+    // bounded queue, that is drained by this thread (since SQLite connection can be used only from thread
+    // that created it)
+    const auto maxQueuedTiles = static_cast<int>(configuration.threadsCount) * 16;
+    const auto pZoomRanges = zoomRanges.data();
+    const auto zoomRangesCount = zoomRanges.size();
+    QMutex queueMutex;
+    QWaitCondition queueCondition;
+    QList<TilerEncodedTile> queue;
+    auto activeWorkersCount = configuration.threadsCount;
+    QMutex statisticsMutex;
+
+    const OsmAnd::QRunnableFunctor::Callback worker =
+        [this, pZoomRanges, zoomRangesCount, &queueMutex, &queueCondition, &queue, &activeWorkersCount, maxQueuedTiles,
+            &statisticsMutex, &outStatistics, mapRasterLayerProvider]
+        (const OsmAnd::QRunnableFunctor* const runnable)
+        {
+            Statistics localStatistics;
+            std::unique_ptr<SkImageEncoder> imageEncoder(createImageEncoder(configuration.outputImageFormat));
+
+            auto zoomRangeIndex = 0;
+            while (zoomRangeIndex < zoomRangesCount)
+            {
+                auto& zoomRange = pZoomRanges[zoomRangeIndex];
+                const auto tileIndex = zoomRange.nextTileIndex.fetchAndAddOrdered(1);
+                if (tileIndex >= zoomRange.tilesCount)
+                {
+                    zoomRangeIndex++;
+                    continue;
+                }
+
+                OsmAnd::MapRasterLayerProvider::Request request;
+                request.tileId = OsmAnd::TileId::fromXY(
+                    zoomRange.left + static_cast<int32_t>(tileIndex / zoomRange.rowsCount),
+                    zoomRange.top + static_cast<int32_t>(tileIndex % zoomRange.rowsCount));
+                request.zoom = zoomRange.zoom;
+
+                OsmAnd::MapRasterLayerProvider_Metrics::Metric_obtainData metric;
+                std::shared_ptr<OsmAnd::MapRasterLayerProvider::Data> rasterTile;
+                const auto ok = mapRasterLayerProvider->obtainRasterizedTile(request, rasterTile, &metric);
+
+                localStatistics.elapsedTimeForObtainingRasterTile += metric.elapsedTime;
+                if (const auto obtainMapObjectsMetric =
+                    metric.findSubmetricOfType<OsmAnd::ObfMapObjectsProvider_Metrics::Metric_obtainData>(true))
+                {
+                    localStatistics.elapsedTimeForObtainingMapObjects += obtainMapObjectsMetric->elapsedTime;
+                }
+                if (const auto primitiviseMetric =
+                    metric.findSubmetricOfType<OsmAnd::MapPrimitiviser_Metrics::Metric_primitivise>(true))
+                {
+                    localStatistics.elapsedTimeForPrimitivisation += primitiviseMetric->elapsedTime;
+                }
+                if (const auto rasterizeMetric =
+                    metric.findSubmetricOfType<OsmAnd::MapRasterizer_Metrics::Metric_rasterize>(true))
+                {
+                    localStatistics.elapsedTimeForRasterization += rasterizeMetric->elapsedTime;
+                }
+
+                if (!ok)
+                {
+                    localStatistics.tilesFailed++;
+                    continue;
+                }
+                if (!rasterTile || !rasterTile->bitmap)
+                {
+                    // Tiles without any data are not written at all
+                    localStatistics.tilesEmpty++;
+                    continue;
+                }
+
+                const OsmAnd::Stopwatch encodingStopwatch(true);
+                const auto imageData = imageEncoder->encodeData(*rasterTile->bitmap, configuration.outputImageQuality);
+                localStatistics.elapsedTimeForEncoding += encodingStopwatch.elapsed();
+                if (!imageData)
+                {
+                    localStatistics.tilesFailed++;
+                    continue;
+                }
+
+                TilerEncodedTile encodedTile;
+                encodedTile.tileId = request.tileId;
+                encodedTile.zoom = request.zoom;
+                encodedTile.data = QByteArray(reinterpret_cast<const char*>(imageData->bytes()), imageData->size());
+                imageData->unref();
+                localStatistics.tilesRendered++;
+
+                {
+                    QMutexLocker scopedLocker(&queueMutex);
+
+                    while (queue.size() >= maxQueuedTiles)
+                        REPEAT_UNTIL(queueCondition.wait(&queueMutex));
+                    queue.push_back(qMove(encodedTile));
+                    queueCondition.wakeAll();
+                }
+            }
+
+            {
+                QMutexLocker scopedLocker(&statisticsMutex);
+
+                outStatistics.tilesRendered += localStatistics.tilesRendered;
+                outStatistics.tilesEmpty += localStatistics.tilesEmpty;
+                outStatistics.tilesFailed += localStatistics.tilesFailed;
+                outStatistics.elapsedTimeForObtainingMapObjects += localStatistics.elapsedTimeForObtainingMapObjects;
+                outStatistics.elapsedTimeForPrimitivisation += localStatistics.elapsedTimeForPrimitivisation;
+                outStatistics.elapsedTimeForRasterization += localStatistics.elapsedTimeForRasterization;
+                outStatistics.elapsedTimeForObtainingRasterTile += localStatistics.elapsedTimeForObtainingRasterTile;
+                outStatistics.elapsedTimeForEncoding += localStatistics.elapsedTimeForEncoding;
+            }
+
+            {
+                QMutexLocker scopedLocker(&queueMutex);
+
+                activeWorkersCount--;
+                queueCondition.wakeAll();
+            }
+        };
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(configuration.threadsCount);
+    for (auto workerIndex = 0u; workerIndex < configuration.threadsCount; workerIndex++)
+    {
+        const auto workerRunnable = new OsmAnd::QRunnableFunctor(worker);
+        workerRunnable->setAutoDelete(true);
+        threadPool.start(workerRunnable);
+    }
+
+    // Write tiles as soon as they are ready
+    bool success = true;
+    uint64_t lastReportedTilesCount = 0;
+    uint64_t writtenTilesCount = 0;
+    for (;;)
+    {
+        QList<TilerEncodedTile> encodedTiles;
+        {
+            QMutexLocker scopedLocker(&queueMutex);
+
+            while (queue.isEmpty() && activeWorkersCount > 0)
+                REPEAT_UNTIL(queueCondition.wait(&queueMutex));
+            if (queue.isEmpty())
+                break;
+
+            encodedTiles.swap(queue);
+            queueCondition.wakeAll();
+        }
+
+        const OsmAnd::Stopwatch writingStopwatch(true);
+        if (configuration.outputFormat == OutputFormat::MBTiles)
+            mbtilesDb.transaction();
+        for (const auto& encodedTile : OsmAnd::constOf(encodedTiles))
+        {
+            writtenTilesCount++;
+
+            if (configuration.outputFormat == OutputFormat::MBTiles)
+            {
+                const auto tmsY = static_cast<int32_t>((1u << encodedTile.zoom) - 1) - encodedTile.tileId.y;
+                insertTileQuery->addBindValue(static_cast<int>(encodedTile.zoom));
+                insertTileQuery->addBindValue(encodedTile.tileId.x);
+                insertTileQuery->addBindValue(tmsY);
+                insertTileQuery->addBindValue(encodedTile.data);
+                if (!insertTileQuery->exec())
+                {
+                    output
+                        << xT("Failed to insert tile ")
+                        << encodedTile.zoom << xT("/") << encodedTile.tileId.x << xT("/") << encodedTile.tileId.y
+                        << xT(": ") << QStringToStlString(insertTileQuery->lastError().text()) << std::endl;
+                    success = false;
+                    continue;
+                }
+            }
+            else
+            {
+                const auto tileFilename = QString(QLatin1String("%1/%2/%3/%4.%5"))
+                    .arg(configuration.outputPath)
+                    .arg(encodedTile.zoom)
+                    .arg(encodedTile.tileId.x)
+                    .arg(encodedTile.tileId.y)
+                    .arg(imageExtension);
+                QFile tileFile(tileFilename);
+                QFileInfo(tileFile).absoluteDir().mkpath(QLatin1String("."));
+                if (!tileFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+                    tileFile.write(encodedTile.data) != encodedTile.data.size())
+                {
+                    output << xT("Failed to write '") << QStringToStlString(tileFilename) << xT("'") << std::endl;
+                    success = false;
+                    continue;
+                }
+                tileFile.close();
+            }
+
+            outStatistics.bytesWritten += encodedTile.data.size();
+        }
+        if (configuration.outputFormat == OutputFormat::MBTiles)
+            mbtilesDb.commit();
+        outStatistics.elapsedTimeForWriting += writingStopwatch.elapsed();
+
+        if (configuration.verbose && writtenTilesCount - lastReportedTilesCount >= 1000)
+        {
+            lastReportedTilesCount = writtenTilesCount;
+            output
+                << xT("Processed ")
+                << writtenTilesCount
+                << xT(" of ")
+                << tilesTotal
+                << xT(" tiles (")
+                << (writtenTilesCount / totalStopwatch.elapsed())
+                << xT(" tiles/s)") << std::endl;
+        }
+    }
+    threadPool.waitForDone();
+
+    if (configuration.outputFormat == OutputFormat::MBTiles)
+    {
+        insertTileQuery.reset();
+        mbtilesDb.close();
+        mbtilesDb = QSqlDatabase();
+        QSqlDatabase::removeDatabase(mbtilesConnectionName);
+    }
+
+    outStatistics.elapsedTime = totalStopwatch.elapsed();
+    outStatistics.peakResidentSetSize = getPeakResidentSetSize();
+    if (outStatistics.tilesFailed > 0)
+        success = false;
+
+    if (configuration.verbose || configuration.metrics)
+        output << xT("Statistics:\n") << QStringToStlString(outStatistics.toString(QLatin1String("\t"))) << std::endl;
+
+    return success;
+}
+
+SkImageEncoder* OsmAndTools::Tiler::createImageEncoder(const ImageFormat imageFormat)
+{
+    switch (imageFormat)
+    {
+        case ImageFormat::PNG:
+            return CreatePNGImageEncoder();
+        case ImageFormat::JPEG:
+            return CreateJPEGImageEncoder();
+        case ImageFormat::WebP:
+            // May be unavailable if SKIA was built without libwebp
+            return SkImageEncoder::Create(SkImageEncoder::kWEBP_Type);
+    }
+
+    return nullptr;
+}
+
+bool OsmAndTools::Tiler::generate(Statistics* const pOutStatistics /*= nullptr*/, QString *pLog /*= nullptr*/)
+{
+    Statistics statistics;
+    bool success;
+    if (pLog != nullptr)
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        std::wostringstream output;
+        success = generate(statistics, output);
+        *pLog = QString::fromStdWString(output.str());
+#else
+        std::ostringstream output;
+        success = generate(statistics, output);
+        *pLog = QString::fromStdString(output.str());
+#endif
+    }
+    else
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        success = generate(statistics, std::wcout);
+#else
+        success = generate(statistics, std::cout);
+#endif
+    }
+
+    if (pOutStatistics != nullptr)
+        *pOutStatistics = statistics;
+
+    return success;
+}
+
+uint64_t OsmAndTools::Tiler::getPeakResidentSetSize()
+{
+#if defined(OSMAND_TARGET_OS_windows)
+    PROCESS_MEMORY_COUNTERS processMemoryCounters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &processMemoryCounters, sizeof(processMemoryCounters)))
+        return 0;
+    return static_cast<uint64_t>(processMemoryCounters.PeakWorkingSetSize);
+#else
+    struct rusage resourceUsage;
+    if (getrusage(RUSAGE_SELF, &resourceUsage) != 0)
+        return 0;
+#   if defined(OSMAND_TARGET_OS_macosx) || defined(OSMAND_TARGET_OS_ios)
+    // On Darwin ru_maxrss is in bytes
+    return static_cast<uint64_t>(resourceUsage.ru_maxrss);
+#   else
+    // Elsewhere ru_maxrss is in kilobytes
+    return static_cast<uint64_t>(resourceUsage.ru_maxrss) * 1024;
+#   endif
+#endif
+}
+
+OsmAndTools::Tiler::Statistics::Statistics()
+    : tilesTotal(0)
+    , tilesRendered(0)
+    , tilesEmpty(0)
+    , tilesFailed(0)
+    , bytesWritten(0)
+    , elapsedTime(0.0f)
+    , elapsedTimeForObtainingMapObjects(0.0f)
+    , elapsedTimeForPrimitivisation(0.0f)
+    , elapsedTimeForRasterization(0.0f)
+    , elapsedTimeForObtainingRasterTile(0.0f)
+    , elapsedTimeForEncoding(0.0f)
+    , elapsedTimeForWriting(0.0f)
+    , peakResidentSetSize(0)
+{
+}
+
+float OsmAndTools::Tiler::Statistics::getTilesPerSecond() const
+{
+    if (elapsedTime <= 0.0f)
+        return 0.0f;
+    return (tilesRendered + tilesEmpty) / elapsedTime;
+}
+
+QString OsmAndTools::Tiler::Statistics::toString(const QString& prefix /*= QString::null*/) const
+{
+    QString output;
+
+    output += prefix + QString(QLatin1String("tilesTotal = %1\n")).arg(tilesTotal);
+    output += prefix + QString(QLatin1String("tilesRendered = %1\n")).arg(tilesRendered);
+    output += prefix + QString(QLatin1String("tilesEmpty = %1\n")).arg(tilesEmpty);
+    output += prefix + QString(QLatin1String("tilesFailed = %1\n")).arg(tilesFailed);
+    output += prefix + QString(QLatin1String("bytesWritten = %1\n")).arg(bytesWritten);
+    output += prefix + QString(QLatin1String("elapsedTime = %1s\n")).arg(elapsedTime);
+    output += prefix + QString(QLatin1String("tilesPerSecond = %1\n")).arg(getTilesPerSecond());
+    output += prefix + QString(QLatin1String("elapsedTimeForObtainingMapObjects = %1s\n")).arg(elapsedTimeForObtainingMapObjects);
+    output += prefix + QString(QLatin1String("elapsedTimeForPrimitivisation = %1s\n")).arg(elapsedTimeForPrimitivisation);
+    output += prefix + QString(QLatin1String("elapsedTimeForRasterization = %1s\n")).arg(elapsedTimeForRasterization);
+    output += prefix + QString(QLatin1String("elapsedTimeForObtainingRasterTile = %1s\n")).arg(elapsedTimeForObtainingRasterTile);
+    output += prefix + QString(QLatin1String("elapsedTimeForEncoding = %1s\n")).arg(elapsedTimeForEncoding);
+    output += prefix + QString(QLatin1String("elapsedTimeForWriting = %1s\n")).arg(elapsedTimeForWriting);
+    output += prefix + QString(QLatin1String("peakResidentSetSize = %1MB")).arg(peakResidentSetSize / (1024.0 * 1024.0), 0, 'f', 2);
+
+    return output;
+}
+
+OsmAndTools::Tiler::Configuration::Configuration()
+    : styleName(QLatin1String("default"))
+    , bbox31(0, 0, std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max())
+    , minZoom(OsmAnd::ZoomLevel0)
+    , maxZoom(OsmAnd::ZoomLevel0)
+    , referenceTileSize(256)
+    , displayDensityFactor(1.0f)
+    , mapScale(1.0f)
+    , symbolsScale(1.0f)
+    , locale(QLatin1String("en"))
+    , outputFormat(OutputFormat::Directory)
+    , outputImageFormat(ImageFormat::PNG)
+    , outputImageQuality(100)
+    , threadsCount(static_cast<unsigned int>(qMax(1, QThread::idealThreadCount())))
+    , metrics(false)
+    , verbose(false)
+{
+}
+
+bool OsmAndTools::Tiler::Configuration::parseFromCommandLineArguments(
+    const QStringList& commandLineArgs,
+    Configuration& outConfiguration,
+    QString& outError)
+{
+    outConfiguration = Configuration();
+
+    const std::shared_ptr<OsmAnd::ObfsCollection> obfsCollection(new OsmAnd::ObfsCollection());
+    outConfiguration.obfsCollection = obfsCollection;
+
+    const std::shared_ptr<OsmAnd::MapStylesCollection> stylesCollection(new OsmAnd::MapStylesCollection());
+    outConfiguration.stylesCollection = stylesCollection;
+
+    for (const auto& arg : commandLineArgs)
+    {
+        if (arg.startsWith(QLatin1String("-obfsPath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-obfsPath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            obfsCollection->addDirectory(value, false);
+        }
+        else if (arg.startsWith(QLatin1String("-obfsRecursivePath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-obfsRecursivePath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            obfsCollection->addDirectory(value, true);
+        }
+        else if (arg.startsWith(QLatin1String("-obfFile=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-obfFile=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            obfsCollection->addFile(value);
+        }
+        else if (arg.startsWith(QLatin1String("-stylesPath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-stylesPath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            QFileInfoList styleFilesList;
+            OsmAnd::Utilities::findFiles(QDir(value), QStringList() << QLatin1String("*.render.xml"), styleFilesList, false);
+            for (const auto& styleFile : styleFilesList)
+                stylesCollection->addStyleFromFile(styleFile.absoluteFilePath());
+        }
+        else if (arg.startsWith(QLatin1String("-stylesRecursivePath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-stylesRecursivePath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            QFileInfoList styleFilesList;
+            OsmAnd::Utilities::findFiles(QDir(value), QStringList() << QLatin1String("*.render.xml"), styleFilesList, true);
+            for (const auto& styleFile : styleFilesList)
+                stylesCollection->addStyleFromFile(styleFile.absoluteFilePath());
+        }
+        else if (arg.startsWith(QLatin1String("-styleName=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-styleName=")));
+            outConfiguration.styleName = value;
+        }
+        else if (arg.startsWith(QLatin1String("-styleSetting:")))
+        {
+            const auto settingValue = arg.mid(strlen("-styleSetting:"));
+            const auto settingKeyValue = settingValue.split(QLatin1Char('='));
+            if (settingKeyValue.size() != 2)
+            {
+                outError = QString("'%1' can not be parsed as style settings key and value").arg(settingValue);
+                return false;
+            }
+
+            outConfiguration.styleSettings[settingKeyValue[0]] = Utilities::purifyArgumentValue(settingKeyValue[1]);
+        }
+        else if (arg.startsWith(QLatin1String("-bbox=")))
+        {
+            // Top-left and bottom-right corners as 'top;left;bottom;right' in degrees
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-bbox=")));
+            const auto bboxValues = value.split(QLatin1Char(';'));
+            if (bboxValues.size() != 4)
+            {
+                outError = QString("'%1' can not be parsed as bounding box").arg(value);
+                return false;
+            }
+
+            double bboxDegrees[4];
+            for (int idx = 0; idx < 4; idx++)
+            {
+                bool ok = false;
+                bboxDegrees[idx] = bboxValues[idx].toDouble(&ok);
+                if (!ok)
+                {
+                    outError = QString("'%1' can not be parsed as bounding box coordinate").arg(bboxValues[idx]);
+                    return false;
+                }
+            }
+
+            outConfiguration.bbox31 = OsmAnd::Utilities::boundingBox31FromLatLon(
+                OsmAnd::LatLon(bboxDegrees[0], bboxDegrees[1]),
+                OsmAnd::LatLon(bboxDegrees[2], bboxDegrees[3]));
+        }
+        else if (arg.startsWith(QLatin1String("-bbox31=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-bbox31=")));
+            const auto bboxValues = value.split(QLatin1Char(';'));
+            if (bboxValues.size() != 4)
+            {
+                outError = QString("'%1' can not be parsed as bounding box").arg(value);
+                return false;
+            }
+
+            int32_t bbox31Values[4];
+            for (int idx = 0; idx < 4; idx++)
+            {
+                bool ok = false;
+                bbox31Values[idx] = bboxValues[idx].toInt(&ok);
+                if (!ok)
+                {
+                    outError = QString("'%1' can not be parsed as bounding box coordinate").arg(bboxValues[idx]);
+                    return false;
+                }
+            }
+
+            outConfiguration.bbox31 = OsmAnd::AreaI(bbox31Values[0], bbox31Values[1], bbox31Values[2], bbox31Values[3]);
+        }
+        else if (arg.startsWith(QLatin1String("-minZoom=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-minZoom=")));
+            bool ok = false;
+            const auto zoom = value.toUInt(&ok);
+            if (!ok || zoom > OsmAnd::MaxZoomLevel)
+            {
+                outError = QString("'%1' can not be parsed as minimal zoom").arg(value);
+                return false;
+            }
+            outConfiguration.minZoom = static_cast<OsmAnd::ZoomLevel>(zoom);
+        }
+        else if (arg.startsWith(QLatin1String("-maxZoom=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-maxZoom=")));
+            bool ok = false;
+            const auto zoom = value.toUInt(&ok);
+            if (!ok || zoom > OsmAnd::MaxZoomLevel)
+            {
+                outError = QString("'%1' can not be parsed as maximal zoom").arg(value);
+                return false;
+            }
+            outConfiguration.maxZoom = static_cast<OsmAnd::ZoomLevel>(zoom);
+        }
+        else if (arg.startsWith(QLatin1String("-referenceTileSize=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-referenceTileSize=")));
+
+            bool ok = false;
+            outConfiguration.referenceTileSize = value.toUInt(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' can not be parsed as reference tile size in pixels").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-displayDensityFactor=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-displayDensityFactor=")));
+
+            bool ok = false;
+            outConfiguration.displayDensityFactor = value.toFloat(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' can not be parsed as display density factor").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-mapScale=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-mapScale=")));
+
+            bool ok = false;
+            outConfiguration.mapScale = value.toFloat(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' can not be parsed as map scale factor").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-symbolsScale=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-symbolsScale=")));
+
+            bool ok = false;
+            outConfiguration.symbolsScale = value.toFloat(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' can not be parsed as symbols scale factor").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-locale=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-locale=")));
+
+            outConfiguration.locale = value;
+        }
+        else if (arg.startsWith(QLatin1String("-outputPath=")))
+        {
+            outConfiguration.outputPath = Utilities::resolvePath(arg.mid(strlen("-outputPath=")));
+        }
+        else if (arg.startsWith(QLatin1String("-outputFormat=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-outputFormat=")));
+            if (value.compare(QLatin1String("directory"), Qt::CaseInsensitive) == 0)
+                outConfiguration.outputFormat = OutputFormat::Directory;
+            else if (value.compare(QLatin1String("mbtiles"), Qt::CaseInsensitive) == 0)
+                outConfiguration.outputFormat = OutputFormat::MBTiles;
+            else
+            {
+                outError = QString("'%1' can not be parsed as output format").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-outputImageFormat=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-outputImageFormat=")));
+            if (value.compare(QLatin1String("png"), Qt::CaseInsensitive) == 0)
+                outConfiguration.outputImageFormat = ImageFormat::PNG;
+            else if (value.compare(QLatin1String("jpeg"), Qt::CaseInsensitive) == 0 || value.compare(QLatin1String("jpg"), Qt::CaseInsensitive) == 0)
+                outConfiguration.outputImageFormat = ImageFormat::JPEG;
+            else if (value.compare(QLatin1String("webp"), Qt::CaseInsensitive) == 0)
+                outConfiguration.outputImageFormat = ImageFormat::WebP;
+            else
+            {
+                outError = QString("'%1' can not be parsed as output image format").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-outputImageQuality=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-outputImageQuality=")));
+
+            bool ok = false;
+            outConfiguration.outputImageQuality = value.toInt(&ok);
+            if (!ok || outConfiguration.outputImageQuality < 0 || outConfiguration.outputImageQuality > 100)
+            {
+                outError = QString("'%1' can not be parsed as output image quality").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-threads=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-threads=")));
+
+            bool ok = false;
+            outConfiguration.threadsCount = value.toUInt(&ok);
+            if (!ok || outConfiguration.threadsCount == 0)
+            {
+                outError = QString("'%1' can not be parsed as threads count").arg(value);
+                return false;
+            }
+        }
+        else if (arg == QLatin1String("-metrics"))
+        {
+            outConfiguration.metrics = true;
+        }
+        else if (arg == QLatin1String("-verbose"))
+        {
+            outConfiguration.verbose = true;
+        }
+        else
+        {
+            outError = QString("Unrecognized argument: '%1'").arg(arg);
+            return false;
+        }
+    }
+
+    // Validate
+    if (outConfiguration.styleName.isEmpty())
+    {
+        outError = QLatin1String("'styleName' can not be empty");
+        return false;
+    }
+    if (outConfiguration.outputPath.isEmpty())
+    {
+        outError = QLatin1String("'outputPath' can not be empty");
+        return false;
+    }
+    if (outConfiguration.minZoom > outConfiguration.maxZoom)
+    {
+        outError = QLatin1String("'minZoom' can not be greater than 'maxZoom'");
+        return false;
+    }
+
+    return true;
+}